@@ -21,6 +21,10 @@
 #          10        1         3
 # --------------   End of CSV  ----------------
 
+# All runs of the sweep share this id; each run's seed is derived from it and the simulation and run numbers,
+# so no two runs get the same seed. Change it to get a statistically independent sweep.
+SWEEP_ID=1
+
 # Here we will create a loop that goes through each row and takes the given values for Lambda and Gamma
 
 while IFS="," read -r rec_column1 rec_column2 rec_column3 rec_column4
@@ -31,8 +35,9 @@ for ((i = 1; i <= $rec_column3; i += 1)); do
      echo "Gamma: $rec_column2"
      echo "Simulation: $rec_column4"
      echo "Run: $i"
-     ## Running simulation with read in parameters and taking a random interger number between 1 - 1000 as the 5th command line option
-     ~/build/projects/BayesianTissueProject2/test/TestPaperCommandLineSpeedSimulation -opt1 $rec_column1 -opt2 $rec_column2 -opt3 $i -opt4 $rec_column4 -opt5 $((1+ $RANDOM % 1000)) &
+     ## Running simulation with read in parameters and the sweep id as the 5th command line option
+     ## -resume skips runs that already finished (they have a RunComplete.manifest in their output directory)
+     ~/build/projects/BayesianTissueProject2/test/TestPaperCommandLineSpeedSimulation -opt1 $rec_column1 -opt2 $rec_column2 -opt3 $i -opt4 $rec_column4 -opt5 $SWEEP_ID -resume &
      echo ""
 done
 done < <(tail -n  +1 ~/Chaste/projects/BayesianTissueProject2/ExampleCommandLineCSV.csv)
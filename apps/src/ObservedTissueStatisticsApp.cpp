@@ -0,0 +1,212 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+/**
+ * @file
+ *
+ * Calculates the summary statistics (TissueSummaryStatistics) of segmented
+ * microscopy images, with the same code as for simulated tissues, so that
+ * observed and simulated statistics can be compared directly.
+ *
+ * Each image is given as a polygon tessellation in the format of Chaste's
+ * VertexMeshReader: <mesh base>.node holds the vertex coordinates and
+ * <mesh base>.cell the vertex list of each cell (see
+ * ObservedTissueMesh::ReadFromFiles()). The images are processed in parallel,
+ * one per worker process.
+ *
+ * Usage: ObservedTissueStatisticsApp <output.csv> <mesh base>... [options]
+ *
+ * Options:
+ *   --workers <number>   the number of images to process at once (default: one per hardware thread)
+ *   --observed <file>    also write the mean statistics over the images as one line, in the form
+ *                        read by TestPaperMultiFidelityScreen, ParameterDesignApp and
+ *                        TestPaperSyntheticLikelihoodMcmc
+ */
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ExecutableSupport.hpp"
+#include "Exception.hpp"
+#include "PetscTools.hpp"
+#include "PetscException.hpp"
+
+#include "BufferedTextEmitter.hpp"
+#include "ObservedTissueMesh.hpp"
+#include "SimulationWorkerPool.hpp"
+#include "TissueSummaryStatistics.hpp"
+
+/**
+ * Calculate the summary statistics of one image.
+ *
+ * @param rMeshBase the mesh base of the image
+ * @return the statistics, as a string
+ */
+std::string CalculateImageStatistics(const std::string& rMeshBase)
+{
+    ObservedTissueMesh mesh;
+    mesh.ReadFromFiles(rMeshBase);
+    return TissueSummaryStatistics::Calculate(mesh).ToString();
+}
+
+int main(int argc, char *argv[])
+{
+    // This sets up PETSc and prints out copyright information, etc.
+    ExecutableSupport::StandardStartup(&argc, &argv);
+
+    int exit_code = ExecutableSupport::EXIT_OK;
+    const std::string usage = "Usage: ObservedTissueStatisticsApp <output.csv> <mesh base>... "
+                              "[--workers number] [--observed file]";
+
+    try
+    {
+        if (argc < 3)
+        {
+            ExecutableSupport::PrintError(usage, true);
+            exit_code = ExecutableSupport::EXIT_BAD_ARGUMENTS;
+        }
+        else if (PetscTools::AmMaster())
+        {
+            std::string output_path = argv[1];
+            std::vector<std::string> mesh_bases;
+            unsigned num_workers = 0u;
+            std::string observed_path;
+            for (int i=2; i<argc; i++)
+            {
+                std::string argument = argv[i];
+                if (argument == "--workers" || argument == "--observed")
+                {
+                    if (i + 1 >= argc)
+                    {
+                        EXCEPTION("Option " << argument << " needs a value\n" << usage);
+                    }
+                    if (argument == "--workers")
+                    {
+                        num_workers = std::strtoul(argv[i+1], nullptr, 10);
+                    }
+                    else
+                    {
+                        observed_path = argv[i+1];
+                    }
+                    i++;
+                }
+                else if (argument.compare(0, 2, "--") == 0)
+                {
+                    EXCEPTION("Unknown option " << argument << "\n" << usage);
+                }
+                else
+                {
+                    mesh_bases.push_back(argument);
+                }
+            }
+            if (mesh_bases.empty())
+            {
+                EXCEPTION("No images were given\n" << usage);
+            }
+
+            SimulationWorkerPool pool(num_workers);
+            std::vector<SimulationWorkerPool::Result> results =
+                    pool.Run(mesh_bases.size(), [&](unsigned i) { return CalculateImageStatistics(mesh_bases[i]); });
+
+            std::ofstream file(output_path.c_str());
+            if (!file.is_open())
+            {
+                EXCEPTION("Could not open output file " << output_path);
+            }
+
+            std::vector<std::string> names = TissueSummaryStatistics::GetNames();
+            BufferedTextEmitter emitter;
+            emitter.SetUseShortestRoundTrip(true);
+            emitter << "Image";
+            for (unsigned i=0; i<names.size(); i++)
+            {
+                emitter << ',' << names[i];
+            }
+            emitter << '\n';
+
+            std::vector<double> mean_values(names.size(), 0.0);
+            unsigned num_succeeded = 0;
+            for (unsigned image=0; image<mesh_bases.size(); image++)
+            {
+                if (!results[image].mSucceeded)
+                {
+                    ExecutableSupport::PrintError("Could not process " + mesh_bases[image] + ": " + results[image].mOutput);
+                    exit_code = ExecutableSupport::EXIT_ERROR;
+                    continue;
+                }
+
+                std::vector<double> values = TissueSummaryStatistics::FromString(results[image].mOutput).ToVector();
+                emitter << mesh_bases[image];
+                for (unsigned i=0; i<values.size(); i++)
+                {
+                    emitter << ',' << values[i];
+                    mean_values[i] += values[i];
+                }
+                emitter << '\n';
+                num_succeeded++;
+            }
+            emitter.FlushTo(file);
+            std::cout << "Wrote the statistics of " << num_succeeded << " of " << mesh_bases.size()
+                      << " images to " << output_path << std::endl;
+
+            if (!observed_path.empty() && num_succeeded > 0)
+            {
+                for (unsigned i=0; i<mean_values.size(); i++)
+                {
+                    mean_values[i] /= num_succeeded;
+                }
+                std::ofstream observed_file(observed_path.c_str());
+                if (!observed_file.is_open())
+                {
+                    EXCEPTION("Could not open output file " << observed_path);
+                }
+                observed_file << TissueSummaryStatistics::FromVector(mean_values).ToString() << std::endl;
+            }
+        }
+    }
+    catch (const Exception& e)
+    {
+        ExecutableSupport::PrintError(e.GetMessage());
+        exit_code = ExecutableSupport::EXIT_ERROR;
+    }
+
+    // End by finalizing PETSc, and returning a suitable exit code.
+    // 0 means 'no error'
+    ExecutableSupport::FinalizePetsc();
+    return exit_code;
+}
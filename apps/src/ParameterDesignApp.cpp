@@ -0,0 +1,188 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+/**
+ * @file
+ *
+ * Writes a sweep CSV file (Lambda, Gamma, Runs, Simulation) for
+ * TestPaperCommandLineVertexSimulation, TestPaperSweepFarm or SweepQueueServerApp.
+ *
+ * An initial design is a Sobol sequence or a Latin hypercube over the parameter
+ * box. A follow-up design is chosen by active learning from the results of the
+ * runs so far (a SweepResults.csv file): an emulator is trained on them and the
+ * new points are put where it is most uncertain, or, given observed statistics
+ * (one line as written in the Statistics line of a RunComplete.manifest), where
+ * it is most uncertain about parameters that could explain the observations.
+ *
+ * Usage: ParameterDesignApp <output.csv> <points> <runs per point> sobol|lhs|active [options]
+ *
+ * Options:
+ *   --lambda <min> <max>     the range of Lambda (default -1 to 0.2)
+ *   --gamma <min> <max>      the range of Gamma (default 0 to 0.5)
+ *   --seed <seed>            the seed of the Latin hypercube (default 1)
+ *   --first <simulation>     the simulation number of the first point (default 1)
+ *   --results <file.csv>     for active: the results of the runs so far (may be repeated)
+ *   --observed <file>        for active: the observed summary statistics
+ */
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "ExecutableSupport.hpp"
+#include "Exception.hpp"
+#include "PetscTools.hpp"
+#include "PetscException.hpp"
+
+#include "GaussianProcessEmulator.hpp"
+#include "ParameterDesign.hpp"
+#include "TissueSummaryStatistics.hpp"
+
+int main(int argc, char *argv[])
+{
+    // This sets up PETSc and prints out copyright information, etc.
+    ExecutableSupport::StandardStartup(&argc, &argv);
+
+    int exit_code = ExecutableSupport::EXIT_OK;
+    const std::string usage = "Usage: ParameterDesignApp <output.csv> <points> <runs per point> sobol|lhs|active "
+                              "[--lambda min max] [--gamma min max] [--seed seed] [--first simulation] "
+                              "[--results file.csv]... [--observed file]";
+
+    try
+    {
+        if (argc < 5)
+        {
+            ExecutableSupport::PrintError(usage, true);
+            exit_code = ExecutableSupport::EXIT_BAD_ARGUMENTS;
+        }
+        else if (PetscTools::AmMaster())
+        {
+            std::string output_path = argv[1];
+            unsigned num_points = std::strtoul(argv[2], nullptr, 10);
+            unsigned num_runs = std::strtoul(argv[3], nullptr, 10);
+            std::string method = argv[4];
+
+            ParameterDesign design;
+            unsigned seed = 1u;
+            unsigned first_simulation = 1u;
+            std::vector<std::string> results_paths;
+            std::string observed_path;
+            for (int i=5; i<argc; i++)
+            {
+                std::string option = argv[i];
+                unsigned num_values = (option == "--lambda" || option == "--gamma") ? 2u : 1u;
+                if (i + (int)num_values >= argc)
+                {
+                    EXCEPTION("Option " << option << " needs " << num_values << " value(s)\n" << usage);
+                }
+
+                if (option == "--lambda" || option == "--gamma")
+                {
+                    design.SetBounds(option == "--lambda" ? "Lambda" : "Gamma", std::strtod(argv[i+1], nullptr), std::strtod(argv[i+2], nullptr));
+                }
+                else if (option == "--seed")
+                {
+                    seed = std::strtoul(argv[i+1], nullptr, 10);
+                }
+                else if (option == "--first")
+                {
+                    first_simulation = std::strtoul(argv[i+1], nullptr, 10);
+                }
+                else if (option == "--results")
+                {
+                    results_paths.push_back(argv[i+1]);
+                }
+                else if (option == "--observed")
+                {
+                    observed_path = argv[i+1];
+                }
+                else
+                {
+                    EXCEPTION("Unknown option " << option << "\n" << usage);
+                }
+                i += num_values;
+            }
+
+            if (method == "sobol")
+            {
+                design.AddSobolSequence(num_points);
+            }
+            else if (method == "lhs")
+            {
+                design.AddLatinHypercube(num_points, seed);
+            }
+            else if (method == "active")
+            {
+                if (results_paths.empty())
+                {
+                    EXCEPTION("An active design needs the results of earlier runs (--results)");
+                }
+                GaussianProcessEmulator emulator;
+                for (unsigned i=0; i<results_paths.size(); i++)
+                {
+                    emulator.ReadSweepResults(results_paths[i]);
+                }
+                emulator.Train();
+
+                std::vector<double> observed;
+                if (!observed_path.empty())
+                {
+                    std::ifstream observed_file(observed_path.c_str());
+                    std::string line;
+                    std::getline(observed_file, line);
+                    observed = TissueSummaryStatistics::FromString(line).ToVector();
+                }
+                design.AddActiveLearningBatch(emulator, num_points, observed);
+            }
+            else
+            {
+                EXCEPTION("Unknown design method " << method << "\n" << usage);
+            }
+
+            design.WriteSweepFile(output_path, num_runs, first_simulation);
+            std::cout << "Wrote " << design.rGetPoints().size() << " parameter sets to " << output_path << std::endl;
+        }
+    }
+    catch (const Exception& e)
+    {
+        ExecutableSupport::PrintError(e.GetMessage());
+        exit_code = ExecutableSupport::EXIT_ERROR;
+    }
+
+    // End by finalizing PETSc, and returning a suitable exit code.
+    // 0 means 'no error'
+    ExecutableSupport::FinalizePetsc();
+    return exit_code;
+}
@@ -0,0 +1,102 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+/**
+ * @file
+ *
+ * A local work-queue server for parameter sweeps. It reads a sweep CSV file
+ * (Lambda, Gamma, Runs, Simulation), and hands out its runs one at a time to
+ * TestPaperQueueWorker processes on the same machine, through a Unix domain
+ * socket. Finished runs are recorded in a completion file; restarting the
+ * server with the same completion file skips them.
+ *
+ * Usage: SweepQueueServerApp <sweep.csv> <socket path> <completion file> [sweep id] [lease seconds] [max attempts]
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "ExecutableSupport.hpp"
+#include "Exception.hpp"
+#include "PetscTools.hpp"
+#include "PetscException.hpp"
+
+#include "SweepQueueServer.hpp"
+#include "SweepWorkQueue.hpp"
+
+int main(int argc, char *argv[])
+{
+    // This sets up PETSc and prints out copyright information, etc.
+    ExecutableSupport::StandardStartup(&argc, &argv);
+
+    int exit_code = ExecutableSupport::EXIT_OK;
+
+    try
+    {
+        if (argc < 4 || argc > 7)
+        {
+            ExecutableSupport::PrintError("Usage: SweepQueueServerApp <sweep.csv> <socket path> <completion file> [sweep id] [lease seconds] [max attempts]", true);
+            exit_code = ExecutableSupport::EXIT_BAD_ARGUMENTS;
+        }
+        else if (PetscTools::AmMaster())
+        {
+            unsigned sweep_id = (argc > 4) ? std::strtoul(argv[4], nullptr, 10) : 1u;
+            double lease_duration = (argc > 5) ? std::strtod(argv[5], nullptr) : 60.0;
+            unsigned max_attempts = (argc > 6) ? std::strtoul(argv[6], nullptr, 10) : 3u;
+
+            std::vector<SweepTask> tasks = SweepTask::ReadSweepFile(argv[1], sweep_id);
+            SweepWorkQueue queue(tasks, argv[3], lease_duration, max_attempts);
+            std::cout << "Serving " << queue.GetNumTasks(SweepWorkQueue::PENDING) << " of " << tasks.size()
+                      << " runs on " << argv[2] << std::endl;
+
+            SweepQueueServer server(queue, argv[2]);
+            server.Serve();
+
+            std::cout << "Sweep finished: " << queue.GetNumTasks(SweepWorkQueue::SUCCEEDED) << " runs succeeded, "
+                      << queue.GetNumTasks(SweepWorkQueue::FAILED) << " failed" << std::endl;
+        }
+    }
+    catch (const Exception& e)
+    {
+        ExecutableSupport::PrintError(e.GetMessage());
+        exit_code = ExecutableSupport::EXIT_ERROR;
+    }
+
+    // End by finalizing PETSc, and returning a suitable exit code.
+    // 0 means 'no error'
+    ExecutableSupport::FinalizePetsc();
+    return exit_code;
+}
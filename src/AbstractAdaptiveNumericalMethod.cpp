@@ -0,0 +1,201 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "AbstractAdaptiveNumericalMethod.hpp"
+#include "BufferedTextEmitter.hpp"
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+AbstractAdaptiveNumericalMethod<ELEMENT_DIM,SPACE_DIM>::AbstractAdaptiveNumericalMethod()
+    : AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>(),
+      mTolerance(1e-4),
+      mStepController(1e-4, 1u),
+      mNumForceEvaluations(0u)
+{
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+AbstractAdaptiveNumericalMethod<ELEMENT_DIM,SPACE_DIM>::~AbstractAdaptiveNumericalMethod()
+{
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+std::vector<c_vector<double, SPACE_DIM> > AbstractAdaptiveNumericalMethod<ELEMENT_DIM,SPACE_DIM>::ComputeForces()
+{
+    mNumForceEvaluations++;
+    return this->ComputeForcesIncludingDamping();
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractAdaptiveNumericalMethod<ELEMENT_DIM,SPACE_DIM>::SetNodeLocations(const std::vector<c_vector<double, SPACE_DIM> >& rLocations)
+{
+    unsigned index = 0;
+    for (typename AbstractMesh<ELEMENT_DIM, SPACE_DIM>::NodeIterator node_iter = this->mpCellPopulation->rGetMesh().GetNodeIteratorBegin();
+         node_iter != this->mpCellPopulation->rGetMesh().GetNodeIteratorEnd();
+         ++node_iter, ++index)
+    {
+        this->SafeNodePositionUpdate(node_iter->GetIndex(), rLocations[index]);
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractAdaptiveNumericalMethod<ELEMENT_DIM,SPACE_DIM>::UpdateAllNodePositions(double dt)
+{
+    if (this->mUseUpdateNodeLocation)
+    {
+        EXCEPTION("Adaptive numerical methods cannot be used with UpdateNodeLocation");
+    }
+
+    mStepController.SetTolerance(mTolerance);
+    mStepController.SetErrorOrder(GetErrorOrder());
+
+    std::vector<c_vector<double, SPACE_DIM> > initial_locations = this->SaveCurrentLocations();
+    mSubstepStartLocations = initial_locations;
+    BeginTimeStep();
+
+    double time_advanced = 0.0;
+    while (time_advanced < dt)
+    {
+        double substep = mStepController.GetStep(dt - time_advanced);
+        if (substep < 1e-12*dt)
+        {
+            EXCEPTION("The sub-step has fallen to " << substep << "; the forces may have become singular");
+        }
+        bool is_last_substep = (substep == dt - time_advanced);
+
+        double error = AttemptSubstep(substep);
+        if (mStepController.RecordStep(substep, error))
+        {
+            time_advanced = is_last_substep ? dt : time_advanced + substep;
+            mSubstepStartLocations = this->SaveCurrentLocations();
+            AcceptSubstep();
+        }
+        else
+        {
+            SetNodeLocations(mSubstepStartLocations);
+        }
+    }
+
+    // Check the displacement over the whole time step, as a forward Euler step would be
+    unsigned index = 0;
+    for (typename AbstractMesh<ELEMENT_DIM, SPACE_DIM>::NodeIterator node_iter = this->mpCellPopulation->rGetMesh().GetNodeIteratorBegin();
+         node_iter != this->mpCellPopulation->rGetMesh().GetNodeIteratorEnd();
+         ++node_iter, ++index)
+    {
+        c_vector<double, SPACE_DIM> displacement = node_iter->rGetLocation() - initial_locations[index];
+        this->DetectStepSizeExceptions(node_iter->GetIndex(), displacement, dt);
+        c_vector<double, SPACE_DIM> new_location = initial_locations[index] + displacement;
+        this->SafeNodePositionUpdate(node_iter->GetIndex(), new_location);
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractAdaptiveNumericalMethod<ELEMENT_DIM,SPACE_DIM>::SetTolerance(double tolerance)
+{
+    // Let the controller check the value
+    mStepController.SetTolerance(tolerance);
+    mTolerance = tolerance;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double AbstractAdaptiveNumericalMethod<ELEMENT_DIM,SPACE_DIM>::GetTolerance() const
+{
+    return mTolerance;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned AbstractAdaptiveNumericalMethod<ELEMENT_DIM,SPACE_DIM>::GetNumAcceptedSteps() const
+{
+    return mStepController.GetNumAcceptedSteps();
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned AbstractAdaptiveNumericalMethod<ELEMENT_DIM,SPACE_DIM>::GetNumRejectedSteps() const
+{
+    return mStepController.GetNumRejectedSteps();
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned AbstractAdaptiveNumericalMethod<ELEMENT_DIM,SPACE_DIM>::GetNumForceEvaluations() const
+{
+    return mNumForceEvaluations;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double AbstractAdaptiveNumericalMethod<ELEMENT_DIM,SPACE_DIM>::GetSmallestAcceptedStep() const
+{
+    return mStepController.GetSmallestAcceptedStep();
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double AbstractAdaptiveNumericalMethod<ELEMENT_DIM,SPACE_DIM>::GetLargestAcceptedStep() const
+{
+    return mStepController.GetLargestAcceptedStep();
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double AbstractAdaptiveNumericalMethod<ELEMENT_DIM,SPACE_DIM>::GetNextSubstep(double maxStep) const
+{
+    return mStepController.GetStep(maxStep);
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractAdaptiveNumericalMethod<ELEMENT_DIM,SPACE_DIM>::OutputStepStatistics(std::ostream& rStream) const
+{
+    BufferedTextEmitter emitter(256);
+    emitter.SetUseShortestRoundTrip(true);
+    emitter << "AcceptedSteps\t" << GetNumAcceptedSteps() << '\n'
+            << "RejectedSteps\t" << GetNumRejectedSteps() << '\n'
+            << "ForceEvaluations\t" << GetNumForceEvaluations() << '\n'
+            << "SmallestAcceptedStep\t" << GetSmallestAcceptedStep() << '\n'
+            << "LargestAcceptedStep\t" << GetLargestAcceptedStep() << '\n';
+    emitter.FlushTo(rStream);
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractAdaptiveNumericalMethod<ELEMENT_DIM,SPACE_DIM>::OutputNumericalMethodParameters(out_stream& rParamsFile)
+{
+    *rParamsFile << "\t\t\t<Tolerance>" << mTolerance << "</Tolerance>\n";
+
+    // Call method on direct parent class
+    AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>::OutputNumericalMethodParameters(rParamsFile);
+}
+
+// Explicit instantiation
+template class AbstractAdaptiveNumericalMethod<1,1>;
+template class AbstractAdaptiveNumericalMethod<1,2>;
+template class AbstractAdaptiveNumericalMethod<2,2>;
+template class AbstractAdaptiveNumericalMethod<1,3>;
+template class AbstractAdaptiveNumericalMethod<2,3>;
+template class AbstractAdaptiveNumericalMethod<3,3>;
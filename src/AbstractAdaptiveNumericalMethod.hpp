@@ -0,0 +1,224 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef ABSTRACTADAPTIVENUMERICALMETHOD_HPP_
+#define ABSTRACTADAPTIVENUMERICALMETHOD_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+#include <iostream>
+#include <vector>
+#include "AbstractNumericalMethod.hpp"
+#include "AdaptiveStepController.hpp"
+
+/**
+ * Base class for the numerical methods that integrate over each time step in
+ * sub-steps chosen by an error estimate, so that the simulation time step
+ * (and hence the number of ReMesh() calls, modifier updates etc.) can be
+ * several times larger than ForwardEulerNumericalMethod allows at the same
+ * accuracy.
+ *
+ * UpdateAllNodePositions(dt) asks the subclass to attempt sub-steps from the
+ * current node locations and accepts or rejects each of them with an
+ * AdaptiveStepController, which also proposes the next sub-step. The proposal
+ * is kept from one time step to the next.
+ *
+ * The mesh is not remeshed during a time step, so T1 swaps are detected at the
+ * same points as with forward Euler. To keep this consistent, the total
+ * displacement of each node over the time step goes through the same
+ * DetectStepSizeExceptions() check as a forward Euler step. In a vertex
+ * simulation this restricts vertices to half the cell rearrangement threshold
+ * per time step, or (with an adaptive time step) has the simulation retry
+ * with a shorter one.
+ *
+ * The sub-steps are instrumented: GetNumAcceptedSteps(), GetNumRejectedSteps()
+ * and GetNumForceEvaluations() count over the whole simulation, and
+ * OutputStepStatistics() writes them out.
+ */
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM=ELEMENT_DIM>
+class AbstractAdaptiveNumericalMethod : public AbstractNumericalMethod<ELEMENT_DIM, SPACE_DIM>
+{
+private:
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Serialize the object and its member variables.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractNumericalMethod<ELEMENT_DIM, SPACE_DIM> >(*this);
+        archive & mTolerance;
+    }
+
+    /** The largest acceptable error estimate of a sub-step. Defaults to 1e-4. */
+    double mTolerance;
+
+    /** Accepts or rejects the sub-steps. Not archived. */
+    AdaptiveStepController mStepController;
+
+    /** The number of force calculations over the simulation. Not archived. */
+    unsigned mNumForceEvaluations;
+
+protected:
+
+    /** The node locations at the start of the current sub-step, in node iterator order. */
+    std::vector<c_vector<double, SPACE_DIM> > mSubstepStartLocations;
+
+    /**
+     * Calculate the forces on the nodes at their current locations, divided by
+     * the damping constants, and count the calculation.
+     *
+     * @return the force on each node, in node iterator order
+     */
+    std::vector<c_vector<double, SPACE_DIM> > ComputeForces();
+
+    /**
+     * Move the nodes.
+     *
+     * @param rLocations the new location of each node, in node iterator order
+     */
+    void SetNodeLocations(const std::vector<c_vector<double, SPACE_DIM> >& rLocations);
+
+    /**
+     * Called at the start of each time step, before any sub-step, e.g. to
+     * forget forces from before the last remesh.
+     */
+    virtual void BeginTimeStep()=0;
+
+    /**
+     * Move the nodes from mSubstepStartLocations by one sub-step.
+     *
+     * @param substep the length of the sub-step
+     * @return the largest norm of the error estimate over the nodes
+     */
+    virtual double AttemptSubstep(double substep)=0;
+
+    /**
+     * Called when the last attempted sub-step is accepted, with the nodes in
+     * their new locations, e.g. to keep the forces there for the next sub-step.
+     */
+    virtual void AcceptSubstep()=0;
+
+    /**
+     * @return the order of the lower-order method of the error estimate
+     */
+    virtual unsigned GetErrorOrder() const=0;
+
+public:
+
+    /**
+     * Constructor.
+     */
+    AbstractAdaptiveNumericalMethod();
+
+    /**
+     * Destructor.
+     */
+    virtual ~AbstractAdaptiveNumericalMethod();
+
+    /**
+     * Overridden UpdateAllNodePositions() method.
+     *
+     * @param dt the time step
+     */
+    virtual void UpdateAllNodePositions(double dt);
+
+    /**
+     * Set the largest acceptable error estimate of a sub-step: the largest
+     * estimated error in the position of any node, in units of length.
+     *
+     * @param tolerance the tolerance
+     */
+    void SetTolerance(double tolerance);
+
+    /**
+     * @return the largest acceptable error estimate of a sub-step
+     */
+    double GetTolerance() const;
+
+    /**
+     * @return the number of accepted sub-steps
+     */
+    unsigned GetNumAcceptedSteps() const;
+
+    /**
+     * @return the number of rejected sub-steps
+     */
+    unsigned GetNumRejectedSteps() const;
+
+    /**
+     * @return the number of force calculations
+     */
+    unsigned GetNumForceEvaluations() const;
+
+    /**
+     * @return the smallest accepted sub-step, or 0 if there was none
+     */
+    double GetSmallestAcceptedStep() const;
+
+    /**
+     * @return the largest accepted sub-step, or 0 if there was none
+     */
+    double GetLargestAcceptedStep() const;
+
+    /**
+     * @param maxStep the longest sub-step allowed, e.g. the time step
+     * @return the sub-step the method would attempt next, as proposed by the
+     *     error estimates so far, or maxStep if that is shorter
+     */
+    double GetNextSubstep(double maxStep) const;
+
+    /**
+     * Write the sub-step counts and the extreme accepted sub-steps, one per line
+     * as name and value separated by a tab.
+     *
+     * @param rStream the stream to write to
+     */
+    void OutputStepStatistics(std::ostream& rStream) const;
+
+    /**
+     * Overridden OutputNumericalMethodParameters() method.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    virtual void OutputNumericalMethodParameters(out_stream& rParamsFile);
+};
+
+#endif /*ABSTRACTADAPTIVENUMERICALMETHOD_HPP_*/
@@ -0,0 +1,410 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef ABSTRACTPROJECTWRITER_HPP_
+#define ABSTRACTPROJECTWRITER_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+#include <boost/shared_ptr.hpp>
+#include <string>
+#include "Exception.hpp"
+#include "OutputFileHandler.hpp"
+#include "SimulationTime.hpp"
+#include "BufferedTextEmitter.hpp"
+#include "GzipBlockStreamBuffer.hpp"
+#include "SweepResultsStore.hpp"
+#include "ElementGeometryCache.hpp"
+
+/**
+ * Output handling shared by the writers in this project.
+ *
+ * This class sits between a writer and the Chaste writer base class it would
+ * otherwise derive from (AbstractCellWriter, AbstractCellPopulationWriter or
+ * AbstractCellPopulationCountWriter), e.g.
+ *
+ *   class MyWriter : public AbstractProjectWriter<AbstractCellWriter<ELEMENT_DIM, SPACE_DIM> >
+ *
+ * Writers should write their output through mEmitter rather than directly to
+ * mpOutStream. The emitter formats numbers without going through the stream's
+ * locale machinery, and its contents are written to mpOutStream in bulk by
+ * FlushEmitter(), which is called from WriteNewline() and CloseFile().
+ *
+ * Writers may also opt into gzip-compressed output with SetCompressOutput(true).
+ * The output file gets a ".gz" suffix and everything written to mpOutStream is
+ * compressed in blocks by a GzipBlockStreamBuffer. The compressing buffer is
+ * installed by BeginOutputBlock(), which is called from WriteTimeStamp(), and
+ * removed again by CloseFile(). Subclasses that override WriteTimeStamp(), or
+ * that write to the file before it is called (e.g. in WriteHeader()), must call
+ * BeginOutputBlock() themselves before writing.
+ *
+ * Writers may be given a SweepResultsStore with SetResultsStore(), in
+ * which case the contents of mEmitter are appended to the store (as a dataset
+ * named after the output file) and the output file is not opened at all.
+ *
+ * Finally, writers that need the areas, perimeters, centroids or shapes of
+ * the cells of a 2D vertex mesh should get them from rGetElementGeometry().
+ * Writers given the same ElementGeometryCache with SetElementGeometryCache()
+ * share one calculation at an output time step; a writer without one makes
+ * its own.
+ */
+template<class BASE_WRITER>
+class AbstractProjectWriter : public BASE_WRITER
+{
+private:
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Serialize the object and its member variables.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<BASE_WRITER>(*this);
+        archive & mCompressOutput;
+        archive & mCompressionBlockSize;
+    }
+
+    /** Whether to gzip-compress the output file. Defaults to false. */
+    bool mCompressOutput;
+
+    /** Amount of uncompressed data, in bytes, per compressed block. Defaults to 1 MiB. */
+    unsigned mCompressionBlockSize;
+
+    /** The compressing stream buffer, if one is currently installed on mpOutStream. */
+    boost::shared_ptr<GzipBlockStreamBuffer> mpCompressedBuffer;
+
+    /** The stream buffer of mpOutStream that mpCompressedBuffer replaced. */
+    std::streambuf* mpOriginalBuffer;
+
+    /** The store that output goes to instead of mpOutStream, if any. Not archived. */
+    boost::shared_ptr<SweepResultsStore> mpResultsStore;
+
+    /** The cache that the element geometry comes from. Not archived. */
+    boost::shared_ptr<ElementGeometryCache> mpElementGeometryCache;
+
+    /** The element geometry fetched in the current block of output, if any. Not archived. */
+    const ElementGeometryKernel* mpElementGeometry;
+
+protected:
+
+    /** Buffer that subclasses write their output to; see FlushEmitter(). */
+    BufferedTextEmitter mEmitter;
+
+    /**
+     * Write the contents of mEmitter to mpOutStream, or append them to the
+     * results store if one has been set.
+     */
+    void FlushEmitter()
+    {
+        if (mpResultsStore)
+        {
+            if (!mEmitter.IsEmpty())
+            {
+                mpResultsStore->Append(this->mFileName, mEmitter.GetString());
+                mEmitter.Clear();
+            }
+        }
+        else if (this->mpOutStream)
+        {
+            mEmitter.FlushTo(*(this->mpOutStream));
+        }
+    }
+
+    /**
+     * Make sure that mpOutStream is ready for the writing of a block of output.
+     * If compression is switched on, this installs the compressing stream buffer.
+     * Calling this more than once between two calls to CloseFile() has no effect,
+     * other than to forget the element geometry; see rGetElementGeometry().
+     */
+    void BeginOutputBlock()
+    {
+        mpElementGeometry = nullptr;
+        if (mCompressOutput && this->mpOutStream && !mpCompressedBuffer)
+        {
+            std::ostream& r_stream = *(this->mpOutStream);
+            mpCompressedBuffer.reset(new GzipBlockStreamBuffer(r_stream.rdbuf(), mCompressionBlockSize));
+            mpOriginalBuffer = r_stream.rdbuf(mpCompressedBuffer.get());
+        }
+    }
+
+    /**
+     * Finish the current block of output. If compression is switched on, any
+     * buffered data are written out as a complete gzip member and mpOutStream
+     * gets its original stream buffer back.
+     */
+    void EndOutputBlock()
+    {
+        mpElementGeometry = nullptr;
+        if (mpCompressedBuffer)
+        {
+            mpCompressedBuffer->pubsync();
+            if (this->mpOutStream)
+            {
+                std::ostream& r_stream = *(this->mpOutStream);
+                r_stream.rdbuf(mpOriginalBuffer);
+            }
+            mpCompressedBuffer.reset();
+            mpOriginalBuffer = nullptr;
+        }
+    }
+
+    /**
+     * Get the geometry of the elements of a 2D vertex mesh from the
+     * ElementGeometryCache. The geometry is only fetched once per block of
+     * output, so writers may call this from VisitCell().
+     *
+     * @param rMesh the mesh
+     * @return the geometry, indexed by element index
+     */
+    const ElementGeometryKernel& rGetElementGeometry(MutableVertexMesh<2,2>& rMesh)
+    {
+        if (!mpElementGeometry)
+        {
+            if (!mpElementGeometryCache)
+            {
+                mpElementGeometryCache.reset(new ElementGeometryCache());
+            }
+            mpElementGeometry = &mpElementGeometryCache->rGetGeometry(rMesh);
+        }
+        return *mpElementGeometry;
+    }
+
+    /**
+     * Overload for the other dimensions, which the writers are instantiated
+     * for but do not call it in.
+     *
+     * @param rMesh the mesh
+     * @return never returns
+     */
+    template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+    const ElementGeometryKernel& rGetElementGeometry(MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>& rMesh)
+    {
+        EXCEPTION("The element geometry is only available for 2D vertex meshes");
+    }
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param rFileName the name of the file to write to
+     */
+    AbstractProjectWriter(const std::string& rFileName)
+        : BASE_WRITER(rFileName),
+          mCompressOutput(false),
+          mCompressionBlockSize(1u << 20),
+          mpOriginalBuffer(nullptr),
+          mpElementGeometry(nullptr)
+    {
+    }
+
+    /**
+     * Destructor.
+     */
+    virtual ~AbstractProjectWriter()
+    {
+        EndOutputBlock();
+    }
+
+    /**
+     * Overridden OpenOutputFile() method. Does not create the output file if
+     * this writer's output goes to a results store.
+     *
+     * @param rOutputFileHandler handler for the directory in which to open this file
+     */
+    virtual void OpenOutputFile(OutputFileHandler& rOutputFileHandler)
+    {
+        if (mpResultsStore)
+        {
+            this->mpOutStream.reset();
+        }
+        else
+        {
+            BASE_WRITER::OpenOutputFile(rOutputFileHandler);
+        }
+    }
+
+    /**
+     * Overridden OpenOutputFileForAppend() method. Does not create the output
+     * file if this writer's output goes to a results store.
+     *
+     * @param rOutputFileHandler handler for the directory in which to open this file
+     */
+    virtual void OpenOutputFileForAppend(OutputFileHandler& rOutputFileHandler)
+    {
+        if (mpResultsStore)
+        {
+            this->mpOutStream.reset();
+        }
+        else
+        {
+            BASE_WRITER::OpenOutputFileForAppend(rOutputFileHandler);
+        }
+    }
+
+    /**
+     * Overridden WriteTimeStamp() method. Begins a block of output and writes the
+     * time stamp in the same format as the base class, but through mEmitter.
+     */
+    virtual void WriteTimeStamp()
+    {
+        BeginOutputBlock();
+        mEmitter << SimulationTime::Instance()->GetTime() << '\t';
+    }
+
+    /**
+     * Overridden WriteNewline() method. Writes the newline through mEmitter and
+     * flushes it.
+     */
+    virtual void WriteNewline()
+    {
+        mEmitter << '\n';
+        FlushEmitter();
+    }
+
+    /**
+     * Overridden CloseFile() method. Flushes mEmitter and finishes any compressed
+     * block before closing the file, so that each open/close cycle leaves a
+     * complete gzip member behind.
+     */
+    virtual void CloseFile()
+    {
+        FlushEmitter();
+        EndOutputBlock();
+        if (this->mpOutStream)
+        {
+            BASE_WRITER::CloseFile();
+        }
+    }
+
+    /**
+     * Set whether to gzip-compress the output file. This must be called before
+     * the output file is opened; ".gz" is added to (or removed from) the file name.
+     *
+     * @param compressOutput whether to compress the output
+     */
+    void SetCompressOutput(bool compressOutput)
+    {
+        const std::string suffix = ".gz";
+        bool has_suffix = this->mFileName.size() >= suffix.size()
+                && this->mFileName.compare(this->mFileName.size() - suffix.size(), suffix.size(), suffix) == 0;
+
+        if (compressOutput && !has_suffix)
+        {
+            this->mFileName += suffix;
+        }
+        else if (!compressOutput && has_suffix)
+        {
+            this->mFileName.erase(this->mFileName.size() - suffix.size());
+        }
+        mCompressOutput = compressOutput;
+    }
+
+    /**
+     * Send this writer's output to a results store rather than to its output file.
+     * This must be called before the output file is opened.
+     *
+     * @param pResultsStore the store, or an empty pointer to write to the output file again
+     */
+    void SetResultsStore(boost::shared_ptr<SweepResultsStore> pResultsStore)
+    {
+        mpResultsStore = pResultsStore;
+    }
+
+    /**
+     * @return the results store this writer's output goes to, if any
+     */
+    boost::shared_ptr<SweepResultsStore> GetResultsStore() const
+    {
+        return mpResultsStore;
+    }
+
+    /**
+     * Share an element geometry cache with the other writers of a simulation.
+     *
+     * @param pElementGeometryCache the cache
+     */
+    void SetElementGeometryCache(boost::shared_ptr<ElementGeometryCache> pElementGeometryCache)
+    {
+        mpElementGeometryCache = pElementGeometryCache;
+        mpElementGeometry = nullptr;
+    }
+
+    /**
+     * @return the element geometry cache this writer uses, if it has one yet
+     */
+    boost::shared_ptr<ElementGeometryCache> GetElementGeometryCache() const
+    {
+        return mpElementGeometryCache;
+    }
+
+    /**
+     * @return whether the output file is gzip-compressed
+     */
+    bool GetCompressOutput() const
+    {
+        return mCompressOutput;
+    }
+
+    /**
+     * Set the amount of uncompressed data per compressed block. Smaller blocks lose
+     * less data in a crash; larger blocks compress better.
+     *
+     * @param blockSize the block size in bytes
+     */
+    void SetCompressionBlockSize(unsigned blockSize)
+    {
+        if (blockSize == 0)
+        {
+            EXCEPTION("The compression block size must be positive");
+        }
+        mCompressionBlockSize = blockSize;
+    }
+
+    /**
+     * @return the amount of uncompressed data per compressed block, in bytes
+     */
+    unsigned GetCompressionBlockSize() const
+    {
+        return mCompressionBlockSize;
+    }
+};
+
+#endif /*ABSTRACTPROJECTWRITER_HPP_*/
@@ -0,0 +1,159 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "AdaptiveStepController.hpp"
+#include "Exception.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    /** The fraction of the optimal step that is proposed, to make rejections rarer. */
+    const double SAFETY_FACTOR = 0.9;
+
+    /** The smallest factor by which a step may shrink. */
+    const double MIN_FACTOR = 0.2;
+
+    /** The largest factor by which a step may grow. */
+    const double MAX_FACTOR = 5.0;
+}
+
+AdaptiveStepController::AdaptiveStepController(double tolerance, unsigned errorOrder)
+    : mTolerance(0.0),
+      mErrorOrder(1u),
+      mNextStep(0.0),
+      mNumAcceptedSteps(0u),
+      mNumRejectedSteps(0u),
+      mSmallestAcceptedStep(0.0),
+      mLargestAcceptedStep(0.0)
+{
+    SetTolerance(tolerance);
+    SetErrorOrder(errorOrder);
+}
+
+void AdaptiveStepController::SetTolerance(double tolerance)
+{
+    if (!(tolerance > 0.0))
+    {
+        EXCEPTION("The tolerance must be positive");
+    }
+    mTolerance = tolerance;
+}
+
+double AdaptiveStepController::GetTolerance() const
+{
+    return mTolerance;
+}
+
+void AdaptiveStepController::SetErrorOrder(unsigned errorOrder)
+{
+    if (errorOrder == 0u)
+    {
+        EXCEPTION("The order of the error estimate must be positive");
+    }
+    mErrorOrder = errorOrder;
+}
+
+unsigned AdaptiveStepController::GetErrorOrder() const
+{
+    return mErrorOrder;
+}
+
+double AdaptiveStepController::GetStep(double maxStep) const
+{
+    if (mNextStep > 0.0 && mNextStep < maxStep)
+    {
+        return mNextStep;
+    }
+    return maxStep;
+}
+
+bool AdaptiveStepController::RecordStep(double step, double error)
+{
+    // A NaN error shrinks the step as much as possible
+    double factor = MIN_FACTOR;
+    if (error == 0.0)
+    {
+        factor = MAX_FACTOR;
+    }
+    else if (error > 0.0)
+    {
+        factor = SAFETY_FACTOR*std::pow(mTolerance/error, 1.0/(mErrorOrder + 1.0));
+        factor = std::max(MIN_FACTOR, std::min(MAX_FACTOR, factor));
+    }
+
+    bool accepted = (error <= mTolerance);
+    if (accepted)
+    {
+        mNumAcceptedSteps++;
+        mSmallestAcceptedStep = (mNumAcceptedSteps == 1u) ? step : std::min(mSmallestAcceptedStep, step);
+        mLargestAcceptedStep = std::max(mLargestAcceptedStep, step);
+        if (factor >= 1.0 && step < mNextStep)
+        {
+            mNextStep = std::max(mNextStep, factor*step);
+        }
+        else
+        {
+            mNextStep = factor*step;
+        }
+    }
+    else
+    {
+        mNumRejectedSteps++;
+        mNextStep = std::min(factor, 1.0)*step;
+    }
+    return accepted;
+}
+
+unsigned AdaptiveStepController::GetNumAcceptedSteps() const
+{
+    return mNumAcceptedSteps;
+}
+
+unsigned AdaptiveStepController::GetNumRejectedSteps() const
+{
+    return mNumRejectedSteps;
+}
+
+double AdaptiveStepController::GetSmallestAcceptedStep() const
+{
+    return mSmallestAcceptedStep;
+}
+
+double AdaptiveStepController::GetLargestAcceptedStep() const
+{
+    return mLargestAcceptedStep;
+}
@@ -0,0 +1,149 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef ADAPTIVESTEPCONTROLLER_HPP_
+#define ADAPTIVESTEPCONTROLLER_HPP_
+
+/**
+ * Step size control for the adaptive numerical methods (see
+ * AbstractAdaptiveNumericalMethod), kept apart from Chaste so that it can be
+ * tested on its own.
+ *
+ * A step is accepted if its error estimate is at most the tolerance. Either
+ * way the next step is the standard
+ *
+ *   h_new = h * 0.9 * (tolerance/error)^(1/(p+1)),
+ *
+ * where p is the order of the lower-order method of the error estimate. The
+ * factor is kept between 0.2 and 5, so that a single estimate cannot change
+ * the step by much. The controller also counts the accepted and rejected
+ * steps, to show how well a tolerance suits a simulation.
+ */
+class AdaptiveStepController
+{
+private:
+
+    /** The largest acceptable error estimate. */
+    double mTolerance;
+
+    /** The order p of the lower-order method of the error estimate. */
+    unsigned mErrorOrder;
+
+    /** The step to try next, or 0 if no step has been tried yet. */
+    double mNextStep;
+
+    /** The number of accepted steps. */
+    unsigned mNumAcceptedSteps;
+
+    /** The number of rejected steps. */
+    unsigned mNumRejectedSteps;
+
+    /** The smallest accepted step, or 0 if no step has been accepted. */
+    double mSmallestAcceptedStep;
+
+    /** The largest accepted step. */
+    double mLargestAcceptedStep;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param tolerance the largest acceptable error estimate
+     * @param errorOrder the order of the lower-order method of the error estimate
+     */
+    AdaptiveStepController(double tolerance, unsigned errorOrder);
+
+    /**
+     * @param tolerance the largest acceptable error estimate
+     */
+    void SetTolerance(double tolerance);
+
+    /**
+     * @return the largest acceptable error estimate
+     */
+    double GetTolerance() const;
+
+    /**
+     * @param errorOrder the order of the lower-order method of the error estimate
+     */
+    void SetErrorOrder(unsigned errorOrder);
+
+    /**
+     * @return the order of the lower-order method of the error estimate
+     */
+    unsigned GetErrorOrder() const;
+
+    /**
+     * @param maxStep the largest step allowed, e.g. the rest of the time step
+     * @return the step to try next: the step proposed by the last call to
+     *     RecordStep(), or maxStep if that is smaller or there was no call
+     */
+    double GetStep(double maxStep) const;
+
+    /**
+     * Decide whether a step is accepted, and propose the next step.
+     *
+     * A step shorter than the proposed one (because it was cut short by
+     * GetStep()'s maxStep) does not shrink the proposal if it was accurate.
+     *
+     * @param step the step taken
+     * @param error the error estimate of the step; NaN is never accepted
+     * @return whether the step is accepted
+     */
+    bool RecordStep(double step, double error);
+
+    /**
+     * @return the number of accepted steps
+     */
+    unsigned GetNumAcceptedSteps() const;
+
+    /**
+     * @return the number of rejected steps
+     */
+    unsigned GetNumRejectedSteps() const;
+
+    /**
+     * @return the smallest accepted step, or 0 if no step has been accepted
+     */
+    double GetSmallestAcceptedStep() const;
+
+    /**
+     * @return the largest accepted step, or 0 if no step has been accepted
+     */
+    double GetLargestAcceptedStep() const;
+};
+
+#endif /*ADAPTIVESTEPCONTROLLER_HPP_*/
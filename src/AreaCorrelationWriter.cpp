@@ -34,6 +34,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "AreaCorrelationWriter.hpp"
+#include "NeighbourCorrelation.hpp"
 
 #include "AbstractCellPopulation.hpp"
 #include "MeshBasedCellPopulation.hpp"
@@ -43,6 +44,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "VertexBasedCellPopulation.hpp"
 #include "ImmersedBoundaryCellPopulation.hpp"
 #include "SimulationTime.hpp"
+#include "VertexMeshNeighbours.hpp"
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics.hpp>
 #include <boost/accumulators/statistics/mean.hpp>
@@ -54,17 +56,19 @@ using namespace boost::accumulators;
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 AreaCorrelationWriter<ELEMENT_DIM, SPACE_DIM>::AreaCorrelationWriter()
-    : AbstractCellPopulationCountWriter<ELEMENT_DIM, SPACE_DIM>("AreaCorrelations.dat")
+    : AbstractProjectWriter<AbstractCellPopulationCountWriter<ELEMENT_DIM, SPACE_DIM> >("AreaCorrelations.dat")
 {
 }
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void AreaCorrelationWriter<ELEMENT_DIM, SPACE_DIM>::WriteHeader(AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>* pCellPopulation)
 {
+    this->BeginOutputBlock();
+
     if (PetscTools::AmMaster())
     {
 
-        *this->mpOutStream << "Time Area_Correlation";
+        this->mEmitter << "Time Area_Correlation";
 
         this->WriteNewline();
     }
@@ -99,6 +103,7 @@ c_vector<double, 2> AreaCorrelationWriter<ELEMENT_DIM, SPACE_DIM>::GetMeanIntern
 {
     if (SPACE_DIM == 2 && ELEMENT_DIM == 2){
 	accumulator_set< double, features<tag::mean, tag::variance> > area_accumulator;
+    const std::vector<double>& r_areas = this->rGetElementGeometry(pCellPopulation->rGetMesh()).rGetAreas();
 
     for (typename AbstractCellPopulation<SPACE_DIM>::Iterator cell_iter = pCellPopulation->Begin();
          cell_iter != pCellPopulation->End();
@@ -106,7 +111,7 @@ c_vector<double, 2> AreaCorrelationWriter<ELEMENT_DIM, SPACE_DIM>::GetMeanIntern
     {
         if( !pCellPopulation->GetElementCorrespondingToCell(*cell_iter)->IsElementOnBoundary() )
         {
-	        double this_cell_area = pCellPopulation->GetVolumeOfCell(*cell_iter);
+	        double this_cell_area = r_areas[pCellPopulation->GetLocationIndexUsingCell(*cell_iter)];
 
 	        area_accumulator(this_cell_area);
         }
@@ -138,10 +143,11 @@ std::vector< c_vector<unsigned,2> > AreaCorrelationWriter<ELEMENT_DIM, SPACE_DIM
         {
             unsigned this_element_index = p_this_element->GetIndex();
 
-            std::set<unsigned> indices_of_neighbour_elements =
-                    pCellPopulation->rGetMesh().GetNeighbouringElementIndices(this_element_index);
+            SmallIndexSet indices_of_neighbour_elements;
+            VertexMeshNeighbours<SPACE_DIM, SPACE_DIM>::GetNeighbouringElementIndices(p_this_element,
+                                                                                   indices_of_neighbour_elements);
 
-            for( std::set<unsigned>::iterator this_iter = indices_of_neighbour_elements.begin();
+            for( SmallIndexSet::const_iterator this_iter = indices_of_neighbour_elements.begin();
                     this_iter != indices_of_neighbour_elements.end();
                     this_iter++)
             {
@@ -180,35 +186,41 @@ std::vector< c_vector<unsigned,2> > AreaCorrelationWriter<ELEMENT_DIM, SPACE_DIM
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void AreaCorrelationWriter<ELEMENT_DIM, SPACE_DIM>::Visit(VertexBasedCellPopulation<SPACE_DIM>* pCellPopulation)
+{
+    this->mEmitter << CalculateAreaCorrelation(pCellPopulation);
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double AreaCorrelationWriter<ELEMENT_DIM, SPACE_DIM>::CalculateAreaCorrelation(VertexBasedCellPopulation<SPACE_DIM>* pCellPopulation)
 {
     if (SPACE_DIM == 2 && ELEMENT_DIM == 2){
     std::vector< c_vector<unsigned,2> > internal_cell_pairs =
             GetAllInternalCellNeighbourIndexPairs(pCellPopulation);
 
-    c_vector<double, 2> internal_area_statistics = GetMeanInternalAreaAndVariance(pCellPopulation);
-
-    double mean_internal_area_squared = internal_area_statistics[0]*internal_area_statistics[0];
-    double internal_area_variance = internal_area_statistics[1];
-
-	accumulator_set< double, features<tag::mean> > correlations_accumulator;
-
-	for( std::vector< c_vector<unsigned,2> >::iterator this_pair = internal_cell_pairs.begin();
-	        this_pair != internal_cell_pairs.end();
-	        this_pair++)
-	{
-	    CellPtr first_cell = pCellPopulation->GetCellUsingLocationIndex((*this_pair)[0]);
-	    CellPtr second_cell = pCellPopulation->GetCellUsingLocationIndex((*this_pair)[1]);
-
-	    double first_cell_area = pCellPopulation->GetVolumeOfCell(first_cell);
-	    double second_cell_area = pCellPopulation->GetVolumeOfCell(second_cell);
-
-	    double this_correlation = (first_cell_area*second_cell_area - mean_internal_area_squared)/
-	            internal_area_variance;
+    // Gather the values by element index for the correlation kernel shared with ObservedTissueMesh
+    unsigned num_elements = pCellPopulation->rGetMesh().GetNumAllElements();
+    std::vector<double> values(num_elements, 0.0);
+    std::vector<bool> is_internal(num_elements, false);
+    const std::vector<double>& r_areas = this->rGetElementGeometry(pCellPopulation->rGetMesh()).rGetAreas();
+    for (typename AbstractCellPopulation<SPACE_DIM>::Iterator cell_iter = pCellPopulation->Begin();
+         cell_iter != pCellPopulation->End();
+         ++cell_iter)
+    {
+        auto p_element = pCellPopulation->GetElementCorrespondingToCell(*cell_iter);
+        if (!p_element->IsElementOnBoundary())
+        {
+            values[p_element->GetIndex()] = r_areas[p_element->GetIndex()];
+            is_internal[p_element->GetIndex()] = true;
+        }
+    }
 
-	    correlations_accumulator(this_correlation);
-	}
+    std::vector<std::pair<unsigned, unsigned> > pairs(internal_cell_pairs.size());
+    for (unsigned i=0; i<internal_cell_pairs.size(); i++)
+    {
+        pairs[i] = std::make_pair(internal_cell_pairs[i][0], internal_cell_pairs[i][1]);
+    }
 
-    *this->mpOutStream << mean(correlations_accumulator);
+    return NeighbourCorrelation::Calculate(values, is_internal, pairs);
     } else {
         EXCEPTION("This writer is supposed to be used with a VertexBasedCellPopulation only of 2 Spatial and Element dimensions.");
     }
@@ -0,0 +1,164 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "BudgetedOffLatticeSimulation.hpp"
+#include "DivergenceDetectionModifier.hpp"
+
+template<unsigned DIM>
+BudgetedOffLatticeSimulation<DIM>::BudgetedOffLatticeSimulation(AbstractCellPopulation<DIM>& rCellPopulation,
+                                                                bool deleteCellPopulationInDestructor,
+                                                                bool initialiseCells)
+    : OffLatticeSimulation<DIM>(rCellPopulation, deleteCellPopulationInDestructor, initialiseCells),
+      mWallTimeBudget(0.0),
+      mTimeStepBudget(0u),
+      mSolveStartTime(std::chrono::steady_clock::now()),
+      mSolveStartTimeStep(0u)
+{
+}
+
+template<unsigned DIM>
+void BudgetedOffLatticeSimulation<DIM>::SetupSolve()
+{
+    OffLatticeSimulation<DIM>::SetupSolve();
+
+    mSolveStartTime = std::chrono::steady_clock::now();
+    mSolveStartTimeStep = SimulationTime::Instance()->GetTimeStepsElapsed();
+    mTruncationReason.clear();
+}
+
+template<unsigned DIM>
+bool BudgetedOffLatticeSimulation<DIM>::StoppingEventHasOccurred()
+{
+    // Called before each time step, and not once the end time has been reached
+    if (HasDiverged())
+    {
+        return true;
+    }
+    if (mTimeStepBudget > 0u && GetSolveTimeSteps() >= mTimeStepBudget)
+    {
+        mTruncationReason = "TimeSteps";
+    }
+    else if (mWallTimeBudget > 0.0 && GetSolveWallTime() >= mWallTimeBudget)
+    {
+        mTruncationReason = "WallTime";
+    }
+    return !mTruncationReason.empty();
+}
+
+template<unsigned DIM>
+void BudgetedOffLatticeSimulation<DIM>::SetWallTimeBudget(double wallTimeBudget)
+{
+    if (!(wallTimeBudget >= 0.0))
+    {
+        EXCEPTION("The wall time budget must be non-negative");
+    }
+    mWallTimeBudget = wallTimeBudget;
+}
+
+template<unsigned DIM>
+double BudgetedOffLatticeSimulation<DIM>::GetWallTimeBudget() const
+{
+    return mWallTimeBudget;
+}
+
+template<unsigned DIM>
+void BudgetedOffLatticeSimulation<DIM>::SetTimeStepBudget(unsigned timeStepBudget)
+{
+    mTimeStepBudget = timeStepBudget;
+}
+
+template<unsigned DIM>
+unsigned BudgetedOffLatticeSimulation<DIM>::GetTimeStepBudget() const
+{
+    return mTimeStepBudget;
+}
+
+template<unsigned DIM>
+double BudgetedOffLatticeSimulation<DIM>::GetSolveWallTime() const
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - mSolveStartTime).count();
+}
+
+template<unsigned DIM>
+unsigned BudgetedOffLatticeSimulation<DIM>::GetSolveTimeSteps() const
+{
+    return SimulationTime::Instance()->GetTimeStepsElapsed() - mSolveStartTimeStep;
+}
+
+template<unsigned DIM>
+bool BudgetedOffLatticeSimulation<DIM>::WasTruncated() const
+{
+    return !mTruncationReason.empty();
+}
+
+template<unsigned DIM>
+bool BudgetedOffLatticeSimulation<DIM>::HasDiverged() const
+{
+    for (unsigned i=0; i<this->mSimulationModifiers.size(); i++)
+    {
+        boost::shared_ptr<DivergenceDetectionModifier<DIM> > p_modifier =
+            boost::dynamic_pointer_cast<DivergenceDetectionModifier<DIM> >(this->mSimulationModifiers[i]);
+        if (p_modifier && p_modifier->HasFailed())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+template<unsigned DIM>
+const std::string& BudgetedOffLatticeSimulation<DIM>::rGetTruncationReason() const
+{
+    return mTruncationReason;
+}
+
+template<unsigned DIM>
+void BudgetedOffLatticeSimulation<DIM>::OutputSimulationParameters(out_stream& rParamsFile)
+{
+    *rParamsFile << "\t\t<WallTimeBudget>" << mWallTimeBudget << "</WallTimeBudget>\n";
+    *rParamsFile << "\t\t<TimeStepBudget>" << mTimeStepBudget << "</TimeStepBudget>\n";
+
+    // Call method on direct parent class
+    OffLatticeSimulation<DIM>::OutputSimulationParameters(rParamsFile);
+}
+
+// Explicit instantiation
+template class BudgetedOffLatticeSimulation<1>;
+template class BudgetedOffLatticeSimulation<2>;
+template class BudgetedOffLatticeSimulation<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(BudgetedOffLatticeSimulation)
@@ -0,0 +1,215 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef BUDGETEDOFFLATTICESIMULATION_HPP_
+#define BUDGETEDOFFLATTICESIMULATION_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+#include <chrono>
+#include <string>
+
+#include "OffLatticeSimulation.hpp"
+
+/**
+ * An OffLatticeSimulation that stops early, through StoppingEventHasOccurred(),
+ * once it has used up a budget of wall-clock time or of time steps.
+ *
+ * Both budgets count from the start of each call to Solve(), so a simulation
+ * loaded from a checkpoint gets a fresh budget. Solve() then returns in the
+ * usual way, after the final remeshing and with the writers' files closed, and
+ * WasTruncated() says whether, and rGetTruncationReason() why, it stopped
+ * before the end time. The caller can then save a checkpoint with
+ * CellBasedSimulationArchiver and resume from it later; see
+ * PaperVertexSimulation. The budgets are not archived.
+ *
+ * It also stops once a DivergenceDetectionModifier among its modifiers has
+ * found a failure; HasDiverged() then says so, and WasTruncated() does not,
+ * since such a run is not to be resumed.
+ */
+template<unsigned DIM>
+class BudgetedOffLatticeSimulation : public OffLatticeSimulation<DIM>
+{
+private:
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Archive the object. The budgets and the state of the current Solve() are not archived.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<OffLatticeSimulation<DIM> >(*this);
+    }
+
+    /** The wall-clock time allowed per call to Solve(), in seconds, or 0 for no limit. */
+    double mWallTimeBudget;
+
+    /** The number of time steps allowed per call to Solve(), or 0 for no limit. */
+    unsigned mTimeStepBudget;
+
+    /** When the current call to Solve() started. */
+    std::chrono::steady_clock::time_point mSolveStartTime;
+
+    /** The number of time steps elapsed when the current call to Solve() started. */
+    unsigned mSolveStartTimeStep;
+
+    /** Why the last call to Solve() stopped early, "WallTime" or "TimeSteps", or empty if it did not. */
+    std::string mTruncationReason;
+
+protected:
+
+    /**
+     * Overridden SetupSolve() method. Starts the budgets.
+     */
+    virtual void SetupSolve();
+
+    /**
+     * Overridden StoppingEventHasOccurred() method.
+     *
+     * @return whether a budget has been used up, or the simulation has diverged
+     */
+    virtual bool StoppingEventHasOccurred();
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param rCellPopulation the cell population
+     * @param deleteCellPopulationInDestructor whether to delete the cell population on destruction
+     *     to free up memory (defaults to false)
+     * @param initialiseCells whether to initialise cells (defaults to true; false when loading from an archive)
+     */
+    BudgetedOffLatticeSimulation(AbstractCellPopulation<DIM>& rCellPopulation,
+                                 bool deleteCellPopulationInDestructor=false,
+                                 bool initialiseCells=true);
+
+    /**
+     * @param wallTimeBudget the wall-clock time allowed per call to Solve(), in seconds, or 0 for no limit
+     */
+    void SetWallTimeBudget(double wallTimeBudget);
+
+    /**
+     * @return the wall-clock time allowed per call to Solve(), in seconds, or 0 for no limit
+     */
+    double GetWallTimeBudget() const;
+
+    /**
+     * @param timeStepBudget the number of time steps allowed per call to Solve(), or 0 for no limit
+     */
+    void SetTimeStepBudget(unsigned timeStepBudget);
+
+    /**
+     * @return the number of time steps allowed per call to Solve(), or 0 for no limit
+     */
+    unsigned GetTimeStepBudget() const;
+
+    /**
+     * @return the wall-clock time taken so far by the current or last call to Solve(), in seconds
+     */
+    double GetSolveWallTime() const;
+
+    /**
+     * @return the number of time steps taken so far by the current or last call to Solve()
+     */
+    unsigned GetSolveTimeSteps() const;
+
+    /**
+     * @return whether the last call to Solve() stopped before the end time because a budget was used up
+     */
+    bool WasTruncated() const;
+
+    /**
+     * @return whether a DivergenceDetectionModifier among the modifiers has found a failure
+     */
+    bool HasDiverged() const;
+
+    /**
+     * @return why the last call to Solve() stopped early, "WallTime" or "TimeSteps", or an empty string
+     */
+    const std::string& rGetTruncationReason() const;
+
+    /**
+     * Overridden OutputSimulationParameters() method.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    void OutputSimulationParameters(out_stream& rParamsFile);
+};
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(BudgetedOffLatticeSimulation)
+
+namespace boost
+{
+namespace serialization
+{
+/**
+ * Serialize information required to construct a BudgetedOffLatticeSimulation.
+ */
+template<class Archive, unsigned DIM>
+inline void save_construct_data(
+    Archive & ar, const BudgetedOffLatticeSimulation<DIM> * t, const unsigned int file_version)
+{
+    // Save data required to construct instance
+    const AbstractCellPopulation<DIM>* p_cell_population = &(t->rGetCellPopulation());
+    ar & p_cell_population;
+}
+
+/**
+ * De-serialize constructor parameters and initialise a BudgetedOffLatticeSimulation.
+ */
+template<class Archive, unsigned DIM>
+inline void load_construct_data(
+    Archive & ar, BudgetedOffLatticeSimulation<DIM> * t, const unsigned int file_version)
+{
+    // Retrieve data from archive required to construct new instance
+    AbstractCellPopulation<DIM>* p_cell_population;
+    ar >> p_cell_population;
+
+    // Invoke inplace constructor to initialise instance; the loaded population
+    // is deleted with the simulation, and its cells are not initialised again
+    ::new(t)BudgetedOffLatticeSimulation<DIM>(*p_cell_population, true, false);
+}
+}
+} // namespace ...
+
+#endif /*BUDGETEDOFFLATTICESIMULATION_HPP_*/
@@ -0,0 +1,186 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "BufferedTextEmitter.hpp"
+#include "Exception.hpp"
+
+#include <charconv>
+#include <cstring>
+
+namespace
+{
+    /** Enough room for any double or 64-bit integer written by std::to_chars. */
+    const std::size_t MAX_NUMBER_LENGTH = 64;
+}
+
+BufferedTextEmitter::BufferedTextEmitter(std::size_t initialCapacity)
+    : mBuffer(initialCapacity > MAX_NUMBER_LENGTH ? initialCapacity : MAX_NUMBER_LENGTH),
+      mSize(0),
+      mPrecision(6),
+      mUseShortestRoundTrip(false)
+{
+}
+
+char* BufferedTextEmitter::Reserve(std::size_t numChars)
+{
+    if (mSize + numChars > mBuffer.size())
+    {
+        std::size_t new_capacity = 2*mBuffer.size();
+        while (mSize + numChars > new_capacity)
+        {
+            new_capacity *= 2;
+        }
+        mBuffer.resize(new_capacity);
+    }
+    return mBuffer.data() + mSize;
+}
+
+BufferedTextEmitter& BufferedTextEmitter::operator<<(double value)
+{
+    char* p_begin = Reserve(MAX_NUMBER_LENGTH);
+    std::to_chars_result result = mUseShortestRoundTrip
+            ? std::to_chars(p_begin, p_begin + MAX_NUMBER_LENGTH, value)
+            : std::to_chars(p_begin, p_begin + MAX_NUMBER_LENGTH, value, std::chars_format::general, mPrecision);
+    mSize += result.ptr - p_begin;
+    return *this;
+}
+
+BufferedTextEmitter& BufferedTextEmitter::operator<<(int value)
+{
+    char* p_begin = Reserve(MAX_NUMBER_LENGTH);
+    mSize += std::to_chars(p_begin, p_begin + MAX_NUMBER_LENGTH, value).ptr - p_begin;
+    return *this;
+}
+
+BufferedTextEmitter& BufferedTextEmitter::operator<<(unsigned value)
+{
+    char* p_begin = Reserve(MAX_NUMBER_LENGTH);
+    mSize += std::to_chars(p_begin, p_begin + MAX_NUMBER_LENGTH, value).ptr - p_begin;
+    return *this;
+}
+
+BufferedTextEmitter& BufferedTextEmitter::operator<<(long value)
+{
+    char* p_begin = Reserve(MAX_NUMBER_LENGTH);
+    mSize += std::to_chars(p_begin, p_begin + MAX_NUMBER_LENGTH, value).ptr - p_begin;
+    return *this;
+}
+
+BufferedTextEmitter& BufferedTextEmitter::operator<<(unsigned long value)
+{
+    char* p_begin = Reserve(MAX_NUMBER_LENGTH);
+    mSize += std::to_chars(p_begin, p_begin + MAX_NUMBER_LENGTH, value).ptr - p_begin;
+    return *this;
+}
+
+BufferedTextEmitter& BufferedTextEmitter::operator<<(bool value)
+{
+    return *this << (value ? '1' : '0');
+}
+
+BufferedTextEmitter& BufferedTextEmitter::operator<<(char value)
+{
+    *Reserve(1) = value;
+    mSize++;
+    return *this;
+}
+
+BufferedTextEmitter& BufferedTextEmitter::operator<<(const char* pValue)
+{
+    std::size_t length = std::strlen(pValue);
+    std::memcpy(Reserve(length), pValue, length);
+    mSize += length;
+    return *this;
+}
+
+BufferedTextEmitter& BufferedTextEmitter::operator<<(const std::string& rValue)
+{
+    std::memcpy(Reserve(rValue.size()), rValue.data(), rValue.size());
+    mSize += rValue.size();
+    return *this;
+}
+
+void BufferedTextEmitter::FlushTo(std::ostream& rStream)
+{
+    if (mSize > 0)
+    {
+        rStream.write(mBuffer.data(), mSize);
+        mSize = 0;
+    }
+}
+
+void BufferedTextEmitter::Clear()
+{
+    mSize = 0;
+}
+
+std::string BufferedTextEmitter::GetString() const
+{
+    return std::string(mBuffer.data(), mSize);
+}
+
+std::size_t BufferedTextEmitter::GetSize() const
+{
+    return mSize;
+}
+
+bool BufferedTextEmitter::IsEmpty() const
+{
+    return mSize == 0;
+}
+
+void BufferedTextEmitter::SetPrecision(int precision)
+{
+    if (precision <= 0 || precision > 17)
+    {
+        EXCEPTION("The precision must be between 1 and 17 significant digits");
+    }
+    mPrecision = precision;
+}
+
+int BufferedTextEmitter::GetPrecision() const
+{
+    return mPrecision;
+}
+
+void BufferedTextEmitter::SetUseShortestRoundTrip(bool useShortestRoundTrip)
+{
+    mUseShortestRoundTrip = useShortestRoundTrip;
+}
+
+bool BufferedTextEmitter::GetUseShortestRoundTrip() const
+{
+    return mUseShortestRoundTrip;
+}
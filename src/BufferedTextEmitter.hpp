@@ -0,0 +1,218 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef BUFFEREDTEXTEMITTER_HPP_
+#define BUFFEREDTEXTEMITTER_HPP_
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * A buffer for formatting numbers and text quickly before they are written to
+ * an output stream in bulk.
+ *
+ * Numbers are formatted with std::to_chars, which avoids the locale and
+ * stream-state machinery of std::ostream::operator<<. By default doubles are
+ * written exactly as an std::ostream with default flags would write them
+ * (general format with precision 6), so files written through this class are
+ * byte-for-byte identical to the ones written with operator<< directly. If
+ * SetUseShortestRoundTrip(true) is called, doubles are instead written with the
+ * shortest representation that reads back to the same value.
+ *
+ * The buffer grows as needed and keeps its capacity when flushed, so it can be
+ * reused for every block of output without further allocation.
+ */
+class BufferedTextEmitter
+{
+private:
+
+    /** The character buffer. Only the first mSize characters are in use. */
+    std::vector<char> mBuffer;
+
+    /** The number of characters currently in the buffer. */
+    std::size_t mSize;
+
+    /** The number of significant digits used for doubles. Defaults to 6. */
+    int mPrecision;
+
+    /** Whether to use shortest round-trip formatting for doubles. Defaults to false. */
+    bool mUseShortestRoundTrip;
+
+    /**
+     * Make sure there is room for at least a given number of further characters.
+     *
+     * @param numChars the number of characters
+     * @return a pointer to the first free character in the buffer
+     */
+    char* Reserve(std::size_t numChars);
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param initialCapacity the initial size of the buffer in bytes, defaults to 64 KiB
+     */
+    BufferedTextEmitter(std::size_t initialCapacity=(1u << 16));
+
+    /**
+     * Append a double.
+     *
+     * @param value the value
+     * @return this emitter
+     */
+    BufferedTextEmitter& operator<<(double value);
+
+    /**
+     * Append an int.
+     *
+     * @param value the value
+     * @return this emitter
+     */
+    BufferedTextEmitter& operator<<(int value);
+
+    /**
+     * Append an unsigned.
+     *
+     * @param value the value
+     * @return this emitter
+     */
+    BufferedTextEmitter& operator<<(unsigned value);
+
+    /**
+     * Append a long.
+     *
+     * @param value the value
+     * @return this emitter
+     */
+    BufferedTextEmitter& operator<<(long value);
+
+    /**
+     * Append an unsigned long (e.g. a std::size_t).
+     *
+     * @param value the value
+     * @return this emitter
+     */
+    BufferedTextEmitter& operator<<(unsigned long value);
+
+    /**
+     * Append a bool, as 1 or 0 (like a stream without std::boolalpha).
+     *
+     * @param value the value
+     * @return this emitter
+     */
+    BufferedTextEmitter& operator<<(bool value);
+
+    /**
+     * Append a single character.
+     *
+     * @param value the character
+     * @return this emitter
+     */
+    BufferedTextEmitter& operator<<(char value);
+
+    /**
+     * Append a C string.
+     *
+     * @param pValue the string
+     * @return this emitter
+     */
+    BufferedTextEmitter& operator<<(const char* pValue);
+
+    /**
+     * Append a string.
+     *
+     * @param rValue the string
+     * @return this emitter
+     */
+    BufferedTextEmitter& operator<<(const std::string& rValue);
+
+    /**
+     * Write the contents of the buffer to a stream with a single call, and
+     * empty the buffer.
+     *
+     * @param rStream the stream
+     */
+    void FlushTo(std::ostream& rStream);
+
+    /**
+     * Empty the buffer without writing its contents anywhere.
+     */
+    void Clear();
+
+    /**
+     * @return the contents of the buffer as a string
+     */
+    std::string GetString() const;
+
+    /**
+     * @return the number of characters in the buffer
+     */
+    std::size_t GetSize() const;
+
+    /**
+     * @return whether the buffer is empty
+     */
+    bool IsEmpty() const;
+
+    /**
+     * Set the number of significant digits used for doubles. This is ignored
+     * when shortest round-trip formatting is used.
+     *
+     * @param precision the precision
+     */
+    void SetPrecision(int precision);
+
+    /**
+     * @return the number of significant digits used for doubles
+     */
+    int GetPrecision() const;
+
+    /**
+     * Set whether doubles are written in the shortest form that reads back
+     * to the same value, rather than with a fixed number of significant digits.
+     *
+     * @param useShortestRoundTrip whether to use shortest round-trip formatting
+     */
+    void SetUseShortestRoundTrip(bool useShortestRoundTrip);
+
+    /**
+     * @return whether shortest round-trip formatting is used for doubles
+     */
+    bool GetUseShortestRoundTrip() const;
+};
+
+#endif /*BUFFEREDTEXTEMITTER_HPP_*/
@@ -0,0 +1,281 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "CellDataTable.hpp"
+#include "Exception.hpp"
+#include "VertexBasedCellPopulation.hpp"
+
+#include <map>
+
+CellDataTable::CellDataTable()
+    : mNumAllElements(0u),
+      mNumElements(0u)
+{
+}
+
+void CellDataTable::CheckHandle(unsigned handle) const
+{
+    if (handle >= mItemNames.size())
+    {
+        EXCEPTION("There is no cell data item with handle " << handle);
+    }
+}
+
+unsigned CellDataTable::RegisterItem(const std::string& rName)
+{
+    for (unsigned handle=0; handle<mItemNames.size(); handle++)
+    {
+        if (mItemNames[handle] == rName)
+        {
+            return handle;
+        }
+    }
+    mItemNames.push_back(rName);
+    mValues.push_back(std::vector<double>());
+
+    // Have the next UpdateLayout() read the new item from the cells
+    mCells.clear();
+    mLocationIndices.clear();
+    mCellData.clear();
+    return mItemNames.size() - 1;
+}
+
+unsigned CellDataTable::GetHandle(const std::string& rName) const
+{
+    for (unsigned handle=0; handle<mItemNames.size(); handle++)
+    {
+        if (mItemNames[handle] == rName)
+        {
+            return handle;
+        }
+    }
+    EXCEPTION("The cell data item \"" << rName << "\" has not been registered");
+}
+
+const std::string& CellDataTable::rGetItemName(unsigned handle) const
+{
+    CheckHandle(handle);
+    return mItemNames[handle];
+}
+
+unsigned CellDataTable::GetNumItems() const
+{
+    return mItemNames.size();
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void CellDataTable::ReadItem(AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>& rCellPopulation, unsigned handle)
+{
+    CheckHandle(handle);
+    const std::string& r_name = mItemNames[handle];
+    std::vector<double>& r_values = mValues[handle];
+    r_values.clear();
+    for (typename AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::Iterator cell_iter = rCellPopulation.Begin();
+         cell_iter != rCellPopulation.End();
+         ++cell_iter)
+    {
+        unsigned location_index = rCellPopulation.GetLocationIndexUsingCell(*cell_iter);
+        if (location_index >= r_values.size())
+        {
+            r_values.resize(location_index + 1, 0.0);
+        }
+        r_values[location_index] = cell_iter->GetCellData()->GetItem(r_name);
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void CellDataTable::WriteItem(AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>& rCellPopulation, unsigned handle)
+{
+    CheckHandle(handle);
+    const std::string& r_name = mItemNames[handle];
+    const std::vector<double>& r_values = mValues[handle];
+    for (typename AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::Iterator cell_iter = rCellPopulation.Begin();
+         cell_iter != rCellPopulation.End();
+         ++cell_iter)
+    {
+        unsigned location_index = rCellPopulation.GetLocationIndexUsingCell(*cell_iter);
+        if (location_index >= r_values.size())
+        {
+            EXCEPTION("No value of the cell data item \"" << r_name << "\" has been set for location " << location_index);
+        }
+        cell_iter->GetCellData()->SetItem(r_name, r_values[location_index]);
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool CellDataTable::UpdateLayout(AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>& rCellPopulation)
+{
+    unsigned num_all_elements = 0u;
+    unsigned num_elements = 0u;
+    VertexBasedCellPopulation<SPACE_DIM>* p_vertex_population = dynamic_cast<VertexBasedCellPopulation<SPACE_DIM>*>(&rCellPopulation);
+    if (p_vertex_population)
+    {
+        num_all_elements = p_vertex_population->rGetMesh().GetNumAllElements();
+        num_elements = p_vertex_population->rGetMesh().GetNumElements();
+    }
+
+    // The location indices only change when cells or elements come or go. The
+    // iterator skips dead cells, as ReadItem() does
+    bool unchanged = (num_all_elements == mNumAllElements && num_elements == mNumElements);
+    unsigned num_cells = 0u;
+    for (typename AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::Iterator cell_iter = rCellPopulation.Begin();
+         unchanged && cell_iter != rCellPopulation.End();
+         ++cell_iter, ++num_cells)
+    {
+        unchanged = (num_cells < mCells.size() && mCells[num_cells].get() == (*cell_iter).get());
+    }
+    if (unchanged && num_cells == mCells.size())
+    {
+        return false;
+    }
+
+    std::map<Cell*, unsigned> old_location_indices;
+    for (unsigned index=0; index<mCells.size(); index++)
+    {
+        old_location_indices[mCells[index].get()] = mLocationIndices[index];
+    }
+
+    // Built aside, so that the table is left as it was if a new cell lacks an item
+    std::vector<CellPtr> cells;
+    for (typename AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::Iterator cell_iter = rCellPopulation.Begin();
+         cell_iter != rCellPopulation.End();
+         ++cell_iter)
+    {
+        cells.push_back(*cell_iter);
+    }
+    std::vector<unsigned> location_indices(cells.size());
+    std::vector<boost::shared_ptr<CellData> > cell_data(cells.size());
+    std::vector<std::vector<double> > values(mValues.size());
+    for (unsigned index=0; index<cells.size(); index++)
+    {
+        unsigned location_index = rCellPopulation.GetLocationIndexUsingCell(cells[index]);
+        location_indices[index] = location_index;
+        cell_data[index] = cells[index]->GetCellData();
+
+        std::map<Cell*, unsigned>::const_iterator old_location_iter = old_location_indices.find(cells[index].get());
+        for (unsigned handle=0; handle<values.size(); handle++)
+        {
+            std::vector<double>& r_values = values[handle];
+            if (location_index >= r_values.size())
+            {
+                r_values.resize(location_index + 1, 0.0);
+            }
+            if (old_location_iter != old_location_indices.end() && old_location_iter->second < mValues[handle].size())
+            {
+                r_values[location_index] = mValues[handle][old_location_iter->second];
+            }
+            else
+            {
+                r_values[location_index] = cell_data[index]->GetItem(mItemNames[handle]);
+            }
+        }
+    }
+
+    mCells.swap(cells);
+    mLocationIndices.swap(location_indices);
+    mCellData.swap(cell_data);
+    for (unsigned handle=0; handle<mValues.size(); handle++)
+    {
+        mValues[handle].swap(values[handle]);
+    }
+    mNumAllElements = num_all_elements;
+    mNumElements = num_elements;
+    return true;
+}
+
+const std::vector<CellPtr>& CellDataTable::rGetCells() const
+{
+    return mCells;
+}
+
+const std::vector<unsigned>& CellDataTable::rGetLocationIndices() const
+{
+    return mLocationIndices;
+}
+
+void CellDataTable::ReadItemFromCells(unsigned handle)
+{
+    CheckHandle(handle);
+    const std::string& r_name = mItemNames[handle];
+    std::vector<double>& r_values = mValues[handle];
+    for (unsigned index=0; index<mCellData.size(); index++)
+    {
+        r_values[mLocationIndices[index]] = mCellData[index]->GetItem(r_name);
+    }
+}
+
+void CellDataTable::WriteItemToCell(unsigned handle, unsigned index)
+{
+    CheckHandle(handle);
+    if (index >= mCells.size())
+    {
+        EXCEPTION("There is no cell with index " << index << " in the table");
+    }
+    mCellData[index]->SetItem(mItemNames[handle], mValues[handle][mLocationIndices[index]]);
+}
+
+void CellDataTable::WriteItemToCells(unsigned handle)
+{
+    CheckHandle(handle);
+    const std::string& r_name = mItemNames[handle];
+    const std::vector<double>& r_values = mValues[handle];
+    for (unsigned index=0; index<mCells.size(); index++)
+    {
+        mCellData[index]->SetItem(r_name, r_values[mLocationIndices[index]]);
+    }
+}
+
+const std::vector<double>& CellDataTable::rGetValues(unsigned handle) const
+{
+    CheckHandle(handle);
+    return mValues[handle];
+}
+
+std::vector<double>& CellDataTable::rGetValues(unsigned handle)
+{
+    CheckHandle(handle);
+    return mValues[handle];
+}
+
+// Explicit instantiation
+template void CellDataTable::ReadItem(AbstractCellPopulation<1,1>&, unsigned);
+template void CellDataTable::ReadItem(AbstractCellPopulation<2,2>&, unsigned);
+template void CellDataTable::ReadItem(AbstractCellPopulation<3,3>&, unsigned);
+template void CellDataTable::WriteItem(AbstractCellPopulation<1,1>&, unsigned);
+template void CellDataTable::WriteItem(AbstractCellPopulation<2,2>&, unsigned);
+template void CellDataTable::WriteItem(AbstractCellPopulation<3,3>&, unsigned);
+template bool CellDataTable::UpdateLayout(AbstractCellPopulation<1,1>&);
+template bool CellDataTable::UpdateLayout(AbstractCellPopulation<2,2>&);
+template bool CellDataTable::UpdateLayout(AbstractCellPopulation<3,3>&);
@@ -0,0 +1,227 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef CELLDATATABLE_HPP_
+#define CELLDATATABLE_HPP_
+
+#include <string>
+#include <vector>
+#include "AbstractCellPopulation.hpp"
+#include "Cell.hpp"
+#include "CellData.hpp"
+
+/**
+ * Cell data items held in contiguous arrays, for loops over many cells.
+ *
+ * Chaste keeps each cell's data (e.g. "target area") in the cell's own
+ * CellData, a map from names to values, and modifiers such as
+ * TargetAreaLinearGrowthModifier and writers such as CellDataItemWriter
+ * read and write it there. Looking an item up by name costs a string
+ * comparison per level of the map, and is usually wrapped in a try/catch for
+ * a clearer message when the item is missing.
+ *
+ * A CellDataTable resolves each item name once, in RegisterItem(), to an
+ * integer handle, and holds the values of each item in a vector indexed by
+ * the cells' location indices. ReadItem() copies an item from the cells'
+ * CellData into its vector in one pass, failing at once if any cell lacks it;
+ * WriteItem() copies it back. Loops in between index the vector from
+ * rGetValues() directly.
+ *
+ * A table shared through a simulation, such as the one a
+ * TableTargetAreaModifier fills in, can instead be the cells' record of its
+ * items from one time step to the next. UpdateLayout() then keeps the values
+ * in step with the population: it walks the cell list and returns at once if
+ * neither the list nor the elements have changed, and otherwise looks up the
+ * location of each cell again, keeping the values of the cells it already
+ * held and taking those of new cells, such as daughters, from their CellData.
+ * WriteItemToCell() and WriteItemToCells() copy values back to CellData for
+ * the Chaste code that reads them there. Where another modifier keeps the
+ * item in CellData instead, ReadItemFromCells() copies it in each time step
+ * through the cells' CellData held since the last UpdateLayout(), without
+ * looking up the cells' locations or properties again.
+ */
+class CellDataTable
+{
+private:
+
+    /** The name of each registered item, by handle. */
+    std::vector<std::string> mItemNames;
+
+    /** The values of each registered item, by handle and then by location index. */
+    std::vector<std::vector<double> > mValues;
+
+    /**
+     * The cells in the order of the population's cell list, as of the last
+     * UpdateLayout(). Holding them keeps a removed cell's address from being
+     * reused by a new cell before the next UpdateLayout().
+     */
+    std::vector<CellPtr> mCells;
+
+    /** The location index of each cell in mCells. */
+    std::vector<unsigned> mLocationIndices;
+
+    /** The CellData of each cell in mCells. */
+    std::vector<boost::shared_ptr<CellData> > mCellData;
+
+    /**
+     * The number of elements, including deleted ones, and of undeleted elements
+     * of a vertex population as of the last UpdateLayout(). A T2 swap changes
+     * these before the dead cell leaves the cell list.
+     */
+    unsigned mNumAllElements;
+
+    /** The number of undeleted elements as of the last UpdateLayout(). */
+    unsigned mNumElements;
+
+    /**
+     * Check that a handle was returned by RegisterItem().
+     *
+     * @param handle the handle
+     */
+    void CheckHandle(unsigned handle) const;
+
+public:
+
+    /**
+     * Constructor.
+     */
+    CellDataTable();
+
+    /**
+     * Register a cell data item.
+     *
+     * After a new item is registered, the next UpdateLayout() reads every item
+     * from the cells' CellData again.
+     *
+     * @param rName the name of the item in CellData
+     * @return the item's handle; registering the same name again gives the same handle
+     */
+    unsigned RegisterItem(const std::string& rName);
+
+    /**
+     * @param rName the name of an item
+     * @return the item's handle
+     */
+    unsigned GetHandle(const std::string& rName) const;
+
+    /**
+     * @param handle an item's handle
+     * @return the item's name
+     */
+    const std::string& rGetItemName(unsigned handle) const;
+
+    /**
+     * @return the number of registered items
+     */
+    unsigned GetNumItems() const;
+
+    /**
+     * Copy an item from the CellData of every cell in a population. Locations
+     * without a cell are set to zero.
+     *
+     * @param rCellPopulation the population
+     * @param handle the item's handle
+     */
+    template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+    void ReadItem(AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>& rCellPopulation, unsigned handle);
+
+    /**
+     * Copy an item to the CellData of every cell in a population.
+     *
+     * @param rCellPopulation the population
+     * @param handle the item's handle
+     */
+    template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+    void WriteItem(AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>& rCellPopulation, unsigned handle);
+
+    /**
+     * Bring the cells and their location indices up to date with a population.
+     * Values of cells already in the table move with them to their new
+     * locations; a cell new to the table takes every registered item from its
+     * CellData. If a new cell lacks one, the table is left as it was.
+     *
+     * @param rCellPopulation the population
+     * @return whether the layout changed
+     */
+    template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+    bool UpdateLayout(AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>& rCellPopulation);
+
+    /**
+     * @return the cells, in the order of the population's cell list, as of the last UpdateLayout()
+     */
+    const std::vector<CellPtr>& rGetCells() const;
+
+    /**
+     * @return the location index of each cell in rGetCells()
+     */
+    const std::vector<unsigned>& rGetLocationIndices() const;
+
+    /**
+     * Copy an item from the CellData of every cell in rGetCells(), without
+     * looking up their locations.
+     *
+     * @param handle the item's handle
+     */
+    void ReadItemFromCells(unsigned handle);
+
+    /**
+     * Copy an item to the CellData of one cell, without looking up its location.
+     *
+     * @param handle the item's handle
+     * @param index the index of the cell in rGetCells()
+     */
+    void WriteItemToCell(unsigned handle, unsigned index);
+
+    /**
+     * Copy an item to the CellData of every cell in rGetCells().
+     *
+     * @param handle the item's handle
+     */
+    void WriteItemToCells(unsigned handle);
+
+    /**
+     * @param handle an item's handle
+     * @return the values of the item, by location index
+     */
+    const std::vector<double>& rGetValues(unsigned handle) const;
+
+    /**
+     * @param handle an item's handle
+     * @return the values of the item, by location index, to be filled in before WriteItem()
+     */
+    std::vector<double>& rGetValues(unsigned handle);
+};
+
+#endif /*CELLDATATABLE_HPP_*/
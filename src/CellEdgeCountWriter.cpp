@@ -42,7 +42,7 @@ cellbased_src_writers_populationwriters
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 CellEdgeCountWriter<ELEMENT_DIM, SPACE_DIM>::CellEdgeCountWriter()
-    : AbstractCellWriter<ELEMENT_DIM, SPACE_DIM>("celledgenumber.dat")
+    : AbstractProjectWriter<AbstractCellWriter<ELEMENT_DIM, SPACE_DIM> >("celledgenumber.dat")
 {
     this->mVtkCellDataName = "Number of cell edges";
     this->mOutputScalarData = true;
@@ -81,7 +81,7 @@ void CellEdgeCountWriter<ELEMENT_DIM, SPACE_DIM>::VisitCell(CellPtr pCell, Abstr
 { 
 
     double number_of_edges = GetCellDataForVtkOutput(pCell, pCellPopulation);
-    *this->mpOutStream << number_of_edges <<" ";
+    this->mEmitter << number_of_edges <<" ";
 }
 
 // Explicit instantiation
@@ -37,11 +37,12 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define CELLEDGECOUNTWRITER_HPP_
 
 #include "AbstractCellWriter.hpp"
+#include "AbstractProjectWriter.hpp"
 #include "ChasteSerialization.hpp"
 #include <boost/serialization/base_object.hpp>
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
-class CellEdgeCountWriter : public AbstractCellWriter<ELEMENT_DIM, SPACE_DIM>
+class CellEdgeCountWriter : public AbstractProjectWriter<AbstractCellWriter<ELEMENT_DIM, SPACE_DIM> >
 {
 private:
     /** Needed for serialization. */
@@ -55,7 +56,7 @@ private:
     template<class Archive>
     void serialize(Archive & archive, const unsigned int version)
     {
-        archive & boost::serialization::base_object<AbstractCellWriter<ELEMENT_DIM, SPACE_DIM> >(*this);
+        archive & boost::serialization::base_object<AbstractProjectWriter<AbstractCellWriter<ELEMENT_DIM, SPACE_DIM> > >(*this);
     }
 
 public:
@@ -36,12 +36,34 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "CellForcesWriter.hpp"
 
 #include "AbstractCellPopulation.hpp"
+#include "VertexMeshNeighbours.hpp"
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 CellForcesWriter<ELEMENT_DIM, SPACE_DIM>::CellForcesWriter()
-    : AbstractCellWriter<ELEMENT_DIM, SPACE_DIM>("CellForces.dat")
+    : AbstractProjectWriter<AbstractCellWriter<ELEMENT_DIM, SPACE_DIM> >("CellForces.dat"),
+      mpCellDataPopulation(nullptr)
 {
     this->mVtkCellDataName = "AreaForceDummy";
+    mTargetAreaHandle = mCellData.RegisterItem("target area");
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void CellForcesWriter<ELEMENT_DIM, SPACE_DIM>::ReadCellData(VertexBasedCellPopulation<SPACE_DIM>* pCellPopulation)
+{
+    if (mpCellDataPopulation == pCellPopulation)
+    {
+        return;
+    }
+
+    try
+    {
+        mCellData.ReadItem(*pCellPopulation, mTargetAreaHandle);
+    }
+    catch (Exception&)
+    {
+        EXCEPTION("You need to add an AbstractTargetAreaModifier to the simulation in order to use a CellForcesWriter");
+    }
+    mpCellDataPopulation = pCellPopulation;
 }
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -68,22 +90,22 @@ void CellForcesWriter<ELEMENT_DIM, SPACE_DIM>::VisitCell(CellPtr pCell, Abstract
     // Define some helper variables
     VertexBasedCellPopulation<SPACE_DIM>* p_cell_population = dynamic_cast<VertexBasedCellPopulation<SPACE_DIM>*>(pCellPopulation);
 
-    *this->mpOutStream << SimulationTime::Instance()->GetTime() << " ";
+    this->mEmitter << SimulationTime::Instance()->GetTime() << " ";
 
     //Get Cell Id
-    *this->mpOutStream << pCell->GetCellId() << " ";
+    this->mEmitter << pCell->GetCellId() << " ";
 
     //Write Area force
     double cell_area_contribution = GetAreaForceContribution(pCell, p_cell_population);
-    *this->mpOutStream << cell_area_contribution << " ";
+    this->mEmitter << cell_area_contribution << " ";
     pCell->GetCellData()->SetItem("area force", cell_area_contribution);
 
     double cell_line_tension_contribution = GetLineTensionForceContribution(pCell, p_cell_population);
-    *this->mpOutStream << cell_line_tension_contribution << " ";
+    this->mEmitter << cell_line_tension_contribution << " ";
     pCell->GetCellData()->SetItem("line tension force", cell_line_tension_contribution);
 
     double cell_perimeter_contribution = GetPerimeterForceContribution(pCell, p_cell_population);
-    *this->mpOutStream << cell_perimeter_contribution << "\n";
+    this->mEmitter << cell_perimeter_contribution << "\n";
     pCell->GetCellData()->SetItem("perimeter force", cell_perimeter_contribution);
     }
 }
@@ -91,19 +113,14 @@ void CellForcesWriter<ELEMENT_DIM, SPACE_DIM>::VisitCell(CellPtr pCell, Abstract
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 double CellForcesWriter<ELEMENT_DIM, SPACE_DIM>::GetAreaForceContribution(CellPtr pCell, VertexBasedCellPopulation<SPACE_DIM>* pCellPopulation)
 {
-    double target_area;
-
     unsigned location_index = pCellPopulation->GetLocationIndexUsingCell(pCell);
     auto p_element = pCellPopulation->GetElement(location_index);
 
-    try
-    {
-        target_area = pCellPopulation->GetCellUsingLocationIndex(location_index)->GetCellData()->GetItem("target area");
-    }
-    catch (Exception&)
-    {
-        EXCEPTION("You need to add an AbstractTargetAreaModifier to the simulation in order to use a CellForcesWriter");
-    }
+    // The target areas are read once per time step, at the first visit after WriteTimeStamp()
+    ReadCellData(pCellPopulation);
+    double target_area = mCellData.rGetValues(mTargetAreaHandle)[location_index];
+
+    double element_area = this->rGetElementGeometry(pCellPopulation->rGetMesh()).rGetAreas()[p_element->GetIndex()];
 
     // Find the local index of this node in this element
 
@@ -114,9 +131,7 @@ double CellForcesWriter<ELEMENT_DIM, SPACE_DIM>::GetAreaForceContribution(CellPt
         c_vector<double, 2> area_elasticity_contribution = zero_vector<double>(2);
         c_vector<double, 2> element_area_gradient =
                 pCellPopulation->rGetMesh().GetAreaGradientOfElementAtNode(p_element, local_index);
-        area_elasticity_contribution -= GetAreaElasticityParameter()*( pCellPopulation->
-                rGetMesh().GetVolumeOfElement(p_element->GetIndex()) -
-                target_area)*element_area_gradient;
+        area_elasticity_contribution -= GetAreaElasticityParameter()*(element_area - target_area)*element_area_gradient;
         area_forces[local_index] = norm_2(area_elasticity_contribution);
     }
 
@@ -176,6 +191,8 @@ double CellForcesWriter<ELEMENT_DIM, SPACE_DIM>::GetPerimeterForceContribution(C
     auto p_element = pCellPopulation->GetElement(location_index);
     unsigned num_nodes = p_element->GetNumNodes();
 
+    double element_perimeter = this->rGetElementGeometry(pCellPopulation->rGetMesh()).rGetPerimeters()[location_index];
+
     std::vector< double > perimeter_forces(num_nodes);
 
     for (unsigned local_index = 0; local_index < p_element->GetNumNodes(); local_index++)
@@ -191,8 +208,7 @@ double CellForcesWriter<ELEMENT_DIM, SPACE_DIM>::GetPerimeterForceContribution(C
 
         // Add the force contribution from this cell's perimeter contractility (note the minus sign)
         c_vector<double, 2> element_perimeter_gradient = previous_edge_gradient + next_edge_gradient;
-        perimeter_contractility_contribution -= GetPerimeterContractilityParameter()*
-                pCellPopulation->rGetMesh().GetSurfaceAreaOfElement(location_index)*
+        perimeter_contractility_contribution -= GetPerimeterContractilityParameter()*element_perimeter*
                 element_perimeter_gradient;
         perimeter_forces[local_index] = norm_2(perimeter_contractility_contribution);
     }
@@ -205,17 +221,9 @@ double CellForcesWriter<ELEMENT_DIM, SPACE_DIM>::GetPerimeterForceContribution(C
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 double CellForcesWriter<ELEMENT_DIM, SPACE_DIM>::GetLineTensionParameter(Node<SPACE_DIM>* pNodeA, Node<SPACE_DIM>* pNodeB, VertexBasedCellPopulation<SPACE_DIM>& rVertexCellPopulation)
 {
-    // Find the indices of the elements owned by each node
-    std::set<unsigned> elements_containing_nodeA = pNodeA->rGetContainingElementIndices();
-    std::set<unsigned> elements_containing_nodeB = pNodeB->rGetContainingElementIndices();
-
-    // Find common elements
-    std::set<unsigned> shared_elements;
-    std::set_intersection(elements_containing_nodeA.begin(),
-                          elements_containing_nodeA.end(),
-                          elements_containing_nodeB.begin(),
-                          elements_containing_nodeB.end(),
-                          std::inserter(shared_elements, shared_elements.begin()));
+    // Find the elements owned by both nodes
+    SmallIndexSet shared_elements;
+    VertexMeshNeighbours<SPACE_DIM, SPACE_DIM>::GetSharedElementIndices(pNodeA, pNodeB, shared_elements);
 
     // Check that the nodes have a common edge
     assert(!shared_elements.empty());
@@ -260,6 +268,8 @@ double CellForcesWriter<ELEMENT_DIM, SPACE_DIM>::GetBoundaryLineTensionParameter
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void CellForcesWriter<ELEMENT_DIM, SPACE_DIM>::WriteTimeStamp()
 {
+    this->BeginOutputBlock();
+    mpCellDataPopulation = nullptr;
 }
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -39,6 +39,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ChasteSerialization.hpp"
 #include <boost/serialization/base_object.hpp>
 #include "AbstractCellWriter.hpp"
+#include "AbstractProjectWriter.hpp"
+#include "CellDataTable.hpp"
 #include "VertexBasedCellPopulation.hpp"
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics.hpp>
@@ -58,7 +60,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * then the writer also specifies the VTK output for each cell, which in this cell is a dummy.
  */
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
-class CellForcesWriter : public AbstractCellWriter<ELEMENT_DIM, SPACE_DIM>
+class CellForcesWriter : public AbstractProjectWriter<AbstractCellWriter<ELEMENT_DIM, SPACE_DIM> >
 {
 private:
     /** Needed for serialization. */
@@ -72,9 +74,26 @@ private:
     template<class Archive>
     void serialize(Archive & archive, const unsigned int version)
     {
-        archive & boost::serialization::base_object<AbstractCellWriter<ELEMENT_DIM, SPACE_DIM> >(*this);
+        archive & boost::serialization::base_object<AbstractProjectWriter<AbstractCellWriter<ELEMENT_DIM, SPACE_DIM> > >(*this);
     }
 
+    /** The cells' target areas, read at the first visit of each time step. Not archived. */
+    CellDataTable mCellData;
+
+    /** The handle of "target area" in mCellData. */
+    unsigned mTargetAreaHandle;
+
+    /** The population visited at this time step, if mCellData has been read from it. */
+    VertexBasedCellPopulation<SPACE_DIM>* mpCellDataPopulation;
+
+    /**
+     * Read the target areas from the cells of a population, unless they have
+     * already been read at this time step.
+     *
+     * @param pCellPopulation the population
+     */
+    void ReadCellData(VertexBasedCellPopulation<SPACE_DIM>* pCellPopulation);
+
 public:
 
     /**
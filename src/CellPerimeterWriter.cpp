@@ -42,7 +42,7 @@ cellbased_src_writers_populationwriters
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 CellPerimeterWriter<ELEMENT_DIM, SPACE_DIM>::CellPerimeterWriter()
-    : AbstractCellWriter<ELEMENT_DIM, SPACE_DIM>("cellperimeter.dat")
+    : AbstractProjectWriter<AbstractCellWriter<ELEMENT_DIM, SPACE_DIM> >("cellperimeter.dat")
 {
     this->mVtkCellDataName = "Cell perimeter";
     this->mOutputScalarData = true;
@@ -88,9 +88,19 @@ double CellPerimeterWriter<ELEMENT_DIM, SPACE_DIM>::GetCellDataForVtkOutput(Cell
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void CellPerimeterWriter<ELEMENT_DIM, SPACE_DIM>::VisitCell(CellPtr pCell, AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>* pCellPopulation)
 { 
-
-    double cell_perimeter = GetCellDataForVtkOutput(pCell, pCellPopulation);
-    *this->mpOutStream << cell_perimeter <<" ";
+    // In 2D, use the perimeters shared with the other writers at this time step
+    VertexBasedCellPopulation<SPACE_DIM>* p_vbcp = dynamic_cast<VertexBasedCellPopulation<SPACE_DIM>*>(pCellPopulation);
+    double cell_perimeter;
+    if (p_vbcp != nullptr && ELEMENT_DIM == 2 && SPACE_DIM == 2)
+    {
+        unsigned location_index = pCellPopulation->GetLocationIndexUsingCell(pCell);
+        cell_perimeter = this->rGetElementGeometry(p_vbcp->rGetMesh()).rGetPerimeters()[location_index];
+    }
+    else
+    {
+        cell_perimeter = GetCellDataForVtkOutput(pCell, pCellPopulation);
+    }
+    this->mEmitter << cell_perimeter <<" ";
 }
 
 // Explicit instantiation
@@ -0,0 +1,104 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "DenseCholesky.hpp"
+
+#include <cmath>
+
+bool DenseCholesky::Decompose(std::vector<double>& rMatrix, unsigned n)
+{
+    for (unsigned j=0; j<n; j++)
+    {
+        double* p_row_j = &rMatrix[j*n];
+        double diagonal = p_row_j[j];
+        for (unsigned k=0; k<j; k++)
+        {
+            diagonal -= p_row_j[k]*p_row_j[k];
+        }
+        if (!(diagonal > 0.0))
+        {
+            return false;
+        }
+        diagonal = std::sqrt(diagonal);
+        p_row_j[j] = diagonal;
+
+        for (unsigned i=j+1; i<n; i++)
+        {
+            double* p_row_i = &rMatrix[i*n];
+            double value = p_row_i[j];
+            for (unsigned k=0; k<j; k++)
+            {
+                value -= p_row_i[k]*p_row_j[k];
+            }
+            p_row_i[j] = value/diagonal;
+        }
+    }
+    return true;
+}
+
+void DenseCholesky::ForwardSubstitute(const std::vector<double>& rLower, unsigned n, std::vector<double>& rVector)
+{
+    for (unsigned i=0; i<n; i++)
+    {
+        const double* p_row = &rLower[i*n];
+        double value = rVector[i];
+        for (unsigned k=0; k<i; k++)
+        {
+            value -= p_row[k]*rVector[k];
+        }
+        rVector[i] = value/p_row[i];
+    }
+}
+
+void DenseCholesky::BackSubstitute(const std::vector<double>& rLower, unsigned n, std::vector<double>& rVector)
+{
+    for (unsigned i=n; i-- > 0; )
+    {
+        rVector[i] /= rLower[i*n + i];
+        for (unsigned k=0; k<i; k++)
+        {
+            rVector[k] -= rLower[i*n + k]*rVector[i];
+        }
+    }
+}
+
+double DenseCholesky::GetLogDeterminant(const std::vector<double>& rLower, unsigned n)
+{
+    double log_determinant = 0.0;
+    for (unsigned i=0; i<n; i++)
+    {
+        log_determinant += 2.0*std::log(rLower[i*n + i]);
+    }
+    return log_determinant;
+}
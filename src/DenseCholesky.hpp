@@ -0,0 +1,85 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef DENSECHOLESKY_HPP_
+#define DENSECHOLESKY_HPP_
+
+#include <vector>
+
+/**
+ * Cholesky decomposition and triangular solves for the small dense symmetric
+ * positive definite matrices of the project's statistical code (emulator kernel
+ * matrices, covariance matrices of summary statistics). Matrices are stored by
+ * rows in a std::vector; only their lower triangles are used.
+ */
+class DenseCholesky
+{
+public:
+
+    /**
+     * Replace a symmetric positive definite matrix by its lower Cholesky factor L.
+     *
+     * @param rMatrix an n by n matrix, stored by rows
+     * @param n the size of the matrix
+     * @return false if the matrix is not positive definite
+     */
+    static bool Decompose(std::vector<double>& rMatrix, unsigned n);
+
+    /**
+     * Solve L x = b in place.
+     *
+     * @param rLower the lower Cholesky factor L, stored by rows
+     * @param n the size of L
+     * @param rVector b on entry, x on exit
+     */
+    static void ForwardSubstitute(const std::vector<double>& rLower, unsigned n, std::vector<double>& rVector);
+
+    /**
+     * Solve L^T x = b in place.
+     *
+     * @param rLower the lower Cholesky factor L, stored by rows
+     * @param n the size of L
+     * @param rVector b on entry, x on exit
+     */
+    static void BackSubstitute(const std::vector<double>& rLower, unsigned n, std::vector<double>& rVector);
+
+    /**
+     * @param rLower the lower Cholesky factor L of a matrix A, stored by rows
+     * @param n the size of L
+     * @return the log of the determinant of A = L L^T
+     */
+    static double GetLogDeterminant(const std::vector<double>& rLower, unsigned n);
+};
+
+#endif /*DENSECHOLESKY_HPP_*/
@@ -0,0 +1,209 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "DistributionDistance.hpp"
+#include "Exception.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+namespace
+{
+    /**
+     * Integrate |F - G|^power over the line, where F and G are the empirical
+     * distribution functions of two sorted samples.
+     *
+     * @param rFirst the first sample, sorted
+     * @param rSecond the second sample, sorted
+     * @param power 1 or 2
+     * @return the integral, or NaN if either sample is empty
+     */
+    double IntegrateDistributionDifference(const std::vector<double>& rFirst,
+                                           const std::vector<double>& rSecond,
+                                           unsigned power)
+    {
+        unsigned n = rFirst.size();
+        unsigned m = rSecond.size();
+        if (n == 0 || m == 0)
+        {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+
+        // Walk through the merged samples; between consecutive points F and G are constant
+        unsigned i = 0;
+        unsigned j = 0;
+        double previous = std::min(rFirst[0], rSecond[0]);
+        double integral = 0.0;
+        while (i < n && j < m)
+        {
+            double next = std::min(rFirst[i], rSecond[j]);
+            double difference = std::fabs(double(i)/n - double(j)/m);
+            integral += (power == 1u ? difference : difference*difference)*(next - previous);
+            previous = next;
+            if (rFirst[i] == next)
+            {
+                i++;
+            }
+            else
+            {
+                j++;
+            }
+        }
+
+        // Then only one distribution is below one
+        const std::vector<double>& r_rest = (i < n) ? rFirst : rSecond;
+        unsigned k = (i < n) ? i : j;
+        unsigned size = r_rest.size();
+        for (; k<size; k++)
+        {
+            double difference = 1.0 - double(k)/size;
+            integral += (power == 1u ? difference : difference*difference)*(r_rest[k] - previous);
+            previous = r_rest[k];
+        }
+        return integral;
+    }
+
+    /**
+     * Sort a sample, unless it contains NaNs.
+     *
+     * @param rSample the sample
+     * @return false if the sample contains NaNs (and so was not sorted)
+     */
+    bool SortSample(std::vector<double>& rSample)
+    {
+        if (std::any_of(rSample.begin(), rSample.end(), [](double value) { return std::isnan(value); }))
+        {
+            return false;
+        }
+        std::sort(rSample.begin(), rSample.end());
+        return true;
+    }
+
+    /**
+     * @param rSimulated a sample from each simulated run
+     * @param rObserved the observed sample
+     * @param power 1 for the Wasserstein-1 distance, 2 for the energy distance
+     * @return the integral of |F - G|^power for each run, or NaN for runs whose
+     *     samples are empty or contain NaNs
+     */
+    std::vector<double> IntegrateBatch(const std::vector<std::vector<double> >& rSimulated,
+                                       const std::vector<double>& rObserved,
+                                       unsigned power)
+    {
+        std::vector<double> integrals(rSimulated.size(), std::numeric_limits<double>::quiet_NaN());
+        std::vector<double> sorted_observed(rObserved);
+        if (!SortSample(sorted_observed))
+        {
+            return integrals;
+        }
+
+        std::vector<double> buffer;
+        for (unsigned run=0; run<rSimulated.size(); run++)
+        {
+            buffer.assign(rSimulated[run].begin(), rSimulated[run].end());
+            if (SortSample(buffer))
+            {
+                integrals[run] = IntegrateDistributionDifference(buffer, sorted_observed, power);
+            }
+        }
+        return integrals;
+    }
+}
+
+double DistributionDistance::GetWassersteinDistance(const std::vector<double>& rFirst, const std::vector<double>& rSecond)
+{
+    return GetWassersteinDistances(std::vector<std::vector<double> >(1, rFirst), rSecond)[0];
+}
+
+double DistributionDistance::GetEnergyDistance(const std::vector<double>& rFirst, const std::vector<double>& rSecond)
+{
+    return GetEnergyDistances(std::vector<std::vector<double> >(1, rFirst), rSecond)[0];
+}
+
+std::vector<double> DistributionDistance::GetWassersteinDistances(const std::vector<std::vector<double> >& rSimulated,
+                                                                  const std::vector<double>& rObserved)
+{
+    return IntegrateBatch(rSimulated, rObserved, 1u);
+}
+
+std::vector<double> DistributionDistance::GetEnergyDistances(const std::vector<std::vector<double> >& rSimulated,
+                                                             const std::vector<double>& rObserved)
+{
+    std::vector<double> distances = IntegrateBatch(rSimulated, rObserved, 2u);
+    for (unsigned run=0; run<distances.size(); run++)
+    {
+        distances[run] = std::sqrt(2.0*distances[run]);
+    }
+    return distances;
+}
+
+std::vector<double> DistributionDistance::ReadFinalSample(const std::string& rFilePath)
+{
+    std::ifstream file(rFilePath.c_str());
+    if (!file.is_open())
+    {
+        EXCEPTION("Could not open sample file " << rFilePath);
+    }
+
+    std::string line;
+    std::string last_line;
+    while (std::getline(file, line))
+    {
+        if (line.find_first_not_of(" \t\r") != std::string::npos)
+        {
+            last_line = line;
+        }
+    }
+
+    std::istringstream stream(last_line);
+    double time;
+    unsigned num_values;
+    if (!(stream >> time >> num_values))
+    {
+        EXCEPTION("Could not read a sample from " << rFilePath);
+    }
+    std::vector<double> values(num_values);
+    for (unsigned i=0; i<num_values; i++)
+    {
+        if (!(stream >> values[i]))
+        {
+            EXCEPTION("The last line of " << rFilePath << " should have " << num_values << " values");
+        }
+    }
+    return values;
+}
@@ -0,0 +1,293 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "DivergenceDetectionModifier.hpp"
+#include "VertexBasedCellPopulation.hpp"
+
+#include <climits>
+#include <cmath>
+
+namespace
+{
+    /** The fewest T2 swaps in the window that can count as too many, so that a small tissue may lose a cell. */
+    const unsigned MIN_T2_SWAPS_FOR_FAILURE = 5u;
+}
+
+template<unsigned DIM>
+DivergenceDetectionModifier<DIM>::DivergenceDetectionModifier()
+    : AbstractCellBasedSimulationModifier<DIM,DIM>(),
+      mMinElementArea(0.0),
+      mMaxVertexSpeed(1000.0),
+      mMinSubstep(1e-6),
+      mT2SwapWindow(1.0),
+      mMaxT2SwapFraction(0.1),
+      mNumT2SwapLocations(0u),
+      mHasFailed(false)
+{
+}
+
+template<unsigned DIM>
+DivergenceDetectionModifier<DIM>::~DivergenceDetectionModifier()
+{
+}
+
+template<unsigned DIM>
+void DivergenceDetectionModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory)
+{
+    if (dynamic_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation) == nullptr)
+    {
+        EXCEPTION("DivergenceDetectionModifier is to be used with a VertexBasedCellPopulation only");
+    }
+    if (DIM != 2)
+    {
+        EXCEPTION("DivergenceDetectionModifier is only implemented in 2D");
+    }
+
+    MutableVertexMesh<DIM,DIM>& r_mesh = static_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation)->rGetMesh();
+    mNumT2SwapLocations = r_mesh.GetLocationsOfT2Swaps().size();
+    mRecentT2Swaps.clear();
+    mFailureRecord = SimulationFailureRecord();
+    mHasFailed = false;
+}
+
+template<unsigned DIM>
+void DivergenceDetectionModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    // Only the first failure is recorded; the simulation stops before the next time step
+    if (mHasFailed)
+    {
+        return;
+    }
+
+    MutableVertexMesh<DIM,DIM>& r_mesh = static_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation)->rGetMesh();
+
+    // Vertices: where they are and how fast they move
+    for (typename AbstractMesh<DIM,DIM>::NodeIterator node_iter = r_mesh.GetNodeIteratorBegin();
+         node_iter != r_mesh.GetNodeIteratorEnd();
+         ++node_iter)
+    {
+        unsigned node_index = node_iter->GetIndex();
+        const c_vector<double, DIM>& r_location = node_iter->rGetLocation();
+        if (!std::isfinite(r_location[0]) || !std::isfinite(r_location[1]))
+        {
+            Fail(rCellPopulation, "NonFiniteLocation", std::isfinite(r_location[0]) ? r_location[1] : r_location[0],
+                 0.0, node_index);
+            return;
+        }
+
+        double speed = norm_2(node_iter->rGetAppliedForce())/rCellPopulation.GetDampingConstant(node_index);
+        if (!(speed <= mMaxVertexSpeed))
+        {
+            Fail(rCellPopulation, "VertexSpeed", speed, mMaxVertexSpeed, node_index);
+            return;
+        }
+    }
+
+    // Elements: their signed areas, relative to the first vertex as in VertexMesh
+    for (typename VertexMesh<DIM,DIM>::VertexElementIterator elem_iter = r_mesh.GetElementIteratorBegin();
+         elem_iter != r_mesh.GetElementIteratorEnd();
+         ++elem_iter)
+    {
+        unsigned num_nodes_elem = elem_iter->GetNumNodes();
+        const c_vector<double, DIM>& r_first_location = elem_iter->GetNode(0)->rGetLocation();
+        double signed_area = 0.0;
+        for (unsigned local_index=1; local_index+1<num_nodes_elem; local_index++)
+        {
+            const c_vector<double, DIM>& r_location = elem_iter->GetNode(local_index)->rGetLocation();
+            const c_vector<double, DIM>& r_next_location = elem_iter->GetNode(local_index + 1)->rGetLocation();
+            signed_area += 0.5*((r_location[0] - r_first_location[0])*(r_next_location[1] - r_first_location[1])
+                                - (r_next_location[0] - r_first_location[0])*(r_location[1] - r_first_location[1]));
+        }
+        if (signed_area <= mMinElementArea)
+        {
+            Fail(rCellPopulation, "CollapsedElement", signed_area, mMinElementArea, elem_iter->GetIndex());
+            return;
+        }
+    }
+
+    // The adaptive method's sub-steps
+    if (mpAdaptiveMethod)
+    {
+        double next_substep = mpAdaptiveMethod->GetNextSubstep(SimulationTime::Instance()->GetTimeStep());
+        if (next_substep < mMinSubstep)
+        {
+            Fail(rCellPopulation, "SubstepFloor", next_substep, mMinSubstep, UINT_MAX);
+            return;
+        }
+    }
+
+    // T2 swaps; the population's writers clear the mesh's list of their locations from time to time
+    unsigned num_t2_swap_locations = r_mesh.GetLocationsOfT2Swaps().size();
+    unsigned num_new_t2_swaps = num_t2_swap_locations >= mNumT2SwapLocations ? num_t2_swap_locations - mNumT2SwapLocations
+                                                                              : num_t2_swap_locations;
+    mNumT2SwapLocations = num_t2_swap_locations;
+
+    double time = SimulationTime::Instance()->GetTime();
+    if (num_new_t2_swaps > 0u)
+    {
+        mRecentT2Swaps.push_back(std::make_pair(time, num_new_t2_swaps));
+    }
+    while (!mRecentT2Swaps.empty() && mRecentT2Swaps.front().first <= time - mT2SwapWindow)
+    {
+        mRecentT2Swaps.pop_front();
+    }
+    unsigned num_recent_t2_swaps = 0u;
+    for (unsigned i=0; i<mRecentT2Swaps.size(); i++)
+    {
+        num_recent_t2_swaps += mRecentT2Swaps[i].second;
+    }
+    double max_t2_swaps = mMaxT2SwapFraction*rCellPopulation.GetNumRealCells();
+    if (num_recent_t2_swaps >= MIN_T2_SWAPS_FOR_FAILURE && num_recent_t2_swaps > max_t2_swaps)
+    {
+        Fail(rCellPopulation, "T2SwapRate", num_recent_t2_swaps, max_t2_swaps, UINT_MAX);
+    }
+}
+
+template<unsigned DIM>
+void DivergenceDetectionModifier<DIM>::Fail(AbstractCellPopulation<DIM,DIM>& rCellPopulation, const std::string& rReason,
+                                            double value, double limit, unsigned index)
+{
+    mFailureRecord.mReason = rReason;
+    mFailureRecord.mTime = SimulationTime::Instance()->GetTime();
+    mFailureRecord.mTimeStep = SimulationTime::Instance()->GetTimeStepsElapsed();
+    mFailureRecord.mValue = value;
+    mFailureRecord.mLimit = limit;
+    mFailureRecord.mIndex = index;
+    mFailureRecord.mNumCells = rCellPopulation.GetNumRealCells();
+    mHasFailed = true;
+}
+
+template<unsigned DIM>
+void DivergenceDetectionModifier<DIM>::SetMinElementArea(double minElementArea)
+{
+    mMinElementArea = minElementArea;
+}
+
+template<unsigned DIM>
+double DivergenceDetectionModifier<DIM>::GetMinElementArea() const
+{
+    return mMinElementArea;
+}
+
+template<unsigned DIM>
+void DivergenceDetectionModifier<DIM>::SetMaxVertexSpeed(double maxVertexSpeed)
+{
+    if (!(maxVertexSpeed > 0.0))
+    {
+        EXCEPTION("The maximum vertex speed must be positive");
+    }
+    mMaxVertexSpeed = maxVertexSpeed;
+}
+
+template<unsigned DIM>
+double DivergenceDetectionModifier<DIM>::GetMaxVertexSpeed() const
+{
+    return mMaxVertexSpeed;
+}
+
+template<unsigned DIM>
+void DivergenceDetectionModifier<DIM>::SetMinSubstep(double minSubstep)
+{
+    mMinSubstep = minSubstep;
+}
+
+template<unsigned DIM>
+double DivergenceDetectionModifier<DIM>::GetMinSubstep() const
+{
+    return mMinSubstep;
+}
+
+template<unsigned DIM>
+void DivergenceDetectionModifier<DIM>::SetMaxT2SwapRate(double window, double maxFraction)
+{
+    if (!(window > 0.0) || !(maxFraction > 0.0))
+    {
+        EXCEPTION("The T2 swap window and the maximum fraction of cells must be positive");
+    }
+    mT2SwapWindow = window;
+    mMaxT2SwapFraction = maxFraction;
+}
+
+template<unsigned DIM>
+double DivergenceDetectionModifier<DIM>::GetT2SwapWindow() const
+{
+    return mT2SwapWindow;
+}
+
+template<unsigned DIM>
+double DivergenceDetectionModifier<DIM>::GetMaxT2SwapFraction() const
+{
+    return mMaxT2SwapFraction;
+}
+
+template<unsigned DIM>
+void DivergenceDetectionModifier<DIM>::SetAdaptiveMethod(boost::shared_ptr<AbstractAdaptiveNumericalMethod<DIM,DIM> > pAdaptiveMethod)
+{
+    mpAdaptiveMethod = pAdaptiveMethod;
+}
+
+template<unsigned DIM>
+bool DivergenceDetectionModifier<DIM>::HasFailed() const
+{
+    return mHasFailed;
+}
+
+template<unsigned DIM>
+const SimulationFailureRecord& DivergenceDetectionModifier<DIM>::rGetFailureRecord() const
+{
+    return mFailureRecord;
+}
+
+template<unsigned DIM>
+void DivergenceDetectionModifier<DIM>::OutputSimulationModifierParameters(out_stream& rParamsFile)
+{
+    *rParamsFile << "\t\t\t<MinElementArea>" << mMinElementArea << "</MinElementArea>\n";
+    *rParamsFile << "\t\t\t<MaxVertexSpeed>" << mMaxVertexSpeed << "</MaxVertexSpeed>\n";
+    *rParamsFile << "\t\t\t<MinSubstep>" << mMinSubstep << "</MinSubstep>\n";
+    *rParamsFile << "\t\t\t<T2SwapWindow>" << mT2SwapWindow << "</T2SwapWindow>\n";
+    *rParamsFile << "\t\t\t<MaxT2SwapFraction>" << mMaxT2SwapFraction << "</MaxT2SwapFraction>\n";
+
+    // Next, call method on direct parent class
+    AbstractCellBasedSimulationModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
+}
+
+// Explicit instantiation
+template class DivergenceDetectionModifier<1>;
+template class DivergenceDetectionModifier<2>;
+template class DivergenceDetectionModifier<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(DivergenceDetectionModifier)
@@ -0,0 +1,242 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef DIVERGENCEDETECTIONMODIFIER_HPP_
+#define DIVERGENCEDETECTIONMODIFIER_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+#include <boost/shared_ptr.hpp>
+#include <deque>
+#include <utility>
+
+#include "AbstractCellBasedSimulationModifier.hpp"
+#include "AbstractAdaptiveNumericalMethod.hpp"
+#include "SimulationFailureRecord.hpp"
+
+/**
+ * A modifier that stops a vertex simulation whose state has become
+ * non-physical, rather than let it crawl on with ever shorter steps.
+ *
+ * At the end of each time step it checks, in this order, for
+ *  - a vertex at a non-finite location;
+ *  - a vertex moving faster than the maximum vertex speed, judging by the
+ *    force last applied to it and its damping constant;
+ *  - an element whose signed area is at most the minimum element area, i.e.
+ *    by default one that has collapsed or turned inside out;
+ *  - an adaptive numerical method (see SetAdaptiveMethod()) whose next
+ *    sub-step is shorter than the minimum sub-step;
+ *  - more T2 swaps within the T2 swap window than the maximum fraction of
+ *    the cells (and at least a handful).
+ *
+ * On the first of these it finds, it fills in a SimulationFailureRecord and
+ * HasFailed() becomes true. A BudgetedOffLatticeSimulation then stops before
+ * the next time step (see its StoppingEventHasOccurred()), so that Solve()
+ * returns and the population's writers close their files as usual. The caller
+ * can then write the record (see rGetFailureRecord()) to the run's output
+ * directory; see PaperVertexSimulation. The modifier does not change the
+ * simulation, so runs that pass the checks give the same results with or
+ * without it.
+ */
+template<unsigned DIM>
+class DivergenceDetectionModifier : public AbstractCellBasedSimulationModifier<DIM,DIM>
+{
+private:
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Archive the object. The adaptive method and the T2 swap history are not archived.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractCellBasedSimulationModifier<DIM,DIM> >(*this);
+        archive & mMinElementArea;
+        archive & mMaxVertexSpeed;
+        archive & mMinSubstep;
+        archive & mT2SwapWindow;
+        archive & mMaxT2SwapFraction;
+    }
+
+    /** Elements with a signed area at most this have collapsed. Defaults to 0. */
+    double mMinElementArea;
+
+    /** The largest speed of any vertex. Defaults to 1000. */
+    double mMaxVertexSpeed;
+
+    /** The shortest next sub-step of the adaptive method. Defaults to 1e-6. */
+    double mMinSubstep;
+
+    /** The length of time over which T2 swaps are counted. Defaults to 1. */
+    double mT2SwapWindow;
+
+    /** The largest number of T2 swaps in the window, as a fraction of the number of cells. Defaults to 0.1. */
+    double mMaxT2SwapFraction;
+
+    /** The adaptive numerical method of the simulation, if any. */
+    boost::shared_ptr<AbstractAdaptiveNumericalMethod<DIM,DIM> > mpAdaptiveMethod;
+
+    /** The number of T2 swap locations the mesh held at the last check. */
+    unsigned mNumT2SwapLocations;
+
+    /** The times of the time steps in the window that had T2 swaps, with their numbers of swaps. */
+    std::deque<std::pair<double, unsigned> > mRecentT2Swaps;
+
+    /** The record of the failure, if any. */
+    SimulationFailureRecord mFailureRecord;
+
+    /** Whether a failure has been detected. */
+    bool mHasFailed;
+
+    /**
+     * Fill in the failure record.
+     *
+     * @param rCellPopulation the cell population
+     * @param rReason the reason; see SimulationFailureRecord::mReason
+     * @param value the offending value
+     * @param limit the limit it passed
+     * @param index the index of the offending element or node, or UINT_MAX
+     */
+    void Fail(AbstractCellPopulation<DIM,DIM>& rCellPopulation, const std::string& rReason,
+              double value, double limit, unsigned index);
+
+public:
+
+    /**
+     * Constructor.
+     */
+    DivergenceDetectionModifier();
+
+    /**
+     * Destructor.
+     */
+    virtual ~DivergenceDetectionModifier();
+
+    /**
+     * Overridden SetupSolve() method. Forgets any earlier failure.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     */
+    virtual void SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory);
+
+    /**
+     * Overridden UpdateAtEndOfTimeStep() method. Makes the checks, until one fails.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * @param minElementArea elements with a signed area at most this have collapsed
+     */
+    void SetMinElementArea(double minElementArea);
+
+    /**
+     * @return the area at or below which elements have collapsed
+     */
+    double GetMinElementArea() const;
+
+    /**
+     * @param maxVertexSpeed the largest speed of any vertex
+     */
+    void SetMaxVertexSpeed(double maxVertexSpeed);
+
+    /**
+     * @return the largest speed of any vertex
+     */
+    double GetMaxVertexSpeed() const;
+
+    /**
+     * @param minSubstep the shortest next sub-step of the adaptive method
+     */
+    void SetMinSubstep(double minSubstep);
+
+    /**
+     * @return the shortest next sub-step of the adaptive method
+     */
+    double GetMinSubstep() const;
+
+    /**
+     * Set the limit on the rate of T2 swaps.
+     *
+     * @param window the length of time over which T2 swaps are counted
+     * @param maxFraction the largest number of swaps in the window, as a fraction of the number of cells
+     */
+    void SetMaxT2SwapRate(double window, double maxFraction);
+
+    /**
+     * @return the length of time over which T2 swaps are counted
+     */
+    double GetT2SwapWindow() const;
+
+    /**
+     * @return the largest number of T2 swaps in the window, as a fraction of the number of cells
+     */
+    double GetMaxT2SwapFraction() const;
+
+    /**
+     * Watch the sub-steps of an adaptive numerical method.
+     *
+     * @param pAdaptiveMethod the simulation's numerical method
+     */
+    void SetAdaptiveMethod(boost::shared_ptr<AbstractAdaptiveNumericalMethod<DIM,DIM> > pAdaptiveMethod);
+
+    /**
+     * @return whether a failure has been detected
+     */
+    bool HasFailed() const;
+
+    /**
+     * @return the record of the failure, if HasFailed()
+     */
+    const SimulationFailureRecord& rGetFailureRecord() const;
+
+    /**
+     * Overridden OutputSimulationModifierParameters() method.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    void OutputSimulationModifierParameters(out_stream& rParamsFile);
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(DivergenceDetectionModifier)
+
+#endif /*DIVERGENCEDETECTIONMODIFIER_HPP_*/
@@ -0,0 +1,112 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "ElementGeometryCache.hpp"
+#include "SimulationTime.hpp"
+
+ElementGeometryCache::ElementGeometryCache()
+    : mpMesh(nullptr),
+      mTimeStepsElapsed(0u),
+      mNumAllNodes(0u),
+      mNumAllElements(0u),
+      mNumElements(0u),
+      mNumMeshChanges(0u),
+      mNumMeshChangesCalculated(0u)
+{
+}
+
+const ElementGeometryKernel& ElementGeometryCache::rGetGeometry(MutableVertexMesh<2,2>& rMesh)
+{
+    SimulationTime* p_simulation_time = SimulationTime::Instance();
+    bool have_time = p_simulation_time->IsEndTimeAndNumberOfTimeStepsSetUp();
+    unsigned time_steps_elapsed = have_time ? p_simulation_time->GetTimeStepsElapsed() : 0u;
+    if (have_time
+        && mKernel.GetNumCalculations() > 0u
+        && mpMesh == &rMesh
+        && mTimeStepsElapsed == time_steps_elapsed
+        && mNumAllNodes == rMesh.GetNumAllNodes()
+        && mNumAllElements == rMesh.GetNumAllElements()
+        && mNumElements == rMesh.GetNumElements()
+        && mNumMeshChangesCalculated == mNumMeshChanges)
+    {
+        return mKernel;
+    }
+
+    // Mirror the mesh; elements are numbered by index, leaving deleted ones empty
+    mElementOffsets.assign(1, 0u);
+    mElementNodes.clear();
+    for (VertexMesh<2,2>::VertexElementIterator elem_iter = rMesh.GetElementIteratorBegin();
+         elem_iter != rMesh.GetElementIteratorEnd();
+         ++elem_iter)
+    {
+        while (mElementOffsets.size() <= elem_iter->GetIndex())
+        {
+            mElementOffsets.push_back(mElementNodes.size());
+        }
+        unsigned num_nodes_elem = elem_iter->GetNumNodes();
+        for (unsigned local_index=0; local_index<num_nodes_elem; local_index++)
+        {
+            mElementNodes.push_back(elem_iter->GetNodeGlobalIndex(local_index));
+        }
+        mElementOffsets.push_back(mElementNodes.size());
+    }
+    unsigned num_nodes = rMesh.GetNumAllNodes();
+    mNodeLocations.resize(2*num_nodes);
+    for (unsigned node_index=0; node_index<num_nodes; node_index++)
+    {
+        const c_vector<double, 2>& r_location = rMesh.GetNode(node_index)->rGetLocation();
+        mNodeLocations[2*node_index] = r_location[0];
+        mNodeLocations[2*node_index + 1] = r_location[1];
+    }
+    mKernel.Calculate(mElementOffsets, mElementNodes, mNodeLocations);
+
+    mpMesh = &rMesh;
+    mTimeStepsElapsed = time_steps_elapsed;
+    mNumAllNodes = num_nodes;
+    mNumAllElements = rMesh.GetNumAllElements();
+    mNumElements = rMesh.GetNumElements();
+    mNumMeshChangesCalculated = mNumMeshChanges;
+    return mKernel;
+}
+
+void ElementGeometryCache::MarkMeshChanged()
+{
+    mNumMeshChanges++;
+}
+
+unsigned ElementGeometryCache::GetNumCalculations() const
+{
+    return mKernel.GetNumCalculations();
+}
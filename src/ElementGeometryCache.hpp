@@ -0,0 +1,126 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef ELEMENTGEOMETRYCACHE_HPP_
+#define ELEMENTGEOMETRYCACHE_HPP_
+
+#include <vector>
+#include "MutableVertexMesh.hpp"
+#include "ElementGeometryKernel.hpp"
+
+/**
+ * The geometry of the elements of a 2D vertex mesh (see ElementGeometryKernel),
+ * shared by everything that reads it at one point of a simulation, such as
+ * the writers at an output time step and TissueSummaryStatistics.
+ *
+ * A simulation owns one cache and hands it to its writers (see
+ * AbstractProjectWriter::SetElementGeometryCache()) and to
+ * TissueSummaryStatistics::Calculate(). rGetGeometry() only mirrors the mesh
+ * and calculates the geometry again when a cheap token has changed: the mesh,
+ * the number of time steps elapsed, the numbers of nodes and elements, and a
+ * mesh change counter. The vertices only move, and the topology only changes,
+ * within a time step, so the token covers everything a simulation does
+ * between output steps. Code that changes the mesh without advancing the time,
+ * such as the final update of OffLatticeSimulation::Solve() or a test, must call
+ * MarkMeshChanged(). Without a simulation time, the geometry is calculated at
+ * every call.
+ */
+class ElementGeometryCache
+{
+private:
+
+    /** The mesh the geometry was last calculated for, if any. */
+    const MutableVertexMesh<2,2>* mpMesh;
+
+    /** The number of time steps elapsed when the geometry was last calculated. */
+    unsigned mTimeStepsElapsed;
+
+    /** The number of nodes, including deleted ones, when the geometry was last calculated. */
+    unsigned mNumAllNodes;
+
+    /** The number of elements, including deleted ones, when the geometry was last calculated. */
+    unsigned mNumAllElements;
+
+    /** The number of undeleted elements when the geometry was last calculated. */
+    unsigned mNumElements;
+
+    /** The number of calls to MarkMeshChanged(). */
+    unsigned mNumMeshChanges;
+
+    /** The value of mNumMeshChanges when the geometry was last calculated. */
+    unsigned mNumMeshChangesCalculated;
+
+    /** The element offsets of the mirrored mesh, by element index. */
+    std::vector<unsigned> mElementOffsets;
+
+    /** The element vertex indices of the mirrored mesh. */
+    std::vector<unsigned> mElementNodes;
+
+    /** The vertex locations of the mirrored mesh. */
+    std::vector<double> mNodeLocations;
+
+    /** The geometry. */
+    ElementGeometryKernel mKernel;
+
+public:
+
+    /**
+     * Constructor.
+     */
+    ElementGeometryCache();
+
+    /**
+     * Get the geometry of the elements of a mesh, indexed by element index.
+     * Deleted elements have zero area.
+     *
+     * @param rMesh the mesh
+     * @return the geometry, valid until the next call
+     */
+    const ElementGeometryKernel& rGetGeometry(MutableVertexMesh<2,2>& rMesh);
+
+    /**
+     * Say that the mesh may have changed since the last call to rGetGeometry()
+     * although the simulation time has not, so that the geometry is
+     * calculated again at the next call.
+     */
+    void MarkMeshChanged();
+
+    /**
+     * @return the number of times the geometry has been calculated
+     */
+    unsigned GetNumCalculations() const;
+};
+
+#endif /*ELEMENTGEOMETRYCACHE_HPP_*/
@@ -0,0 +1,176 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "ElementGeometryKernel.hpp"
+#include "Exception.hpp"
+
+#include <cmath>
+
+ElementGeometryKernel::ElementGeometryKernel()
+    : mNumCalculations(0u)
+{
+}
+
+void ElementGeometryKernel::Calculate(const std::vector<unsigned>& rElementOffsets,
+                                      const std::vector<unsigned>& rElementNodes,
+                                      const std::vector<double>& rNodeLocations)
+{
+    if (rElementOffsets.empty() || rElementOffsets.back() != rElementNodes.size())
+    {
+        EXCEPTION("The element offsets do not match the element vertices");
+    }
+
+    unsigned num_elements = rElementOffsets.size() - 1;
+    mAreas.assign(num_elements, 0.0);
+    mPerimeters.assign(num_elements, 0.0);
+    mCentroids.assign(2*num_elements, 0.0);
+    mMoments.assign(3*num_elements, 0.0);
+    mElongationShapeFactors.assign(num_elements, 0.0);
+
+    for (unsigned element=0; element<num_elements; element++)
+    {
+        unsigned first_corner = rElementOffsets[element];
+        unsigned n = rElementOffsets[element + 1] - first_corner;
+        if (n == 0)
+        {
+            continue;
+        }
+        if (mX.size() < n + 1)
+        {
+            mX.resize(n + 1);
+            mY.resize(n + 1);
+        }
+
+        // Relative to the first vertex, as in VertexMesh
+        const unsigned* p_nodes = &rElementNodes[first_corner];
+        double x_0 = rNodeLocations[2*p_nodes[0]];
+        double y_0 = rNodeLocations[2*p_nodes[0] + 1];
+        for (unsigned k=0; k<n; k++)
+        {
+            mX[k] = rNodeLocations[2*p_nodes[k]] - x_0;
+            mY[k] = rNodeLocations[2*p_nodes[k] + 1] - y_0;
+        }
+        mX[n] = mX[0];
+        mY[n] = mY[0];
+
+        double signed_area = 0.0;
+        double perimeter = 0.0;
+        double centroid_x = 0.0;
+        double centroid_y = 0.0;
+        for (unsigned k=0; k<n; k++)
+        {
+            double signed_area_term = mX[k]*mY[k + 1] - mY[k]*mX[k + 1];
+            signed_area += 0.5*signed_area_term;
+            centroid_x += (mX[k] + mX[k + 1])*signed_area_term;
+            centroid_y += (mY[k] + mY[k + 1])*signed_area_term;
+            double dx = mX[k + 1] - mX[k];
+            double dy = mY[k + 1] - mY[k];
+            perimeter += std::sqrt(dx*dx + dy*dy);
+        }
+        centroid_x /= 6.0*signed_area;
+        centroid_y /= 6.0*signed_area;
+
+        // Second moments about the centroid
+        double moment_xx = 0.0;
+        double moment_yy = 0.0;
+        double moment_xy = 0.0;
+        for (unsigned k=0; k<n; k++)
+        {
+            double x_1 = mX[k] - centroid_x;
+            double y_1 = mY[k] - centroid_y;
+            double x_2 = mX[k + 1] - centroid_x;
+            double y_2 = mY[k + 1] - centroid_y;
+            double signed_area_term = x_1*y_2 - x_2*y_1;
+            moment_xx += (y_1*y_1 + y_1*y_2 + y_2*y_2)*signed_area_term;
+            moment_yy += (x_1*x_1 + x_1*x_2 + x_2*x_2)*signed_area_term;
+            moment_xy += (x_1*y_2 + 2.0*x_1*y_1 + 2.0*x_2*y_2 + x_2*y_1)*signed_area_term;
+        }
+        moment_xx /= 12.0;
+        moment_yy /= 12.0;
+        moment_xy /= 24.0;
+
+        // As in VertexMesh, clockwise elements give the moments the wrong sign
+        if (moment_xx < 0.0)
+        {
+            moment_xx = -moment_xx;
+            moment_yy = -moment_yy;
+            moment_xy = -moment_xy;
+        }
+
+        double discriminant = std::sqrt((moment_xx - moment_yy)*(moment_xx - moment_yy) + 4.0*moment_xy*moment_xy);
+        double largest_eigenvalue = 0.5*(moment_xx + moment_yy + discriminant);
+        double smallest_eigenvalue = 0.5*(moment_xx + moment_yy - discriminant);
+
+        mAreas[element] = std::fabs(signed_area);
+        mPerimeters[element] = perimeter;
+        mCentroids[2*element] = x_0 + centroid_x;
+        mCentroids[2*element + 1] = y_0 + centroid_y;
+        mMoments[3*element] = moment_xx;
+        mMoments[3*element + 1] = moment_yy;
+        mMoments[3*element + 2] = moment_xy;
+        mElongationShapeFactors[element] = std::sqrt(largest_eigenvalue/smallest_eigenvalue);
+    }
+    mNumCalculations++;
+}
+
+const std::vector<double>& ElementGeometryKernel::rGetAreas() const
+{
+    return mAreas;
+}
+
+const std::vector<double>& ElementGeometryKernel::rGetPerimeters() const
+{
+    return mPerimeters;
+}
+
+const std::vector<double>& ElementGeometryKernel::rGetCentroids() const
+{
+    return mCentroids;
+}
+
+const std::vector<double>& ElementGeometryKernel::rGetMoments() const
+{
+    return mMoments;
+}
+
+const std::vector<double>& ElementGeometryKernel::rGetElongationShapeFactors() const
+{
+    return mElongationShapeFactors;
+}
+
+unsigned ElementGeometryKernel::GetNumCalculations() const
+{
+    return mNumCalculations;
+}
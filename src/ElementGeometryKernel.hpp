@@ -0,0 +1,136 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef ELEMENTGEOMETRYKERNEL_HPP_
+#define ELEMENTGEOMETRYKERNEL_HPP_
+
+#include <vector>
+
+/**
+ * The geometry of every element of a 2D vertex mesh, calculated in one pass
+ * over plain arrays: area, perimeter, centroid, second moments of area and
+ * elongation shape factor.
+ *
+ * The connectivity is given in compressed rows, as for FarhadifarForceKernel,
+ * except that an element may have no vertices (e.g. a deleted element, so
+ * that the arrays can be indexed by element index); its results are zero.
+ * The quantities are those of VertexMesh::GetVolumeOfElement(),
+ * GetSurfaceAreaOfElement(), GetCentroidOfElement(),
+ * CalculateMomentsOfElement() and GetElongationShapeFactorOfElement(), with
+ * the same formulas, so they agree up to rounding. Each element's vertex
+ * locations are gathered once into contiguous arrays, relative to its first
+ * vertex as in VertexMesh, and the loops over its edges need no modulo
+ * arithmetic or indirection.
+ */
+class ElementGeometryKernel
+{
+private:
+
+    /** The area of each element. */
+    std::vector<double> mAreas;
+
+    /** The perimeter of each element. */
+    std::vector<double> mPerimeters;
+
+    /** The x and y coordinates of the centroid of each element in turn. */
+    std::vector<double> mCentroids;
+
+    /** The second moments of area Ixx, Iyy and Ixy about the centroid of each element in turn. */
+    std::vector<double> mMoments;
+
+    /** The elongation shape factor of each element. */
+    std::vector<double> mElongationShapeFactors;
+
+    /** The x coordinates of the corners of the current element, with the first repeated at the end. */
+    std::vector<double> mX;
+
+    /** The y coordinates of the corners of the current element, with the first repeated at the end. */
+    std::vector<double> mY;
+
+    /** The number of calls to Calculate(). */
+    unsigned mNumCalculations;
+
+public:
+
+    /**
+     * Constructor.
+     */
+    ElementGeometryKernel();
+
+    /**
+     * Calculate the geometry of every element.
+     *
+     * @param rElementOffsets the index in rElementNodes of the first vertex of each element, plus one past the end
+     * @param rElementNodes the vertex indices of all elements, in anticlockwise order within each element
+     * @param rNodeLocations the x and y coordinates of each vertex in turn
+     */
+    void Calculate(const std::vector<unsigned>& rElementOffsets,
+                   const std::vector<unsigned>& rElementNodes,
+                   const std::vector<double>& rNodeLocations);
+
+    /**
+     * @return the area of each element
+     */
+    const std::vector<double>& rGetAreas() const;
+
+    /**
+     * @return the perimeter of each element
+     */
+    const std::vector<double>& rGetPerimeters() const;
+
+    /**
+     * @return the x and y coordinates of the centroid of each element in turn
+     */
+    const std::vector<double>& rGetCentroids() const;
+
+    /**
+     * @return the second moments of area Ixx, Iyy and Ixy about the centroid of
+     *     each element in turn, as from VertexMesh::CalculateMomentsOfElement()
+     */
+    const std::vector<double>& rGetMoments() const;
+
+    /**
+     * @return the elongation shape factor of each element: the square root of
+     *     the ratio of the largest to the smallest eigenvalue of its moments
+     */
+    const std::vector<double>& rGetElongationShapeFactors() const;
+
+    /**
+     * @return the number of calls to Calculate()
+     */
+    unsigned GetNumCalculations() const;
+};
+
+#endif /*ELEMENTGEOMETRYKERNEL_HPP_*/
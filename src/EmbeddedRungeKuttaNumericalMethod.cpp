@@ -0,0 +1,184 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "EmbeddedRungeKuttaNumericalMethod.hpp"
+
+#include <algorithm>
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+EmbeddedRungeKuttaNumericalMethod<ELEMENT_DIM,SPACE_DIM>::EmbeddedRungeKuttaNumericalMethod()
+    : AbstractAdaptiveNumericalMethod<ELEMENT_DIM,SPACE_DIM>(),
+      mOrder(5u),
+      mTableau(EmbeddedRungeKuttaTableau::Create(5u)),
+      mHaveStartForces(false)
+{
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+EmbeddedRungeKuttaNumericalMethod<ELEMENT_DIM,SPACE_DIM>::~EmbeddedRungeKuttaNumericalMethod()
+{
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void EmbeddedRungeKuttaNumericalMethod<ELEMENT_DIM,SPACE_DIM>::BeginTimeStep()
+{
+    if (mTableau.GetOrder() != mOrder)
+    {
+        mTableau = EmbeddedRungeKuttaTableau::Create(mOrder);
+    }
+    mStageForces.resize(mTableau.GetNumStages());
+
+    // The mesh may have been remeshed and the target areas changed since the last time step
+    mHaveStartForces = false;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double EmbeddedRungeKuttaNumericalMethod<ELEMENT_DIM,SPACE_DIM>::AttemptSubstep(double substep)
+{
+    if (!mHaveStartForces)
+    {
+        mStageForces[0] = this->ComputeForces();
+        mHaveStartForces = true;
+    }
+
+    unsigned num_nodes = this->mSubstepStartLocations.size();
+    unsigned num_stages = mTableau.GetNumStages();
+    std::vector<c_vector<double, SPACE_DIM> > locations(num_nodes);
+    for (unsigned stage=1; stage<num_stages; stage++)
+    {
+        const std::vector<double>& r_coefficients = mTableau.rGetStageCoefficients(stage);
+        for (unsigned index=0; index<num_nodes; index++)
+        {
+            locations[index] = this->mSubstepStartLocations[index];
+            for (unsigned previous=0; previous<stage; previous++)
+            {
+                if (r_coefficients[previous] != 0.0)
+                {
+                    locations[index] += (substep*r_coefficients[previous])*mStageForces[previous][index];
+                }
+            }
+        }
+        this->SetNodeLocations(locations);
+        mStageForces[stage] = this->ComputeForces();
+    }
+
+    // The last stage of a first-same-as-last pair is at the new locations; otherwise move there
+    const std::vector<double>& r_solution_weights = mTableau.rGetSolutionWeights();
+    if (!mTableau.IsFirstSameAsLast())
+    {
+        for (unsigned index=0; index<num_nodes; index++)
+        {
+            locations[index] = this->mSubstepStartLocations[index];
+            for (unsigned stage=0; stage<num_stages; stage++)
+            {
+                locations[index] += (substep*r_solution_weights[stage])*mStageForces[stage][index];
+            }
+        }
+        this->SetNodeLocations(locations);
+    }
+
+    const std::vector<double>& r_error_weights = mTableau.rGetErrorWeights();
+    double max_error = 0.0;
+    for (unsigned index=0; index<num_nodes; index++)
+    {
+        c_vector<double, SPACE_DIM> error = zero_vector<double>(SPACE_DIM);
+        for (unsigned stage=0; stage<num_stages; stage++)
+        {
+            error += (substep*r_error_weights[stage])*mStageForces[stage][index];
+        }
+
+        // Comparing this way round lets a NaN through, so that the sub-step is rejected
+        double norm = norm_2(error);
+        if (!(norm <= max_error))
+        {
+            max_error = norm;
+        }
+    }
+    return max_error;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void EmbeddedRungeKuttaNumericalMethod<ELEMENT_DIM,SPACE_DIM>::AcceptSubstep()
+{
+    if (mTableau.IsFirstSameAsLast())
+    {
+        std::swap(mStageForces[0], mStageForces.back());
+    }
+    else
+    {
+        mHaveStartForces = false;
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned EmbeddedRungeKuttaNumericalMethod<ELEMENT_DIM,SPACE_DIM>::GetErrorOrder() const
+{
+    return mOrder - 1u;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void EmbeddedRungeKuttaNumericalMethod<ELEMENT_DIM,SPACE_DIM>::SetOrder(unsigned order)
+{
+    // Let the tableau check the order
+    mTableau = EmbeddedRungeKuttaTableau::Create(order);
+    mOrder = order;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned EmbeddedRungeKuttaNumericalMethod<ELEMENT_DIM,SPACE_DIM>::GetOrder() const
+{
+    return mOrder;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void EmbeddedRungeKuttaNumericalMethod<ELEMENT_DIM,SPACE_DIM>::OutputNumericalMethodParameters(out_stream& rParamsFile)
+{
+    *rParamsFile << "\t\t\t<Order>" << mOrder << "</Order>\n";
+
+    // Call method on direct parent class
+    AbstractAdaptiveNumericalMethod<ELEMENT_DIM,SPACE_DIM>::OutputNumericalMethodParameters(rParamsFile);
+}
+
+// Explicit instantiation
+template class EmbeddedRungeKuttaNumericalMethod<1,1>;
+template class EmbeddedRungeKuttaNumericalMethod<1,2>;
+template class EmbeddedRungeKuttaNumericalMethod<2,2>;
+template class EmbeddedRungeKuttaNumericalMethod<1,3>;
+template class EmbeddedRungeKuttaNumericalMethod<2,3>;
+template class EmbeddedRungeKuttaNumericalMethod<3,3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_ALL_DIMS(EmbeddedRungeKuttaNumericalMethod)
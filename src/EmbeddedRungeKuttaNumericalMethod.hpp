@@ -0,0 +1,147 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef EMBEDDEDRUNGEKUTTANUMERICALMETHOD_HPP_
+#define EMBEDDEDRUNGEKUTTANUMERICALMETHOD_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+#include "AbstractAdaptiveNumericalMethod.hpp"
+#include "EmbeddedRungeKuttaTableau.hpp"
+
+/**
+ * An adaptive numerical method using an embedded Runge-Kutta pair: the
+ * Dormand-Prince pair RK45 (the default) or the Bogacki-Shampine pair RK23;
+ * see EmbeddedRungeKuttaTableau and AbstractAdaptiveNumericalMethod.
+ *
+ * RK45 costs six force calculations per sub-step and RK23 three, but both
+ * take far longer sub-steps than forward Euler at the same accuracy, so they
+ * pay off when the tolerance is tight or the time step is long.
+ */
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM=ELEMENT_DIM>
+class EmbeddedRungeKuttaNumericalMethod : public AbstractAdaptiveNumericalMethod<ELEMENT_DIM, SPACE_DIM>
+{
+private:
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Serialize the object and its member variables.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractAdaptiveNumericalMethod<ELEMENT_DIM, SPACE_DIM> >(*this);
+        archive & mOrder;
+    }
+
+    /** The order of the method, 3 or 5. Defaults to 5. */
+    unsigned mOrder;
+
+    /** The tableau of the method; rebuilt from mOrder when needed, so not archived. */
+    EmbeddedRungeKuttaTableau mTableau;
+
+    /** The forces at each stage of the current sub-step, in node iterator order. */
+    std::vector<std::vector<c_vector<double, SPACE_DIM> > > mStageForces;
+
+    /** Whether mStageForces[0] holds the forces at mSubstepStartLocations. */
+    bool mHaveStartForces;
+
+protected:
+
+    /**
+     * Overridden BeginTimeStep() method.
+     */
+    virtual void BeginTimeStep();
+
+    /**
+     * Overridden AttemptSubstep() method.
+     *
+     * @param substep the length of the sub-step
+     * @return the largest norm of the error estimate over the nodes
+     */
+    virtual double AttemptSubstep(double substep);
+
+    /**
+     * Overridden AcceptSubstep() method.
+     */
+    virtual void AcceptSubstep();
+
+    /**
+     * Overridden GetErrorOrder() method.
+     *
+     * @return the order of the embedded lower-order method
+     */
+    virtual unsigned GetErrorOrder() const;
+
+public:
+
+    /**
+     * Constructor.
+     */
+    EmbeddedRungeKuttaNumericalMethod();
+
+    /**
+     * Destructor.
+     */
+    virtual ~EmbeddedRungeKuttaNumericalMethod();
+
+    /**
+     * Set the order of the method.
+     *
+     * @param order 5 for RK45 or 3 for RK23
+     */
+    void SetOrder(unsigned order);
+
+    /**
+     * @return the order of the method
+     */
+    unsigned GetOrder() const;
+
+    /**
+     * Overridden OutputNumericalMethodParameters() method.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    virtual void OutputNumericalMethodParameters(out_stream& rParamsFile);
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_ALL_DIMS(EmbeddedRungeKuttaNumericalMethod)
+
+#endif /*EMBEDDEDRUNGEKUTTANUMERICALMETHOD_HPP_*/
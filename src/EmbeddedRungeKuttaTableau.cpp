@@ -0,0 +1,125 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "EmbeddedRungeKuttaTableau.hpp"
+#include "Exception.hpp"
+
+EmbeddedRungeKuttaTableau::EmbeddedRungeKuttaTableau(unsigned order,
+                                                     const std::vector<std::vector<double> >& rStageCoefficients,
+                                                     const std::vector<double>& rSolutionWeights,
+                                                     const std::vector<double>& rLowerOrderWeights)
+    : mOrder(order),
+      mStageCoefficients(rStageCoefficients),
+      mSolutionWeights(rSolutionWeights),
+      mErrorWeights(rSolutionWeights.size())
+{
+    for (unsigned stage=0; stage<mErrorWeights.size(); stage++)
+    {
+        mErrorWeights[stage] = rSolutionWeights[stage] - rLowerOrderWeights[stage];
+    }
+}
+
+EmbeddedRungeKuttaTableau EmbeddedRungeKuttaTableau::Create(unsigned order)
+{
+    if (order == 3u)
+    {
+        // Bogacki and Shampine (1989), Appl. Math. Lett. 2:321-325
+        return EmbeddedRungeKuttaTableau(3u,
+            {{},
+             {1.0/2.0},
+             {0.0, 3.0/4.0},
+             {2.0/9.0, 1.0/3.0, 4.0/9.0}},
+            {2.0/9.0, 1.0/3.0, 4.0/9.0, 0.0},
+            {7.0/24.0, 1.0/4.0, 1.0/3.0, 1.0/8.0});
+    }
+    else if (order == 5u)
+    {
+        // Dormand and Prince (1980), J. Comput. Appl. Math. 6:19-26
+        return EmbeddedRungeKuttaTableau(5u,
+            {{},
+             {1.0/5.0},
+             {3.0/40.0, 9.0/40.0},
+             {44.0/45.0, -56.0/15.0, 32.0/9.0},
+             {19372.0/6561.0, -25360.0/2187.0, 64448.0/6561.0, -212.0/729.0},
+             {9017.0/3168.0, -355.0/33.0, 46732.0/5247.0, 49.0/176.0, -5103.0/18656.0},
+             {35.0/384.0, 0.0, 500.0/1113.0, 125.0/192.0, -2187.0/6784.0, 11.0/84.0}},
+            {35.0/384.0, 0.0, 500.0/1113.0, 125.0/192.0, -2187.0/6784.0, 11.0/84.0, 0.0},
+            {5179.0/57600.0, 0.0, 7571.0/16695.0, 393.0/640.0, -92097.0/339200.0, 187.0/2100.0, 1.0/40.0});
+    }
+    EXCEPTION("There are embedded Runge-Kutta methods of order 3 and 5 only, not " << order);
+}
+
+unsigned EmbeddedRungeKuttaTableau::GetOrder() const
+{
+    return mOrder;
+}
+
+unsigned EmbeddedRungeKuttaTableau::GetErrorOrder() const
+{
+    return mOrder - 1u;
+}
+
+unsigned EmbeddedRungeKuttaTableau::GetNumStages() const
+{
+    return mSolutionWeights.size();
+}
+
+const std::vector<double>& EmbeddedRungeKuttaTableau::rGetStageCoefficients(unsigned stage) const
+{
+    return mStageCoefficients[stage];
+}
+
+const std::vector<double>& EmbeddedRungeKuttaTableau::rGetSolutionWeights() const
+{
+    return mSolutionWeights;
+}
+
+const std::vector<double>& EmbeddedRungeKuttaTableau::rGetErrorWeights() const
+{
+    return mErrorWeights;
+}
+
+bool EmbeddedRungeKuttaTableau::IsFirstSameAsLast() const
+{
+    const std::vector<double>& r_last_stage = mStageCoefficients.back();
+    for (unsigned stage=0; stage<r_last_stage.size(); stage++)
+    {
+        if (r_last_stage[stage] != mSolutionWeights[stage])
+        {
+            return false;
+        }
+    }
+    return mSolutionWeights.back() == 0.0;
+}
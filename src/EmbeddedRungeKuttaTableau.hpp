@@ -0,0 +1,133 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef EMBEDDEDRUNGEKUTTATABLEAU_HPP_
+#define EMBEDDEDRUNGEKUTTATABLEAU_HPP_
+
+#include <vector>
+
+/**
+ * The coefficients of an explicit embedded Runge-Kutta pair, for
+ * EmbeddedRungeKuttaNumericalMethod.
+ *
+ * For dx/dt = f(x), a step of length h from x evaluates the stages
+ *
+ *   k_i = f(x + h sum_{j<i} a_ij k_j),
+ *
+ * advances to x + h sum_i b_i k_i and estimates the error of the step as
+ * h sum_i e_i k_i, the difference from the embedded lower-order solution. Both
+ * pairs provided are "first same as last": the last stage is evaluated at the
+ * new x, so it is the first stage of the next step and a step costs one
+ * evaluation of f fewer than it has stages.
+ */
+class EmbeddedRungeKuttaTableau
+{
+private:
+
+    /** The order of the solution. */
+    unsigned mOrder;
+
+    /** The coefficients a_ij of each stage i. */
+    std::vector<std::vector<double> > mStageCoefficients;
+
+    /** The weights b_i of the solution. */
+    std::vector<double> mSolutionWeights;
+
+    /** The weights e_i of the error estimate. */
+    std::vector<double> mErrorWeights;
+
+    /**
+     * Constructor.
+     *
+     * @param order the order of the solution
+     * @param rStageCoefficients the coefficients of each stage
+     * @param rSolutionWeights the weights of the solution
+     * @param rLowerOrderWeights the weights of the embedded lower-order solution
+     */
+    EmbeddedRungeKuttaTableau(unsigned order,
+                              const std::vector<std::vector<double> >& rStageCoefficients,
+                              const std::vector<double>& rSolutionWeights,
+                              const std::vector<double>& rLowerOrderWeights);
+
+public:
+
+    /**
+     * Create a tableau.
+     *
+     * @param order 3 for the Bogacki-Shampine pair RK23, or 5 for the
+     *     Dormand-Prince pair RK45
+     * @return the tableau
+     */
+    static EmbeddedRungeKuttaTableau Create(unsigned order);
+
+    /**
+     * @return the order of the solution
+     */
+    unsigned GetOrder() const;
+
+    /**
+     * @return the order of the embedded solution, which sets how the error
+     *     estimate scales with the step
+     */
+    unsigned GetErrorOrder() const;
+
+    /**
+     * @return the number of stages
+     */
+    unsigned GetNumStages() const;
+
+    /**
+     * @param stage the stage
+     * @return the coefficients a_ij of the stage, one per earlier stage
+     */
+    const std::vector<double>& rGetStageCoefficients(unsigned stage) const;
+
+    /**
+     * @return the weights b_i of the solution
+     */
+    const std::vector<double>& rGetSolutionWeights() const;
+
+    /**
+     * @return the weights e_i of the error estimate
+     */
+    const std::vector<double>& rGetErrorWeights() const;
+
+    /**
+     * @return whether the last stage is evaluated at the new solution
+     */
+    bool IsFirstSameAsLast() const;
+};
+
+#endif /*EMBEDDEDRUNGEKUTTATABLEAU_HPP_*/
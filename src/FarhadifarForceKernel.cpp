@@ -0,0 +1,529 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "FarhadifarForceKernel.hpp"
+#include "Exception.hpp"
+#include "MeshRenumbering.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+
+FarhadifarForceKernel::FarhadifarForceKernel()
+    : mRenumber(false),
+      mNumNodes(0u),
+      mInputElementOffsets(1, 0u),
+      mNumLocalNodes(0u),
+      mElementOffsets(1, 0u),
+      mColourOffsets(1, 0u),
+      mScratch(1),
+      mNumThreads(1u),
+      mCalculateStiffness(false),
+      mNumTopologyUpdates(0u)
+{
+}
+
+bool FarhadifarForceKernel::SetTopology(const std::vector<unsigned>& rElementOffsets,
+                                        const std::vector<unsigned>& rElementNodes,
+                                        unsigned numNodes)
+{
+    if (numNodes == mNumNodes && rElementOffsets == mInputElementOffsets && rElementNodes == mInputElementNodes)
+    {
+        return false;
+    }
+
+    if (rElementOffsets.empty() || rElementOffsets.back() != rElementNodes.size())
+    {
+        EXCEPTION("The element offsets do not match the element vertices");
+    }
+    for (unsigned element=0; element+1<rElementOffsets.size(); element++)
+    {
+        if (rElementOffsets[element + 1] < rElementOffsets[element] + 3)
+        {
+            EXCEPTION("Element " << element << " has fewer than three vertices");
+        }
+    }
+    for (unsigned i=0; i<rElementNodes.size(); i++)
+    {
+        if (rElementNodes[i] >= numNodes)
+        {
+            EXCEPTION("Vertex " << rElementNodes[i] << " is out of range");
+        }
+    }
+
+    mNumNodes = numNodes;
+    mInputElementOffsets = rElementOffsets;
+    mInputElementNodes = rElementNodes;
+    UpdateNumbering();
+    UpdateBoundaryEdges();
+    UpdateColouring();
+    mNumTopologyUpdates++;
+    return true;
+}
+
+void FarhadifarForceKernel::UpdateNumbering()
+{
+    if (!mRenumber)
+    {
+        mNumLocalNodes = mNumNodes;
+        mElementOffsets = mInputElementOffsets;
+        mElementNodes = mInputElementNodes;
+        mElementOrder.clear();
+        mNodeOrder.clear();
+        return;
+    }
+
+    std::vector<unsigned> graph_offsets;
+    std::vector<unsigned> graph_neighbours;
+    MeshRenumbering::GetElementGraph(mInputElementOffsets, mInputElementNodes, mNumNodes, graph_offsets, graph_neighbours);
+    mElementOrder = MeshRenumbering::GetReverseCuthillMcKeeOrder(graph_offsets, graph_neighbours);
+    mNodeOrder = MeshRenumbering::GetNodeOrder(mInputElementOffsets, mInputElementNodes, mNumNodes, mElementOrder);
+    mNumLocalNodes = mNodeOrder.size();
+
+    std::vector<unsigned> local_indices(mNumNodes, 0u);
+    for (unsigned node=0; node<mNumLocalNodes; node++)
+    {
+        local_indices[mNodeOrder[node]] = node;
+    }
+    mElementOffsets.assign(1, 0u);
+    mElementNodes.clear();
+    mElementNodes.reserve(mInputElementNodes.size());
+    for (unsigned element=0; element<mElementOrder.size(); element++)
+    {
+        unsigned input_element = mElementOrder[element];
+        for (unsigned corner=mInputElementOffsets[input_element]; corner<mInputElementOffsets[input_element + 1]; corner++)
+        {
+            mElementNodes.push_back(local_indices[mInputElementNodes[corner]]);
+        }
+        mElementOffsets.push_back(mElementNodes.size());
+    }
+}
+
+void FarhadifarForceKernel::UpdateBoundaryEdges()
+{
+    // Sort the edges of all elements by their vertices; an edge that appears once is on the boundary
+    unsigned num_corners = mElementNodes.size();
+    std::vector<std::pair<uint64_t, unsigned> > edges(num_corners);
+    for (unsigned element=0; element+1<mElementOffsets.size(); element++)
+    {
+        unsigned begin = mElementOffsets[element];
+        unsigned end = mElementOffsets[element + 1];
+        for (unsigned corner=begin; corner<end; corner++)
+        {
+            unsigned a = mElementNodes[corner];
+            unsigned b = mElementNodes[(corner + 1 == end) ? begin : corner + 1];
+            uint64_t key = (uint64_t(std::min(a, b)) << 32) | uint64_t(std::max(a, b));
+            edges[corner] = std::make_pair(key, corner);
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+
+    mIsBoundaryEdge.assign(num_corners, 0u);
+    for (unsigned i=0; i<num_corners; )
+    {
+        unsigned j = i + 1;
+        while (j < num_corners && edges[j].first == edges[i].first)
+        {
+            j++;
+        }
+        if (j - i == 1)
+        {
+            mIsBoundaryEdge[edges[i].second] = 1u;
+        }
+        i = j;
+    }
+}
+
+void FarhadifarForceKernel::UpdateColouring()
+{
+    // Greedy colouring in element order: each element gets the lowest colour not
+    // yet used by an element sharing one of its vertices
+    unsigned num_elements = mElementOffsets.size() - 1;
+    std::vector<uint64_t> node_colours(mNumLocalNodes, 0u);
+    mElementColours.resize(num_elements);
+    unsigned num_colours = 0;
+    for (unsigned element=0; element<num_elements; element++)
+    {
+        uint64_t used_colours = 0u;
+        for (unsigned corner=mElementOffsets[element]; corner<mElementOffsets[element + 1]; corner++)
+        {
+            used_colours |= node_colours[mElementNodes[corner]];
+        }
+        if (~used_colours == 0u)
+        {
+            unsigned input_element = mRenumber ? mElementOrder[element] : element;
+            EXCEPTION("Element " << input_element << " shares vertices with elements of 64 different colours");
+        }
+
+        unsigned colour = 0;
+        while (used_colours & (uint64_t(1) << colour))
+        {
+            colour++;
+        }
+        mElementColours[element] = colour;
+        num_colours = std::max(num_colours, colour + 1);
+        for (unsigned corner=mElementOffsets[element]; corner<mElementOffsets[element + 1]; corner++)
+        {
+            node_colours[mElementNodes[corner]] |= uint64_t(1) << colour;
+        }
+    }
+
+    // Sort the elements by colour, keeping them in order within each colour
+    mColourOffsets.assign(num_colours + 1, 0u);
+    for (unsigned element=0; element<num_elements; element++)
+    {
+        mColourOffsets[mElementColours[element] + 1]++;
+    }
+    for (unsigned colour=0; colour<num_colours; colour++)
+    {
+        mColourOffsets[colour + 1] += mColourOffsets[colour];
+    }
+    mElementsByColour.resize(num_elements);
+    std::vector<unsigned> next_slot(mColourOffsets.begin(), mColourOffsets.end() - 1);
+    for (unsigned element=0; element<num_elements; element++)
+    {
+        mElementsByColour[next_slot[mElementColours[element]]++] = element;
+    }
+
+    if (mRenumber)
+    {
+        mInputElementColours.resize(num_elements);
+        for (unsigned element=0; element<num_elements; element++)
+        {
+            mInputElementColours[mElementOrder[element]] = mElementColours[element];
+        }
+    }
+}
+
+void FarhadifarForceKernel::CalculateForces(const std::vector<double>& rNodeLocations,
+                                            const std::vector<double>& rTargetAreas,
+                                            double areaElasticity,
+                                            double perimeterContractility,
+                                            double lineTension,
+                                            double boundaryLineTension,
+                                            std::vector<double>& rForces)
+{
+    unsigned num_elements = mElementOffsets.size() - 1;
+    if (rNodeLocations.size() != 2*mNumNodes)
+    {
+        EXCEPTION("Expected the locations of " << mNumNodes << " vertices");
+    }
+    if (rTargetAreas.size() != num_elements)
+    {
+        EXCEPTION("Expected the target areas of " << num_elements << " elements");
+    }
+
+    rForces.assign(2*mNumNodes, 0.0);
+    mElementAreas.resize(num_elements);
+    mElementPerimeters.resize(num_elements);
+
+    // Internal edges are visited once from each of their two elements, so each visit gets half the tension
+    const double edge_tensions[2] = {0.5*lineTension, boundaryLineTension};
+    const double* p_locations = rNodeLocations.data();
+    const double* p_target_areas = rTargetAreas.data();
+    double* p_forces = rForces.data();
+    if (mRenumber)
+    {
+        // Gather the input into the kernel's numbering
+        mLocalLocations.resize(2*mNumLocalNodes);
+        for (unsigned node=0; node<mNumLocalNodes; node++)
+        {
+            mLocalLocations[2*node] = rNodeLocations[2*mNodeOrder[node]];
+            mLocalLocations[2*node + 1] = rNodeLocations[2*mNodeOrder[node] + 1];
+        }
+        mLocalTargetAreas.resize(num_elements);
+        for (unsigned element=0; element<num_elements; element++)
+        {
+            mLocalTargetAreas[element] = rTargetAreas[mElementOrder[element]];
+        }
+        mLocalForces.assign(2*mNumLocalNodes, 0.0);
+        p_locations = mLocalLocations.data();
+        p_target_areas = mLocalTargetAreas.data();
+        p_forces = mLocalForces.data();
+    }
+    double* p_stiffness = nullptr;
+    if (mCalculateStiffness)
+    {
+        mVertexStiffness.assign(3*mNumLocalNodes, 0.0);
+        p_stiffness = mVertexStiffness.data();
+    }
+
+    if (mNumThreads == 1u)
+    {
+        // The colours are stored one after another, so this is the same order as below
+        ProcessElements(0u, num_elements, mScratch[0], p_locations, p_target_areas, edge_tensions,
+                        areaElasticity, perimeterContractility, p_forces, p_stiffness);
+    }
+    else
+    {
+        if (!mpThreadTeam || mpThreadTeam->GetNumThreads() != mNumThreads)
+        {
+            mpThreadTeam.reset(new ThreadTeam(mNumThreads));
+        }
+        mScratch.resize(mNumThreads);
+
+        // No two elements of a colour share a vertex, so the threads never add to the same vertex
+        for (unsigned colour=0; colour+1<mColourOffsets.size(); colour++)
+        {
+            unsigned colour_begin = mColourOffsets[colour];
+            unsigned colour_size = mColourOffsets[colour + 1] - colour_begin;
+            mpThreadTeam->Run([&](unsigned threadIndex)
+            {
+                unsigned begin = colour_begin + (unsigned long)colour_size*threadIndex/mNumThreads;
+                unsigned end = colour_begin + (unsigned long)colour_size*(threadIndex + 1)/mNumThreads;
+                ProcessElements(begin, end, mScratch[threadIndex], p_locations, p_target_areas, edge_tensions,
+                                areaElasticity, perimeterContractility, p_forces, p_stiffness);
+            });
+        }
+    }
+
+    if (mRenumber)
+    {
+        // Scatter the results back to the caller's numbering
+        for (unsigned node=0; node<mNumLocalNodes; node++)
+        {
+            rForces[2*mNodeOrder[node]] = mLocalForces[2*node];
+            rForces[2*mNodeOrder[node] + 1] = mLocalForces[2*node + 1];
+        }
+        mInputElementAreas.resize(num_elements);
+        mInputElementPerimeters.resize(num_elements);
+        for (unsigned element=0; element<num_elements; element++)
+        {
+            mInputElementAreas[mElementOrder[element]] = mElementAreas[element];
+            mInputElementPerimeters[mElementOrder[element]] = mElementPerimeters[element];
+        }
+        if (mCalculateStiffness)
+        {
+            mInputVertexStiffness.assign(3*mNumNodes, 0.0);
+            for (unsigned node=0; node<mNumLocalNodes; node++)
+            {
+                for (unsigned i=0; i<3; i++)
+                {
+                    mInputVertexStiffness[3*mNodeOrder[node] + i] = mVertexStiffness[3*node + i];
+                }
+            }
+        }
+    }
+}
+
+void FarhadifarForceKernel::ProcessElements(unsigned begin,
+                                            unsigned end,
+                                            ElementScratch& rScratch,
+                                            const double* pLocations,
+                                            const double* pTargetAreas,
+                                            const double* pEdgeTensions,
+                                            double areaElasticity,
+                                            double perimeterContractility,
+                                            double* pForces,
+                                            double* pStiffness)
+{
+    std::vector<double>& x = rScratch.mX;
+    std::vector<double>& y = rScratch.mY;
+    std::vector<double>& unit_x = rScratch.mUnitX;
+    std::vector<double>& unit_y = rScratch.mUnitY;
+    std::vector<double>& tension = rScratch.mTension;
+    std::vector<double>& length = rScratch.mLength;
+
+    for (unsigned index=begin; index<end; index++)
+    {
+        unsigned element = mElementsByColour[index];
+        unsigned first_corner = mElementOffsets[element];
+        unsigned n = mElementOffsets[element + 1] - first_corner;
+        const unsigned* p_nodes = &mElementNodes[first_corner];
+        const unsigned char* p_boundary = &mIsBoundaryEdge[first_corner];
+
+        if (x.size() < n + 2)
+        {
+            x.resize(n + 2);
+            y.resize(n + 2);
+            unit_x.resize(n + 2);
+            unit_y.resize(n + 2);
+            tension.resize(n + 2);
+            length.resize(n + 2);
+        }
+
+        for (unsigned k=0; k<n; k++)
+        {
+            x[k + 1] = pLocations[2*p_nodes[k]];
+            y[k + 1] = pLocations[2*p_nodes[k] + 1];
+            tension[k + 1] = pEdgeTensions[p_boundary[k]];
+        }
+        x[0] = x[n];
+        y[0] = y[n];
+        x[n + 1] = x[1];
+        y[n + 1] = y[1];
+        tension[0] = tension[n];
+
+        // Area (relative to the first vertex, as in VertexMesh::GetVolumeOfElement()),
+        // perimeter and the unit vector from the end of each edge to its start,
+        // which is the gradient of the edge length at its start
+        double x_0 = x[1];
+        double y_0 = y[1];
+        double twice_area = 0.0;
+        double perimeter = 0.0;
+        for (unsigned k=1; k<=n; k++)
+        {
+            double dx = x[k] - x[k + 1];
+            double dy = y[k] - y[k + 1];
+            length[k] = std::sqrt(dx*dx + dy*dy);
+            unit_x[k] = dx/length[k];
+            unit_y[k] = dy/length[k];
+            perimeter += length[k];
+            twice_area += (x[k] - x_0)*(y[k + 1] - y_0) - (x[k + 1] - x_0)*(y[k] - y_0);
+        }
+        unit_x[0] = unit_x[n];
+        unit_y[0] = unit_y[n];
+        length[0] = length[n];
+
+        double area = 0.5*std::fabs(twice_area);
+        mElementAreas[element] = area;
+        mElementPerimeters[element] = perimeter;
+
+        double area_factor = -0.5*areaElasticity*(area - pTargetAreas[element]);
+        double perimeter_factor = -perimeterContractility*perimeter;
+
+        for (unsigned k=1; k<=n; k++)
+        {
+            // The gradients at this corner of the previous and next edges' lengths
+            double previous_x = -unit_x[k - 1];
+            double previous_y = -unit_y[k - 1];
+            double next_x = unit_x[k];
+            double next_y = unit_y[k];
+
+            double force_x = area_factor*(y[k + 1] - y[k - 1])
+                             + perimeter_factor*(previous_x + next_x)
+                             - (tension[k - 1]*previous_x + tension[k]*next_x);
+            double force_y = -area_factor*(x[k + 1] - x[k - 1])
+                             + perimeter_factor*(previous_y + next_y)
+                             - (tension[k - 1]*previous_y + tension[k]*next_y);
+
+            unsigned node = p_nodes[k - 1];
+            pForces[2*node] += force_x;
+            pForces[2*node + 1] += force_y;
+
+            if (pStiffness)
+            {
+                double area_x = 0.5*(y[k + 1] - y[k - 1]);
+                double area_y = -0.5*(x[k + 1] - x[k - 1]);
+                double perimeter_x = previous_x + next_x;
+                double perimeter_y = previous_y + next_y;
+                double contractility = std::max(perimeterContractility, 0.0);
+                double previous_curvature = (contractility*perimeter + std::max(tension[k - 1], 0.0))/length[k - 1];
+                double next_curvature = (contractility*perimeter + std::max(tension[k], 0.0))/length[k];
+
+                pStiffness[3*node] += areaElasticity*area_x*area_x + contractility*perimeter_x*perimeter_x
+                                      + previous_curvature*(1.0 - unit_x[k - 1]*unit_x[k - 1])
+                                      + next_curvature*(1.0 - unit_x[k]*unit_x[k]);
+                pStiffness[3*node + 1] += areaElasticity*area_x*area_y + contractility*perimeter_x*perimeter_y
+                                          - previous_curvature*unit_x[k - 1]*unit_y[k - 1]
+                                          - next_curvature*unit_x[k]*unit_y[k];
+                pStiffness[3*node + 2] += areaElasticity*area_y*area_y + contractility*perimeter_y*perimeter_y
+                                          + previous_curvature*(1.0 - unit_y[k - 1]*unit_y[k - 1])
+                                          + next_curvature*(1.0 - unit_y[k]*unit_y[k]);
+            }
+        }
+    }
+}
+
+void FarhadifarForceKernel::SetCalculateStiffness(bool calculateStiffness)
+{
+    mCalculateStiffness = calculateStiffness;
+}
+
+const std::vector<double>& FarhadifarForceKernel::rGetVertexStiffness() const
+{
+    return mRenumber ? mInputVertexStiffness : mVertexStiffness;
+}
+
+const std::vector<double>& FarhadifarForceKernel::rGetElementAreas() const
+{
+    return mRenumber ? mInputElementAreas : mElementAreas;
+}
+
+const std::vector<double>& FarhadifarForceKernel::rGetElementPerimeters() const
+{
+    return mRenumber ? mInputElementPerimeters : mElementPerimeters;
+}
+
+void FarhadifarForceKernel::SetRenumbering(bool renumber)
+{
+    if (renumber != mRenumber)
+    {
+        mRenumber = renumber;
+        UpdateNumbering();
+        UpdateBoundaryEdges();
+        UpdateColouring();
+    }
+}
+
+bool FarhadifarForceKernel::GetRenumbering() const
+{
+    return mRenumber;
+}
+
+const std::vector<unsigned>& FarhadifarForceKernel::rGetElementOrder() const
+{
+    return mElementOrder;
+}
+
+unsigned FarhadifarForceKernel::GetNumTopologyUpdates() const
+{
+    return mNumTopologyUpdates;
+}
+
+void FarhadifarForceKernel::SetNumThreads(unsigned numThreads)
+{
+    if (numThreads == 0u)
+    {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    mNumThreads = numThreads;
+}
+
+unsigned FarhadifarForceKernel::GetNumThreads() const
+{
+    return mNumThreads;
+}
+
+const std::vector<unsigned>& FarhadifarForceKernel::rGetElementColours() const
+{
+    return mRenumber ? mInputElementColours : mElementColours;
+}
+
+unsigned FarhadifarForceKernel::GetNumColours() const
+{
+    return mColourOffsets.size() - 1;
+}
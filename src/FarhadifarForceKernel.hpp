@@ -0,0 +1,352 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef FARHADIFARFORCEKERNEL_HPP_
+#define FARHADIFARFORCEKERNEL_HPP_
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include "ThreadTeam.hpp"
+
+/**
+ * The arithmetic of FasterFarhadifarForce, on plain arrays so that it does not
+ * depend on Chaste's mesh classes.
+ *
+ * The connectivity of the mesh is held in compressed rows: the vertices of
+ * element e, in anticlockwise order, are rElementNodes[rElementOffsets[e]] to
+ * rElementNodes[rElementOffsets[e+1]-1]. The connectivity is passed in at every
+ * time step by SetTopology(), which only rebuilds the derived data (which edges
+ * are on the tissue boundary) when it has changed, i.e. after T1, T2 or T3
+ * swaps or divisions.
+ *
+ * CalculateForces() then works through the elements one at a time: it gathers
+ * the element's vertex locations into contiguous arrays padded at both ends,
+ * so that the loops over the element's edges and corners need no modulo
+ * arithmetic or indirection, and scatters the force on each corner to its
+ * vertex. The energy and its gradients are those of Chaste's FarhadifarForce:
+ *
+ *   E = sum_cells K/2 (A - A0)^2 + sum_cells Gamma/2 P^2 + sum_edges Lambda_ij l_ij
+ *
+ * where internal edges have line tension Lambda and boundary edges the boundary
+ * line tension.
+ *
+ * With SetNumThreads(), the elements are processed by a team of threads. When
+ * the topology changes, the elements are coloured greedily so that no two
+ * elements of a colour share a vertex; the colours are then processed one after
+ * another, and the elements of a colour in parallel, so that no two threads add
+ * to the same vertex and no locks or atomics are needed. The elements are
+ * always processed in colour order, also by a single thread, so each vertex
+ * receives its contributions in the same order whatever the number of threads
+ * and the forces are bitwise identical.
+ *
+ * With SetRenumbering(true), when the topology changes, the kernel also numbers
+ * its own copy of the mesh afresh (see MeshRenumbering): the elements in reverse Cuthill-McKee order of
+ * the graph of elements that share vertices, and the vertices by their first
+ * use in that order, leaving out vertices that belong to no element. Elements
+ * that are neighbours in the tissue are then close together in memory, as are
+ * their vertices, however scattered the indices passed in have become after
+ * divisions and T2 swaps. CalculateForces() gathers the locations and target
+ * areas into this numbering, and scatters the results back, so everything
+ * passed in or out is by the caller's indices. The renumbering changes the
+ * order in which the contributions to each vertex are summed, so the forces
+ * differ by rounding from those without it; see SetRenumbering().
+ *
+ * With SetCalculateStiffness(true), CalculateForces() also sums the 2x2 block
+ * of the energy's Hessian belonging to each vertex by itself, for
+ * SemiImplicitVertexNumericalMethod. Only the positive semi-definite parts are
+ * included: K g g^T for the area gradient g, Gamma p p^T + Gamma P C for the
+ * perimeter gradient p and the curvature C = (I - u u^T)/l of the lengths of
+ * the vertex's two edges, and Lambda C where Lambda is positive.
+ */
+class FarhadifarForceKernel
+{
+private:
+
+    /** Whether to renumber the elements and vertices; see the class documentation. Defaults to false. */
+    bool mRenumber;
+
+    /** The number of vertices passed to SetTopology(). */
+    unsigned mNumNodes;
+
+    /** The element offsets passed to SetTopology(). */
+    std::vector<unsigned> mInputElementOffsets;
+
+    /** The element vertex indices passed to SetTopology(). */
+    std::vector<unsigned> mInputElementNodes;
+
+    /** The index passed to SetTopology() of each element in the kernel's numbering, if renumbering. */
+    std::vector<unsigned> mElementOrder;
+
+    /** The index passed to SetTopology() of each vertex in the kernel's numbering, if renumbering. */
+    std::vector<unsigned> mNodeOrder;
+
+    /** The number of vertices in the kernel's numbering. */
+    unsigned mNumLocalNodes;
+
+    /** The index in mElementNodes of the first vertex of each element, plus one past the end, in the kernel's numbering. */
+    std::vector<unsigned> mElementOffsets;
+
+    /** The vertex indices of all elements, one element after another, in the kernel's numbering. */
+    std::vector<unsigned> mElementNodes;
+
+    /** For each element corner k, whether the edge from corner k to corner k+1 is on the boundary. */
+    std::vector<unsigned char> mIsBoundaryEdge;
+
+    /** The colour of each element. */
+    std::vector<unsigned> mElementColours;
+
+    /** The index in mElementsByColour of the first element of each colour, plus one past the end. */
+    std::vector<unsigned> mColourOffsets;
+
+    /** The elements, sorted by colour and then by index. */
+    std::vector<unsigned> mElementsByColour;
+
+    /** The colour of each element by the caller's index, if renumbering. */
+    std::vector<unsigned> mInputElementColours;
+
+    /** The vertex locations in the kernel's numbering, if renumbering. */
+    std::vector<double> mLocalLocations;
+
+    /** The target areas in the kernel's numbering, if renumbering. */
+    std::vector<double> mLocalTargetAreas;
+
+    /** The forces in the kernel's numbering, if renumbering. */
+    std::vector<double> mLocalForces;
+
+    /** Per-element scratch arrays, padded so that index k+1 is corner k and indices 0 and n+1 wrap around. */
+    struct ElementScratch
+    {
+        /** The x coordinates of the corners. */
+        std::vector<double> mX;
+        /** The y coordinates of the corners. */
+        std::vector<double> mY;
+        /** The x components of the unit vectors from the end of each edge to its start. */
+        std::vector<double> mUnitX;
+        /** The y components of the unit vectors from the end of each edge to its start. */
+        std::vector<double> mUnitY;
+        /** The line tension of each edge. */
+        std::vector<double> mTension;
+        /** The length of each edge. */
+        std::vector<double> mLength;
+    };
+
+    /** The scratch arrays of each thread. */
+    std::vector<ElementScratch> mScratch;
+
+    /** The number of threads to use. */
+    unsigned mNumThreads;
+
+    /** The thread team, created when first needed. */
+    boost::shared_ptr<ThreadTeam> mpThreadTeam;
+
+    /** Whether CalculateForces() also calculates mVertexStiffness. Defaults to false. */
+    bool mCalculateStiffness;
+
+    /** The xx, xy and yy components of each vertex's stiffness, from the last call to CalculateForces(). */
+    std::vector<double> mVertexStiffness;
+
+    /** The area of each element, from the last call to CalculateForces(). */
+    std::vector<double> mElementAreas;
+
+    /** The perimeter of each element, from the last call to CalculateForces(). */
+    std::vector<double> mElementPerimeters;
+
+    /** mVertexStiffness by the caller's indices, if renumbering. */
+    std::vector<double> mInputVertexStiffness;
+
+    /** mElementAreas by the caller's indices, if renumbering. */
+    std::vector<double> mInputElementAreas;
+
+    /** mElementPerimeters by the caller's indices, if renumbering. */
+    std::vector<double> mInputElementPerimeters;
+
+    /** The number of times the derived topology has been rebuilt. */
+    unsigned mNumTopologyUpdates;
+
+    /**
+     * Number the current connectivity in the kernel's own order.
+     */
+    void UpdateNumbering();
+
+    /**
+     * Find the boundary edges of the current connectivity.
+     */
+    void UpdateBoundaryEdges();
+
+    /**
+     * Colour the elements of the current connectivity.
+     */
+    void UpdateColouring();
+
+    /**
+     * Calculate the forces from some of the elements and add them to their vertices.
+     *
+     * @param begin the index in mElementsByColour of the first element
+     * @param end the index in mElementsByColour one past the last element
+     * @param rScratch the scratch arrays to use
+     * @param pLocations the vertex locations
+     * @param pTargetAreas the target areas
+     * @param pEdgeTensions the line tension of internal and boundary edges
+     * @param areaElasticity the area elasticity parameter
+     * @param perimeterContractility the perimeter contractility parameter
+     * @param pForces the forces to add to
+     * @param pStiffness the vertex stiffnesses to add to, or NULL
+     */
+    void ProcessElements(unsigned begin,
+                         unsigned end,
+                         ElementScratch& rScratch,
+                         const double* pLocations,
+                         const double* pTargetAreas,
+                         const double* pEdgeTensions,
+                         double areaElasticity,
+                         double perimeterContractility,
+                         double* pForces,
+                         double* pStiffness);
+
+public:
+
+    /**
+     * Constructor. The mesh is empty.
+     */
+    FarhadifarForceKernel();
+
+    /**
+     * Set the connectivity of the mesh.
+     *
+     * @param rElementOffsets the index in rElementNodes of the first vertex of each element, plus one past the end
+     * @param rElementNodes the vertex indices of all elements, in anticlockwise order within each element
+     * @param numNodes the number of vertices
+     * @return whether the connectivity differed from the previous one
+     */
+    bool SetTopology(const std::vector<unsigned>& rElementOffsets,
+                     const std::vector<unsigned>& rElementNodes,
+                     unsigned numNodes);
+
+    /**
+     * Calculate the force on each vertex.
+     *
+     * @param rNodeLocations the x and y coordinates of each vertex in turn
+     * @param rTargetAreas the target area of each element
+     * @param areaElasticity the area elasticity parameter K
+     * @param perimeterContractility the perimeter contractility parameter Gamma
+     * @param lineTension the line tension parameter Lambda of internal edges
+     * @param boundaryLineTension the line tension parameter of boundary edges
+     * @param rForces filled in with the x and y components of the force on each vertex in turn
+     */
+    void CalculateForces(const std::vector<double>& rNodeLocations,
+                         const std::vector<double>& rTargetAreas,
+                         double areaElasticity,
+                         double perimeterContractility,
+                         double lineTension,
+                         double boundaryLineTension,
+                         std::vector<double>& rForces);
+
+    /**
+     * Set whether CalculateForces() also calculates the stiffness of each vertex;
+     * see the class documentation.
+     *
+     * @param calculateStiffness whether to calculate the stiffnesses
+     */
+    void SetCalculateStiffness(bool calculateStiffness);
+
+    /**
+     * @return the xx, xy and yy components of the stiffness of each vertex in
+     *     turn, from the last call to CalculateForces() with the stiffnesses
+     *     switched on
+     */
+    const std::vector<double>& rGetVertexStiffness() const;
+
+    /**
+     * @return the area of each element, from the last call to CalculateForces()
+     */
+    const std::vector<double>& rGetElementAreas() const;
+
+    /**
+     * @return the perimeter of each element, from the last call to CalculateForces()
+     */
+    const std::vector<double>& rGetElementPerimeters() const;
+
+    /**
+     * Set whether to renumber the elements and vertices; see the class
+     * documentation. Renumbering pays off once the indices of a large tissue
+     * have become scattered, and costs little otherwise, but changes the
+     * forces by rounding, so it is off by default.
+     *
+     * @param renumber whether to renumber
+     */
+    void SetRenumbering(bool renumber);
+
+    /**
+     * @return whether the elements and vertices are renumbered
+     */
+    bool GetRenumbering() const;
+
+    /**
+     * @return the index passed to SetTopology() of each element in the order in
+     *     which the kernel stores them; empty if not renumbering
+     */
+    const std::vector<unsigned>& rGetElementOrder() const;
+
+    /**
+     * @return the number of times the boundary edges and colouring have been
+     *     rebuilt, i.e. the number of topology changes seen by SetTopology()
+     */
+    unsigned GetNumTopologyUpdates() const;
+
+    /**
+     * Set the number of threads used by CalculateForces(). The forces do not
+     * depend on it. Threads only pay off for large tissues.
+     *
+     * @param numThreads the number of threads; 0 means one per hardware thread
+     */
+    void SetNumThreads(unsigned numThreads);
+
+    /**
+     * @return the number of threads used by CalculateForces()
+     */
+    unsigned GetNumThreads() const;
+
+    /**
+     * @return the colour of each element; no two elements of a colour share a vertex
+     */
+    const std::vector<unsigned>& rGetElementColours() const;
+
+    /**
+     * @return the number of colours
+     */
+    unsigned GetNumColours() const;
+};
+
+#endif /*FARHADIFARFORCEKERNEL_HPP_*/
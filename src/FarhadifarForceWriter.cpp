@@ -43,6 +43,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "VertexBasedCellPopulation.hpp"
 #include "ImmersedBoundaryCellPopulation.hpp"
 #include "SimulationTime.hpp"
+#include "VertexMeshNeighbours.hpp"
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics.hpp>
 #include <boost/accumulators/statistics/mean.hpp>
@@ -52,17 +53,20 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 FarhadifarForceWriter<ELEMENT_DIM, SPACE_DIM>::FarhadifarForceWriter()
-    : AbstractCellPopulationCountWriter<ELEMENT_DIM, SPACE_DIM>("FarhadifarForces.dat")
+    : AbstractProjectWriter<AbstractCellPopulationCountWriter<ELEMENT_DIM, SPACE_DIM> >("FarhadifarForces.dat")
 {
+    mTargetAreaHandle = mCellData.RegisterItem("target area");
 }
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void FarhadifarForceWriter<ELEMENT_DIM, SPACE_DIM>::WriteHeader(AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>* pCellPopulation)
 {
+    this->BeginOutputBlock();
+
     if (PetscTools::AmMaster())
     {
 
-        *this->mpOutStream << "Time Areaforce stdAreaForce LineTensionforce stdLineTensionForce Permiterforce stdperimeterforce";
+        this->mEmitter << "Time Areaforce stdAreaForce LineTensionforce stdLineTensionForce Permiterforce stdperimeterforce";
 
         this->WriteNewline();
     }
@@ -108,7 +112,7 @@ void FarhadifarForceWriter<ELEMENT_DIM, SPACE_DIM>::Visit(VertexBasedCellPopulat
 	std::for_each( line_tension_forces.begin(), line_tension_forces.end(), boost::bind<void>(boost::ref(line_tension_accumulator), _1) );
 	std::for_each( perimeter_forces.begin(), perimeter_forces.end(), boost::bind<void>(boost::ref(perimeter_accumulator), _1) );
 
-    *this->mpOutStream <<
+    this->mEmitter <<
             boost::accumulators::mean(area_accumulator) << " " << sqrt( boost::accumulators::variance(area_accumulator) ) << " " <<
             boost::accumulators::mean(line_tension_accumulator) << " " << sqrt( boost::accumulators::variance(line_tension_accumulator) ) << " "<<
             boost::accumulators::mean(perimeter_accumulator) << " " << sqrt( boost::accumulators::variance(perimeter_accumulator) );
@@ -130,32 +134,25 @@ std::map<std::string, std::vector<double> > FarhadifarForceWriter<ELEMENT_DIM, S
     
     if constexpr ((SPACE_DIM == 2) && (ELEMENT_DIM == 2)){
     unsigned num_nodes = pCellPopulation->GetNumNodes();
-    unsigned num_elements = pCellPopulation->GetNumElements();
-
-    // Begin by computing the area and perimeter of each element in the mesh, to avoid having to do this multiple times
-    std::vector<double> element_areas(num_elements);
-    std::vector<double> element_perimeters(num_elements);
-    std::vector<double> target_areas(num_elements);
-    for (typename VertexMesh<2, 2>::VertexElementIterator elem_iter = pCellPopulation->rGetMesh().GetElementIteratorBegin();
-         elem_iter != pCellPopulation->rGetMesh().GetElementIteratorEnd();
-         ++elem_iter)
+
+    // The area and perimeter of each element in the mesh, shared with the other writers at this time step
+    const ElementGeometryKernel& r_geometry = this->rGetElementGeometry(pCellPopulation->rGetMesh());
+    const std::vector<double>& element_areas = r_geometry.rGetAreas();
+    const std::vector<double>& element_perimeters = r_geometry.rGetPerimeters();
+
+    try
     {
-        unsigned elem_index = elem_iter->GetIndex();
-        element_areas[elem_index] = pCellPopulation->rGetMesh().GetVolumeOfElement(elem_index);
-        element_perimeters[elem_index] = pCellPopulation->rGetMesh().GetSurfaceAreaOfElement(elem_index);
-        try
-        {
-            // If we haven't specified a growth modifier, there won't be any target areas in the CellData array and CellData
-            // will throw an exception that it doesn't have "target area" entries.  We add this piece of code to give a more
-            // understandable message. There is a slight chance that the exception is thrown although the error is not about the
-            // target areas.
-            target_areas[elem_index] = pCellPopulation->GetCellUsingLocationIndex(elem_index)->GetCellData()->GetItem("target area");
-        }
-        catch (Exception&)
-        {
-            EXCEPTION("You need to add an AbstractTargetAreaModifier to the simulation in order to use a FarhadifarForceWriter");
-        }
+        // If we haven't specified a growth modifier, there won't be any target areas in the CellData array and CellData
+        // will throw an exception that it doesn't have "target area" entries.  We add this piece of code to give a more
+        // understandable message. There is a slight chance that the exception is thrown although the error is not about the
+        // target areas.
+        mCellData.ReadItem(*pCellPopulation, mTargetAreaHandle);
+    }
+    catch (Exception&)
+    {
+        EXCEPTION("You need to add an AbstractTargetAreaModifier to the simulation in order to use a FarhadifarForceWriter");
     }
+    const std::vector<double>& target_areas = mCellData.rGetValues(mTargetAreaHandle);
 
     std::vector< double > area_forces(num_nodes);
     std::vector< double > line_tension_forces(num_nodes);
@@ -182,10 +179,10 @@ std::map<std::string, std::vector<double> > FarhadifarForceWriter<ELEMENT_DIM, S
         c_vector<double, 2> line_tension_contribution = zero_vector<double>(2);
 
         // Find the indices of the elements owned by this node
-        std::set<unsigned> containing_elem_indices = pCellPopulation->GetNode(node_index)->rGetContainingElementIndices();
+        const std::set<unsigned>& containing_elem_indices = pCellPopulation->GetNode(node_index)->rGetContainingElementIndices();
 
         // Iterate over these elements
-        for (std::set<unsigned>::iterator iter = containing_elem_indices.begin();
+        for (std::set<unsigned>::const_iterator iter = containing_elem_indices.begin();
              iter != containing_elem_indices.end();
              ++iter)
         {
@@ -252,17 +249,9 @@ std::map<std::string, std::vector<double> > FarhadifarForceWriter<ELEMENT_DIM, S
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 double FarhadifarForceWriter<ELEMENT_DIM, SPACE_DIM>::GetLineTensionParameter(Node<SPACE_DIM>* pNodeA, Node<SPACE_DIM>* pNodeB, VertexBasedCellPopulation<SPACE_DIM>& rVertexCellPopulation)
 {
-    // Find the indices of the elements owned by each node
-    std::set<unsigned> elements_containing_nodeA = pNodeA->rGetContainingElementIndices();
-    std::set<unsigned> elements_containing_nodeB = pNodeB->rGetContainingElementIndices();
-
-    // Find common elements
-    std::set<unsigned> shared_elements;
-    std::set_intersection(elements_containing_nodeA.begin(),
-                          elements_containing_nodeA.end(),
-                          elements_containing_nodeB.begin(),
-                          elements_containing_nodeB.end(),
-                          std::inserter(shared_elements, shared_elements.begin()));
+    // Find the elements owned by both nodes
+    SmallIndexSet shared_elements;
+    VertexMeshNeighbours<SPACE_DIM, SPACE_DIM>::GetSharedElementIndices(pNodeA, pNodeB, shared_elements);
 
     // Check that the nodes have a common edge
     assert(!shared_elements.empty());
@@ -37,6 +37,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define FARHADIFARFORCEWRITER_HPP_
 
 #include "AbstractCellPopulationCountWriter.hpp"
+#include "AbstractProjectWriter.hpp"
+#include "CellDataTable.hpp"
 #include "ChasteSerialization.hpp"
 #include <boost/serialization/base_object.hpp>
 #include <map>
@@ -50,7 +52,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * \todo: not hardcode the force parameters
  */
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
-class FarhadifarForceWriter : public AbstractCellPopulationCountWriter<ELEMENT_DIM, SPACE_DIM>
+class FarhadifarForceWriter : public AbstractProjectWriter<AbstractCellPopulationCountWriter<ELEMENT_DIM, SPACE_DIM> >
 {
 private:
     /** Needed for serialization. */
@@ -64,9 +66,15 @@ private:
     template<class Archive>
     void serialize(Archive & archive, const unsigned int version)
     {
-        archive & boost::serialization::base_object<AbstractCellPopulationCountWriter<ELEMENT_DIM, SPACE_DIM> >(*this);
+        archive & boost::serialization::base_object<AbstractProjectWriter<AbstractCellPopulationCountWriter<ELEMENT_DIM, SPACE_DIM> > >(*this);
     }
 
+    /** The cells' target areas, by location index. Not archived. */
+    CellDataTable mCellData;
+
+    /** The handle of "target area" in mCellData. */
+    unsigned mTargetAreaHandle;
+
 public:
 
     /**
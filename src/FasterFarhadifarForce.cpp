@@ -0,0 +1,200 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "FasterFarhadifarForce.hpp"
+#include "VertexBasedCellPopulation.hpp"
+
+template<unsigned DIM>
+FasterFarhadifarForce<DIM>::FasterFarhadifarForce()
+    : FarhadifarForce<DIM>(),
+      mSharedTargetAreaHandle(0u)
+{
+    mTargetAreaHandle = mCellData.RegisterItem("target area");
+}
+
+template<unsigned DIM>
+FasterFarhadifarForce<DIM>::~FasterFarhadifarForce()
+{
+}
+
+template<unsigned DIM>
+void FasterFarhadifarForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>& rCellPopulation)
+{
+    // Throw an exception message if not using a VertexBasedCellPopulation
+    if (dynamic_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation) == nullptr)
+    {
+        EXCEPTION("FasterFarhadifarForce is to be used with a VertexBasedCellPopulation only");
+    }
+    if (DIM != 2)
+    {
+        EXCEPTION("FasterFarhadifarForce is only implemented in 2D");
+    }
+
+    VertexBasedCellPopulation<DIM>* p_cell_population = static_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation);
+    MutableVertexMesh<DIM, DIM>& r_mesh = p_cell_population->rGetMesh();
+    unsigned num_nodes = p_cell_population->GetNumNodes();
+
+    try
+    {
+        if (mpCellDataTable)
+        {
+            // Only reads CellData for cells new to the table
+            mpCellDataTable->UpdateLayout(rCellPopulation);
+        }
+        else
+        {
+            // The growth modifier keeps the target areas in the cells' CellData; the
+            // cells' locations and CellData are only looked up again when cells come or go
+            mCellData.UpdateLayout(rCellPopulation);
+            mCellData.ReadItemFromCells(mTargetAreaHandle);
+        }
+    }
+    catch (Exception&)
+    {
+        // As in FarhadifarForce, give a clearer message if there is no growth modifier
+        EXCEPTION("You need to add an AbstractTargetAreaModifier to the simulation in order to use a FasterFarhadifarForce");
+    }
+    const std::vector<double>& r_target_areas = mpCellDataTable ? mpCellDataTable->rGetValues(mSharedTargetAreaHandle)
+                                                                : mCellData.rGetValues(mTargetAreaHandle);
+
+    // Mirror the connectivity and target areas; the kernel compares the connectivity with the last one
+    mElementOffsets.assign(1, 0u);
+    mElementNodes.clear();
+    mTargetAreas.clear();
+    for (typename VertexMesh<DIM,DIM>::VertexElementIterator elem_iter = r_mesh.GetElementIteratorBegin();
+         elem_iter != r_mesh.GetElementIteratorEnd();
+         ++elem_iter)
+    {
+        unsigned num_nodes_elem = elem_iter->GetNumNodes();
+        for (unsigned local_index=0; local_index<num_nodes_elem; local_index++)
+        {
+            mElementNodes.push_back(elem_iter->GetNodeGlobalIndex(local_index));
+        }
+        mElementOffsets.push_back(mElementNodes.size());
+        mTargetAreas.push_back(r_target_areas[elem_iter->GetIndex()]);
+    }
+    mKernel.SetTopology(mElementOffsets, mElementNodes, num_nodes);
+
+    mNodeLocations.resize(2*num_nodes);
+    for (unsigned node_index=0; node_index<num_nodes; node_index++)
+    {
+        const c_vector<double, DIM>& r_location = p_cell_population->GetNode(node_index)->rGetLocation();
+        mNodeLocations[2*node_index] = r_location[0];
+        mNodeLocations[2*node_index + 1] = r_location[1];
+    }
+
+    mKernel.CalculateForces(mNodeLocations, mTargetAreas,
+                            this->GetAreaElasticityParameter(),
+                            this->GetPerimeterContractilityParameter(),
+                            this->GetLineTensionParameter(),
+                            this->GetBoundaryLineTensionParameter(),
+                            mForces);
+
+    for (unsigned node_index=0; node_index<num_nodes; node_index++)
+    {
+        c_vector<double, DIM> force_on_node = zero_vector<double>(DIM);
+        force_on_node[0] = mForces[2*node_index];
+        force_on_node[1] = mForces[2*node_index + 1];
+        p_cell_population->GetNode(node_index)->AddAppliedForceContribution(force_on_node);
+    }
+}
+
+template<unsigned DIM>
+void FasterFarhadifarForce<DIM>::SetNumThreads(unsigned numThreads)
+{
+    mKernel.SetNumThreads(numThreads);
+}
+
+template<unsigned DIM>
+unsigned FasterFarhadifarForce<DIM>::GetNumThreads() const
+{
+    return mKernel.GetNumThreads();
+}
+
+template<unsigned DIM>
+void FasterFarhadifarForce<DIM>::SetRenumbering(bool renumber)
+{
+    mKernel.SetRenumbering(renumber);
+}
+
+template<unsigned DIM>
+bool FasterFarhadifarForce<DIM>::GetRenumbering() const
+{
+    return mKernel.GetRenumbering();
+}
+
+template<unsigned DIM>
+void FasterFarhadifarForce<DIM>::SetCalculateStiffness(bool calculateStiffness)
+{
+    mKernel.SetCalculateStiffness(calculateStiffness);
+}
+
+template<unsigned DIM>
+const std::vector<double>& FasterFarhadifarForce<DIM>::rGetVertexStiffness() const
+{
+    return mKernel.rGetVertexStiffness();
+}
+
+template<unsigned DIM>
+void FasterFarhadifarForce<DIM>::SetCellDataTable(boost::shared_ptr<CellDataTable> pCellDataTable)
+{
+    if (pCellDataTable)
+    {
+        // Resolved once, and fails here rather than in the time step loop
+        mSharedTargetAreaHandle = pCellDataTable->GetHandle("target area");
+    }
+    mpCellDataTable = pCellDataTable;
+}
+
+template<unsigned DIM>
+boost::shared_ptr<CellDataTable> FasterFarhadifarForce<DIM>::GetCellDataTable() const
+{
+    return mpCellDataTable;
+}
+
+template<unsigned DIM>
+const FarhadifarForceKernel& FasterFarhadifarForce<DIM>::rGetKernel() const
+{
+    return mKernel;
+}
+
+// Explicit instantiation
+template class FasterFarhadifarForce<1>;
+template class FasterFarhadifarForce<2>;
+template class FasterFarhadifarForce<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(FasterFarhadifarForce)
@@ -0,0 +1,199 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef FASTERFARHADIFARFORCE_HPP_
+#define FASTERFARHADIFARFORCE_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+#include <boost/shared_ptr.hpp>
+#include <vector>
+
+#include "FarhadifarForce.hpp"
+#include "FarhadifarForceKernel.hpp"
+#include "CellDataTable.hpp"
+
+/**
+ * A drop-in replacement for FarhadifarForce that gives the same forces (up to
+ * rounding) in a fraction of the time.
+ *
+ * FarhadifarForce::AddForceContribution() visits each vertex, copies the
+ * std::set of its containing elements and, for each of its edges, intersects
+ * two more such sets to decide whether the edge is on the boundary. This class
+ * instead mirrors the vertex locations and element connectivity into flat
+ * arrays at each time step and passes them to a FarhadifarForceKernel, which
+ * finds the boundary edges only when the connectivity has changed and computes
+ * the area, perimeter and line tension terms element by element in contiguous
+ * loops.
+ *
+ * The target areas are read from the cells' CellData at each time step, as
+ * set by e.g. TargetAreaLinearGrowthModifier, unless the force is given the
+ * CellDataTable of a TableTargetAreaModifier, which it then reads directly.
+ *
+ * All parameters are set and archived as for FarhadifarForce.
+ */
+template<unsigned DIM>
+class FasterFarhadifarForce : public FarhadifarForce<DIM>
+{
+private:
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Archive the object. The kernel and mirrored arrays are rebuilt at the next
+     * time step, so are not archived.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<FarhadifarForce<DIM> >(*this);
+    }
+
+    /** The force arithmetic, and the cached topology. */
+    FarhadifarForceKernel mKernel;
+
+    /** The mirrored element offsets; see FarhadifarForceKernel. */
+    std::vector<unsigned> mElementOffsets;
+
+    /** The mirrored element vertex indices; see FarhadifarForceKernel. */
+    std::vector<unsigned> mElementNodes;
+
+    /** The mirrored vertex locations. */
+    std::vector<double> mNodeLocations;
+
+    /** The cells' target areas, by location index, if read from their CellData. */
+    CellDataTable mCellData;
+
+    /** The handle of "target area" in mCellData. */
+    unsigned mTargetAreaHandle;
+
+    /** The table holding the cells' target areas, if any; see SetCellDataTable(). Not archived. */
+    boost::shared_ptr<CellDataTable> mpCellDataTable;
+
+    /** The handle of "target area" in mpCellDataTable. */
+    unsigned mSharedTargetAreaHandle;
+
+    /** The target area of each element. */
+    std::vector<double> mTargetAreas;
+
+    /** The calculated forces. */
+    std::vector<double> mForces;
+
+public:
+
+    /**
+     * Constructor.
+     */
+    FasterFarhadifarForce();
+
+    /**
+     * Destructor.
+     */
+    virtual ~FasterFarhadifarForce();
+
+    /**
+     * Overridden AddForceContribution() method.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void AddForceContribution(AbstractCellPopulation<DIM>& rCellPopulation);
+
+    /**
+     * Set the number of threads used to calculate the forces. The forces do not
+     * depend on the number of threads; see FarhadifarForceKernel. Not archived.
+     *
+     * @param numThreads the number of threads; 0 means one per hardware thread
+     */
+    void SetNumThreads(unsigned numThreads);
+
+    /**
+     * @return the number of threads used to calculate the forces
+     */
+    unsigned GetNumThreads() const;
+
+    /**
+     * Set whether to renumber the mirrored mesh for locality when its topology
+     * changes; see FarhadifarForceKernel. Defaults to false. Not archived.
+     *
+     * @param renumber whether to renumber
+     */
+    void SetRenumbering(bool renumber);
+
+    /**
+     * @return whether the mirrored mesh is renumbered
+     */
+    bool GetRenumbering() const;
+
+    /**
+     * Set whether to also calculate the stiffness of each vertex, for
+     * SemiImplicitVertexNumericalMethod; see FarhadifarForceKernel. Not archived.
+     *
+     * @param calculateStiffness whether to calculate the stiffnesses
+     */
+    void SetCalculateStiffness(bool calculateStiffness);
+
+    /**
+     * @return the xx, xy and yy components of the stiffness of each node in
+     *     turn, by node index, from the last call to AddForceContribution()
+     */
+    const std::vector<double>& rGetVertexStiffness() const;
+
+    /**
+     * Read the target areas from a table, such as that of a
+     * TableTargetAreaModifier, rather than from the cells' CellData. Not archived.
+     *
+     * @param pCellDataTable the table, which must have a "target area" item; or
+     *     an empty pointer to read the cells' CellData again
+     */
+    void SetCellDataTable(boost::shared_ptr<CellDataTable> pCellDataTable);
+
+    /**
+     * @return the table the target areas are read from, if any
+     */
+    boost::shared_ptr<CellDataTable> GetCellDataTable() const;
+
+    /**
+     * @return the kernel, e.g. to see how often the topology has changed
+     */
+    const FarhadifarForceKernel& rGetKernel() const;
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(FasterFarhadifarForce)
+
+#endif /*FASTERFARHADIFARFORCE_HPP_*/
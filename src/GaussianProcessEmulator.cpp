@@ -0,0 +1,782 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "GaussianProcessEmulator.hpp"
+#include "DenseCholesky.hpp"
+#include "Exception.hpp"
+#include "TissueSummaryStatistics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <boost/function.hpp>
+
+namespace
+{
+    /** Added to the diagonal of kernel matrices, relative to the signal variance, for numerical stability. */
+    const double JITTER = 1e-8;
+
+    /** Returned by the fitting objective for hyperparameters out of bounds or an indefinite kernel matrix. */
+    const double INVALID = 1e300;
+
+    /**
+     * The squared-exponential kernel.
+     *
+     * @param rA a scaled input
+     * @param rB another scaled input
+     * @param rInverseLengthScales the inverse length scales
+     * @param signalVariance the signal variance
+     * @return the covariance of the outputs at the two inputs
+     */
+    double Kernel(const std::vector<double>& rA, const std::vector<double>& rB,
+                  const std::vector<double>& rInverseLengthScales, double signalVariance)
+    {
+        double distance_squared = 0.0;
+        for (unsigned i=0; i<rA.size(); i++)
+        {
+            double difference = (rA[i] - rB[i])*rInverseLengthScales[i];
+            distance_squared += difference*difference;
+        }
+        return signalVariance*std::exp(-0.5*distance_squared);
+    }
+
+    /**
+     * @param rX the scaled inputs
+     * @param rY the standardised outputs
+     * @param rParameters the log length scales, log signal variance and log noise variance
+     * @return the negative log marginal likelihood of the exact GP, up to a constant
+     */
+    double NegativeLogMarginalLikelihood(const std::vector<std::vector<double> >& rX,
+                                         const std::vector<double>& rY,
+                                         const std::vector<double>& rParameters)
+    {
+        const unsigned num_inputs = rParameters.size() - 2;
+        for (unsigned i=0; i<num_inputs; i++)
+        {
+            // Length scales between 1% and ten times the range of the training inputs
+            if (rParameters[i] < std::log(0.01) || rParameters[i] > std::log(10.0))
+            {
+                return INVALID;
+            }
+        }
+        double log_signal_variance = rParameters[num_inputs];
+        double log_noise_variance = rParameters[num_inputs + 1];
+        if (std::fabs(log_signal_variance) > std::log(1e3) || log_noise_variance < std::log(1e-8) || log_noise_variance > std::log(10.0))
+        {
+            return INVALID;
+        }
+
+        std::vector<double> inverse_length_scales(num_inputs);
+        for (unsigned i=0; i<num_inputs; i++)
+        {
+            inverse_length_scales[i] = std::exp(-rParameters[i]);
+        }
+        double signal_variance = std::exp(log_signal_variance);
+        double noise_variance = std::exp(log_noise_variance) + JITTER*signal_variance;
+
+        const unsigned n = rX.size();
+        std::vector<double> kernel_matrix(n*n);
+        for (unsigned i=0; i<n; i++)
+        {
+            for (unsigned j=0; j<i; j++)
+            {
+                kernel_matrix[i*n + j] = Kernel(rX[i], rX[j], inverse_length_scales, signal_variance);
+            }
+            kernel_matrix[i*n + i] = signal_variance + noise_variance;
+        }
+        if (!DenseCholesky::Decompose(kernel_matrix, n))
+        {
+            return INVALID;
+        }
+
+        // 0.5 y^T K^-1 y + 0.5 log det K, with K = L L^T
+        std::vector<double> solution = rY;
+        DenseCholesky::ForwardSubstitute(kernel_matrix, n, solution);
+        double result = 0.0;
+        for (unsigned i=0; i<n; i++)
+        {
+            result += 0.5*solution[i]*solution[i] + std::log(kernel_matrix[i*n + i]);
+        }
+        return result;
+    }
+
+    /**
+     * Minimise a function with the Nelder-Mead simplex method.
+     *
+     * @param function the function
+     * @param start the starting point
+     * @param step the size of the initial simplex along each coordinate
+     * @param maxEvaluations the largest number of function evaluations
+     * @return the best point found
+     */
+    std::vector<double> NelderMead(boost::function<double (const std::vector<double>&)> function,
+                                   const std::vector<double>& start, double step, unsigned maxEvaluations)
+    {
+        const unsigned dimension = start.size();
+        std::vector<std::vector<double> > simplex(dimension + 1, start);
+        std::vector<double> values(dimension + 1);
+        for (unsigned i=0; i<dimension; i++)
+        {
+            simplex[i + 1][i] += step;
+        }
+        for (unsigned i=0; i<=dimension; i++)
+        {
+            values[i] = function(simplex[i]);
+        }
+        unsigned num_evaluations = dimension + 1;
+
+        std::vector<unsigned> order(dimension + 1);
+        while (num_evaluations < maxEvaluations)
+        {
+            for (unsigned i=0; i<=dimension; i++)
+            {
+                order[i] = i;
+            }
+            std::sort(order.begin(), order.end(), [&](unsigned a, unsigned b) { return values[a] < values[b]; });
+            unsigned best = order[0];
+            unsigned worst = order[dimension];
+            unsigned second_worst = order[dimension - 1];
+            if (std::fabs(values[worst] - values[best]) < 1e-6*(1.0 + std::fabs(values[best])))
+            {
+                break;
+            }
+
+            // The centroid of all but the worst point, and points along the line from the worst through it
+            std::vector<double> centroid(dimension, 0.0);
+            for (unsigned i=0; i<=dimension; i++)
+            {
+                if (i != worst)
+                {
+                    for (unsigned k=0; k<dimension; k++)
+                    {
+                        centroid[k] += simplex[i][k]/dimension;
+                    }
+                }
+            }
+            auto along = [&](double factor)
+            {
+                std::vector<double> point(dimension);
+                for (unsigned k=0; k<dimension; k++)
+                {
+                    point[k] = centroid[k] + factor*(simplex[worst][k] - centroid[k]);
+                }
+                return point;
+            };
+
+            std::vector<double> reflected = along(-1.0);
+            double reflected_value = function(reflected);
+            num_evaluations++;
+            if (reflected_value < values[best])
+            {
+                std::vector<double> expanded = along(-2.0);
+                double expanded_value = function(expanded);
+                num_evaluations++;
+                if (expanded_value < reflected_value)
+                {
+                    simplex[worst] = expanded;
+                    values[worst] = expanded_value;
+                }
+                else
+                {
+                    simplex[worst] = reflected;
+                    values[worst] = reflected_value;
+                }
+            }
+            else if (reflected_value < values[second_worst])
+            {
+                simplex[worst] = reflected;
+                values[worst] = reflected_value;
+            }
+            else
+            {
+                std::vector<double> contracted = along(reflected_value < values[worst] ? -0.5 : 0.5);
+                double contracted_value = function(contracted);
+                num_evaluations++;
+                if (contracted_value < std::min(reflected_value, values[worst]))
+                {
+                    simplex[worst] = contracted;
+                    values[worst] = contracted_value;
+                }
+                else
+                {
+                    // Shrink the simplex towards the best point
+                    for (unsigned i=0; i<=dimension; i++)
+                    {
+                        if (i != best)
+                        {
+                            for (unsigned k=0; k<dimension; k++)
+                            {
+                                simplex[i][k] = simplex[best][k] + 0.5*(simplex[i][k] - simplex[best][k]);
+                            }
+                            values[i] = function(simplex[i]);
+                            num_evaluations++;
+                        }
+                    }
+                }
+            }
+        }
+
+        unsigned best = std::min_element(values.begin(), values.end()) - values.begin();
+        return simplex[best];
+    }
+
+    /**
+     * Choose points that cover a set of inputs, by greedy farthest-point sampling.
+     *
+     * @param rX the scaled inputs
+     * @param rInverseLengthScales the inverse length scales, used to measure distances
+     * @param maxNumPoints the largest number of points to choose
+     * @return the indices of the chosen inputs; fewer than maxNumPoints if there are fewer distinct inputs
+     */
+    std::vector<unsigned> ChooseFarthestPoints(const std::vector<std::vector<double> >& rX,
+                                               const std::vector<double>& rInverseLengthScales,
+                                               unsigned maxNumPoints)
+    {
+        std::vector<double> distance_to_chosen(rX.size(), std::numeric_limits<double>::infinity());
+        std::vector<unsigned> chosen;
+        unsigned next = 0;
+        while (chosen.size() < maxNumPoints)
+        {
+            const unsigned latest = next;
+            chosen.push_back(latest);
+            double largest_distance = 0.0;
+            for (unsigned j=0; j<rX.size(); j++)
+            {
+                double distance = -2.0*std::log(Kernel(rX[j], rX[latest], rInverseLengthScales, 1.0));
+                distance_to_chosen[j] = std::min(distance_to_chosen[j], distance);
+                if (distance_to_chosen[j] > largest_distance)
+                {
+                    largest_distance = distance_to_chosen[j];
+                    next = j;
+                }
+            }
+            if (largest_distance == 0.0)
+            {
+                break;
+            }
+        }
+        return chosen;
+    }
+}
+
+GaussianProcessEmulator::GaussianProcessEmulator(const std::vector<std::string>& rInputNames,
+                                                 const std::vector<std::string>& rOutputNames)
+    : mInputNames(rInputNames),
+      mOutputNames(rOutputNames),
+      mMaxFitPoints(300u),
+      mMaxExactPoints(1000u),
+      mNumInducingPoints(300u)
+{
+    if (mInputNames.empty())
+    {
+        mInputNames.push_back("Lambda");
+        mInputNames.push_back("Gamma");
+    }
+    if (mOutputNames.empty())
+    {
+        mOutputNames = TissueSummaryStatistics::GetNames();
+    }
+}
+
+void GaussianProcessEmulator::AddTrainingPoint(const std::vector<double>& rInput, const std::vector<double>& rOutput)
+{
+    if (rInput.size() != mInputNames.size() || rOutput.size() != mOutputNames.size())
+    {
+        EXCEPTION("A training point needs " << mInputNames.size() << " inputs and " << mOutputNames.size() << " outputs");
+    }
+    mInputs.push_back(rInput);
+    mOutputs.push_back(rOutput);
+    mModels.clear();
+}
+
+unsigned GaussianProcessEmulator::ReadSweepResults(const std::string& rFilePath)
+{
+    std::ifstream file(rFilePath.c_str());
+    if (!file.is_open())
+    {
+        EXCEPTION("Could not open results file " << rFilePath);
+    }
+
+    std::string line;
+    std::getline(file, line);
+    std::vector<std::string> header;
+    std::istringstream header_stream(line);
+    std::string field;
+    while (std::getline(header_stream, field, ','))
+    {
+        if (!field.empty() && field[field.size()-1] == '\r')
+        {
+            field.erase(field.size()-1);
+        }
+        header.push_back(field);
+    }
+
+    // Find the column of each input and output, and of the Succeeded flag if there is one
+    auto find_column = [&](const std::string& rName, bool required)
+    {
+        std::vector<std::string>::iterator it = std::find(header.begin(), header.end(), rName);
+        if (it == header.end() && required)
+        {
+            EXCEPTION("Results file " << rFilePath << " has no " << rName << " column");
+        }
+        return (int)(it - header.begin());
+    };
+    std::vector<int> input_columns;
+    for (unsigned i=0; i<mInputNames.size(); i++)
+    {
+        input_columns.push_back(find_column(mInputNames[i], true));
+    }
+    std::vector<int> output_columns;
+    for (unsigned i=0; i<mOutputNames.size(); i++)
+    {
+        output_columns.push_back(find_column(mOutputNames[i], true));
+    }
+    int succeeded_column = find_column("Succeeded", false);
+
+    unsigned num_added = 0;
+    while (std::getline(file, line))
+    {
+        if (line.find_first_not_of(" \t\r") == std::string::npos)
+        {
+            continue;
+        }
+
+        // Empty fields (e.g. the statistics of a failed run) are not a number
+        std::vector<double> values;
+        std::istringstream line_stream(line);
+        while (std::getline(line_stream, field, ','))
+        {
+            char* p_end;
+            double value = std::strtod(field.c_str(), &p_end);
+            values.push_back(p_end == field.c_str() ? std::numeric_limits<double>::quiet_NaN() : value);
+        }
+        values.resize(header.size(), std::numeric_limits<double>::quiet_NaN());
+
+        if (succeeded_column < (int)header.size() && values[succeeded_column] == 0.0)
+        {
+            continue;
+        }
+
+        std::vector<double> input;
+        for (unsigned i=0; i<input_columns.size(); i++)
+        {
+            input.push_back(values[input_columns[i]]);
+        }
+        std::vector<double> output;
+        for (unsigned i=0; i<output_columns.size(); i++)
+        {
+            output.push_back(values[output_columns[i]]);
+        }
+        AddTrainingPoint(input, output);
+        num_added++;
+    }
+    return num_added;
+}
+
+std::vector<double> GaussianProcessEmulator::ScaleInput(const std::vector<double>& rInput) const
+{
+    if (rInput.size() != mInputNames.size())
+    {
+        EXCEPTION("Expected " << mInputNames.size() << " inputs, not " << rInput.size());
+    }
+    std::vector<double> scaled(rInput.size());
+    for (unsigned i=0; i<rInput.size(); i++)
+    {
+        scaled[i] = (rInput[i] - mInputMin[i])/mInputRange[i];
+    }
+    return scaled;
+}
+
+void GaussianProcessEmulator::Train()
+{
+    const unsigned num_inputs = mInputNames.size();
+    if (mInputs.empty())
+    {
+        EXCEPTION("The emulator has no training points");
+    }
+
+    mInputMin = mInputs[0];
+    std::vector<double> input_max = mInputs[0];
+    for (unsigned j=1; j<mInputs.size(); j++)
+    {
+        for (unsigned i=0; i<num_inputs; i++)
+        {
+            mInputMin[i] = std::min(mInputMin[i], mInputs[j][i]);
+            input_max[i] = std::max(input_max[i], mInputs[j][i]);
+        }
+    }
+    mInputRange.resize(num_inputs);
+    for (unsigned i=0; i<num_inputs; i++)
+    {
+        // An input that does not vary (e.g. Gamma in a sweep over Lambda only) has no effect
+        mInputRange[i] = (input_max[i] > mInputMin[i]) ? input_max[i] - mInputMin[i] : 1.0;
+    }
+
+    std::vector<OutputModel> models(mOutputNames.size());
+    for (unsigned output=0; output<mOutputNames.size(); output++)
+    {
+        std::vector<std::vector<double> > x;
+        std::vector<double> y;
+        for (unsigned j=0; j<mInputs.size(); j++)
+        {
+            if (std::isfinite(mOutputs[j][output]))
+            {
+                x.push_back(ScaleInput(mInputs[j]));
+                y.push_back(mOutputs[j][output]);
+            }
+        }
+        if (y.size() < 2u)
+        {
+            EXCEPTION("Output " << mOutputNames[output] << " has fewer than two training values");
+        }
+
+        OutputModel& r_model = models[output];
+        double sum = 0.0;
+        double sum_squares = 0.0;
+        for (unsigned j=0; j<y.size(); j++)
+        {
+            sum += y[j];
+            sum_squares += y[j]*y[j];
+        }
+        r_model.mMean = sum/y.size();
+        double variance = (sum_squares - y.size()*r_model.mMean*r_model.mMean)/(y.size() - 1u);
+        r_model.mScale = (variance > 0.0) ? std::sqrt(variance) : 1.0;
+        for (unsigned j=0; j<y.size(); j++)
+        {
+            y[j] = (y[j] - r_model.mMean)/r_model.mScale;
+        }
+
+        TrainOutput(x, y, r_model);
+    }
+    mModels = models;
+}
+
+void GaussianProcessEmulator::TrainOutput(const std::vector<std::vector<double> >& rX, const std::vector<double>& rY, OutputModel& rModel) const
+{
+    const unsigned num_inputs = mInputNames.size();
+    const unsigned n = rX.size();
+
+    // Fit the hyperparameters on an evenly spread subset of the training points
+    std::vector<std::vector<double> > fit_x;
+    std::vector<double> fit_y;
+    unsigned num_fit_points = std::min(n, mMaxFitPoints);
+    for (unsigned i=0; i<num_fit_points; i++)
+    {
+        unsigned j = (unsigned)(((unsigned long long)i*n)/num_fit_points);
+        fit_x.push_back(rX[j]);
+        fit_y.push_back(rY[j]);
+    }
+
+    std::vector<double> start(num_inputs + 2, std::log(0.3));
+    start[num_inputs] = 0.0;
+    start[num_inputs + 1] = std::log(0.1);
+    std::vector<double> parameters = NelderMead(
+            [&](const std::vector<double>& rParameters) { return NegativeLogMarginalLikelihood(fit_x, fit_y, rParameters); },
+            start, 1.0, 60u*(num_inputs + 2));
+
+    rModel.mLogLengthScales.assign(parameters.begin(), parameters.begin() + num_inputs);
+    rModel.mLogSignalVariance = parameters[num_inputs];
+    rModel.mLogNoiseVariance = parameters[num_inputs + 1];
+
+    std::vector<double> inverse_length_scales(num_inputs);
+    for (unsigned i=0; i<num_inputs; i++)
+    {
+        inverse_length_scales[i] = std::exp(-rModel.mLogLengthScales[i]);
+    }
+    double signal_variance = std::exp(rModel.mLogSignalVariance);
+    double noise_variance = std::exp(rModel.mLogNoiseVariance) + JITTER*signal_variance;
+
+    if (n <= mMaxExactPoints)
+    {
+        // Exact GP: weights K^-1 y, with K = L L^T the kernel matrix plus noise
+        rModel.mBasis = rX;
+        rModel.mCholesky.assign(n*n, 0.0);
+        for (unsigned i=0; i<n; i++)
+        {
+            for (unsigned j=0; j<i; j++)
+            {
+                rModel.mCholesky[i*n + j] = Kernel(rX[i], rX[j], inverse_length_scales, signal_variance);
+            }
+            rModel.mCholesky[i*n + i] = signal_variance + noise_variance;
+        }
+        if (!DenseCholesky::Decompose(rModel.mCholesky, n))
+        {
+            EXCEPTION("The kernel matrix of the emulator is not positive definite");
+        }
+        rModel.mWeights = rY;
+        DenseCholesky::ForwardSubstitute(rModel.mCholesky, n, rModel.mWeights);
+        DenseCholesky::BackSubstitute(rModel.mCholesky, n, rModel.mWeights);
+        rModel.mSparseCholesky.clear();
+    }
+    else
+    {
+        // Sparse GP on inducing points Z: with Kmm = Lm Lm^T, V = Lm^-1 Kmn and B = I + V V^T/noise = LB LB^T,
+        // the mean is k*^T Lm^-T B^-1 V y/noise and the variance k** - |Lm^-1 k*|^2 + |LB^-1 Lm^-1 k*|^2
+        std::vector<unsigned> inducing = ChooseFarthestPoints(rX, inverse_length_scales, mNumInducingPoints);
+        const unsigned m = inducing.size();
+        rModel.mBasis.clear();
+        for (unsigned i=0; i<m; i++)
+        {
+            rModel.mBasis.push_back(rX[inducing[i]]);
+        }
+
+        rModel.mCholesky.assign(m*m, 0.0);
+        for (unsigned i=0; i<m; i++)
+        {
+            for (unsigned j=0; j<i; j++)
+            {
+                rModel.mCholesky[i*m + j] = Kernel(rModel.mBasis[i], rModel.mBasis[j], inverse_length_scales, signal_variance);
+            }
+            rModel.mCholesky[i*m + i] = signal_variance*(1.0 + JITTER);
+        }
+        if (!DenseCholesky::Decompose(rModel.mCholesky, m))
+        {
+            EXCEPTION("The kernel matrix of the emulator's inducing points is not positive definite");
+        }
+
+        rModel.mSparseCholesky.assign(m*m, 0.0);
+        for (unsigned i=0; i<m; i++)
+        {
+            rModel.mSparseCholesky[i*m + i] = 1.0;
+        }
+        std::vector<double> weights(m, 0.0);
+        std::vector<double> column(m);
+        for (unsigned j=0; j<n; j++)
+        {
+            for (unsigned i=0; i<m; i++)
+            {
+                column[i] = Kernel(rModel.mBasis[i], rX[j], inverse_length_scales, signal_variance);
+            }
+            DenseCholesky::ForwardSubstitute(rModel.mCholesky, m, column);
+            for (unsigned i=0; i<m; i++)
+            {
+                double scaled = column[i]/noise_variance;
+                for (unsigned k=0; k<=i; k++)
+                {
+                    rModel.mSparseCholesky[i*m + k] += scaled*column[k];
+                }
+                weights[i] += scaled*rY[j];
+            }
+        }
+        if (!DenseCholesky::Decompose(rModel.mSparseCholesky, m))
+        {
+            EXCEPTION("The sparse emulator matrix is not positive definite");
+        }
+        DenseCholesky::ForwardSubstitute(rModel.mSparseCholesky, m, weights);
+        DenseCholesky::BackSubstitute(rModel.mSparseCholesky, m, weights);
+        DenseCholesky::BackSubstitute(rModel.mCholesky, m, weights);
+        rModel.mWeights = weights;
+    }
+}
+
+void GaussianProcessEmulator::Predict(const std::vector<double>& rInput, std::vector<double>& rMean, std::vector<double>& rVariance) const
+{
+    if (mModels.empty())
+    {
+        EXCEPTION("The emulator has not been trained");
+    }
+    std::vector<double> x = ScaleInput(rInput);
+    rMean.resize(mModels.size());
+    rVariance.resize(mModels.size());
+
+    std::vector<double> kernel_vector;
+    for (unsigned output=0; output<mModels.size(); output++)
+    {
+        const OutputModel& r_model = mModels[output];
+        const unsigned num_basis = r_model.mBasis.size();
+
+        std::vector<double> inverse_length_scales(x.size());
+        for (unsigned i=0; i<x.size(); i++)
+        {
+            inverse_length_scales[i] = std::exp(-r_model.mLogLengthScales[i]);
+        }
+        double signal_variance = std::exp(r_model.mLogSignalVariance);
+
+        kernel_vector.resize(num_basis);
+        double mean = 0.0;
+        for (unsigned i=0; i<num_basis; i++)
+        {
+            kernel_vector[i] = Kernel(r_model.mBasis[i], x, inverse_length_scales, signal_variance);
+            mean += r_model.mWeights[i]*kernel_vector[i];
+        }
+
+        DenseCholesky::ForwardSubstitute(r_model.mCholesky, num_basis, kernel_vector);
+        double variance = signal_variance;
+        for (unsigned i=0; i<num_basis; i++)
+        {
+            variance -= kernel_vector[i]*kernel_vector[i];
+        }
+        if (!r_model.mSparseCholesky.empty())
+        {
+            DenseCholesky::ForwardSubstitute(r_model.mSparseCholesky, num_basis, kernel_vector);
+            for (unsigned i=0; i<num_basis; i++)
+            {
+                variance += kernel_vector[i]*kernel_vector[i];
+            }
+        }
+
+        rMean[output] = r_model.mMean + r_model.mScale*mean;
+        rVariance[output] = r_model.mScale*r_model.mScale*std::max(0.0, variance);
+    }
+}
+
+std::vector<double> GaussianProcessEmulator::PredictMean(const std::vector<double>& rInput) const
+{
+    if (mModels.empty())
+    {
+        EXCEPTION("The emulator has not been trained");
+    }
+    std::vector<double> x = ScaleInput(rInput);
+    std::vector<double> means(mModels.size());
+    std::vector<double> inverse_length_scales(x.size());
+    for (unsigned output=0; output<mModels.size(); output++)
+    {
+        const OutputModel& r_model = mModels[output];
+        for (unsigned i=0; i<x.size(); i++)
+        {
+            inverse_length_scales[i] = std::exp(-r_model.mLogLengthScales[i]);
+        }
+        double signal_variance = std::exp(r_model.mLogSignalVariance);
+
+        double mean = 0.0;
+        for (unsigned i=0; i<r_model.mBasis.size(); i++)
+        {
+            mean += r_model.mWeights[i]*Kernel(r_model.mBasis[i], x, inverse_length_scales, signal_variance);
+        }
+        means[output] = r_model.mMean + r_model.mScale*mean;
+    }
+    return means;
+}
+
+double GaussianProcessEmulator::GetUncertainty(const std::vector<double>& rInput) const
+{
+    std::vector<double> mean;
+    std::vector<double> variance;
+    Predict(rInput, mean, variance);
+
+    double uncertainty = 0.0;
+    for (unsigned output=0; output<mModels.size(); output++)
+    {
+        uncertainty += variance[output]/(mModels[output].mScale*mModels[output].mScale);
+    }
+    return uncertainty/mModels.size();
+}
+
+double GaussianProcessEmulator::GetNoiseVariance(unsigned output) const
+{
+    if (output >= mModels.size())
+    {
+        EXCEPTION("The emulator has not been trained, or has no output " << output);
+    }
+    return mModels[output].mScale*mModels[output].mScale*std::exp(mModels[output].mLogNoiseVariance);
+}
+
+std::vector<double> GaussianProcessEmulator::GetLengthScales(unsigned output) const
+{
+    if (output >= mModels.size())
+    {
+        EXCEPTION("The emulator has not been trained, or has no output " << output);
+    }
+    std::vector<double> length_scales(mInputRange.size());
+    for (unsigned i=0; i<length_scales.size(); i++)
+    {
+        length_scales[i] = mInputRange[i]*std::exp(mModels[output].mLogLengthScales[i]);
+    }
+    return length_scales;
+}
+
+bool GaussianProcessEmulator::IsSparse(unsigned output) const
+{
+    if (output >= mModels.size())
+    {
+        EXCEPTION("The emulator has not been trained, or has no output " << output);
+    }
+    return !mModels[output].mSparseCholesky.empty();
+}
+
+const std::vector<std::string>& GaussianProcessEmulator::rGetInputNames() const
+{
+    return mInputNames;
+}
+
+const std::vector<std::string>& GaussianProcessEmulator::rGetOutputNames() const
+{
+    return mOutputNames;
+}
+
+unsigned GaussianProcessEmulator::GetNumTrainingPoints() const
+{
+    return mInputs.size();
+}
+
+void GaussianProcessEmulator::SetMaxFitPoints(unsigned maxFitPoints)
+{
+    if (maxFitPoints < 2u)
+    {
+        EXCEPTION("The hyperparameters must be fitted on at least two points");
+    }
+    mMaxFitPoints = maxFitPoints;
+}
+
+unsigned GaussianProcessEmulator::GetMaxFitPoints() const
+{
+    return mMaxFitPoints;
+}
+
+void GaussianProcessEmulator::SetMaxExactPoints(unsigned maxExactPoints)
+{
+    mMaxExactPoints = maxExactPoints;
+}
+
+unsigned GaussianProcessEmulator::GetMaxExactPoints() const
+{
+    return mMaxExactPoints;
+}
+
+void GaussianProcessEmulator::SetNumInducingPoints(unsigned numInducingPoints)
+{
+    if (numInducingPoints == 0u)
+    {
+        EXCEPTION("The sparse emulator needs at least one inducing point");
+    }
+    mNumInducingPoints = numInducingPoints;
+}
+
+unsigned GaussianProcessEmulator::GetNumInducingPoints() const
+{
+    return mNumInducingPoints;
+}
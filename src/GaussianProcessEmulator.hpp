@@ -0,0 +1,263 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef GAUSSIANPROCESSEMULATOR_HPP_
+#define GAUSSIANPROCESSEMULATOR_HPP_
+
+#include <string>
+#include <vector>
+
+/**
+ * A Gaussian-process emulator of the summary statistics of the tissue
+ * simulation as functions of its parameters (by default Lambda and Gamma),
+ * trained on the results of completed sweeps.
+ *
+ * Each output (statistic) has its own GP with a zero mean (after the output is
+ * standardised), a squared-exponential kernel with one length scale per input
+ * (after the inputs are scaled to [0, 1]) and Gaussian noise, which absorbs the
+ * run-to-run variation between replicates. The hyperparameters are fitted by
+ * maximising the log marginal likelihood with the Nelder-Mead method, on at most
+ * GetMaxFitPoints() training points. With at most GetMaxExactPoints() training
+ * points the exact GP posterior is used, computed by Cholesky decomposition;
+ * with more, the sparse approximation of Titsias (2009) with GetNumInducingPoints()
+ * inducing points, chosen from the training inputs by farthest-point sampling,
+ * so that training costs O(n m^2) rather than O(n^3) and a prediction O(m^2).
+ */
+class GaussianProcessEmulator
+{
+private:
+
+    /** The fitted GP of one output. */
+    struct OutputModel
+    {
+        /** The mean of the output over its training points. */
+        double mMean;
+
+        /** The standard deviation of the output over its training points. */
+        double mScale;
+
+        /** The log of the length scale of each input. */
+        std::vector<double> mLogLengthScales;
+
+        /** The log of the signal variance, in standardised units. */
+        double mLogSignalVariance;
+
+        /** The log of the noise variance, in standardised units. */
+        double mLogNoiseVariance;
+
+        /** The scaled inputs that predictions are expanded on: the training or inducing points. */
+        std::vector<std::vector<double> > mBasis;
+
+        /** The weights of the basis points in the predictive mean. */
+        std::vector<double> mWeights;
+
+        /** The Cholesky factor of the kernel matrix of the basis (plus noise, for the exact GP). */
+        std::vector<double> mCholesky;
+
+        /** For the sparse GP, the Cholesky factor of I + V V^T / noise variance; empty for the exact GP. */
+        std::vector<double> mSparseCholesky;
+    };
+
+    /** The names of the inputs, as CSV column names. */
+    std::vector<std::string> mInputNames;
+
+    /** The names of the outputs, as CSV column names. */
+    std::vector<std::string> mOutputNames;
+
+    /** The inputs of the training points. */
+    std::vector<std::vector<double> > mInputs;
+
+    /** The outputs of the training points; outputs that are not a number are not used. */
+    std::vector<std::vector<double> > mOutputs;
+
+    /** The smallest value of each input over the training points. */
+    std::vector<double> mInputMin;
+
+    /** The range of each input over the training points. */
+    std::vector<double> mInputRange;
+
+    /** The GP of each output, once trained. */
+    std::vector<OutputModel> mModels;
+
+    /** The largest number of points the hyperparameters are fitted on. Defaults to 300. */
+    unsigned mMaxFitPoints;
+
+    /** The largest number of training points for which the exact GP is used. Defaults to 1000. */
+    unsigned mMaxExactPoints;
+
+    /** The number of inducing points of the sparse GP. Defaults to 300. */
+    unsigned mNumInducingPoints;
+
+    /**
+     * @param rInput an input
+     * @return the input scaled to [0, 1] over the training points
+     */
+    std::vector<double> ScaleInput(const std::vector<double>& rInput) const;
+
+    /**
+     * Fit the hyperparameters of one output and set up its posterior.
+     *
+     * @param rX the scaled inputs of the output's training points
+     * @param rY the standardised outputs
+     * @param rModel the model to train
+     */
+    void TrainOutput(const std::vector<std::vector<double> >& rX, const std::vector<double>& rY, OutputModel& rModel) const;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param rInputNames the names of the inputs. Defaults to Lambda and Gamma.
+     * @param rOutputNames the names of the outputs. Defaults to TissueSummaryStatistics::GetNames().
+     */
+    GaussianProcessEmulator(const std::vector<std::string>& rInputNames=std::vector<std::string>(),
+                            const std::vector<std::string>& rOutputNames=std::vector<std::string>());
+
+    /**
+     * Add a training point.
+     *
+     * @param rInput the inputs
+     * @param rOutput the outputs; any that are not a number are left out of that output's GP
+     */
+    void AddTrainingPoint(const std::vector<double>& rInput, const std::vector<double>& rOutput);
+
+    /**
+     * Add the successful runs of a results file, such as the SweepResults.csv
+     * written by SweepFarm::WriteResults(), as training points. The file must have
+     * a header line with a column for each input and output; rows whose Succeeded
+     * column is 0 are skipped.
+     *
+     * @param rFilePath the path of the file
+     * @return the number of training points added
+     */
+    unsigned ReadSweepResults(const std::string& rFilePath);
+
+    /**
+     * Fit the GP of every output to the training points. Must be called after
+     * adding training points and before predicting.
+     */
+    void Train();
+
+    /**
+     * Predict the outputs at an input.
+     *
+     * @param rInput the inputs
+     * @param rMean filled in with the predictive mean of each output
+     * @param rVariance filled in with the predictive variance of the mean of each
+     *     output, i.e. not including the run-to-run noise (see GetNoiseVariance())
+     */
+    void Predict(const std::vector<double>& rInput, std::vector<double>& rMean, std::vector<double>& rVariance) const;
+
+    /**
+     * Predict only the means of the outputs at an input, which is cheaper than Predict().
+     *
+     * @param rInput the inputs
+     * @return the predictive mean of each output
+     */
+    std::vector<double> PredictMean(const std::vector<double>& rInput) const;
+
+    /**
+     * @param rInput the inputs
+     * @return the mean over the outputs of the predictive variance divided by the
+     *     variance of the output's training values: how uncertain the emulator is at
+     *     this input, e.g. for choosing where to simulate next
+     */
+    double GetUncertainty(const std::vector<double>& rInput) const;
+
+    /**
+     * @param output the index of an output
+     * @return the fitted variance of the run-to-run noise of the output
+     */
+    double GetNoiseVariance(unsigned output) const;
+
+    /**
+     * @param output the index of an output
+     * @return the fitted length scale of each input, in the units of the input
+     */
+    std::vector<double> GetLengthScales(unsigned output) const;
+
+    /**
+     * @param output the index of an output
+     * @return whether the output uses the sparse approximation
+     */
+    bool IsSparse(unsigned output) const;
+
+    /**
+     * @return the names of the inputs
+     */
+    const std::vector<std::string>& rGetInputNames() const;
+
+    /**
+     * @return the names of the outputs
+     */
+    const std::vector<std::string>& rGetOutputNames() const;
+
+    /**
+     * @return the number of training points
+     */
+    unsigned GetNumTrainingPoints() const;
+
+    /**
+     * @param maxFitPoints the largest number of points the hyperparameters are fitted on
+     */
+    void SetMaxFitPoints(unsigned maxFitPoints);
+
+    /**
+     * @return the largest number of points the hyperparameters are fitted on
+     */
+    unsigned GetMaxFitPoints() const;
+
+    /**
+     * @param maxExactPoints the largest number of training points for which the exact GP is used
+     */
+    void SetMaxExactPoints(unsigned maxExactPoints);
+
+    /**
+     * @return the largest number of training points for which the exact GP is used
+     */
+    unsigned GetMaxExactPoints() const;
+
+    /**
+     * @param numInducingPoints the number of inducing points of the sparse GP
+     */
+    void SetNumInducingPoints(unsigned numInducingPoints);
+
+    /**
+     * @return the number of inducing points of the sparse GP
+     */
+    unsigned GetNumInducingPoints() const;
+};
+
+#endif /*GAUSSIANPROCESSEMULATOR_HPP_*/
@@ -0,0 +1,127 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "GzipBlockStreamBuffer.hpp"
+#include "Exception.hpp"
+
+#include <cstring>
+
+GzipBlockStreamBuffer::GzipBlockStreamBuffer(std::streambuf* pSink, unsigned blockSize, int compressionLevel)
+    : mpSink(pSink),
+      mBlock(blockSize > 0 ? blockSize : 1u)
+{
+    if (mpSink == nullptr)
+    {
+        EXCEPTION("GzipBlockStreamBuffer needs a stream buffer to write to");
+    }
+
+    std::memset(&mZStream, 0, sizeof(mZStream));
+
+    // A window size of 15+16 asks zlib for a gzip (rather than raw zlib) wrapper
+    if (deflateInit2(&mZStream, compressionLevel, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        EXCEPTION("Could not initialise zlib for compressed output");
+    }
+
+    setp(mBlock.data(), mBlock.data() + mBlock.size());
+}
+
+GzipBlockStreamBuffer::~GzipBlockStreamBuffer()
+{
+    WriteBlock();
+    mpSink->pubsync();
+    deflateEnd(&mZStream);
+}
+
+bool GzipBlockStreamBuffer::WriteBlock()
+{
+    std::size_t num_bytes = pptr() - pbase();
+    if (num_bytes == 0)
+    {
+        return true;
+    }
+
+    if (deflateReset(&mZStream) != Z_OK)
+    {
+        return false;
+    }
+
+    mCompressedBlock.resize(deflateBound(&mZStream, num_bytes));
+
+    mZStream.next_in = reinterpret_cast<Bytef*>(pbase());
+    mZStream.avail_in = num_bytes;
+    mZStream.next_out = mCompressedBlock.data();
+    mZStream.avail_out = mCompressedBlock.size();
+
+    // The output buffer is at least deflateBound() bytes, so a single call finishes the member
+    if (deflate(&mZStream, Z_FINISH) != Z_STREAM_END)
+    {
+        return false;
+    }
+
+    std::streamsize num_compressed_bytes = mCompressedBlock.size() - mZStream.avail_out;
+    if (mpSink->sputn(reinterpret_cast<const char*>(mCompressedBlock.data()), num_compressed_bytes) != num_compressed_bytes)
+    {
+        return false;
+    }
+
+    setp(mBlock.data(), mBlock.data() + mBlock.size());
+    return true;
+}
+
+GzipBlockStreamBuffer::int_type GzipBlockStreamBuffer::overflow(int_type c)
+{
+    if (!WriteBlock())
+    {
+        return traits_type::eof();
+    }
+
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+    {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+        return c;
+    }
+    return traits_type::not_eof(c);
+}
+
+int GzipBlockStreamBuffer::sync()
+{
+    if (!WriteBlock())
+    {
+        return -1;
+    }
+    return mpSink->pubsync();
+}
@@ -0,0 +1,114 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef GZIPBLOCKSTREAMBUFFER_HPP_
+#define GZIPBLOCKSTREAMBUFFER_HPP_
+
+#include <streambuf>
+#include <vector>
+#include <zlib.h>
+
+/**
+ * A stream buffer that gzip-compresses everything written to it before passing
+ * it on to another (sink) stream buffer, typically the std::filebuf of a writer's
+ * output file.
+ *
+ * Data are compressed in blocks. Each block is written to the sink as a complete
+ * gzip member, and a concatenation of gzip members is itself a valid gzip file
+ * (gunzip, zcat and Python's gzip module all read such files transparently). A
+ * block is emitted whenever the internal buffer is full and whenever the buffer
+ * is synced, so an output file that is cut short by a crash stays readable up to
+ * the last completed block.
+ */
+class GzipBlockStreamBuffer : public std::streambuf
+{
+private:
+
+    /** The stream buffer that compressed data are written to. Not owned by this class. */
+    std::streambuf* mpSink;
+
+    /** Buffer holding uncompressed data for the current block. */
+    std::vector<char> mBlock;
+
+    /** Scratch buffer holding the compressed form of a block. */
+    std::vector<unsigned char> mCompressedBlock;
+
+    /** The zlib stream, initialised once and reset for each block. */
+    z_stream mZStream;
+
+    /**
+     * Compress the contents of the block buffer into one gzip member, write
+     * it to the sink and empty the block buffer.
+     *
+     * @return whether the block was written successfully
+     */
+    bool WriteBlock();
+
+protected:
+
+    /**
+     * Overridden overflow() method, called when the block buffer is full.
+     *
+     * @param c the character that did not fit in the block buffer
+     * @return c on success, or EOF on failure
+     */
+    virtual int_type overflow(int_type c);
+
+    /**
+     * Overridden sync() method. Writes any buffered data as a complete gzip member
+     * and syncs the sink.
+     *
+     * @return 0 on success and -1 on failure
+     */
+    virtual int sync();
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param pSink the stream buffer to write compressed data to
+     * @param blockSize the size, in bytes, of uncompressed data per gzip member
+     * @param compressionLevel the zlib compression level (0-9), defaults to Z_DEFAULT_COMPRESSION
+     */
+    GzipBlockStreamBuffer(std::streambuf* pSink, unsigned blockSize, int compressionLevel=Z_DEFAULT_COMPRESSION);
+
+    /**
+     * Destructor. Writes out any data remaining in the block buffer.
+     */
+    virtual ~GzipBlockStreamBuffer();
+};
+
+#endif /*GZIPBLOCKSTREAMBUFFER_HPP_*/
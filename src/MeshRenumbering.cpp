@@ -0,0 +1,248 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "MeshRenumbering.hpp"
+
+#include <algorithm>
+
+namespace
+{
+
+/**
+ * Traverse the connected component of a graph that contains a vertex breadth
+ * first, visiting the new neighbours of each vertex in order of increasing
+ * degree (and then index), as in the Cuthill-McKee algorithm.
+ *
+ * @param rGraphOffsets the index in rGraphNeighbours of the first neighbour of each vertex, plus one past the end
+ * @param rGraphNeighbours the neighbours of each vertex
+ * @param start the vertex to start from
+ * @param rMarks the mark of each vertex; vertices with the given mark count as visited
+ * @param mark the mark to give the vertices of the component
+ * @param rOrder the vertices of the component are appended to this in the order of the traversal
+ * @param rLastLevelBegin set to the index in rOrder of the first vertex of the last level
+ * @return the number of levels
+ */
+unsigned VisitComponent(const std::vector<unsigned>& rGraphOffsets,
+                        const std::vector<unsigned>& rGraphNeighbours,
+                        unsigned start,
+                        std::vector<unsigned>& rMarks,
+                        unsigned mark,
+                        std::vector<unsigned>& rOrder,
+                        unsigned& rLastLevelBegin)
+{
+    auto by_degree = [&rGraphOffsets](unsigned a, unsigned b)
+    {
+        unsigned degree_a = rGraphOffsets[a + 1] - rGraphOffsets[a];
+        unsigned degree_b = rGraphOffsets[b + 1] - rGraphOffsets[b];
+        return degree_a < degree_b || (degree_a == degree_b && a < b);
+    };
+
+    unsigned level_begin = rOrder.size();
+    rOrder.push_back(start);
+    rMarks[start] = mark;
+    unsigned level_end = rOrder.size();
+    unsigned num_levels = 0;
+    while (level_begin < level_end)
+    {
+        rLastLevelBegin = level_begin;
+        num_levels++;
+        for (unsigned i=level_begin; i<level_end; i++)
+        {
+            unsigned vertex = rOrder[i];
+            unsigned first_new = rOrder.size();
+            for (unsigned k=rGraphOffsets[vertex]; k<rGraphOffsets[vertex + 1]; k++)
+            {
+                unsigned neighbour = rGraphNeighbours[k];
+                if (rMarks[neighbour] != mark)
+                {
+                    rMarks[neighbour] = mark;
+                    rOrder.push_back(neighbour);
+                }
+            }
+            std::sort(rOrder.begin() + first_new, rOrder.end(), by_degree);
+        }
+        level_begin = level_end;
+        level_end = rOrder.size();
+    }
+    return num_levels;
+}
+
+} // anonymous namespace
+
+void MeshRenumbering::GetElementGraph(const std::vector<unsigned>& rElementOffsets,
+                                      const std::vector<unsigned>& rElementNodes,
+                                      unsigned numNodes,
+                                      std::vector<unsigned>& rGraphOffsets,
+                                      std::vector<unsigned>& rGraphNeighbours)
+{
+    unsigned num_elements = rElementOffsets.size() - 1;
+
+    // The elements of each vertex, in compressed rows
+    std::vector<unsigned> node_offsets(numNodes + 1, 0u);
+    for (unsigned i=0; i<rElementNodes.size(); i++)
+    {
+        node_offsets[rElementNodes[i] + 1]++;
+    }
+    for (unsigned node=0; node<numNodes; node++)
+    {
+        node_offsets[node + 1] += node_offsets[node];
+    }
+    std::vector<unsigned> node_elements(rElementNodes.size());
+    std::vector<unsigned> next_slot(node_offsets.begin(), node_offsets.end() - 1);
+    for (unsigned element=0; element<num_elements; element++)
+    {
+        for (unsigned corner=rElementOffsets[element]; corner<rElementOffsets[element + 1]; corner++)
+        {
+            node_elements[next_slot[rElementNodes[corner]]++] = element;
+        }
+    }
+
+    // The neighbours of an element are the other elements of its vertices
+    rGraphOffsets.assign(1, 0u);
+    rGraphNeighbours.clear();
+    std::vector<unsigned> last_seen(num_elements, num_elements);
+    for (unsigned element=0; element<num_elements; element++)
+    {
+        last_seen[element] = element;
+        for (unsigned corner=rElementOffsets[element]; corner<rElementOffsets[element + 1]; corner++)
+        {
+            unsigned node = rElementNodes[corner];
+            for (unsigned k=node_offsets[node]; k<node_offsets[node + 1]; k++)
+            {
+                unsigned neighbour = node_elements[k];
+                if (last_seen[neighbour] != element)
+                {
+                    last_seen[neighbour] = element;
+                    rGraphNeighbours.push_back(neighbour);
+                }
+            }
+        }
+        rGraphOffsets.push_back(rGraphNeighbours.size());
+    }
+}
+
+std::vector<unsigned> MeshRenumbering::GetReverseCuthillMcKeeOrder(const std::vector<unsigned>& rGraphOffsets,
+                                                                   const std::vector<unsigned>& rGraphNeighbours)
+{
+    unsigned num_vertices = rGraphOffsets.size() - 1;
+
+    // Components are started from their vertex of lowest degree, so try the vertices in that order
+    std::vector<unsigned> candidates(num_vertices);
+    for (unsigned vertex=0; vertex<num_vertices; vertex++)
+    {
+        candidates[vertex] = vertex;
+    }
+    std::stable_sort(candidates.begin(), candidates.end(), [&rGraphOffsets](unsigned a, unsigned b)
+    {
+        return rGraphOffsets[a + 1] - rGraphOffsets[a] < rGraphOffsets[b + 1] - rGraphOffsets[b];
+    });
+
+    std::vector<unsigned> order;
+    order.reserve(num_vertices);
+    std::vector<unsigned char> is_placed(num_vertices, 0u);
+    std::vector<unsigned> marks(num_vertices, 0u);
+    unsigned mark = 0;
+    std::vector<unsigned> component;
+    for (unsigned i=0; i<num_vertices; i++)
+    {
+        unsigned start = candidates[i];
+        if (is_placed[start])
+        {
+            continue;
+        }
+
+        // Look for a pseudo-peripheral vertex: move to the vertex of lowest degree in the
+        // last level for as long as that increases the number of levels
+        component.clear();
+        unsigned last_level_begin = 0;
+        unsigned num_levels = VisitComponent(rGraphOffsets, rGraphNeighbours, start, marks, ++mark,
+                                             component, last_level_begin);
+        while (true)
+        {
+            unsigned candidate = component[last_level_begin];
+            for (unsigned k=last_level_begin+1; k<component.size(); k++)
+            {
+                unsigned vertex = component[k];
+                if (rGraphOffsets[vertex + 1] - rGraphOffsets[vertex] < rGraphOffsets[candidate + 1] - rGraphOffsets[candidate])
+                {
+                    candidate = vertex;
+                }
+            }
+            component.clear();
+            unsigned candidate_num_levels = VisitComponent(rGraphOffsets, rGraphNeighbours, candidate, marks, ++mark,
+                                                           component, last_level_begin);
+            if (candidate_num_levels <= num_levels)
+            {
+                break;
+            }
+            start = candidate;
+            num_levels = candidate_num_levels;
+        }
+
+        unsigned component_begin = order.size();
+        VisitComponent(rGraphOffsets, rGraphNeighbours, start, marks, ++mark, order, last_level_begin);
+        for (unsigned k=component_begin; k<order.size(); k++)
+        {
+            is_placed[order[k]] = 1u;
+        }
+    }
+
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+std::vector<unsigned> MeshRenumbering::GetNodeOrder(const std::vector<unsigned>& rElementOffsets,
+                                                    const std::vector<unsigned>& rElementNodes,
+                                                    unsigned numNodes,
+                                                    const std::vector<unsigned>& rElementOrder)
+{
+    std::vector<unsigned> order;
+    order.reserve(numNodes);
+    std::vector<unsigned char> is_used(numNodes, 0u);
+    for (unsigned i=0; i<rElementOrder.size(); i++)
+    {
+        unsigned element = rElementOrder[i];
+        for (unsigned corner=rElementOffsets[element]; corner<rElementOffsets[element + 1]; corner++)
+        {
+            unsigned node = rElementNodes[corner];
+            if (!is_used[node])
+            {
+                is_used[node] = 1u;
+                order.push_back(node);
+            }
+        }
+    }
+    return order;
+}
@@ -0,0 +1,103 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef MESHRENUMBERING_HPP_
+#define MESHRENUMBERING_HPP_
+
+#include <vector>
+
+/**
+ * Orderings of the elements and vertices of a mesh that keep neighbouring
+ * elements, and the vertices they share, close together in memory.
+ *
+ * After many divisions and T2 swaps, the vertex and element indices of a
+ * vertex mesh no longer follow the tissue: new vertices are added at the end
+ * and freed indices are reused wherever they happen to be, so the force loops
+ * jump about in memory. FarhadifarForceKernel uses these orderings to number
+ * its own copy of the mesh afresh whenever the topology changes.
+ *
+ * The connectivity is given in compressed rows, as for FarhadifarForceKernel.
+ * An ordering is returned as the old index of each new index in turn.
+ */
+class MeshRenumbering
+{
+public:
+
+    /**
+     * Build the graph in which two elements are neighbours if they share a vertex.
+     *
+     * @param rElementOffsets the index in rElementNodes of the first vertex of each element, plus one past the end
+     * @param rElementNodes the vertex indices of all elements
+     * @param numNodes the number of vertices
+     * @param rGraphOffsets filled in with the index in rGraphNeighbours of the first neighbour of each element,
+     *     plus one past the end
+     * @param rGraphNeighbours filled in with the neighbours of each element
+     */
+    static void GetElementGraph(const std::vector<unsigned>& rElementOffsets,
+                                const std::vector<unsigned>& rElementNodes,
+                                unsigned numNodes,
+                                std::vector<unsigned>& rGraphOffsets,
+                                std::vector<unsigned>& rGraphNeighbours);
+
+    /**
+     * Order the vertices of a graph by the reverse Cuthill-McKee algorithm, which
+     * keeps the indices of neighbours close together. Each connected component is
+     * started from a pseudo-peripheral vertex and traversed breadth first, visiting
+     * the neighbours of each vertex in order of increasing degree.
+     *
+     * @param rGraphOffsets the index in rGraphNeighbours of the first neighbour of each vertex, plus one past the end
+     * @param rGraphNeighbours the neighbours of each vertex
+     * @return the old index of each new index
+     */
+    static std::vector<unsigned> GetReverseCuthillMcKeeOrder(const std::vector<unsigned>& rGraphOffsets,
+                                                             const std::vector<unsigned>& rGraphNeighbours);
+
+    /**
+     * Order the vertices of a mesh by their first use when going through the
+     * elements in a given order. Vertices that belong to no element are left out.
+     *
+     * @param rElementOffsets the index in rElementNodes of the first vertex of each element, plus one past the end
+     * @param rElementNodes the vertex indices of all elements
+     * @param numNodes the number of vertices
+     * @param rElementOrder the old index of each element in the new order
+     * @return the old index of each new vertex index
+     */
+    static std::vector<unsigned> GetNodeOrder(const std::vector<unsigned>& rElementOffsets,
+                                              const std::vector<unsigned>& rElementNodes,
+                                              unsigned numNodes,
+                                              const std::vector<unsigned>& rElementOrder);
+};
+
+#endif /*MESHRENUMBERING_HPP_*/
@@ -0,0 +1,277 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "MultiFidelityScreen.hpp"
+#include "BufferedTextEmitter.hpp"
+#include "Exception.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <tuple>
+
+MultiFidelityScreen::MultiFidelityScreen(const std::vector<SweepTask>& rTasks,
+                                         const TissueSummaryStatistics& rTarget,
+                                         double selectionFraction)
+    : mTasks(rTasks),
+      mTarget(rTarget),
+      mSelectionFraction(selectionFraction)
+{
+    if (!(selectionFraction > 0.0 && selectionFraction <= 1.0))
+    {
+        EXCEPTION("The selection fraction must be in (0, 1]");
+    }
+
+    // Group the runs into parameter sets, in the order in which the sets first appear
+    std::map<std::tuple<unsigned, double, double>, unsigned> set_indices;
+    for (unsigned index=0; index<mTasks.size(); index++)
+    {
+        std::tuple<unsigned, double, double> key(mTasks[index].mSimulation, mTasks[index].mLambda, mTasks[index].mGamma);
+        std::map<std::tuple<unsigned, double, double>, unsigned>::iterator it = set_indices.find(key);
+        if (it == set_indices.end())
+        {
+            it = set_indices.insert(std::make_pair(key, (unsigned)mParameterSets.size())).first;
+            mParameterSets.push_back(std::vector<unsigned>());
+        }
+        mParameterSets[it->second].push_back(index);
+    }
+
+    // The cell counts (the first two statistics) depend on the generations and end time, so are not comparable
+    mWeights.assign(TissueSummaryStatistics::GetNames().size(), 1.0);
+    mWeights[0] = 0.0;
+    mWeights[1] = 0.0;
+}
+
+PaperVertexSimulationParameters MultiFidelityScreen::GetScreeningParameters(const PaperVertexSimulationParameters& rParameters,
+                                                                            unsigned numberGenerations,
+                                                                            double endTime,
+                                                                            double dt)
+{
+    PaperVertexSimulationParameters parameters = rParameters;
+    parameters.mNumberGenerations = numberGenerations;
+    parameters.mEndTime = endTime;
+    parameters.mDt = dt;
+
+    double sampling_multiple = std::round(rParameters.mSamplingTimestepMultiple * rParameters.mDt / dt);
+    parameters.mSamplingTimestepMultiple = (unsigned)std::max(1.0, sampling_multiple);
+    return parameters;
+}
+
+void MultiFidelityScreen::SetStatisticWeights(const std::vector<double>& rWeights)
+{
+    if (rWeights.size() != mWeights.size())
+    {
+        EXCEPTION("Expected " << mWeights.size() << " statistic weights, not " << rWeights.size());
+    }
+    mWeights = rWeights;
+}
+
+unsigned MultiFidelityScreen::GetNumParameterSets() const
+{
+    return mParameterSets.size();
+}
+
+std::vector<SweepTask> MultiFidelityScreen::GetScreeningTasks() const
+{
+    std::vector<SweepTask> tasks;
+    for (unsigned set=0; set<mParameterSets.size(); set++)
+    {
+        tasks.push_back(mTasks[mParameterSets[set][0]]);
+    }
+    return tasks;
+}
+
+void MultiFidelityScreen::SetScreeningResults(const std::vector<TissueSummaryStatistics>& rStatistics,
+                                              const std::vector<bool>& rSucceeded)
+{
+    const unsigned num_sets = mParameterSets.size();
+    if (rStatistics.size() != num_sets || rSucceeded.size() != num_sets)
+    {
+        EXCEPTION("Expected the results of " << num_sets << " screening runs");
+    }
+    mScreeningStatistics = rStatistics;
+    mScreeningSucceeded = rSucceeded;
+
+    // The mean and standard deviation of each statistic over the successful runs
+    const unsigned num_statistics = mWeights.size();
+    std::vector<double> sum(num_statistics, 0.0);
+    std::vector<double> sum_squares(num_statistics, 0.0);
+    std::vector<unsigned> count(num_statistics, 0u);
+    for (unsigned set=0; set<num_sets; set++)
+    {
+        if (rSucceeded[set])
+        {
+            std::vector<double> values = rStatistics[set].ToVector();
+            for (unsigned i=0; i<num_statistics; i++)
+            {
+                if (std::isfinite(values[i]))
+                {
+                    sum[i] += values[i];
+                    sum_squares[i] += values[i]*values[i];
+                    count[i]++;
+                }
+            }
+        }
+    }
+    std::vector<double> scale(num_statistics, 0.0);
+    for (unsigned i=0; i<num_statistics; i++)
+    {
+        if (count[i] > 1u)
+        {
+            double mean = sum[i]/count[i];
+            scale[i] = std::sqrt(std::max(0.0, (sum_squares[i] - count[i]*mean*mean)/(count[i] - 1u)));
+        }
+    }
+
+    std::vector<double> target = mTarget.ToVector();
+    mScores.assign(num_sets, std::numeric_limits<double>::infinity());
+    for (unsigned set=0; set<num_sets; set++)
+    {
+        if (!rSucceeded[set])
+        {
+            continue;
+        }
+        std::vector<double> values = rStatistics[set].ToVector();
+        double weighted_sum = 0.0;
+        double total_weight = 0.0;
+        for (unsigned i=0; i<num_statistics; i++)
+        {
+            if (mWeights[i] > 0.0 && scale[i] > 0.0 && std::isfinite(values[i]) && std::isfinite(target[i]))
+            {
+                double difference = (values[i] - target[i])/scale[i];
+                weighted_sum += mWeights[i]*difference*difference;
+                total_weight += mWeights[i];
+            }
+        }
+
+        // With nothing to compare, a successful run is neither better nor worse than any other
+        mScores[set] = (total_weight > 0.0) ? std::sqrt(weighted_sum/total_weight) : 0.0;
+    }
+
+    // Pass the best-scoring fraction, breaking ties by the order of the sweep
+    std::vector<unsigned> order(num_sets);
+    for (unsigned set=0; set<num_sets; set++)
+    {
+        order[set] = set;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](unsigned a, unsigned b) { return mScores[a] < mScores[b]; });
+
+    unsigned num_selected = std::max(1u, (unsigned)std::ceil(mSelectionFraction*num_sets - 1e-9));
+    mSelected.assign(num_sets, false);
+    for (unsigned rank=0; rank<num_sets && rank<num_selected; rank++)
+    {
+        if (std::isfinite(mScores[order[rank]]))
+        {
+            mSelected[order[rank]] = true;
+        }
+    }
+}
+
+const std::vector<double>& MultiFidelityScreen::rGetScores() const
+{
+    return mScores;
+}
+
+const std::vector<bool>& MultiFidelityScreen::rGetSelected() const
+{
+    return mSelected;
+}
+
+std::vector<SweepTask> MultiFidelityScreen::GetSelectedTasks() const
+{
+    if (mSelected.empty() && !mParameterSets.empty())
+    {
+        EXCEPTION("The screening results have not been set");
+    }
+
+    std::vector<SweepTask> tasks;
+    for (unsigned set=0; set<mParameterSets.size(); set++)
+    {
+        if (mSelected[set])
+        {
+            for (unsigned i=0; i<mParameterSets[set].size(); i++)
+            {
+                tasks.push_back(mTasks[mParameterSets[set][i]]);
+            }
+        }
+    }
+    return tasks;
+}
+
+void MultiFidelityScreen::WriteScreeningResults(const std::string& rFilePath) const
+{
+    if (mSelected.empty() && !mParameterSets.empty())
+    {
+        EXCEPTION("The screening results have not been set");
+    }
+
+    std::ofstream file(rFilePath.c_str());
+    if (!file.is_open())
+    {
+        EXCEPTION("Could not open screening results file " << rFilePath);
+    }
+
+    std::vector<std::string> names = TissueSummaryStatistics::GetNames();
+    BufferedTextEmitter emitter;
+    emitter.SetUseShortestRoundTrip(true);
+    emitter << "Lambda,Gamma,Simulation,Run,Seed,Succeeded,Score,Selected";
+    for (unsigned i=0; i<names.size(); i++)
+    {
+        emitter << ',' << names[i];
+    }
+    emitter << '\n';
+
+    std::vector<SweepTask> tasks = GetScreeningTasks();
+    for (unsigned set=0; set<tasks.size(); set++)
+    {
+        const SweepTask& r_task = tasks[set];
+        emitter << r_task.mLambda << ',' << r_task.mGamma << ',' << r_task.mSimulation << ','
+                << r_task.mRun << ',' << r_task.mSeed << ',' << (bool)mScreeningSucceeded[set] << ','
+                << mScores[set] << ',' << (bool)mSelected[set];
+
+        std::vector<double> values = mScreeningStatistics[set].ToVector();
+        for (unsigned i=0; i<values.size(); i++)
+        {
+            emitter << ',';
+            if (mScreeningSucceeded[set])
+            {
+                emitter << values[i];
+            }
+        }
+        emitter << '\n';
+        emitter.FlushTo(file);
+    }
+}
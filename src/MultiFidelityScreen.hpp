@@ -0,0 +1,178 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef MULTIFIDELITYSCREEN_HPP_
+#define MULTIFIDELITYSCREEN_HPP_
+
+#include <string>
+#include <vector>
+#include "PaperVertexSimulation.hpp"
+#include "SweepTask.hpp"
+#include "TissueSummaryStatistics.hpp"
+
+/**
+ * Two-stage screening of a parameter sweep.
+ *
+ * In the first stage, one run of each parameter set of the sweep (its first
+ * run) is simulated cheaply, with the parameters returned by
+ * GetScreeningParameters(): fewer generations, a shorter end time and a larger
+ * time step. Each screening run is scored by the distance of its summary
+ * statistics from a target (e.g. observed) set of statistics, and only the
+ * best-scoring fraction of the parameter sets goes on to the second stage, in
+ * which all of its runs are simulated with the full parameters.
+ *
+ * The class only does the book-keeping; the runs themselves are done by the
+ * caller, e.g. with a SweepFarm per stage (see TestPaperMultiFidelityScreen).
+ */
+class MultiFidelityScreen
+{
+private:
+
+    /** All the runs of the sweep. */
+    std::vector<SweepTask> mTasks;
+
+    /** For each parameter set, the indices in mTasks of its runs. */
+    std::vector<std::vector<unsigned> > mParameterSets;
+
+    /** The target statistics. */
+    TissueSummaryStatistics mTarget;
+
+    /** The fraction of parameter sets that pass the screen. */
+    double mSelectionFraction;
+
+    /** The weight of each statistic in the score. */
+    std::vector<double> mWeights;
+
+    /** The statistics of the screening run of each parameter set. */
+    std::vector<TissueSummaryStatistics> mScreeningStatistics;
+
+    /** Whether the screening run of each parameter set succeeded. */
+    std::vector<bool> mScreeningSucceeded;
+
+    /** The score of each parameter set; lower is better, infinite for failed runs. */
+    std::vector<double> mScores;
+
+    /** Whether each parameter set passed the screen. */
+    std::vector<bool> mSelected;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param rTasks all the runs of the sweep, e.g. from SweepTask::ReadSweepFile(); runs
+     *     with the same Simulation, Lambda and Gamma form one parameter set
+     * @param rTarget the statistics that the screening runs are scored against
+     * @param selectionFraction the fraction of parameter sets that pass the screen
+     *     (at least one always does). Defaults to 0.2.
+     */
+    MultiFidelityScreen(const std::vector<SweepTask>& rTasks,
+                        const TissueSummaryStatistics& rTarget,
+                        double selectionFraction=0.2);
+
+    /**
+     * Get cheap simulation parameters for the screening stage. The sampling
+     * timestep multiple is scaled so that output is written at the same times.
+     *
+     * @param rParameters the full simulation parameters
+     * @param numberGenerations the number of generations of transit cells. Defaults to 4.
+     * @param endTime the end time. Defaults to 200.
+     * @param dt the time step. Defaults to 0.01.
+     * @return the screening parameters
+     */
+    static PaperVertexSimulationParameters GetScreeningParameters(const PaperVertexSimulationParameters& rParameters,
+                                                                  unsigned numberGenerations=4u,
+                                                                  double endTime=200.0,
+                                                                  double dt=0.01);
+
+    /**
+     * Set the weight of each statistic (in the order of TissueSummaryStatistics::GetNames())
+     * in the score. By default the cell counts, which depend on the number of generations
+     * and the end time, get weight 0 and all other statistics weight 1.
+     *
+     * @param rWeights the weights
+     */
+    void SetStatisticWeights(const std::vector<double>& rWeights);
+
+    /**
+     * @return the number of parameter sets in the sweep
+     */
+    unsigned GetNumParameterSets() const;
+
+    /**
+     * @return the runs of the screening stage: the first run of each parameter set
+     */
+    std::vector<SweepTask> GetScreeningTasks() const;
+
+    /**
+     * Score the screening runs and choose the parameter sets that pass the screen.
+     *
+     * Each statistic is scaled by its standard deviation over the successful
+     * screening runs, and the score of a run is the root mean square of the
+     * weighted, scaled differences from the target. Statistics that are not a
+     * number in the run or the target, or that do not vary between runs, are left
+     * out. Failed runs get an infinite score and never pass.
+     *
+     * @param rStatistics the statistics of each run of GetScreeningTasks()
+     * @param rSucceeded whether each run of GetScreeningTasks() succeeded
+     */
+    void SetScreeningResults(const std::vector<TissueSummaryStatistics>& rStatistics,
+                             const std::vector<bool>& rSucceeded);
+
+    /**
+     * @return the score of each parameter set, in the order of GetScreeningTasks()
+     */
+    const std::vector<double>& rGetScores() const;
+
+    /**
+     * @return whether each parameter set passed the screen, in the order of GetScreeningTasks()
+     */
+    const std::vector<bool>& rGetSelected() const;
+
+    /**
+     * @return the runs of the full stage: all the runs of the parameter sets that passed the screen
+     */
+    std::vector<SweepTask> GetSelectedTasks() const;
+
+    /**
+     * Write the results of the screening stage to a CSV file, with columns Lambda,
+     * Gamma, Simulation, Run, Seed, Succeeded, Score and Selected followed by the
+     * statistics.
+     *
+     * @param rFilePath the path of the file
+     */
+    void WriteScreeningResults(const std::string& rFilePath) const;
+};
+
+#endif /*MULTIFIDELITYSCREEN_HPP_*/
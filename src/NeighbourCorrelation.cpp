@@ -0,0 +1,89 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "NeighbourCorrelation.hpp"
+#include "Exception.hpp"
+
+#include <boost/accumulators/accumulators.hpp>
+#include <boost/accumulators/statistics.hpp>
+#include <boost/accumulators/statistics/mean.hpp>
+#include <boost/accumulators/statistics/variance.hpp>
+
+using namespace boost::accumulators;
+
+void NeighbourCorrelation::GetMeanAndVariance(const std::vector<double>& rValues,
+                                              const std::vector<bool>& rIsInternal,
+                                              double& rMean,
+                                              double& rVariance)
+{
+    if (rIsInternal.size() != rValues.size())
+    {
+        EXCEPTION("Expected " << rValues.size() << " internal cell flags but got " << rIsInternal.size());
+    }
+
+    accumulator_set< double, features<tag::mean, tag::variance> > accumulator;
+    for (unsigned i=0; i<rValues.size(); i++)
+    {
+        if (rIsInternal[i])
+        {
+            accumulator(rValues[i]);
+        }
+    }
+    rMean = mean(accumulator);
+    rVariance = variance(accumulator);
+}
+
+double NeighbourCorrelation::Calculate(const std::vector<double>& rValues,
+                                       const std::vector<bool>& rIsInternal,
+                                       const std::vector<std::pair<unsigned, unsigned> >& rPairs)
+{
+    double mean_value;
+    double value_variance;
+    GetMeanAndVariance(rValues, rIsInternal, mean_value, value_variance);
+    double mean_value_squared = mean_value*mean_value;
+
+    accumulator_set< double, features<tag::mean> > correlations_accumulator;
+    for (unsigned i=0; i<rPairs.size(); i++)
+    {
+        if (rPairs[i].first >= rValues.size() || rPairs[i].second >= rValues.size())
+        {
+            EXCEPTION("Cell pair (" << rPairs[i].first << ", " << rPairs[i].second << ") is out of range");
+        }
+        double first_value = rValues[rPairs[i].first];
+        double second_value = rValues[rPairs[i].second];
+        correlations_accumulator((first_value*second_value - mean_value_squared)/value_variance);
+    }
+    return mean(correlations_accumulator);
+}
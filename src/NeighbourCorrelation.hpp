@@ -0,0 +1,79 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef NEIGHBOURCORRELATION_HPP_
+#define NEIGHBOURCORRELATION_HPP_
+
+#include <utility>
+#include <vector>
+
+/**
+ * The neighbour correlation kernel shared by AreaCorrelationWriter,
+ * PolygonNumberCorrelationWriter, NeighbourNumberCorrelationWriter and
+ * TissueSummaryStatistics, for simulated and observed (ObservedTissueMesh)
+ * tissues alike. The correlation of a per-cell quantity X is
+ * (<X_i*X_j> - <X>^2)/var(X)
+ * where <X> and var(X) are taken over the internal cells and <X_i*X_j> over the
+ * given pairs of neighbouring internal cells.
+ */
+class NeighbourCorrelation
+{
+public:
+
+    /**
+     * @param rValues the quantity, indexed by cell
+     * @param rIsInternal whether each cell is internal (not on the tissue boundary)
+     * @param rMean filled in with the mean of the quantity over the internal cells
+     * @param rVariance filled in with its (population) variance over the internal cells
+     */
+    static void GetMeanAndVariance(const std::vector<double>& rValues,
+                                   const std::vector<bool>& rIsInternal,
+                                   double& rMean,
+                                   double& rVariance);
+
+    /**
+     * Calculate the neighbour correlation of a quantity.
+     *
+     * @param rValues the quantity, indexed by cell
+     * @param rIsInternal whether each cell is internal (not on the tissue boundary)
+     * @param rPairs the pairs of neighbouring internal cells, each pair once
+     * @return the correlation
+     */
+    static double Calculate(const std::vector<double>& rValues,
+                            const std::vector<bool>& rIsInternal,
+                            const std::vector<std::pair<unsigned, unsigned> >& rPairs);
+};
+
+#endif /*NEIGHBOURCORRELATION_HPP_*/
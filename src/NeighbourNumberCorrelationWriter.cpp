@@ -34,6 +34,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "NeighbourNumberCorrelationWriter.hpp"
+#include "NeighbourCorrelation.hpp"
 
 #include "AbstractCellPopulation.hpp"
 #include "MeshBasedCellPopulation.hpp"
@@ -43,6 +44,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "VertexBasedCellPopulation.hpp"
 #include "ImmersedBoundaryCellPopulation.hpp"
 #include "SimulationTime.hpp"
+#include "VertexMeshNeighbours.hpp"
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics.hpp>
 #include <boost/accumulators/statistics/mean.hpp>
@@ -54,17 +56,19 @@ using namespace boost::accumulators;
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 NeighbourNumberCorrelationWriter<ELEMENT_DIM, SPACE_DIM>::NeighbourNumberCorrelationWriter()
-    : AbstractCellPopulationCountWriter<ELEMENT_DIM, SPACE_DIM>("NeighbourNumberCorrelations.dat")
+    : AbstractProjectWriter<AbstractCellPopulationCountWriter<ELEMENT_DIM, SPACE_DIM> >("NeighbourNumberCorrelations.dat")
 {
 }
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void NeighbourNumberCorrelationWriter<ELEMENT_DIM, SPACE_DIM>::WriteHeader(AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>* pCellPopulation)
 {
+    this->BeginOutputBlock();
+
     if (PetscTools::AmMaster())
     {
 
-        *this->mpOutStream << "Time NeighbourNumber_Correlation";
+        this->mEmitter << "Time NeighbourNumber_Correlation";
 
         this->WriteNewline();
     }
@@ -145,10 +149,11 @@ std::vector< c_vector<unsigned,2> > NeighbourNumberCorrelationWriter<ELEMENT_DIM
         {
             unsigned this_element_index = p_this_element->GetIndex();
 
-            std::set<unsigned> indices_of_neighbour_elements =
-                    pCellPopulation->rGetMesh().GetNeighbouringElementIndices(this_element_index);
+            SmallIndexSet indices_of_neighbour_elements;
+            VertexMeshNeighbours<SPACE_DIM, SPACE_DIM>::GetNeighbouringElementIndices(p_this_element,
+                                                                                   indices_of_neighbour_elements);
 
-            for( std::set<unsigned>::iterator this_iter = indices_of_neighbour_elements.begin();
+            for( SmallIndexSet::const_iterator this_iter = indices_of_neighbour_elements.begin();
                     this_iter != indices_of_neighbour_elements.end();
                     this_iter++)
             {
@@ -187,33 +192,40 @@ std::vector< c_vector<unsigned,2> > NeighbourNumberCorrelationWriter<ELEMENT_DIM
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void NeighbourNumberCorrelationWriter<ELEMENT_DIM, SPACE_DIM>::Visit(VertexBasedCellPopulation<SPACE_DIM>* pCellPopulation)
+{
+    this->mEmitter << CalculateNeighbourNumberCorrelation(pCellPopulation);
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double NeighbourNumberCorrelationWriter<ELEMENT_DIM, SPACE_DIM>::CalculateNeighbourNumberCorrelation(VertexBasedCellPopulation<SPACE_DIM>* pCellPopulation)
 {
     if (SPACE_DIM == 2 && ELEMENT_DIM == 2){
     std::vector< c_vector<unsigned,2> > internal_cell_pairs =
             GetAllInternalCellNeighbourIndexPairs(pCellPopulation);
 
-    c_vector<double, 2> internal_neighbour_statistics = GetMeanInternalNeighbourNumberAndVariance(pCellPopulation);
-
-    double mean_internal_neighbour_number_squared = internal_neighbour_statistics[0]*internal_neighbour_statistics[0];
-    double internal_neighbour_number_variance = internal_neighbour_statistics[1];
-
-	accumulator_set< double, features<tag::mean> > correlations_accumulator;
-
-	for( std::vector< c_vector<unsigned,2> >::iterator this_pair = internal_cell_pairs.begin();
-	        this_pair != internal_cell_pairs.end();
-	        this_pair++)
-	{
-	    double first_cell_neighbour_number = pCellPopulation->GetElement((*this_pair)[0])->GetNumNodes();
-	    double second_cell_neighbour_number = pCellPopulation->GetElement((*this_pair)[1])->GetNumNodes();
-
-	    double this_correlation = (first_cell_neighbour_number*second_cell_neighbour_number -
-	            mean_internal_neighbour_number_squared)/
-	            internal_neighbour_number_variance;
+    // Gather the values by element index for the correlation kernel shared with ObservedTissueMesh
+    unsigned num_elements = pCellPopulation->rGetMesh().GetNumAllElements();
+    std::vector<double> values(num_elements, 0.0);
+    std::vector<bool> is_internal(num_elements, false);
+    for (typename AbstractCellPopulation<SPACE_DIM>::Iterator cell_iter = pCellPopulation->Begin();
+         cell_iter != pCellPopulation->End();
+         ++cell_iter)
+    {
+        auto p_element = pCellPopulation->GetElementCorrespondingToCell(*cell_iter);
+        if (!p_element->IsElementOnBoundary())
+        {
+            values[p_element->GetIndex()] = p_element->GetNumNodes();
+            is_internal[p_element->GetIndex()] = true;
+        }
+    }
 
-	    correlations_accumulator(this_correlation);
-	}
+    std::vector<std::pair<unsigned, unsigned> > pairs(internal_cell_pairs.size());
+    for (unsigned i=0; i<internal_cell_pairs.size(); i++)
+    {
+        pairs[i] = std::make_pair(internal_cell_pairs[i][0], internal_cell_pairs[i][1]);
+    }
 
-    *this->mpOutStream << mean(correlations_accumulator);
+    return NeighbourCorrelation::Calculate(values, is_internal, pairs);
     } else {
         EXCEPTION("This writer is supposed to be used with a VertexBasedCellPopulation only of 2 Spatial and Element dimensions.");
     }
@@ -37,6 +37,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define NEIGHBOURNUMBERCORRELATIONWRITER_HPP_
 
 #include "AbstractCellPopulationCountWriter.hpp"
+#include "AbstractProjectWriter.hpp"
 #include "ChasteSerialization.hpp"
 #include <boost/serialization/base_object.hpp>
 #include <map>
@@ -54,7 +55,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * in this formula.
  */
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
-class NeighbourNumberCorrelationWriter : public AbstractCellPopulationCountWriter<ELEMENT_DIM, SPACE_DIM>
+class NeighbourNumberCorrelationWriter : public AbstractProjectWriter<AbstractCellPopulationCountWriter<ELEMENT_DIM, SPACE_DIM> >
 {
 private:
     /** Needed for serialization. */
@@ -68,7 +69,7 @@ private:
     template<class Archive>
     void serialize(Archive & archive, const unsigned int version)
     {
-        archive & boost::serialization::base_object<AbstractCellPopulationCountWriter<ELEMENT_DIM, SPACE_DIM> >(*this);
+        archive & boost::serialization::base_object<AbstractProjectWriter<AbstractCellPopulationCountWriter<ELEMENT_DIM, SPACE_DIM> > >(*this);
     }
 
 public:
@@ -108,12 +109,21 @@ public:
     virtual void Visit(PottsBasedCellPopulation<SPACE_DIM>* pCellPopulation);
 
     /**
-     * Calculate the area correlation for this tissue and write to file
+     * Calculate the neighbour number correlation for this tissue and write to file
      *
      * @param pCellPopulation  The cell population
      */
     virtual void Visit(VertexBasedCellPopulation<SPACE_DIM>* pCellPopulation);
 
+    /**
+     * Calculate the neighbour number correlation for this tissue.
+     *
+     * @param pCellPopulation  The cell population
+     *
+     * @return the neighbour number correlation
+     */
+    double CalculateNeighbourNumberCorrelation(VertexBasedCellPopulation<SPACE_DIM>* pCellPopulation);
+
     /**
      * Visit the population and write the data.
      *
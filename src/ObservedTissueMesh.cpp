@@ -0,0 +1,360 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "ObservedTissueMesh.hpp"
+#include "Exception.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+    /**
+     * @param first a vertex or cell index
+     * @param second another vertex or cell index
+     * @return a key for the unordered pair of indices, which sorts by smaller index first
+     */
+    uint64_t GetPairKey(unsigned first, unsigned second)
+    {
+        return (uint64_t(std::min(first, second)) << 32) | uint64_t(std::max(first, second));
+    }
+
+    /**
+     * Read the next line of a mesh file that is not blank or a comment.
+     *
+     * @param rFile the file
+     * @param rLine filled in with the line
+     * @return whether there was such a line
+     */
+    bool GetDataLine(std::ifstream& rFile, std::string& rLine)
+    {
+        while (std::getline(rFile, rLine))
+        {
+            std::string::size_type first = rLine.find_first_not_of(" \t\r");
+            if (first != std::string::npos && rLine[first] != '#')
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+ObservedTissueMesh::ObservedTissueMesh()
+    : mElementOffsets(1, 0u),
+      mTopologyIsUpToDate(false)
+{
+}
+
+unsigned ObservedTissueMesh::AddNode(double x, double y)
+{
+    mNodeLocations.push_back(x);
+    mNodeLocations.push_back(y);
+    mTopologyIsUpToDate = false;
+    return GetNumNodes() - 1;
+}
+
+unsigned ObservedTissueMesh::AddElement(const std::vector<unsigned>& rNodeIndices)
+{
+    unsigned num_nodes = rNodeIndices.size();
+    if (num_nodes > 1 && rNodeIndices.front() == rNodeIndices.back())
+    {
+        num_nodes--;
+    }
+    if (num_nodes < 3)
+    {
+        EXCEPTION("A cell must have at least three vertices");
+    }
+    for (unsigned i=0; i<num_nodes; i++)
+    {
+        if (rNodeIndices[i] >= GetNumNodes())
+        {
+            EXCEPTION("Cell " << GetNumElements() << " has vertex " << rNodeIndices[i] << " but there are only " << GetNumNodes() << " vertices");
+        }
+    }
+
+    mElementNodes.insert(mElementNodes.end(), rNodeIndices.begin(), rNodeIndices.begin() + num_nodes);
+    mElementOffsets.push_back(mElementNodes.size());
+    mTopologyIsUpToDate = false;
+    return GetNumElements() - 1;
+}
+
+void ObservedTissueMesh::ReadFromFiles(const std::string& rMeshBase)
+{
+    mNodeLocations.clear();
+    mElementOffsets.assign(1, 0u);
+    mElementNodes.clear();
+    mTopologyIsUpToDate = false;
+
+    std::string node_path = rMeshBase + ".node";
+    std::ifstream node_file(node_path.c_str());
+    if (!node_file.is_open())
+    {
+        EXCEPTION("Could not open vertex file " << node_path);
+    }
+
+    std::string line;
+    unsigned num_nodes = 0;
+    unsigned dimension = 0;
+    if (!GetDataLine(node_file, line) || !(std::istringstream(line) >> num_nodes >> dimension) || dimension != 2)
+    {
+        EXCEPTION("The header of " << node_path << " must give the number of vertices and dimension 2");
+    }
+
+    // As in Chaste's mesh readers, the first index says whether indices count from zero or one
+    unsigned first_index = 0;
+    for (unsigned i=0; i<num_nodes; i++)
+    {
+        unsigned index;
+        double x, y;
+        if (!GetDataLine(node_file, line) || !(std::istringstream(line) >> index >> x >> y))
+        {
+            EXCEPTION("Could not read vertex " << i << " from " << node_path);
+        }
+        if (i == 0)
+        {
+            first_index = index;
+        }
+        AddNode(x, y);
+    }
+
+    std::string cell_path = rMeshBase + ".cell";
+    std::ifstream cell_file(cell_path.c_str());
+    if (!cell_file.is_open())
+    {
+        EXCEPTION("Could not open cell file " << cell_path);
+    }
+
+    unsigned num_elements = 0;
+    if (!GetDataLine(cell_file, line) || !(std::istringstream(line) >> num_elements))
+    {
+        EXCEPTION("The header of " << cell_path << " must give the number of cells");
+    }
+
+    std::vector<unsigned> node_indices;
+    for (unsigned i=0; i<num_elements; i++)
+    {
+        if (!GetDataLine(cell_file, line))
+        {
+            EXCEPTION("Could not read cell " << i << " from " << cell_path);
+        }
+        std::istringstream stream(line);
+        unsigned index;
+        unsigned num_element_nodes;
+        if (!(stream >> index >> num_element_nodes))
+        {
+            EXCEPTION("Could not read cell " << i << " from " << cell_path);
+        }
+
+        node_indices.resize(num_element_nodes);
+        for (unsigned j=0; j<num_element_nodes; j++)
+        {
+            if (!(stream >> node_indices[j]) || node_indices[j] < first_index)
+            {
+                EXCEPTION("Could not read the vertices of cell " << i << " from " << cell_path);
+            }
+            node_indices[j] -= first_index;
+        }
+        AddElement(node_indices);
+    }
+}
+
+unsigned ObservedTissueMesh::GetNumNodes() const
+{
+    return mNodeLocations.size()/2;
+}
+
+unsigned ObservedTissueMesh::GetNumElements() const
+{
+    return mElementOffsets.size() - 1;
+}
+
+unsigned ObservedTissueMesh::GetNumNodesInElement(unsigned elementIndex) const
+{
+    return mElementOffsets[elementIndex + 1] - mElementOffsets[elementIndex];
+}
+
+double ObservedTissueMesh::GetAreaOfElement(unsigned elementIndex) const
+{
+    // As in VertexMesh::GetVolumeOfElement(), relative to the first vertex
+    const unsigned* p_nodes = &mElementNodes[mElementOffsets[elementIndex]];
+    unsigned num_nodes = GetNumNodesInElement(elementIndex);
+    double x_0 = mNodeLocations[2*p_nodes[0]];
+    double y_0 = mNodeLocations[2*p_nodes[0] + 1];
+
+    double area = 0.0;
+    for (unsigned i=0; i<num_nodes; i++)
+    {
+        unsigned next = (i + 1)%num_nodes;
+        double x_1 = mNodeLocations[2*p_nodes[i]] - x_0;
+        double y_1 = mNodeLocations[2*p_nodes[i] + 1] - y_0;
+        double x_2 = mNodeLocations[2*p_nodes[next]] - x_0;
+        double y_2 = mNodeLocations[2*p_nodes[next] + 1] - y_0;
+        area += 0.5*(x_1*y_2 - x_2*y_1);
+    }
+    return std::fabs(area);
+}
+
+double ObservedTissueMesh::GetPerimeterOfElement(unsigned elementIndex) const
+{
+    const unsigned* p_nodes = &mElementNodes[mElementOffsets[elementIndex]];
+    unsigned num_nodes = GetNumNodesInElement(elementIndex);
+
+    double perimeter = 0.0;
+    for (unsigned i=0; i<num_nodes; i++)
+    {
+        unsigned next = (i + 1)%num_nodes;
+        double dx = mNodeLocations[2*p_nodes[next]] - mNodeLocations[2*p_nodes[i]];
+        double dy = mNodeLocations[2*p_nodes[next] + 1] - mNodeLocations[2*p_nodes[i] + 1];
+        perimeter += std::sqrt(dx*dx + dy*dy);
+    }
+    return perimeter;
+}
+
+bool ObservedTissueMesh::IsElementOnBoundary(unsigned elementIndex)
+{
+    UpdateTopology();
+    return mIsElementOnBoundary[elementIndex];
+}
+
+const std::vector<std::pair<unsigned, unsigned> >& ObservedTissueMesh::rGetNeighbourPairs()
+{
+    UpdateTopology();
+    return mNeighbourPairs;
+}
+
+void ObservedTissueMesh::UpdateTopology()
+{
+    if (mTopologyIsUpToDate)
+    {
+        return;
+    }
+
+    unsigned num_nodes = GetNumNodes();
+    unsigned num_elements = GetNumElements();
+
+    // An edge that appears in only one cell is on the boundary, and so are its vertices
+    std::vector<uint64_t> edges;
+    edges.reserve(mElementNodes.size());
+    for (unsigned element=0; element<num_elements; element++)
+    {
+        unsigned begin = mElementOffsets[element];
+        unsigned end = mElementOffsets[element + 1];
+        for (unsigned i=begin; i<end; i++)
+        {
+            unsigned next = (i + 1 == end) ? begin : i + 1;
+            edges.push_back(GetPairKey(mElementNodes[i], mElementNodes[next]));
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+
+    std::vector<bool> is_node_on_boundary(num_nodes, false);
+    for (unsigned i=0; i<edges.size(); )
+    {
+        unsigned j = i + 1;
+        while (j < edges.size() && edges[j] == edges[i])
+        {
+            j++;
+        }
+        if (j - i == 1)
+        {
+            is_node_on_boundary[edges[i] >> 32] = true;
+            is_node_on_boundary[edges[i] & 0xFFFFFFFFu] = true;
+        }
+        i = j;
+    }
+
+    mIsElementOnBoundary.assign(num_elements, false);
+    for (unsigned element=0; element<num_elements; element++)
+    {
+        for (unsigned i=mElementOffsets[element]; i<mElementOffsets[element + 1]; i++)
+        {
+            if (is_node_on_boundary[mElementNodes[i]])
+            {
+                mIsElementOnBoundary[element] = true;
+                break;
+            }
+        }
+    }
+
+    // Cells sharing a vertex are neighbours: list the cells containing each vertex...
+    std::vector<unsigned> node_offsets(num_nodes + 1, 0u);
+    for (unsigned i=0; i<mElementNodes.size(); i++)
+    {
+        node_offsets[mElementNodes[i] + 1]++;
+    }
+    for (unsigned node=0; node<num_nodes; node++)
+    {
+        node_offsets[node + 1] += node_offsets[node];
+    }
+    std::vector<unsigned> node_elements(mElementNodes.size());
+    std::vector<unsigned> next_slot(node_offsets.begin(), node_offsets.end() - 1);
+    for (unsigned element=0; element<num_elements; element++)
+    {
+        for (unsigned i=mElementOffsets[element]; i<mElementOffsets[element + 1]; i++)
+        {
+            node_elements[next_slot[mElementNodes[i]]++] = element;
+        }
+    }
+
+    // ...and pair them up
+    std::vector<uint64_t> pairs;
+    for (unsigned node=0; node<num_nodes; node++)
+    {
+        for (unsigned i=node_offsets[node]; i<node_offsets[node + 1]; i++)
+        {
+            for (unsigned j=i + 1; j<node_offsets[node + 1]; j++)
+            {
+                if (node_elements[i] != node_elements[j])
+                {
+                    pairs.push_back(GetPairKey(node_elements[i], node_elements[j]));
+                }
+            }
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+    mNeighbourPairs.resize(pairs.size());
+    for (unsigned i=0; i<pairs.size(); i++)
+    {
+        mNeighbourPairs[i] = std::make_pair(unsigned(pairs[i] >> 32), unsigned(pairs[i] & 0xFFFFFFFFu));
+    }
+
+    mTopologyIsUpToDate = true;
+}
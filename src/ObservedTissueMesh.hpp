@@ -0,0 +1,167 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef OBSERVEDTISSUEMESH_HPP_
+#define OBSERVEDTISSUEMESH_HPP_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * A lightweight two-dimensional vertex mesh for tissues segmented from
+ * microscopy images, so that their summary statistics can be calculated by
+ * TissueSummaryStatistics with the same kernels as for simulated tissues.
+ *
+ * The mesh holds only vertex locations and, for each cell, the indices of its
+ * vertices in order around the cell (in either direction). Neighbouring cells
+ * and cells on the tissue boundary are defined as in Chaste's VertexMesh: two
+ * cells are neighbours if they share a vertex, a vertex is on the boundary if it
+ * lies on an edge that belongs to only one cell, and a cell is on the boundary
+ * if any of its vertices are. These are found in O(N log N) time, so images with
+ * tens of thousands of cells take milliseconds.
+ *
+ * Meshes are built with AddNode() and AddElement(), or read from files in the
+ * format of Chaste's VertexMeshReader (see ReadFromFiles()).
+ */
+class ObservedTissueMesh
+{
+private:
+
+    /** The vertex locations, x and y of each vertex in turn. */
+    std::vector<double> mNodeLocations;
+
+    /** The index in mElementNodes of the first vertex of each cell, plus one past the end. */
+    std::vector<unsigned> mElementOffsets;
+
+    /** The vertex indices of all cells, one cell after another. */
+    std::vector<unsigned> mElementNodes;
+
+    /** Whether each cell is on the tissue boundary; empty until UpdateTopology() is called. */
+    std::vector<bool> mIsElementOnBoundary;
+
+    /** The pairs of neighbouring cells, smaller index first, in increasing order. */
+    std::vector<std::pair<unsigned, unsigned> > mNeighbourPairs;
+
+    /** Whether mIsElementOnBoundary and mNeighbourPairs are up to date. */
+    bool mTopologyIsUpToDate;
+
+    /**
+     * Find the boundary cells and the neighbouring pairs of cells.
+     */
+    void UpdateTopology();
+
+public:
+
+    /**
+     * Constructor. The mesh is empty.
+     */
+    ObservedTissueMesh();
+
+    /**
+     * Add a vertex.
+     *
+     * @param x the x coordinate
+     * @param y the y coordinate
+     * @return the index of the vertex
+     */
+    unsigned AddNode(double x, double y);
+
+    /**
+     * Add a cell. If the last vertex repeats the first, as in closed polygons
+     * exported by some segmentation tools, it is dropped.
+     *
+     * @param rNodeIndices the indices of the cell's vertices, in order around the cell
+     * @return the index of the cell
+     */
+    unsigned AddElement(const std::vector<unsigned>& rNodeIndices);
+
+    /**
+     * Read a mesh from the files rMeshBase.node and rMeshBase.cell, as written by
+     * Chaste's VertexMeshWriter. The .node file has a header line
+     * "<number of vertices> 2 <number of attributes> <boundary marker flag>" and
+     * then a line "<index> <x> <y> [attributes] [boundary marker]" for each vertex;
+     * the .cell file has a header line "<number of cells> <number of attributes>"
+     * and then a line "<index> <number of vertices> <vertex indices> [attributes]"
+     * for each cell. Indices count from zero, lines starting with '#' are ignored,
+     * and boundary markers and attributes are not used. Any existing contents of
+     * the mesh are replaced.
+     *
+     * @param rMeshBase the path of the files without their extensions
+     */
+    void ReadFromFiles(const std::string& rMeshBase);
+
+    /**
+     * @return the number of vertices
+     */
+    unsigned GetNumNodes() const;
+
+    /**
+     * @return the number of cells
+     */
+    unsigned GetNumElements() const;
+
+    /**
+     * @param elementIndex the index of a cell
+     * @return the number of vertices (and so edges) of the cell
+     */
+    unsigned GetNumNodesInElement(unsigned elementIndex) const;
+
+    /**
+     * @param elementIndex the index of a cell
+     * @return the area of the cell
+     */
+    double GetAreaOfElement(unsigned elementIndex) const;
+
+    /**
+     * @param elementIndex the index of a cell
+     * @return the perimeter of the cell
+     */
+    double GetPerimeterOfElement(unsigned elementIndex) const;
+
+    /**
+     * @param elementIndex the index of a cell
+     * @return whether the cell is on the tissue boundary
+     */
+    bool IsElementOnBoundary(unsigned elementIndex);
+
+    /**
+     * @return the pairs of neighbouring cells (sharing at least one vertex), each
+     *     pair once with the smaller index first, in increasing order
+     */
+    const std::vector<std::pair<unsigned, unsigned> >& rGetNeighbourPairs();
+};
+
+#endif /*OBSERVEDTISSUEMESH_HPP_*/
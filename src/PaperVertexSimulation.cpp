@@ -0,0 +1,504 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "PaperVertexSimulation.hpp"
+#include "SimulationContext.hpp"
+
+#include <ctime>
+#include <sstream>
+#include "BudgetedOffLatticeSimulation.hpp"
+#include "CellBasedSimulationArchiver.hpp"
+#include "TargetAreaLinearGrowthModifier.hpp"
+#include "TableTargetAreaModifier.hpp"
+#include "SpatialHashIntersectionModifier.hpp"
+#include "DivergenceDetectionModifier.hpp"
+#include "SimulationFailureRecord.hpp"
+#include "RunTruncationMarker.hpp"
+#include "FarhadifarForce.hpp"
+#include "FasterFarhadifarForce.hpp"
+#include "FixedSequenceCellCycleModel.hpp"
+#include "TransitCellProliferativeType.hpp"
+#include "WildTypeCellMutationState.hpp"
+#include "SmartPointers.hpp"
+#include "ForwardEulerNumericalMethod.hpp"
+#include "EmbeddedRungeKuttaNumericalMethod.hpp"
+#include "SemiImplicitVertexNumericalMethod.hpp"
+#include "OutputFileHandler.hpp"
+#include "CellCycleTimesGenerator.hpp"
+#include "ModifiedVertexBasedCellPopulation.hpp"
+#include "ExtendedHoneycombVertexMeshGenerator.hpp"
+#include "FasterMutableVertexMesh.hpp"
+
+#include "VertexModelDataWriter.hpp"
+#include "CellProliferativePhasesWriter.hpp"
+#include "CellAgesWriter.hpp"
+#include "CellEdgeCountWriter.hpp"
+#include "CellPerimeterWriter.hpp"
+#include "FarhadifarForceWriter.hpp"
+#include "PolygonNumberCorrelationWriter.hpp"
+#include "AreaCorrelationWriter.hpp"
+#include "NeighbourNumberCorrelationWriter.hpp"
+#include "VertexEdgeLengthWriter.hpp"
+#include "ResultsStoreWriter.hpp"
+#include "ElementGeometryCache.hpp"
+
+namespace
+{
+    /**
+     * Helper to create one of the project writers.
+     *
+     * @param compressOutput whether the writer should gzip-compress its output file
+     * @param pResultsStore the store to write to instead of the output file, if any
+     * @param pElementGeometryCache the element geometry cache shared by the writers
+     * @return the writer
+     */
+    template<class WRITER>
+    boost::shared_ptr<WRITER> MakeProjectWriter(bool compressOutput, boost::shared_ptr<SweepResultsStore> pResultsStore,
+                                                boost::shared_ptr<ElementGeometryCache> pElementGeometryCache)
+    {
+        boost::shared_ptr<WRITER> p_writer(new WRITER());
+        p_writer->SetCompressOutput(compressOutput);
+        p_writer->SetResultsStore(pResultsStore);
+        p_writer->SetElementGeometryCache(pElementGeometryCache);
+        return p_writer;
+    }
+
+    /**
+     * Helper to create one of the Chaste writers, writing to a results store.
+     *
+     * @param pResultsStore the store
+     * @return the writer
+     */
+    template<class WRITER>
+    boost::shared_ptr<ResultsStoreWriter<WRITER> > MakeStoredWriter(boost::shared_ptr<SweepResultsStore> pResultsStore)
+    {
+        boost::shared_ptr<ResultsStoreWriter<WRITER> > p_writer(new ResultsStoreWriter<WRITER>());
+        p_writer->SetResultsStore(pResultsStore);
+        return p_writer;
+    }
+}
+
+PaperVertexSimulationParameters::PaperVertexSimulationParameters()
+    : mLineTensionParameter(0.12),
+      mPerimeterContractilityParameter(0.04),
+      mNumberGenerations(7u),
+      mAverageCellCycleTime(20.0),
+      mNewEdgeLengthFactor(1.5),
+      mRestrictVertexMovement(true),
+      mRandomiseT1SwapOrder(false),
+      mT1SwapThreshold(0.01),
+      mT2SwapThreshold(0.001),
+      mInitialSize(2u),
+      mDt(0.005),
+      mEndTime(700.0),
+      mSamplingTimestepMultiple(200u),
+      mCompressOutput(false),
+      mUseFasterForce(false),
+      mNumForceThreads(1u),
+      mRenumberMesh(false),
+      mNumericalMethod("ForwardEuler"),
+      mIntegratorTolerance(1e-4),
+      mUseSpatialHash(false),
+      mUseCellDataTable(false),
+      mDetectDivergence(false),
+      mWallTimeBudget(0.0),
+      mTimeStepBudget(0u)
+{
+}
+
+PaperVertexSimulation::PaperVertexSimulation(const PaperVertexSimulationParameters& rParameters, const std::string& rOutputDirectory)
+    : mParameters(rParameters),
+      mOutputDirectory(rOutputDirectory),
+      mResumeFromCheckpoint(false),
+      mWasTruncated(false)
+{
+}
+
+void PaperVertexSimulation::SetResultsStore(boost::shared_ptr<SweepResultsStore> pResultsStore)
+{
+    mpResultsStore = pResultsStore;
+}
+
+void PaperVertexSimulation::SetResumeFromCheckpoint(bool resumeFromCheckpoint)
+{
+    mResumeFromCheckpoint = resumeFromCheckpoint;
+}
+
+const PaperVertexSimulationParameters& PaperVertexSimulation::rGetParameters() const
+{
+    return mParameters;
+}
+
+bool PaperVertexSimulation::WasTruncated() const
+{
+    return mWasTruncated;
+}
+
+TissueSummaryStatistics PaperVertexSimulation::Run(unsigned randomSeed)
+{
+    if (randomSeed == 0u)
+    {
+        randomSeed = time(NULL);
+    }
+    SimulationContext context(randomSeed);
+
+    const PaperVertexSimulationParameters& r_params = mParameters;
+    mWasTruncated = false;
+    if (r_params.mUseCellDataTable && !r_params.mUseFasterForce)
+    {
+        EXCEPTION("The cell data table needs FasterFarhadifarForce, since FarhadifarForce reads the target areas from the cells");
+    }
+    if (r_params.mNumericalMethod == "SemiImplicit" && !r_params.mUseFasterForce)
+    {
+        EXCEPTION("The SemiImplicit integrator needs FasterFarhadifarForce, since only it calculates the vertex stiffness");
+    }
+
+    // The context has seeded the generator already
+    CellCycleTimesGenerator* p_cell_cycle_times_generator = CellCycleTimesGenerator::Instance();
+    p_cell_cycle_times_generator->SetRate(3.0/(2.0*r_params.mAverageCellCycleTime));
+    p_cell_cycle_times_generator->GenerateCellCycleTimeSequence();
+
+    // A failure record left by an earlier attempt at this run no longer applies
+    std::string output_directory = OutputFileHandler(mOutputDirectory, false).GetOutputDirectoryFullPath();
+    SimulationFailureRecord::Remove(output_directory);
+
+    if (mResumeFromCheckpoint && RunTruncationMarker::Exists(output_directory))
+    {
+        // The tissue, forces, modifiers, writers and numerical method all come from the checkpoint
+        double checkpoint_time = RunTruncationMarker::Read(output_directory).mTime;
+        boost::shared_ptr<BudgetedOffLatticeSimulation<2> > p_simulator(
+            CellBasedSimulationArchiver<2, BudgetedOffLatticeSimulation<2> >::Load(mOutputDirectory, checkpoint_time));
+        p_simulator->SetEndTime(r_params.mEndTime);
+        if (mpResultsStore)
+        {
+            // Keep the output that the truncated attempt put in the store
+            mpResultsStore->SetReplaceExistingRun(false);
+        }
+
+        // The force's threads, renumbering and cell data table are not archived
+        boost::shared_ptr<TableTargetAreaModifier<2> > p_table_modifier;
+        std::vector<boost::shared_ptr<AbstractCellBasedSimulationModifier<2> > >& r_modifiers = *(p_simulator->GetSimulationModifiers());
+        for (unsigned i=0; i<r_modifiers.size() && !p_table_modifier; i++)
+        {
+            p_table_modifier = boost::dynamic_pointer_cast<TableTargetAreaModifier<2> >(r_modifiers[i]);
+        }
+        const std::vector<boost::shared_ptr<AbstractForce<2> > >& r_forces = p_simulator->rGetForceCollection();
+        for (unsigned i=0; i<r_forces.size(); i++)
+        {
+            boost::shared_ptr<FasterFarhadifarForce<2> > p_faster_force = boost::dynamic_pointer_cast<FasterFarhadifarForce<2> >(r_forces[i]);
+            if (p_faster_force)
+            {
+                p_faster_force->SetNumThreads(r_params.mNumForceThreads);
+                p_faster_force->SetRenumbering(r_params.mRenumberMesh);
+                if (p_table_modifier)
+                {
+                    p_faster_force->SetCellDataTable(p_table_modifier->GetCellDataTable());
+                }
+            }
+        }
+        return Solve(*p_simulator, output_directory);
+    }
+    RunTruncationMarker::Remove(output_directory);
+
+    // First we create a regular vertex mesh
+    ExtendedHoneycombVertexMeshGenerator generator(r_params.mInitialSize, r_params.mInitialSize, false,
+                                                   r_params.mT1SwapThreshold, r_params.mT2SwapThreshold, 1.0);
+    FasterMutableVertexMesh<2, 2>* p_mesh = generator.GetMesh();
+    p_mesh->SetRandomizeT1SwapOrderBoolean(r_params.mRandomiseT1SwapOrder);
+    p_mesh->SetCellRearrangementRatio(r_params.mNewEdgeLengthFactor);
+    p_mesh->SetCheckForInternalIntersections(false);
+    p_mesh->SetCheckForT3Swaps(true);
+
+    std::vector<CellPtr> cells;
+    MAKE_PTR(WildTypeCellMutationState, p_state);
+    MAKE_PTR(TransitCellProliferativeType, p_diff_type);
+
+    for (unsigned elem_index=0; elem_index < p_mesh->GetNumElements(); elem_index++)
+    {
+        FixedSequenceCellCycleModel* p_cc_model = new FixedSequenceCellCycleModel();
+        p_cc_model->SetDimension(2);
+        p_cc_model->SetG2Duration((1.0/3.0)*r_params.mAverageCellCycleTime);
+        p_cc_model->SetMDuration(1e-12);
+        p_cc_model->SetSDuration(1e-12);
+        p_cc_model->SetMaxTransitGenerations(r_params.mNumberGenerations);
+
+        CellPtr p_cell(new Cell(p_state, p_cc_model));
+        p_cell->SetCellProliferativeType(p_diff_type);
+        p_cell->SetBirthTime(0.0);
+        cells.push_back(p_cell);
+    }
+
+    ModifiedVertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+    cell_population.SetRestrictVertexMovementBoolean(r_params.mRestrictVertexMovement);
+
+    bool compress_output = r_params.mCompressOutput;
+
+    // The writers calculate the geometry of the cells once per output time step between them
+    boost::shared_ptr<ElementGeometryCache> p_geometry_cache(new ElementGeometryCache());
+
+    // Cell writers
+    cell_population.AddCellWriter(MakeProjectWriter<VertexModelDataWriter<2,2> >(compress_output, mpResultsStore, p_geometry_cache));
+    if (mpResultsStore)
+    {
+        cell_population.AddCellWriter(MakeStoredWriter<CellProliferativePhasesWriter<2,2> >(mpResultsStore));
+        cell_population.AddCellWriter(MakeStoredWriter<CellAgesWriter<2,2> >(mpResultsStore));
+    }
+    else
+    {
+        cell_population.AddCellWriter<CellProliferativePhasesWriter>();
+        cell_population.AddCellWriter<CellAgesWriter>();
+    }
+    cell_population.AddCellWriter(MakeProjectWriter<CellEdgeCountWriter<2,2> >(compress_output, mpResultsStore, p_geometry_cache));
+    cell_population.AddCellWriter(MakeProjectWriter<CellPerimeterWriter<2,2> >(compress_output, mpResultsStore, p_geometry_cache));
+
+    // Cell population writers
+    cell_population.AddCellPopulationCountWriter(MakeProjectWriter<FarhadifarForceWriter<2,2> >(compress_output, mpResultsStore, p_geometry_cache));
+    cell_population.AddCellPopulationCountWriter(MakeProjectWriter<AreaCorrelationWriter<2,2> >(compress_output, mpResultsStore, p_geometry_cache));
+    cell_population.AddCellPopulationCountWriter(MakeProjectWriter<PolygonNumberCorrelationWriter<2,2> >(compress_output, mpResultsStore, p_geometry_cache));
+    cell_population.AddCellPopulationCountWriter(MakeProjectWriter<NeighbourNumberCorrelationWriter<2,2> >(compress_output, mpResultsStore, p_geometry_cache));
+    cell_population.AddPopulationWriter(MakeProjectWriter<VertexEdgeLengthWriter<2,2> >(compress_output, mpResultsStore, p_geometry_cache));
+
+    if (mpResultsStore)
+    {
+        // The population would add these itself, writing to files
+        cell_population.SetOutputResultsForChasteVisualizer(false);
+        cell_population.SetOutputCellRearrangementLocations(false);
+        cell_population.AddCellWriter(MakeStoredWriter<CellProliferativeTypesWriter<2,2> >(mpResultsStore));
+        cell_population.AddPopulationWriter(MakeStoredWriter<NodeLocationWriter<2,2> >(mpResultsStore));
+        cell_population.AddPopulationWriter(MakeStoredWriter<BoundaryNodeWriter<2,2> >(mpResultsStore));
+        cell_population.AddPopulationWriter(MakeStoredWriter<CellPopulationElementWriter<2,2> >(mpResultsStore));
+        cell_population.AddPopulationWriter(MakeStoredWriter<VertexT1SwapLocationsWriter<2,2> >(mpResultsStore));
+        cell_population.AddPopulationWriter(MakeStoredWriter<VertexT2SwapLocationsWriter<2,2> >(mpResultsStore));
+        cell_population.AddPopulationWriter(MakeStoredWriter<VertexT3SwapLocationsWriter<2,2> >(mpResultsStore));
+        cell_population.AddPopulationWriter(MakeStoredWriter<VertexIntersectionSwapLocationsWriter<2,2> >(mpResultsStore));
+    }
+
+    cell_population.SetWriteCellVtkResults(false);
+    cell_population.SetWriteEdgeVtkResults(false);
+
+    for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+         cell_iter != cell_population.End();
+         ++cell_iter)
+    {
+        cell_iter->GetCellData()->SetItem("target area", 1.0);
+    }
+
+    BudgetedOffLatticeSimulation<2> simulator(cell_population);
+    simulator.SetOutputDirectory(mOutputDirectory);
+    simulator.SetSamplingTimestepMultiple(r_params.mSamplingTimestepMultiple);
+    simulator.SetDt(r_params.mDt);
+    simulator.SetEndTime(r_params.mEndTime);
+
+    boost::shared_ptr<FarhadifarForce<2> > p_force;
+    boost::shared_ptr<FasterFarhadifarForce<2> > p_faster_force;
+    if (r_params.mUseFasterForce)
+    {
+        p_faster_force.reset(new FasterFarhadifarForce<2>());
+        p_faster_force->SetNumThreads(r_params.mNumForceThreads);
+        p_faster_force->SetRenumbering(r_params.mRenumberMesh);
+        p_force = p_faster_force;
+    }
+    else
+    {
+        p_force.reset(new FarhadifarForce<2>());
+    }
+    p_force->SetPerimeterContractilityParameter(r_params.mPerimeterContractilityParameter);
+    p_force->SetLineTensionParameter(r_params.mLineTensionParameter);
+
+    // If the line tension parameter is negative in the bulk we set it to zero at the
+    // boundary, to prevent non-physical behaviour
+    if (r_params.mLineTensionParameter < 0)
+    {
+        p_force->SetBoundaryLineTensionParameter(0.0);
+    }
+    else
+    {
+        p_force->SetBoundaryLineTensionParameter(r_params.mLineTensionParameter);
+    }
+    simulator.AddForce(p_force);
+
+    if (r_params.mUseCellDataTable)
+    {
+        // The force reads the target areas from the modifier's table
+        MAKE_PTR(TableTargetAreaModifier<2>, p_growth_modifier);
+        p_growth_modifier->SetSamplingTimestepMultiple(r_params.mSamplingTimestepMultiple);
+        p_faster_force->SetCellDataTable(p_growth_modifier->GetCellDataTable());
+        simulator.AddSimulationModifier(p_growth_modifier);
+    }
+    else
+    {
+        MAKE_PTR(TargetAreaLinearGrowthModifier<2>, p_growth_modifier);
+        simulator.AddSimulationModifier(p_growth_modifier);
+    }
+
+    if (r_params.mUseSpatialHash)
+    {
+        // Takes over the mesh's T3 swap check
+        MAKE_PTR(SpatialHashIntersectionModifier<2>, p_intersection_modifier);
+        simulator.AddSimulationModifier(p_intersection_modifier);
+    }
+
+    boost::shared_ptr<AbstractNumericalMethod<2,2> > p_method;
+    boost::shared_ptr<AbstractAdaptiveNumericalMethod<2,2> > p_adaptive_method;
+    if (r_params.mNumericalMethod == "ForwardEuler")
+    {
+        p_method.reset(new ForwardEulerNumericalMethod<2,2>());
+    }
+    else if (r_params.mNumericalMethod == "RK23" || r_params.mNumericalMethod == "RK45")
+    {
+        boost::shared_ptr<EmbeddedRungeKuttaNumericalMethod<2,2> > p_runge_kutta(new EmbeddedRungeKuttaNumericalMethod<2,2>());
+        p_runge_kutta->SetOrder(r_params.mNumericalMethod == "RK23" ? 3u : 5u);
+        p_adaptive_method = p_runge_kutta;
+    }
+    else if (r_params.mNumericalMethod == "SemiImplicit")
+    {
+        p_adaptive_method.reset(new SemiImplicitVertexNumericalMethod());
+    }
+    else
+    {
+        EXCEPTION("Unknown numerical method " << r_params.mNumericalMethod);
+    }
+    if (p_adaptive_method)
+    {
+        p_adaptive_method->SetTolerance(r_params.mIntegratorTolerance);
+        p_method = p_adaptive_method;
+    }
+
+    // The adaptive methods choose their own sub-steps, but this also lets a time step be
+    // retried with a shorter one if vertices would move too far for the T1 swap checks
+    p_method->SetUseAdaptiveTimestep(true);
+    simulator.SetNumericalMethod(p_method);
+
+    if (r_params.mDetectDivergence)
+    {
+        // Added last, so that it sees the state the other modifiers leave behind
+        MAKE_PTR(DivergenceDetectionModifier<2>, p_divergence_modifier);
+        simulator.AddSimulationModifier(p_divergence_modifier);
+    }
+
+    return Solve(simulator, output_directory);
+}
+
+TissueSummaryStatistics PaperVertexSimulation::Solve(BudgetedOffLatticeSimulation<2>& rSimulator, const std::string& rOutputDirectory)
+{
+    const PaperVertexSimulationParameters& r_params = mParameters;
+    rSimulator.SetWallTimeBudget(r_params.mWallTimeBudget);
+    rSimulator.SetTimeStepBudget(r_params.mTimeStepBudget);
+
+    // Found through the simulation, so that this also works for one loaded from a checkpoint
+    boost::shared_ptr<AbstractAdaptiveNumericalMethod<2,2> > p_adaptive_method =
+        boost::dynamic_pointer_cast<AbstractAdaptiveNumericalMethod<2,2> >(rSimulator.GetNumericalMethod());
+    boost::shared_ptr<DivergenceDetectionModifier<2> > p_divergence_modifier;
+    std::vector<boost::shared_ptr<AbstractCellBasedSimulationModifier<2> > >& r_modifiers = *(rSimulator.GetSimulationModifiers());
+    for (unsigned i=0; i<r_modifiers.size() && !p_divergence_modifier; i++)
+    {
+        p_divergence_modifier = boost::dynamic_pointer_cast<DivergenceDetectionModifier<2> >(r_modifiers[i]);
+    }
+    if (p_divergence_modifier)
+    {
+        p_divergence_modifier->SetAdaptiveMethod(p_adaptive_method);
+    }
+
+    try
+    {
+        rSimulator.Solve();
+    }
+    catch (Exception&)
+    {
+        // The final remeshing of a simulation that has diverged may throw too
+        if (p_divergence_modifier && p_divergence_modifier->HasFailed())
+        {
+            p_divergence_modifier->rGetFailureRecord().Write(rOutputDirectory);
+        }
+        throw;
+    }
+
+    if (p_divergence_modifier && p_divergence_modifier->HasFailed())
+    {
+        // The modifier has stopped the simulation, and Solve() has closed the writers' files.
+        // A run that has diverged is not resumed, so any marker from an earlier call goes
+        const SimulationFailureRecord& r_record = p_divergence_modifier->rGetFailureRecord();
+        r_record.Write(rOutputDirectory);
+        RunTruncationMarker::Remove(rOutputDirectory);
+        EXCEPTION("The simulation has diverged: " << r_record.GetDescription());
+    }
+
+    if (p_adaptive_method)
+    {
+        const std::string file_name = "NumericalMethodStatistics.dat";
+        if (mpResultsStore)
+        {
+            std::ostringstream statistics;
+            p_adaptive_method->OutputStepStatistics(statistics);
+            mpResultsStore->Append(file_name, statistics.str());
+        }
+        else
+        {
+            OutputFileHandler handler(mOutputDirectory, false);
+            out_stream p_file = handler.OpenOutputFile(file_name);
+            p_adaptive_method->OutputStepStatistics(*p_file);
+            p_file->close();
+        }
+    }
+
+    VertexBasedCellPopulation<2>* p_cell_population = static_cast<VertexBasedCellPopulation<2>*>(&(rSimulator.rGetCellPopulation()));
+    if (rSimulator.WasTruncated())
+    {
+        // Solve() has closed the writers' files already. The marker goes last, so that
+        // a run with a marker always has its checkpoint
+        CellBasedSimulationArchiver<2, BudgetedOffLatticeSimulation<2> >::Save(&rSimulator);
+
+        RunTruncationMarker marker;
+        marker.mReason = rSimulator.rGetTruncationReason();
+        marker.mTime = SimulationTime::Instance()->GetTime();
+        marker.mEndTime = r_params.mEndTime;
+        marker.mWallTime = rSimulator.GetSolveWallTime();
+        marker.mTimeSteps = rSimulator.GetSolveTimeSteps();
+        marker.mNumCells = p_cell_population->GetNumRealCells();
+        marker.Write(rOutputDirectory);
+        mWasTruncated = true;
+    }
+    else
+    {
+        RunTruncationMarker::Remove(rOutputDirectory);
+    }
+
+    if (mpResultsStore)
+    {
+        mpResultsStore->Commit();
+    }
+
+    return TissueSummaryStatistics::Calculate(p_cell_population);
+}
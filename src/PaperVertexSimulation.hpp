@@ -0,0 +1,259 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef PAPERVERTEXSIMULATION_HPP_
+#define PAPERVERTEXSIMULATION_HPP_
+
+#include <string>
+#include <boost/shared_ptr.hpp>
+#include "SweepResultsStore.hpp"
+#include "TissueSummaryStatistics.hpp"
+
+/**
+ * The parameters of the tissue simulation used in the paper. The defaults are
+ * those used by TestPaperCommandLineVertexSimulation.
+ */
+struct PaperVertexSimulationParameters
+{
+    /** The line tension parameter, Lambda. Defaults to 0.12. */
+    double mLineTensionParameter;
+
+    /** The perimeter contractility parameter, Gamma. Defaults to 0.04. */
+    double mPerimeterContractilityParameter;
+
+    /** The number of generations of transit cells. Defaults to 7. */
+    unsigned mNumberGenerations;
+
+    /** The average cell cycle time. Defaults to 20. */
+    double mAverageCellCycleTime;
+
+    /** The ratio of new to threshold edge length after a T1 swap. Defaults to 1.5. */
+    double mNewEdgeLengthFactor;
+
+    /** Whether to restrict vertex movement. Defaults to true. */
+    bool mRestrictVertexMovement;
+
+    /** Whether to randomise the order of T1 swaps. Defaults to false. */
+    bool mRandomiseT1SwapOrder;
+
+    /** The T1 swap threshold. Defaults to 0.01. */
+    double mT1SwapThreshold;
+
+    /** The T2 swap threshold. Defaults to 0.001. */
+    double mT2SwapThreshold;
+
+    /** The number of cells along each side of the initial honeycomb. Defaults to 2. */
+    unsigned mInitialSize;
+
+    /** The time step. Defaults to 0.005. */
+    double mDt;
+
+    /** The end time. Defaults to 700. */
+    double mEndTime;
+
+    /** Output is written every this many time steps. Defaults to 200. */
+    unsigned mSamplingTimestepMultiple;
+
+    /** Whether the project writers gzip their output. Defaults to false. */
+    bool mCompressOutput;
+
+    /**
+     * Whether to use FasterFarhadifarForce rather than Chaste's FarhadifarForce,
+     * which gives the same forces up to rounding. Defaults to false, so that the
+     * paper's runs use the reference force.
+     */
+    bool mUseFasterForce;
+
+    /**
+     * The number of threads FasterFarhadifarForce uses, where 0 means one per
+     * hardware thread. The results do not depend on it. Defaults to 1.
+     */
+    unsigned mNumForceThreads;
+
+    /**
+     * Whether FasterFarhadifarForce renumbers its copy of the mesh for locality
+     * when the topology changes; see FarhadifarForceKernel. Defaults to false.
+     */
+    bool mRenumberMesh;
+
+    /**
+     * The numerical method: "ForwardEuler" (the default), "RK23" or "RK45" (see
+     * EmbeddedRungeKuttaNumericalMethod) or "SemiImplicit" (see
+     * SemiImplicitVertexNumericalMethod, which needs mUseFasterForce).
+     */
+    std::string mNumericalMethod;
+
+    /** The tolerance of the adaptive numerical methods; see AbstractAdaptiveNumericalMethod. Defaults to 1e-4. */
+    double mIntegratorTolerance;
+
+    /**
+     * Whether to check for T3 swaps with a SpatialHashIntersectionModifier rather
+     * than the mesh's own check of every boundary node against every boundary
+     * element. Defaults to false.
+     */
+    bool mUseSpatialHash;
+
+    /**
+     * Whether to grow the target areas with a TableTargetAreaModifier, which
+     * FasterFarhadifarForce reads without going through the cells' CellData,
+     * rather than with TargetAreaLinearGrowthModifier. Needs mUseFasterForce.
+     * Defaults to false.
+     */
+    bool mUseCellDataTable;
+
+    /**
+     * Whether to stop the simulation, and leave a SimulationFailureRecord in its
+     * output directory, if it diverges; see DivergenceDetectionModifier.
+     * Defaults to false.
+     */
+    bool mDetectDivergence;
+
+    /**
+     * The wall-clock time, in seconds, that the run may take before it is stopped
+     * and checkpointed (see BudgetedOffLatticeSimulation), or 0 for no limit.
+     * Defaults to 0.
+     */
+    double mWallTimeBudget;
+
+    /**
+     * The number of time steps that the run may take before it is stopped and
+     * checkpointed, or 0 for no limit. Defaults to 0.
+     */
+    unsigned mTimeStepBudget;
+
+    /**
+     * Default constructor. Sets the defaults given above.
+     */
+    PaperVertexSimulationParameters();
+};
+
+template<unsigned DIM> class BudgetedOffLatticeSimulation;
+
+/**
+ * Sets up and runs one tissue simulation of the paper: a honeycomb of transit
+ * cells with FixedSequenceCellCycleModel cell cycles, a FarhadifarForce (or,
+ * with mUseFasterForce, the equivalent FasterFarhadifarForce) with the
+ * given Lambda and Gamma, linear target area growth and the project writers.
+ *
+ * Each call to Run() creates its own SimulationContext, so a program may call
+ * Run() many times, e.g. through a SimulationWorkerPool.
+ *
+ * A run that uses up its wall time or time step budget stops early and leaves
+ * a checkpoint and a RunTruncationMarker in its output directory. With
+ * SetResumeFromCheckpoint(true), the next call to Run() carries on from there.
+ */
+class PaperVertexSimulation
+{
+private:
+
+    /** The simulation parameters. */
+    PaperVertexSimulationParameters mParameters;
+
+    /** The output directory, relative to CHASTE_TEST_OUTPUT. */
+    std::string mOutputDirectory;
+
+    /** The store that the writers write to, if any. */
+    boost::shared_ptr<SweepResultsStore> mpResultsStore;
+
+    /** Whether Run() resumes a truncated run from its checkpoint. */
+    bool mResumeFromCheckpoint;
+
+    /** Whether the last call to Run() stopped early. */
+    bool mWasTruncated;
+
+    /**
+     * Run a simulation that has been set up or loaded from a checkpoint to the end
+     * time or until it uses up its budget, and write a failure record if it diverges,
+     * or a checkpoint and a truncation marker if it is stopped early.
+     *
+     * @param rSimulator the simulation
+     * @param rOutputDirectory the full path of the output directory, ending in '/'
+     * @return the summary statistics of the tissue at the end
+     */
+    TissueSummaryStatistics Solve(BudgetedOffLatticeSimulation<2>& rSimulator, const std::string& rOutputDirectory);
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param rParameters the simulation parameters
+     * @param rOutputDirectory the output directory, relative to CHASTE_TEST_OUTPUT
+     */
+    PaperVertexSimulation(const PaperVertexSimulationParameters& rParameters, const std::string& rOutputDirectory);
+
+    /**
+     * Send the output of the writers to a results store rather than to files.
+     * Chaste's own writers are wrapped in ResultsStoreWriter, and the numerical
+     * method statistics go to the store too. Only the files that the simulation
+     * writes itself, such as results.parameters, and the failure, truncation and
+     * checkpoint files are still written to the output directory.
+     *
+     * @param pResultsStore the store
+     */
+    void SetResultsStore(boost::shared_ptr<SweepResultsStore> pResultsStore);
+
+    /**
+     * Set whether Run() should resume the run from its checkpoint, if an earlier
+     * attempt was truncated, rather than start it again. Defaults to false.
+     *
+     * The writers of a resumed run write to their files in a new results
+     * directory, results_from_time_<checkpoint time>, and not to a results store.
+     *
+     * @param resumeFromCheckpoint whether to resume truncated runs
+     */
+    void SetResumeFromCheckpoint(bool resumeFromCheckpoint);
+
+    /**
+     * @return the simulation parameters
+     */
+    const PaperVertexSimulationParameters& rGetParameters() const;
+
+    /**
+     * Run the simulation.
+     *
+     * @param randomSeed the random seed; 0 means seed from the clock
+     * @return the summary statistics of the tissue at the end time, or when it was stopped
+     */
+    TissueSummaryStatistics Run(unsigned randomSeed);
+
+    /**
+     * @return whether the last call to Run() stopped before the end time because
+     *     it used up its budget
+     */
+    bool WasTruncated() const;
+};
+
+#endif /*PAPERVERTEXSIMULATION_HPP_*/
@@ -0,0 +1,341 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "ParameterDesign.hpp"
+#include "BufferedTextEmitter.hpp"
+#include "Exception.hpp"
+#include "Philox4x32.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+
+namespace
+{
+    /** The largest dimension of the Sobol sequences. */
+    const unsigned MAX_SOBOL_DIMENSION = 8u;
+
+    /**
+     * The Joe-Kuo direction number parameters of dimensions 2 to 8: the degree s
+     * and coefficients a of the primitive polynomial, and the initial direction numbers m.
+     */
+    const struct
+    {
+        unsigned mDegree;
+        unsigned mCoefficients;
+        unsigned mInitial[5];
+    } SOBOL_PARAMETERS[MAX_SOBOL_DIMENSION - 1] = {
+        {1u, 0u, {1u}},
+        {2u, 1u, {1u, 3u}},
+        {3u, 1u, {1u, 3u, 1u}},
+        {3u, 2u, {1u, 1u, 1u}},
+        {4u, 1u, {1u, 1u, 3u, 3u}},
+        {4u, 4u, {1u, 3u, 5u, 13u}},
+        {5u, 2u, {1u, 1u, 5u, 5u, 17u}}
+    };
+}
+
+ParameterDesign::ParameterDesign()
+    : mNumSobolPoints(0u)
+{
+    SetBounds("Lambda", -1.0, 0.2);
+    SetBounds("Gamma", 0.0, 0.5);
+}
+
+void ParameterDesign::SetBounds(const std::string& rName, double lowerBound, double upperBound)
+{
+    if (!(lowerBound < upperBound))
+    {
+        EXCEPTION("The lower bound of " << rName << " must be below its upper bound");
+    }
+
+    std::vector<std::string>::iterator it = std::find(mNames.begin(), mNames.end(), rName);
+    if (it == mNames.end())
+    {
+        if (!mPoints.empty())
+        {
+            EXCEPTION("Parameters cannot be added to a design that has points");
+        }
+        mNames.push_back(rName);
+        mLowerBounds.push_back(lowerBound);
+        mUpperBounds.push_back(upperBound);
+    }
+    else
+    {
+        mLowerBounds[it - mNames.begin()] = lowerBound;
+        mUpperBounds[it - mNames.begin()] = upperBound;
+    }
+}
+
+std::vector<std::vector<double> > ParameterDesign::GetLatinHypercube(unsigned numPoints, unsigned dimension, unsigned seed)
+{
+    Philox4x32 random(seed);
+    std::vector<std::vector<double> > points(numPoints, std::vector<double>(dimension));
+    std::vector<unsigned> permutation(numPoints);
+    for (unsigned d=0; d<dimension; d++)
+    {
+        // A random permutation of the intervals (Fisher-Yates), and a random position within each
+        for (unsigned i=0; i<numPoints; i++)
+        {
+            permutation[i] = i;
+        }
+        for (unsigned i=numPoints; i-- > 1u; )
+        {
+            std::swap(permutation[i], permutation[(unsigned)(random.ranf()*(i + 1))]);
+        }
+        for (unsigned i=0; i<numPoints; i++)
+        {
+            points[i][d] = (permutation[i] + random.ranf())/numPoints;
+        }
+    }
+    return points;
+}
+
+std::vector<std::vector<double> > ParameterDesign::GetSobolSequence(unsigned numPoints, unsigned dimension, unsigned skip)
+{
+    if (dimension == 0u || dimension > MAX_SOBOL_DIMENSION)
+    {
+        EXCEPTION("Sobol sequences are available in 1 to " << MAX_SOBOL_DIMENSION << " dimensions");
+    }
+
+    // The direction numbers V[k] of each dimension, as 32-bit fractions
+    std::vector<std::vector<std::uint32_t> > directions(dimension, std::vector<std::uint32_t>(32));
+    for (unsigned k=0; k<32; k++)
+    {
+        directions[0][k] = (std::uint32_t)1u << (31 - k);
+    }
+    for (unsigned d=1; d<dimension; d++)
+    {
+        unsigned degree = SOBOL_PARAMETERS[d-1].mDegree;
+        unsigned coefficients = SOBOL_PARAMETERS[d-1].mCoefficients;
+        std::vector<std::uint32_t>& r_v = directions[d];
+        for (unsigned k=0; k<degree; k++)
+        {
+            r_v[k] = SOBOL_PARAMETERS[d-1].mInitial[k] << (31 - k);
+        }
+        for (unsigned k=degree; k<32; k++)
+        {
+            r_v[k] = r_v[k - degree] ^ (r_v[k - degree] >> degree);
+            for (unsigned i=1; i<degree; i++)
+            {
+                if ((coefficients >> (degree - 1 - i)) & 1u)
+                {
+                    r_v[k] ^= r_v[k - i];
+                }
+            }
+        }
+    }
+
+    // Gray code order: point i differs from point i-1 by the direction of the lowest zero bit of i-1
+    std::vector<std::uint32_t> x(dimension, 0u);
+    std::vector<std::vector<double> > points;
+    points.reserve(numPoints);
+    for (unsigned long long i=1; i<=(unsigned long long)skip + numPoints; i++)
+    {
+        unsigned bit = 0;
+        for (unsigned long long value=i-1; value & 1u; value >>= 1)
+        {
+            bit++;
+        }
+        for (unsigned d=0; d<dimension; d++)
+        {
+            x[d] ^= directions[d][bit];
+        }
+        if (i > skip)
+        {
+            std::vector<double> point(dimension);
+            for (unsigned d=0; d<dimension; d++)
+            {
+                point[d] = x[d]/4294967296.0;
+            }
+            points.push_back(point);
+        }
+    }
+    return points;
+}
+
+std::vector<double> ParameterDesign::ScalePoint(const std::vector<double>& rUnitPoint) const
+{
+    std::vector<double> point(rUnitPoint.size());
+    for (unsigned d=0; d<rUnitPoint.size(); d++)
+    {
+        point[d] = mLowerBounds[d] + rUnitPoint[d]*(mUpperBounds[d] - mLowerBounds[d]);
+    }
+    return point;
+}
+
+void ParameterDesign::AddLatinHypercube(unsigned numPoints, unsigned seed)
+{
+    std::vector<std::vector<double> > unit_points = GetLatinHypercube(numPoints, mNames.size(), seed);
+    for (unsigned i=0; i<unit_points.size(); i++)
+    {
+        mPoints.push_back(ScalePoint(unit_points[i]));
+    }
+}
+
+void ParameterDesign::AddSobolSequence(unsigned numPoints)
+{
+    std::vector<std::vector<double> > unit_points = GetSobolSequence(numPoints, mNames.size(), mNumSobolPoints);
+    for (unsigned i=0; i<unit_points.size(); i++)
+    {
+        mPoints.push_back(ScalePoint(unit_points[i]));
+    }
+    mNumSobolPoints += numPoints;
+}
+
+void ParameterDesign::AddActiveLearningBatch(const GaussianProcessEmulator& rEmulator,
+                                             unsigned numPoints,
+                                             const std::vector<double>& rObserved,
+                                             unsigned numCandidates)
+{
+    if (rEmulator.rGetInputNames() != mNames)
+    {
+        EXCEPTION("The inputs of the emulator are not the parameters of the design");
+    }
+    const unsigned num_outputs = rEmulator.rGetOutputNames().size();
+    if (!rObserved.empty() && rObserved.size() != num_outputs)
+    {
+        EXCEPTION("Expected " << num_outputs << " observed values, not " << rObserved.size());
+    }
+    const unsigned dimension = mNames.size();
+
+    // Log scores of the candidates: the emulator's uncertainty, times the emulated likelihood of the observations
+    std::vector<std::vector<double> > candidates = GetSobolSequence(numCandidates, dimension);
+    std::vector<double> log_scores(candidates.size());
+    std::vector<double> mean;
+    std::vector<double> variance;
+    for (unsigned c=0; c<candidates.size(); c++)
+    {
+        candidates[c] = ScalePoint(candidates[c]);
+        log_scores[c] = std::log(rEmulator.GetUncertainty(candidates[c]));
+        if (!rObserved.empty())
+        {
+            rEmulator.Predict(candidates[c], mean, variance);
+            for (unsigned output=0; output<num_outputs; output++)
+            {
+                if (std::isfinite(rObserved[output]))
+                {
+                    double total_variance = variance[output] + rEmulator.GetNoiseVariance(output);
+                    double difference = mean[output] - rObserved[output];
+                    log_scores[c] -= 0.5*(difference*difference/total_variance + std::log(total_variance));
+                }
+            }
+        }
+    }
+
+    // Candidates correlated with a chosen point are penalised, using the mean length scales over the outputs
+    std::vector<double> length_scales(dimension, 0.0);
+    for (unsigned output=0; output<num_outputs; output++)
+    {
+        std::vector<double> output_length_scales = rEmulator.GetLengthScales(output);
+        for (unsigned d=0; d<dimension; d++)
+        {
+            length_scales[d] += output_length_scales[d]/num_outputs;
+        }
+    }
+
+    std::vector<bool> chosen(candidates.size(), false);
+    for (unsigned i=0; i<numPoints && i<candidates.size(); i++)
+    {
+        unsigned best = 0;
+        double best_score = -std::numeric_limits<double>::infinity();
+        for (unsigned c=0; c<candidates.size(); c++)
+        {
+            if (!chosen[c] && log_scores[c] > best_score)
+            {
+                best = c;
+                best_score = log_scores[c];
+            }
+        }
+        chosen[best] = true;
+        mPoints.push_back(candidates[best]);
+
+        for (unsigned c=0; c<candidates.size(); c++)
+        {
+            double distance_squared = 0.0;
+            for (unsigned d=0; d<dimension; d++)
+            {
+                double difference = (candidates[c][d] - candidates[best][d])/length_scales[d];
+                distance_squared += difference*difference;
+            }
+            // A new run at the chosen point would remove about this fraction of the emulator's variance here
+            double correlation = std::exp(-0.5*distance_squared);
+            log_scores[c] += std::log(std::max(1e-300, 1.0 - correlation*correlation));
+        }
+    }
+}
+
+void ParameterDesign::WriteSweepFile(const std::string& rFilePath, unsigned numRuns, unsigned firstSimulation) const
+{
+    std::ofstream file(rFilePath.c_str());
+    if (!file.is_open())
+    {
+        EXCEPTION("Could not open sweep file " << rFilePath);
+    }
+
+    BufferedTextEmitter emitter;
+    emitter.SetUseShortestRoundTrip(true);
+    for (unsigned d=0; d<mNames.size(); d++)
+    {
+        emitter << mNames[d] << ',';
+    }
+    emitter << "Runs,Simulation\n";
+    for (unsigned i=0; i<mPoints.size(); i++)
+    {
+        for (unsigned d=0; d<mNames.size(); d++)
+        {
+            emitter << mPoints[i][d] << ',';
+        }
+        emitter << numRuns << ',' << firstSimulation + i << '\n';
+    }
+    emitter.FlushTo(file);
+}
+
+const std::vector<std::string>& ParameterDesign::rGetNames() const
+{
+    return mNames;
+}
+
+const std::vector<std::vector<double> >& ParameterDesign::rGetPoints() const
+{
+    return mPoints;
+}
+
+void ParameterDesign::Clear()
+{
+    mPoints.clear();
+    mNumSobolPoints = 0u;
+}
@@ -0,0 +1,172 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef PARAMETERDESIGN_HPP_
+#define PARAMETERDESIGN_HPP_
+
+#include <string>
+#include <vector>
+#include "GaussianProcessEmulator.hpp"
+
+/**
+ * Generates the parameter sets of a sweep, to be written as a sweep CSV file
+ * (Lambda, Gamma, Runs, Simulation) in place of a hand-written one.
+ *
+ * An initial design fills the parameter box evenly, as a Latin hypercube or a
+ * Sobol sequence. Later batches are chosen by active learning: from a dense set
+ * of candidate points, those where a GaussianProcessEmulator trained on the runs
+ * so far is most uncertain, optionally weighted by how well the emulated
+ * statistics match observed ones (i.e. by approximate posterior mass). Points of
+ * a batch are kept apart by reducing the score of candidates within an emulator
+ * length scale of points already chosen.
+ */
+class ParameterDesign
+{
+private:
+
+    /** The names of the parameters, as CSV column names. */
+    std::vector<std::string> mNames;
+
+    /** The lower bound of each parameter. */
+    std::vector<double> mLowerBounds;
+
+    /** The upper bound of each parameter. */
+    std::vector<double> mUpperBounds;
+
+    /** The points of the design, in parameter units. */
+    std::vector<std::vector<double> > mPoints;
+
+    /** The number of Sobol points added so far, so that further calls to AddSobolSequence() continue the sequence. */
+    unsigned mNumSobolPoints;
+
+    /**
+     * @param rUnitPoint a point in the unit cube
+     * @return the corresponding point of the parameter box
+     */
+    std::vector<double> ScalePoint(const std::vector<double>& rUnitPoint) const;
+
+public:
+
+    /**
+     * Constructor. The parameters are Lambda, between -1 and 0.2, and Gamma, between 0 and 0.5.
+     */
+    ParameterDesign();
+
+    /**
+     * Set the range of a parameter, adding the parameter if it is new.
+     *
+     * @param rName the name of the parameter
+     * @param lowerBound the lower bound
+     * @param upperBound the upper bound
+     */
+    void SetBounds(const std::string& rName, double lowerBound, double upperBound);
+
+    /**
+     * Get a Latin hypercube sample of the unit cube: each parameter's range is cut
+     * into numPoints equal intervals and each interval holds exactly one point.
+     *
+     * @param numPoints the number of points
+     * @param dimension the number of parameters
+     * @param seed the seed of the Philox4x32 stream used
+     * @return the points
+     */
+    static std::vector<std::vector<double> > GetLatinHypercube(unsigned numPoints, unsigned dimension, unsigned seed);
+
+    /**
+     * Get points of the Sobol sequence in the unit cube, with the direction numbers
+     * of Joe and Kuo (2008). The first point of the sequence (the origin) is skipped.
+     *
+     * @param numPoints the number of points
+     * @param dimension the number of parameters, at most 8
+     * @param skip the number of further points to skip, e.g. those used before
+     * @return the points
+     */
+    static std::vector<std::vector<double> > GetSobolSequence(unsigned numPoints, unsigned dimension, unsigned skip=0u);
+
+    /**
+     * Add a Latin hypercube sample of the parameter box to the design.
+     *
+     * @param numPoints the number of points
+     * @param seed the seed
+     */
+    void AddLatinHypercube(unsigned numPoints, unsigned seed);
+
+    /**
+     * Add Sobol points of the parameter box to the design.
+     *
+     * @param numPoints the number of points
+     */
+    void AddSobolSequence(unsigned numPoints);
+
+    /**
+     * Add a batch of points chosen by active learning.
+     *
+     * @param rEmulator an emulator, trained on the runs so far, whose inputs are the design's parameters
+     * @param numPoints the number of points to add
+     * @param rObserved the observed value of each of the emulator's outputs, to weight the
+     *     uncertainty by the emulated likelihood; values that are not a number are ignored, and
+     *     if empty, points are chosen by uncertainty alone
+     * @param numCandidates the number of candidate points, from a Sobol sequence. Defaults to 4096.
+     */
+    void AddActiveLearningBatch(const GaussianProcessEmulator& rEmulator,
+                                unsigned numPoints,
+                                const std::vector<double>& rObserved=std::vector<double>(),
+                                unsigned numCandidates=4096u);
+
+    /**
+     * Write the design as a sweep CSV file with columns for the parameters, Runs and Simulation.
+     *
+     * @param rFilePath the path of the file
+     * @param numRuns the number of runs of each point
+     * @param firstSimulation the simulation number of the first point; the others are numbered on from it
+     */
+    void WriteSweepFile(const std::string& rFilePath, unsigned numRuns, unsigned firstSimulation=1u) const;
+
+    /**
+     * @return the names of the parameters
+     */
+    const std::vector<std::string>& rGetNames() const;
+
+    /**
+     * @return the points of the design
+     */
+    const std::vector<std::vector<double> >& rGetPoints() const;
+
+    /**
+     * Remove all points from the design, and restart the Sobol sequence.
+     */
+    void Clear();
+};
+
+#endif /*PARAMETERDESIGN_HPP_*/
@@ -0,0 +1,198 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef PHILOX4X32_HPP_
+#define PHILOX4X32_HPP_
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+/**
+ * The Philox4x32-10 counter-based random number generator of Salmon et al.,
+ * "Parallel random numbers: as easy as 1, 2, 3" (SC'11).
+ *
+ * Philox is a keyed bijection of 128-bit counters: the n-th block of random
+ * numbers of a stream is Generate(n, key), computed directly rather than by
+ * stepping a hidden state. Different keys (or different fixed counter words)
+ * give independent streams, so each run, chain or thread can have its own
+ * stream without any shared state or locking, and a stream can be replayed
+ * from any position.
+ *
+ * As an engine, counter words 0 and 1 hold the 64-bit position in the stream
+ * and words 2 and 3 hold a stream number, so one key gives 2^64 streams of
+ * 2^66 numbers each. The class meets the C++ UniformRandomBitGenerator
+ * requirements, so it can be used with the <random> distributions.
+ */
+class Philox4x32
+{
+public:
+
+    /** A block of four 32-bit words: a counter or a block of output. */
+    typedef std::array<std::uint32_t, 4> Block;
+
+    /** A key. */
+    typedef std::array<std::uint32_t, 2> Key;
+
+    /** The type of the numbers generated. */
+    typedef std::uint32_t result_type;
+
+private:
+
+    /** The key of the stream. */
+    Key mKey;
+
+    /** The counter of the current block. */
+    Block mCounter;
+
+    /** The current block of output. */
+    Block mOutput;
+
+    /** The index in mOutput of the next number; 4 means a new block is needed. */
+    unsigned mOutputIndex;
+
+    /**
+     * One Philox round.
+     *
+     * @param rCounter the block to transform
+     * @param rKey the round key
+     */
+    static void Round(Block& rCounter, const Key& rKey)
+    {
+        std::uint64_t product_0 = (std::uint64_t)0xD2511F53u * rCounter[0];
+        std::uint64_t product_1 = (std::uint64_t)0xCD9E8D57u * rCounter[2];
+
+        Block result = {{(std::uint32_t)(product_1 >> 32) ^ rCounter[1] ^ rKey[0],
+                         (std::uint32_t)product_1,
+                         (std::uint32_t)(product_0 >> 32) ^ rCounter[3] ^ rKey[1],
+                         (std::uint32_t)product_0}};
+        rCounter = result;
+    }
+
+public:
+
+    /**
+     * Compute one block of random numbers.
+     *
+     * @param counter the counter
+     * @param key the key
+     * @return the block for that counter and key
+     */
+    static Block Generate(Block counter, Key key)
+    {
+        Round(counter, key);
+        for (unsigned round=1; round<10; round++)
+        {
+            key[0] += 0x9E3779B9u;
+            key[1] += 0xBB67AE85u;
+            Round(counter, key);
+        }
+        return counter;
+    }
+
+    /**
+     * Constructor.
+     *
+     * @param key0 the first word of the key (e.g. a seed)
+     * @param key1 the second word of the key
+     * @param stream0 the first word of the stream number
+     * @param stream1 the second word of the stream number
+     */
+    Philox4x32(std::uint32_t key0, std::uint32_t key1=0u, std::uint32_t stream0=0u, std::uint32_t stream1=0u)
+        : mKey({{key0, key1}}),
+          mCounter({{0u, 0u, stream0, stream1}}),
+          mOutputIndex(4u)
+    {
+    }
+
+    /**
+     * @return the next 32-bit number of the stream
+     */
+    result_type operator()()
+    {
+        if (mOutputIndex == 4u)
+        {
+            mOutput = Generate(mCounter, mKey);
+            mOutputIndex = 0u;
+
+            // Advance the 64-bit position held in counter words 0 and 1
+            if (++mCounter[0] == 0u)
+            {
+                ++mCounter[1];
+            }
+        }
+        return mOutput[mOutputIndex++];
+    }
+
+    /**
+     * @return a uniform random number in [0, 1), with 53 random bits
+     */
+    double ranf()
+    {
+        std::uint64_t high = (*this)() >> 5;
+        std::uint64_t low = (*this)() >> 6;
+        return (high * 67108864.0 + low) * (1.0 / 9007199254740992.0);
+    }
+
+    /**
+     * Move to a position in the stream.
+     *
+     * @param blockIndex the index of the block of four numbers to generate next
+     */
+    void Seek(std::uint64_t blockIndex)
+    {
+        mCounter[0] = (std::uint32_t)blockIndex;
+        mCounter[1] = (std::uint32_t)(blockIndex >> 32);
+        mOutputIndex = 4u;
+    }
+
+    /**
+     * @return the smallest number generated
+     */
+    static constexpr result_type min()
+    {
+        return 0u;
+    }
+
+    /**
+     * @return the largest number generated
+     */
+    static constexpr result_type max()
+    {
+        return std::numeric_limits<result_type>::max();
+    }
+};
+
+#endif /*PHILOX4X32_HPP_*/
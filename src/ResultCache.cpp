@@ -0,0 +1,203 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "ResultCache.hpp"
+#include "Exception.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <system_error>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+
+namespace
+{
+    /** The file name extension of cache entries. */
+    const std::string ENTRY_EXTENSION = ".entry";
+
+    /** Separates the key from the value in an entry. */
+    const std::string KEY_END = "\n--\n";
+}
+
+ResultCache::ResultCache(const std::string& rDirectory, std::uintmax_t maxSize)
+    : mDirectory(rDirectory),
+      mMaxSize(maxSize)
+{
+    if (mDirectory.empty() || mDirectory[mDirectory.size()-1] != '/')
+    {
+        mDirectory += '/';
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(mDirectory, error);
+    if (!std::filesystem::is_directory(mDirectory))
+    {
+        EXCEPTION("Could not create result cache directory " << mDirectory);
+    }
+}
+
+std::string ResultCache::GetHash(const std::string& rKey)
+{
+    std::uint64_t hash = 14695981039346656037ull;
+    for (unsigned i=0; i<rKey.size(); i++)
+    {
+        hash ^= (unsigned char)rKey[i];
+        hash *= 1099511628211ull;
+    }
+
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)hash);
+    return std::string(hex);
+}
+
+std::string ResultCache::GetEntryPath(const std::string& rKey) const
+{
+    return mDirectory + GetHash(rKey) + ENTRY_EXTENSION;
+}
+
+bool ResultCache::Lookup(const std::string& rKey, std::string& rValue)
+{
+    std::string path = GetEntryPath(rKey);
+    std::ifstream file(path.c_str(), std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    const std::string& r_contents = contents.str();
+
+    // Check the stored key, in case of a hash collision
+    if (r_contents.size() < rKey.size() + KEY_END.size()
+        || r_contents.compare(0, rKey.size(), rKey) != 0
+        || r_contents.compare(rKey.size(), KEY_END.size(), KEY_END) != 0)
+    {
+        return false;
+    }
+    rValue = r_contents.substr(rKey.size() + KEY_END.size());
+
+    // Mark as recently used; the entry may have been evicted by another process meanwhile
+    std::error_code error;
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+    return true;
+}
+
+void ResultCache::Insert(const std::string& rKey, const std::string& rValue)
+{
+    std::string path = GetEntryPath(rKey);
+    std::string temporary_path = path + ".tmp" + std::to_string(getpid());
+    {
+        std::ofstream file(temporary_path.c_str(), std::ios::binary);
+        if (!file.is_open())
+        {
+            EXCEPTION("Could not write result cache entry " << temporary_path);
+        }
+        file << rKey << KEY_END << rValue;
+    }
+    if (std::rename(temporary_path.c_str(), path.c_str()) != 0)
+    {
+        std::remove(temporary_path.c_str());
+        EXCEPTION("Could not write result cache entry " << path);
+    }
+
+    Evict();
+}
+
+unsigned ResultCache::Evict()
+{
+    std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path> > entries;
+    std::uintmax_t total_size = 0;
+
+    std::error_code error;
+    for (std::filesystem::directory_iterator iter(mDirectory, error); !error && iter != std::filesystem::directory_iterator(); iter.increment(error))
+    {
+        if (iter->path().extension() == ENTRY_EXTENSION)
+        {
+            std::error_code entry_error;
+            std::uintmax_t size = iter->file_size(entry_error);
+            std::filesystem::file_time_type time = iter->last_write_time(entry_error);
+            if (!entry_error)
+            {
+                total_size += size;
+                entries.push_back(std::make_pair(time, iter->path()));
+            }
+        }
+    }
+
+    if (total_size <= mMaxSize)
+    {
+        return 0;
+    }
+
+    // Oldest first
+    std::sort(entries.begin(), entries.end());
+
+    unsigned num_removed = 0;
+    for (unsigned i=0; i<entries.size() && total_size > mMaxSize; i++)
+    {
+        std::error_code entry_error;
+        std::uintmax_t size = std::filesystem::file_size(entries[i].second, entry_error);
+        if (!entry_error && std::filesystem::remove(entries[i].second, entry_error))
+        {
+            total_size -= size;
+            num_removed++;
+        }
+    }
+    return num_removed;
+}
+
+std::uintmax_t ResultCache::GetSize() const
+{
+    std::uintmax_t total_size = 0;
+    std::error_code error;
+    for (std::filesystem::directory_iterator iter(mDirectory, error); !error && iter != std::filesystem::directory_iterator(); iter.increment(error))
+    {
+        std::error_code entry_error;
+        if (iter->path().extension() == ENTRY_EXTENSION)
+        {
+            std::uintmax_t size = iter->file_size(entry_error);
+            if (!entry_error)
+            {
+                total_size += size;
+            }
+        }
+    }
+    return total_size;
+}
@@ -0,0 +1,118 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef RESULTCACHE_HPP_
+#define RESULTCACHE_HPP_
+
+#include <cstdint>
+#include <string>
+
+/**
+ * A size-bounded on-disk cache of simulation results, addressed by content.
+ *
+ * An entry is looked up by a key, a text that lists every input affecting the
+ * result (see SweepRunner::GetCacheKey()). The key is hashed (64-bit FNV-1a) to
+ * give the entry's file name; the full key is also stored in the entry and
+ * compared on lookup, so that a hash collision gives a miss rather than a wrong
+ * result.
+ *
+ * Entries are written to a temporary file and renamed into place, so several
+ * processes can share a cache directory. When the total size of the entries goes
+ * over the limit, the least recently used entries are removed; an entry's
+ * modification time records when it was last used.
+ */
+class ResultCache
+{
+private:
+
+    /** The cache directory, ending in '/'. */
+    std::string mDirectory;
+
+    /** The maximum total size of the entries, in bytes. */
+    std::uintmax_t mMaxSize;
+
+    /**
+     * @param rKey a key
+     * @return the path of the entry for the key
+     */
+    std::string GetEntryPath(const std::string& rKey) const;
+
+public:
+
+    /**
+     * Constructor. Creates the cache directory if necessary.
+     *
+     * @param rDirectory the cache directory
+     * @param maxSize the maximum total size of the entries, in bytes; defaults to 256 MiB
+     */
+    ResultCache(const std::string& rDirectory, std::uintmax_t maxSize=(std::uintmax_t)1 << 28);
+
+    /**
+     * @param rKey a key
+     * @return the 64-bit FNV-1a hash of the key, as 16 hexadecimal digits
+     */
+    static std::string GetHash(const std::string& rKey);
+
+    /**
+     * Look up a result. A hit marks the entry as recently used.
+     *
+     * @param rKey the key
+     * @param rValue set to the cached result on a hit
+     * @return whether the cache holds a result for the key
+     */
+    bool Lookup(const std::string& rKey, std::string& rValue);
+
+    /**
+     * Add a result to the cache, then evict entries if the cache is too large.
+     *
+     * @param rKey the key
+     * @param rValue the result
+     */
+    void Insert(const std::string& rKey, const std::string& rValue);
+
+    /**
+     * Remove least recently used entries until the cache is within its size limit.
+     *
+     * @return the number of entries removed
+     */
+    unsigned Evict();
+
+    /**
+     * @return the total size of the entries, in bytes
+     */
+    std::uintmax_t GetSize() const;
+};
+
+#endif /*RESULTCACHE_HPP_*/
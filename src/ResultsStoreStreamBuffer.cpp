@@ -0,0 +1,103 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "ResultsStoreStreamBuffer.hpp"
+#include "Exception.hpp"
+
+ResultsStoreStreamBuffer::ResultsStoreStreamBuffer(boost::shared_ptr<SweepResultsStore> pResultsStore,
+                                                   const std::string& rDatasetName,
+                                                   unsigned bufferSize)
+    : mpResultsStore(pResultsStore),
+      mDatasetName(rDatasetName),
+      mBuffer(bufferSize > 0 ? bufferSize : 1u)
+{
+    if (!mpResultsStore)
+    {
+        EXCEPTION("ResultsStoreStreamBuffer needs a results store to write to");
+    }
+
+    setp(mBuffer.data(), mBuffer.data() + mBuffer.size());
+}
+
+ResultsStoreStreamBuffer::~ResultsStoreStreamBuffer()
+{
+    // A failure is recorded in the store, whose next commit fails the run
+    AppendBuffer();
+}
+
+bool ResultsStoreStreamBuffer::AppendBuffer()
+{
+    std::size_t num_bytes = pptr() - pbase();
+    if (num_bytes == 0)
+    {
+        return true;
+    }
+
+    try
+    {
+        mpResultsStore->Append(mDatasetName, std::string(pbase(), num_bytes));
+    }
+    catch (Exception& e)
+    {
+        // Stream buffers report failure through their return values, not exceptions, and
+        // writers may not check the stream, so the store remembers it for its next commit
+        mpResultsStore->RecordFailure("Output for " + mDatasetName + " could not be added: " + e.GetMessage());
+        return false;
+    }
+
+    setp(mBuffer.data(), mBuffer.data() + mBuffer.size());
+    return true;
+}
+
+ResultsStoreStreamBuffer::int_type ResultsStoreStreamBuffer::overflow(int_type c)
+{
+    if (!AppendBuffer())
+    {
+        return traits_type::eof();
+    }
+
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+    {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+        return c;
+    }
+    return traits_type::not_eof(c);
+}
+
+int ResultsStoreStreamBuffer::sync()
+{
+    return AppendBuffer() ? 0 : -1;
+}
@@ -0,0 +1,111 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef RESULTSSTORESTREAMBUFFER_HPP_
+#define RESULTSSTORESTREAMBUFFER_HPP_
+
+#include <boost/shared_ptr.hpp>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include "SweepResultsStore.hpp"
+
+/**
+ * A stream buffer that appends everything written to it to one dataset of a
+ * SweepResultsStore, rather than to a file. It lets writers that write to an
+ * std::ostream, such as the Chaste writers, put their output in the store.
+ *
+ * Data are collected in a buffer of fixed size and appended to the store
+ * whenever the buffer is full and whenever it is synced. If that fails, the
+ * stream fails and the failure is recorded in the store (see
+ * SweepResultsStore::RecordFailure()), so that the run fails too.
+ */
+class ResultsStoreStreamBuffer : public std::streambuf
+{
+private:
+
+    /** The store that data are appended to. */
+    boost::shared_ptr<SweepResultsStore> mpResultsStore;
+
+    /** The name of the dataset that data are appended to. */
+    std::string mDatasetName;
+
+    /** Buffer holding data not yet appended to the store. */
+    std::vector<char> mBuffer;
+
+    /**
+     * Append the contents of the buffer to the store and empty the buffer.
+     *
+     * @return whether the data were appended successfully
+     */
+    bool AppendBuffer();
+
+protected:
+
+    /**
+     * Overridden overflow() method, called when the buffer is full.
+     *
+     * @param c the character that did not fit in the buffer
+     * @return c on success, or EOF on failure
+     */
+    virtual int_type overflow(int_type c);
+
+    /**
+     * Overridden sync() method. Appends any buffered data to the store.
+     *
+     * @return 0 on success and -1 on failure
+     */
+    virtual int sync();
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param pResultsStore the store to append data to
+     * @param rDatasetName the name of the dataset to append data to
+     * @param bufferSize the size of the buffer, in bytes
+     */
+    ResultsStoreStreamBuffer(boost::shared_ptr<SweepResultsStore> pResultsStore,
+                             const std::string& rDatasetName,
+                             unsigned bufferSize=1u << 16);
+
+    /**
+     * Destructor. Appends any data remaining in the buffer, recording any failure in the store.
+     */
+    virtual ~ResultsStoreStreamBuffer();
+};
+
+#endif /*RESULTSSTORESTREAMBUFFER_HPP_*/
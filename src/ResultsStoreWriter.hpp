@@ -0,0 +1,215 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef RESULTSSTOREWRITER_HPP_
+#define RESULTSSTOREWRITER_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+#include <boost/shared_ptr.hpp>
+#include <fstream>
+#include "OutputFileHandler.hpp"
+#include "ResultsStoreStreamBuffer.hpp"
+#include "SweepResultsStore.hpp"
+
+#include "BoundaryNodeWriter.hpp"
+#include "CellAgesWriter.hpp"
+#include "CellPopulationElementWriter.hpp"
+#include "CellProliferativePhasesWriter.hpp"
+#include "CellProliferativeTypesWriter.hpp"
+#include "NodeLocationWriter.hpp"
+#include "VertexIntersectionSwapLocationsWriter.hpp"
+#include "VertexT1SwapLocationsWriter.hpp"
+#include "VertexT2SwapLocationsWriter.hpp"
+#include "VertexT3SwapLocationsWriter.hpp"
+
+/**
+ * Puts the output of one of the Chaste writers in a SweepResultsStore, e.g.
+ *
+ *   boost::shared_ptr<ResultsStoreWriter<CellAgesWriter<2,2> > > p_writer(new ResultsStoreWriter<CellAgesWriter<2,2> >());
+ *   p_writer->SetResultsStore(p_store);
+ *
+ * The Chaste writers write straight to mpOutStream, so rather than opening the
+ * output file this class gives them a stream that appends to the dataset of
+ * the store named after the file. Without a store it behaves like the writer
+ * it wraps. The project writers do not need this; see AbstractProjectWriter.
+ *
+ * The store is not archived, so a writer loaded from a checkpoint writes to its
+ * file until it is given a store again.
+ */
+template<class CHASTE_WRITER>
+class ResultsStoreWriter : public CHASTE_WRITER
+{
+private:
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Serialize the object and its member variables.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<CHASTE_WRITER>(*this);
+    }
+
+    /** The store that output goes to instead of the output file, if any. */
+    boost::shared_ptr<SweepResultsStore> mpResultsStore;
+
+    /** The stream buffer of mpOutStream while the output goes to the store. */
+    boost::shared_ptr<ResultsStoreStreamBuffer> mpStoreBuffer;
+
+    /**
+     * Point mpOutStream at the store rather than at the output file.
+     */
+    void OpenStoreStream()
+    {
+        mpStoreBuffer.reset(new ResultsStoreStreamBuffer(mpResultsStore, this->mFileName));
+        this->mpOutStream.reset(new std::ofstream());
+        std::ostream& r_stream = *(this->mpOutStream);
+        r_stream.rdbuf(mpStoreBuffer.get());
+    }
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    ResultsStoreWriter()
+        : CHASTE_WRITER()
+    {
+    }
+
+    /**
+     * Send this writer's output to a results store rather than to its output file.
+     * This must be called before the output file is opened.
+     *
+     * @param pResultsStore the store, or an empty pointer to write to the output file again
+     */
+    void SetResultsStore(boost::shared_ptr<SweepResultsStore> pResultsStore)
+    {
+        mpResultsStore = pResultsStore;
+    }
+
+    /**
+     * Overridden OpenOutputFile() method.
+     *
+     * @param rOutputFileHandler handler for the directory in which to open this file
+     */
+    virtual void OpenOutputFile(OutputFileHandler& rOutputFileHandler)
+    {
+        if (mpResultsStore)
+        {
+            OpenStoreStream();
+        }
+        else
+        {
+            CHASTE_WRITER::OpenOutputFile(rOutputFileHandler);
+        }
+    }
+
+    /**
+     * Overridden OpenOutputFileForAppend() method.
+     *
+     * @param rOutputFileHandler handler for the directory in which to open this file
+     */
+    virtual void OpenOutputFileForAppend(OutputFileHandler& rOutputFileHandler)
+    {
+        if (mpResultsStore)
+        {
+            OpenStoreStream();
+        }
+        else
+        {
+            CHASTE_WRITER::OpenOutputFileForAppend(rOutputFileHandler);
+        }
+    }
+
+    /**
+     * Overridden CloseFile() method. Hands anything still buffered to the store.
+     */
+    virtual void CloseFile()
+    {
+        if (mpStoreBuffer)
+        {
+            this->mpOutStream->flush();
+            this->mpOutStream.reset();
+            mpStoreBuffer.reset();
+        }
+        else
+        {
+            CHASTE_WRITER::CloseFile();
+        }
+    }
+};
+
+/** The Chaste cell writers used by PaperVertexSimulation, for putting in a results store. */
+typedef ResultsStoreWriter<CellAgesWriter<2,2> > StoredCellAgesWriter;
+/** @copydoc StoredCellAgesWriter */
+typedef ResultsStoreWriter<CellProliferativePhasesWriter<2,2> > StoredCellProliferativePhasesWriter;
+/** @copydoc StoredCellAgesWriter */
+typedef ResultsStoreWriter<CellProliferativeTypesWriter<2,2> > StoredCellProliferativeTypesWriter;
+
+/** The Chaste population writers that a vertex population adds by default, for putting in a results store. */
+typedef ResultsStoreWriter<NodeLocationWriter<2,2> > StoredNodeLocationWriter;
+/** @copydoc StoredNodeLocationWriter */
+typedef ResultsStoreWriter<BoundaryNodeWriter<2,2> > StoredBoundaryNodeWriter;
+/** @copydoc StoredNodeLocationWriter */
+typedef ResultsStoreWriter<CellPopulationElementWriter<2,2> > StoredCellPopulationElementWriter;
+/** @copydoc StoredNodeLocationWriter */
+typedef ResultsStoreWriter<VertexT1SwapLocationsWriter<2,2> > StoredVertexT1SwapLocationsWriter;
+/** @copydoc StoredNodeLocationWriter */
+typedef ResultsStoreWriter<VertexT2SwapLocationsWriter<2,2> > StoredVertexT2SwapLocationsWriter;
+/** @copydoc StoredNodeLocationWriter */
+typedef ResultsStoreWriter<VertexT3SwapLocationsWriter<2,2> > StoredVertexT3SwapLocationsWriter;
+/** @copydoc StoredNodeLocationWriter */
+typedef ResultsStoreWriter<VertexIntersectionSwapLocationsWriter<2,2> > StoredVertexIntersectionSwapLocationsWriter;
+
+#include "SerializationExportWrapper.hpp"
+CHASTE_CLASS_EXPORT(StoredCellAgesWriter)
+CHASTE_CLASS_EXPORT(StoredCellProliferativePhasesWriter)
+CHASTE_CLASS_EXPORT(StoredCellProliferativeTypesWriter)
+CHASTE_CLASS_EXPORT(StoredNodeLocationWriter)
+CHASTE_CLASS_EXPORT(StoredBoundaryNodeWriter)
+CHASTE_CLASS_EXPORT(StoredCellPopulationElementWriter)
+CHASTE_CLASS_EXPORT(StoredVertexT1SwapLocationsWriter)
+CHASTE_CLASS_EXPORT(StoredVertexT2SwapLocationsWriter)
+CHASTE_CLASS_EXPORT(StoredVertexT3SwapLocationsWriter)
+CHASTE_CLASS_EXPORT(StoredVertexIntersectionSwapLocationsWriter)
+
+#endif /*RESULTSSTOREWRITER_HPP_*/
@@ -0,0 +1,181 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "RunManifest.hpp"
+#include "BufferedTextEmitter.hpp"
+#include "Exception.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <unistd.h>
+#include <zlib.h>
+
+const std::string RunManifest::FILE_NAME = "RunComplete.manifest";
+
+namespace
+{
+    /**
+     * @param rPath the path of a file
+     * @return the size and CRC-32 checksum of the file, as "<size> <crc in hex>"
+     */
+    std::string GetFileChecksum(const std::filesystem::path& rPath)
+    {
+        std::ifstream file(rPath, std::ios::binary);
+        if (!file.is_open())
+        {
+            EXCEPTION("Could not open " << rPath.string() << " to checksum it");
+        }
+
+        uLong crc = crc32(0L, Z_NULL, 0);
+        unsigned long long size = 0;
+        std::vector<char> buffer(1u << 16);
+        while (file)
+        {
+            file.read(buffer.data(), buffer.size());
+            std::streamsize num_read = file.gcount();
+            crc = crc32(crc, reinterpret_cast<const Bytef*>(buffer.data()), num_read);
+            size += num_read;
+        }
+
+        std::ostringstream checksum;
+        checksum << size << ' ' << std::hex << std::setw(8) << std::setfill('0') << crc;
+        return checksum.str();
+    }
+
+    /**
+     * @param rOutputDirectory the full path of a run's output directory
+     * @return the size and checksum of each file in the directory (other than the manifest), by relative path
+     */
+    std::map<std::string, std::string> GetChecksums(const std::string& rOutputDirectory)
+    {
+        std::map<std::string, std::string> checksums;
+        for (const std::filesystem::directory_entry& r_entry : std::filesystem::recursive_directory_iterator(rOutputDirectory))
+        {
+            std::string relative_path = std::filesystem::relative(r_entry.path(), rOutputDirectory).string();
+            if (r_entry.is_regular_file() && relative_path.compare(0, RunManifest::FILE_NAME.size(), RunManifest::FILE_NAME) != 0)
+            {
+                checksums[relative_path] = GetFileChecksum(r_entry.path());
+            }
+        }
+        return checksums;
+    }
+}
+
+bool RunManifest::Exists(const std::string& rOutputDirectory)
+{
+    return std::filesystem::is_regular_file(rOutputDirectory + FILE_NAME);
+}
+
+void RunManifest::Write(const std::string& rOutputDirectory, const SweepTask& rTask, double wallTime,
+                        const std::string& rStatistics)
+{
+    std::map<std::string, std::string> checksums = GetChecksums(rOutputDirectory);
+
+    BufferedTextEmitter manifest;
+    manifest.SetUseShortestRoundTrip(true);
+    manifest << "Name=" << rTask.GetName() << '\n'
+             << "Lambda=" << rTask.mLambda << '\n'
+             << "Gamma=" << rTask.mGamma << '\n'
+             << "Simulation=" << rTask.mSimulation << '\n'
+             << "Run=" << rTask.mRun << '\n'
+             << "Seed=" << rTask.mSeed << '\n'
+             << "WallTime=" << wallTime << '\n'
+             << "Statistics=" << rStatistics << '\n';
+    for (std::map<std::string, std::string>::iterator iter = checksums.begin(); iter != checksums.end(); ++iter)
+    {
+        manifest << "File:" << iter->first << '=' << iter->second << '\n';
+    }
+
+    // Write to a temporary file, sync it and rename it into place, so the manifest appears all at once
+    std::string temporary_path = rOutputDirectory + FILE_NAME + ".tmp" + std::to_string(getpid());
+    FILE* p_file = std::fopen(temporary_path.c_str(), "w");
+    if (p_file == nullptr)
+    {
+        EXCEPTION("Could not write run manifest " << temporary_path);
+    }
+    const std::string& r_contents = manifest.GetString();
+    bool written = std::fwrite(r_contents.data(), 1, r_contents.size(), p_file) == r_contents.size()
+                   && std::fflush(p_file) == 0
+                   && fsync(fileno(p_file)) == 0;
+    std::fclose(p_file);
+
+    if (!written || std::rename(temporary_path.c_str(), (rOutputDirectory + FILE_NAME).c_str()) != 0)
+    {
+        std::remove(temporary_path.c_str());
+        EXCEPTION("Could not write run manifest " << rOutputDirectory + FILE_NAME);
+    }
+}
+
+std::map<std::string, std::string> RunManifest::Read(const std::string& rOutputDirectory)
+{
+    std::ifstream file((rOutputDirectory + FILE_NAME).c_str());
+    if (!file.is_open())
+    {
+        EXCEPTION("No run manifest in " << rOutputDirectory);
+    }
+
+    std::map<std::string, std::string> entries;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::size_t separator = line.find('=');
+        if (separator != std::string::npos)
+        {
+            entries[line.substr(0, separator)] = line.substr(separator + 1);
+        }
+    }
+    return entries;
+}
+
+bool RunManifest::Verify(const std::string& rOutputDirectory)
+{
+    std::map<std::string, std::string> entries = Read(rOutputDirectory);
+    for (std::map<std::string, std::string>::iterator iter = entries.begin(); iter != entries.end(); ++iter)
+    {
+        if (iter->first.compare(0, 5, "File:") == 0)
+        {
+            std::filesystem::path path = rOutputDirectory + iter->first.substr(5);
+            if (!std::filesystem::is_regular_file(path) || GetFileChecksum(path) != iter->second)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
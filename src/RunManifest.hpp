@@ -0,0 +1,97 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef RUNMANIFEST_HPP_
+#define RUNMANIFEST_HPP_
+
+#include <map>
+#include <string>
+#include "SweepTask.hpp"
+
+/**
+ * The completion record of one run of a sweep, kept as a small text file,
+ * RunComplete.manifest, in the run's output directory.
+ *
+ * The manifest is written only once the run has finished, and atomically: it is
+ * written to a temporary file, synced to disk and then renamed into place, so a
+ * manifest is either complete or absent, even if the run is killed while writing
+ * it. It holds the run's parameters and seed, its wall time, its summary
+ * statistics, and the size and CRC-32 checksum of every file in the output
+ * directory, so that damaged or partial output can be told apart from good output.
+ *
+ * Sweep drivers use Exists() to skip runs that have already finished.
+ */
+class RunManifest
+{
+public:
+
+    /** The file name of the manifest. */
+    static const std::string FILE_NAME;
+
+    /**
+     * @param rOutputDirectory the full path of a run's output directory, ending in '/'
+     * @return whether the run has a manifest
+     */
+    static bool Exists(const std::string& rOutputDirectory);
+
+    /**
+     * Write the manifest of a finished run.
+     *
+     * @param rOutputDirectory the full path of the run's output directory, ending in '/'
+     * @param rTask the run
+     * @param wallTime the wall time taken by the run, in seconds
+     * @param rStatistics the summary statistics of the run, as a string
+     */
+    static void Write(const std::string& rOutputDirectory, const SweepTask& rTask, double wallTime,
+                      const std::string& rStatistics);
+
+    /**
+     * Read a manifest.
+     *
+     * @param rOutputDirectory the full path of the run's output directory, ending in '/'
+     * @return the entries of the manifest by key; checksums have keys "File:<relative path>"
+     */
+    static std::map<std::string, std::string> Read(const std::string& rOutputDirectory);
+
+    /**
+     * Check the files in a run's output directory against the checksums in its manifest.
+     *
+     * @param rOutputDirectory the full path of the run's output directory, ending in '/'
+     * @return whether every file in the manifest is present and unchanged
+     */
+    static bool Verify(const std::string& rOutputDirectory);
+};
+
+#endif /*RUNMANIFEST_HPP_*/
@@ -0,0 +1,140 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "RunTruncationMarker.hpp"
+#include "BufferedTextEmitter.hpp"
+#include "Exception.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <unistd.h>
+
+const std::string RunTruncationMarker::FILE_NAME = "RunTruncated.marker";
+
+RunTruncationMarker::RunTruncationMarker()
+    : mTime(0.0),
+      mEndTime(0.0),
+      mWallTime(0.0),
+      mTimeSteps(0u),
+      mNumCells(0u)
+{
+}
+
+std::string RunTruncationMarker::GetDescription() const
+{
+    BufferedTextEmitter description(256);
+    description.SetUseShortestRoundTrip(true);
+    description << mReason << " budget used up at time " << mTime << " of " << mEndTime
+                << ", after " << mTimeSteps << " time steps and " << mWallTime << " s, with "
+                << mNumCells << " cells";
+    return description.GetString();
+}
+
+void RunTruncationMarker::Write(const std::string& rOutputDirectory) const
+{
+    BufferedTextEmitter marker(512);
+    marker.SetUseShortestRoundTrip(true);
+    marker << "Reason=" << mReason << '\n'
+           << "Time=" << mTime << '\n'
+           << "EndTime=" << mEndTime << '\n'
+           << "WallTime=" << mWallTime << '\n'
+           << "TimeSteps=" << mTimeSteps << '\n'
+           << "NumCells=" << mNumCells << '\n';
+
+    // As for RunManifest, write to a temporary file, sync it and rename it into place
+    std::string temporary_path = rOutputDirectory + FILE_NAME + ".tmp" + std::to_string(getpid());
+    FILE* p_file = std::fopen(temporary_path.c_str(), "w");
+    if (p_file == nullptr)
+    {
+        EXCEPTION("Could not write truncation marker " << temporary_path);
+    }
+    const std::string& r_contents = marker.GetString();
+    bool written = std::fwrite(r_contents.data(), 1, r_contents.size(), p_file) == r_contents.size()
+                   && std::fflush(p_file) == 0
+                   && fsync(fileno(p_file)) == 0;
+    std::fclose(p_file);
+
+    if (!written || std::rename(temporary_path.c_str(), (rOutputDirectory + FILE_NAME).c_str()) != 0)
+    {
+        std::remove(temporary_path.c_str());
+        EXCEPTION("Could not write truncation marker " << rOutputDirectory + FILE_NAME);
+    }
+}
+
+bool RunTruncationMarker::Exists(const std::string& rOutputDirectory)
+{
+    return std::filesystem::is_regular_file(rOutputDirectory + FILE_NAME);
+}
+
+RunTruncationMarker RunTruncationMarker::Read(const std::string& rOutputDirectory)
+{
+    std::ifstream file((rOutputDirectory + FILE_NAME).c_str());
+    if (!file.is_open())
+    {
+        EXCEPTION("No truncation marker in " << rOutputDirectory);
+    }
+
+    std::map<std::string, std::string> entries;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::size_t separator = line.find('=');
+        if (separator != std::string::npos)
+        {
+            entries[line.substr(0, separator)] = line.substr(separator + 1);
+        }
+    }
+    if (entries.count("Reason") == 0u || entries.count("Time") == 0u)
+    {
+        EXCEPTION("The truncation marker in " << rOutputDirectory << " has no reason or time");
+    }
+
+    RunTruncationMarker marker;
+    marker.mReason = entries["Reason"];
+    marker.mTime = std::strtod(entries["Time"].c_str(), nullptr);
+    marker.mEndTime = std::strtod(entries["EndTime"].c_str(), nullptr);
+    marker.mWallTime = std::strtod(entries["WallTime"].c_str(), nullptr);
+    marker.mTimeSteps = (unsigned)std::strtoul(entries["TimeSteps"].c_str(), nullptr, 10);
+    marker.mNumCells = (unsigned)std::strtoul(entries["NumCells"].c_str(), nullptr, 10);
+    return marker;
+}
+
+void RunTruncationMarker::Remove(const std::string& rOutputDirectory)
+{
+    std::filesystem::remove(rOutputDirectory + FILE_NAME);
+}
@@ -0,0 +1,112 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef RUNTRUNCATIONMARKER_HPP_
+#define RUNTRUNCATIONMARKER_HPP_
+
+#include <string>
+
+/**
+ * Marks a run that stopped before its end time because it used up its budget
+ * of wall-clock time or time steps (see BudgetedOffLatticeSimulation), kept as
+ * a small text file, RunTruncated.marker, in the run's output directory.
+ *
+ * The marker records why the run stopped and the time of the checkpoint it
+ * left behind, from which it can be resumed. Like SimulationFailureRecord, it
+ * is written atomically, one "Key=value" entry per line.
+ */
+struct RunTruncationMarker
+{
+    /** The file name of the marker. */
+    static const std::string FILE_NAME;
+
+    /** Which budget was used up: "WallTime" or "TimeSteps". */
+    std::string mReason;
+
+    /** The simulation time at which the run stopped, i.e. the time of its checkpoint. */
+    double mTime;
+
+    /** The end time the run was heading for. */
+    double mEndTime;
+
+    /** The wall-clock time taken by the attempt, in seconds. */
+    double mWallTime;
+
+    /** The number of time steps taken by the attempt. */
+    unsigned mTimeSteps;
+
+    /** The number of cells at the time. */
+    unsigned mNumCells;
+
+    /**
+     * Default constructor. The reason is empty and the numbers are zero.
+     */
+    RunTruncationMarker();
+
+    /**
+     * @return a one-line description, for error messages and logs
+     */
+    std::string GetDescription() const;
+
+    /**
+     * Write the marker to a run's output directory, replacing any earlier one.
+     *
+     * @param rOutputDirectory the full path of the run's output directory, ending in '/'
+     */
+    void Write(const std::string& rOutputDirectory) const;
+
+    /**
+     * @param rOutputDirectory the full path of a run's output directory, ending in '/'
+     * @return whether the run has a truncation marker
+     */
+    static bool Exists(const std::string& rOutputDirectory);
+
+    /**
+     * Read the marker of a run.
+     *
+     * @param rOutputDirectory the full path of the run's output directory, ending in '/'
+     * @return the marker
+     */
+    static RunTruncationMarker Read(const std::string& rOutputDirectory);
+
+    /**
+     * Remove the marker of a run, if there is one, e.g. once it has been run to the end.
+     *
+     * @param rOutputDirectory the full path of the run's output directory, ending in '/'
+     */
+    static void Remove(const std::string& rOutputDirectory);
+};
+
+#endif /*RUNTRUNCATIONMARKER_HPP_*/
@@ -0,0 +1,144 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "SemiImplicitVertexNumericalMethod.hpp"
+
+#include <algorithm>
+
+SemiImplicitVertexNumericalMethod::SemiImplicitVertexNumericalMethod()
+    : AbstractAdaptiveNumericalMethod<2,2>(),
+      mHaveStartForces(false)
+{
+}
+
+SemiImplicitVertexNumericalMethod::~SemiImplicitVertexNumericalMethod()
+{
+}
+
+void SemiImplicitVertexNumericalMethod::ComputeForcesAndStiffness(std::vector<c_vector<double, 2> >& rForces,
+                                                                  std::vector<double>& rStiffness)
+{
+    rForces = ComputeForces();
+
+    const std::vector<double>& r_stiffness = mpForce->rGetVertexStiffness();
+    rStiffness.resize(3*rForces.size());
+    unsigned index = 0;
+    for (AbstractMesh<2,2>::NodeIterator node_iter = mpCellPopulation->rGetMesh().GetNodeIteratorBegin();
+         node_iter != mpCellPopulation->rGetMesh().GetNodeIteratorEnd();
+         ++node_iter, ++index)
+    {
+        unsigned node_index = node_iter->GetIndex();
+        double damping = mpCellPopulation->GetDampingConstant(node_index);
+        for (unsigned component=0; component<3; component++)
+        {
+            rStiffness[3*index + component] = r_stiffness[3*node_index + component]/damping;
+        }
+    }
+}
+
+void SemiImplicitVertexNumericalMethod::BeginTimeStep()
+{
+    if (!mpForce)
+    {
+        for (unsigned force_index=0; force_index<mpForceCollection->size() && !mpForce; force_index++)
+        {
+            mpForce = boost::dynamic_pointer_cast<FasterFarhadifarForce<2> >((*mpForceCollection)[force_index]);
+        }
+        if (!mpForce)
+        {
+            EXCEPTION("SemiImplicitVertexNumericalMethod needs a FasterFarhadifarForce");
+        }
+        mpForce->SetCalculateStiffness(true);
+    }
+
+    // The mesh may have been remeshed and the target areas changed since the last time step
+    mHaveStartForces = false;
+}
+
+double SemiImplicitVertexNumericalMethod::AttemptSubstep(double substep)
+{
+    if (!mHaveStartForces)
+    {
+        ComputeForcesAndStiffness(mStartForces, mStartStiffness);
+        mHaveStartForces = true;
+    }
+
+    unsigned num_nodes = mSubstepStartLocations.size();
+    std::vector<c_vector<double, 2> > locations(num_nodes);
+    for (unsigned index=0; index<num_nodes; index++)
+    {
+        // Solve (I + h S) dx = h F by Cramer's rule; S is positive semi-definite, so the determinant is at least 1
+        double a = 1.0 + substep*mStartStiffness[3*index];
+        double b = substep*mStartStiffness[3*index + 1];
+        double d = 1.0 + substep*mStartStiffness[3*index + 2];
+        double f_x = substep*mStartForces[index][0];
+        double f_y = substep*mStartForces[index][1];
+        double determinant = a*d - b*b;
+
+        locations[index] = mSubstepStartLocations[index];
+        locations[index][0] += (d*f_x - b*f_y)/determinant;
+        locations[index][1] += (a*f_y - b*f_x)/determinant;
+    }
+    SetNodeLocations(locations);
+
+    ComputeForcesAndStiffness(mNewForces, mNewStiffness);
+
+    double max_error = 0.0;
+    for (unsigned index=0; index<num_nodes; index++)
+    {
+        // Comparing this way round lets a NaN through, so that the sub-step is rejected
+        double norm = 0.5*substep*norm_2(mNewForces[index] - mStartForces[index]);
+        if (!(norm <= max_error))
+        {
+            max_error = norm;
+        }
+    }
+    return max_error;
+}
+
+void SemiImplicitVertexNumericalMethod::AcceptSubstep()
+{
+    std::swap(mStartForces, mNewForces);
+    std::swap(mStartStiffness, mNewStiffness);
+}
+
+unsigned SemiImplicitVertexNumericalMethod::GetErrorOrder() const
+{
+    return 1u;
+}
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+CHASTE_CLASS_EXPORT(SemiImplicitVertexNumericalMethod)
@@ -0,0 +1,152 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef SEMIIMPLICITVERTEXNUMERICALMETHOD_HPP_
+#define SEMIIMPLICITVERTEXNUMERICALMETHOD_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+#include <boost/shared_ptr.hpp>
+#include "AbstractAdaptiveNumericalMethod.hpp"
+#include "FasterFarhadifarForce.hpp"
+
+/**
+ * An adaptive, linearly implicit Euler method for vertex simulations with a
+ * FasterFarhadifarForce.
+ *
+ * Each vertex moves by
+ *
+ *   dx = (I + (h/eta) S)^{-1} h F/eta,
+ *
+ * where F is the total force on it, eta its damping constant and S its 2x2
+ * stiffness from FarhadifarForceKernel: the positive semi-definite part of the
+ * block of the energy's Hessian belonging to the vertex by itself. Treating
+ * this part implicitly damps the stiff motion of vertices on short edges,
+ * which is what limits the forward Euler time step, at the cost of solving a
+ * 2x2 system per vertex. Other forces are treated explicitly.
+ *
+ * The method is first order, and the error of a sub-step is estimated as
+ * h/2 |F_new - F_old|/eta, the difference from a trapezoidal step; the forces
+ * at the new locations are those of the next sub-step, so a sub-step costs one
+ * force calculation.
+ */
+class SemiImplicitVertexNumericalMethod : public AbstractAdaptiveNumericalMethod<2,2>
+{
+private:
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Serialize the object and its member variables.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractAdaptiveNumericalMethod<2,2> >(*this);
+    }
+
+    /** The Farhadifar force in the force collection, found by BeginTimeStep(). */
+    boost::shared_ptr<FasterFarhadifarForce<2> > mpForce;
+
+    /** The forces at mSubstepStartLocations, in node iterator order. */
+    std::vector<c_vector<double, 2> > mStartForces;
+
+    /** The xx, xy and yy stiffness divided by the damping constant at mSubstepStartLocations, in node iterator order. */
+    std::vector<double> mStartStiffness;
+
+    /** The forces at the locations of the last attempted sub-step. */
+    std::vector<c_vector<double, 2> > mNewForces;
+
+    /** The stiffness divided by the damping constant at the locations of the last attempted sub-step. */
+    std::vector<double> mNewStiffness;
+
+    /** Whether mStartForces and mStartStiffness are up to date. */
+    bool mHaveStartForces;
+
+    /**
+     * Calculate the forces and stiffnesses at the current node locations.
+     *
+     * @param rForces filled in with the force on each node divided by its damping constant
+     * @param rStiffness filled in with the stiffness of each node divided by its damping constant
+     */
+    void ComputeForcesAndStiffness(std::vector<c_vector<double, 2> >& rForces, std::vector<double>& rStiffness);
+
+protected:
+
+    /**
+     * Overridden BeginTimeStep() method.
+     */
+    virtual void BeginTimeStep();
+
+    /**
+     * Overridden AttemptSubstep() method.
+     *
+     * @param substep the length of the sub-step
+     * @return the largest norm of the error estimate over the nodes
+     */
+    virtual double AttemptSubstep(double substep);
+
+    /**
+     * Overridden AcceptSubstep() method.
+     */
+    virtual void AcceptSubstep();
+
+    /**
+     * Overridden GetErrorOrder() method.
+     *
+     * @return 1
+     */
+    virtual unsigned GetErrorOrder() const;
+
+public:
+
+    /**
+     * Constructor.
+     */
+    SemiImplicitVertexNumericalMethod();
+
+    /**
+     * Destructor.
+     */
+    virtual ~SemiImplicitVertexNumericalMethod();
+};
+
+#include "SerializationExportWrapper.hpp"
+CHASTE_CLASS_EXPORT(SemiImplicitVertexNumericalMethod)
+
+#endif /*SEMIIMPLICITVERTEXNUMERICALMETHOD_HPP_*/
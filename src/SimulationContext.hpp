@@ -0,0 +1,86 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef SIMULATIONCONTEXT_HPP_
+#define SIMULATIONCONTEXT_HPP_
+
+#include <mutex>
+
+/**
+ * Sets up, and tears down again, the global state used by a single tissue
+ * simulation: SimulationTime, RandomNumberGenerator, CellCycleTimesGenerator,
+ * CellPropertyRegistry and the cell ID counter. This does for one simulation
+ * what AbstractCellBasedTestSuite does for one test, so that a program can run
+ * many simulations one after the other without state leaking between them.
+ *
+ * These objects are process-wide singletons in Chaste, and their Instance()
+ * methods cannot be redirected to per-thread instances from a user project. A
+ * SimulationContext therefore holds a process-wide lock for its lifetime:
+ * simulations started on different threads of one process are run one at a
+ * time, safely, rather than corrupting each other's state. To run tissues
+ * concurrently use SimulationWorkerPool, which gives each simulation its own
+ * copy of the singletons in a forked worker process.
+ */
+class SimulationContext
+{
+private:
+
+    /**
+     * @return the lock shared by all contexts in this process
+     */
+    static std::mutex& rGetProcessMutex();
+
+    /** Holds the process-wide lock while this context exists. */
+    std::unique_lock<std::mutex> mLock;
+
+public:
+
+    /**
+     * Constructor. Waits until no other context exists, then resets the
+     * singletons: simulation time starts at zero, RandomNumberGenerator and
+     * CellCycleTimesGenerator are seeded with randomSeed, and the cell
+     * property registry and cell IDs are cleared.
+     *
+     * @param randomSeed the random seed for the simulation
+     */
+    SimulationContext(unsigned randomSeed);
+
+    /**
+     * Destructor. Destroys the singletons so that the next context starts afresh.
+     */
+    ~SimulationContext();
+};
+
+#endif /*SIMULATIONCONTEXT_HPP_*/
@@ -0,0 +1,148 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "SimulationFailureRecord.hpp"
+#include "BufferedTextEmitter.hpp"
+#include "Exception.hpp"
+
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <unistd.h>
+
+const std::string SimulationFailureRecord::FILE_NAME = "RunFailure.record";
+
+SimulationFailureRecord::SimulationFailureRecord()
+    : mTime(0.0),
+      mTimeStep(0u),
+      mValue(0.0),
+      mLimit(0.0),
+      mIndex(UINT_MAX),
+      mNumCells(0u)
+{
+}
+
+std::string SimulationFailureRecord::GetDescription() const
+{
+    BufferedTextEmitter description(256);
+    description.SetUseShortestRoundTrip(true);
+    description << mReason << " at time " << mTime << " (step " << mTimeStep << "): "
+                << mValue << " passed the limit " << mLimit;
+    if (mIndex != UINT_MAX)
+    {
+        description << " at index " << mIndex;
+    }
+    description << ", with " << mNumCells << " cells";
+    return description.GetString();
+}
+
+void SimulationFailureRecord::Write(const std::string& rOutputDirectory) const
+{
+    BufferedTextEmitter record(512);
+    record.SetUseShortestRoundTrip(true);
+    record << "Reason=" << mReason << '\n'
+           << "Time=" << mTime << '\n'
+           << "TimeStep=" << mTimeStep << '\n'
+           << "Value=" << mValue << '\n'
+           << "Limit=" << mLimit << '\n'
+           << "Index=" << mIndex << '\n'
+           << "NumCells=" << mNumCells << '\n';
+
+    // As for RunManifest, write to a temporary file, sync it and rename it into place
+    std::string temporary_path = rOutputDirectory + FILE_NAME + ".tmp" + std::to_string(getpid());
+    FILE* p_file = std::fopen(temporary_path.c_str(), "w");
+    if (p_file == nullptr)
+    {
+        EXCEPTION("Could not write failure record " << temporary_path);
+    }
+    const std::string& r_contents = record.GetString();
+    bool written = std::fwrite(r_contents.data(), 1, r_contents.size(), p_file) == r_contents.size()
+                   && std::fflush(p_file) == 0
+                   && fsync(fileno(p_file)) == 0;
+    std::fclose(p_file);
+
+    if (!written || std::rename(temporary_path.c_str(), (rOutputDirectory + FILE_NAME).c_str()) != 0)
+    {
+        std::remove(temporary_path.c_str());
+        EXCEPTION("Could not write failure record " << rOutputDirectory + FILE_NAME);
+    }
+}
+
+bool SimulationFailureRecord::Exists(const std::string& rOutputDirectory)
+{
+    return std::filesystem::is_regular_file(rOutputDirectory + FILE_NAME);
+}
+
+SimulationFailureRecord SimulationFailureRecord::Read(const std::string& rOutputDirectory)
+{
+    std::ifstream file((rOutputDirectory + FILE_NAME).c_str());
+    if (!file.is_open())
+    {
+        EXCEPTION("No failure record in " << rOutputDirectory);
+    }
+
+    std::map<std::string, std::string> entries;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::size_t separator = line.find('=');
+        if (separator != std::string::npos)
+        {
+            entries[line.substr(0, separator)] = line.substr(separator + 1);
+        }
+    }
+    if (entries.count("Reason") == 0u)
+    {
+        EXCEPTION("The failure record in " << rOutputDirectory << " has no reason");
+    }
+
+    SimulationFailureRecord record;
+    record.mReason = entries["Reason"];
+    record.mTime = std::strtod(entries["Time"].c_str(), nullptr);
+    record.mTimeStep = (unsigned)std::strtoul(entries["TimeStep"].c_str(), nullptr, 10);
+    record.mValue = std::strtod(entries["Value"].c_str(), nullptr);
+    record.mLimit = std::strtod(entries["Limit"].c_str(), nullptr);
+    record.mIndex = (unsigned)std::strtoul(entries["Index"].c_str(), nullptr, 10);
+    record.mNumCells = (unsigned)std::strtoul(entries["NumCells"].c_str(), nullptr, 10);
+    return record;
+}
+
+void SimulationFailureRecord::Remove(const std::string& rOutputDirectory)
+{
+    std::filesystem::remove(rOutputDirectory + FILE_NAME);
+}
@@ -0,0 +1,119 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef SIMULATIONFAILURERECORD_HPP_
+#define SIMULATIONFAILURERECORD_HPP_
+
+#include <string>
+
+/**
+ * Why and when a simulation was stopped because its state had become
+ * non-physical (see DivergenceDetectionModifier), kept as a small text file,
+ * RunFailure.record, in the run's output directory.
+ *
+ * Like RunManifest, the record is written atomically, one "Key=value" entry
+ * per line, so that it is either complete or absent. Sweep drivers use
+ * Exists() to skip runs that diverged in an earlier attempt.
+ */
+struct SimulationFailureRecord
+{
+    /** The file name of the record. */
+    static const std::string FILE_NAME;
+
+    /**
+     * What was detected: "NonFiniteLocation", "CollapsedElement",
+     * "VertexSpeed", "SubstepFloor" or "T2SwapRate".
+     */
+    std::string mReason;
+
+    /** The simulation time at which it was detected. */
+    double mTime;
+
+    /** The number of time steps taken by then. */
+    unsigned mTimeStep;
+
+    /** The offending value, e.g. the area of the collapsed element. */
+    double mValue;
+
+    /** The limit that the value passed. */
+    double mLimit;
+
+    /** The index of the offending element or node, or UINT_MAX if there is none. */
+    unsigned mIndex;
+
+    /** The number of cells at the time. */
+    unsigned mNumCells;
+
+    /**
+     * Default constructor. The reason is empty and the numbers are zero,
+     * except for mIndex, which is UINT_MAX.
+     */
+    SimulationFailureRecord();
+
+    /**
+     * @return a one-line description, for error messages and logs
+     */
+    std::string GetDescription() const;
+
+    /**
+     * Write the record to a run's output directory, replacing any earlier one.
+     *
+     * @param rOutputDirectory the full path of the run's output directory, ending in '/'
+     */
+    void Write(const std::string& rOutputDirectory) const;
+
+    /**
+     * @param rOutputDirectory the full path of a run's output directory, ending in '/'
+     * @return whether the run has a failure record
+     */
+    static bool Exists(const std::string& rOutputDirectory);
+
+    /**
+     * Read the record of a run.
+     *
+     * @param rOutputDirectory the full path of the run's output directory, ending in '/'
+     * @return the record
+     */
+    static SimulationFailureRecord Read(const std::string& rOutputDirectory);
+
+    /**
+     * Remove the record of a run, if there is one, e.g. before running it again.
+     *
+     * @param rOutputDirectory the full path of the run's output directory, ending in '/'
+     */
+    static void Remove(const std::string& rOutputDirectory);
+};
+
+#endif /*SIMULATIONFAILURERECORD_HPP_*/
@@ -0,0 +1,226 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "SimulationWorkerPool.hpp"
+#include "Exception.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <thread>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+    /** Exit status of a child whose task threw. */
+    const int TASK_FAILED = 1;
+
+    /**
+     * Write all of a string to a file descriptor.
+     *
+     * @param fileDescriptor the file descriptor
+     * @param rData the string
+     */
+    void WriteAll(int fileDescriptor, const std::string& rData)
+    {
+        std::size_t written = 0;
+        while (written < rData.size())
+        {
+            ssize_t n = write(fileDescriptor, rData.data() + written, rData.size() - written);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                return;
+            }
+            written += n;
+        }
+    }
+}
+
+SimulationWorkerPool::SimulationWorkerPool(unsigned numWorkers)
+    : mNumWorkers(numWorkers)
+{
+    if (mNumWorkers == 0)
+    {
+        mNumWorkers = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+unsigned SimulationWorkerPool::GetNumWorkers() const
+{
+    return mNumWorkers;
+}
+
+std::vector<SimulationWorkerPool::Result> SimulationWorkerPool::Run(unsigned numTasks, boost::function<std::string (unsigned)> task)
+{
+    std::vector<Result> results(numTasks);
+
+    /** A running child: its task index, process ID and the read end of its pipe. */
+    struct Child
+    {
+        unsigned mTask;
+        pid_t mPid;
+        int mPipe;
+    };
+    std::vector<Child> children;
+    unsigned next_task = 0;
+
+    while (next_task < numTasks || !children.empty())
+    {
+        // Start tasks until all workers are busy
+        while (next_task < numTasks && children.size() < mNumWorkers)
+        {
+            int pipe_ends[2];
+            if (pipe(pipe_ends) != 0)
+            {
+                EXCEPTION("Could not create a pipe for a simulation worker");
+            }
+
+            // Otherwise anything buffered would be written by both processes
+            std::cout.flush();
+            std::cerr.flush();
+            fflush(nullptr);
+
+            pid_t pid = fork();
+            if (pid < 0)
+            {
+                close(pipe_ends[0]);
+                close(pipe_ends[1]);
+                EXCEPTION("Could not fork a simulation worker");
+            }
+
+            if (pid == 0)
+            {
+                close(pipe_ends[0]);
+                int status = 0;
+                try
+                {
+                    WriteAll(pipe_ends[1], task(next_task));
+                }
+                catch (Exception& e)
+                {
+                    WriteAll(pipe_ends[1], e.GetMessage());
+                    status = TASK_FAILED;
+                }
+                catch (std::exception& e)
+                {
+                    WriteAll(pipe_ends[1], e.what());
+                    status = TASK_FAILED;
+                }
+                catch (...)
+                {
+                    // Nothing may escape the child, or it would carry on running the parent's code
+                    WriteAll(pipe_ends[1], "Task threw an unknown exception");
+                    status = TASK_FAILED;
+                }
+                close(pipe_ends[1]);
+                std::cout.flush();
+                std::cerr.flush();
+                fflush(nullptr);
+                _exit(status);
+            }
+
+            close(pipe_ends[1]);
+            Child child = {next_task, pid, pipe_ends[0]};
+            children.push_back(child);
+            next_task++;
+        }
+
+        // Read whatever the children have sent; a child is finished when its pipe is closed
+        std::vector<pollfd> poll_fds(children.size());
+        for (unsigned i=0; i<children.size(); i++)
+        {
+            poll_fds[i].fd = children[i].mPipe;
+            poll_fds[i].events = POLLIN;
+            poll_fds[i].revents = 0;
+        }
+        if (poll(poll_fds.data(), poll_fds.size(), -1) < 0 && errno != EINTR)
+        {
+            EXCEPTION("Could not wait for the simulation workers");
+        }
+
+        for (unsigned i=children.size(); i-- > 0; )
+        {
+            if (poll_fds[i].revents == 0)
+            {
+                continue;
+            }
+
+            char buffer[4096];
+            ssize_t n = read(children[i].mPipe, buffer, sizeof(buffer));
+            if (n > 0)
+            {
+                results[children[i].mTask].mOutput.append(buffer, n);
+            }
+            else if (n == 0 || errno != EINTR)
+            {
+                close(children[i].mPipe);
+
+                int status = 0;
+                pid_t waited;
+                while ((waited = waitpid(children[i].mPid, &status, 0)) < 0 && errno == EINTR)
+                {
+                }
+
+                Result& r_result = results[children[i].mTask];
+                if (waited < 0)
+                {
+                    // We cannot tell how the child ended, so its output cannot be trusted
+                    r_result.mSucceeded = false;
+                    r_result.mOutput = "Could not wait for worker";
+                }
+                else
+                {
+                    r_result.mSucceeded = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+                    if (!r_result.mSucceeded && r_result.mOutput.empty())
+                    {
+                        r_result.mOutput = WIFSIGNALED(status) ? "Worker killed by signal " + std::to_string(WTERMSIG(status))
+                                                               : "Worker failed";
+                    }
+                }
+                children.erase(children.begin() + i);
+            }
+        }
+    }
+
+    return results;
+}
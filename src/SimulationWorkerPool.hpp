@@ -0,0 +1,102 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef SIMULATIONWORKERPOOL_HPP_
+#define SIMULATIONWORKERPOOL_HPP_
+
+#include <string>
+#include <vector>
+#include <boost/function.hpp>
+
+/**
+ * Runs many independent simulations concurrently from one process.
+ *
+ * Each task is run in a child process forked from the calling process, with at
+ * most GetNumWorkers() children alive at a time. A forked child starts with a
+ * copy-on-write view of everything the parent has already set up (PETSc, loaded
+ * meshes or data files, ...), so there is no per-run program start-up, read-only
+ * data are shared between the children, and each child gets its own copy of the
+ * Chaste singletons (see SimulationContext) without any changes to Chaste.
+ *
+ * A task returns a string (e.g. TissueSummaryStatistics::ToString()), which is
+ * sent back to the parent through a pipe. Tasks must not use MPI: children are
+ * not part of the parent's communicator. Children leave with _exit(), so they
+ * do not run the parent's exit handlers (e.g. PETSc finalisation).
+ */
+class SimulationWorkerPool
+{
+public:
+
+    /** The outcome of one task. */
+    struct Result
+    {
+        /** Whether the task returned normally. */
+        bool mSucceeded;
+
+        /** The string returned by the task, or an error message if it failed. */
+        std::string mOutput;
+    };
+
+private:
+
+    /** The maximum number of tasks that run at once. */
+    unsigned mNumWorkers;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param numWorkers the maximum number of tasks to run at once;
+     *     0 (the default) means one per hardware thread
+     */
+    SimulationWorkerPool(unsigned numWorkers=0u);
+
+    /**
+     * @return the maximum number of tasks that run at once
+     */
+    unsigned GetNumWorkers() const;
+
+    /**
+     * Run tasks 0, 1, ..., numTasks-1, and wait for all of them to finish.
+     *
+     * @param numTasks the number of tasks
+     * @param task the function to run for each task index
+     * @return the result of each task, indexed by task
+     */
+    std::vector<Result> Run(unsigned numTasks, boost::function<std::string (unsigned)> task);
+};
+
+#endif /*SIMULATIONWORKERPOOL_HPP_*/
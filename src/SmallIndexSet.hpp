@@ -0,0 +1,336 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef SMALLINDEXSET_HPP_
+#define SMALLINDEXSET_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * A sorted set of indices, such as the elements containing a vertex or the
+ * neighbours of an element, with the parts of the std::set<unsigned> interface
+ * that vertex code uses.
+ *
+ * A vertex of a 2D vertex mesh is in at most a handful of elements, and a cell
+ * has six or so neighbours, so up to INLINE_CAPACITY indices are stored in the
+ * object itself, sorted, and filling, copying or intersecting such sets does
+ * not allocate. Larger sets spill over to the heap. Iterators are plain
+ * pointers, and are invalidated by any change to the set.
+ */
+class SmallIndexSet
+{
+public:
+
+    /** The number of indices stored without allocating. */
+    static const unsigned INLINE_CAPACITY = 8u;
+
+    /** The type of the indices. */
+    typedef unsigned value_type;
+
+    /** An iterator over the indices, in increasing order. */
+    typedef const unsigned* const_iterator;
+
+    /** The sets cannot be changed through iterators, as for std::set. */
+    typedef const_iterator iterator;
+
+private:
+
+    /** The number of indices. */
+    unsigned mSize;
+
+    /** The indices, if there are no more than INLINE_CAPACITY. */
+    unsigned mInline[INLINE_CAPACITY];
+
+    /** The indices, once there have been more than INLINE_CAPACITY; empty before. */
+    std::vector<unsigned> mSpilled;
+
+    /**
+     * @return the first index
+     */
+    unsigned* GetData()
+    {
+        return mSpilled.empty() ? mInline : mSpilled.data();
+    }
+
+public:
+
+    /**
+     * Constructor. The set is empty.
+     */
+    SmallIndexSet()
+        : mSize(0u)
+    {
+    }
+
+    /**
+     * Constructor.
+     *
+     * @param first the first of a range of indices, in any order
+     * @param last one past the last index of the range
+     */
+    template<class ITERATOR>
+    SmallIndexSet(ITERATOR first, ITERATOR last)
+        : mSize(0u)
+    {
+        for ( ; first != last; ++first)
+        {
+            insert(end(), *first);
+        }
+    }
+
+    /**
+     * @return an iterator to the smallest index
+     */
+    const_iterator begin() const
+    {
+        return mSpilled.empty() ? mInline : mSpilled.data();
+    }
+
+    /**
+     * @return an iterator one past the largest index
+     */
+    const_iterator end() const
+    {
+        return begin() + mSize;
+    }
+
+    /**
+     * @return the number of indices
+     */
+    std::size_t size() const
+    {
+        return mSize;
+    }
+
+    /**
+     * @return whether the set is empty
+     */
+    bool empty() const
+    {
+        return mSize == 0u;
+    }
+
+    /**
+     * @return whether the indices have spilled over to the heap
+     */
+    bool IsSpilled() const
+    {
+        return !mSpilled.empty();
+    }
+
+    /**
+     * @param index an index
+     * @return an iterator to the index, or end() if it is not in the set
+     */
+    const_iterator find(unsigned index) const
+    {
+        const_iterator p_position = std::lower_bound(begin(), end(), index);
+        return (p_position != end() && *p_position == index) ? p_position : end();
+    }
+
+    /**
+     * @param index an index
+     * @return 1 if the index is in the set and 0 otherwise
+     */
+    std::size_t count(unsigned index) const
+    {
+        return find(index) == end() ? 0u : 1u;
+    }
+
+    /**
+     * Add an index to the set.
+     *
+     * @param index the index
+     * @return an iterator to the index, and whether it was added (rather than already in the set)
+     */
+    std::pair<const_iterator, bool> insert(unsigned index)
+    {
+        unsigned* p_begin = GetData();
+        unsigned* p_position = std::lower_bound(p_begin, p_begin + mSize, index);
+        if (p_position != p_begin + mSize && *p_position == index)
+        {
+            return std::make_pair(p_position, false);
+        }
+
+        unsigned offset = p_position - p_begin;
+        if (mSpilled.empty() && mSize == INLINE_CAPACITY)
+        {
+            mSpilled.assign(mInline, mInline + mSize);
+        }
+        if (!mSpilled.empty())
+        {
+            mSpilled.insert(mSpilled.begin() + offset, index);
+            mSize++;
+            return std::make_pair(mSpilled.data() + offset, true);
+        }
+        std::copy_backward(mInline + offset, mInline + mSize, mInline + mSize + 1);
+        mInline[offset] = index;
+        mSize++;
+        return std::make_pair(mInline + offset, true);
+    }
+
+    /**
+     * Add an index to the set, as for std::set. Adding indices in increasing
+     * order with end() as the hint, as std::set_intersection() does through a
+     * std::inserter, takes constant time.
+     *
+     * @param hint where the index probably goes
+     * @param index the index
+     * @return an iterator to the index
+     */
+    const_iterator insert(const_iterator hint, unsigned index)
+    {
+        if (hint == end() && (mSize == 0u || *(hint - 1) < index))
+        {
+            if (!mSpilled.empty())
+            {
+                mSpilled.push_back(index);
+                mSize++;
+                return mSpilled.data() + mSize - 1;
+            }
+            if (mSize < INLINE_CAPACITY)
+            {
+                mInline[mSize] = index;
+                mSize++;
+                return mInline + mSize - 1;
+            }
+        }
+        return insert(index).first;
+    }
+
+    /**
+     * Remove an index from the set.
+     *
+     * @param index the index
+     * @return the number of indices removed, 0 or 1
+     */
+    std::size_t erase(unsigned index)
+    {
+        unsigned* p_begin = GetData();
+        unsigned* p_position = std::lower_bound(p_begin, p_begin + mSize, index);
+        if (p_position == p_begin + mSize || *p_position != index)
+        {
+            return 0u;
+        }
+        if (!mSpilled.empty())
+        {
+            mSpilled.erase(mSpilled.begin() + (p_position - p_begin));
+        }
+        else
+        {
+            std::copy(p_position + 1, p_begin + mSize, p_position);
+        }
+        mSize--;
+        return 1u;
+    }
+
+    /**
+     * Remove all indices. The set goes back to storing its indices inline.
+     */
+    void clear()
+    {
+        mSize = 0u;
+        mSpilled.clear();
+    }
+
+    /**
+     * Replace the contents of the set by the indices that are in both of two
+     * sorted sets, e.g. the containing elements of the two vertices of an edge.
+     *
+     * @param rFirst the first set, e.g. a std::set<unsigned> or a SmallIndexSet
+     * @param rSecond the second set
+     */
+    template<class FIRST_SET, class SECOND_SET>
+    void AssignIntersection(const FIRST_SET& rFirst, const SECOND_SET& rSecond)
+    {
+        clear();
+        typename FIRST_SET::const_iterator first_iter = rFirst.begin();
+        typename SECOND_SET::const_iterator second_iter = rSecond.begin();
+        while (first_iter != rFirst.end() && second_iter != rSecond.end())
+        {
+            if (*first_iter < *second_iter)
+            {
+                ++first_iter;
+            }
+            else if (*second_iter < *first_iter)
+            {
+                ++second_iter;
+            }
+            else
+            {
+                insert(end(), *first_iter);
+                ++first_iter;
+                ++second_iter;
+            }
+        }
+    }
+
+    /**
+     * Add the indices of a sorted set to this one.
+     *
+     * @param rOther the other set, e.g. a std::set<unsigned> or a SmallIndexSet
+     */
+    template<class OTHER_SET>
+    void InsertAll(const OTHER_SET& rOther)
+    {
+        for (typename OTHER_SET::const_iterator iter = rOther.begin(); iter != rOther.end(); ++iter)
+        {
+            insert(*iter);
+        }
+    }
+
+    /**
+     * @param rOther another set
+     * @return whether the sets hold the same indices
+     */
+    bool operator==(const SmallIndexSet& rOther) const
+    {
+        return mSize == rOther.mSize && std::equal(begin(), end(), rOther.begin());
+    }
+
+    /**
+     * @param rOther another set
+     * @return whether the sets hold different indices
+     */
+    bool operator!=(const SmallIndexSet& rOther) const
+    {
+        return !(*this == rOther);
+    }
+};
+
+#endif /*SMALLINDEXSET_HPP_*/
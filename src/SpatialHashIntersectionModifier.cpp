@@ -0,0 +1,273 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "SpatialHashIntersectionModifier.hpp"
+#include "VertexBasedCellPopulation.hpp"
+
+#include <algorithm>
+#include <climits>
+
+template<unsigned DIM>
+SpatialHashIntersectionModifier<DIM>::SpatialHashIntersectionModifier()
+    : AbstractCellBasedSimulationModifier<DIM,DIM>(),
+      mGridCellSize(1.0),
+      mCheckForT3Swaps(false),
+      mCheckForInternalIntersections(false),
+      mNumT3Swaps(0u),
+      mNumIntersectionSwaps(0u),
+      mNumInclusionTests(0u)
+{
+}
+
+template<unsigned DIM>
+SpatialHashIntersectionModifier<DIM>::~SpatialHashIntersectionModifier()
+{
+}
+
+template<unsigned DIM>
+void SpatialHashIntersectionModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory)
+{
+    if (dynamic_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation) == nullptr)
+    {
+        EXCEPTION("SpatialHashIntersectionModifier is to be used with a VertexBasedCellPopulation only");
+    }
+    if (DIM != 2)
+    {
+        EXCEPTION("SpatialHashIntersectionModifier is only implemented in 2D");
+    }
+
+    MutableVertexMesh<DIM,DIM>& r_mesh = static_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation)->rGetMesh();
+    mCheckForT3Swaps = mCheckForT3Swaps || r_mesh.GetCheckForT3Swaps();
+    mCheckForInternalIntersections = mCheckForInternalIntersections || r_mesh.GetCheckForInternalIntersections();
+    r_mesh.SetCheckForT3Swaps(false);
+    r_mesh.SetCheckForInternalIntersections(false);
+}
+
+template<unsigned DIM>
+void SpatialHashIntersectionModifier<DIM>::UpdateHash(MutableVertexMesh<DIM,DIM>& rMesh)
+{
+    if (!mpHash)
+    {
+        mpHash.reset(new VertexSpatialHash(mGridCellSize));
+    }
+
+    unsigned num_nodes = rMesh.GetNumAllNodes();
+    for (unsigned node_index=0; node_index<num_nodes; node_index++)
+    {
+        // Only boundary nodes can take part in T3 swaps
+        Node<DIM>* p_node = rMesh.GetNode(node_index);
+        if (p_node->IsDeleted() || !(mCheckForInternalIntersections || p_node->IsBoundaryNode()))
+        {
+            mpHash->RemoveVertex(node_index);
+        }
+        else
+        {
+            const c_vector<double, DIM>& r_location = p_node->rGetLocation();
+            mpHash->SetVertex(node_index, r_location[0], r_location[1]);
+        }
+    }
+    mpHash->Truncate(num_nodes);
+}
+
+template<unsigned DIM>
+bool SpatialHashIntersectionModifier<DIM>::FindFirstIntersection(MutableVertexMesh<DIM,DIM>& rMesh, bool boundaryOnly,
+                                                                 unsigned& rNodeIndex, unsigned& rElementIndex)
+{
+    // The mesh loops over nodes and then elements, both in index order, so look for the smallest pair
+    rNodeIndex = UINT_MAX;
+    rElementIndex = UINT_MAX;
+    double max_distance = rMesh.GetMaxDistanceForT3SwapChecking();
+
+    for (typename VertexMesh<DIM,DIM>::VertexElementIterator elem_iter = rMesh.GetElementIteratorBegin();
+         elem_iter != rMesh.GetElementIteratorEnd();
+         ++elem_iter)
+    {
+        if (boundaryOnly && !elem_iter->IsElementOnBoundary())
+        {
+            continue;
+        }
+        unsigned elem_index = elem_iter->GetIndex();
+
+        // Only nodes in the bounding box of the element can be in it
+        c_vector<double, DIM> box_min = elem_iter->GetNode(0)->rGetLocation();
+        c_vector<double, DIM> box_max = box_min;
+        for (unsigned local_index=1; local_index<elem_iter->GetNumNodes(); local_index++)
+        {
+            const c_vector<double, DIM>& r_location = elem_iter->GetNode(local_index)->rGetLocation();
+            for (unsigned dim=0; dim<2; dim++)
+            {
+                box_min[dim] = std::min(box_min[dim], r_location[dim]);
+                box_max[dim] = std::max(box_max[dim], r_location[dim]);
+            }
+        }
+        mpHash->GetVerticesInBox(box_min[0], box_min[1], box_max[0], box_max[1], mCandidates);
+
+        bool have_centroid = false;
+        c_vector<double, DIM> centroid;
+        for (unsigned candidate=0; candidate<mCandidates.size(); candidate++)
+        {
+            unsigned node_index = mCandidates[candidate];
+            if (node_index > rNodeIndex || (node_index == rNodeIndex && elem_index > rElementIndex))
+            {
+                continue;
+            }
+            Node<DIM>* p_node = rMesh.GetNode(node_index);
+            if ((boundaryOnly && !p_node->IsBoundaryNode()) || p_node->rGetContainingElementIndices().count(elem_index) != 0)
+            {
+                continue;
+            }
+            if (boundaryOnly)
+            {
+                if (!have_centroid)
+                {
+                    centroid = rMesh.GetCentroidOfElement(elem_index);
+                    have_centroid = true;
+                }
+                if (norm_2(rMesh.GetVectorFromAtoB(p_node->rGetLocation(), centroid)) >= max_distance)
+                {
+                    continue;
+                }
+            }
+
+            mNumInclusionTests++;
+            if (rMesh.ElementIncludesPoint(p_node->rGetLocation(), elem_index))
+            {
+                rNodeIndex = node_index;
+                rElementIndex = elem_index;
+            }
+        }
+    }
+    return rNodeIndex != UINT_MAX;
+}
+
+template<unsigned DIM>
+void SpatialHashIntersectionModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    // The mesh only calls CheckForIntersections(), which also checks for internal intersections, if T3 swaps are on
+    if (!mCheckForT3Swaps)
+    {
+        return;
+    }
+
+    MutableVertexMesh<DIM,DIM>& r_mesh = static_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation)->rGetMesh();
+    UpdateHash(r_mesh);
+
+    bool swapped = false;
+    unsigned node_index;
+    unsigned elem_index;
+    while (true)
+    {
+        if (mCheckForInternalIntersections && FindFirstIntersection(r_mesh, false, node_index, elem_index))
+        {
+            r_mesh.PerformIntersectionSwap(r_mesh.GetNode(node_index), elem_index);
+            mNumIntersectionSwaps++;
+        }
+        else if (mCheckForT3Swaps && FindFirstIntersection(r_mesh, true, node_index, elem_index))
+        {
+            r_mesh.PerformT3Swap(r_mesh.GetNode(node_index), elem_index);
+            mNumT3Swaps++;
+        }
+        else
+        {
+            break;
+        }
+        swapped = true;
+
+        // A swap may add nodes and move others
+        UpdateHash(r_mesh);
+    }
+
+    if (swapped)
+    {
+        // As at the end of MutableVertexMesh::ReMesh()
+        r_mesh.RemoveDeletedNodes();
+        UpdateHash(r_mesh);
+    }
+}
+
+template<unsigned DIM>
+void SpatialHashIntersectionModifier<DIM>::SetGridCellSize(double gridCellSize)
+{
+    if (!(gridCellSize > 0.0))
+    {
+        EXCEPTION("The grid cell size must be positive");
+    }
+    mGridCellSize = gridCellSize;
+    mpHash.reset();
+}
+
+template<unsigned DIM>
+double SpatialHashIntersectionModifier<DIM>::GetGridCellSize() const
+{
+    return mGridCellSize;
+}
+
+template<unsigned DIM>
+unsigned SpatialHashIntersectionModifier<DIM>::GetNumT3Swaps() const
+{
+    return mNumT3Swaps;
+}
+
+template<unsigned DIM>
+unsigned SpatialHashIntersectionModifier<DIM>::GetNumIntersectionSwaps() const
+{
+    return mNumIntersectionSwaps;
+}
+
+template<unsigned DIM>
+unsigned long SpatialHashIntersectionModifier<DIM>::GetNumInclusionTests() const
+{
+    return mNumInclusionTests;
+}
+
+template<unsigned DIM>
+void SpatialHashIntersectionModifier<DIM>::OutputSimulationModifierParameters(out_stream& rParamsFile)
+{
+    *rParamsFile << "\t\t\t<GridCellSize>" << mGridCellSize << "</GridCellSize>\n";
+    *rParamsFile << "\t\t\t<CheckForT3Swaps>" << mCheckForT3Swaps << "</CheckForT3Swaps>\n";
+    *rParamsFile << "\t\t\t<CheckForInternalIntersections>" << mCheckForInternalIntersections << "</CheckForInternalIntersections>\n";
+
+    // Next, call method on direct parent class
+    AbstractCellBasedSimulationModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
+}
+
+// Explicit instantiation
+template class SpatialHashIntersectionModifier<1>;
+template class SpatialHashIntersectionModifier<2>;
+template class SpatialHashIntersectionModifier<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(SpatialHashIntersectionModifier)
@@ -0,0 +1,206 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef SPATIALHASHINTERSECTIONMODIFIER_HPP_
+#define SPATIALHASHINTERSECTIONMODIFIER_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+#include <boost/shared_ptr.hpp>
+#include <vector>
+
+#include "AbstractCellBasedSimulationModifier.hpp"
+#include "MutableVertexMesh.hpp"
+#include "VertexSpatialHash.hpp"
+
+/**
+ * A modifier that takes over the T3 swap and internal intersection checks of a
+ * vertex mesh, finding the candidate node-element pairs with a VertexSpatialHash.
+ *
+ * MutableVertexMesh::CheckForIntersections() tests every (boundary) node
+ * against every (boundary) element, so remeshing slows down quadratically as
+ * the tissue grows. In SetupSolve() this modifier switches those checks off in
+ * the mesh, and remembers which were on. At the end of each time step it
+ * brings the hash up to date with the moved vertices and tests each element
+ * only against the vertices in its bounding box. As in the mesh, it performs
+ * the swap for the first intersecting node (in index order) and element,
+ * checks again, and repeats until there is none: internal intersection swaps
+ * first, then T3 swaps of boundary nodes into boundary elements. As in
+ * MutableVertexMesh::ReMesh(), internal intersections are only checked for
+ * when T3 swaps are.
+ *
+ * The checks now run straight after the vertices move rather than at the start
+ * of the next ReMesh(), after births and T1 swaps. T1 swaps are already found
+ * in time linear in the number of edges, by MutableVertexMesh's loop over the
+ * edges of each element, so they are left to the mesh.
+ */
+template<unsigned DIM>
+class SpatialHashIntersectionModifier : public AbstractCellBasedSimulationModifier<DIM,DIM>
+{
+private:
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Archive the object. The hash is rebuilt at the next time step, so is not archived.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractCellBasedSimulationModifier<DIM,DIM> >(*this);
+        archive & mGridCellSize;
+        archive & mCheckForT3Swaps;
+        archive & mCheckForInternalIntersections;
+    }
+
+    /** The side length of the grid cells of the hash. Defaults to 1. */
+    double mGridCellSize;
+
+    /** Whether to check for T3 swaps; taken from the mesh by SetupSolve(). */
+    bool mCheckForT3Swaps;
+
+    /**
+     * Whether to check for internal intersections, if T3 swaps are checked for;
+     * taken from the mesh by SetupSolve().
+     */
+    bool mCheckForInternalIntersections;
+
+    /** The hash of the vertex locations. */
+    boost::shared_ptr<VertexSpatialHash> mpHash;
+
+    /** The vertices found by the last query of the hash. */
+    std::vector<unsigned> mCandidates;
+
+    /** The number of T3 swaps performed. */
+    unsigned mNumT3Swaps;
+
+    /** The number of internal intersection swaps performed. */
+    unsigned mNumIntersectionSwaps;
+
+    /** The number of node-in-element tests made. */
+    unsigned long mNumInclusionTests;
+
+    /**
+     * Bring the hash up to date with the mesh. Only boundary nodes are hashed
+     * unless internal intersections are checked for.
+     *
+     * @param rMesh the mesh
+     */
+    void UpdateHash(MutableVertexMesh<DIM,DIM>& rMesh);
+
+    /**
+     * Find the first node that lies in an element that it is not part of.
+     *
+     * @param rMesh the mesh
+     * @param boundaryOnly whether to consider only boundary nodes and elements,
+     *     within the mesh's maximum distance for T3 swap checking
+     * @param rNodeIndex filled in with the index of the node
+     * @param rElementIndex filled in with the index of the element
+     * @return whether there is such a node
+     */
+    bool FindFirstIntersection(MutableVertexMesh<DIM,DIM>& rMesh, bool boundaryOnly,
+                               unsigned& rNodeIndex, unsigned& rElementIndex);
+
+public:
+
+    /**
+     * Constructor.
+     */
+    SpatialHashIntersectionModifier();
+
+    /**
+     * Destructor.
+     */
+    virtual ~SpatialHashIntersectionModifier();
+
+    /**
+     * Overridden SetupSolve() method. Takes over the mesh's checks.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     */
+    virtual void SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory);
+
+    /**
+     * Overridden UpdateAtEndOfTimeStep() method. Performs the swaps.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Set the side length of the grid cells of the hash. About the diameter of an
+     * element is best. Must be called before the simulation starts.
+     *
+     * @param gridCellSize the side length
+     */
+    void SetGridCellSize(double gridCellSize);
+
+    /**
+     * @return the side length of the grid cells of the hash
+     */
+    double GetGridCellSize() const;
+
+    /**
+     * @return the number of T3 swaps performed
+     */
+    unsigned GetNumT3Swaps() const;
+
+    /**
+     * @return the number of internal intersection swaps performed
+     */
+    unsigned GetNumIntersectionSwaps() const;
+
+    /**
+     * @return the number of node-in-element tests made, to compare with the
+     *     number of nodes times the number of elements
+     */
+    unsigned long GetNumInclusionTests() const;
+
+    /**
+     * Overridden OutputSimulationModifierParameters() method.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    void OutputSimulationModifierParameters(out_stream& rParamsFile);
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(SpatialHashIntersectionModifier)
+
+#endif /*SPATIALHASHINTERSECTIONMODIFIER_HPP_*/
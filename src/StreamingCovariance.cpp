@@ -0,0 +1,102 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "StreamingCovariance.hpp"
+#include "Exception.hpp"
+
+StreamingCovariance::StreamingCovariance(unsigned dimension)
+    : mDimension(dimension),
+      mNumSamples(0u),
+      mMean(dimension, 0.0),
+      mSumOfProducts(dimension*dimension, 0.0)
+{
+}
+
+void StreamingCovariance::AddSample(const std::vector<double>& rSample)
+{
+    if (rSample.size() != mDimension)
+    {
+        EXCEPTION("Expected a sample of length " << mDimension << ", not " << rSample.size());
+    }
+
+    // Welford: the products of the deviations from the old and the new mean
+    mNumSamples++;
+    std::vector<double> old_deviation(mDimension);
+    for (unsigned i=0; i<mDimension; i++)
+    {
+        old_deviation[i] = rSample[i] - mMean[i];
+        mMean[i] += old_deviation[i]/mNumSamples;
+    }
+    for (unsigned i=0; i<mDimension; i++)
+    {
+        double new_deviation = rSample[i] - mMean[i];
+        for (unsigned j=0; j<mDimension; j++)
+        {
+            mSumOfProducts[i*mDimension + j] += new_deviation*old_deviation[j];
+        }
+    }
+}
+
+unsigned StreamingCovariance::GetNumSamples() const
+{
+    return mNumSamples;
+}
+
+unsigned StreamingCovariance::GetDimension() const
+{
+    return mDimension;
+}
+
+const std::vector<double>& StreamingCovariance::rGetMean() const
+{
+    return mMean;
+}
+
+std::vector<double> StreamingCovariance::GetCovariance() const
+{
+    if (mNumSamples < 2u)
+    {
+        EXCEPTION("A covariance needs at least two samples, not " << mNumSamples);
+    }
+    // The Welford update is only symmetric up to rounding, so average the two triangles
+    std::vector<double> covariance(mDimension*mDimension);
+    for (unsigned i=0; i<mDimension; i++)
+    {
+        for (unsigned j=0; j<mDimension; j++)
+        {
+            covariance[i*mDimension + j] = 0.5*(mSumOfProducts[i*mDimension + j] + mSumOfProducts[j*mDimension + i])/(mNumSamples - 1u);
+        }
+    }
+    return covariance;
+}
@@ -0,0 +1,99 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef STREAMINGCOVARIANCE_HPP_
+#define STREAMINGCOVARIANCE_HPP_
+
+#include <vector>
+
+/**
+ * The sample mean and covariance of a stream of vectors (e.g. the summary
+ * statistics of the replicate runs of a parameter set), updated one sample at
+ * a time with Welford's algorithm, so that the samples need not be kept and
+ * the estimate is numerically stable.
+ */
+class StreamingCovariance
+{
+private:
+
+    /** The length of the vectors. */
+    unsigned mDimension;
+
+    /** The number of samples so far. */
+    unsigned mNumSamples;
+
+    /** The mean of the samples so far. */
+    std::vector<double> mMean;
+
+    /** The sum of the outer products of the deviations from the mean, stored by rows. */
+    std::vector<double> mSumOfProducts;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param dimension the length of the vectors
+     */
+    StreamingCovariance(unsigned dimension);
+
+    /**
+     * Add a sample.
+     *
+     * @param rSample the sample
+     */
+    void AddSample(const std::vector<double>& rSample);
+
+    /**
+     * @return the number of samples added
+     */
+    unsigned GetNumSamples() const;
+
+    /**
+     * @return the length of the vectors
+     */
+    unsigned GetDimension() const;
+
+    /**
+     * @return the sample mean
+     */
+    const std::vector<double>& rGetMean() const;
+
+    /**
+     * @return the unbiased sample covariance, stored by rows; needs at least two samples
+     */
+    std::vector<double> GetCovariance() const;
+};
+
+#endif /*STREAMINGCOVARIANCE_HPP_*/
@@ -0,0 +1,175 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "SummaryStatisticDistance.hpp"
+#include "Exception.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    /**
+     * @param rValues some values, which are reordered
+     * @return their median; there must be at least one value
+     */
+    double GetMedian(std::vector<double>& rValues)
+    {
+        unsigned middle = rValues.size()/2;
+        std::nth_element(rValues.begin(), rValues.begin() + middle, rValues.end());
+        double median = rValues[middle];
+        if (rValues.size()%2 == 0)
+        {
+            median = 0.5*(median + *std::max_element(rValues.begin(), rValues.begin() + middle));
+        }
+        return median;
+    }
+}
+
+SummaryStatisticDistance::SummaryStatisticDistance(const std::vector<double>& rObserved)
+    : mObserved(rObserved),
+      mWeights(rObserved.size(), 1.0),
+      mScales(rObserved.size(), 1.0)
+{
+    UpdateFactors();
+}
+
+void SummaryStatisticDistance::CheckSize(const std::vector<double>& rValues, const char* pName) const
+{
+    if (rValues.size() != mObserved.size())
+    {
+        EXCEPTION("Expected " << mObserved.size() << " " << pName << " but got " << rValues.size());
+    }
+}
+
+void SummaryStatisticDistance::UpdateFactors()
+{
+    mFactors.resize(mObserved.size());
+    for (unsigned i=0; i<mObserved.size(); i++)
+    {
+        bool is_used = !std::isnan(mObserved[i]) && std::isfinite(mScales[i]) && mScales[i] != 0.0;
+        mFactors[i] = is_used ? mWeights[i]/(mScales[i]*mScales[i]) : 0.0;
+    }
+}
+
+void SummaryStatisticDistance::SetWeights(const std::vector<double>& rWeights)
+{
+    CheckSize(rWeights, "weights");
+    for (unsigned i=0; i<rWeights.size(); i++)
+    {
+        if (!(rWeights[i] >= 0.0))
+        {
+            EXCEPTION("The weights of the statistics must not be negative");
+        }
+    }
+    mWeights = rWeights;
+    UpdateFactors();
+}
+
+void SummaryStatisticDistance::SetScales(const std::vector<double>& rScales)
+{
+    CheckSize(rScales, "scales");
+    mScales = rScales;
+    UpdateFactors();
+}
+
+void SummaryStatisticDistance::SetScalesFromSimulations(const std::vector<std::vector<double> >& rSimulated)
+{
+    std::vector<double> scales(mObserved.size());
+    std::vector<double> column(rSimulated.size());
+    for (unsigned i=0; i<mObserved.size(); i++)
+    {
+        for (unsigned run=0; run<rSimulated.size(); run++)
+        {
+            CheckSize(rSimulated[run], "simulated statistics");
+            column[run] = rSimulated[run][i];
+        }
+        scales[i] = GetMedianAbsoluteDeviation(column);
+    }
+    SetScales(scales);
+}
+
+const std::vector<double>& SummaryStatisticDistance::rGetScales() const
+{
+    return mScales;
+}
+
+double SummaryStatisticDistance::GetDistance(const std::vector<double>& rSimulated) const
+{
+    CheckSize(rSimulated, "simulated statistics");
+
+    const double* p_simulated = rSimulated.data();
+    const double* p_observed = mObserved.data();
+    const double* p_factors = mFactors.data();
+    unsigned num_statistics = mObserved.size();
+
+    // Unused statistics have a zero factor, so the sum needs no branches; a NaN
+    // difference in a used statistic makes it NaN, which is reported as infinity
+    double sum = 0.0;
+    for (unsigned i=0; i<num_statistics; i++)
+    {
+        double difference = (p_factors[i] != 0.0) ? p_simulated[i] - p_observed[i] : 0.0;
+        sum += p_factors[i]*difference*difference;
+    }
+    return std::isnan(sum) ? std::numeric_limits<double>::infinity() : std::sqrt(sum);
+}
+
+std::vector<double> SummaryStatisticDistance::GetDistances(const std::vector<std::vector<double> >& rSimulated) const
+{
+    std::vector<double> distances(rSimulated.size());
+    for (unsigned run=0; run<rSimulated.size(); run++)
+    {
+        distances[run] = GetDistance(rSimulated[run]);
+    }
+    return distances;
+}
+
+double SummaryStatisticDistance::GetMedianAbsoluteDeviation(std::vector<double> values)
+{
+    values.erase(std::remove_if(values.begin(), values.end(), [](double value) { return std::isnan(value); }),
+                 values.end());
+    if (values.empty())
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    double median = GetMedian(values);
+    for (unsigned i=0; i<values.size(); i++)
+    {
+        values[i] = std::fabs(values[i] - median);
+    }
+    return GetMedian(values);
+}
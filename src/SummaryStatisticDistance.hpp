@@ -0,0 +1,138 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef SUMMARYSTATISTICDISTANCE_HPP_
+#define SUMMARYSTATISTICDISTANCE_HPP_
+
+#include <vector>
+
+/**
+ * The weighted Euclidean distance between simulated and observed vectors of
+ * summary statistics (e.g. TissueSummaryStatistics::ToVector(), possibly with
+ * the columns of FarhadifarForceWriter appended), for ABC and similar schemes:
+ *
+ *   d(s) = sqrt( sum_i w_i ((s_i - o_i)/c_i)^2 )
+ *
+ * where o is the observed vector, w the weights and c the scales. The scales are
+ * usually the median absolute deviations of the statistics over a batch of
+ * simulated runs (SetScalesFromSimulations()), which puts statistics of
+ * different sizes on a common footing and, unlike the standard deviation, is not
+ * thrown by a few outlying runs.
+ *
+ * Statistics that are NaN in the observed vector, or whose scale is zero or not
+ * finite, are not used. A simulated vector with a NaN in a used statistic (e.g.
+ * a failed run) is infinitely far away.
+ */
+class SummaryStatisticDistance
+{
+private:
+
+    /** The observed statistics. */
+    std::vector<double> mObserved;
+
+    /** The weight of each statistic. */
+    std::vector<double> mWeights;
+
+    /** The scale of each statistic. */
+    std::vector<double> mScales;
+
+    /** The factor w_i/c_i^2 of each statistic, or 0 for statistics that are not used. */
+    std::vector<double> mFactors;
+
+    /**
+     * Recalculate mFactors from the weights and scales.
+     */
+    void UpdateFactors();
+
+    /**
+     * @param rValues a vector of statistics
+     * @param pName what the vector is, for the error message
+     */
+    void CheckSize(const std::vector<double>& rValues, const char* pName) const;
+
+public:
+
+    /**
+     * Constructor. All weights and scales are one.
+     *
+     * @param rObserved the observed statistics
+     */
+    SummaryStatisticDistance(const std::vector<double>& rObserved);
+
+    /**
+     * @param rWeights the weight of each statistic, which must not be negative
+     */
+    void SetWeights(const std::vector<double>& rWeights);
+
+    /**
+     * @param rScales the scale of each statistic
+     */
+    void SetScales(const std::vector<double>& rScales);
+
+    /**
+     * Set the scale of each statistic to its median absolute deviation over
+     * simulated runs, ignoring NaNs.
+     *
+     * @param rSimulated the statistics of each run
+     */
+    void SetScalesFromSimulations(const std::vector<std::vector<double> >& rSimulated);
+
+    /**
+     * @return the scale of each statistic
+     */
+    const std::vector<double>& rGetScales() const;
+
+    /**
+     * @param rSimulated simulated statistics
+     * @return their distance from the observed statistics
+     */
+    double GetDistance(const std::vector<double>& rSimulated) const;
+
+    /**
+     * Calculate the distances of many simulated runs at once.
+     *
+     * @param rSimulated the statistics of each run
+     * @return the distance of each run from the observed statistics
+     */
+    std::vector<double> GetDistances(const std::vector<std::vector<double> >& rSimulated) const;
+
+    /**
+     * @param values some values; NaNs are ignored
+     * @return their median absolute deviation from their median, or NaN if there are none
+     */
+    static double GetMedianAbsoluteDeviation(std::vector<double> values);
+};
+
+#endif /*SUMMARYSTATISTICDISTANCE_HPP_*/
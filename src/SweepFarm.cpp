@@ -0,0 +1,281 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "SweepFarm.hpp"
+#include "BufferedTextEmitter.hpp"
+#include "Exception.hpp"
+#include "PetscTools.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+    /** Tag of messages from a worker: a result, or a request for the first task. */
+    const int RESULT_TAG = 1;
+
+    /** Tag of messages from the master: the index of a task to run. */
+    const int TASK_TAG = 2;
+
+    /** Tag of the message from the master telling a worker to stop. */
+    const int STOP_TAG = 3;
+
+    /** Task index sent by a worker that has no result yet. */
+    const int NO_TASK = -1;
+}
+
+SweepFarm::SweepFarm(const std::vector<SweepTask>& rTasks)
+    : mTasks(rTasks)
+{
+}
+
+void SweepFarm::RunTask(const boost::function<std::string (const SweepTask&)>& rRunTask, unsigned index, Result& rResult) const
+{
+    try
+    {
+        rResult.mOutput = rRunTask(mTasks[index]);
+        rResult.mSucceeded = true;
+    }
+    catch (Exception& e)
+    {
+        rResult.mOutput = e.GetMessage();
+        rResult.mSucceeded = false;
+    }
+    catch (std::exception& e)
+    {
+        rResult.mOutput = e.what();
+        rResult.mSucceeded = false;
+    }
+    std::cout << "Finished " << mTasks[index].GetName()
+              << (rResult.mSucceeded ? "" : " with an error: " + rResult.mOutput) << std::endl;
+}
+
+void SweepFarm::Run(boost::function<std::string (const SweepTask&)> runTask)
+{
+    // Ask for the real rank and size before switching on isolation
+    bool am_master = PetscTools::AmMaster();
+    unsigned num_processes = PetscTools::GetNumProcs();
+
+    mResults.assign(am_master ? mTasks.size() : 0u, Result());
+
+    if (num_processes == 1)
+    {
+        for (unsigned index=0; index<mTasks.size(); index++)
+        {
+            RunTask(runTask, index, mResults[index]);
+        }
+        return;
+    }
+
+    PetscTools::IsolateProcesses(true);
+    try
+    {
+        if (am_master)
+        {
+            RunMaster(num_processes - 1);
+        }
+        else
+        {
+            RunWorker(runTask);
+        }
+    }
+    catch (...)
+    {
+        PetscTools::IsolateProcesses(false);
+        throw;
+    }
+    PetscTools::IsolateProcesses(false);
+    PetscTools::Barrier("SweepFarm::Run");
+}
+
+void SweepFarm::RunMaster(unsigned numWorkers)
+{
+    unsigned next_task = 0;
+    unsigned num_stopped = 0;
+
+    while (num_stopped < numWorkers)
+    {
+        // Wait for any worker to report back
+        MPI_Status status;
+        MPI_Probe(MPI_ANY_SOURCE, RESULT_TAG, PETSC_COMM_WORLD, &status);
+        int length;
+        MPI_Get_count(&status, MPI_CHAR, &length);
+        std::vector<char> message(length);
+        MPI_Recv(message.data(), length, MPI_CHAR, status.MPI_SOURCE, RESULT_TAG, PETSC_COMM_WORLD, MPI_STATUS_IGNORE);
+
+        // The message is "<task index> <succeeded> <output>"
+        std::istringstream message_stream(std::string(message.begin(), message.end()));
+        int index;
+        int succeeded;
+        message_stream >> index >> succeeded;
+        if (index != NO_TASK)
+        {
+            Result& r_result = mResults[index];
+            r_result.mSucceeded = (succeeded != 0);
+            message_stream.get();
+            std::getline(message_stream, r_result.mOutput, '\0');
+        }
+
+        // Give the worker its next task, or tell it to stop
+        if (next_task < mTasks.size())
+        {
+            int task = next_task++;
+            MPI_Send(&task, 1, MPI_INT, status.MPI_SOURCE, TASK_TAG, PETSC_COMM_WORLD);
+        }
+        else
+        {
+            int stop = NO_TASK;
+            MPI_Send(&stop, 1, MPI_INT, status.MPI_SOURCE, STOP_TAG, PETSC_COMM_WORLD);
+            num_stopped++;
+        }
+    }
+}
+
+void SweepFarm::RunWorker(const boost::function<std::string (const SweepTask&)>& rRunTask)
+{
+    std::string message = std::to_string(NO_TASK) + " 0 ";
+    while (true)
+    {
+        MPI_Send(const_cast<char*>(message.data()), message.size(), MPI_CHAR, 0, RESULT_TAG, PETSC_COMM_WORLD);
+
+        int task;
+        MPI_Status status;
+        MPI_Recv(&task, 1, MPI_INT, 0, MPI_ANY_TAG, PETSC_COMM_WORLD, &status);
+        if (status.MPI_TAG == STOP_TAG)
+        {
+            break;
+        }
+
+        Result result;
+        RunTask(rRunTask, task, result);
+        message = std::to_string(task) + (result.mSucceeded ? " 1 " : " 0 ") + result.mOutput;
+    }
+}
+
+void SweepFarm::BroadcastResults()
+{
+    if (PetscTools::IsSequential())
+    {
+        return;
+    }
+
+    // Each result is packed as "<succeeded> <length> <output>"
+    std::string packed;
+    if (PetscTools::AmMaster())
+    {
+        for (unsigned index=0; index<mResults.size(); index++)
+        {
+            packed += (mResults[index].mSucceeded ? "1 " : "0 ") + std::to_string(mResults[index].mOutput.size()) + " " + mResults[index].mOutput;
+        }
+    }
+
+    unsigned long length = packed.size();
+    MPI_Bcast(&length, 1, MPI_UNSIGNED_LONG, 0, PETSC_COMM_WORLD);
+    packed.resize(length);
+    MPI_Bcast(const_cast<char*>(packed.data()), length, MPI_CHAR, 0, PETSC_COMM_WORLD);
+
+    if (!PetscTools::AmMaster())
+    {
+        mResults.resize(mTasks.size());
+        std::istringstream packed_stream(packed);
+        for (unsigned index=0; index<mResults.size(); index++)
+        {
+            int succeeded;
+            std::size_t output_length;
+            packed_stream >> succeeded >> output_length;
+            packed_stream.get();
+            mResults[index].mSucceeded = (succeeded != 0);
+            mResults[index].mOutput.resize(output_length);
+            packed_stream.read(&mResults[index].mOutput[0], output_length);
+        }
+    }
+}
+
+void SweepFarm::WriteResults(const std::string& rFilePath, const std::vector<std::string>& rStatisticNames) const
+{
+    if (!PetscTools::AmMaster() || (mResults.empty() && !mTasks.empty()))
+    {
+        return;
+    }
+
+    std::ofstream file(rFilePath.c_str());
+    if (!file.is_open())
+    {
+        EXCEPTION("Could not open results file " << rFilePath);
+    }
+
+    BufferedTextEmitter emitter;
+    emitter.SetUseShortestRoundTrip(true);
+    emitter << "Lambda,Gamma,Simulation,Run,Seed,Succeeded";
+    for (unsigned i=0; i<rStatisticNames.size(); i++)
+    {
+        emitter << ',' << rStatisticNames[i];
+    }
+    emitter << '\n';
+
+    for (unsigned index=0; index<mTasks.size(); index++)
+    {
+        const SweepTask& r_task = mTasks[index];
+        const Result& r_result = mResults[index];
+        emitter << r_task.mLambda << ',' << r_task.mGamma << ',' << r_task.mSimulation << ','
+                << r_task.mRun << ',' << r_task.mSeed << ',' << r_result.mSucceeded;
+
+        // Failed tasks get empty statistic columns; their error messages are in the log
+        if (r_result.mSucceeded)
+        {
+            std::istringstream statistics(r_result.mOutput);
+            std::string statistic;
+            while (statistics >> statistic)
+            {
+                emitter << ',' << statistic;
+            }
+        }
+        else
+        {
+            for (unsigned i=0; i<rStatisticNames.size(); i++)
+            {
+                emitter << ',';
+            }
+        }
+        emitter << '\n';
+        emitter.FlushTo(file);
+    }
+}
+
+const std::vector<SweepFarm::Result>& SweepFarm::rGetResults() const
+{
+    return mResults;
+}
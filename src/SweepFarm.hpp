@@ -0,0 +1,143 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef SWEEPFARM_HPP_
+#define SWEEPFARM_HPP_
+
+#include <string>
+#include <vector>
+#include <boost/function.hpp>
+#include "SweepTask.hpp"
+
+/**
+ * Runs the tasks of a parameter sweep on all MPI processes, as a task farm.
+ *
+ * The master process hands out tasks one at a time to the other processes as
+ * they become free, so long runs (e.g. those with negative Lambda) do not hold
+ * up the rest of the sweep. Each worker runs its tasks as independent serial
+ * simulations: while the farm runs, PetscTools::IsolateProcesses() is switched
+ * on, so that Chaste treats every process as if it were running on its own.
+ * A task returns its summary statistics as a line of space-separated numbers,
+ * which is sent back to the master and written, with the task's parameters, as
+ * one line of a single CSV results file.
+ *
+ * On a single process the master runs all the tasks itself.
+ */
+class SweepFarm
+{
+public:
+
+    /** The outcome of one task, as collected by the master. */
+    struct Result
+    {
+        /** Whether the task returned normally. */
+        bool mSucceeded;
+
+        /** The string returned by the task, or an error message if it failed. */
+        std::string mOutput;
+    };
+
+private:
+
+    /** The tasks of the sweep. */
+    std::vector<SweepTask> mTasks;
+
+    /** The results of the tasks, only filled in on the master process. */
+    std::vector<Result> mResults;
+
+    /**
+     * Run one task, catching any exception.
+     *
+     * @param rRunTask the function that runs a task
+     * @param index the index of the task
+     * @param rResult the result of the task
+     */
+    void RunTask(const boost::function<std::string (const SweepTask&)>& rRunTask, unsigned index, Result& rResult) const;
+
+    /**
+     * Hand out tasks to the worker processes and collect their results.
+     *
+     * @param numWorkers the number of worker processes
+     */
+    void RunMaster(unsigned numWorkers);
+
+    /**
+     * Run tasks handed out by the master until told to stop.
+     *
+     * @param rRunTask the function that runs a task
+     */
+    void RunWorker(const boost::function<std::string (const SweepTask&)>& rRunTask);
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param rTasks the tasks of the sweep; must be the same on all processes
+     */
+    SweepFarm(const std::vector<SweepTask>& rTasks);
+
+    /**
+     * Run all the tasks. This is collective: it must be called on all processes.
+     *
+     * @param runTask the function that runs a task and returns its summary statistics
+     */
+    void Run(boost::function<std::string (const SweepTask&)> runTask);
+
+    /**
+     * Send the results collected by the master to all the other processes, so
+     * that rGetResults() can be used everywhere, e.g. to choose the tasks of a
+     * further farm. This is collective: it must be called on all processes.
+     */
+    void BroadcastResults();
+
+    /**
+     * Write the results to a CSV file, with columns Lambda, Gamma, Simulation, Run,
+     * Seed and Succeeded followed by the given statistic columns. Does nothing on
+     * processes other than the master.
+     *
+     * @param rFilePath the path of the results file
+     * @param rStatisticNames the names of the statistics returned by the tasks
+     */
+    void WriteResults(const std::string& rFilePath, const std::vector<std::string>& rStatisticNames) const;
+
+    /**
+     * @return the results of the tasks, indexed by task (only on the master
+     *     process, unless BroadcastResults() has been called)
+     */
+    const std::vector<Result>& rGetResults() const;
+};
+
+#endif /*SWEEPFARM_HPP_*/
@@ -0,0 +1,239 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "SweepQueueClient.hpp"
+#include "Exception.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+SweepQueueClient::SweepQueueClient(const std::string& rSocketPath, double heartbeatInterval)
+    : mSocketPath(rSocketPath),
+      mHeartbeatInterval(heartbeatInterval)
+{
+    char host_name[256] = "localhost";
+    gethostname(host_name, sizeof(host_name) - 1);
+    std::ostringstream worker_name;
+    worker_name << host_name << ':' << getpid();
+    mWorkerName = worker_name.str();
+}
+
+const std::string& SweepQueueClient::rGetWorkerName() const
+{
+    return mWorkerName;
+}
+
+std::string SweepQueueClient::SendRequest(const std::string& rRequest) const
+{
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (mSocketPath.size() >= sizeof(address.sun_path))
+    {
+        EXCEPTION("The socket path " << mSocketPath << " is too long");
+    }
+    std::strcpy(address.sun_path, mSocketPath.c_str());
+
+    int connection = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connection < 0)
+    {
+        EXCEPTION("Could not create a socket");
+    }
+    if (connect(connection, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        close(connection);
+        EXCEPTION("Could not connect to the sweep queue at " << mSocketPath);
+    }
+
+    std::string request = rRequest + "\n";
+    send(connection, request.data(), request.size(), MSG_NOSIGNAL);
+
+    std::string reply;
+    char buffer[4096];
+    ssize_t n;
+    while ((n = recv(connection, buffer, sizeof(buffer), 0)) > 0)
+    {
+        reply.append(buffer, n);
+    }
+    close(connection);
+
+    if (reply.empty() || reply[reply.size()-1] != '\n')
+    {
+        EXCEPTION("No reply from the sweep queue at " << mSocketPath);
+    }
+    reply.erase(reply.size()-1);
+    return reply;
+}
+
+bool SweepQueueClient::Lease(unsigned& rIndex, SweepTask& rTask)
+{
+    while (true)
+    {
+        std::string reply;
+        try
+        {
+            reply = SendRequest("LEASE " + mWorkerName);
+        }
+        catch (Exception&)
+        {
+            // The server stops once the sweep has finished
+            return false;
+        }
+
+        std::istringstream reply_stream(reply);
+        std::string status;
+        reply_stream >> status;
+        if (status == "TASK")
+        {
+            reply_stream >> rIndex >> rTask.mLambda >> rTask.mGamma >> rTask.mSimulation >> rTask.mRun >> rTask.mSeed
+                         >> rTask.mWallTimeBudget >> rTask.mTimeStepBudget;
+            return true;
+        }
+        if (status != "WAIT")
+        {
+            return false;
+        }
+
+        // All remaining tasks are running elsewhere; one of them may yet fail and be re-issued
+        std::this_thread::sleep_for(std::chrono::duration<double>(mHeartbeatInterval));
+    }
+}
+
+bool SweepQueueClient::Heartbeat(unsigned index)
+{
+    std::ostringstream request;
+    request << "HEARTBEAT " << index << ' ' << mWorkerName;
+    return SendRequest(request.str()) == "OK";
+}
+
+bool SweepQueueClient::Complete(unsigned index, bool succeeded, const std::string& rOutput)
+{
+    std::string output = rOutput;
+    for (unsigned i=0; i<output.size(); i++)
+    {
+        if (output[i] == '\n' || output[i] == '\r')
+        {
+            output[i] = ' ';
+        }
+    }
+
+    std::ostringstream request;
+    request << "COMPLETE " << index << ' ' << mWorkerName << ' ' << (succeeded ? 1 : 0) << ' ' << output;
+    return SendRequest(request.str()) == "OK";
+}
+
+unsigned SweepQueueClient::RunTasks(boost::function<std::string (const SweepTask&)> runTask)
+{
+    unsigned num_tasks_run = 0;
+    unsigned index;
+    SweepTask task;
+    while (Lease(index, task))
+    {
+        // Keep the lease alive while the task runs
+        std::mutex mutex;
+        std::condition_variable finished_condition;
+        bool finished = false;
+        std::thread heartbeat_thread([&]()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            const unsigned leased_index = index;
+            while (!finished_condition.wait_for(lock, std::chrono::duration<double>(mHeartbeatInterval), [&]{ return finished; }))
+            {
+                // Talk to the server without holding the lock, so that finishing the task is not held up by a slow server
+                lock.unlock();
+                try
+                {
+                    Heartbeat(leased_index);
+                }
+                catch (Exception&)
+                {
+                    // The server may be busy or restarting; the next heartbeat will try again
+                }
+                catch (std::exception&)
+                {
+                    // Likewise
+                }
+                lock.lock();
+            }
+        });
+
+        bool succeeded = true;
+        std::string output;
+        try
+        {
+            output = runTask(task);
+        }
+        catch (Exception& e)
+        {
+            succeeded = false;
+            output = e.GetMessage();
+        }
+        catch (std::exception& e)
+        {
+            succeeded = false;
+            output = e.what();
+        }
+        catch (...)
+        {
+            succeeded = false;
+            output = "Task threw an unknown exception";
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished = true;
+        }
+        finished_condition.notify_one();
+        heartbeat_thread.join();
+
+        try
+        {
+            Complete(index, succeeded, output);
+        }
+        catch (Exception&)
+        {
+            // The lease will run out and the task will be re-issued
+        }
+        num_tasks_run++;
+    }
+    return num_tasks_run;
+}
@@ -0,0 +1,121 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef SWEEPQUEUECLIENT_HPP_
+#define SWEEPQUEUECLIENT_HPP_
+
+#include <string>
+#include <boost/function.hpp>
+#include "SweepTask.hpp"
+
+/**
+ * The worker side of a SweepQueueServer: leases tasks, keeps the leases alive
+ * with heartbeats while the tasks run, and reports their outcomes.
+ */
+class SweepQueueClient
+{
+private:
+
+    /** The path of the server's socket. */
+    std::string mSocketPath;
+
+    /** The name this worker is known by. */
+    std::string mWorkerName;
+
+    /** The time between heartbeats, in seconds. */
+    double mHeartbeatInterval;
+
+    /**
+     * Send a request to the server and wait for the reply.
+     *
+     * @param rRequest the request line, without the line break
+     * @return the reply line, without the line break
+     */
+    std::string SendRequest(const std::string& rRequest) const;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param rSocketPath the path of the server's socket
+     * @param heartbeatInterval the time between heartbeats, in seconds; must be
+     *     well below the lease duration of the server's queue
+     */
+    SweepQueueClient(const std::string& rSocketPath, double heartbeatInterval=10.0);
+
+    /**
+     * @return the name this worker is known by (host name and process ID)
+     */
+    const std::string& rGetWorkerName() const;
+
+    /**
+     * Lease a task, waiting while all remaining tasks are leased to other workers.
+     *
+     * @param rIndex set to the index of the task
+     * @param rTask set to the task
+     * @return whether a task was leased; false once the sweep has finished or the server has gone
+     */
+    bool Lease(unsigned& rIndex, SweepTask& rTask);
+
+    /**
+     * Renew the lease on a task.
+     *
+     * @param index the index of the task
+     * @return whether this worker still holds the lease
+     */
+    bool Heartbeat(unsigned index);
+
+    /**
+     * Report the outcome of a task.
+     *
+     * @param index the index of the task
+     * @param succeeded whether the task succeeded
+     * @param rOutput the output of the task (its summary statistics, or an error message)
+     * @return whether the outcome was accepted
+     */
+    bool Complete(unsigned index, bool succeeded, const std::string& rOutput);
+
+    /**
+     * Lease and run tasks until the sweep has finished. Heartbeats are sent from
+     * a background thread while each task runs.
+     *
+     * @param runTask the function that runs a task and returns its summary statistics
+     * @return the number of tasks run
+     */
+    unsigned RunTasks(boost::function<std::string (const SweepTask&)> runTask);
+};
+
+#endif /*SWEEPQUEUECLIENT_HPP_*/
@@ -0,0 +1,203 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "SweepQueueServer.hpp"
+#include "BufferedTextEmitter.hpp"
+#include "Exception.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+SweepQueueServer::SweepQueueServer(SweepWorkQueue& rQueue, const std::string& rSocketPath)
+    : mrQueue(rQueue),
+      mSocketPath(rSocketPath),
+      mListenSocket(-1)
+{
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (mSocketPath.size() >= sizeof(address.sun_path))
+    {
+        EXCEPTION("The socket path " << mSocketPath << " is too long");
+    }
+    std::strcpy(address.sun_path, mSocketPath.c_str());
+
+    mListenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (mListenSocket < 0)
+    {
+        EXCEPTION("Could not create a socket");
+    }
+
+    unlink(mSocketPath.c_str());
+    if (bind(mListenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+        || listen(mListenSocket, 64) != 0)
+    {
+        close(mListenSocket);
+        EXCEPTION("Could not listen on socket " << mSocketPath);
+    }
+}
+
+SweepQueueServer::~SweepQueueServer()
+{
+    close(mListenSocket);
+    unlink(mSocketPath.c_str());
+}
+
+double SweepQueueServer::GetTime()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void SweepQueueServer::Serve()
+{
+    while (!mrQueue.IsFinished())
+    {
+        // Wake up at least once a second, so that expired leases are noticed
+        pollfd poll_fd = {mListenSocket, POLLIN, 0};
+        int num_ready = poll(&poll_fd, 1, 1000);
+        mrQueue.ExpireLeases(GetTime());
+        if (num_ready <= 0)
+        {
+            continue;
+        }
+
+        int connection = accept(mListenSocket, nullptr, nullptr);
+        if (connection < 0)
+        {
+            continue;
+        }
+
+        // Don't let a stuck client hold up the queue
+        timeval timeout = {5, 0};
+        setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        std::string request;
+        char buffer[4096];
+        while (request.find('\n') == std::string::npos)
+        {
+            ssize_t n = recv(connection, buffer, sizeof(buffer), 0);
+            if (n <= 0)
+            {
+                break;
+            }
+            request.append(buffer, n);
+        }
+
+        if (request.find('\n') != std::string::npos)
+        {
+            request.erase(request.find('\n'));
+            std::string reply = HandleRequest(request, GetTime()) + "\n";
+            send(connection, reply.data(), reply.size(), MSG_NOSIGNAL);
+        }
+        close(connection);
+    }
+}
+
+std::string SweepQueueServer::HandleRequest(const std::string& rRequest, double now)
+{
+    std::istringstream request(rRequest);
+    std::string command;
+    request >> command;
+
+    if (command == "LEASE")
+    {
+        std::string worker;
+        if (!(request >> worker))
+        {
+            return "ERROR LEASE needs a worker name";
+        }
+
+        unsigned index;
+        if (mrQueue.Lease(worker, now, index))
+        {
+            const SweepTask& r_task = mrQueue.rGetTask(index);
+            BufferedTextEmitter reply(256);
+            reply.SetUseShortestRoundTrip(true);
+            reply << "TASK " << index << ' ' << r_task.mLambda << ' ' << r_task.mGamma << ' '
+                  << r_task.mSimulation << ' ' << r_task.mRun << ' ' << r_task.mSeed << ' '
+                  << r_task.mWallTimeBudget << ' ' << r_task.mTimeStepBudget;
+            std::cout << "Leased " << r_task.GetName() << " to " << worker << std::endl;
+            return reply.GetString();
+        }
+        return mrQueue.IsFinished() ? "DONE" : "WAIT";
+    }
+    else if (command == "HEARTBEAT")
+    {
+        unsigned index;
+        std::string worker;
+        if (!(request >> index >> worker))
+        {
+            return "ERROR HEARTBEAT needs a task index and a worker name";
+        }
+        return mrQueue.Heartbeat(index, worker, now) ? "OK" : "LOST";
+    }
+    else if (command == "COMPLETE")
+    {
+        unsigned index;
+        std::string worker;
+        int succeeded;
+        if (!(request >> index >> worker >> succeeded))
+        {
+            return "ERROR COMPLETE needs a task index, a worker name and a success flag";
+        }
+        std::string output;
+        request.get();
+        std::getline(request, output);
+
+        if (!mrQueue.Complete(index, worker, succeeded != 0, output))
+        {
+            return "LOST";
+        }
+        std::cout << (succeeded ? "Completed " : "Failed ") << mrQueue.rGetTask(index).GetName() << std::endl;
+        return "OK";
+    }
+    else if (command == "STATUS")
+    {
+        std::ostringstream reply;
+        reply << "PENDING " << mrQueue.GetNumTasks(SweepWorkQueue::PENDING)
+              << " LEASED " << mrQueue.GetNumTasks(SweepWorkQueue::LEASED)
+              << " SUCCEEDED " << mrQueue.GetNumTasks(SweepWorkQueue::SUCCEEDED)
+              << " FAILED " << mrQueue.GetNumTasks(SweepWorkQueue::FAILED);
+        return reply.str();
+    }
+    return "ERROR Unknown request " + command;
+}
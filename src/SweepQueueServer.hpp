@@ -0,0 +1,107 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef SWEEPQUEUESERVER_HPP_
+#define SWEEPQUEUESERVER_HPP_
+
+#include <string>
+#include "SweepWorkQueue.hpp"
+
+/**
+ * Serves the tasks of a SweepWorkQueue to worker processes on the same machine
+ * through a Unix domain socket.
+ *
+ * Each request is a single line sent on a new connection, and is answered with
+ * a single line before the connection is closed:
+ *
+ *   LEASE <worker>                                  -> TASK <index> <Lambda> <Gamma> <Simulation> <Run> <seed>
+ *                                                      <wall time budget> <time step budget>, WAIT or DONE
+ *   HEARTBEAT <index> <worker>                      -> OK, or LOST if the lease has been lost
+ *   COMPLETE <index> <worker> <succeeded> <output>  -> OK, or LOST
+ *   STATUS                                          -> PENDING <n> LEASED <n> SUCCEEDED <n> FAILED <n>
+ *
+ * Malformed requests are answered with ERROR <message>. The server stops once
+ * every task has finished; workers then find the socket gone and stop too.
+ * SweepQueueClient implements the worker side.
+ */
+class SweepQueueServer
+{
+private:
+
+    /** The queue being served. */
+    SweepWorkQueue& mrQueue;
+
+    /** The path of the socket. */
+    std::string mSocketPath;
+
+    /** The listening socket. */
+    int mListenSocket;
+
+public:
+
+    /**
+     * Constructor. Creates the socket; an old socket file left at the path is removed.
+     *
+     * @param rQueue the queue to serve
+     * @param rSocketPath the path of the socket
+     */
+    SweepQueueServer(SweepWorkQueue& rQueue, const std::string& rSocketPath);
+
+    /**
+     * Destructor. Closes and removes the socket.
+     */
+    ~SweepQueueServer();
+
+    /**
+     * Serve requests until every task of the queue has finished.
+     */
+    void Serve();
+
+    /**
+     * Handle one request.
+     *
+     * @param rRequest the request line, without the line break
+     * @param now the current time in seconds
+     * @return the reply line, without the line break
+     */
+    std::string HandleRequest(const std::string& rRequest, double now);
+
+    /**
+     * @return the current time in seconds, on the clock used by Serve()
+     */
+    static double GetTime();
+};
+
+#endif /*SWEEPQUEUESERVER_HPP_*/
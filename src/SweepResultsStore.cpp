@@ -0,0 +1,631 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "SweepResultsStore.hpp"
+#include "Exception.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <hdf5.h>
+
+namespace
+{
+    /** Maximum length of a run name in the index. */
+    const std::size_t RUN_NAME_LENGTH = 128;
+
+    /** One row of the /index dataset. */
+    struct IndexRecord
+    {
+        double mLambda;
+        double mGamma;
+        unsigned mSimulation;
+        unsigned mRun;
+        unsigned mSeed;
+        char mName[RUN_NAME_LENGTH];
+    };
+
+    /**
+     * @return the HDF5 compound type of an IndexRecord; the caller must close it
+     */
+    hid_t CreateIndexRecordType()
+    {
+        hid_t string_type = H5Tcopy(H5T_C_S1);
+        H5Tset_size(string_type, RUN_NAME_LENGTH);
+
+        hid_t record_type = H5Tcreate(H5T_COMPOUND, sizeof(IndexRecord));
+        H5Tinsert(record_type, "Lambda", HOFFSET(IndexRecord, mLambda), H5T_NATIVE_DOUBLE);
+        H5Tinsert(record_type, "Gamma", HOFFSET(IndexRecord, mGamma), H5T_NATIVE_DOUBLE);
+        H5Tinsert(record_type, "Simulation", HOFFSET(IndexRecord, mSimulation), H5T_NATIVE_UINT);
+        H5Tinsert(record_type, "Run", HOFFSET(IndexRecord, mRun), H5T_NATIVE_UINT);
+        H5Tinsert(record_type, "Seed", HOFFSET(IndexRecord, mSeed), H5T_NATIVE_UINT);
+        H5Tinsert(record_type, "Name", HOFFSET(IndexRecord, mName), string_type);
+        H5Tclose(string_type);
+
+        return record_type;
+    }
+
+    /**
+     * Open a group, creating it if necessary.
+     *
+     * @param location the parent location
+     * @param rName the group name
+     * @param rCreated set to whether the group was created
+     * @return the group; the caller must close it
+     */
+    hid_t OpenOrCreateGroup(hid_t location, const std::string& rName, bool& rCreated)
+    {
+        rCreated = (H5Lexists(location, rName.c_str(), H5P_DEFAULT) <= 0);
+        hid_t group = rCreated ? H5Gcreate2(location, rName.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)
+                               : H5Gopen2(location, rName.c_str(), H5P_DEFAULT);
+        if (group < 0)
+        {
+            EXCEPTION("Could not open or create group " << rName << " in the sweep results store");
+        }
+        return group;
+    }
+
+    /**
+     * Append elements to a one-dimensional extendible dataset, creating it if necessary.
+     *
+     * @param location the parent location
+     * @param rName the dataset name
+     * @param type the HDF5 type of the elements
+     * @param pData the elements
+     * @param numElements the number of elements
+     * @param chunkSize the chunk size used if the dataset is created
+     */
+    void AppendToDataset(hid_t location, const std::string& rName, hid_t type, const void* pData,
+                         hsize_t numElements, hsize_t chunkSize)
+    {
+        hid_t dataset;
+        hsize_t old_size = 0;
+
+        if (H5Lexists(location, rName.c_str(), H5P_DEFAULT) > 0)
+        {
+            dataset = H5Dopen2(location, rName.c_str(), H5P_DEFAULT);
+            hid_t space = H5Dget_space(dataset);
+            H5Sget_simple_extent_dims(space, &old_size, nullptr);
+            H5Sclose(space);
+        }
+        else
+        {
+            hsize_t initial_size = 0;
+            hsize_t max_size = H5S_UNLIMITED;
+            hid_t space = H5Screate_simple(1, &initial_size, &max_size);
+            hid_t properties = H5Pcreate(H5P_DATASET_CREATE);
+            H5Pset_chunk(properties, 1, &chunkSize);
+            H5Pset_deflate(properties, 6);
+            dataset = H5Dcreate2(location, rName.c_str(), type, space, H5P_DEFAULT, properties, H5P_DEFAULT);
+            H5Pclose(properties);
+            H5Sclose(space);
+        }
+
+        if (dataset < 0)
+        {
+            EXCEPTION("Could not open or create dataset " << rName << " in the sweep results store");
+        }
+
+        hsize_t new_size = old_size + numElements;
+        if (H5Dset_extent(dataset, &new_size) < 0)
+        {
+            H5Dclose(dataset);
+            EXCEPTION("Could not extend dataset " << rName << " in the sweep results store");
+        }
+
+        hid_t file_space = H5Dget_space(dataset);
+        H5Sselect_hyperslab(file_space, H5S_SELECT_SET, &old_size, nullptr, &numElements, nullptr);
+        hid_t memory_space = H5Screate_simple(1, &numElements, nullptr);
+        herr_t status = H5Dwrite(dataset, type, memory_space, file_space, H5P_DEFAULT, pData);
+
+        H5Sclose(memory_space);
+        H5Sclose(file_space);
+        H5Dclose(dataset);
+
+        if (status < 0)
+        {
+            EXCEPTION("Could not append to dataset " << rName << " in the sweep results store");
+        }
+    }
+
+    /**
+     * Write a scalar attribute.
+     *
+     * @param location the object to attach the attribute to
+     * @param rName the attribute name
+     * @param type the HDF5 type of the value
+     * @param pValue the value
+     */
+    void WriteAttribute(hid_t location, const std::string& rName, hid_t type, const void* pValue)
+    {
+        hid_t space = H5Screate(H5S_SCALAR);
+        hid_t attribute = H5Acreate2(location, rName.c_str(), type, space, H5P_DEFAULT, H5P_DEFAULT);
+        H5Sclose(space);
+        if (attribute < 0)
+        {
+            EXCEPTION("Could not create attribute " << rName << " in the sweep results store");
+        }
+
+        herr_t status = H5Awrite(attribute, type, pValue);
+        H5Aclose(attribute);
+        if (status < 0)
+        {
+            EXCEPTION("Could not write attribute " << rName << " in the sweep results store");
+        }
+    }
+
+    /**
+     * Read the rows of the index of an open store.
+     *
+     * @param file the store
+     * @return the rows, in the order the runs were first written
+     */
+    std::vector<IndexRecord> ReadIndexRecords(hid_t file)
+    {
+        std::vector<IndexRecord> records;
+        if (H5Lexists(file, "index", H5P_DEFAULT) > 0)
+        {
+            hid_t dataset = H5Dopen2(file, "index", H5P_DEFAULT);
+            if (dataset < 0)
+            {
+                EXCEPTION("Could not open the index of the sweep results store");
+            }
+            hid_t space = H5Dget_space(dataset);
+            hsize_t num_records;
+            H5Sget_simple_extent_dims(space, &num_records, nullptr);
+
+            records.resize(num_records);
+            hid_t record_type = CreateIndexRecordType();
+            herr_t status = num_records > 0 ? H5Dread(dataset, record_type, H5S_ALL, H5S_ALL, H5P_DEFAULT, records.data()) : 0;
+            H5Tclose(record_type);
+            H5Sclose(space);
+            H5Dclose(dataset);
+            if (status < 0)
+            {
+                EXCEPTION("Could not read the index of the sweep results store");
+            }
+        }
+        return records;
+    }
+
+    /**
+     * @param rFilePath the path of a store
+     * @return the path of the store relative to its directory
+     */
+    std::string GetFileName(const std::string& rFilePath)
+    {
+        std::size_t slash = rFilePath.find_last_of('/');
+        return slash == std::string::npos ? rFilePath : rFilePath.substr(slash + 1);
+    }
+
+    /**
+     * Write a sweep file with the given index rows and a link to the file of
+     * each run, to a temporary file that is then renamed over the store.
+     *
+     * @param rFilePath the path of the store
+     * @param rRecords the rows of the index
+     */
+    void ReplaceSweepFile(const std::string& rFilePath, const std::vector<IndexRecord>& rRecords)
+    {
+        std::string temporary_path = rFilePath + ".new";
+        hid_t file = H5Fcreate(temporary_path.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+        if (file < 0)
+        {
+            EXCEPTION("Could not create " << temporary_path);
+        }
+
+        try
+        {
+            hid_t record_type = CreateIndexRecordType();
+            try
+            {
+                AppendToDataset(file, "index", record_type, rRecords.data(), rRecords.size(), 256);
+            }
+            catch (Exception&)
+            {
+                H5Tclose(record_type);
+                throw;
+            }
+            H5Tclose(record_type);
+
+            bool created;
+            hid_t runs_group = OpenOrCreateGroup(file, "runs", created);
+            for (unsigned i=0; i<rRecords.size(); i++)
+            {
+                // Relative to the store's directory, where HDF5 looks for the target of a relative link
+                std::string run_file_name = GetFileName(rFilePath) + ".runs/" + rRecords[i].mName + ".h5";
+                if (H5Lcreate_external(run_file_name.c_str(), "/", runs_group, rRecords[i].mName, H5P_DEFAULT, H5P_DEFAULT) < 0)
+                {
+                    H5Gclose(runs_group);
+                    EXCEPTION("Could not link run " << rRecords[i].mName << " into the sweep results store");
+                }
+            }
+            H5Gclose(runs_group);
+        }
+        catch (Exception&)
+        {
+            H5Fclose(file);
+            std::remove(temporary_path.c_str());
+            throw;
+        }
+
+        if (H5Fclose(file) < 0)
+        {
+            std::remove(temporary_path.c_str());
+            EXCEPTION("Could not write " << temporary_path);
+        }
+
+        // Make sure the new file is on disk before it replaces the old one
+        int file_descriptor = open(temporary_path.c_str(), O_RDONLY);
+        bool synced = (file_descriptor >= 0 && fsync(file_descriptor) == 0);
+        if (file_descriptor >= 0)
+        {
+            close(file_descriptor);
+        }
+        if (!synced || std::rename(temporary_path.c_str(), rFilePath.c_str()) != 0)
+        {
+            std::remove(temporary_path.c_str());
+            EXCEPTION("Could not replace sweep results store " << rFilePath);
+        }
+    }
+}
+
+SweepResultsStore::SweepResultsStore(const std::string& rFilePath, const SweepTask& rTask)
+    : mFilePath(rFilePath),
+      mTask(rTask),
+      mNumPendingBytes(0),
+      mCommitThreshold(1u << 22),
+      mReplaceExistingRun(true),
+      mHasCommitted(false)
+{
+    if (mTask.GetName().size() >= RUN_NAME_LENGTH)
+    {
+        EXCEPTION("The run name " << mTask.GetName() << " is too long for the sweep results store");
+    }
+}
+
+SweepResultsStore::~SweepResultsStore()
+{
+    try
+    {
+        Commit();
+    }
+    catch (Exception&)
+    {
+        // Data are only pending here if the run failed before its own call to Commit(), and
+        // that failure is what the run reports; a commit failure on the way is recorded anyway
+    }
+}
+
+int SweepResultsStore::Lock(const std::string& rFilePath, bool exclusive)
+{
+    std::string lock_path = rFilePath + ".lock";
+    int lock_file_descriptor = open(lock_path.c_str(), (exclusive ? O_RDWR : O_RDONLY) | O_CREAT, 0644);
+    if (lock_file_descriptor < 0)
+    {
+        EXCEPTION("Could not open lock file " << lock_path);
+    }
+
+    struct flock lock;
+    std::memset(&lock, 0, sizeof(lock));
+    lock.l_type = exclusive ? F_WRLCK : F_RDLCK;
+    lock.l_whence = SEEK_SET;
+
+    // Wait for any other process to finish with the store
+    if (fcntl(lock_file_descriptor, F_SETLKW, &lock) != 0)
+    {
+        close(lock_file_descriptor);
+        EXCEPTION("Could not lock " << lock_path);
+    }
+    return lock_file_descriptor;
+}
+
+void SweepResultsStore::Unlock(int lockFileDescriptor)
+{
+    struct flock lock;
+    std::memset(&lock, 0, sizeof(lock));
+    lock.l_type = F_UNLCK;
+    lock.l_whence = SEEK_SET;
+    fcntl(lockFileDescriptor, F_SETLK, &lock);
+    close(lockFileDescriptor);
+}
+
+void SweepResultsStore::Append(const std::string& rDatasetName, const std::string& rData)
+{
+    mPendingData[rDatasetName] += rData;
+    mNumPendingBytes += rData.size();
+
+    if (mNumPendingBytes > mCommitThreshold)
+    {
+        Commit();
+    }
+}
+
+void SweepResultsStore::Commit()
+{
+    if (!mFailure.empty())
+    {
+        EXCEPTION("Output of run " << mTask.GetName() << " was lost: " << mFailure);
+    }
+    if (mNumPendingBytes == 0)
+    {
+        return;
+    }
+
+    int lock_file_descriptor = -1;
+    try
+    {
+        lock_file_descriptor = Lock(mFilePath, true);
+        if (!mHasCommitted)
+        {
+            AddRunToSweepFile();
+        }
+        AppendToRunFile();
+    }
+    catch (Exception& e)
+    {
+        if (lock_file_descriptor >= 0)
+        {
+            Unlock(lock_file_descriptor);
+        }
+        RecordFailure(e.GetMessage());
+        throw;
+    }
+    Unlock(lock_file_descriptor);
+
+    mPendingData.clear();
+    mNumPendingBytes = 0;
+    mHasCommitted = true;
+}
+
+void SweepResultsStore::AddRunToSweepFile()
+{
+    std::string runs_directory = mFilePath + ".runs";
+    if (mkdir(runs_directory.c_str(), 0755) != 0 && errno != EEXIST)
+    {
+        EXCEPTION("Could not create directory " << runs_directory);
+    }
+
+    // A run that is started again (e.g. after its worker died) replaces whatever its
+    // earlier attempt left behind, rather than adding to it; deleting its file frees the space
+    std::string run_file_path = GetRunFilePath(mFilePath, mTask);
+    if (mReplaceExistingRun && std::remove(run_file_path.c_str()) != 0 && errno != ENOENT)
+    {
+        EXCEPTION("Could not replace the data of run " << mTask.GetName() << " in the sweep results store");
+    }
+
+    std::vector<IndexRecord> records;
+    if (access(mFilePath.c_str(), F_OK) == 0)
+    {
+        hid_t file = H5Fopen(mFilePath.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+        if (file < 0)
+        {
+            EXCEPTION("Could not open sweep results store " << mFilePath);
+        }
+        try
+        {
+            records = ReadIndexRecords(file);
+        }
+        catch (Exception&)
+        {
+            H5Fclose(file);
+            throw;
+        }
+        H5Fclose(file);
+
+        for (unsigned i=0; i<records.size(); i++)
+        {
+            if (mTask.GetName() == records[i].mName)
+            {
+                // A replaced run is in the index already
+                return;
+            }
+        }
+    }
+
+    IndexRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.mLambda = mTask.mLambda;
+    record.mGamma = mTask.mGamma;
+    record.mSimulation = mTask.mSimulation;
+    record.mRun = mTask.mRun;
+    record.mSeed = mTask.mSeed;
+    std::strncpy(record.mName, mTask.GetName().c_str(), RUN_NAME_LENGTH - 1);
+    records.push_back(record);
+
+    ReplaceSweepFile(mFilePath, records);
+}
+
+void SweepResultsStore::AppendToRunFile()
+{
+    std::string run_file_path = GetRunFilePath(mFilePath, mTask);
+    bool exists = (access(run_file_path.c_str(), F_OK) == 0);
+    hid_t file = exists ? H5Fopen(run_file_path.c_str(), H5F_ACC_RDWR, H5P_DEFAULT)
+                        : H5Fcreate(run_file_path.c_str(), H5F_ACC_EXCL, H5P_DEFAULT, H5P_DEFAULT);
+    if (file < 0)
+    {
+        EXCEPTION("Could not open " << run_file_path << " in the sweep results store");
+    }
+
+    try
+    {
+        if (!exists)
+        {
+            // First data for this run: tag its file
+            WriteAttribute(file, "Lambda", H5T_NATIVE_DOUBLE, &mTask.mLambda);
+            WriteAttribute(file, "Gamma", H5T_NATIVE_DOUBLE, &mTask.mGamma);
+            WriteAttribute(file, "Simulation", H5T_NATIVE_UINT, &mTask.mSimulation);
+            WriteAttribute(file, "Run", H5T_NATIVE_UINT, &mTask.mRun);
+            WriteAttribute(file, "Seed", H5T_NATIVE_UINT, &mTask.mSeed);
+        }
+
+        for (std::map<std::string, std::string>::iterator iter = mPendingData.begin();
+             iter != mPendingData.end();
+             ++iter)
+        {
+            if (!iter->second.empty())
+            {
+                AppendToDataset(file, iter->first, H5T_NATIVE_CHAR, iter->second.data(), iter->second.size(), 1u << 16);
+            }
+        }
+    }
+    catch (Exception&)
+    {
+        H5Fclose(file);
+        throw;
+    }
+
+    if (H5Fclose(file) < 0)
+    {
+        EXCEPTION("Could not write " << run_file_path << " in the sweep results store");
+    }
+}
+
+void SweepResultsStore::RecordFailure(const std::string& rMessage)
+{
+    if (mFailure.empty())
+    {
+        mFailure = rMessage;
+    }
+}
+
+void SweepResultsStore::SetReplaceExistingRun(bool replaceExistingRun)
+{
+    mReplaceExistingRun = replaceExistingRun;
+}
+
+void SweepResultsStore::SetCommitThreshold(std::size_t commitThreshold)
+{
+    mCommitThreshold = commitThreshold;
+}
+
+const std::string& SweepResultsStore::rGetFilePath() const
+{
+    return mFilePath;
+}
+
+const SweepTask& SweepResultsStore::rGetTask() const
+{
+    return mTask;
+}
+
+std::string SweepResultsStore::GetRunFilePath(const std::string& rFilePath, const SweepTask& rTask)
+{
+    return rFilePath + ".runs/" + rTask.GetName() + ".h5";
+}
+
+std::vector<SweepTask> SweepResultsStore::ReadIndex(const std::string& rFilePath)
+{
+    int lock_file_descriptor = Lock(rFilePath, false);
+    hid_t file = H5Fopen(rFilePath.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    if (file < 0)
+    {
+        Unlock(lock_file_descriptor);
+        EXCEPTION("Could not open sweep results store " << rFilePath);
+    }
+
+    std::vector<IndexRecord> records;
+    try
+    {
+        records = ReadIndexRecords(file);
+    }
+    catch (Exception&)
+    {
+        H5Fclose(file);
+        Unlock(lock_file_descriptor);
+        throw;
+    }
+    H5Fclose(file);
+    Unlock(lock_file_descriptor);
+
+    std::vector<SweepTask> tasks;
+    for (unsigned i=0; i<records.size(); i++)
+    {
+        tasks.push_back(SweepTask(records[i].mLambda, records[i].mGamma, records[i].mSimulation,
+                                  records[i].mRun, records[i].mSeed));
+    }
+    return tasks;
+}
+
+std::string SweepResultsStore::ReadDataset(const std::string& rFilePath, const SweepTask& rTask, const std::string& rDatasetName)
+{
+    // Held until the run's file, reached through the link, has been read as well
+    int lock_file_descriptor = Lock(rFilePath, false);
+    hid_t file = H5Fopen(rFilePath.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    if (file < 0)
+    {
+        Unlock(lock_file_descriptor);
+        EXCEPTION("Could not open sweep results store " << rFilePath);
+    }
+
+    std::string path = "runs/" + rTask.GetName() + "/" + rDatasetName;
+    if (H5Lexists(file, "runs", H5P_DEFAULT) <= 0
+        || H5Lexists(file, ("runs/" + rTask.GetName()).c_str(), H5P_DEFAULT) <= 0
+        || access(GetRunFilePath(rFilePath, rTask).c_str(), F_OK) != 0
+        || H5Lexists(file, path.c_str(), H5P_DEFAULT) <= 0)
+    {
+        H5Fclose(file);
+        Unlock(lock_file_descriptor);
+        EXCEPTION("No dataset " << path << " in sweep results store " << rFilePath);
+    }
+
+    hid_t dataset = H5Dopen2(file, path.c_str(), H5P_DEFAULT);
+    if (dataset < 0)
+    {
+        H5Fclose(file);
+        Unlock(lock_file_descriptor);
+        EXCEPTION("Could not open dataset " << path << " in sweep results store " << rFilePath);
+    }
+    hid_t space = H5Dget_space(dataset);
+    hsize_t size;
+    H5Sget_simple_extent_dims(space, &size, nullptr);
+
+    std::string data(size, '\0');
+    herr_t status = size > 0 ? H5Dread(dataset, H5T_NATIVE_CHAR, H5S_ALL, H5S_ALL, H5P_DEFAULT, &data[0]) : 0;
+
+    H5Sclose(space);
+    H5Dclose(dataset);
+    H5Fclose(file);
+    Unlock(lock_file_descriptor);
+
+    if (status < 0)
+    {
+        EXCEPTION("Could not read dataset " << path << " in sweep results store " << rFilePath);
+    }
+    return data;
+}
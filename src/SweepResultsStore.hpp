@@ -0,0 +1,227 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef SWEEPRESULTSSTORE_HPP_
+#define SWEEPRESULTSSTORE_HPP_
+
+#include <map>
+#include <string>
+#include <vector>
+#include "SweepTask.hpp"
+
+/**
+ * An HDF5 store holding the output of every run of a parameter sweep.
+ *
+ * Rather than one directory per run with one file per writer, each run gets
+ * an HDF5 file of its own, <file>.runs/<run name>.h5, tagged with Lambda,
+ * Gamma, Simulation, Run and seed attributes, in which each writer's output
+ * becomes a (compressed, extendible) character dataset named after the
+ * writer's file. The sweep file itself holds only a compound dataset /index,
+ * with one row per run, and an external link /runs/<run name> to each run's
+ * file, so that a whole sweep can be found with a single indexed read and
+ * browsed as one file.
+ *
+ * Several processes may append to the same store. Access is serialised with
+ * an fcntl() lock on a "<file>.lock" file next to the store: writers hold it
+ * exclusively while they commit, and ReadIndex() and ReadDataset() hold it
+ * shared while they read. To keep the number of opens (and lock round trips)
+ * small, appended data are buffered in memory and only committed when more
+ * than a threshold amount is pending or when Commit() is called.
+ *
+ * A process that dies in the middle of a commit can only damage the file of
+ * its own run. The sweep file is only changed when a run is added to it, by
+ * writing a new copy next to it and renaming that over the old one, so it is
+ * either the old or the new file, never a mixture.
+ *
+ * If the run already has a file when the first commit is made, for example
+ * because an earlier attempt at the run died part way through, that file is
+ * deleted first, unless SetReplaceExistingRun(false) has been called.
+ *
+ * A failed commit, or a failure reported with RecordFailure(), makes every
+ * later call to Commit() throw, so that a run whose output was lost fails
+ * rather than finishing as usual. Owners should therefore call Commit() at
+ * the end of a run; the destructor only commits on a best-effort basis, for
+ * runs that are failing anyway.
+ */
+class SweepResultsStore
+{
+private:
+
+    /** The path of the HDF5 file. */
+    std::string mFilePath;
+
+    /** The run that this store writes data for. */
+    SweepTask mTask;
+
+    /** Data waiting to be committed, keyed by dataset (i.e. writer file) name. */
+    std::map<std::string, std::string> mPendingData;
+
+    /** The total number of bytes in mPendingData. */
+    std::size_t mNumPendingBytes;
+
+    /** Commit when more than this many bytes are pending. Defaults to 4 MiB. */
+    std::size_t mCommitThreshold;
+
+    /** Whether the first commit replaces any data the run already has. Defaults to true. */
+    bool mReplaceExistingRun;
+
+    /** Whether this object has committed any data yet. */
+    bool mHasCommitted;
+
+    /** Why some of the run's output was lost, or empty if none was. */
+    std::string mFailure;
+
+    /**
+     * Acquire the lock on a store.
+     *
+     * @param rFilePath the path of the HDF5 file
+     * @param exclusive whether to lock the store for writing, rather than for reading
+     * @return the file descriptor holding the lock
+     */
+    static int Lock(const std::string& rFilePath, bool exclusive);
+
+    /**
+     * Release the lock on a store.
+     *
+     * @param lockFileDescriptor the file descriptor returned by Lock()
+     */
+    static void Unlock(int lockFileDescriptor);
+
+    /**
+     * Add this run to the index and links of the sweep file, unless it is
+     * there already, and delete the run's file if it is to be replaced. The
+     * store must be locked.
+     */
+    void AddRunToSweepFile();
+
+    /**
+     * Append the pending data to the run's file, creating it if necessary. The
+     * store must be locked.
+     */
+    void AppendToRunFile();
+
+public:
+
+    /**
+     * Constructor. The HDF5 file is created on the first commit if it does not exist yet.
+     *
+     * @param rFilePath the path of the HDF5 file shared by the whole sweep
+     * @param rTask the run this store writes data for
+     */
+    SweepResultsStore(const std::string& rFilePath, const SweepTask& rTask);
+
+    /**
+     * Destructor. Tries to commit any pending data, which are only left if the
+     * run has failed without calling Commit(), so errors are ignored.
+     */
+    ~SweepResultsStore();
+
+    /**
+     * Append data to one of this run's datasets.
+     *
+     * @param rDatasetName the dataset name (the writer's file name)
+     * @param rData the data to append
+     */
+    void Append(const std::string& rDatasetName, const std::string& rData);
+
+    /**
+     * Write all pending data to the run's file.
+     *
+     * Throws if this or an earlier commit fails, or if a failure has been recorded.
+     */
+    void Commit();
+
+    /**
+     * Record that some of the run's output was lost, e.g. by a stream buffer,
+     * which cannot throw, so that the next call to Commit() throws. Only the
+     * first failure is kept.
+     *
+     * @param rMessage what went wrong
+     */
+    void RecordFailure(const std::string& rMessage);
+
+    /**
+     * Set whether the first commit replaces any data the run already has in the
+     * store, or appends to them. Appending is right when a run carries on from a
+     * checkpoint, whose output up to the checkpoint is in the store already.
+     *
+     * @param replaceExistingRun whether to replace the run's existing data
+     */
+    void SetReplaceExistingRun(bool replaceExistingRun);
+
+    /**
+     * Set the amount of pending data that triggers a commit.
+     *
+     * @param commitThreshold the threshold in bytes
+     */
+    void SetCommitThreshold(std::size_t commitThreshold);
+
+    /**
+     * @return the path of the HDF5 file
+     */
+    const std::string& rGetFilePath() const;
+
+    /**
+     * @return the run that this store writes data for
+     */
+    const SweepTask& rGetTask() const;
+
+    /**
+     * @param rFilePath the path of the HDF5 file
+     * @param rTask the run
+     * @return the path of the HDF5 file holding the run's data
+     */
+    static std::string GetRunFilePath(const std::string& rFilePath, const SweepTask& rTask);
+
+    /**
+     * Read the index of a store.
+     *
+     * @param rFilePath the path of the HDF5 file
+     * @return the runs in the store, in the order they were first written
+     */
+    static std::vector<SweepTask> ReadIndex(const std::string& rFilePath);
+
+    /**
+     * Read one dataset of one run from a store.
+     *
+     * @param rFilePath the path of the HDF5 file
+     * @param rTask the run
+     * @param rDatasetName the dataset name (the writer's file name)
+     * @return the contents of the dataset
+     */
+    static std::string ReadDataset(const std::string& rFilePath, const SweepTask& rTask, const std::string& rDatasetName);
+};
+
+#endif /*SWEEPRESULTSSTORE_HPP_*/
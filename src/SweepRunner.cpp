@@ -0,0 +1,288 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "SweepRunner.hpp"
+#include "BufferedTextEmitter.hpp"
+#include "CommandLineArguments.hpp"
+#include "Exception.hpp"
+#include "OutputFileHandler.hpp"
+#include "RunManifest.hpp"
+#include "RunTruncationMarker.hpp"
+#include "SimulationFailureRecord.hpp"
+#include "Version.hpp"
+
+#include <chrono>
+
+SweepRunner::SweepRunner(const PaperVertexSimulationParameters& rParameters, const std::string& rOutputDirectory)
+    : mParameters(rParameters),
+      mOutputDirectory(rOutputDirectory),
+      mSkipCompletedRuns(false)
+{
+}
+
+void SweepRunner::SetStorePath(const std::string& rStorePath)
+{
+    mStorePath = rStorePath;
+}
+
+void SweepRunner::SetSkipCompletedRuns(bool skipCompletedRuns)
+{
+    mSkipCompletedRuns = skipCompletedRuns;
+}
+
+void SweepRunner::SetResultCache(boost::shared_ptr<ResultCache> pResultCache)
+{
+    mpResultCache = pResultCache;
+}
+
+void SweepRunner::SetOptionsFromCommandLine()
+{
+    CommandLineArguments* p_args = CommandLineArguments::Instance();
+
+    // -compress gzips the output of the project writers, e.g. for large sweeps
+    mParameters.mCompressOutput = p_args->OptionExists("-compress");
+
+    // -faster_force uses FasterFarhadifarForce instead of Chaste's FarhadifarForce
+    mParameters.mUseFasterForce = p_args->OptionExists("-faster_force");
+
+    // -spatial_hash checks for T3 swaps with a SpatialHashIntersectionModifier instead of the mesh
+    mParameters.mUseSpatialHash = p_args->OptionExists("-spatial_hash");
+
+    // -renumber has FasterFarhadifarForce renumber its copy of the mesh for locality
+    mParameters.mRenumberMesh = p_args->OptionExists("-renumber");
+
+    // -cell_data_table grows the target areas with a TableTargetAreaModifier, with -faster_force
+    mParameters.mUseCellDataTable = p_args->OptionExists("-cell_data_table");
+
+    // -detect_divergence stops diverging runs with a DivergenceDetectionModifier
+    mParameters.mDetectDivergence = p_args->OptionExists("-detect_divergence");
+
+    // -integrator <name> picks the numerical method (ForwardEuler, RK23, RK45 or SemiImplicit) and
+    // -integrator_tolerance <x> the tolerance of the adaptive ones
+    if (p_args->OptionExists("-integrator"))
+    {
+        mParameters.mNumericalMethod = p_args->GetStringCorrespondingToOption("-integrator");
+    }
+    if (p_args->OptionExists("-integrator_tolerance"))
+    {
+        mParameters.mIntegratorTolerance = p_args->GetDoubleCorrespondingToOption("-integrator_tolerance");
+    }
+
+    // -wall_time_budget <seconds> and -time_step_budget <n> stop each run that takes longer, leaving a
+    // checkpoint to resume from with -resume. Budgets in the sweep CSV take precedence. These are not
+    // part of the cache key, since truncated runs are not cached
+    if (p_args->OptionExists("-wall_time_budget"))
+    {
+        mParameters.mWallTimeBudget = p_args->GetDoubleCorrespondingToOption("-wall_time_budget");
+    }
+    if (p_args->OptionExists("-time_step_budget"))
+    {
+        mParameters.mTimeStepBudget = p_args->GetUnsignedCorrespondingToOption("-time_step_budget");
+    }
+
+    // -force_threads <n> calculates the forces on n threads (0 for one per hardware thread).
+    // This is not part of the cache key, since the results are the same for any n
+    if (p_args->OptionExists("-force_threads"))
+    {
+        mParameters.mNumForceThreads = p_args->GetUnsignedCorrespondingToOption("-force_threads");
+    }
+
+    // -store <file.h5> collects the output of the project writers for the whole sweep in one HDF5 file
+    if (p_args->OptionExists("-store"))
+    {
+        SetStorePath(p_args->GetStringCorrespondingToOption("-store"));
+    }
+
+    // -resume skips runs that finished before (i.e. that have a RunComplete.manifest), fails runs
+    // that diverged before (i.e. that have a RunFailure.record) without rerunning them, and carries
+    // on with runs that were truncated before (i.e. that have a RunTruncated.marker) from their checkpoints
+    SetSkipCompletedRuns(p_args->OptionExists("-resume"));
+
+    // -cache <directory> reuses the summary statistics of identical runs, also from other sweeps
+    if (p_args->OptionExists("-cache"))
+    {
+        std::uintmax_t max_size = (std::uintmax_t)1 << 28;
+        if (p_args->OptionExists("-cache_size"))
+        {
+            max_size = (std::uintmax_t)p_args->GetUnsignedCorrespondingToOption("-cache_size") << 20;
+        }
+        SetResultCache(boost::shared_ptr<ResultCache>(new ResultCache(p_args->GetStringCorrespondingToOption("-cache"), max_size)));
+    }
+}
+
+PaperVertexSimulationParameters SweepRunner::GetRunParameters(const SweepTask& rTask) const
+{
+    PaperVertexSimulationParameters parameters = mParameters;
+    parameters.mLineTensionParameter = rTask.mLambda;
+    parameters.mPerimeterContractilityParameter = rTask.mGamma;
+    if (rTask.mWallTimeBudget > 0.0)
+    {
+        parameters.mWallTimeBudget = rTask.mWallTimeBudget;
+    }
+    if (rTask.mTimeStepBudget > 0u)
+    {
+        parameters.mTimeStepBudget = rTask.mTimeStepBudget;
+    }
+    return parameters;
+}
+
+std::string SweepRunner::GetCacheKey(const SweepTask& rTask) const
+{
+    PaperVertexSimulationParameters parameters = GetRunParameters(rTask);
+
+    BufferedTextEmitter key(1024);
+    key.SetUseShortestRoundTrip(true);
+    key << "PaperVertexSimulation\n"
+        << "ChasteVersion=" << ChasteBuildInfo::GetVersionString() << '\n'
+        << "ProjectVersions=" << ChasteBuildInfo::GetProjectVersions() << '\n';
+
+    // The revision does not capture uncommitted changes, so then the build itself identifies the code
+    if (ChasteBuildInfo::IsWorkingCopyModified())
+    {
+        key << "BuildTime=" << ChasteBuildInfo::GetBuildTime() << '\n';
+    }
+
+    key << "Lambda=" << parameters.mLineTensionParameter << '\n'
+        << "Gamma=" << parameters.mPerimeterContractilityParameter << '\n'
+        << "BoundaryLineTension=" << (parameters.mLineTensionParameter < 0 ? 0.0 : parameters.mLineTensionParameter) << '\n'
+        << "NumberGenerations=" << parameters.mNumberGenerations << '\n'
+        << "AverageCellCycleTime=" << parameters.mAverageCellCycleTime << '\n'
+        << "NewEdgeLengthFactor=" << parameters.mNewEdgeLengthFactor << '\n'
+        << "RestrictVertexMovement=" << parameters.mRestrictVertexMovement << '\n'
+        << "RandomiseT1SwapOrder=" << parameters.mRandomiseT1SwapOrder << '\n'
+        << "T1SwapThreshold=" << parameters.mT1SwapThreshold << '\n'
+        << "T2SwapThreshold=" << parameters.mT2SwapThreshold << '\n'
+        << "InitialSize=" << parameters.mInitialSize << '\n'
+        << "Dt=" << parameters.mDt << '\n'
+        << "EndTime=" << parameters.mEndTime << '\n'
+        << "FasterForce=" << parameters.mUseFasterForce << '\n';
+
+    // Left out for forward Euler, so that the keys of earlier runs still match
+    if (parameters.mNumericalMethod != "ForwardEuler")
+    {
+        key << "NumericalMethod=" << parameters.mNumericalMethod << '\n'
+            << "IntegratorTolerance=" << parameters.mIntegratorTolerance << '\n';
+    }
+    // The T3 swaps happen at a different point of the time step with the spatial hash
+    if (parameters.mUseSpatialHash)
+    {
+        key << "SpatialHash=1\n";
+    }
+    // Renumbering changes the order in which the forces on each vertex are summed
+    if (parameters.mUseFasterForce && parameters.mRenumberMesh)
+    {
+        key << "Renumbering=1\n";
+    }
+    // TableTargetAreaModifier has its own copy of the growth law
+    if (parameters.mUseCellDataTable)
+    {
+        key << "CellDataTable=1\n";
+    }
+    // A diverging run fails with the modifier, instead of producing results
+    if (parameters.mDetectDivergence)
+    {
+        key << "DetectDivergence=1\n";
+    }
+    key << "Seed=" << rTask.mSeed << '\n';
+    return key.GetString();
+}
+
+std::string SweepRunner::GetRunDirectory(const SweepTask& rTask) const
+{
+    return OutputFileHandler::GetChasteTestOutputDirectory() + mOutputDirectory + "/" + rTask.GetName() + "/";
+}
+
+bool SweepRunner::IsComplete(const SweepTask& rTask) const
+{
+    return RunManifest::Exists(GetRunDirectory(rTask));
+}
+
+TissueSummaryStatistics SweepRunner::Run(const SweepTask& rTask)
+{
+    if (mSkipCompletedRuns && IsComplete(rTask))
+    {
+        return TissueSummaryStatistics::FromString(RunManifest::Read(GetRunDirectory(rTask))["Statistics"]);
+    }
+    if (mSkipCompletedRuns && SimulationFailureRecord::Exists(GetRunDirectory(rTask)))
+    {
+        EXCEPTION("The simulation diverged in an earlier attempt: "
+                  << SimulationFailureRecord::Read(GetRunDirectory(rTask)).GetDescription());
+    }
+
+    // A seed of zero means a seed from the clock, so such runs cannot be reproduced or cached
+    std::string cache_key;
+    if (mpResultCache && rTask.mSeed != 0u)
+    {
+        cache_key = GetCacheKey(rTask);
+        std::string cached_statistics;
+        if (mpResultCache->Lookup(cache_key, cached_statistics))
+        {
+            return TissueSummaryStatistics::FromString(cached_statistics);
+        }
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    PaperVertexSimulation simulation(GetRunParameters(rTask), mOutputDirectory + "/" + rTask.GetName());
+    if (!mStorePath.empty())
+    {
+        boost::shared_ptr<SweepResultsStore> p_results_store(new SweepResultsStore(mStorePath, rTask));
+        simulation.SetResultsStore(p_results_store);
+    }
+    simulation.SetResumeFromCheckpoint(mSkipCompletedRuns);
+    TissueSummaryStatistics statistics = simulation.Run(rTask.mSeed);
+
+    // A truncated run has not finished, so it gets neither a manifest nor a cache entry
+    if (simulation.WasTruncated())
+    {
+        EXCEPTION("The run was stopped early: " << RunTruncationMarker::Read(GetRunDirectory(rTask)).GetDescription()
+                  << "; pass -resume to carry on from its checkpoint");
+    }
+
+    double wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    RunManifest::Write(GetRunDirectory(rTask), rTask, wall_time, statistics.ToString());
+
+    if (!cache_key.empty())
+    {
+        mpResultCache->Insert(cache_key, statistics.ToString());
+    }
+
+    return statistics;
+}
+
+std::string SweepRunner::RunToString(const SweepTask& rTask)
+{
+    return Run(rTask).ToString();
+}
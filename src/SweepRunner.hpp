@@ -0,0 +1,160 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef SWEEPRUNNER_HPP_
+#define SWEEPRUNNER_HPP_
+
+#include <string>
+#include <boost/shared_ptr.hpp>
+#include "PaperVertexSimulation.hpp"
+#include "ResultCache.hpp"
+#include "SweepTask.hpp"
+#include "TissueSummaryStatistics.hpp"
+
+/**
+ * Runs the tasks of a sweep as PaperVertexSimulations, in the way shared by
+ * all the sweep drivers (TestPaperCommandLineVertexSimulation, TestPaperSweepFarm
+ * and TestPaperQueueWorker): each run gets Lambda, Gamma and the seed from its
+ * task and its own output directory, named after the task, under a common root.
+ *
+ * When a run finishes, its RunManifest is written. If skipping of completed runs
+ * is switched on, a run that already has a manifest is not simulated again; its
+ * summary statistics are read back from the manifest instead.
+ */
+class SweepRunner
+{
+private:
+
+    /** The simulation parameters other than Lambda and Gamma. */
+    PaperVertexSimulationParameters mParameters;
+
+    /** The output directory of the sweep, relative to CHASTE_TEST_OUTPUT. */
+    std::string mOutputDirectory;
+
+    /** The results store to write to, or empty to write to the output directories only. */
+    std::string mStorePath;
+
+    /** Whether to skip runs that already have a manifest. Defaults to false. */
+    bool mSkipCompletedRuns;
+
+    /** The cache of summary statistics, if any. */
+    boost::shared_ptr<ResultCache> mpResultCache;
+
+    /**
+     * @param rTask a run
+     * @return the simulation parameters for the run
+     */
+    PaperVertexSimulationParameters GetRunParameters(const SweepTask& rTask) const;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param rParameters the simulation parameters; Lambda and Gamma are taken from each task
+     * @param rOutputDirectory the output directory of the sweep, relative to CHASTE_TEST_OUTPUT
+     */
+    SweepRunner(const PaperVertexSimulationParameters& rParameters, const std::string& rOutputDirectory);
+
+    /**
+     * Send the output of the project writers to a results store.
+     *
+     * @param rStorePath the path of the store, or empty to write to the output directories only
+     */
+    void SetStorePath(const std::string& rStorePath);
+
+    /**
+     * Set whether to skip runs that already have a manifest. Runs that diverged
+     * before, and so have a SimulationFailureRecord, then fail straight away, and
+     * runs that were truncated before, and so have a RunTruncationMarker, are
+     * resumed from their checkpoints.
+     *
+     * @param skipCompletedRuns whether to skip completed runs
+     */
+    void SetSkipCompletedRuns(bool skipCompletedRuns);
+
+    /**
+     * Cache the summary statistics of runs.
+     *
+     * @param pResultCache the cache, or an empty pointer for no caching
+     */
+    void SetResultCache(boost::shared_ptr<ResultCache> pResultCache);
+
+    /**
+     * Set the options shared by the sweep drivers from the command line:
+     * -compress, -store (followed by the store file), -resume, and -cache (followed
+     * by the cache directory) with an optional -cache_size (in MiB).
+     */
+    void SetOptionsFromCommandLine();
+
+    /**
+     * @param rTask a run
+     * @return the text that identifies the run's result in a ResultCache: every
+     *     simulation input that affects the trajectory, the seed and the code version
+     */
+    std::string GetCacheKey(const SweepTask& rTask) const;
+
+    /**
+     * @param rTask a run
+     * @return the full path of the run's output directory, ending in '/'
+     */
+    std::string GetRunDirectory(const SweepTask& rTask) const;
+
+    /**
+     * @param rTask a run
+     * @return whether the run has finished before, i.e. has a manifest
+     */
+    bool IsComplete(const SweepTask& rTask) const;
+
+    /**
+     * Run one run of the sweep, unless it is complete and skipping is switched on.
+     * Throws if the run diverges, or diverged before and skipping is switched on,
+     * or if it uses up its budget, in which case it can be resumed later.
+     *
+     * @param rTask the run
+     * @return the summary statistics of the run
+     */
+    TissueSummaryStatistics Run(const SweepTask& rTask);
+
+    /**
+     * As Run(), for use with SweepFarm, SimulationWorkerPool and SweepQueueClient.
+     *
+     * @param rTask the run
+     * @return the summary statistics of the run, as a string
+     */
+    std::string RunToString(const SweepTask& rTask);
+};
+
+#endif /*SWEEPRUNNER_HPP_*/
@@ -0,0 +1,191 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "SweepTask.hpp"
+#include "BufferedTextEmitter.hpp"
+#include "Exception.hpp"
+#include "Philox4x32.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+SweepTask::SweepTask()
+    : mLambda(0.0),
+      mGamma(0.0),
+      mSimulation(0u),
+      mRun(0u),
+      mSeed(0u),
+      mWallTimeBudget(0.0),
+      mTimeStepBudget(0u)
+{
+}
+
+SweepTask::SweepTask(double lambda, double gamma, unsigned simulation, unsigned run, unsigned seed)
+    : mLambda(lambda),
+      mGamma(gamma),
+      mSimulation(simulation),
+      mRun(run),
+      mSeed(seed),
+      mWallTimeBudget(0.0),
+      mTimeStepBudget(0u)
+{
+}
+
+std::string SweepTask::GetName() const
+{
+    // Shortest round-trip formatting gives the same text as the CSV, e.g. 0.12 rather than 0.120000
+    BufferedTextEmitter name(128);
+    name.SetUseShortestRoundTrip(true);
+    name << "_Sim_Number_" << mSimulation << "Lambda__" << mLambda << "_Gamma_" << mGamma << "_Run_" << mRun;
+    return name.GetString();
+}
+
+/**
+ * Apply a 4-round Feistel network on 16-bit halves to a 32-bit value. Whatever
+ * the round function, the network is a permutation of 32-bit values.
+ *
+ * @param value the value
+ * @param rRoundKeys one key per round
+ * @return the permuted value
+ */
+static std::uint32_t FeistelPermute(std::uint32_t value, const Philox4x32::Block& rRoundKeys)
+{
+    std::uint32_t left = value >> 16;
+    std::uint32_t right = value & 0xFFFFu;
+    for (unsigned round=0; round<4; round++)
+    {
+        // Round function: the finaliser of MurmurHash3 applied to the keyed half
+        std::uint32_t mixed = right ^ rRoundKeys[round];
+        mixed ^= mixed >> 16;
+        mixed *= 0x85EBCA6Bu;
+        mixed ^= mixed >> 13;
+        mixed *= 0xC2B2AE35u;
+        mixed ^= mixed >> 16;
+
+        std::uint32_t new_right = left ^ (mixed & 0xFFFFu);
+        left = right;
+        right = new_right;
+    }
+    return (left << 16) | right;
+}
+
+unsigned SweepTask::DeriveSeed(unsigned sweepId, unsigned simulation, unsigned run)
+{
+    if (simulation > 0xFFFFu || run == 0u || run > 0xFFFFu)
+    {
+        EXCEPTION("Cannot derive a seed for simulation " << simulation << ", run " << run
+                  << "; simulation numbers must be below 65536 and run numbers from 1 to 65535");
+    }
+
+    // The second key word just separates these round keys from other uses of the sweep id as a key
+    Philox4x32::Block counter = {{0u, 0u, 0u, 0u}};
+    Philox4x32::Key key = {{sweepId, 0x5EEDu}};
+    Philox4x32::Block round_keys = Philox4x32::Generate(counter, key);
+
+    std::uint32_t seed = FeistelPermute((simulation << 16) | run, round_keys);
+    if (seed == 0u)
+    {
+        // Run 0 is never used, so its image is free and cannot collide with another run's seed
+        seed = FeistelPermute(simulation << 16, round_keys);
+    }
+    return seed;
+}
+
+std::vector<SweepTask> SweepTask::ReadSweepFile(const std::string& rFilePath, unsigned sweepId)
+{
+    std::ifstream file(rFilePath.c_str());
+    if (!file.is_open())
+    {
+        EXCEPTION("Could not open sweep file " << rFilePath);
+    }
+
+    std::vector<SweepTask> tasks;
+    std::string line;
+    unsigned line_number = 0;
+    while (std::getline(file, line))
+    {
+        line_number++;
+        if (!line.empty() && line[line.size()-1] == '\r')
+        {
+            line.erase(line.size()-1);
+        }
+        if (line.find_first_not_of(" \t") == std::string::npos)
+        {
+            continue;
+        }
+
+        std::vector<double> values;
+        std::istringstream line_stream(line);
+        std::string field;
+        bool is_numeric = true;
+        while (std::getline(line_stream, field, ','))
+        {
+            char* p_end;
+            values.push_back(std::strtod(field.c_str(), &p_end));
+            is_numeric = is_numeric && p_end != field.c_str();
+        }
+
+        if (!is_numeric)
+        {
+            // The header line, or a malformed row
+            if (line_number == 1)
+            {
+                continue;
+            }
+            EXCEPTION("Could not read line " << line_number << " of sweep file " << rFilePath);
+        }
+        if (values.size() < 4)
+        {
+            EXCEPTION("Line " << line_number << " of sweep file " << rFilePath << " needs Lambda, Gamma, Runs and Simulation columns");
+        }
+
+        unsigned num_runs = (unsigned)values[2];
+        unsigned simulation = (unsigned)values[3];
+        for (unsigned run=1; run<=num_runs; run++)
+        {
+            tasks.push_back(SweepTask(values[0], values[1], simulation, run, DeriveSeed(sweepId, simulation, run)));
+            if (values.size() > 4)
+            {
+                tasks.back().mWallTimeBudget = values[4];
+            }
+            if (values.size() > 5)
+            {
+                tasks.back().mTimeStepBudget = (unsigned)values[5];
+            }
+        }
+    }
+    return tasks;
+}
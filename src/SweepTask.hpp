@@ -0,0 +1,125 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef SWEEPTASK_HPP_
+#define SWEEPTASK_HPP_
+
+#include <string>
+#include <vector>
+
+/**
+ * Identifies a single run of a parameter sweep: the line tension (Lambda) and
+ * perimeter contractility (Gamma) parameters, the simulation number (a row in a
+ * sweep CSV file such as ExampleCommandLineCSV.csv), the run number of that row
+ * and the random seed used for the run.
+ */
+struct SweepTask
+{
+    /** The line tension parameter, Lambda. */
+    double mLambda;
+
+    /** The perimeter contractility parameter, Gamma. */
+    double mGamma;
+
+    /** The simulation number, i.e. the Simulation column of the sweep CSV. */
+    unsigned mSimulation;
+
+    /** The run number, from 1 to the Runs column of the sweep CSV. */
+    unsigned mRun;
+
+    /** The random seed for the run. */
+    unsigned mSeed;
+
+    /** The wall-clock time budget of the run in seconds, from the sweep CSV, or 0 for the sweep's default. */
+    double mWallTimeBudget;
+
+    /** The time step budget of the run, from the sweep CSV, or 0 for the sweep's default. */
+    unsigned mTimeStepBudget;
+
+    /**
+     * Default constructor. All fields are set to zero.
+     */
+    SweepTask();
+
+    /**
+     * Constructor. The budgets are set to zero.
+     *
+     * @param lambda the line tension parameter
+     * @param gamma the perimeter contractility parameter
+     * @param simulation the simulation number
+     * @param run the run number
+     * @param seed the random seed
+     */
+    SweepTask(double lambda, double gamma, unsigned simulation, unsigned run, unsigned seed=0u);
+
+    /**
+     * @return a name for the run, suitable for use as a file or group name, in
+     * the same form as the output directories of TestPaperCommandLineVertexSimulation,
+     * e.g. "_Sim_Number_3Lambda__0.12_Gamma_0.1_Run_2"
+     */
+    std::string GetName() const;
+
+    /**
+     * Derive the random seed of a run from the sweep it belongs to.
+     *
+     * The simulation and run numbers are packed into 32 bits and passed through a
+     * Feistel permutation whose round keys are drawn from a Philox4x32 stream keyed
+     * by the sweep id. Distinct (simulation, run) pairs of a sweep therefore always
+     * get distinct seeds, unlike (simulation + run)*factor, while the seeds of
+     * different sweeps are unrelated. The seed is never 0, which PaperVertexSimulation
+     * would take to mean a time-based seed.
+     *
+     * @param sweepId identifies the sweep (the -opt5 option of TestPaperCommandLineVertexSimulation)
+     * @param simulation the simulation number, less than 65536
+     * @param run the run number, from 1 to 65535
+     * @return the seed
+     */
+    static unsigned DeriveSeed(unsigned sweepId, unsigned simulation, unsigned run);
+
+    /**
+     * Read a sweep CSV file such as ExampleCommandLineCSV.csv, with columns
+     * Lambda, Gamma, Runs and Simulation and an optional header line, and expand
+     * each row into one task per run, seeded by DeriveSeed(). Two more columns,
+     * WallTimeBudget (in seconds) and TimeStepBudget, may give each row's runs
+     * their own budgets; see BudgetedOffLatticeSimulation.
+     *
+     * @param rFilePath the path of the CSV file
+     * @param sweepId identifies the sweep; see DeriveSeed()
+     * @return the tasks, in file order and then run order
+     */
+    static std::vector<SweepTask> ReadSweepFile(const std::string& rFilePath, unsigned sweepId);
+};
+
+#endif /*SWEEPTASK_HPP_*/
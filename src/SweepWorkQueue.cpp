@@ -0,0 +1,284 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "SweepWorkQueue.hpp"
+#include "Exception.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+namespace
+{
+    /**
+     * @param rText some text
+     * @return the text with tabs and line breaks replaced by spaces, so that it fits in one field of a line
+     */
+    std::string ToSingleField(const std::string& rText)
+    {
+        std::string field = rText;
+        for (unsigned i=0; i<field.size(); i++)
+        {
+            if (field[i] == '\t' || field[i] == '\n' || field[i] == '\r')
+            {
+                field[i] = ' ';
+            }
+        }
+        return field;
+    }
+
+    /**
+     * @param rText a line of the completion file, without its checksum
+     * @return the 32-bit FNV-1a hash of the text, as eight hexadecimal digits
+     */
+    std::string Checksum(const std::string& rText)
+    {
+        uint32_t hash = 2166136261u;
+        for (unsigned i=0; i<rText.size(); i++)
+        {
+            hash = (hash ^ static_cast<unsigned char>(rText[i]))*16777619u;
+        }
+        char checksum[9];
+        std::snprintf(checksum, sizeof(checksum), "%08x", hash);
+        return checksum;
+    }
+}
+
+SweepWorkQueue::SweepWorkQueue(const std::vector<SweepTask>& rTasks, const std::string& rCompletionFilePath,
+                               double leaseDuration, unsigned maxAttempts)
+    : mTasks(rTasks),
+      mLeaseDuration(leaseDuration),
+      mMaxAttempts(maxAttempts)
+{
+    if (mLeaseDuration <= 0.0)
+    {
+        EXCEPTION("The lease duration must be positive");
+    }
+    if (mMaxAttempts == 0)
+    {
+        EXCEPTION("The maximum number of attempts must be positive");
+    }
+
+    TaskRecord pending_record;
+    pending_record.mState = PENDING;
+    pending_record.mLeaseExpiry = 0.0;
+    pending_record.mNumAttempts = 0;
+    mRecords.assign(mTasks.size(), pending_record);
+
+    bool ends_with_line = LoadCompletionFile(rCompletionFilePath);
+
+    mCompletionFile.open(rCompletionFilePath.c_str(), std::ios::app);
+    if (!mCompletionFile.is_open())
+    {
+        EXCEPTION("Could not open completion file " << rCompletionFilePath);
+    }
+    if (!ends_with_line)
+    {
+        // End the line that was cut short, so that it does not run into the next one
+        mCompletionFile << '\n';
+        mCompletionFile.flush();
+    }
+}
+
+bool SweepWorkQueue::LoadCompletionFile(const std::string& rFilePath)
+{
+    std::ifstream file(rFilePath.c_str());
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (file.eof())
+        {
+            // The last line has no newline, so it was cut short by a crash; the task will be run again
+            return false;
+        }
+
+        // Lines are "<index>\t<task name>\t<succeeded|failed>\t<attempts>\t<output>\t<checksum>"
+        std::size_t last_tab = line.rfind('\t');
+        if (last_tab == std::string::npos || Checksum(line.substr(0, last_tab)) != line.substr(last_tab + 1))
+        {
+            // A line cut short by a crash, and then ended by the next queue; the task will be run again
+            continue;
+        }
+
+        std::istringstream line_stream(line.substr(0, last_tab));
+        std::string index_field, name, state, attempts_field, output;
+        if (!std::getline(line_stream, index_field, '\t') || !std::getline(line_stream, name, '\t')
+            || !std::getline(line_stream, state, '\t') || !std::getline(line_stream, attempts_field, '\t'))
+        {
+            continue;
+        }
+        std::getline(line_stream, output);
+
+        unsigned index = std::strtoul(index_field.c_str(), nullptr, 10);
+        if (index >= mTasks.size() || mTasks[index].GetName() != name)
+        {
+            EXCEPTION("Completion file " << rFilePath << " does not belong to this sweep: it records task "
+                      << name << " at position " << index_field);
+        }
+
+        TaskRecord& r_record = mRecords[index];
+        r_record.mState = (state == "succeeded") ? SUCCEEDED : FAILED;
+        r_record.mNumAttempts = std::strtoul(attempts_field.c_str(), nullptr, 10);
+        r_record.mOutput = output;
+    }
+    return true;
+}
+
+void SweepWorkQueue::Finish(unsigned index, TaskState state)
+{
+    TaskRecord& r_record = mRecords[index];
+    r_record.mState = state;
+    r_record.mWorker.clear();
+
+    std::ostringstream line;
+    line << index << '\t' << mTasks[index].GetName() << '\t'
+         << (state == SUCCEEDED ? "succeeded" : "failed") << '\t'
+         << r_record.mNumAttempts << '\t' << ToSingleField(r_record.mOutput);
+    mCompletionFile << line.str() << '\t' << Checksum(line.str()) << '\n';
+    mCompletionFile.flush();
+}
+
+bool SweepWorkQueue::IsLeasedTo(unsigned index, const std::string& rWorker) const
+{
+    return index < mRecords.size() && mRecords[index].mState == LEASED && mRecords[index].mWorker == rWorker;
+}
+
+bool SweepWorkQueue::Lease(const std::string& rWorker, double now, unsigned& rIndex)
+{
+    ExpireLeases(now);
+
+    for (unsigned index=0; index<mRecords.size(); index++)
+    {
+        TaskRecord& r_record = mRecords[index];
+        if (r_record.mState == PENDING)
+        {
+            r_record.mState = LEASED;
+            r_record.mWorker = rWorker;
+            r_record.mLeaseExpiry = now + mLeaseDuration;
+            r_record.mNumAttempts++;
+            rIndex = index;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SweepWorkQueue::Heartbeat(unsigned index, const std::string& rWorker, double now)
+{
+    if (!IsLeasedTo(index, rWorker))
+    {
+        return false;
+    }
+    mRecords[index].mLeaseExpiry = now + mLeaseDuration;
+    return true;
+}
+
+bool SweepWorkQueue::Complete(unsigned index, const std::string& rWorker, bool succeeded, const std::string& rOutput)
+{
+    if (!IsLeasedTo(index, rWorker))
+    {
+        return false;
+    }
+
+    TaskRecord& r_record = mRecords[index];
+    r_record.mOutput = rOutput;
+    if (succeeded)
+    {
+        Finish(index, SUCCEEDED);
+    }
+    else if (r_record.mNumAttempts >= mMaxAttempts)
+    {
+        Finish(index, FAILED);
+    }
+    else
+    {
+        r_record.mState = PENDING;
+        r_record.mWorker.clear();
+    }
+    return true;
+}
+
+unsigned SweepWorkQueue::ExpireLeases(double now)
+{
+    unsigned num_expired = 0;
+    for (unsigned index=0; index<mRecords.size(); index++)
+    {
+        TaskRecord& r_record = mRecords[index];
+        if (r_record.mState == LEASED && r_record.mLeaseExpiry < now)
+        {
+            num_expired++;
+            r_record.mOutput = "Lease held by " + r_record.mWorker + " ran out";
+            if (r_record.mNumAttempts >= mMaxAttempts)
+            {
+                Finish(index, FAILED);
+            }
+            else
+            {
+                r_record.mState = PENDING;
+                r_record.mWorker.clear();
+            }
+        }
+    }
+    return num_expired;
+}
+
+bool SweepWorkQueue::IsFinished() const
+{
+    return GetNumTasks(SUCCEEDED) + GetNumTasks(FAILED) == mTasks.size();
+}
+
+unsigned SweepWorkQueue::GetNumTasks(TaskState state) const
+{
+    unsigned num_tasks = 0;
+    for (unsigned index=0; index<mRecords.size(); index++)
+    {
+        if (mRecords[index].mState == state)
+        {
+            num_tasks++;
+        }
+    }
+    return num_tasks;
+}
+
+const SweepTask& SweepWorkQueue::rGetTask(unsigned index) const
+{
+    return mTasks[index];
+}
+
+SweepWorkQueue::TaskState SweepWorkQueue::GetState(unsigned index) const
+{
+    return mRecords[index].mState;
+}
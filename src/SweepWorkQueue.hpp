@@ -0,0 +1,214 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef SWEEPWORKQUEUE_HPP_
+#define SWEEPWORKQUEUE_HPP_
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include "SweepTask.hpp"
+
+/**
+ * The book-keeping of a work queue for the tasks of a parameter sweep.
+ *
+ * Workers lease tasks one at a time. A lease lasts for a fixed time and is
+ * renewed by heartbeats from the worker; a task whose lease runs out (e.g.
+ * because its worker or node died) goes back into the queue. A task that is
+ * completed unsuccessfully is also re-issued, up to a maximum number of
+ * attempts, after which it is given up on.
+ *
+ * Finished tasks are recorded in a completion file, one line per task, which
+ * is appended to and flushed as soon as each task finishes. When a queue is
+ * created with an existing completion file, the tasks recorded in it are not
+ * run again, so a sweep can be restarted after a crash of the queue itself.
+ * Each line ends with a checksum of the rest of the line, and a line without
+ * its newline or with the wrong checksum (e.g. one cut short by a crash while
+ * it was being appended) does not count, so its task is run again.
+ *
+ * Times are passed in by the caller, in seconds, so that this class does not
+ * depend on a clock.
+ */
+class SweepWorkQueue
+{
+public:
+
+    /** The state of a task. */
+    enum TaskState
+    {
+        PENDING,  /**< Waiting to be leased. */
+        LEASED,   /**< Leased to a worker. */
+        SUCCEEDED,/**< Completed successfully. */
+        FAILED    /**< Failed too many times. */
+    };
+
+private:
+
+    /** The book-keeping for one task. */
+    struct TaskRecord
+    {
+        /** The state of the task. */
+        TaskState mState;
+
+        /** The worker holding the lease, if leased. */
+        std::string mWorker;
+
+        /** The time at which the lease runs out, if leased. */
+        double mLeaseExpiry;
+
+        /** The number of times the task has been leased. */
+        unsigned mNumAttempts;
+
+        /** The output of the last attempt. */
+        std::string mOutput;
+    };
+
+    /** The tasks of the sweep. */
+    std::vector<SweepTask> mTasks;
+
+    /** The book-keeping for each task. */
+    std::vector<TaskRecord> mRecords;
+
+    /** How long a lease lasts without a heartbeat, in seconds. */
+    double mLeaseDuration;
+
+    /** The number of times a task is tried before it is given up on. */
+    unsigned mMaxAttempts;
+
+    /** The completion file, open for appending. */
+    std::ofstream mCompletionFile;
+
+    /**
+     * Read a completion file and mark the tasks recorded in it as finished.
+     *
+     * @param rFilePath the path of the completion file
+     * @return whether the file is empty or ends with a complete line, so that the next line can be appended
+     */
+    bool LoadCompletionFile(const std::string& rFilePath);
+
+    /**
+     * Mark a task as finished and record it in the completion file.
+     *
+     * @param index the index of the task
+     * @param state SUCCEEDED or FAILED
+     */
+    void Finish(unsigned index, TaskState state);
+
+    /**
+     * @param index the index of a task
+     * @param rWorker a worker
+     * @return whether the task is currently leased to the worker
+     */
+    bool IsLeasedTo(unsigned index, const std::string& rWorker) const;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param rTasks the tasks of the sweep
+     * @param rCompletionFilePath the completion file, which is read if it exists and then appended to
+     * @param leaseDuration how long a lease lasts without a heartbeat, in seconds
+     * @param maxAttempts the number of times a task is tried before it is given up on
+     */
+    SweepWorkQueue(const std::vector<SweepTask>& rTasks, const std::string& rCompletionFilePath,
+                   double leaseDuration=60.0, unsigned maxAttempts=3u);
+
+    /**
+     * Lease the next pending task to a worker. Expired leases are returned to the
+     * queue first.
+     *
+     * @param rWorker the worker
+     * @param now the current time
+     * @param rIndex set to the index of the leased task
+     * @return whether a task was leased; if not, either all tasks are leased or all are finished
+     */
+    bool Lease(const std::string& rWorker, double now, unsigned& rIndex);
+
+    /**
+     * Renew a worker's lease on a task.
+     *
+     * @param index the index of the task
+     * @param rWorker the worker
+     * @param now the current time
+     * @return whether the worker still holds the lease; if not, it should abandon the task
+     */
+    bool Heartbeat(unsigned index, const std::string& rWorker, double now);
+
+    /**
+     * Record the outcome of a leased task. Outcomes from workers that no longer
+     * hold the lease are ignored.
+     *
+     * @param index the index of the task
+     * @param rWorker the worker
+     * @param succeeded whether the task succeeded
+     * @param rOutput the output of the task (its summary statistics, or an error message)
+     * @return whether the outcome was recorded
+     */
+    bool Complete(unsigned index, const std::string& rWorker, bool succeeded, const std::string& rOutput);
+
+    /**
+     * Return tasks whose leases have run out to the queue.
+     *
+     * @param now the current time
+     * @return the number of leases that had run out
+     */
+    unsigned ExpireLeases(double now);
+
+    /**
+     * @return whether every task has succeeded or been given up on
+     */
+    bool IsFinished() const;
+
+    /**
+     * @param state a state
+     * @return the number of tasks in that state
+     */
+    unsigned GetNumTasks(TaskState state) const;
+
+    /**
+     * @param index the index of a task
+     * @return the task
+     */
+    const SweepTask& rGetTask(unsigned index) const;
+
+    /**
+     * @param index the index of a task
+     * @return the state of the task
+     */
+    TaskState GetState(unsigned index) const;
+};
+
+#endif /*SWEEPWORKQUEUE_HPP_*/
@@ -0,0 +1,201 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "SyntheticLikelihood.hpp"
+#include "DenseCholesky.hpp"
+#include "Exception.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+SyntheticLikelihood::SyntheticLikelihood(const std::vector<double>& rObserved)
+    : mObserved(rObserved),
+      mUsed(rObserved.size()),
+      mShrinkageIntensity(-1.0)
+{
+    for (unsigned i=0; i<mObserved.size(); i++)
+    {
+        mUsed[i] = std::isfinite(mObserved[i]);
+    }
+}
+
+void SyntheticLikelihood::SetUsedStatistics(const std::vector<bool>& rUsed)
+{
+    if (rUsed.size() != mObserved.size())
+    {
+        EXCEPTION("Expected " << mObserved.size() << " flags, not " << rUsed.size());
+    }
+    for (unsigned i=0; i<mObserved.size(); i++)
+    {
+        mUsed[i] = rUsed[i] && std::isfinite(mObserved[i]);
+    }
+}
+
+void SyntheticLikelihood::SetShrinkageIntensity(double shrinkageIntensity)
+{
+    if (shrinkageIntensity > 1.0)
+    {
+        EXCEPTION("The shrinkage intensity cannot be more than 1");
+    }
+    mShrinkageIntensity = shrinkageIntensity;
+}
+
+void SyntheticLikelihood::GetMoments(const StreamingCovariance& rSamples,
+                                     std::vector<unsigned>& rIndices,
+                                     std::vector<double>& rMean,
+                                     std::vector<double>& rVariance,
+                                     std::vector<double>& rCorrelation) const
+{
+    if (rSamples.GetDimension() != mObserved.size())
+    {
+        EXCEPTION("Expected samples of " << mObserved.size() << " statistics, not " << rSamples.GetDimension());
+    }
+    if (rSamples.GetNumSamples() < 2u)
+    {
+        EXCEPTION("The synthetic likelihood needs at least two replicate runs, not " << rSamples.GetNumSamples());
+    }
+
+    const unsigned dimension = rSamples.GetDimension();
+    std::vector<double> covariance = rSamples.GetCovariance();
+    rIndices.clear();
+    for (unsigned i=0; i<dimension; i++)
+    {
+        if (mUsed[i])
+        {
+            rIndices.push_back(i);
+        }
+    }
+
+    const unsigned num_used = rIndices.size();
+    rMean.resize(num_used);
+    rVariance.resize(num_used);
+    for (unsigned a=0; a<num_used; a++)
+    {
+        unsigned i = rIndices[a];
+        rMean[a] = rSamples.rGetMean()[i];
+
+        // A statistic that is the same in every replicate still needs some spread
+        rVariance[a] = std::max(covariance[i*dimension + i], 1e-12*std::max(1.0, rMean[a]*rMean[a]));
+    }
+
+    rCorrelation.assign(num_used*num_used, 0.0);
+    for (unsigned a=0; a<num_used; a++)
+    {
+        for (unsigned b=0; b<num_used; b++)
+        {
+            rCorrelation[a*num_used + b] = (a == b) ? 1.0
+                    : covariance[rIndices[a]*dimension + rIndices[b]]/std::sqrt(rVariance[a]*rVariance[b]);
+        }
+    }
+}
+
+double SyntheticLikelihood::GetAutomaticShrinkageIntensity(const std::vector<double>& rCorrelation, unsigned dimension, unsigned numSamples)
+{
+    // With S the correlation matrix, tr(S) = p and the RBLW intensity is
+    // ((n-2)/n tr(S^2) + tr(S)^2) / ((n+2) (tr(S^2) - tr(S)^2/p))
+    double trace_of_square = 0.0;
+    for (unsigned i=0; i<dimension*dimension; i++)
+    {
+        trace_of_square += rCorrelation[i]*rCorrelation[i];
+    }
+    double n = numSamples;
+    double p = dimension;
+    double denominator = (n + 2.0)*(trace_of_square - p);
+    if (!(denominator > 0.0))
+    {
+        return 1.0;
+    }
+    return std::min(1.0, ((n - 2.0)/n*trace_of_square + p*p)/denominator);
+}
+
+double SyntheticLikelihood::GetShrinkageIntensity(const StreamingCovariance& rSamples) const
+{
+    if (mShrinkageIntensity >= 0.0)
+    {
+        return mShrinkageIntensity;
+    }
+    std::vector<unsigned> indices;
+    std::vector<double> mean;
+    std::vector<double> variance;
+    std::vector<double> correlation;
+    GetMoments(rSamples, indices, mean, variance, correlation);
+    return GetAutomaticShrinkageIntensity(correlation, indices.size(), rSamples.GetNumSamples());
+}
+
+double SyntheticLikelihood::Evaluate(const StreamingCovariance& rSamples) const
+{
+    std::vector<unsigned> indices;
+    std::vector<double> mean;
+    std::vector<double> variance;
+    std::vector<double> correlation;
+    GetMoments(rSamples, indices, mean, variance, correlation);
+    const unsigned num_used = indices.size();
+    if (num_used == 0u)
+    {
+        EXCEPTION("The synthetic likelihood has no statistics to use");
+    }
+
+    double intensity = (mShrinkageIntensity >= 0.0) ? mShrinkageIntensity
+            : GetAutomaticShrinkageIntensity(correlation, num_used, rSamples.GetNumSamples());
+
+    // The shrunk correlation matrix, and the standardised difference from the observations
+    std::vector<double> matrix(num_used*num_used);
+    std::vector<double> difference(num_used);
+    for (unsigned a=0; a<num_used; a++)
+    {
+        for (unsigned b=0; b<num_used; b++)
+        {
+            matrix[a*num_used + b] = (a == b) ? 1.0 : (1.0 - intensity)*correlation[a*num_used + b];
+        }
+        difference[a] = (mObserved[indices[a]] - mean[a])/std::sqrt(variance[a]);
+    }
+    if (!DenseCholesky::Decompose(matrix, num_used))
+    {
+        return -std::numeric_limits<double>::infinity();
+    }
+    DenseCholesky::ForwardSubstitute(matrix, num_used, difference);
+
+    double log_likelihood = -0.5*DenseCholesky::GetLogDeterminant(matrix, num_used) - 0.5*num_used*std::log(2.0*M_PI);
+    for (unsigned a=0; a<num_used; a++)
+    {
+        log_likelihood -= 0.5*difference[a]*difference[a] + 0.5*std::log(variance[a]);
+    }
+    return log_likelihood;
+}
+
+const std::vector<double>& SyntheticLikelihood::rGetObserved() const
+{
+    return mObserved;
+}
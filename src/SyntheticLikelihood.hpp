@@ -0,0 +1,133 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef SYNTHETICLIKELIHOOD_HPP_
+#define SYNTHETICLIKELIHOOD_HPP_
+
+#include <vector>
+#include "StreamingCovariance.hpp"
+
+/**
+ * The synthetic likelihood of Wood (2010): the summary statistics of the runs
+ * of a parameter set are taken to be multivariate normal, with the mean and
+ * covariance of the statistics of its replicate runs, and the likelihood of
+ * the parameter set is the density of the observed statistics under that
+ * normal distribution.
+ *
+ * With few replicates the sample covariance is noisy, or singular when there
+ * are fewer replicates than statistics, so the correlations are shrunk towards
+ * zero: the covariance used is (1 - rho) S + rho diag(S), with the shrinkage
+ * intensity rho either fixed or chosen by the Rao-Blackwellised Ledoit-Wolf
+ * formula of Chen et al. (2010) applied to the sample correlation matrix.
+ */
+class SyntheticLikelihood
+{
+private:
+
+    /** The observed value of each statistic. */
+    std::vector<double> mObserved;
+
+    /** Whether each statistic is used; statistics that were not observed (not a number) are not. */
+    std::vector<bool> mUsed;
+
+    /** The shrinkage intensity, or a negative value to choose it automatically. */
+    double mShrinkageIntensity;
+
+    /**
+     * Get the mean and the variances and correlations of the used statistics.
+     *
+     * @param rSamples the statistics of the replicate runs
+     * @param rIndices filled in with the indices of the used statistics
+     * @param rMean filled in with their means
+     * @param rVariance filled in with their variances
+     * @param rCorrelation filled in with their correlation matrix, stored by rows
+     */
+    void GetMoments(const StreamingCovariance& rSamples,
+                    std::vector<unsigned>& rIndices,
+                    std::vector<double>& rMean,
+                    std::vector<double>& rVariance,
+                    std::vector<double>& rCorrelation) const;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param rObserved the observed statistics, e.g. TissueSummaryStatistics::ToVector()
+     */
+    SyntheticLikelihood(const std::vector<double>& rObserved);
+
+    /**
+     * Choose the statistics to use. By default all the observed statistics are used.
+     *
+     * @param rUsed whether to use each statistic
+     */
+    void SetUsedStatistics(const std::vector<bool>& rUsed);
+
+    /**
+     * @param shrinkageIntensity the shrinkage intensity, between 0 (the sample covariance)
+     *     and 1 (independent statistics), or a negative value to choose it automatically
+     *     (the default)
+     */
+    void SetShrinkageIntensity(double shrinkageIntensity);
+
+    /**
+     * @param rSamples the statistics of the replicate runs of a parameter set
+     * @return the shrinkage intensity used for those runs
+     */
+    double GetShrinkageIntensity(const StreamingCovariance& rSamples) const;
+
+    /**
+     * The Rao-Blackwellised Ledoit-Wolf shrinkage intensity towards the identity.
+     *
+     * @param rCorrelation a sample correlation matrix, stored by rows
+     * @param dimension its size
+     * @param numSamples the number of samples it was estimated from
+     * @return the shrinkage intensity, between 0 and 1
+     */
+    static double GetAutomaticShrinkageIntensity(const std::vector<double>& rCorrelation, unsigned dimension, unsigned numSamples);
+
+    /**
+     * @param rSamples the statistics of the replicate runs of a parameter set; at least two
+     * @return the log synthetic likelihood of the parameter set
+     */
+    double Evaluate(const StreamingCovariance& rSamples) const;
+
+    /**
+     * @return the observed statistics
+     */
+    const std::vector<double>& rGetObserved() const;
+};
+
+#endif /*SYNTHETICLIKELIHOOD_HPP_*/
@@ -0,0 +1,257 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "SyntheticLikelihoodMcmc.hpp"
+#include "BufferedTextEmitter.hpp"
+#include "Exception.hpp"
+#include "TissueSummaryStatistics.hpp"
+
+#include <cmath>
+#include <fstream>
+#include <limits>
+
+SyntheticLikelihoodMcmc::SyntheticLikelihoodMcmc(const SyntheticLikelihood& rLikelihood,
+                                                 const std::vector<std::vector<double> >& rStartingPoints,
+                                                 unsigned numReplicates,
+                                                 unsigned sweepId)
+    : mLikelihood(rLikelihood),
+      mNumReplicates(numReplicates),
+      mSweepId(sweepId),
+      mCurrentPoints(rStartingPoints),
+      mNumSimulatedPoints(0u),
+      mNumIterations(0u),
+      mNumAccepted(0u)
+{
+    if (numReplicates < 2u)
+    {
+        EXCEPTION("The synthetic likelihood needs at least two replicate runs per point");
+    }
+    if (numReplicates > 0xFFFFu)
+    {
+        EXCEPTION("At most 65535 replicate runs per point are possible, since each needs its own seed");
+    }
+    if (rStartingPoints.empty())
+    {
+        EXCEPTION("At least one chain is needed");
+    }
+    for (unsigned chain=0; chain<rStartingPoints.size(); chain++)
+    {
+        if (rStartingPoints[chain].size() != 2u)
+        {
+            EXCEPTION("A starting point needs a Lambda and a Gamma");
+        }
+
+        // Each chain has its own proposal stream, keyed by the sweep id
+        mRandom.push_back(Philox4x32(sweepId, 0x4D434D43u, chain));
+    }
+    SetPriorBounds({-1.0, 0.0}, {0.2, 0.5});
+}
+
+void SyntheticLikelihoodMcmc::SetPriorBounds(const std::vector<double>& rLowerBounds, const std::vector<double>& rUpperBounds)
+{
+    if (rLowerBounds.size() != 2u || rUpperBounds.size() != 2u
+        || !(rLowerBounds[0] < rUpperBounds[0]) || !(rLowerBounds[1] < rUpperBounds[1]))
+    {
+        EXCEPTION("The prior needs lower bounds below upper bounds for Lambda and Gamma");
+    }
+    mLowerBounds = rLowerBounds;
+    mUpperBounds = rUpperBounds;
+    mProposalScales = {0.05*(rUpperBounds[0] - rLowerBounds[0]), 0.05*(rUpperBounds[1] - rLowerBounds[1])};
+}
+
+void SyntheticLikelihoodMcmc::SetProposalScales(const std::vector<double>& rProposalScales)
+{
+    if (rProposalScales.size() != 2u)
+    {
+        EXCEPTION("The proposal needs scales for Lambda and Gamma");
+    }
+    mProposalScales = rProposalScales;
+}
+
+bool SyntheticLikelihoodMcmc::IsInPrior(const std::vector<double>& rPoint) const
+{
+    for (unsigned d=0; d<2; d++)
+    {
+        if (rPoint[d] < mLowerBounds[d] || rPoint[d] > mUpperBounds[d])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<double> SyntheticLikelihoodMcmc::EvaluatePoints(const std::vector<std::vector<double> >& rPoints,
+                                                            const boost::function<std::vector<std::string> (const std::vector<SweepTask>&)>& rRunBatch)
+{
+    std::vector<SweepTask> tasks;
+    for (unsigned i=0; i<rPoints.size(); i++)
+    {
+        unsigned simulation = ++mNumSimulatedPoints;
+        for (unsigned run=1; run<=mNumReplicates; run++)
+        {
+            tasks.push_back(SweepTask(rPoints[i][0], rPoints[i][1], simulation, run, SweepTask::DeriveSeed(mSweepId, simulation, run)));
+        }
+    }
+
+    std::vector<std::string> results = rRunBatch(tasks);
+    if (results.size() != tasks.size())
+    {
+        EXCEPTION("Expected the results of " << tasks.size() << " runs, not " << results.size());
+    }
+
+    std::vector<double> log_likelihoods(rPoints.size());
+    for (unsigned i=0; i<rPoints.size(); i++)
+    {
+        StreamingCovariance statistics(mLikelihood.rGetObserved().size());
+        for (unsigned run=0; run<mNumReplicates; run++)
+        {
+            const std::string& r_result = results[i*mNumReplicates + run];
+            if (!r_result.empty())
+            {
+                statistics.AddSample(TissueSummaryStatistics::FromString(r_result).ToVector());
+            }
+        }
+        log_likelihoods[i] = (statistics.GetNumSamples() < 2u) ? -std::numeric_limits<double>::infinity()
+                                                                : mLikelihood.Evaluate(statistics);
+    }
+    return log_likelihoods;
+}
+
+void SyntheticLikelihoodMcmc::Run(unsigned numIterations, boost::function<std::vector<std::string> (const std::vector<SweepTask>&)> runBatch)
+{
+    const unsigned num_chains = mCurrentPoints.size();
+
+    // Each simulated point is numbered for SweepTask::DeriveSeed(), which takes numbers below
+    // 65536, so check before simulating anything that every proposal could be simulated
+    const unsigned long long max_num_points = mNumSimulatedPoints + (mSamples.empty() ? num_chains : 0u)
+                                              + static_cast<unsigned long long>(num_chains)*numIterations;
+    if (max_num_points > 0xFFFFu)
+    {
+        EXCEPTION("Cannot run " << numIterations << " iterations of " << num_chains << " chains, since up to "
+                  << max_num_points << " points would be simulated and at most 65535 have seeds");
+    }
+
+    if (mSamples.empty())
+    {
+        mCurrentLogLikelihoods = EvaluatePoints(mCurrentPoints, runBatch);
+        for (unsigned chain=0; chain<num_chains; chain++)
+        {
+            Sample sample = {chain, 0u, mCurrentPoints[chain][0], mCurrentPoints[chain][1], mCurrentLogLikelihoods[chain], false};
+            mSamples.push_back(sample);
+        }
+    }
+
+    for (unsigned iteration=0; iteration<numIterations; iteration++)
+    {
+        mNumIterations++;
+
+        // Gaussian random-walk proposals (Box-Muller); those outside the prior are rejected without simulating
+        std::vector<std::vector<double> > proposals(num_chains, std::vector<double>(2));
+        std::vector<unsigned> simulated_chains;
+        std::vector<std::vector<double> > simulated_points;
+        for (unsigned chain=0; chain<num_chains; chain++)
+        {
+            Philox4x32& r_random = mRandom[chain];
+            double radius = std::sqrt(-2.0*std::log(1.0 - r_random.ranf()));
+            double angle = 2.0*M_PI*r_random.ranf();
+            proposals[chain][0] = mCurrentPoints[chain][0] + mProposalScales[0]*radius*std::cos(angle);
+            proposals[chain][1] = mCurrentPoints[chain][1] + mProposalScales[1]*radius*std::sin(angle);
+            if (IsInPrior(proposals[chain]))
+            {
+                simulated_chains.push_back(chain);
+                simulated_points.push_back(proposals[chain]);
+            }
+        }
+
+        std::vector<double> proposal_log_likelihoods(num_chains, -std::numeric_limits<double>::infinity());
+        if (!simulated_points.empty())
+        {
+            std::vector<double> log_likelihoods = EvaluatePoints(simulated_points, runBatch);
+            for (unsigned i=0; i<simulated_chains.size(); i++)
+            {
+                proposal_log_likelihoods[simulated_chains[i]] = log_likelihoods[i];
+            }
+        }
+
+        // Metropolis acceptance; the prior is flat inside the box and the proposal symmetric
+        for (unsigned chain=0; chain<num_chains; chain++)
+        {
+            double log_ratio = proposal_log_likelihoods[chain] - mCurrentLogLikelihoods[chain];
+            bool accept = std::isfinite(proposal_log_likelihoods[chain])
+                    && (!std::isfinite(mCurrentLogLikelihoods[chain]) || std::log(1.0 - mRandom[chain].ranf()) < log_ratio);
+            if (accept)
+            {
+                mCurrentPoints[chain] = proposals[chain];
+                mCurrentLogLikelihoods[chain] = proposal_log_likelihoods[chain];
+                mNumAccepted++;
+            }
+            Sample sample = {chain, mNumIterations, mCurrentPoints[chain][0], mCurrentPoints[chain][1], mCurrentLogLikelihoods[chain], accept};
+            mSamples.push_back(sample);
+        }
+    }
+}
+
+const std::vector<SyntheticLikelihoodMcmc::Sample>& SyntheticLikelihoodMcmc::rGetSamples() const
+{
+    return mSamples;
+}
+
+double SyntheticLikelihoodMcmc::GetAcceptanceRate() const
+{
+    if (mNumIterations == 0u)
+    {
+        return 0.0;
+    }
+    return double(mNumAccepted)/(mNumIterations*mCurrentPoints.size());
+}
+
+void SyntheticLikelihoodMcmc::WriteSamples(const std::string& rFilePath) const
+{
+    std::ofstream file(rFilePath.c_str());
+    if (!file.is_open())
+    {
+        EXCEPTION("Could not open samples file " << rFilePath);
+    }
+
+    BufferedTextEmitter emitter;
+    emitter.SetUseShortestRoundTrip(true);
+    emitter << "Chain,Iteration,Lambda,Gamma,LogLikelihood,Accepted\n";
+    for (unsigned i=0; i<mSamples.size(); i++)
+    {
+        const Sample& r_sample = mSamples[i];
+        emitter << r_sample.mChain << ',' << r_sample.mIteration << ',' << r_sample.mLambda << ','
+                << r_sample.mGamma << ',' << r_sample.mLogLikelihood << ',' << r_sample.mAccepted << '\n';
+    }
+    emitter.FlushTo(file);
+}
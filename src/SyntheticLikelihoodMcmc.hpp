@@ -0,0 +1,203 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef SYNTHETICLIKELIHOODMCMC_HPP_
+#define SYNTHETICLIKELIHOODMCMC_HPP_
+
+#include <string>
+#include <vector>
+#include <boost/function.hpp>
+#include "Philox4x32.hpp"
+#include "SweepTask.hpp"
+#include "SyntheticLikelihood.hpp"
+
+/**
+ * Random-walk Metropolis sampling of the posterior of (Lambda, Gamma) under a
+ * SyntheticLikelihood and a uniform prior on a box.
+ *
+ * Several chains are run in step. At each iteration every chain proposes a new
+ * point, and the replicate runs of all the proposals inside the prior box are
+ * handed to the caller as one batch of SweepTasks, so they can be simulated in
+ * parallel (e.g. with a SimulationWorkerPool or SweepFarm). Each proposal gets
+ * its own simulation number, and its runs are seeded with SweepTask::DeriveSeed(),
+ * so a sampler with the same settings reproduces the same runs; at most 65535
+ * proposals can be made. As usual for synthetic likelihood MCMC, the likelihood
+ * estimate of a chain's current point is kept until a proposal is accepted.
+ */
+class SyntheticLikelihoodMcmc
+{
+public:
+
+    /** One state of one chain. */
+    struct Sample
+    {
+        /** The chain. */
+        unsigned mChain;
+
+        /** The iteration; 0 is the starting point. */
+        unsigned mIteration;
+
+        /** Lambda. */
+        double mLambda;
+
+        /** Gamma. */
+        double mGamma;
+
+        /** The log synthetic likelihood. */
+        double mLogLikelihood;
+
+        /** Whether the state was reached by accepting a proposal at this iteration. */
+        bool mAccepted;
+    };
+
+private:
+
+    /** The likelihood. */
+    SyntheticLikelihood mLikelihood;
+
+    /** The number of replicate runs per point. */
+    unsigned mNumReplicates;
+
+    /** Identifies the runs; see SweepTask::DeriveSeed(). */
+    unsigned mSweepId;
+
+    /** The lower bounds of the prior on Lambda and Gamma. */
+    std::vector<double> mLowerBounds;
+
+    /** The upper bounds of the prior on Lambda and Gamma. */
+    std::vector<double> mUpperBounds;
+
+    /** The standard deviations of the random-walk proposal for Lambda and Gamma. */
+    std::vector<double> mProposalScales;
+
+    /** The current point of each chain. */
+    std::vector<std::vector<double> > mCurrentPoints;
+
+    /** The log likelihood of the current point of each chain. */
+    std::vector<double> mCurrentLogLikelihoods;
+
+    /** The proposal random number stream of each chain. */
+    std::vector<Philox4x32> mRandom;
+
+    /** The number of points simulated so far. */
+    unsigned mNumSimulatedPoints;
+
+    /** The number of iterations run so far. */
+    unsigned mNumIterations;
+
+    /** The number of proposals accepted so far. */
+    unsigned mNumAccepted;
+
+    /** The states of all chains at all iterations. */
+    std::vector<Sample> mSamples;
+
+    /**
+     * Simulate a set of points and evaluate their log likelihoods.
+     *
+     * @param rPoints the points
+     * @param rRunBatch the function that runs a batch of tasks
+     * @return the log likelihood of each point; minus infinity if fewer than two runs succeeded
+     */
+    std::vector<double> EvaluatePoints(const std::vector<std::vector<double> >& rPoints,
+                                       const boost::function<std::vector<std::string> (const std::vector<SweepTask>&)>& rRunBatch);
+
+    /**
+     * @param rPoint a point
+     * @return whether the point is inside the prior box
+     */
+    bool IsInPrior(const std::vector<double>& rPoint) const;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param rLikelihood the synthetic likelihood
+     * @param rStartingPoints the starting (Lambda, Gamma) of each chain
+     * @param numReplicates the number of replicate runs per point; at least two
+     * @param sweepId identifies the runs; see SweepTask::DeriveSeed(). Defaults to 1.
+     */
+    SyntheticLikelihoodMcmc(const SyntheticLikelihood& rLikelihood,
+                            const std::vector<std::vector<double> >& rStartingPoints,
+                            unsigned numReplicates,
+                            unsigned sweepId=1u);
+
+    /**
+     * Set the prior box. Defaults to Lambda between -1 and 0.2 and Gamma between 0 and 0.5.
+     *
+     * @param rLowerBounds the lower bounds of Lambda and Gamma
+     * @param rUpperBounds the upper bounds of Lambda and Gamma
+     */
+    void SetPriorBounds(const std::vector<double>& rLowerBounds, const std::vector<double>& rUpperBounds);
+
+    /**
+     * Set the standard deviations of the random-walk proposal. Default to 5% of the prior ranges.
+     *
+     * @param rProposalScales the standard deviations for Lambda and Gamma
+     */
+    void SetProposalScales(const std::vector<double>& rProposalScales);
+
+    /**
+     * Run the chains. The first call also evaluates the starting points. Each
+     * simulated point gets its own seeds (SweepTask::DeriveSeed()), so at most
+     * 65535 points can be simulated over all calls: chains times iterations,
+     * plus the chains' starting points.
+     *
+     * @param numIterations the number of iterations to run
+     * @param runBatch the function that runs a batch of tasks and returns the summary
+     *     statistics of each (TissueSummaryStatistics::ToString()), or an empty string for
+     *     a run that failed
+     */
+    void Run(unsigned numIterations, boost::function<std::vector<std::string> (const std::vector<SweepTask>&)> runBatch);
+
+    /**
+     * @return the states of all chains at all iterations so far
+     */
+    const std::vector<Sample>& rGetSamples() const;
+
+    /**
+     * @return the fraction of proposals accepted so far
+     */
+    double GetAcceptanceRate() const;
+
+    /**
+     * Write the samples to a CSV file with columns Chain, Iteration, Lambda, Gamma,
+     * LogLikelihood and Accepted.
+     *
+     * @param rFilePath the path of the file
+     */
+    void WriteSamples(const std::string& rFilePath) const;
+};
+
+#endif /*SYNTHETICLIKELIHOODMCMC_HPP_*/
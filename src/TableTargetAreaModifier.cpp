@@ -0,0 +1,176 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "TableTargetAreaModifier.hpp"
+#include "AbstractPhaseBasedCellCycleModel.hpp"
+#include "SimulationTime.hpp"
+
+#include <algorithm>
+
+template<unsigned DIM>
+TableTargetAreaModifier<DIM>::TableTargetAreaModifier()
+    : AbstractTargetAreaModifier<DIM>(),
+      mpCellDataTable(new CellDataTable()),
+      mSamplingTimestepMultiple(1u)
+{
+    mTargetAreaHandle = mpCellDataTable->RegisterItem("target area");
+}
+
+template<unsigned DIM>
+TableTargetAreaModifier<DIM>::~TableTargetAreaModifier()
+{
+}
+
+template<unsigned DIM>
+double TableTargetAreaModifier<DIM>::CalculateTargetArea(const CellPtr pCell) const
+{
+    // The cell cycle models were checked by SetupSolve(), and daughters get the same kind
+    AbstractPhaseBasedCellCycleModel* p_model = static_cast<AbstractPhaseBasedCellCycleModel*>(pCell->GetCellCycleModel());
+    double reference_target_area = this->mReferenceTargetArea;
+    double age_to_start_growing = p_model->GetMDuration() + p_model->GetG1Duration() + p_model->GetSDuration();
+
+    // An apoptotic cell stops growing when apoptosis begins
+    bool is_apoptotic = pCell->HasApoptosisBegun();
+    double age = is_apoptotic ? pCell->GetStartOfApoptosisTime() - pCell->GetBirthTime() : pCell->GetAge();
+
+    double target_area = reference_target_area;
+    if (age > age_to_start_growing)
+    {
+        target_area += std::min(reference_target_area, reference_target_area*(age - age_to_start_growing)/p_model->GetG2Duration());
+    }
+    if (is_apoptotic)
+    {
+        double time_spent_apoptotic = SimulationTime::Instance()->GetTime() - pCell->GetStartOfApoptosisTime();
+        target_area *= std::max(0.0, 1.0 - time_spent_apoptotic/pCell->GetApoptosisTime());
+    }
+    else if (pCell->ReadyToDivide())
+    {
+        // The daughter copies this from its mother's CellData
+        target_area = reference_target_area;
+    }
+    return target_area;
+}
+
+template<unsigned DIM>
+void TableTargetAreaModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory)
+{
+    for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
+         cell_iter != rCellPopulation.End();
+         ++cell_iter)
+    {
+        if (dynamic_cast<AbstractPhaseBasedCellCycleModel*>(cell_iter->GetCellCycleModel()) == nullptr)
+        {
+            EXCEPTION("TableTargetAreaModifier needs a subclass of AbstractPhaseBasedCellCycleModel");
+        }
+    }
+
+    // Sets each cell's target area in its CellData, from which the table reads the cells new to it
+    AbstractTargetAreaModifier<DIM>::SetupSolve(rCellPopulation, outputDirectory);
+    UpdateAtEndOfTimeStep(rCellPopulation);
+}
+
+template<unsigned DIM>
+void TableTargetAreaModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    mpCellDataTable->UpdateLayout(rCellPopulation);
+    const std::vector<CellPtr>& r_cells = mpCellDataTable->rGetCells();
+    const std::vector<unsigned>& r_location_indices = mpCellDataTable->rGetLocationIndices();
+    std::vector<double>& r_target_areas = mpCellDataTable->rGetValues(mTargetAreaHandle);
+
+    bool is_output_time_step = (SimulationTime::Instance()->GetTimeStepsElapsed() % mSamplingTimestepMultiple == 0);
+    for (unsigned index=0; index<r_cells.size(); index++)
+    {
+        r_target_areas[r_location_indices[index]] = CalculateTargetArea(r_cells[index]);
+
+        // The cell divides at the start of the next time step
+        if (is_output_time_step || r_cells[index]->ReadyToDivide())
+        {
+            mpCellDataTable->WriteItemToCell(mTargetAreaHandle, index);
+        }
+    }
+}
+
+template<unsigned DIM>
+void TableTargetAreaModifier<DIM>::UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    mpCellDataTable->UpdateLayout(rCellPopulation);
+    mpCellDataTable->WriteItemToCells(mTargetAreaHandle);
+}
+
+template<unsigned DIM>
+void TableTargetAreaModifier<DIM>::UpdateTargetAreaOfCell(const CellPtr pCell)
+{
+    pCell->GetCellData()->SetItem("target area", CalculateTargetArea(pCell));
+}
+
+template<unsigned DIM>
+boost::shared_ptr<CellDataTable> TableTargetAreaModifier<DIM>::GetCellDataTable() const
+{
+    return mpCellDataTable;
+}
+
+template<unsigned DIM>
+void TableTargetAreaModifier<DIM>::SetSamplingTimestepMultiple(unsigned samplingTimestepMultiple)
+{
+    if (samplingTimestepMultiple == 0u)
+    {
+        EXCEPTION("The sampling time step multiple must be positive");
+    }
+    mSamplingTimestepMultiple = samplingTimestepMultiple;
+}
+
+template<unsigned DIM>
+unsigned TableTargetAreaModifier<DIM>::GetSamplingTimestepMultiple() const
+{
+    return mSamplingTimestepMultiple;
+}
+
+template<unsigned DIM>
+void TableTargetAreaModifier<DIM>::OutputSimulationModifierParameters(out_stream& rParamsFile)
+{
+    *rParamsFile << "\t\t\t<SamplingTimestepMultiple>" << mSamplingTimestepMultiple << "</SamplingTimestepMultiple>\n";
+
+    // Next, call method on direct parent class
+    AbstractTargetAreaModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
+}
+
+// Explicit instantiation
+template class TableTargetAreaModifier<1>;
+template class TableTargetAreaModifier<2>;
+template class TableTargetAreaModifier<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(TableTargetAreaModifier)
@@ -0,0 +1,178 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TABLETARGETAREAMODIFIER_HPP_
+#define TABLETARGETAREAMODIFIER_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include "AbstractTargetAreaModifier.hpp"
+#include "CellDataTable.hpp"
+
+/**
+ * A target area modifier that keeps the cells' target areas in a CellDataTable
+ * rather than in their CellData.
+ *
+ * The target area of a cell grows as under Chaste's
+ * TargetAreaLinearGrowthModifier without a user-defined growth rate: it is the
+ * reference target area A until the end of the S phase, then grows linearly
+ * to 2A over the G2 phase. As there, a cell that is ready to divide is given
+ * A, which its daughter inherits. Once a cell has begun apoptosis, the target area it
+ * had then shrinks linearly to zero over its apoptosis time. The cell cycle
+ * models must be phase-based.
+ *
+ * At the end of each time step the modifier writes the target areas straight
+ * into the table's slots. A FasterFarhadifarForce given the table through
+ * SetCellDataTable() reads them from there, so neither looks an item up by
+ * name in the time step loop. The target areas are copied to CellData only
+ * for the Chaste code that reads them there: for cells that are ready to
+ * divide, since a daughter's CellData is a copy of its mother's;
+ * at output time steps, for writers; and at the end of the simulation, for
+ * checkpoints and later use. Forces that read CellData, such as Chaste's
+ * FarhadifarForce, therefore need TargetAreaLinearGrowthModifier instead.
+ */
+template<unsigned DIM>
+class TableTargetAreaModifier : public AbstractTargetAreaModifier<DIM>
+{
+private:
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Archive the object. The table is filled in again by SetupSolve(), so is not archived.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractTargetAreaModifier<DIM> >(*this);
+        archive & mSamplingTimestepMultiple;
+    }
+
+    /** The table holding the target areas, shared with the force. */
+    boost::shared_ptr<CellDataTable> mpCellDataTable;
+
+    /** The handle of "target area" in the table. */
+    unsigned mTargetAreaHandle;
+
+    /**
+     * The simulation's sampling time step multiple; the target areas are copied to
+     * the cells' CellData at output time steps. Defaults to 1.
+     */
+    unsigned mSamplingTimestepMultiple;
+
+    /**
+     * @param pCell a cell
+     * @return the cell's target area under the growth law
+     */
+    double CalculateTargetArea(const CellPtr pCell) const;
+
+public:
+
+    /**
+     * Constructor.
+     */
+    TableTargetAreaModifier();
+
+    /**
+     * Destructor.
+     */
+    virtual ~TableTargetAreaModifier();
+
+    /**
+     * Overridden SetupSolve() method. Checks the cell cycle models, sets every
+     * cell's target area in its CellData and fills in the table.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     */
+    virtual void SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory);
+
+    /**
+     * Overridden UpdateAtEndOfTimeStep() method. Updates the target areas in the table.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden UpdateAtEndOfSolve() method. Copies the target areas to the cells' CellData.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden UpdateTargetAreaOfCell() method. Sets the target area in the
+     * cell's CellData; the table is left alone.
+     *
+     * @param pCell pointer to the cell
+     */
+    virtual void UpdateTargetAreaOfCell(const CellPtr pCell);
+
+    /**
+     * @return the table holding the target areas, to pass to FasterFarhadifarForce::SetCellDataTable()
+     */
+    boost::shared_ptr<CellDataTable> GetCellDataTable() const;
+
+    /**
+     * Set the simulation's sampling time step multiple, so that the target areas
+     * are in the cells' CellData when the writers run.
+     *
+     * @param samplingTimestepMultiple the multiple
+     */
+    void SetSamplingTimestepMultiple(unsigned samplingTimestepMultiple);
+
+    /**
+     * @return the sampling time step multiple
+     */
+    unsigned GetSamplingTimestepMultiple() const;
+
+    /**
+     * Overridden OutputSimulationModifierParameters() method.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    void OutputSimulationModifierParameters(out_stream& rParamsFile);
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(TableTargetAreaModifier)
+
+#endif /*TABLETARGETAREAMODIFIER_HPP_*/
@@ -0,0 +1,152 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "ThreadTeam.hpp"
+
+#include <algorithm>
+
+ThreadTeam::ThreadTeam(unsigned numThreads)
+    : mGeneration(0u),
+      mNumRunning(0u),
+      mStop(false)
+{
+    if (numThreads == 0u)
+    {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned thread_index=1; thread_index<numThreads; thread_index++)
+    {
+        mThreads.push_back(std::thread(&ThreadTeam::WorkerLoop, this, thread_index));
+    }
+}
+
+ThreadTeam::~ThreadTeam()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mTaskReady.notify_all();
+    for (unsigned i=0; i<mThreads.size(); i++)
+    {
+        mThreads[i].join();
+    }
+}
+
+unsigned ThreadTeam::GetNumThreads() const
+{
+    return mThreads.size() + 1u;
+}
+
+void ThreadTeam::WorkerLoop(unsigned threadIndex)
+{
+    unsigned long last_generation = 0u;
+    while (true)
+    {
+        std::function<void (unsigned)> task;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mTaskReady.wait(lock, [&] { return mStop || mGeneration != last_generation; });
+            if (mStop)
+            {
+                return;
+            }
+            last_generation = mGeneration;
+            task = mTask;
+        }
+
+        std::exception_ptr p_exception;
+        try
+        {
+            task(threadIndex);
+        }
+        catch (...)
+        {
+            p_exception = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (p_exception && !mpException)
+        {
+            mpException = p_exception;
+        }
+        if (--mNumRunning == 0u)
+        {
+            mTaskDone.notify_one();
+        }
+    }
+}
+
+void ThreadTeam::Run(const std::function<void (unsigned)>& rTask)
+{
+    if (mThreads.empty())
+    {
+        rTask(0u);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mTask = rTask;
+        mNumRunning = mThreads.size();
+        mpException = nullptr;
+        mGeneration++;
+    }
+    mTaskReady.notify_all();
+
+    std::exception_ptr p_exception;
+    try
+    {
+        rTask(0u);
+    }
+    catch (...)
+    {
+        p_exception = std::current_exception();
+    }
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mTaskDone.wait(lock, [&] { return mNumRunning == 0u; });
+    if (!p_exception)
+    {
+        p_exception = mpException;
+    }
+    mTask = nullptr;
+    lock.unlock();
+
+    if (p_exception)
+    {
+        std::rethrow_exception(p_exception);
+    }
+}
@@ -0,0 +1,124 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef THREADTEAM_HPP_
+#define THREADTEAM_HPP_
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * A fixed team of threads for data-parallel loops inside a simulation, such as
+ * the force calculation of FarhadifarForceKernel.
+ *
+ * Run() calls a function once on every thread of the team, with the thread's
+ * index, and returns when all calls have returned; the calling thread is thread
+ * 0. The other threads wait between calls, so that a team can be reused at every
+ * time step without the cost of starting threads. (Processes forked by
+ * SimulationWorkerPool must create their own teams: threads do not survive a
+ * fork.)
+ */
+class ThreadTeam
+{
+private:
+
+    /** The threads other than the calling thread. */
+    std::vector<std::thread> mThreads;
+
+    /** Guards the members below. */
+    std::mutex mMutex;
+
+    /** Signalled when there is a new task, or the team is stopping. */
+    std::condition_variable mTaskReady;
+
+    /** Signalled when the last thread finishes a task. */
+    std::condition_variable mTaskDone;
+
+    /** The current task. */
+    std::function<void (unsigned)> mTask;
+
+    /** Incremented for each task, so that threads can tell a new task from a spurious wake-up. */
+    unsigned long mGeneration;
+
+    /** The number of threads still running the current task. */
+    unsigned mNumRunning;
+
+    /** The first exception thrown by a thread during the current task, if any. */
+    std::exception_ptr mpException;
+
+    /** Whether the threads should exit. */
+    bool mStop;
+
+    /**
+     * The loop run by each of mThreads.
+     *
+     * @param threadIndex the index of the thread in the team
+     */
+    void WorkerLoop(unsigned threadIndex);
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param numThreads the number of threads, including the calling thread;
+     *     0 means one per hardware thread
+     */
+    ThreadTeam(unsigned numThreads);
+
+    /**
+     * Destructor. Stops the threads.
+     */
+    ~ThreadTeam();
+
+    /**
+     * @return the number of threads, including the calling thread
+     */
+    unsigned GetNumThreads() const;
+
+    /**
+     * Call a function on every thread of the team and wait for all the calls to
+     * return. If any call throws, the first exception is rethrown here.
+     *
+     * @param rTask the function, called with the index of each thread
+     */
+    void Run(const std::function<void (unsigned)>& rTask);
+};
+
+#endif /*THREADTEAM_HPP_*/
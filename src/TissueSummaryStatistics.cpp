@@ -0,0 +1,239 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "TissueSummaryStatistics.hpp"
+#include "AreaCorrelationWriter.hpp"
+#include "PolygonNumberCorrelationWriter.hpp"
+#include "NeighbourNumberCorrelationWriter.hpp"
+#include "NeighbourCorrelation.hpp"
+#include "BufferedTextEmitter.hpp"
+#include "Exception.hpp"
+
+#include <cstdlib>
+#include <sstream>
+#include <boost/accumulators/accumulators.hpp>
+#include <boost/accumulators/statistics.hpp>
+#include <boost/accumulators/statistics/mean.hpp>
+#include <boost/accumulators/statistics/variance.hpp>
+using namespace boost::accumulators;
+
+/** The number of statistics in a TissueSummaryStatistics. */
+static const unsigned NUM_STATISTICS = 10u;
+
+TissueSummaryStatistics::TissueSummaryStatistics()
+    : mNumCells(0.0),
+      mNumInternalCells(0.0),
+      mMeanArea(0.0),
+      mAreaVariance(0.0),
+      mMeanPerimeter(0.0),
+      mMeanPolygonNumber(0.0),
+      mPolygonNumberVariance(0.0),
+      mAreaCorrelation(0.0),
+      mPolygonNumberCorrelation(0.0),
+      mNeighbourNumberCorrelation(0.0)
+{
+}
+
+TissueSummaryStatistics TissueSummaryStatistics::Calculate(VertexBasedCellPopulation<2>* pCellPopulation,
+                                                           ElementGeometryCache* pElementGeometryCache)
+{
+    TissueSummaryStatistics statistics;
+
+    accumulator_set< double, features<tag::mean, tag::variance> > area_accumulator;
+    accumulator_set< double, features<tag::mean> > perimeter_accumulator;
+    accumulator_set< double, features<tag::mean, tag::variance> > polygon_accumulator;
+
+    // Shared with the writers, if they have already visited the population at this time
+    ElementGeometryCache own_cache;
+    ElementGeometryCache* p_cache = pElementGeometryCache ? pElementGeometryCache : &own_cache;
+    const ElementGeometryKernel& r_geometry = p_cache->rGetGeometry(pCellPopulation->rGetMesh());
+
+    for (AbstractCellPopulation<2>::Iterator cell_iter = pCellPopulation->Begin();
+         cell_iter != pCellPopulation->End();
+         ++cell_iter)
+    {
+        statistics.mNumCells += 1.0;
+
+        VertexElement<2,2>* p_element = pCellPopulation->GetElementCorrespondingToCell(*cell_iter);
+        if (!p_element->IsElementOnBoundary())
+        {
+            area_accumulator(r_geometry.rGetAreas()[p_element->GetIndex()]);
+            perimeter_accumulator(r_geometry.rGetPerimeters()[p_element->GetIndex()]);
+            polygon_accumulator(p_element->GetNumNodes());
+        }
+    }
+
+    statistics.mNumInternalCells = count(area_accumulator);
+    if (statistics.mNumInternalCells > 0)
+    {
+        statistics.mMeanArea = mean(area_accumulator);
+        statistics.mAreaVariance = variance(area_accumulator);
+        statistics.mMeanPerimeter = mean(perimeter_accumulator);
+        statistics.mMeanPolygonNumber = mean(polygon_accumulator);
+        statistics.mPolygonNumberVariance = variance(polygon_accumulator);
+
+        AreaCorrelationWriter<2,2> area_correlation_writer;
+        PolygonNumberCorrelationWriter<2,2> polygon_number_correlation_writer;
+        NeighbourNumberCorrelationWriter<2,2> neighbour_number_correlation_writer;
+
+        statistics.mAreaCorrelation = area_correlation_writer.CalculateAreaCorrelation(pCellPopulation);
+        statistics.mPolygonNumberCorrelation = polygon_number_correlation_writer.CalculatePolygonNumberCorrelation(pCellPopulation);
+        statistics.mNeighbourNumberCorrelation = neighbour_number_correlation_writer.CalculateNeighbourNumberCorrelation(pCellPopulation);
+    }
+
+    return statistics;
+}
+
+TissueSummaryStatistics TissueSummaryStatistics::Calculate(ObservedTissueMesh& rMesh)
+{
+    TissueSummaryStatistics statistics;
+
+    unsigned num_elements = rMesh.GetNumElements();
+    std::vector<double> areas(num_elements, 0.0);
+    std::vector<double> polygon_numbers(num_elements, 0.0);
+    std::vector<bool> is_internal(num_elements, false);
+    accumulator_set< double, features<tag::mean> > perimeter_accumulator;
+
+    for (unsigned element=0; element<num_elements; element++)
+    {
+        statistics.mNumCells += 1.0;
+
+        if (!rMesh.IsElementOnBoundary(element))
+        {
+            areas[element] = rMesh.GetAreaOfElement(element);
+            polygon_numbers[element] = rMesh.GetNumNodesInElement(element);
+            is_internal[element] = true;
+            perimeter_accumulator(rMesh.GetPerimeterOfElement(element));
+        }
+    }
+
+    statistics.mNumInternalCells = count(perimeter_accumulator);
+    if (statistics.mNumInternalCells > 0)
+    {
+        NeighbourCorrelation::GetMeanAndVariance(areas, is_internal, statistics.mMeanArea, statistics.mAreaVariance);
+        NeighbourCorrelation::GetMeanAndVariance(polygon_numbers, is_internal, statistics.mMeanPolygonNumber, statistics.mPolygonNumberVariance);
+        statistics.mMeanPerimeter = mean(perimeter_accumulator);
+
+        const std::vector<std::pair<unsigned, unsigned> >& r_pairs = rMesh.rGetNeighbourPairs();
+        std::vector<std::pair<unsigned, unsigned> > internal_pairs;
+        internal_pairs.reserve(r_pairs.size());
+        for (unsigned i=0; i<r_pairs.size(); i++)
+        {
+            if (is_internal[r_pairs[i].first] && is_internal[r_pairs[i].second])
+            {
+                internal_pairs.push_back(r_pairs[i]);
+            }
+        }
+
+        statistics.mAreaCorrelation = NeighbourCorrelation::Calculate(areas, is_internal, internal_pairs);
+        statistics.mPolygonNumberCorrelation = NeighbourCorrelation::Calculate(polygon_numbers, is_internal, internal_pairs);
+        statistics.mNeighbourNumberCorrelation = statistics.mPolygonNumberCorrelation;
+    }
+
+    return statistics;
+}
+
+std::vector<std::string> TissueSummaryStatistics::GetNames()
+{
+    std::vector<std::string> names = {"NumCells", "NumInternalCells", "MeanArea", "AreaVariance", "MeanPerimeter",
+                                      "MeanPolygonNumber", "PolygonNumberVariance", "AreaCorrelation",
+                                      "PolygonNumberCorrelation", "NeighbourNumberCorrelation"};
+    return names;
+}
+
+std::vector<double> TissueSummaryStatistics::ToVector() const
+{
+    std::vector<double> values = {mNumCells, mNumInternalCells, mMeanArea, mAreaVariance, mMeanPerimeter,
+                                  mMeanPolygonNumber, mPolygonNumberVariance, mAreaCorrelation,
+                                  mPolygonNumberCorrelation, mNeighbourNumberCorrelation};
+    return values;
+}
+
+TissueSummaryStatistics TissueSummaryStatistics::FromVector(const std::vector<double>& rValues)
+{
+    if (rValues.size() != NUM_STATISTICS)
+    {
+        EXCEPTION("Expected " << NUM_STATISTICS << " summary statistics but got " << rValues.size());
+    }
+
+    TissueSummaryStatistics statistics;
+    statistics.mNumCells = rValues[0];
+    statistics.mNumInternalCells = rValues[1];
+    statistics.mMeanArea = rValues[2];
+    statistics.mAreaVariance = rValues[3];
+    statistics.mMeanPerimeter = rValues[4];
+    statistics.mMeanPolygonNumber = rValues[5];
+    statistics.mPolygonNumberVariance = rValues[6];
+    statistics.mAreaCorrelation = rValues[7];
+    statistics.mPolygonNumberCorrelation = rValues[8];
+    statistics.mNeighbourNumberCorrelation = rValues[9];
+    return statistics;
+}
+
+std::string TissueSummaryStatistics::ToString() const
+{
+    std::vector<double> values = ToVector();
+
+    BufferedTextEmitter emitter(256);
+    emitter.SetUseShortestRoundTrip(true);
+    for (unsigned i=0; i<values.size(); i++)
+    {
+        if (i > 0)
+        {
+            emitter << ' ';
+        }
+        emitter << values[i];
+    }
+    return emitter.GetString();
+}
+
+TissueSummaryStatistics TissueSummaryStatistics::FromString(const std::string& rString)
+{
+    std::vector<double> values;
+    std::istringstream stream(rString);
+    std::string token;
+    while (stream >> token)
+    {
+        // strtod rather than operator>> so that "nan" and "inf" are read back too
+        char* p_end;
+        double value = std::strtod(token.c_str(), &p_end);
+        if (*p_end != '\0')
+        {
+            EXCEPTION("Could not read summary statistic " << token);
+        }
+        values.push_back(value);
+    }
+    return FromVector(values);
+}
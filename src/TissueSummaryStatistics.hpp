@@ -0,0 +1,141 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TISSUESUMMARYSTATISTICS_HPP_
+#define TISSUESUMMARYSTATISTICS_HPP_
+
+#include <string>
+#include <vector>
+#include "VertexBasedCellPopulation.hpp"
+#include "ElementGeometryCache.hpp"
+#include "ObservedTissueMesh.hpp"
+
+/**
+ * The summary statistics of a two-dimensional vertex-model tissue that are
+ * compared against data, e.g. when inferring Lambda and Gamma. As in the
+ * correlation writers, only cells that are not on the tissue boundary are used.
+ *
+ * The statistics can be converted to and from a vector (in the order given by
+ * GetNames()) and to and from a single line of text, which is how they are
+ * passed between processes.
+ */
+struct TissueSummaryStatistics
+{
+    /** The number of cells in the tissue. */
+    double mNumCells;
+
+    /** The number of cells that are not on the tissue boundary. */
+    double mNumInternalCells;
+
+    /** The mean area of the internal cells. */
+    double mMeanArea;
+
+    /** The variance of the area of the internal cells. */
+    double mAreaVariance;
+
+    /** The mean perimeter of the internal cells. */
+    double mMeanPerimeter;
+
+    /** The mean polygon number (number of edges) of the internal cells. */
+    double mMeanPolygonNumber;
+
+    /** The variance of the polygon number of the internal cells. */
+    double mPolygonNumberVariance;
+
+    /** The area correlation, as written by AreaCorrelationWriter. */
+    double mAreaCorrelation;
+
+    /** The polygon number correlation, as written by PolygonNumberCorrelationWriter. */
+    double mPolygonNumberCorrelation;
+
+    /** The neighbour number correlation, as written by NeighbourNumberCorrelationWriter. */
+    double mNeighbourNumberCorrelation;
+
+    /**
+     * Default constructor. All statistics are set to zero.
+     */
+    TissueSummaryStatistics();
+
+    /**
+     * Calculate the summary statistics of a tissue.
+     *
+     * @param pCellPopulation the population
+     * @param pElementGeometryCache the simulation's element geometry cache, if
+     *     any, to share the geometry with its writers (defaults to none)
+     * @return the statistics
+     */
+    static TissueSummaryStatistics Calculate(VertexBasedCellPopulation<2>* pCellPopulation,
+                                             ElementGeometryCache* pElementGeometryCache=nullptr);
+
+    /**
+     * Calculate the summary statistics of an observed (segmented) tissue, with the
+     * same definitions and correlation kernel (NeighbourCorrelation) as for a
+     * simulated one. The polygon number and neighbour number of a cell are both
+     * its number of vertices, as in the correlation writers.
+     *
+     * @param rMesh the tissue
+     * @return the statistics
+     */
+    static TissueSummaryStatistics Calculate(ObservedTissueMesh& rMesh);
+
+    /**
+     * @return the names of the statistics, in the order used by ToVector()
+     */
+    static std::vector<std::string> GetNames();
+
+    /**
+     * @return the statistics as a vector, in the order given by GetNames()
+     */
+    std::vector<double> ToVector() const;
+
+    /**
+     * @param rValues the statistics in the order given by GetNames()
+     * @return the statistics
+     */
+    static TissueSummaryStatistics FromVector(const std::vector<double>& rValues);
+
+    /**
+     * @return the statistics as a line of space-separated numbers that round-trip exactly
+     */
+    std::string ToString() const;
+
+    /**
+     * @param rString a string produced by ToString()
+     * @return the statistics
+     */
+    static TissueSummaryStatistics FromString(const std::string& rString);
+};
+
+#endif /*TISSUESUMMARYSTATISTICS_HPP_*/
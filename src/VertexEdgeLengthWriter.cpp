@@ -42,11 +42,12 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "VertexBasedCellPopulation.hpp"
 #include "ImmersedBoundaryCellPopulation.hpp"
 #include "VertexElement.hpp"
+#include "VertexMeshNeighbours.hpp"
 #include "UblasIncludes.hpp"
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 VertexEdgeLengthWriter<ELEMENT_DIM, SPACE_DIM>::VertexEdgeLengthWriter()
-    : AbstractCellPopulationWriter<ELEMENT_DIM, SPACE_DIM>("EdgeLengths.dat")
+    : AbstractProjectWriter<AbstractCellPopulationWriter<ELEMENT_DIM, SPACE_DIM> >("EdgeLengths.dat")
 {
 }
 
@@ -89,6 +90,8 @@ void VertexEdgeLengthWriter<ELEMENT_DIM, SPACE_DIM>::Visit(VertexBasedCellPopula
 
 	std::vector<double> edge_lengths;
 
+	SmallIndexSet shared_elements;
+
     MutableVertexMesh<SPACE_DIM,SPACE_DIM>& r_mesh = pCellPopulation->rGetMesh();
 
 	// Loop over cells
@@ -104,17 +107,8 @@ void VertexEdgeLengthWriter<ELEMENT_DIM, SPACE_DIM>::Visit(VertexBasedCellPopula
             Node<SPACE_DIM>* p_this_node = p_element->GetNode(vertex_index);
             Node<SPACE_DIM>* p_next_node = p_element->GetNode((vertex_index == num_nodes - 1) ? 0 : vertex_index + 1);
 
-            // Find the indices of the elements owned by each node
-            std::set<unsigned> elements_containing_nodeA = p_this_node->rGetContainingElementIndices();
-            std::set<unsigned> elements_containing_nodeB = p_next_node->rGetContainingElementIndices();
-
-            // Find common elements
-            std::set<unsigned> shared_elements;
-            std::set_intersection(elements_containing_nodeA.begin(),
-                                  elements_containing_nodeA.end(),
-                                  elements_containing_nodeB.begin(),
-                                  elements_containing_nodeB.end(),
-                                  std::inserter(shared_elements, shared_elements.begin()));
+            // Find the elements owned by both nodes
+            VertexMeshNeighbours<SPACE_DIM, SPACE_DIM>::GetSharedElementIndices(p_this_node, p_next_node, shared_elements);
 
             shared_elements.erase(p_element->GetIndex());
             if ( shared_elements.size() > 0 )
@@ -129,11 +123,11 @@ void VertexEdgeLengthWriter<ELEMENT_DIM, SPACE_DIM>::Visit(VertexBasedCellPopula
         visited_elements.insert(location_index);
 	}
 
-    *this->mpOutStream << edge_lengths.size() << "\t";
+    this->mEmitter << edge_lengths.size() << "\t";
 
     for (unsigned index = 0;  index < edge_lengths.size(); index++)
     {
-        *this->mpOutStream << edge_lengths[index] << "\t";
+        this->mEmitter << edge_lengths[index] << "\t";
     }
 }
 
@@ -37,6 +37,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define VERTEXEDGELENGTHWRITER_HPP_
 
 #include "AbstractCellPopulationWriter.hpp"
+#include "AbstractProjectWriter.hpp"
 #include "ChasteSerialization.hpp"
 #include <boost/serialization/base_object.hpp>
 
@@ -46,7 +47,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * The output file is called T2SwapLocations.dat by default.
  */
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
-class VertexEdgeLengthWriter : public AbstractCellPopulationWriter<ELEMENT_DIM, SPACE_DIM>
+class VertexEdgeLengthWriter : public AbstractProjectWriter<AbstractCellPopulationWriter<ELEMENT_DIM, SPACE_DIM> >
 {
 private:
     /** Needed for serialization. */
@@ -60,7 +61,7 @@ private:
     template<class Archive>
     void serialize(Archive & archive, const unsigned int version)
     {
-        archive & boost::serialization::base_object<AbstractCellPopulationWriter<ELEMENT_DIM, SPACE_DIM> >(*this);
+        archive & boost::serialization::base_object<AbstractProjectWriter<AbstractCellPopulationWriter<ELEMENT_DIM, SPACE_DIM> > >(*this);
     }
 
 public:
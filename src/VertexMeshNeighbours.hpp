@@ -0,0 +1,81 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef VERTEXMESHNEIGHBOURS_HPP_
+#define VERTEXMESHNEIGHBOURS_HPP_
+
+#include "Node.hpp"
+#include "VertexElement.hpp"
+#include "SmallIndexSet.hpp"
+
+/**
+ * Neighbour queries on a vertex mesh that fill a SmallIndexSet instead of
+ * building std::sets.
+ *
+ * Node::rGetContainingElementIndices() returns a reference to the node's own
+ * std::set, but the writers used to copy it for each end of each edge, and
+ * VertexMesh::GetNeighbouringElementIndices() builds a new std::set for each
+ * element. These functions read the nodes' sets in place and collect the
+ * result in the caller's SmallIndexSet, so that, for the usual numbers of
+ * elements per vertex and neighbours per cell, they do not allocate.
+ */
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+class VertexMeshNeighbours
+{
+public:
+
+    /**
+     * Find the elements that contain both ends of an edge.
+     *
+     * @param pNodeA a node
+     * @param pNodeB another node
+     * @param rSharedElements filled in with the indices of the elements containing both nodes
+     */
+    static void GetSharedElementIndices(Node<SPACE_DIM>* pNodeA,
+                                        Node<SPACE_DIM>* pNodeB,
+                                        SmallIndexSet& rSharedElements);
+
+    /**
+     * Find the elements that share a vertex with an element, as
+     * VertexMesh::GetNeighbouringElementIndices() does.
+     *
+     * @param pElement an element
+     * @param rNeighbours filled in with the indices of the other elements containing its vertices
+     */
+    static void GetNeighbouringElementIndices(VertexElement<ELEMENT_DIM, SPACE_DIM>* pElement,
+                                              SmallIndexSet& rNeighbours);
+};
+
+#endif /*VERTEXMESHNEIGHBOURS_HPP_*/
@@ -38,6 +38,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Cell.hpp"
 #include "CellLabel.hpp"
 #include "MutableVertexMesh.hpp"
+#include "VertexMeshNeighbours.hpp"
 
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics.hpp>
@@ -49,7 +50,7 @@ using namespace boost::accumulators;
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 VertexModelDataWriter<ELEMENT_DIM, SPACE_DIM>::VertexModelDataWriter()
-        : AbstractCellWriter<ELEMENT_DIM, SPACE_DIM>("VertexData.txt")
+        : AbstractProjectWriter<AbstractCellWriter<ELEMENT_DIM, SPACE_DIM> >("VertexData.txt")
 {
 	this->mVtkCellDataName = "VertexDataDummy";
 }
@@ -66,15 +67,18 @@ double VertexModelDataWriter<ELEMENT_DIM, SPACE_DIM>::GetAverageCellAreaOfNeighb
 	unsigned location_index = pCellPopulation->GetLocationIndexUsingCell(pCell);
 
 	MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>* p_mesh = static_cast<MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>* >(&(pCellPopulation->rGetMesh()));
-	std::set<unsigned> indices_of_neighbour_elements = p_mesh->GetNeighbouringElementIndices(location_index);
+	SmallIndexSet indices_of_neighbour_elements;
+	VertexMeshNeighbours<ELEMENT_DIM, SPACE_DIM>::GetNeighbouringElementIndices(p_mesh->GetElement(location_index),
+	                                                                           indices_of_neighbour_elements);
 
+	const std::vector<double>& r_areas = this->rGetElementGeometry(*p_mesh).rGetAreas();
 	accumulator_set< double, features<tag::mean > > area_accumulator;
 
-	for( std::set<unsigned>::iterator this_iter = indices_of_neighbour_elements.begin();
+	for( SmallIndexSet::const_iterator this_iter = indices_of_neighbour_elements.begin();
 	        this_iter != indices_of_neighbour_elements.end();
 	        this_iter++)
 	{
-	    double this_area = p_mesh->GetVolumeOfElement(*this_iter);
+	    double this_area = r_areas[*this_iter];
 	    area_accumulator(this_area);
 	}
 
@@ -93,11 +97,13 @@ double VertexModelDataWriter<ELEMENT_DIM, SPACE_DIM>::GetAverageNeighbourNumberO
 	unsigned location_index = pCellPopulation->GetLocationIndexUsingCell(pCell);
 
 	MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>* p_mesh = static_cast<MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>* >(&(pCellPopulation->rGetMesh()));
-	std::set<unsigned> indices_of_neighbour_elements = p_mesh->GetNeighbouringElementIndices(location_index);
+	SmallIndexSet indices_of_neighbour_elements;
+	VertexMeshNeighbours<ELEMENT_DIM, SPACE_DIM>::GetNeighbouringElementIndices(p_mesh->GetElement(location_index),
+	                                                                           indices_of_neighbour_elements);
 
 	accumulator_set< double, features<tag::mean> > neighbour_number_accumulator;
 
-	for( std::set<unsigned>::iterator this_iter = indices_of_neighbour_elements.begin();
+	for( SmallIndexSet::const_iterator this_iter = indices_of_neighbour_elements.begin();
 	        this_iter != indices_of_neighbour_elements.end();
 	        this_iter++)
 	{
@@ -120,11 +126,13 @@ bool VertexModelDataWriter<ELEMENT_DIM, SPACE_DIM>::IsCellOnInnerBoundary(CellPt
 	unsigned location_index = pCellPopulation->GetLocationIndexUsingCell(pCell);
 
 	MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>* p_mesh = static_cast<MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>* >(&(pCellPopulation->rGetMesh()));
-	std::set<unsigned> indices_of_neighbour_elements = p_mesh->GetNeighbouringElementIndices(location_index);
+	SmallIndexSet indices_of_neighbour_elements;
+	VertexMeshNeighbours<ELEMENT_DIM, SPACE_DIM>::GetNeighbouringElementIndices(p_mesh->GetElement(location_index),
+	                                                                           indices_of_neighbour_elements);
 
 	bool is_on_inner_boundary = false;
 
-	for( std::set<unsigned>::iterator this_iter = indices_of_neighbour_elements.begin();
+	for( SmallIndexSet::const_iterator this_iter = indices_of_neighbour_elements.begin();
 	        this_iter != indices_of_neighbour_elements.end();
 	        this_iter++)
 	{
@@ -157,37 +165,40 @@ void VertexModelDataWriter<ELEMENT_DIM, SPACE_DIM>::VisitCell(CellPtr pCell, Abs
 	// Note that the line below will only return something sensible if using a VertexBasedCellPopulation
 	MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>* p_mesh = static_cast<MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>* >(&(pCellPopulation->rGetMesh()));
 
+	// The geometry of every cell, shared with the other writers at this time step
+	const ElementGeometryKernel& r_geometry = this->rGetElementGeometry(*p_mesh);
+
 	unsigned num_edges = p_mesh->GetElement(location_index)->GetNumNodes();
-	double cell_area = p_mesh->GetVolumeOfElement(location_index);
-	*this->mpOutStream << SimulationTime::Instance()->GetTime() << " " << location_index << " " << cell_id << " " << cell_type << " " << num_edges << " " << cell_area << " ";
+	double cell_area = r_geometry.rGetAreas()[location_index];
+	this->mEmitter << SimulationTime::Instance()->GetTime() << " " << location_index << " " << cell_id << " " << cell_type << " " << num_edges << " " << cell_area << " ";
 
-	c_vector<double, SPACE_DIM> centre_location = pCellPopulation->GetLocationOfCellCentre(pCell);
-	for (unsigned i=0; i<SPACE_DIM; i++)
+	for (unsigned i=0; i<2; i++)
 	{
-		*this->mpOutStream << " " << centre_location[i];
+		this->mEmitter << " " << r_geometry.rGetCentroids()[2*location_index + i];
 	}
 
 	if (pCell->HasCellProperty<CellLabel>())
 	{
-		*this->mpOutStream << " " << 1; //labelled true
+		this->mEmitter << " " << 1; //labelled true
 	}
 	else
 	{
-		*this->mpOutStream << " " << 0; //labelled false
+		this->mEmitter << " " << 0; //labelled false
 	}
 
-	*this->mpOutStream << " " << p_mesh->GetElement(location_index)->IsElementOnBoundary();
-	*this->mpOutStream << " " << p_mesh->GetSurfaceAreaOfElement(location_index);
-	*this->mpOutStream << " " << p_mesh->GetElongationShapeFactorOfElement(location_index);
-	*this->mpOutStream << " " << this->IsCellOnInnerBoundary( pCell, pCellPopulation);
-	*this->mpOutStream << " " << this->GetAverageNeighbourNumberOfNeighbours( pCell, pCellPopulation);
-	*this->mpOutStream << " " << this->GetAverageCellAreaOfNeighbours( pCell, pCellPopulation);
-	*this->mpOutStream << "\n";
+	this->mEmitter << " " << p_mesh->GetElement(location_index)->IsElementOnBoundary();
+	this->mEmitter << " " << r_geometry.rGetPerimeters()[location_index];
+	this->mEmitter << " " << r_geometry.rGetElongationShapeFactors()[location_index];
+	this->mEmitter << " " << this->IsCellOnInnerBoundary( pCell, pCellPopulation);
+	this->mEmitter << " " << this->GetAverageNeighbourNumberOfNeighbours( pCell, pCellPopulation);
+	this->mEmitter << " " << this->GetAverageCellAreaOfNeighbours( pCell, pCellPopulation);
+	this->mEmitter << "\n";
 }
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void VertexModelDataWriter<ELEMENT_DIM, SPACE_DIM>::WriteTimeStamp()
 {
+    this->BeginOutputBlock();
 }
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -39,6 +39,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ChasteSerialization.hpp"
 #include <boost/serialization/base_object.hpp>
 #include "AbstractCellWriter.hpp"
+#include "AbstractProjectWriter.hpp"
 
 /**
  * A class written using the visitor pattern for writing the polygon class
@@ -46,7 +47,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * used when simulating a vertex-based model.
  */
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
-class VertexModelDataWriter : public AbstractCellWriter<ELEMENT_DIM, SPACE_DIM>
+class VertexModelDataWriter : public AbstractProjectWriter<AbstractCellWriter<ELEMENT_DIM, SPACE_DIM> >
 {
 private:
 
@@ -61,7 +62,7 @@ private:
     template<class Archive>
     void serialize(Archive & archive, const unsigned int version)
     {
-        archive & boost::serialization::base_object<AbstractCellWriter<ELEMENT_DIM, SPACE_DIM> >(*this);
+        archive & boost::serialization::base_object<AbstractProjectWriter<AbstractCellWriter<ELEMENT_DIM, SPACE_DIM> > >(*this);
     }
 
 public:
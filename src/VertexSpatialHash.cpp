@@ -0,0 +1,202 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "VertexSpatialHash.hpp"
+#include "Exception.hpp"
+
+#include <cmath>
+
+namespace
+{
+    /** The number of buckets to start with. */
+    const unsigned INITIAL_NUM_BUCKETS = 1024u;
+}
+
+VertexSpatialHash::VertexSpatialHash(double cellSize)
+    : mCellSize(cellSize),
+      mBuckets(INITIAL_NUM_BUCKETS),
+      mNumVertices(0u),
+      mNumCellChanges(0u)
+{
+    if (!(cellSize > 0.0))
+    {
+        EXCEPTION("The grid cell size must be positive");
+    }
+}
+
+unsigned VertexSpatialHash::GetBucket(int column, int row) const
+{
+    // Multiply by large odd constants to spread neighbouring cells over the buckets
+    unsigned hash = (unsigned)column*73856093u ^ (unsigned)row*19349663u;
+    return hash & (mBuckets.size() - 1u);
+}
+
+void VertexSpatialHash::AddToBucket(unsigned index)
+{
+    std::vector<unsigned>& r_bucket = mBuckets[GetBucket(mColumns[index], mRows[index])];
+    mPositionsInBuckets[index] = r_bucket.size();
+    r_bucket.push_back(index);
+}
+
+void VertexSpatialHash::RemoveFromBucket(unsigned index)
+{
+    // Move the last vertex of the bucket into the gap
+    std::vector<unsigned>& r_bucket = mBuckets[GetBucket(mColumns[index], mRows[index])];
+    unsigned last = r_bucket.back();
+    r_bucket[mPositionsInBuckets[index]] = last;
+    mPositionsInBuckets[last] = mPositionsInBuckets[index];
+    r_bucket.pop_back();
+}
+
+double VertexSpatialHash::GetCellSize() const
+{
+    return mCellSize;
+}
+
+void VertexSpatialHash::SetVertex(unsigned index, double x, double y)
+{
+    if (index >= mIsPresent.size())
+    {
+        mX.resize(index + 1);
+        mY.resize(index + 1);
+        mColumns.resize(index + 1);
+        mRows.resize(index + 1);
+        mPositionsInBuckets.resize(index + 1);
+        mIsPresent.resize(index + 1, 0u);
+    }
+    mX[index] = x;
+    mY[index] = y;
+    int column = (int)std::floor(x/mCellSize);
+    int row = (int)std::floor(y/mCellSize);
+
+    if (mIsPresent[index])
+    {
+        if (column == mColumns[index] && row == mRows[index])
+        {
+            return;
+        }
+        RemoveFromBucket(index);
+        mNumCellChanges++;
+    }
+    else
+    {
+        mIsPresent[index] = 1u;
+        mNumVertices++;
+    }
+    mColumns[index] = column;
+    mRows[index] = row;
+    AddToBucket(index);
+
+    // Keep the buckets at most half full on average, so that queries stay short
+    if (mNumVertices > 2u*mBuckets.size())
+    {
+        std::vector<std::vector<unsigned> >(2u*mBuckets.size()).swap(mBuckets);
+        for (unsigned vertex=0; vertex<mIsPresent.size(); vertex++)
+        {
+            if (mIsPresent[vertex])
+            {
+                AddToBucket(vertex);
+            }
+        }
+    }
+}
+
+void VertexSpatialHash::RemoveVertex(unsigned index)
+{
+    if (Contains(index))
+    {
+        RemoveFromBucket(index);
+        mIsPresent[index] = 0u;
+        mNumVertices--;
+    }
+}
+
+void VertexSpatialHash::Truncate(unsigned numVertices)
+{
+    for (unsigned index=numVertices; index<mIsPresent.size(); index++)
+    {
+        RemoveVertex(index);
+    }
+    if (numVertices < mIsPresent.size())
+    {
+        mX.resize(numVertices);
+        mY.resize(numVertices);
+        mColumns.resize(numVertices);
+        mRows.resize(numVertices);
+        mPositionsInBuckets.resize(numVertices);
+        mIsPresent.resize(numVertices);
+    }
+}
+
+bool VertexSpatialHash::Contains(unsigned index) const
+{
+    return index < mIsPresent.size() && mIsPresent[index];
+}
+
+unsigned VertexSpatialHash::GetNumVertices() const
+{
+    return mNumVertices;
+}
+
+unsigned long VertexSpatialHash::GetNumCellChanges() const
+{
+    return mNumCellChanges;
+}
+
+void VertexSpatialHash::GetVerticesInBox(double xMin, double yMin, double xMax, double yMax, std::vector<unsigned>& rVertices) const
+{
+    rVertices.clear();
+    int min_column = (int)std::floor(xMin/mCellSize);
+    int max_column = (int)std::floor(xMax/mCellSize);
+    int min_row = (int)std::floor(yMin/mCellSize);
+    int max_row = (int)std::floor(yMax/mCellSize);
+    for (int column=min_column; column<=max_column; column++)
+    {
+        for (int row=min_row; row<=max_row; row++)
+        {
+            const std::vector<unsigned>& r_bucket = mBuckets[GetBucket(column, row)];
+            for (unsigned position=0; position<r_bucket.size(); position++)
+            {
+                // Other grid cells may share the bucket
+                unsigned index = r_bucket[position];
+                if (mColumns[index] == column && mRows[index] == row
+                    && mX[index] >= xMin && mX[index] <= xMax && mY[index] >= yMin && mY[index] <= yMax)
+                {
+                    rVertices.push_back(index);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,173 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef VERTEXSPATIALHASH_HPP_
+#define VERTEXSPATIALHASH_HPP_
+
+#include <vector>
+
+/**
+ * A uniform grid over vertex positions in 2D, for finding the vertices near a
+ * point or element without looking at every vertex (see
+ * SpatialHashIntersectionModifier).
+ *
+ * The grid is unbounded, so that it needs no rebuilding as a tissue grows:
+ * grid cells are hashed into a power-of-two number of buckets, which is
+ * doubled when the buckets fill up. Vertices are identified by index. Calling
+ * SetVertex() for every vertex at every time step keeps the grid up to date
+ * incrementally, since a vertex only changes bucket when it changes grid cell.
+ */
+class VertexSpatialHash
+{
+private:
+
+    /** The side length of the grid cells. */
+    double mCellSize;
+
+    /** The vertex indices in each bucket, in no particular order. */
+    std::vector<std::vector<unsigned> > mBuckets;
+
+    /** The x coordinate of each vertex. */
+    std::vector<double> mX;
+
+    /** The y coordinate of each vertex. */
+    std::vector<double> mY;
+
+    /** The grid column of each vertex. */
+    std::vector<int> mColumns;
+
+    /** The grid row of each vertex. */
+    std::vector<int> mRows;
+
+    /** The position of each vertex in its bucket. */
+    std::vector<unsigned> mPositionsInBuckets;
+
+    /** Whether each index holds a vertex. */
+    std::vector<unsigned char> mIsPresent;
+
+    /** The number of vertices held. */
+    unsigned mNumVertices;
+
+    /** The number of times a vertex has moved from one grid cell to another. */
+    unsigned long mNumCellChanges;
+
+    /**
+     * @param column a grid column
+     * @param row a grid row
+     * @return the bucket of the grid cell
+     */
+    unsigned GetBucket(int column, int row) const;
+
+    /**
+     * Add a vertex to the bucket of its grid cell.
+     *
+     * @param index the vertex index
+     */
+    void AddToBucket(unsigned index);
+
+    /**
+     * Remove a vertex from its bucket.
+     *
+     * @param index the vertex index
+     */
+    void RemoveFromBucket(unsigned index);
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param cellSize the side length of the grid cells, e.g. a typical element diameter
+     */
+    VertexSpatialHash(double cellSize);
+
+    /**
+     * @return the side length of the grid cells
+     */
+    double GetCellSize() const;
+
+    /**
+     * Add a vertex, or move it if it is already held.
+     *
+     * @param index the vertex index
+     * @param x the x coordinate
+     * @param y the y coordinate
+     */
+    void SetVertex(unsigned index, double x, double y);
+
+    /**
+     * Remove a vertex, if it is held.
+     *
+     * @param index the vertex index
+     */
+    void RemoveVertex(unsigned index);
+
+    /**
+     * Remove all vertices with index numVertices or more, e.g. after the mesh
+     * has removed deleted nodes.
+     *
+     * @param numVertices the number of vertex indices to keep
+     */
+    void Truncate(unsigned numVertices);
+
+    /**
+     * @param index a vertex index
+     * @return whether the vertex is held
+     */
+    bool Contains(unsigned index) const;
+
+    /**
+     * @return the number of vertices held
+     */
+    unsigned GetNumVertices() const;
+
+    /**
+     * @return the number of times a vertex has moved from one grid cell to another
+     */
+    unsigned long GetNumCellChanges() const;
+
+    /**
+     * Find the vertices in a box, boundary included.
+     *
+     * @param xMin the smallest x coordinate of the box
+     * @param yMin the smallest y coordinate of the box
+     * @param xMax the largest x coordinate of the box
+     * @param yMax the largest y coordinate of the box
+     * @param rVertices filled in with the indices of the vertices in the box, in no particular order
+     */
+    void GetVerticesInBox(double xMin, double yMin, double xMax, double yMax, std::vector<unsigned>& rVertices) const;
+};
+
+#endif /*VERTEXSPATIALHASH_HPP_*/
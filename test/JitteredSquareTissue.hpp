@@ -0,0 +1,112 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef JITTEREDSQUARETISSUE_HPP_
+#define JITTEREDSQUARETISSUE_HPP_
+
+#include <vector>
+#include "Philox4x32.hpp"
+
+/**
+ * Test fixture: a tissue of numX by numY unit squares with randomly moved
+ * vertices, in the flat layout taken by FarhadifarForceKernel and
+ * ElementGeometryKernel. The vertices and cells are numbered row by row from
+ * the corner at the origin, and the vertices of each cell run anticlockwise.
+ */
+struct JitteredSquareTissue
+{
+    /** The x and y coordinates of each vertex in turn. */
+    std::vector<double> mNodeLocations;
+
+    /** The vertices of cell i are mElementNodes[mElementOffsets[i]] up to mElementNodes[mElementOffsets[i+1]]. */
+    std::vector<unsigned> mElementOffsets;
+
+    /** The vertices of all the cells. */
+    std::vector<unsigned> mElementNodes;
+
+    /**
+     * Constructor.
+     *
+     * @param numX the number of cells in the x direction
+     * @param numY the number of cells in the y direction
+     * @param seed the seed of the random numbers that move the vertices
+     * @param jitter each vertex is moved by up to jitter/2 in each direction
+     * @param fixBoundary whether to leave the vertices on the edge of the tissue where they are
+     */
+    JitteredSquareTissue(unsigned numX, unsigned numY, unsigned seed, double jitter, bool fixBoundary=false)
+    {
+        Philox4x32 random(seed);
+        for (unsigned j=0; j<=numY; j++)
+        {
+            for (unsigned i=0; i<=numX; i++)
+            {
+                bool fixed = fixBoundary && (i == 0 || j == 0 || i == numX || j == numY);
+                double dx = fixed ? 0.0 : jitter*(random.ranf() - 0.5);
+                double dy = fixed ? 0.0 : jitter*(random.ranf() - 0.5);
+                mNodeLocations.push_back(i + dx);
+                mNodeLocations.push_back(j + dy);
+            }
+        }
+
+        mElementOffsets.push_back(0u);
+        for (unsigned j=0; j<numY; j++)
+        {
+            for (unsigned i=0; i<numX; i++)
+            {
+                unsigned corner = j*(numX + 1) + i;
+                mElementNodes.insert(mElementNodes.end(), {corner, corner + 1, corner + numX + 2, corner + numX + 1});
+                mElementOffsets.push_back(mElementNodes.size());
+            }
+        }
+    }
+
+    /**
+     * @return the number of vertices
+     */
+    unsigned GetNumNodes() const
+    {
+        return mNodeLocations.size()/2;
+    }
+
+    /**
+     * @return the number of cells
+     */
+    unsigned GetNumElements() const
+    {
+        return mElementOffsets.size() - 1;
+    }
+};
+
+#endif /*JITTEREDSQUARETISSUE_HPP_*/
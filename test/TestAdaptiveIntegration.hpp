@@ -0,0 +1,192 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTADAPTIVEINTEGRATION_HPP_
+#define TESTADAPTIVEINTEGRATION_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <cmath>
+#include "FakePetscSetup.hpp"
+#include "Exception.hpp"
+#include "AdaptiveStepController.hpp"
+#include "EmbeddedRungeKuttaTableau.hpp"
+
+class TestAdaptiveIntegration : public CxxTest::TestSuite
+{
+private:
+
+    /**
+     * Integrate dx/dt = -x/2 - 2y, dy/dt = 2x - y/2 from (1, 0), whose solution
+     * is exp(-t/2) (cos 2t, sin 2t), as AbstractAdaptiveNumericalMethod does.
+     *
+     * @param rTableau the Runge-Kutta pair
+     * @param rController the step controller
+     * @param endTime the time to integrate to
+     * @param rNumEvaluations filled in with the number of evaluations of the right-hand side
+     * @return the largest distance from the solution at the end of a step
+     */
+    static double Integrate(const EmbeddedRungeKuttaTableau& rTableau, AdaptiveStepController& rController,
+                            double endTime, unsigned& rNumEvaluations)
+    {
+        unsigned num_stages = rTableau.GetNumStages();
+        std::vector<double> k_x(num_stages);
+        std::vector<double> k_y(num_stages);
+        double x = 1.0;
+        double y = 0.0;
+        double time = 0.0;
+        double max_error = 0.0;
+        k_x[0] = -0.5*x - 2.0*y;
+        k_y[0] = 2.0*x - 0.5*y;
+        rNumEvaluations = 1u;
+        while (time < endTime)
+        {
+            double step = rController.GetStep(endTime - time);
+            for (unsigned stage=1; stage<num_stages; stage++)
+            {
+                double stage_x = x;
+                double stage_y = y;
+                for (unsigned previous=0; previous<stage; previous++)
+                {
+                    stage_x += step*rTableau.rGetStageCoefficients(stage)[previous]*k_x[previous];
+                    stage_y += step*rTableau.rGetStageCoefficients(stage)[previous]*k_y[previous];
+                }
+                k_x[stage] = -0.5*stage_x - 2.0*stage_y;
+                k_y[stage] = 2.0*stage_x - 0.5*stage_y;
+                rNumEvaluations++;
+            }
+            double new_x = x;
+            double new_y = y;
+            double error_x = 0.0;
+            double error_y = 0.0;
+            for (unsigned stage=0; stage<num_stages; stage++)
+            {
+                new_x += step*rTableau.rGetSolutionWeights()[stage]*k_x[stage];
+                new_y += step*rTableau.rGetSolutionWeights()[stage]*k_y[stage];
+                error_x += step*rTableau.rGetErrorWeights()[stage]*k_x[stage];
+                error_y += step*rTableau.rGetErrorWeights()[stage]*k_y[stage];
+            }
+            if (rController.RecordStep(step, std::hypot(error_x, error_y)))
+            {
+                time = (step == endTime - time) ? endTime : time + step;
+                x = new_x;
+                y = new_y;
+                k_x[0] = k_x[num_stages - 1];
+                k_y[0] = k_y[num_stages - 1];
+                max_error = std::max(max_error, std::hypot(x - std::exp(-0.5*time)*std::cos(2.0*time),
+                                                           y - std::exp(-0.5*time)*std::sin(2.0*time)));
+            }
+        }
+        return max_error;
+    }
+
+public:
+
+    void TestTableaux()
+    {
+        for (unsigned order=3; order<=5; order+=2)
+        {
+            EmbeddedRungeKuttaTableau tableau = EmbeddedRungeKuttaTableau::Create(order);
+            TS_ASSERT_EQUALS(tableau.GetOrder(), order);
+            TS_ASSERT_EQUALS(tableau.GetErrorOrder(), order - 1u);
+            TS_ASSERT_EQUALS(tableau.GetNumStages(), order == 3u ? 4u : 7u);
+            TS_ASSERT(tableau.IsFirstSameAsLast());
+
+            // Consistency: the solution weights sum to 1 and the error weights to 0
+            double solution_sum = 0.0;
+            double error_sum = 0.0;
+            for (unsigned stage=0; stage<tableau.GetNumStages(); stage++)
+            {
+                TS_ASSERT_EQUALS(tableau.rGetStageCoefficients(stage).size(), stage);
+                solution_sum += tableau.rGetSolutionWeights()[stage];
+                error_sum += tableau.rGetErrorWeights()[stage];
+            }
+            TS_ASSERT_DELTA(solution_sum, 1.0, 1e-14);
+            TS_ASSERT_DELTA(error_sum, 0.0, 1e-14);
+        }
+        TS_ASSERT_THROWS_CONTAINS(EmbeddedRungeKuttaTableau::Create(4u), "order 3 and 5 only");
+    }
+
+    void TestStepController()
+    {
+        AdaptiveStepController controller(1e-3, 1u);
+        TS_ASSERT_EQUALS(controller.GetStep(0.1), 0.1);
+
+        // An error 100 times the tolerance is rejected and the step shrinks by the largest factor
+        TS_ASSERT(!controller.RecordStep(0.1, 0.1));
+        TS_ASSERT_DELTA(controller.GetStep(1.0), 0.02, 1e-15);
+
+        // An error a quarter of the tolerance is accepted and, with p = 1, the step grows by 0.9*2
+        TS_ASSERT(controller.RecordStep(0.02, 0.25e-3));
+        TS_ASSERT_DELTA(controller.GetStep(1.0), 0.036, 1e-15);
+
+        // A step cut short by the end of a time step does not shrink the proposal
+        TS_ASSERT(controller.RecordStep(0.001, 0.0));
+        TS_ASSERT_DELTA(controller.GetStep(1.0), 0.036, 1e-15);
+
+        // NaN is rejected
+        TS_ASSERT(!controller.RecordStep(0.036, std::nan("")));
+        TS_ASSERT_DELTA(controller.GetStep(1.0), 0.0072, 1e-15);
+
+        TS_ASSERT_EQUALS(controller.GetNumAcceptedSteps(), 2u);
+        TS_ASSERT_EQUALS(controller.GetNumRejectedSteps(), 2u);
+        TS_ASSERT_EQUALS(controller.GetSmallestAcceptedStep(), 0.001);
+        TS_ASSERT_EQUALS(controller.GetLargestAcceptedStep(), 0.02);
+
+        TS_ASSERT_THROWS_CONTAINS(controller.SetTolerance(0.0), "must be positive");
+        TS_ASSERT_THROWS_CONTAINS(controller.SetErrorOrder(0u), "must be positive");
+    }
+
+    void TestIntegrationToTolerance()
+    {
+        // Both pairs keep the global error near the tolerance, and RK45 needs far fewer evaluations
+        unsigned evaluations[2];
+        for (unsigned order=3; order<=5; order+=2)
+        {
+            EmbeddedRungeKuttaTableau tableau = EmbeddedRungeKuttaTableau::Create(order);
+            AdaptiveStepController controller(1e-8, tableau.GetErrorOrder());
+            unsigned& r_evaluations = evaluations[order/5];
+            double error = Integrate(tableau, controller, 10.0, r_evaluations);
+            TS_ASSERT_LESS_THAN(error, 1e-7);
+            TS_ASSERT_LESS_THAN(0u, controller.GetNumAcceptedSteps());
+
+            // Starting with the whole interval as the first step forces at least one rejection
+            TS_ASSERT_LESS_THAN(0u, controller.GetNumRejectedSteps());
+            TS_ASSERT_LESS_THAN(controller.GetNumRejectedSteps(), controller.GetNumAcceptedSteps()/5);
+        }
+        TS_ASSERT_LESS_THAN(3*evaluations[1], evaluations[0]);
+    }
+};
+
+#endif /*TESTADAPTIVEINTEGRATION_HPP_*/
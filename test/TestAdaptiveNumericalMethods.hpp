@@ -0,0 +1,213 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTADAPTIVENUMERICALMETHODS_HPP_
+#define TESTADAPTIVENUMERICALMETHODS_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <cmath>
+#include <vector>
+#include "AbstractCellBasedTestSuite.hpp"
+#include "CellsGenerator.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+#include "ForwardEulerNumericalMethod.hpp"
+#include "HoneycombVertexMeshGenerator.hpp"
+#include "NoCellCycleModel.hpp"
+#include "SmartPointers.hpp"
+#include "VertexBasedCellPopulation.hpp"
+#include "FakePetscSetup.hpp"
+#include "EmbeddedRungeKuttaNumericalMethod.hpp"
+#include "FasterFarhadifarForce.hpp"
+#include "SemiImplicitVertexNumericalMethod.hpp"
+
+class TestAdaptiveNumericalMethods : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * Relax a small honeycomb tissue whose cells have different target areas,
+     * without remeshing, and return the final node locations.
+     *
+     * @param rMethod the numerical method
+     * @param dt the time step
+     * @param endTime the time to integrate to
+     * @return the x and y coordinates of each node in turn
+     */
+    static std::vector<double> Relax(AbstractNumericalMethod<2,2>& rMethod, double dt, double endTime)
+    {
+        HoneycombVertexMeshGenerator generator(3, 3);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        // No remeshing happens here, so let the vertices move further per time step
+        p_mesh->SetCellRearrangementThreshold(0.5);
+
+        std::vector<CellPtr> cells;
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements(), std::vector<unsigned>(), p_diff_type);
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            unsigned elem_index = cell_population.GetLocationIndexUsingCell(*cell_iter);
+            cell_iter->GetCellData()->SetItem("target area", 0.5*sqrt(3.0)*(0.9 + 0.1*(elem_index % 3)));
+        }
+
+        // The same force for every method, since SemiImplicitVertexNumericalMethod needs FasterFarhadifarForce
+        std::vector<boost::shared_ptr<AbstractForce<2,2> > > forces;
+        MAKE_PTR(FasterFarhadifarForce<2>, p_force);
+        forces.push_back(p_force);
+
+        rMethod.SetCellPopulation(&cell_population);
+        rMethod.SetForceCollection(&forces);
+        unsigned num_steps = (unsigned)(endTime/dt + 0.5);
+        for (unsigned step=0; step<num_steps; step++)
+        {
+            rMethod.UpdateAllNodePositions(dt);
+        }
+
+        std::vector<double> locations;
+        for (unsigned node_index=0; node_index<cell_population.GetNumNodes(); node_index++)
+        {
+            const c_vector<double, 2>& r_location = cell_population.GetNode(node_index)->rGetLocation();
+            locations.push_back(r_location[0]);
+            locations.push_back(r_location[1]);
+        }
+        return locations;
+    }
+
+    /**
+     * @param rLocations some node locations
+     * @param rReference the reference locations
+     * @return the largest distance of a node from its reference location
+     */
+    static double GetLargestDistance(const std::vector<double>& rLocations, const std::vector<double>& rReference)
+    {
+        TS_ASSERT_EQUALS(rLocations.size(), rReference.size());
+        double largest = 0.0;
+        for (unsigned i=0; i+1<rLocations.size(); i+=2)
+        {
+            largest = std::max(largest, std::hypot(rLocations[i] - rReference[i], rLocations[i+1] - rReference[i+1]));
+        }
+        return largest;
+    }
+
+public:
+
+    void TestAgreeWithForwardEuler()
+    {
+        const double end_time = 0.1;
+
+        // Forward Euler at a small time step as the reference; halving it shows its own error
+        ForwardEulerNumericalMethod<2,2> reference_method;
+        std::vector<double> reference = Relax(reference_method, 1e-5, end_time);
+        ForwardEulerNumericalMethod<2,2> coarser_method;
+        double reference_error = GetLargestDistance(Relax(coarser_method, 2e-5, end_time), reference);
+        TS_ASSERT_LESS_THAN(reference_error, 1e-6);
+
+        // The tissue does move, so agreement is not trivial
+        HoneycombVertexMeshGenerator generator(3, 3);
+        std::vector<double> initial;
+        for (unsigned node_index=0; node_index<generator.GetMesh()->GetNumNodes(); node_index++)
+        {
+            initial.push_back(generator.GetMesh()->GetNode(node_index)->rGetLocation()[0]);
+            initial.push_back(generator.GetMesh()->GetNode(node_index)->rGetLocation()[1]);
+        }
+        TS_ASSERT_LESS_THAN(1e-3, GetLargestDistance(reference, initial));
+
+        // The adaptive methods take 20 sub-stepped time steps. Each accepted sub-step adds at most
+        // about the tolerance to the error, so the error is bounded by their number times the tolerance
+        const double tolerance = 1e-7;
+        for (unsigned order=3; order<=5; order+=2)
+        {
+            EmbeddedRungeKuttaNumericalMethod<2,2> runge_kutta;
+            runge_kutta.SetOrder(order);
+            runge_kutta.SetTolerance(tolerance);
+            double error = GetLargestDistance(Relax(runge_kutta, 0.005, end_time), reference);
+            TS_ASSERT_LESS_THAN(error, runge_kutta.GetNumAcceptedSteps()*tolerance + 2.0*reference_error);
+            TS_ASSERT_LESS_THAN(19u, runge_kutta.GetNumAcceptedSteps());
+            TS_ASSERT_LESS_THAN_EQUALS(runge_kutta.GetLargestAcceptedStep(), 0.005);
+        }
+
+        SemiImplicitVertexNumericalMethod semi_implicit;
+        semi_implicit.SetTolerance(tolerance);
+        double error = GetLargestDistance(Relax(semi_implicit, 0.005, end_time), reference);
+        TS_ASSERT_LESS_THAN(error, semi_implicit.GetNumAcceptedSteps()*tolerance + 2.0*reference_error);
+        TS_ASSERT_LESS_THAN(19u, semi_implicit.GetNumAcceptedSteps());
+        TS_ASSERT_LESS_THAN_EQUALS(semi_implicit.GetLargestAcceptedStep(), 0.005);
+    }
+
+    void TestSubstepsFollowTolerance()
+    {
+        // One long time step, so the sub-steps are chosen by the tolerance alone
+        ForwardEulerNumericalMethod<2,2> reference_method;
+        std::vector<double> reference = Relax(reference_method, 1e-5, 0.05);
+
+        for (unsigned method=0; method<2; method++)
+        {
+            double errors[2];
+            unsigned num_steps[2];
+            for (unsigned run=0; run<2; run++)
+            {
+                double tolerance = (run == 0) ? 1e-5 : 1e-7;
+                boost::shared_ptr<AbstractAdaptiveNumericalMethod<2,2> > p_method;
+                if (method == 0)
+                {
+                    p_method.reset(new EmbeddedRungeKuttaNumericalMethod<2,2>());
+                }
+                else
+                {
+                    p_method.reset(new SemiImplicitVertexNumericalMethod());
+                }
+                p_method->SetTolerance(tolerance);
+                errors[run] = GetLargestDistance(Relax(*p_method, 0.05, 0.05), reference);
+                num_steps[run] = p_method->GetNumAcceptedSteps();
+
+                TS_ASSERT_LESS_THAN(errors[run], num_steps[run]*tolerance + 1e-6);
+                TS_ASSERT_LESS_THAN_EQUALS(p_method->GetLargestAcceptedStep(), 0.05);
+                TS_ASSERT_LESS_THAN_EQUALS(p_method->GetSmallestAcceptedStep(), p_method->GetLargestAcceptedStep());
+                TS_ASSERT_LESS_THAN_EQUALS(p_method->GetNumAcceptedSteps() + p_method->GetNumRejectedSteps(),
+                                           p_method->GetNumForceEvaluations());
+            }
+
+            // A tighter tolerance takes more, shorter sub-steps and gives a smaller error
+            TS_ASSERT_LESS_THAN(num_steps[0], num_steps[1]);
+            TS_ASSERT_LESS_THAN(errors[1], errors[0]);
+        }
+    }
+};
+
+#endif /*TESTADAPTIVENUMERICALMETHODS_HPP_*/
@@ -0,0 +1,109 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTBUFFEREDTEXTEMITTER_HPP_
+#define TESTBUFFEREDTEXTEMITTER_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <cmath>
+#include <sstream>
+#include <vector>
+#include "FakePetscSetup.hpp"
+#include "BufferedTextEmitter.hpp"
+
+class TestBufferedTextEmitter : public CxxTest::TestSuite
+{
+public:
+
+    void TestOutputMatchesStreamOutput()
+    {
+        // Values of the kind written by the project writers, including some awkward ones
+        std::vector<double> values = {0.0, -0.0, 1.0, -1.0, 0.1, 1.0/3.0, 2.0/3.0, 1e-12, 123456.0, 1234567.0,
+                                      1e300, -2.5e-300, 0.005, 700.0, 699.995, M_PI, -M_E, 0.04, 0.12, -0.85};
+
+        std::ostringstream stream;
+        BufferedTextEmitter emitter(1); // deliberately tiny, to check that the buffer grows
+        for (unsigned i=0; i<values.size(); i++)
+        {
+            stream << values[i] << " " << i << "\t" << (i % 2 == 0) << " " << (int)i - 5 << " " << values.size() << "\n";
+            emitter << values[i] << " " << i << '\t' << (i % 2 == 0) << " " << (int)i - 5 << " " << values.size() << "\n";
+        }
+
+        TS_ASSERT_EQUALS(emitter.GetString(), stream.str());
+        TS_ASSERT_EQUALS(emitter.GetSize(), stream.str().size());
+    }
+
+    void TestPrecisionAndRoundTrip()
+    {
+        double value = 1.0/3.0;
+
+        BufferedTextEmitter emitter;
+        emitter.SetPrecision(3);
+        TS_ASSERT_EQUALS(emitter.GetPrecision(), 3);
+        emitter << value;
+        TS_ASSERT_EQUALS(emitter.GetString(), "0.333");
+
+        emitter.Clear();
+        TS_ASSERT(emitter.IsEmpty());
+        emitter.SetUseShortestRoundTrip(true);
+        TS_ASSERT(emitter.GetUseShortestRoundTrip());
+        emitter << value << " " << 0.1;
+        TS_ASSERT_EQUALS(emitter.GetString(), "0.3333333333333333 0.1");
+
+        std::istringstream read_back(emitter.GetString());
+        double read_value;
+        read_back >> read_value;
+        TS_ASSERT_EQUALS(read_value, value);
+
+        TS_ASSERT_THROWS_THIS(emitter.SetPrecision(0), "The precision must be between 1 and 17 significant digits");
+    }
+
+    void TestFlushTo()
+    {
+        BufferedTextEmitter emitter;
+        emitter << "Time Area_Correlation" << '\n' << 1.5;
+
+        std::ostringstream stream;
+        emitter.FlushTo(stream);
+        TS_ASSERT_EQUALS(stream.str(), "Time Area_Correlation\n1.5");
+        TS_ASSERT(emitter.IsEmpty());
+
+        // Flushing an empty emitter writes nothing
+        emitter.FlushTo(stream);
+        TS_ASSERT_EQUALS(stream.str(), "Time Area_Correlation\n1.5");
+    }
+};
+
+#endif /*TESTBUFFEREDTEXTEMITTER_HPP_*/
@@ -0,0 +1,226 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTCELLDATATABLE_HPP_
+#define TESTCELLDATATABLE_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <cmath>
+#include <map>
+#include "AbstractCellBasedTestSuite.hpp"
+#include "CellsGenerator.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+#include "HoneycombVertexMeshGenerator.hpp"
+#include "NoCellCycleModel.hpp"
+#include "SmartPointers.hpp"
+#include "VertexBasedCellPopulation.hpp"
+#include "WildTypeCellMutationState.hpp"
+#include "FakePetscSetup.hpp"
+#include "CellDataTable.hpp"
+
+class TestCellDataTable : public AbstractCellBasedTestSuite
+{
+public:
+
+    void TestHandles()
+    {
+        CellDataTable table;
+        TS_ASSERT_EQUALS(table.GetNumItems(), 0u);
+        unsigned target_area_handle = table.RegisterItem("target area");
+        unsigned area_force_handle = table.RegisterItem("area force");
+        TS_ASSERT_EQUALS(target_area_handle, 0u);
+        TS_ASSERT_EQUALS(area_force_handle, 1u);
+        TS_ASSERT_EQUALS(table.RegisterItem("target area"), target_area_handle);
+        TS_ASSERT_EQUALS(table.GetNumItems(), 2u);
+        TS_ASSERT_EQUALS(table.GetHandle("area force"), area_force_handle);
+        TS_ASSERT_EQUALS(table.rGetItemName(target_area_handle), "target area");
+        TS_ASSERT(table.rGetValues(area_force_handle).empty());
+
+        TS_ASSERT_THROWS_CONTAINS(table.GetHandle("volume"), "has not been registered");
+        TS_ASSERT_THROWS_CONTAINS(table.rGetValues(2u), "no cell data item with handle 2");
+    }
+
+    void TestReadAndWrite()
+    {
+        HoneycombVertexMeshGenerator generator(3, 2);
+        boost::shared_ptr<MutableVertexMesh<2,2> > p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements(), std::vector<unsigned>(), p_diff_type);
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+
+        CellDataTable table;
+        unsigned target_area_handle = table.RegisterItem("target area");
+        unsigned area_force_handle = table.RegisterItem("area force");
+
+        // No cell has a target area yet
+        TS_ASSERT_THROWS_ANYTHING(table.ReadItem(cell_population, target_area_handle));
+
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            unsigned location_index = cell_population.GetLocationIndexUsingCell(*cell_iter);
+            cell_iter->GetCellData()->SetItem("target area", 1.0 + location_index);
+        }
+        table.ReadItem(cell_population, target_area_handle);
+        const std::vector<double>& r_target_areas = table.rGetValues(target_area_handle);
+        TS_ASSERT_EQUALS(r_target_areas.size(), 6u);
+        for (unsigned location_index=0; location_index<6; location_index++)
+        {
+            TS_ASSERT_DELTA(r_target_areas[location_index], 1.0 + location_index, 1e-12);
+        }
+
+        // Values must be set for every cell before writing
+        TS_ASSERT_THROWS_CONTAINS(table.WriteItem(cell_population, area_force_handle), "No value of the cell data item \"area force\"");
+        table.rGetValues(area_force_handle).assign(6, 0.0);
+        table.rGetValues(area_force_handle)[4] = 2.5;
+        table.WriteItem(cell_population, area_force_handle);
+        TS_ASSERT_DELTA(cell_population.GetCellUsingLocationIndex(4)->GetCellData()->GetItem("area force"), 2.5, 1e-12);
+        TS_ASSERT_DELTA(cell_population.GetCellUsingLocationIndex(3)->GetCellData()->GetItem("area force"), 0.0, 1e-12);
+    }
+
+    void TestUpdateLayout()
+    {
+        HoneycombVertexMeshGenerator generator(3, 2);
+        boost::shared_ptr<MutableVertexMesh<2,2> > p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements(), std::vector<unsigned>(), p_diff_type);
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+
+        // The values the table should hold, by cell
+        std::map<Cell*, double> expected;
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            double target_area = 1.0 + cell_population.GetLocationIndexUsingCell(*cell_iter);
+            cell_iter->GetCellData()->SetItem("target area", target_area);
+            expected[(*cell_iter).get()] = target_area;
+        }
+
+        CellDataTable table;
+        unsigned target_area_handle = table.RegisterItem("target area");
+        TS_ASSERT(table.UpdateLayout(cell_population));
+        TS_ASSERT(!table.UpdateLayout(cell_population));
+        TS_ASSERT_EQUALS(table.rGetCells().size(), 6u);
+        TS_ASSERT_EQUALS(table.rGetLocationIndices().size(), 6u);
+        for (unsigned index=0; index<6; index++)
+        {
+            TS_ASSERT_EQUALS(table.rGetLocationIndices()[index], cell_population.GetLocationIndexUsingCell(table.rGetCells()[index]));
+        }
+
+        // The table is now the record: the cells' CellData is not read again
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            cell_iter->GetCellData()->SetItem("target area", NAN);
+        }
+        TS_ASSERT(!table.UpdateLayout(cell_population));
+        table.rGetValues(target_area_handle)[2] = 10.0;
+        expected[cell_population.GetCellUsingLocationIndex(2).get()] = 10.0;
+
+        // A new cell takes its value from its CellData; the others keep theirs
+        MAKE_PTR(WildTypeCellMutationState, p_state);
+        CellPtr p_parent = cell_population.GetCellUsingLocationIndex(4);
+        CellPtr p_new_cell(new Cell(p_state, new NoCellCycleModel()));
+        p_new_cell->SetCellProliferativeType(p_diff_type);
+        cell_population.AddCell(p_new_cell, p_parent);
+        TS_ASSERT_THROWS_ANYTHING(table.UpdateLayout(cell_population));
+        p_new_cell->GetCellData()->SetItem("target area", 7.0);
+        expected[p_new_cell.get()] = 7.0;
+        TS_ASSERT(table.UpdateLayout(cell_population));
+        TS_ASSERT_EQUALS(table.rGetCells().size(), 7u);
+
+        // Removing a cell renumbers the elements, and the values move with their cells
+        CellPtr p_dead_cell = cell_population.GetCellUsingLocationIndex(0);
+        p_dead_cell->Kill();
+        expected.erase(p_dead_cell.get());
+        p_dead_cell.reset();
+        TS_ASSERT(table.UpdateLayout(cell_population));
+        TS_ASSERT_EQUALS(table.rGetCells().size(), 6u);
+        cell_population.RemoveDeadCells();
+        cell_population.Update();
+        TS_ASSERT(table.UpdateLayout(cell_population));
+        TS_ASSERT(!table.UpdateLayout(cell_population));
+
+        const std::vector<double>& r_target_areas = table.rGetValues(target_area_handle);
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            unsigned location_index = cell_population.GetLocationIndexUsingCell(*cell_iter);
+            TS_ASSERT_DELTA(r_target_areas[location_index], expected[(*cell_iter).get()], 1e-12);
+        }
+
+        // Copy the values back without looking the cells' locations up
+        table.WriteItemToCell(target_area_handle, 0);
+        CellPtr p_first_cell = table.rGetCells()[0];
+        TS_ASSERT_DELTA(p_first_cell->GetCellData()->GetItem("target area"), expected[p_first_cell.get()], 1e-12);
+        TS_ASSERT(std::isnan(table.rGetCells()[1]->GetCellData()->GetItem("target area")));
+        table.WriteItemToCells(target_area_handle);
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            TS_ASSERT_DELTA(cell_iter->GetCellData()->GetItem("target area"), expected[(*cell_iter).get()], 1e-12);
+        }
+        TS_ASSERT_THROWS_CONTAINS(table.WriteItemToCell(target_area_handle, 6u), "There is no cell with index 6");
+
+        // Read values kept in the cells' CellData without looking the cells up
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            cell_iter->GetCellData()->SetItem("target area", 2.0*expected[(*cell_iter).get()]);
+        }
+        table.ReadItemFromCells(target_area_handle);
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            unsigned location_index = cell_population.GetLocationIndexUsingCell(*cell_iter);
+            TS_ASSERT_DELTA(r_target_areas[location_index], 2.0*expected[(*cell_iter).get()], 1e-12);
+        }
+    }
+};
+
+#endif /*TESTCELLDATATABLE_HPP_*/
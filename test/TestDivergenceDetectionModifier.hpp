@@ -0,0 +1,369 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTDIVERGENCEDETECTIONMODIFIER_HPP_
+#define TESTDIVERGENCEDETECTIONMODIFIER_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <climits>
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "AbstractCellBasedTestSuite.hpp"
+#include "CellsGenerator.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+#include "FarhadifarForce.hpp"
+#include "HoneycombVertexMeshGenerator.hpp"
+#include "NoCellCycleModel.hpp"
+#include "OutputFileHandler.hpp"
+#include "SimpleTargetAreaModifier.hpp"
+#include "SimulationTime.hpp"
+#include "SmartPointers.hpp"
+#include "VertexBasedCellPopulation.hpp"
+#include "FakePetscSetup.hpp"
+#include "BudgetedOffLatticeSimulation.hpp"
+#include "DivergenceDetectionModifier.hpp"
+#include "EmbeddedRungeKuttaNumericalMethod.hpp"
+
+class TestDivergenceDetectionModifier : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * Make differentiated cells that do not divide.
+     *
+     * @param numCells the number of cells
+     * @return the cells
+     */
+    static std::vector<CellPtr> MakeCells(unsigned numCells)
+    {
+        std::vector<CellPtr> cells;
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_differentiated_type);
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, numCells, std::vector<unsigned>(), p_differentiated_type);
+        return cells;
+    }
+
+    /**
+     * Clear the applied force on every node, as the numerical method does
+     * before the forces are added, so that the modifier can read the forces.
+     *
+     * @param rMesh the mesh
+     */
+    static void ClearAppliedForces(MutableVertexMesh<2,2>& rMesh)
+    {
+        for (AbstractMesh<2,2>::NodeIterator node_iter = rMesh.GetNodeIteratorBegin();
+             node_iter != rMesh.GetNodeIteratorEnd();
+             ++node_iter)
+        {
+            node_iter->ClearAppliedForce();
+        }
+    }
+
+public:
+
+    void TestNonFiniteLocation()
+    {
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 100);
+
+        HoneycombVertexMeshGenerator generator(3, 3);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, MakeCells(p_mesh->GetNumElements()));
+        ClearAppliedForces(*p_mesh);
+
+        DivergenceDetectionModifier<2> modifier;
+        modifier.SetupSolve(cell_population, "TestDivergenceDetectionModifier");
+        SimulationTime::Instance()->IncrementTimeOneStep();
+        modifier.UpdateAtEndOfTimeStep(cell_population);
+        TS_ASSERT(!modifier.HasFailed());
+
+        p_mesh->GetNode(4)->rGetModifiableLocation()[1] = NAN;
+        SimulationTime::Instance()->IncrementTimeOneStep();
+        modifier.UpdateAtEndOfTimeStep(cell_population);
+        TS_ASSERT(modifier.HasFailed());
+
+        const SimulationFailureRecord& r_record = modifier.rGetFailureRecord();
+        TS_ASSERT_EQUALS(r_record.mReason, "NonFiniteLocation");
+        TS_ASSERT_DELTA(r_record.mTime, 0.02, 1e-12);
+        TS_ASSERT_EQUALS(r_record.mTimeStep, 2u);
+        TS_ASSERT(std::isnan(r_record.mValue));
+        TS_ASSERT_EQUALS(r_record.mIndex, 4u);
+        TS_ASSERT_EQUALS(r_record.mNumCells, 9u);
+
+        // Only the first failure is recorded
+        p_mesh->GetNode(4)->rGetModifiableLocation()[1] = 0.0;
+        p_mesh->GetNode(5)->AddAppliedForceContribution(Create_c_vector(2000.0, 0.0));
+        SimulationTime::Instance()->IncrementTimeOneStep();
+        modifier.UpdateAtEndOfTimeStep(cell_population);
+        TS_ASSERT_EQUALS(modifier.rGetFailureRecord().mReason, "NonFiniteLocation");
+        TS_ASSERT_EQUALS(modifier.rGetFailureRecord().mTimeStep, 2u);
+
+        // SetupSolve() forgets it
+        modifier.SetupSolve(cell_population, "TestDivergenceDetectionModifier");
+        TS_ASSERT(!modifier.HasFailed());
+    }
+
+    void TestVertexSpeed()
+    {
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 100);
+
+        HoneycombVertexMeshGenerator generator(3, 3);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, MakeCells(p_mesh->GetNumElements()));
+        ClearAppliedForces(*p_mesh);
+
+        // With the default damping constant of 1, the speed is the size of the force
+        p_mesh->GetNode(2)->AddAppliedForceContribution(Create_c_vector(0.0, -1500.0));
+
+        DivergenceDetectionModifier<2> modifier;
+        modifier.SetMaxVertexSpeed(2000.0);
+        modifier.SetupSolve(cell_population, "TestDivergenceDetectionModifier");
+        SimulationTime::Instance()->IncrementTimeOneStep();
+        modifier.UpdateAtEndOfTimeStep(cell_population);
+        TS_ASSERT(!modifier.HasFailed());
+
+        modifier.SetMaxVertexSpeed(1000.0);
+        SimulationTime::Instance()->IncrementTimeOneStep();
+        modifier.UpdateAtEndOfTimeStep(cell_population);
+        TS_ASSERT(modifier.HasFailed());
+
+        const SimulationFailureRecord& r_record = modifier.rGetFailureRecord();
+        TS_ASSERT_EQUALS(r_record.mReason, "VertexSpeed");
+        TS_ASSERT_EQUALS(r_record.mTimeStep, 2u);
+        TS_ASSERT_DELTA(r_record.mValue, 1500.0, 1e-9);
+        TS_ASSERT_DELTA(r_record.mLimit, 1000.0, 1e-12);
+        TS_ASSERT_EQUALS(r_record.mIndex, 2u);
+    }
+
+    void TestCollapsedElement()
+    {
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 100);
+
+        HoneycombVertexMeshGenerator generator(3, 3);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, MakeCells(p_mesh->GetNumElements()));
+        ClearAppliedForces(*p_mesh);
+
+        DivergenceDetectionModifier<2> modifier;
+        modifier.SetupSolve(cell_population, "TestDivergenceDetectionModifier");
+        SimulationTime::Instance()->IncrementTimeOneStep();
+        modifier.UpdateAtEndOfTimeStep(cell_population);
+        TS_ASSERT(!modifier.HasFailed());
+
+        // Turn the first element inside out by reflecting its vertices in the x axis
+        double area = p_mesh->GetVolumeOfElement(0);
+        VertexElement<2,2>* p_element = p_mesh->GetElement(0);
+        for (unsigned local_index=0; local_index<p_element->GetNumNodes(); local_index++)
+        {
+            c_vector<double, 2>& r_location = p_element->GetNode(local_index)->rGetModifiableLocation();
+            r_location[1] = -r_location[1];
+        }
+        SimulationTime::Instance()->IncrementTimeOneStep();
+        modifier.UpdateAtEndOfTimeStep(cell_population);
+        TS_ASSERT(modifier.HasFailed());
+
+        const SimulationFailureRecord& r_record = modifier.rGetFailureRecord();
+        TS_ASSERT_EQUALS(r_record.mReason, "CollapsedElement");
+        TS_ASSERT_DELTA(r_record.mValue, -area, 1e-9);
+        TS_ASSERT_DELTA(r_record.mLimit, 0.0, 1e-12);
+        TS_ASSERT_EQUALS(r_record.mIndex, 0u);
+    }
+
+    void TestSubstepFloor()
+    {
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 100);
+
+        HoneycombVertexMeshGenerator generator(3, 3);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, MakeCells(p_mesh->GetNumElements()));
+        ClearAppliedForces(*p_mesh);
+
+        // A method that has taken no sub-steps yet proposes the whole time step
+        boost::shared_ptr<EmbeddedRungeKuttaNumericalMethod<2> > p_method(new EmbeddedRungeKuttaNumericalMethod<2>());
+        TS_ASSERT_DELTA(p_method->GetNextSubstep(0.01), 0.01, 1e-12);
+
+        DivergenceDetectionModifier<2> modifier;
+        modifier.SetAdaptiveMethod(p_method);
+        modifier.SetupSolve(cell_population, "TestDivergenceDetectionModifier");
+        SimulationTime::Instance()->IncrementTimeOneStep();
+        modifier.UpdateAtEndOfTimeStep(cell_population);
+        TS_ASSERT(!modifier.HasFailed());
+
+        // Raising the floor above it has the same effect as the sub-steps collapsing below the floor
+        modifier.SetMinSubstep(0.1);
+        SimulationTime::Instance()->IncrementTimeOneStep();
+        modifier.UpdateAtEndOfTimeStep(cell_population);
+        TS_ASSERT(modifier.HasFailed());
+
+        const SimulationFailureRecord& r_record = modifier.rGetFailureRecord();
+        TS_ASSERT_EQUALS(r_record.mReason, "SubstepFloor");
+        TS_ASSERT_DELTA(r_record.mValue, 0.01, 1e-12);
+        TS_ASSERT_DELTA(r_record.mLimit, 0.1, 1e-12);
+        TS_ASSERT_EQUALS(r_record.mIndex, UINT_MAX);
+    }
+
+    void TestT2SwapRate()
+    {
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(10.0, 1000);
+
+        // Eight small triangles on top of a long element, each sharing its base with
+        // the long element only, so that each can be removed by a T2 swap
+        const unsigned num_triangles = 8;
+        std::vector<Node<2>*> nodes;
+        nodes.push_back(new Node<2>(0, true, 0.0, 0.0));
+        nodes.push_back(new Node<2>(1, true, num_triangles, 0.0));
+        std::vector<Node<2>*> base_nodes;
+        for (unsigned i=0; i<num_triangles; i++)
+        {
+            unsigned index = nodes.size();
+            nodes.push_back(new Node<2>(index, true, i + 0.25, 1.0));
+            nodes.push_back(new Node<2>(index + 1, true, i + 0.75, 1.0));
+            nodes.push_back(new Node<2>(index + 2, true, i + 0.5, 1.4));
+        }
+
+        std::vector<VertexElement<2,2>*> elements;
+        std::vector<Node<2>*> long_element_nodes;
+        long_element_nodes.push_back(nodes[0]);
+        long_element_nodes.push_back(nodes[1]);
+        for (unsigned i=num_triangles; i-- > 0; )
+        {
+            long_element_nodes.push_back(nodes[2 + 3*i + 1]);
+            long_element_nodes.push_back(nodes[2 + 3*i]);
+        }
+        elements.push_back(new VertexElement<2,2>(0, long_element_nodes));
+        for (unsigned i=0; i<num_triangles; i++)
+        {
+            std::vector<Node<2>*> triangle_nodes;
+            triangle_nodes.push_back(nodes[2 + 3*i]);
+            triangle_nodes.push_back(nodes[2 + 3*i + 1]);
+            triangle_nodes.push_back(nodes[2 + 3*i + 2]);
+            elements.push_back(new VertexElement<2,2>(i + 1, triangle_nodes));
+        }
+        MutableVertexMesh<2,2> mesh(nodes, elements);
+        VertexBasedCellPopulation<2> cell_population(mesh, MakeCells(mesh.GetNumElements()));
+        ClearAppliedForces(mesh);
+
+        DivergenceDetectionModifier<2> modifier;
+        modifier.SetupSolve(cell_population, "TestDivergenceDetectionModifier");
+
+        // Three swaps, too few to count
+        SimulationTime::Instance()->IncrementTimeOneStep();
+        for (unsigned i=1; i<=3; i++)
+        {
+            mesh.PerformT2Swap(*mesh.GetElement(i));
+        }
+        ClearAppliedForces(mesh);
+        modifier.UpdateAtEndOfTimeStep(cell_population);
+        TS_ASSERT(!modifier.HasFailed());
+
+        // Three more, once the first three have left the window
+        for (unsigned i=0; i<150; i++)
+        {
+            SimulationTime::Instance()->IncrementTimeOneStep();
+        }
+        for (unsigned i=4; i<=6; i++)
+        {
+            mesh.PerformT2Swap(*mesh.GetElement(i));
+        }
+        ClearAppliedForces(mesh);
+        modifier.UpdateAtEndOfTimeStep(cell_population);
+        TS_ASSERT(!modifier.HasFailed());
+
+        // Two more make five within the window; the cells of the removed triangles no longer
+        // count, so this is more than a tenth of the one cell left
+        SimulationTime::Instance()->IncrementTimeOneStep();
+        for (unsigned i=7; i<=8; i++)
+        {
+            mesh.PerformT2Swap(*mesh.GetElement(i));
+        }
+        ClearAppliedForces(mesh);
+        modifier.UpdateAtEndOfTimeStep(cell_population);
+        TS_ASSERT(modifier.HasFailed());
+
+        const SimulationFailureRecord& r_record = modifier.rGetFailureRecord();
+        TS_ASSERT_EQUALS(r_record.mReason, "T2SwapRate");
+        TS_ASSERT_EQUALS(r_record.mTimeStep, 152u);
+        TS_ASSERT_DELTA(r_record.mValue, 5.0, 1e-12);
+        TS_ASSERT_DELTA(r_record.mLimit, 0.1, 1e-12);
+        TS_ASSERT_EQUALS(r_record.mIndex, UINT_MAX);
+        TS_ASSERT_EQUALS(r_record.mNumCells, 1u);
+    }
+
+    void TestStopsSimulation()
+    {
+        HoneycombVertexMeshGenerator generator(2, 2);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, MakeCells(p_mesh->GetNumElements()));
+
+        BudgetedOffLatticeSimulation<2> simulator(cell_population);
+        simulator.SetOutputDirectory("TestDivergenceDetectionModifier/Stop");
+        simulator.SetDt(0.01);
+        simulator.SetSamplingTimestepMultiple(1);
+        simulator.SetEndTime(1.0);
+
+        MAKE_PTR(FarhadifarForce<2>, p_force);
+        simulator.AddForce(p_force);
+        MAKE_PTR(SimpleTargetAreaModifier<2>, p_growth_modifier);
+        simulator.AddSimulationModifier(p_growth_modifier);
+
+        // The vertices of the honeycomb move, so any vertex fails so low a limit
+        MAKE_PTR(DivergenceDetectionModifier<2>, p_divergence_modifier);
+        p_divergence_modifier->SetMaxVertexSpeed(1e-9);
+        simulator.AddSimulationModifier(p_divergence_modifier);
+
+        // Solve() returns rather than throws, after the first time step
+        TS_ASSERT_THROWS_NOTHING(simulator.Solve());
+        TS_ASSERT(simulator.HasDiverged());
+        TS_ASSERT(!simulator.WasTruncated());
+        TS_ASSERT_EQUALS(SimulationTime::Instance()->GetTimeStepsElapsed(), 1u);
+        TS_ASSERT_EQUALS(p_divergence_modifier->rGetFailureRecord().mReason, "VertexSpeed");
+        TS_ASSERT_EQUALS(p_divergence_modifier->rGetFailureRecord().mTimeStep, 1u);
+
+        // The writers have closed their files, with the initial state and the first time step
+        OutputFileHandler handler("TestDivergenceDetectionModifier/Stop", false);
+        std::ifstream file((handler.GetOutputDirectoryFullPath() + "results_from_time_0/results.viznodes").c_str());
+        TS_ASSERT(file.is_open());
+        unsigned num_lines = 0;
+        std::string line;
+        while (std::getline(file, line))
+        {
+            num_lines++;
+        }
+        TS_ASSERT_EQUALS(num_lines, 2u);
+    }
+};
+
+#endif /*TESTDIVERGENCEDETECTIONMODIFIER_HPP_*/
@@ -0,0 +1,154 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTELEMENTGEOMETRYCACHE_HPP_
+#define TESTELEMENTGEOMETRYCACHE_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <cmath>
+#include "AbstractCellBasedTestSuite.hpp"
+#include "HoneycombVertexMeshGenerator.hpp"
+#include "SimulationTime.hpp"
+#include "FakePetscSetup.hpp"
+#include "ElementGeometryCache.hpp"
+
+class TestElementGeometryCache : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * Move the vertices of a mesh by a fixed pseudo-random jitter.
+     *
+     * @param rMesh the mesh
+     * @param scale the largest displacement in each direction
+     */
+    static void Jitter(MutableVertexMesh<2,2>& rMesh, double scale)
+    {
+        for (unsigned node_index=0; node_index<rMesh.GetNumNodes(); node_index++)
+        {
+            c_vector<double, 2>& r_location = rMesh.GetNode(node_index)->rGetModifiableLocation();
+            r_location[0] += scale*sin(3.0*node_index + 1.0);
+            r_location[1] += scale*cos(5.0*node_index + 2.0);
+        }
+    }
+
+    /**
+     * Check the geometry of each element against the mesh's own calculation.
+     *
+     * @param rGeometry the geometry
+     * @param rMesh the mesh
+     */
+    static void CheckAgainstMesh(const ElementGeometryKernel& rGeometry, MutableVertexMesh<2,2>& rMesh)
+    {
+        TS_ASSERT_EQUALS(rGeometry.rGetAreas().size(), rMesh.GetNumAllElements());
+        for (unsigned elem_index=0; elem_index<rMesh.GetNumElements(); elem_index++)
+        {
+            TS_ASSERT_DELTA(rGeometry.rGetAreas()[elem_index], rMesh.GetVolumeOfElement(elem_index), 1e-12);
+            TS_ASSERT_DELTA(rGeometry.rGetPerimeters()[elem_index], rMesh.GetSurfaceAreaOfElement(elem_index), 1e-12);
+            c_vector<double, 2> centroid = rMesh.GetCentroidOfElement(elem_index);
+            TS_ASSERT_DELTA(rGeometry.rGetCentroids()[2*elem_index], centroid[0], 1e-12);
+            TS_ASSERT_DELTA(rGeometry.rGetCentroids()[2*elem_index + 1], centroid[1], 1e-12);
+            TS_ASSERT_DELTA(rGeometry.rGetElongationShapeFactors()[elem_index],
+                            rMesh.GetElongationShapeFactorOfElement(elem_index), 1e-10);
+        }
+    }
+
+public:
+
+    void TestAgreesWithVertexMesh()
+    {
+        HoneycombVertexMeshGenerator generator(6, 5);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+        Jitter(*p_mesh, 0.05);
+
+        ElementGeometryCache cache;
+        CheckAgainstMesh(cache.rGetGeometry(*p_mesh), *p_mesh);
+        TS_ASSERT_EQUALS(cache.GetNumCalculations(), 1u);
+    }
+
+    void TestInvalidation()
+    {
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 10);
+
+        HoneycombVertexMeshGenerator generator(4, 4);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+        ElementGeometryCache cache;
+        CheckAgainstMesh(cache.rGetGeometry(*p_mesh), *p_mesh);
+        TS_ASSERT_EQUALS(cache.GetNumCalculations(), 1u);
+
+        // Within a time step the geometry is calculated once
+        cache.rGetGeometry(*p_mesh);
+        TS_ASSERT_EQUALS(cache.GetNumCalculations(), 1u);
+
+        // Moving the vertices without advancing the time needs MarkMeshChanged()
+        Jitter(*p_mesh, 0.02);
+        cache.rGetGeometry(*p_mesh);
+        TS_ASSERT_EQUALS(cache.GetNumCalculations(), 1u);
+        cache.MarkMeshChanged();
+        CheckAgainstMesh(cache.rGetGeometry(*p_mesh), *p_mesh);
+        TS_ASSERT_EQUALS(cache.GetNumCalculations(), 2u);
+
+        // A new time step
+        SimulationTime::Instance()->IncrementTimeOneStep();
+        Jitter(*p_mesh, 0.02);
+        CheckAgainstMesh(cache.rGetGeometry(*p_mesh), *p_mesh);
+        TS_ASSERT_EQUALS(cache.GetNumCalculations(), 3u);
+
+        // A division changes the numbers of nodes and elements
+        p_mesh->DivideElementAlongShortAxis(p_mesh->GetElement(5));
+        CheckAgainstMesh(cache.rGetGeometry(*p_mesh), *p_mesh);
+        TS_ASSERT_EQUALS(cache.GetNumCalculations(), 4u);
+
+        // Another mesh
+        HoneycombVertexMeshGenerator other_generator(3, 3);
+        MutableVertexMesh<2,2>* p_other_mesh = other_generator.GetMesh();
+        CheckAgainstMesh(cache.rGetGeometry(*p_other_mesh), *p_other_mesh);
+        TS_ASSERT_EQUALS(cache.GetNumCalculations(), 5u);
+    }
+
+    void TestWithoutSimulationTime()
+    {
+        // With no end time set there are no time steps to go by, so every call calculates
+        HoneycombVertexMeshGenerator generator(3, 3);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+        ElementGeometryCache cache;
+        cache.rGetGeometry(*p_mesh);
+        Jitter(*p_mesh, 0.02);
+        CheckAgainstMesh(cache.rGetGeometry(*p_mesh), *p_mesh);
+        TS_ASSERT_EQUALS(cache.GetNumCalculations(), 2u);
+    }
+};
+
+#endif /*TESTELEMENTGEOMETRYCACHE_HPP_*/
@@ -0,0 +1,138 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTELEMENTGEOMETRYKERNEL_HPP_
+#define TESTELEMENTGEOMETRYKERNEL_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <cmath>
+#include "FakePetscSetup.hpp"
+#include "Exception.hpp"
+#include "ElementGeometryKernel.hpp"
+#include "FarhadifarForceKernel.hpp"
+#include "JitteredSquareTissue.hpp"
+
+class TestElementGeometryKernel : public CxxTest::TestSuite
+{
+public:
+
+    void TestRectangles()
+    {
+        // A 3 by 1 rectangle with its corner at (2,5), the same clockwise, and a deleted element
+        std::vector<double> locations = {2.0, 5.0, 5.0, 5.0, 5.0, 6.0, 2.0, 6.0};
+        std::vector<unsigned> offsets = {0, 4, 8, 8};
+        std::vector<unsigned> nodes = {0, 1, 2, 3, 3, 2, 1, 0};
+
+        ElementGeometryKernel kernel;
+        TS_ASSERT_EQUALS(kernel.GetNumCalculations(), 0u);
+        kernel.Calculate(offsets, nodes, locations);
+        TS_ASSERT_EQUALS(kernel.GetNumCalculations(), 1u);
+        TS_ASSERT_EQUALS(kernel.rGetAreas().size(), 3u);
+
+        for (unsigned element=0; element<2; element++)
+        {
+            TS_ASSERT_DELTA(kernel.rGetAreas()[element], 3.0, 1e-12);
+            TS_ASSERT_DELTA(kernel.rGetPerimeters()[element], 8.0, 1e-12);
+            TS_ASSERT_DELTA(kernel.rGetCentroids()[2*element], 3.5, 1e-12);
+            TS_ASSERT_DELTA(kernel.rGetCentroids()[2*element + 1], 5.5, 1e-12);
+
+            // Ixx = ab^3/12 and Iyy = ba^3/12
+            TS_ASSERT_DELTA(kernel.rGetMoments()[3*element], 0.25, 1e-12);
+            TS_ASSERT_DELTA(kernel.rGetMoments()[3*element + 1], 2.25, 1e-12);
+            TS_ASSERT_DELTA(kernel.rGetMoments()[3*element + 2], 0.0, 1e-12);
+            TS_ASSERT_DELTA(kernel.rGetElongationShapeFactors()[element], 3.0, 1e-12);
+        }
+
+        TS_ASSERT_EQUALS(kernel.rGetAreas()[2], 0.0);
+        TS_ASSERT_EQUALS(kernel.rGetPerimeters()[2], 0.0);
+        TS_ASSERT_EQUALS(kernel.rGetCentroids()[5], 0.0);
+        TS_ASSERT_EQUALS(kernel.rGetElongationShapeFactors()[2], 0.0);
+
+        TS_ASSERT_THROWS_CONTAINS(kernel.Calculate({0, 4}, {0, 1, 2}, locations), "do not match");
+    }
+
+    void TestRotatedElement()
+    {
+        // A 2 by 0.5 rectangle rotated by 30 degrees; its elongation does not depend on the rotation
+        double c = std::cos(M_PI/6.0);
+        double s = std::sin(M_PI/6.0);
+        std::vector<double> locations;
+        double corners[4][2] = {{0.0, 0.0}, {2.0, 0.0}, {2.0, 0.5}, {0.0, 0.5}};
+        for (unsigned k=0; k<4; k++)
+        {
+            locations.push_back(1.0 + c*corners[k][0] - s*corners[k][1]);
+            locations.push_back(-1.0 + s*corners[k][0] + c*corners[k][1]);
+        }
+
+        ElementGeometryKernel kernel;
+        kernel.Calculate({0, 4}, {0, 1, 2, 3}, locations);
+        TS_ASSERT_DELTA(kernel.rGetAreas()[0], 1.0, 1e-12);
+        TS_ASSERT_DELTA(kernel.rGetPerimeters()[0], 5.0, 1e-12);
+        TS_ASSERT_DELTA(kernel.rGetCentroids()[0], 1.0 + c - 0.25*s, 1e-12);
+        TS_ASSERT_DELTA(kernel.rGetCentroids()[1], -1.0 + s + 0.25*c, 1e-12);
+        TS_ASSERT_DELTA(kernel.rGetElongationShapeFactors()[0], 4.0, 1e-10);
+
+        // The moments rotate as a tensor, so their trace does not change
+        TS_ASSERT_DELTA(kernel.rGetMoments()[0] + kernel.rGetMoments()[1], (2.0*0.125 + 0.5*8.0)/12.0, 1e-12);
+    }
+
+    void TestAgreesWithForceKernel()
+    {
+        // A tissue of randomly moved squares
+        unsigned num_x = 12;
+        unsigned num_y = 9;
+        JitteredSquareTissue tissue(num_x, num_y, 5u, 0.3);
+        const std::vector<double>& locations = tissue.mNodeLocations;
+        const std::vector<unsigned>& offsets = tissue.mElementOffsets;
+        const std::vector<unsigned>& nodes = tissue.mElementNodes;
+
+        ElementGeometryKernel kernel;
+        kernel.Calculate(offsets, nodes, locations);
+
+        FarhadifarForceKernel force_kernel;
+        force_kernel.SetTopology(offsets, nodes, locations.size()/2);
+        std::vector<double> forces;
+        force_kernel.CalculateForces(locations, std::vector<double>(num_x*num_y, 1.0), 1.0, 0.04, 0.12, 0.12, forces);
+
+        for (unsigned element=0; element<num_x*num_y; element++)
+        {
+            TS_ASSERT_DELTA(kernel.rGetAreas()[element], force_kernel.rGetElementAreas()[element], 1e-12);
+            TS_ASSERT_DELTA(kernel.rGetPerimeters()[element], force_kernel.rGetElementPerimeters()[element], 1e-12);
+            TS_ASSERT_LESS_THAN_EQUALS(1.0, kernel.rGetElongationShapeFactors()[element]);
+        }
+    }
+};
+
+#endif /*TESTELEMENTGEOMETRYKERNEL_HPP_*/
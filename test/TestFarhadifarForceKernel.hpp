@@ -0,0 +1,472 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTFARHADIFARFORCEKERNEL_HPP_
+#define TESTFARHADIFARFORCEKERNEL_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <climits>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include "FakePetscSetup.hpp"
+#include "Exception.hpp"
+#include "FarhadifarForceKernel.hpp"
+#include "JitteredSquareTissue.hpp"
+#include "MeshRenumbering.hpp"
+#include "Philox4x32.hpp"
+#include "ThreadTeam.hpp"
+
+class TestFarhadifarForceKernel : public CxxTest::TestSuite
+{
+private:
+
+    /**
+     * The Farhadifar energy of a tissue, calculated directly.
+     *
+     * @param rElementOffsets the element offsets
+     * @param rElementNodes the element vertices
+     * @param rNodeLocations the vertex locations
+     * @param rTargetAreas the target areas
+     * @return the energy with K = 1.3, Gamma = 0.04, Lambda = 0.12 and boundary Lambda = 0.07
+     */
+    static double GetEnergy(const std::vector<unsigned>& rElementOffsets,
+                            const std::vector<unsigned>& rElementNodes,
+                            const std::vector<double>& rNodeLocations,
+                            const std::vector<double>& rTargetAreas)
+    {
+        std::map<std::pair<unsigned, unsigned>, unsigned> edge_counts;
+        std::map<std::pair<unsigned, unsigned>, double> edge_lengths;
+        double energy = 0.0;
+        for (unsigned element=0; element+1<rElementOffsets.size(); element++)
+        {
+            unsigned begin = rElementOffsets[element];
+            unsigned n = rElementOffsets[element + 1] - begin;
+            double area = 0.0;
+            double perimeter = 0.0;
+            for (unsigned k=0; k<n; k++)
+            {
+                unsigned a = rElementNodes[begin + k];
+                unsigned b = rElementNodes[begin + (k + 1)%n];
+                double dx = rNodeLocations[2*b] - rNodeLocations[2*a];
+                double dy = rNodeLocations[2*b + 1] - rNodeLocations[2*a + 1];
+                area += 0.5*(rNodeLocations[2*a]*rNodeLocations[2*b + 1] - rNodeLocations[2*b]*rNodeLocations[2*a + 1]);
+                perimeter += std::sqrt(dx*dx + dy*dy);
+                std::pair<unsigned, unsigned> edge(std::min(a, b), std::max(a, b));
+                edge_counts[edge]++;
+                edge_lengths[edge] = std::sqrt(dx*dx + dy*dy);
+            }
+            energy += 0.5*1.3*(area - rTargetAreas[element])*(area - rTargetAreas[element]) + 0.5*0.04*perimeter*perimeter;
+        }
+        for (std::map<std::pair<unsigned, unsigned>, unsigned>::iterator iter = edge_counts.begin();
+             iter != edge_counts.end();
+             ++iter)
+        {
+            energy += (iter->second == 1 ? 0.07 : 0.12)*edge_lengths[iter->first];
+        }
+        return energy;
+    }
+
+public:
+
+    void TestForcesAreMinusTheEnergyGradient()
+    {
+        JitteredSquareTissue tissue(4u, 3u, 11u, 0.3);
+        std::vector<unsigned>& offsets = tissue.mElementOffsets;
+        std::vector<unsigned>& nodes = tissue.mElementNodes;
+        std::vector<double>& locations = tissue.mNodeLocations;
+        std::vector<double> target_areas(12);
+        for (unsigned element=0; element<12; element++)
+        {
+            target_areas[element] = 0.8 + 0.05*element;
+        }
+
+        FarhadifarForceKernel kernel;
+        TS_ASSERT(kernel.SetTopology(offsets, nodes, locations.size()/2));
+        std::vector<double> forces;
+        kernel.CalculateForces(locations, target_areas, 1.3, 0.04, 0.12, 0.07, forces);
+        TS_ASSERT_EQUALS(forces.size(), locations.size());
+
+        double step = 1e-6;
+        for (unsigned i=0; i<locations.size(); i++)
+        {
+            std::vector<double> plus(locations);
+            std::vector<double> minus(locations);
+            plus[i] += step;
+            minus[i] -= step;
+            double gradient = (GetEnergy(offsets, nodes, plus, target_areas) - GetEnergy(offsets, nodes, minus, target_areas))/(2.0*step);
+            TS_ASSERT_DELTA(forces[i], -gradient, 1e-7);
+        }
+
+        // The areas and perimeters are kept
+        TS_ASSERT_EQUALS(kernel.rGetElementAreas().size(), 12u);
+        TS_ASSERT_EQUALS(kernel.rGetElementPerimeters().size(), 12u);
+        double area = 0.0;
+        double perimeter = 0.0;
+        for (unsigned k=0; k<4; k++)
+        {
+            unsigned a = nodes[k];
+            unsigned b = nodes[(k + 1)%4];
+            area += 0.5*(locations[2*a]*locations[2*b + 1] - locations[2*b]*locations[2*a + 1]);
+            perimeter += std::hypot(locations[2*b] - locations[2*a], locations[2*b + 1] - locations[2*a + 1]);
+        }
+        TS_ASSERT_DELTA(kernel.rGetElementAreas()[0], area, 1e-12);
+        TS_ASSERT_DELTA(kernel.rGetElementPerimeters()[0], perimeter, 1e-12);
+    }
+
+    void TestTopologyCaching()
+    {
+        JitteredSquareTissue tissue(2u, 2u, 11u, 0.3);
+        std::vector<unsigned>& offsets = tissue.mElementOffsets;
+        std::vector<unsigned>& nodes = tissue.mElementNodes;
+        std::vector<double>& locations = tissue.mNodeLocations;
+
+        FarhadifarForceKernel kernel;
+        TS_ASSERT_EQUALS(kernel.GetNumTopologyUpdates(), 0u);
+        TS_ASSERT(kernel.SetTopology(offsets, nodes, 9u));
+        TS_ASSERT(!kernel.SetTopology(offsets, nodes, 9u));
+        TS_ASSERT_EQUALS(kernel.GetNumTopologyUpdates(), 1u);
+
+        // Moving vertices does not change the topology, but removing an element does
+        std::vector<unsigned> fewer_offsets(offsets.begin(), offsets.end() - 1);
+        std::vector<unsigned> fewer_nodes(nodes.begin(), nodes.end() - 4);
+        TS_ASSERT(kernel.SetTopology(fewer_offsets, fewer_nodes, 9u));
+        TS_ASSERT_EQUALS(kernel.GetNumTopologyUpdates(), 2u);
+
+        std::vector<double> forces;
+        TS_ASSERT_THROWS_CONTAINS(kernel.CalculateForces(locations, std::vector<double>(4, 1.0), 1.0, 0.0, 0.0, 0.0, forces),
+                                  "target areas of 3 elements");
+        TS_ASSERT_THROWS_CONTAINS(kernel.SetTopology({0, 2}, {0, 1}, 9u), "fewer than three vertices");
+        TS_ASSERT_THROWS_CONTAINS(kernel.SetTopology({0, 3}, {0, 1, 9}, 9u), "out of range");
+        TS_ASSERT_THROWS_CONTAINS(kernel.SetTopology({0, 4}, {0, 1, 2}, 9u), "do not match");
+    }
+    void TestVertexStiffness()
+    {
+        JitteredSquareTissue tissue(3u, 3u, 11u, 0.3);
+        std::vector<unsigned>& offsets = tissue.mElementOffsets;
+        std::vector<unsigned>& nodes = tissue.mElementNodes;
+        std::vector<double>& locations = tissue.mNodeLocations;
+        std::vector<double> target_areas(9, 0.9);
+
+        FarhadifarForceKernel kernel;
+        kernel.SetTopology(offsets, nodes, locations.size()/2);
+        std::vector<double> forces;
+        kernel.CalculateForces(locations, target_areas, 1.3, 0.04, 0.12, 0.07, forces);
+        TS_ASSERT(kernel.rGetVertexStiffness().empty());
+
+        // With positive parameters the stiffness is the diagonal block of the Hessian
+        kernel.SetCalculateStiffness(true);
+        kernel.CalculateForces(locations, target_areas, 1.3, 0.04, 0.12, 0.07, forces);
+        std::vector<double> stiffness = kernel.rGetVertexStiffness();
+        TS_ASSERT_EQUALS(stiffness.size(), 3*locations.size()/2);
+
+        double step = 1e-6;
+        for (unsigned node=0; node<locations.size()/2; node++)
+        {
+            std::vector<double> plus_forces;
+            std::vector<double> minus_forces;
+            for (unsigned dim=0; dim<2; dim++)
+            {
+                std::vector<double> plus(locations);
+                std::vector<double> minus(locations);
+                plus[2*node + dim] += step;
+                minus[2*node + dim] -= step;
+                kernel.CalculateForces(plus, target_areas, 1.3, 0.04, 0.12, 0.07, plus_forces);
+                kernel.CalculateForces(minus, target_areas, 1.3, 0.04, 0.12, 0.07, minus_forces);
+                double d_force_x = (plus_forces[2*node] - minus_forces[2*node])/(2.0*step);
+                double d_force_y = (plus_forces[2*node + 1] - minus_forces[2*node + 1])/(2.0*step);
+                TS_ASSERT_DELTA(stiffness[3*node + dim], -d_force_x, 1e-6);
+                TS_ASSERT_DELTA(stiffness[3*node + dim + 1], -d_force_y, 1e-6);
+            }
+        }
+
+        // Negative line tension is left out, so the stiffness stays positive semi-definite
+        kernel.CalculateForces(locations, target_areas, 1.3, 0.0, -0.5, 0.0, forces);
+        for (unsigned node=0; node<locations.size()/2; node++)
+        {
+            const double* p_block = &kernel.rGetVertexStiffness()[3*node];
+            TS_ASSERT_LESS_THAN_EQUALS(0.0, p_block[0]);
+            TS_ASSERT_LESS_THAN_EQUALS(0.0, p_block[2]);
+            TS_ASSERT_LESS_THAN_EQUALS(p_block[1]*p_block[1], p_block[0]*p_block[2] + 1e-12);
+        }
+    }
+
+    void TestColouringAndThreads()
+    {
+        JitteredSquareTissue tissue(40u, 30u, 11u, 0.3);
+        std::vector<unsigned>& offsets = tissue.mElementOffsets;
+        std::vector<unsigned>& nodes = tissue.mElementNodes;
+        std::vector<double>& locations = tissue.mNodeLocations;
+        std::vector<double> target_areas(1200);
+        for (unsigned element=0; element<1200; element++)
+        {
+            target_areas[element] = 0.9 + 0.0001*element;
+        }
+
+        // No two elements of a colour share a vertex; in the order given, squares need four colours
+        FarhadifarForceKernel kernel;
+        kernel.SetRenumbering(false);
+        kernel.SetTopology(offsets, nodes, locations.size()/2);
+        TS_ASSERT_EQUALS(kernel.GetNumColours(), 4u);
+        std::vector<unsigned> vertex_colours(locations.size()/2, UINT_MAX);
+        for (unsigned element=0; element<1200; element++)
+        {
+            unsigned colour = kernel.rGetElementColours()[element];
+            for (unsigned corner=offsets[element]; corner<offsets[element + 1]; corner++)
+            {
+                TS_ASSERT_DIFFERS(vertex_colours[nodes[corner]], colour);
+            }
+            for (unsigned corner=offsets[element]; corner<offsets[element + 1]; corner++)
+            {
+                vertex_colours[nodes[corner]] = colour;
+            }
+        }
+
+        // The forces do not depend on the number of threads, to the last bit
+        std::vector<double> serial_forces;
+        kernel.CalculateForces(locations, target_areas, 1.3, 0.04, 0.12, 0.07, serial_forces);
+        for (unsigned num_threads=2; num_threads<=4; num_threads+=2)
+        {
+            kernel.SetNumThreads(num_threads);
+            TS_ASSERT_EQUALS(kernel.GetNumThreads(), num_threads);
+            std::vector<double> forces;
+            kernel.CalculateForces(locations, target_areas, 1.3, 0.04, 0.12, 0.07, forces);
+            TS_ASSERT_EQUALS(forces.size(), serial_forces.size());
+            for (unsigned i=0; i<forces.size(); i++)
+            {
+                TS_ASSERT_EQUALS(forces[i], serial_forces[i]);
+            }
+        }
+        kernel.SetNumThreads(0u);
+        TS_ASSERT_LESS_THAN_EQUALS(1u, kernel.GetNumThreads());
+    }
+
+    void TestRenumbering()
+    {
+        // A tissue whose vertex and element indices have been shuffled, plus a vertex that belongs to no element
+        JitteredSquareTissue tissue(40u, 30u, 11u, 0.3);
+        std::vector<unsigned>& offsets = tissue.mElementOffsets;
+        std::vector<unsigned>& nodes = tissue.mElementNodes;
+        std::vector<double>& locations = tissue.mNodeLocations;
+        unsigned num_nodes = locations.size()/2 + 1;
+        Philox4x32 random(5u);
+        std::vector<unsigned> node_permutation(num_nodes);
+        std::vector<unsigned> element_permutation(1200);
+        for (unsigned i=0; i<num_nodes; i++)
+        {
+            node_permutation[i] = i;
+        }
+        for (unsigned i=0; i<1200; i++)
+        {
+            element_permutation[i] = i;
+        }
+        for (unsigned i=num_nodes-1; i>0; i--)
+        {
+            std::swap(node_permutation[i], node_permutation[(unsigned)(random.ranf()*(i + 1))]);
+        }
+        for (unsigned i=1199; i>0; i--)
+        {
+            std::swap(element_permutation[i], element_permutation[(unsigned)(random.ranf()*(i + 1))]);
+        }
+
+        std::vector<double> scattered_locations(2*num_nodes, 0.0);
+        for (unsigned node=0; node+1<num_nodes; node++)
+        {
+            scattered_locations[2*node_permutation[node]] = locations[2*node];
+            scattered_locations[2*node_permutation[node] + 1] = locations[2*node + 1];
+        }
+        std::vector<unsigned> scattered_offsets(1, 0u);
+        std::vector<unsigned> scattered_nodes;
+        std::vector<double> target_areas(1200);
+        for (unsigned element=0; element<1200; element++)
+        {
+            unsigned original = element_permutation[element];
+            for (unsigned corner=offsets[original]; corner<offsets[original + 1]; corner++)
+            {
+                scattered_nodes.push_back(node_permutation[nodes[corner]]);
+            }
+            scattered_offsets.push_back(scattered_nodes.size());
+            target_areas[element] = 0.9 + 0.0001*original;
+        }
+
+        // The orderings are permutations, leaving out the unused vertex
+        std::vector<unsigned> graph_offsets;
+        std::vector<unsigned> graph_neighbours;
+        MeshRenumbering::GetElementGraph(scattered_offsets, scattered_nodes, num_nodes, graph_offsets, graph_neighbours);
+        TS_ASSERT_EQUALS(graph_offsets.size(), 1201u);
+        std::vector<unsigned> element_order = MeshRenumbering::GetReverseCuthillMcKeeOrder(graph_offsets, graph_neighbours);
+        std::vector<unsigned> node_order = MeshRenumbering::GetNodeOrder(scattered_offsets, scattered_nodes, num_nodes, element_order);
+        TS_ASSERT_EQUALS(element_order.size(), 1200u);
+        TS_ASSERT_EQUALS(node_order.size(), num_nodes - 1);
+        std::vector<unsigned> new_node_indices(num_nodes, UINT_MAX);
+        for (unsigned node=0; node<node_order.size(); node++)
+        {
+            TS_ASSERT_EQUALS(new_node_indices[node_order[node]], UINT_MAX);
+            new_node_indices[node_order[node]] = node;
+        }
+        TS_ASSERT_EQUALS(new_node_indices[node_permutation[num_nodes - 1]], UINT_MAX);
+        std::vector<unsigned> element_counts(1200, 0u);
+        for (unsigned element=0; element<1200; element++)
+        {
+            element_counts[element_order[element]]++;
+        }
+        for (unsigned element=0; element<1200; element++)
+        {
+            TS_ASSERT_EQUALS(element_counts[element], 1u);
+        }
+
+        // The vertices of each element end up much closer together in memory
+        double scattered_span = 0.0;
+        double renumbered_span = 0.0;
+        for (unsigned element=0; element<1200; element++)
+        {
+            unsigned scattered_min = UINT_MAX;
+            unsigned scattered_max = 0;
+            unsigned renumbered_min = UINT_MAX;
+            unsigned renumbered_max = 0;
+            for (unsigned corner=scattered_offsets[element]; corner<scattered_offsets[element + 1]; corner++)
+            {
+                unsigned node = scattered_nodes[corner];
+                scattered_min = std::min(scattered_min, node);
+                scattered_max = std::max(scattered_max, node);
+                renumbered_min = std::min(renumbered_min, new_node_indices[node]);
+                renumbered_max = std::max(renumbered_max, new_node_indices[node]);
+            }
+            scattered_span += scattered_max - scattered_min;
+            renumbered_span += renumbered_max - renumbered_min;
+        }
+        TS_ASSERT_LESS_THAN(renumbered_span, 0.1*scattered_span);
+
+        // The kernel gives the same results by the caller's indices, up to rounding
+        FarhadifarForceKernel reference_kernel;
+        reference_kernel.SetRenumbering(false);
+        TS_ASSERT_EQUALS(reference_kernel.GetRenumbering(), false);
+        reference_kernel.SetTopology(scattered_offsets, scattered_nodes, num_nodes);
+        std::vector<double> reference_forces;
+        reference_kernel.CalculateForces(scattered_locations, target_areas, 1.3, 0.04, 0.12, 0.07, reference_forces);
+        TS_ASSERT(reference_kernel.rGetElementOrder().empty());
+
+        FarhadifarForceKernel kernel;
+        TS_ASSERT_EQUALS(kernel.GetRenumbering(), false);
+        kernel.SetRenumbering(true);
+        TS_ASSERT_EQUALS(kernel.GetRenumbering(), true);
+        kernel.SetTopology(scattered_offsets, scattered_nodes, num_nodes);
+        TS_ASSERT_EQUALS(kernel.rGetElementOrder().size(), 1200u);
+        std::vector<double> forces;
+        kernel.CalculateForces(scattered_locations, target_areas, 1.3, 0.04, 0.12, 0.07, forces);
+        TS_ASSERT_EQUALS(forces.size(), 2*num_nodes);
+        for (unsigned i=0; i<forces.size(); i++)
+        {
+            TS_ASSERT_DELTA(forces[i], reference_forces[i], 1e-12);
+        }
+        TS_ASSERT_EQUALS(forces[2*node_permutation[num_nodes - 1]], 0.0);
+        for (unsigned element=0; element<1200; element++)
+        {
+            TS_ASSERT_DELTA(kernel.rGetElementAreas()[element], reference_kernel.rGetElementAreas()[element], 1e-12);
+            TS_ASSERT_DELTA(kernel.rGetElementPerimeters()[element], reference_kernel.rGetElementPerimeters()[element], 1e-12);
+        }
+
+        // The colours are by the caller's indices, and the threads still give the same forces to the last bit
+        std::vector<unsigned> vertex_colours(num_nodes, UINT_MAX);
+        for (unsigned i=0; i<1200; i++)
+        {
+            unsigned element = kernel.rGetElementOrder()[i];
+            unsigned colour = kernel.rGetElementColours()[element];
+            for (unsigned corner=scattered_offsets[element]; corner<scattered_offsets[element + 1]; corner++)
+            {
+                TS_ASSERT_DIFFERS(vertex_colours[scattered_nodes[corner]], colour);
+            }
+            for (unsigned corner=scattered_offsets[element]; corner<scattered_offsets[element + 1]; corner++)
+            {
+                vertex_colours[scattered_nodes[corner]] = colour;
+            }
+        }
+        kernel.SetNumThreads(3u);
+        std::vector<double> threaded_forces;
+        kernel.CalculateForces(scattered_locations, target_areas, 1.3, 0.04, 0.12, 0.07, threaded_forces);
+        for (unsigned i=0; i<forces.size(); i++)
+        {
+            TS_ASSERT_EQUALS(threaded_forces[i], forces[i]);
+        }
+
+        // Switching the renumbering off rebuilds the derived topology, but is not a topology change
+        kernel.SetRenumbering(false);
+        TS_ASSERT(kernel.rGetElementOrder().empty());
+        TS_ASSERT_EQUALS(kernel.GetNumTopologyUpdates(), 1u);
+        kernel.CalculateForces(scattered_locations, target_areas, 1.3, 0.04, 0.12, 0.07, forces);
+        for (unsigned i=0; i<forces.size(); i++)
+        {
+            TS_ASSERT_EQUALS(forces[i], reference_forces[i]);
+        }
+    }
+
+    void TestThreadTeam()
+    {
+        ThreadTeam team(3u);
+        TS_ASSERT_EQUALS(team.GetNumThreads(), 3u);
+        for (unsigned repeat=0; repeat<100; repeat++)
+        {
+            std::vector<unsigned> counts(3, 0u);
+            team.Run([&](unsigned threadIndex)
+            {
+                counts[threadIndex]++;
+            });
+            for (unsigned thread=0; thread<3; thread++)
+            {
+                TS_ASSERT_EQUALS(counts[thread], 1u);
+            }
+        }
+
+        TS_ASSERT_THROWS_CONTAINS(team.Run([](unsigned threadIndex)
+        {
+            if (threadIndex == 2u)
+            {
+                EXCEPTION("Thread " << threadIndex << " failed");
+            }
+        }), "Thread 2 failed");
+
+        // The team can still be used after an exception
+        unsigned sum = 0;
+        std::mutex mutex;
+        team.Run([&](unsigned threadIndex)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            sum += threadIndex;
+        });
+        TS_ASSERT_EQUALS(sum, 3u);
+    }
+};
+
+#endif /*TESTFARHADIFARFORCEKERNEL_HPP_*/
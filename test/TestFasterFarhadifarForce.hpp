@@ -0,0 +1,414 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTFASTERFARHADIFARFORCE_HPP_
+#define TESTFASTERFARHADIFARFORCE_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+#include "AbstractCellBasedTestSuite.hpp"
+#include "CellsGenerator.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+#include "FarhadifarForce.hpp"
+#include "HoneycombVertexMeshGenerator.hpp"
+#include "NoCellCycleModel.hpp"
+#include "SmartPointers.hpp"
+#include "VertexBasedCellPopulation.hpp"
+#include "VoronoiVertexMeshGenerator.hpp"
+#include "FakePetscSetup.hpp"
+#include "Exception.hpp"
+#include "FasterFarhadifarForce.hpp"
+
+class TestFasterFarhadifarForce : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * Calculate the forces on the nodes of a population with the given force,
+     * starting from no applied force.
+     *
+     * @param rForce the force
+     * @param rCellPopulation the population
+     * @return the x and y components of the force on each node in turn
+     */
+    static std::vector<double> CalculateForces(AbstractForce<2>& rForce, VertexBasedCellPopulation<2>& rCellPopulation)
+    {
+        for (unsigned node_index=0; node_index<rCellPopulation.GetNumNodes(); node_index++)
+        {
+            rCellPopulation.GetNode(node_index)->ClearAppliedForce();
+        }
+        rForce.AddForceContribution(rCellPopulation);
+
+        std::vector<double> forces;
+        for (unsigned node_index=0; node_index<rCellPopulation.GetNumNodes(); node_index++)
+        {
+            const c_vector<double, 2>& r_force = rCellPopulation.GetNode(node_index)->rGetAppliedForce();
+            forces.push_back(r_force[0]);
+            forces.push_back(r_force[1]);
+        }
+        return forces;
+    }
+
+    /**
+     * Give both forces the same parameters, with a boundary line tension that
+     * differs from the line tension in the bulk.
+     *
+     * @param rReference Chaste's force
+     * @param rFaster the faster force
+     */
+    static void SetParameters(FarhadifarForce<2>& rReference, FarhadifarForce<2>& rFaster)
+    {
+        rReference.SetAreaElasticityParameter(1.3);
+        rReference.SetPerimeterContractilityParameter(0.04);
+        rReference.SetLineTensionParameter(0.12);
+        rReference.SetBoundaryLineTensionParameter(0.07);
+        rFaster.SetAreaElasticityParameter(1.3);
+        rFaster.SetPerimeterContractilityParameter(0.04);
+        rFaster.SetLineTensionParameter(0.12);
+        rFaster.SetBoundaryLineTensionParameter(0.07);
+    }
+
+public:
+
+    void TestSameForcesAsFarhadifarForce()
+    {
+        // An irregular tissue with a ragged boundary
+        VoronoiVertexMeshGenerator generator(6, 5, 2);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements(), std::vector<unsigned>(), p_diff_type);
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+
+        // Target areas that differ from cell to cell, so that a mix-up of cells shows
+        for (typename AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            unsigned elem_index = cell_population.GetLocationIndexUsingCell(*cell_iter);
+            cell_iter->GetCellData()->SetItem("target area", 0.8 + 0.05*(elem_index % 7));
+        }
+
+        FarhadifarForce<2> reference_force;
+        FasterFarhadifarForce<2> faster_force;
+        SetParameters(reference_force, faster_force);
+
+        // Move the nodes between calls, so the faster force must pick up the new locations
+        for (unsigned step=0; step<3; step++)
+        {
+            std::vector<double> reference = CalculateForces(reference_force, cell_population);
+            std::vector<double> faster = CalculateForces(faster_force, cell_population);
+            TS_ASSERT_EQUALS(faster.size(), reference.size());
+            for (unsigned i=0; i<reference.size(); i++)
+            {
+                TS_ASSERT_DELTA(faster[i], reference[i], 1e-12);
+            }
+
+            for (unsigned node_index=0; node_index<cell_population.GetNumNodes(); node_index++)
+            {
+                c_vector<double, 2>& r_location = cell_population.GetNode(node_index)->rGetModifiableLocation();
+                r_location[0] += 0.01*reference[2*node_index];
+                r_location[1] += 0.01*reference[2*node_index + 1];
+            }
+        }
+    }
+
+    void TestBoundaryLineTensionIsUsed()
+    {
+        VoronoiVertexMeshGenerator generator(5, 5, 2);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements(), std::vector<unsigned>(), p_diff_type);
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+        for (typename AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            cell_iter->GetCellData()->SetItem("target area", 1.0);
+        }
+
+        FarhadifarForce<2> reference_force;
+        FasterFarhadifarForce<2> faster_force;
+        SetParameters(reference_force, faster_force);
+        std::vector<double> before = CalculateForces(faster_force, cell_population);
+
+        // Changing only the boundary line tension changes only the forces on boundary nodes
+        reference_force.SetBoundaryLineTensionParameter(0.3);
+        faster_force.SetBoundaryLineTensionParameter(0.3);
+        std::vector<double> reference = CalculateForces(reference_force, cell_population);
+        std::vector<double> faster = CalculateForces(faster_force, cell_population);
+
+        unsigned num_boundary_nodes_changed = 0;
+        for (unsigned node_index=0; node_index<cell_population.GetNumNodes(); node_index++)
+        {
+            bool is_boundary = cell_population.GetNode(node_index)->IsBoundaryNode();
+            for (unsigned dim=0; dim<2; dim++)
+            {
+                unsigned i = 2*node_index + dim;
+                TS_ASSERT_DELTA(faster[i], reference[i], 1e-12);
+                if (!is_boundary)
+                {
+                    TS_ASSERT_DELTA(faster[i], before[i], 1e-12);
+                }
+            }
+            if (is_boundary && (fabs(faster[2*node_index] - before[2*node_index]) > 1e-6
+                                || fabs(faster[2*node_index + 1] - before[2*node_index + 1]) > 1e-6))
+            {
+                num_boundary_nodes_changed++;
+            }
+        }
+        TS_ASSERT_LESS_THAN(0u, num_boundary_nodes_changed);
+    }
+
+    void TestThreadsAndRenumberingGiveSameForces()
+    {
+        VoronoiVertexMeshGenerator generator(8, 8, 2);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements(), std::vector<unsigned>(), p_diff_type);
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+        for (typename AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            cell_iter->GetCellData()->SetItem("target area", 0.9);
+        }
+
+        FarhadifarForce<2> reference_force;
+        FasterFarhadifarForce<2> faster_force;
+        SetParameters(reference_force, faster_force);
+        faster_force.SetNumThreads(3);
+        faster_force.SetRenumbering(true);
+
+        std::vector<double> reference = CalculateForces(reference_force, cell_population);
+        std::vector<double> faster = CalculateForces(faster_force, cell_population);
+        for (unsigned i=0; i<reference.size(); i++)
+        {
+            TS_ASSERT_DELTA(faster[i], reference[i], 1e-12);
+        }
+    }
+
+    void TestRenumberingAfterSwaps()
+    {
+        // A honeycomb tissue in which an interior vertex is replaced by a small triangular element
+        HoneycombVertexMeshGenerator generator(6, 6);
+        MutableVertexMesh<2,2>* p_honeycomb = generator.GetMesh();
+        unsigned vertex_index = UINT_MAX;
+        for (unsigned node_index=0; node_index<p_honeycomb->GetNumNodes() && vertex_index == UINT_MAX; node_index++)
+        {
+            Node<2>* p_node = p_honeycomb->GetNode(node_index);
+            if (!p_node->IsBoundaryNode() && p_node->rGetContainingElementIndices().size() == 3)
+            {
+                vertex_index = node_index;
+            }
+        }
+        TS_ASSERT_DIFFERS(vertex_index, UINT_MAX);
+        const c_vector<double, 2>& r_vertex = p_honeycomb->GetNode(vertex_index)->rGetLocation();
+
+        std::vector<Node<2>*> nodes;
+        for (unsigned node_index=0; node_index<p_honeycomb->GetNumNodes(); node_index++)
+        {
+            Node<2>* p_node = p_honeycomb->GetNode(node_index);
+            nodes.push_back(new Node<2>(node_index, p_node->rGetLocation(), p_node->IsBoundaryNode()));
+        }
+
+        // The corners of the triangle lie on the vertex's three edges, keyed by the neighbour at the other end
+        std::map<unsigned, Node<2>*> triangle_nodes;
+        std::vector<std::pair<double, Node<2>*> > triangle_by_angle;
+        const std::set<unsigned>& r_containing_elements = p_honeycomb->GetNode(vertex_index)->rGetContainingElementIndices();
+        for (std::set<unsigned>::const_iterator elem_iter = r_containing_elements.begin();
+             elem_iter != r_containing_elements.end();
+             ++elem_iter)
+        {
+            VertexElement<2,2>* p_element = p_honeycomb->GetElement(*elem_iter);
+            unsigned num_element_nodes = p_element->GetNumNodes();
+            unsigned local_index = p_element->GetNodeLocalIndex(vertex_index);
+            unsigned neighbour_index = p_element->GetNodeGlobalIndex((local_index + 1) % num_element_nodes);
+            c_vector<double, 2> direction = p_honeycomb->GetNode(neighbour_index)->rGetLocation() - r_vertex;
+            Node<2>* p_corner;
+            if (triangle_nodes.empty())
+            {
+                // Reuse the vertex, so that no node is left without an element
+                p_corner = nodes[vertex_index];
+                p_corner->rGetModifiableLocation() = r_vertex + 0.02*direction;
+            }
+            else
+            {
+                p_corner = new Node<2>(nodes.size(), r_vertex + 0.02*direction, false);
+                nodes.push_back(p_corner);
+            }
+            triangle_nodes[neighbour_index] = p_corner;
+            triangle_by_angle.push_back(std::make_pair(atan2(direction[1], direction[0]), p_corner));
+        }
+        TS_ASSERT_EQUALS(triangle_nodes.size(), 3u);
+
+        // Each element at the vertex takes the two corners on its edges in place of the vertex
+        std::vector<VertexElement<2,2>*> elements;
+        for (unsigned elem_index=0; elem_index<p_honeycomb->GetNumElements(); elem_index++)
+        {
+            VertexElement<2,2>* p_element = p_honeycomb->GetElement(elem_index);
+            unsigned num_element_nodes = p_element->GetNumNodes();
+            std::vector<Node<2>*> element_nodes;
+            for (unsigned local_index=0; local_index<num_element_nodes; local_index++)
+            {
+                unsigned node_index = p_element->GetNodeGlobalIndex(local_index);
+                if (node_index == vertex_index)
+                {
+                    element_nodes.push_back(triangle_nodes[p_element->GetNodeGlobalIndex((local_index + num_element_nodes - 1) % num_element_nodes)]);
+                    element_nodes.push_back(triangle_nodes[p_element->GetNodeGlobalIndex((local_index + 1) % num_element_nodes)]);
+                }
+                else
+                {
+                    element_nodes.push_back(nodes[node_index]);
+                }
+            }
+            elements.push_back(new VertexElement<2,2>(elem_index, element_nodes));
+        }
+        std::sort(triangle_by_angle.begin(), triangle_by_angle.end());
+        std::vector<Node<2>*> triangle;
+        for (unsigned corner=0; corner<3; corner++)
+        {
+            triangle.push_back(triangle_by_angle[corner].second);
+        }
+        elements.push_back(new VertexElement<2,2>(elements.size(), triangle));
+        MutableVertexMesh<2,2> mesh(nodes, elements);
+        unsigned num_elements = mesh.GetNumElements();
+
+        // The triangle is smaller than the T2 threshold, so remeshing removes it
+        mesh.ReMesh();
+        TS_ASSERT_EQUALS(mesh.GetNumElements(), num_elements - 1);
+
+        // Shorten an interior edge between two interior vertices, so that remeshing makes a T1 swap
+        bool have_t1_edge = false;
+        for (unsigned elem_index=mesh.GetNumElements()/2; elem_index<mesh.GetNumElements() && !have_t1_edge; elem_index++)
+        {
+            VertexElement<2,2>* p_element = mesh.GetElement(elem_index);
+            if (p_element->IsElementOnBoundary())
+            {
+                continue;
+            }
+            Node<2>* p_node_a = p_element->GetNode(0);
+            Node<2>* p_node_b = p_element->GetNode(1);
+            if (p_node_a->rGetContainingElementIndices().size() == 3 && p_node_b->rGetContainingElementIndices().size() == 3)
+            {
+                c_vector<double, 2> midpoint = 0.5*(p_node_a->rGetLocation() + p_node_b->rGetLocation());
+                c_vector<double, 2> half_edge = 0.5*(p_node_b->rGetLocation() - p_node_a->rGetLocation());
+                double shrink = 0.25*mesh.GetCellRearrangementThreshold()/norm_2(half_edge);
+                p_node_a->rGetModifiableLocation() = midpoint - shrink*half_edge;
+                p_node_b->rGetModifiableLocation() = midpoint + shrink*half_edge;
+                have_t1_edge = true;
+            }
+        }
+        TS_ASSERT(have_t1_edge);
+        mesh.ReMesh();
+        TS_ASSERT_EQUALS(mesh.GetLocationsOfT1Swaps().size(), 1u);
+
+        // A division adds an element and nodes at the end, as in a simulation
+        mesh.DivideElementAlongShortAxis(mesh.GetElement(1));
+
+        std::vector<CellPtr> cells;
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, mesh.GetNumElements(), std::vector<unsigned>(), p_diff_type);
+        VertexBasedCellPopulation<2> cell_population(mesh, cells);
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            unsigned elem_index = cell_population.GetLocationIndexUsingCell(*cell_iter);
+            cell_iter->GetCellData()->SetItem("target area", 0.8 + 0.05*(elem_index % 5));
+        }
+
+        FarhadifarForce<2> reference_force;
+        FasterFarhadifarForce<2> faster_force;
+        SetParameters(reference_force, faster_force);
+        FasterFarhadifarForce<2> renumbered_force;
+        SetParameters(reference_force, renumbered_force);
+        TS_ASSERT_EQUALS(faster_force.GetRenumbering(), false);
+        renumbered_force.SetRenumbering(true);
+
+        std::vector<double> reference = CalculateForces(reference_force, cell_population);
+        std::vector<double> faster = CalculateForces(faster_force, cell_population);
+        std::vector<double> renumbered = CalculateForces(renumbered_force, cell_population);
+        for (unsigned i=0; i<reference.size(); i++)
+        {
+            TS_ASSERT_DELTA(faster[i], reference[i], 1e-12);
+            TS_ASSERT_DELTA(renumbered[i], faster[i], 1e-12);
+        }
+
+        // The renumbering has moved the elements
+        const std::vector<unsigned>& r_element_order = renumbered_force.rGetKernel().rGetElementOrder();
+        TS_ASSERT_EQUALS(r_element_order.size(), mesh.GetNumElements());
+        bool is_identity = true;
+        for (unsigned i=0; i<r_element_order.size(); i++)
+        {
+            is_identity = is_identity && (r_element_order[i] == i);
+        }
+        TS_ASSERT(!is_identity);
+    }
+
+    void TestExceptions()
+    {
+        VoronoiVertexMeshGenerator generator(3, 3, 2);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements(), std::vector<unsigned>(), p_diff_type);
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+
+        // No target areas, as when there is no growth modifier
+        FasterFarhadifarForce<2> faster_force;
+        TS_ASSERT_THROWS_CONTAINS(faster_force.AddForceContribution(cell_population),
+                                  "You need to add an AbstractTargetAreaModifier");
+    }
+};
+
+#endif /*TESTFASTERFARHADIFARFORCE_HPP_*/
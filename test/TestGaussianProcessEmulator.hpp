@@ -0,0 +1,168 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef TESTGAUSSIANPROCESSEMULATOR_HPP_
+#define TESTGAUSSIANPROCESSEMULATOR_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <cmath>
+#include <fstream>
+#include "FakePetscSetup.hpp"
+#include "Exception.hpp"
+#include "GaussianProcessEmulator.hpp"
+#include "OutputFileHandler.hpp"
+#include "Philox4x32.hpp"
+
+class TestGaussianProcessEmulator : public CxxTest::TestSuite
+{
+private:
+
+    /**
+     * @param lambda Lambda
+     * @param gamma Gamma
+     * @return the smooth function that the emulator is trained on
+     */
+    double Function(double lambda, double gamma)
+    {
+        return std::sin(3.0*lambda) + 10.0*gamma*gamma;
+    }
+
+    /**
+     * Add noisy samples of Function() on [-1, 1] x [0, 0.2] to an emulator.
+     *
+     * @param rEmulator the emulator
+     * @param numPoints the number of points
+     * @param noise the standard deviation of the noise
+     */
+    void AddSamples(GaussianProcessEmulator& rEmulator, unsigned numPoints, double noise)
+    {
+        Philox4x32 random(1u);
+        for (unsigned i=0; i<numPoints; i++)
+        {
+            double lambda = -1.0 + 2.0*random.ranf();
+            double gamma = 0.2*random.ranf();
+
+            // Box-Muller
+            double normal = std::sqrt(-2.0*std::log(1.0 - random.ranf()))*std::cos(2.0*M_PI*random.ranf());
+
+            std::vector<double> input = {lambda, gamma};
+            std::vector<double> output = {Function(lambda, gamma) + noise*normal};
+            rEmulator.AddTrainingPoint(input, output);
+        }
+    }
+
+public:
+
+    void TestExactEmulator()
+    {
+        GaussianProcessEmulator emulator(std::vector<std::string>(), std::vector<std::string>(1, "Statistic"));
+        TS_ASSERT_EQUALS(emulator.rGetInputNames()[0], "Lambda");
+        TS_ASSERT_EQUALS(emulator.rGetInputNames()[1], "Gamma");
+        TS_ASSERT_THROWS_CONTAINS(emulator.Train(), "no training points");
+
+        AddSamples(emulator, 200u, 0.05);
+        emulator.Train();
+        TS_ASSERT(!emulator.IsSparse(0));
+
+        double max_error = 0.0;
+        for (double lambda=-0.9; lambda<0.9; lambda+=0.1)
+        {
+            std::vector<double> mean;
+            std::vector<double> variance;
+            emulator.Predict({lambda, 0.1}, mean, variance);
+            max_error = std::max(max_error, std::fabs(mean[0] - Function(lambda, 0.1)));
+            TS_ASSERT(variance[0] < 0.01);
+            TS_ASSERT_DELTA(emulator.PredictMean({lambda, 0.1})[0], mean[0], 1e-12);
+        }
+        TS_ASSERT_LESS_THAN(max_error, 0.05);
+
+        // The noise is recovered, and the emulator is much less certain away from the data
+        TS_ASSERT_DELTA(std::sqrt(emulator.GetNoiseVariance(0)), 0.05, 0.015);
+        TS_ASSERT_LESS_THAN(10.0*emulator.GetUncertainty({0.0, 0.1}), emulator.GetUncertainty({3.0, 0.1}));
+    }
+
+    void TestSparseEmulator()
+    {
+        GaussianProcessEmulator emulator(std::vector<std::string>(), std::vector<std::string>(1, "Statistic"));
+        emulator.SetMaxExactPoints(500u);
+        emulator.SetNumInducingPoints(60u);
+        AddSamples(emulator, 3000u, 0.05);
+        emulator.Train();
+        TS_ASSERT(emulator.IsSparse(0));
+
+        double max_error = 0.0;
+        for (double lambda=-0.9; lambda<0.9; lambda+=0.1)
+        {
+            std::vector<double> mean;
+            std::vector<double> variance;
+            emulator.Predict({lambda, 0.05}, mean, variance);
+            max_error = std::max(max_error, std::fabs(mean[0] - Function(lambda, 0.05)));
+            TS_ASSERT(variance[0] >= 0.0);
+        }
+        TS_ASSERT_LESS_THAN(max_error, 0.05);
+        TS_ASSERT_LESS_THAN(10.0*emulator.GetUncertainty({0.0, 0.1}), emulator.GetUncertainty({3.0, 0.1}));
+    }
+
+    void TestReadSweepResults()
+    {
+        OutputFileHandler handler("TestGaussianProcessEmulator");
+        std::string path = handler.GetOutputDirectoryFullPath() + "SweepResults.csv";
+        {
+            std::ofstream file(path.c_str());
+            file << "Lambda,Gamma,Simulation,Run,Seed,Succeeded,MeanArea,AreaCorrelation\n";
+            file << "0.1,0.04,1,1,5,1,1.1,0.2\n";
+            file << "0.1,0.04,1,2,6,1,1.2,\n";
+            file << "0.2,0.04,2,1,7,0,,\n";
+            file << "0.3,0.05,3,1,8,1,1.4,0.3\n";
+            file << "0.4,0.06,4,1,9,1,1.5,0.1\n";
+        }
+
+        std::vector<std::string> outputs = {"MeanArea", "AreaCorrelation"};
+        GaussianProcessEmulator emulator(std::vector<std::string>(), outputs);
+        TS_ASSERT_EQUALS(emulator.ReadSweepResults(path), 4u);
+        TS_ASSERT_EQUALS(emulator.GetNumTrainingPoints(), 4u);
+        emulator.Train();
+        TS_ASSERT_EQUALS(emulator.GetLengthScales(0).size(), 2u);
+
+        std::vector<double> mean = emulator.PredictMean({0.25, 0.045});
+        TS_ASSERT(mean[0] > 1.0 && mean[0] < 1.6);
+
+        GaussianProcessEmulator other(std::vector<std::string>(), std::vector<std::string>(1, "Missing"));
+        TS_ASSERT_THROWS_CONTAINS(other.ReadSweepResults(path), "has no Missing column");
+        std::vector<double> variance;
+        TS_ASSERT_THROWS_CONTAINS(other.Predict({0.1, 0.1}, mean, variance), "has not been trained");
+    }
+};
+
+#endif /*TESTGAUSSIANPROCESSEMULATOR_HPP_*/
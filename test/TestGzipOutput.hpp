@@ -0,0 +1,213 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTGZIPOUTPUT_HPP_
+#define TESTGZIPOUTPUT_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <zlib.h>
+#include "AbstractCellBasedTestSuite.hpp"
+#include "CellsGenerator.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+#include "HoneycombVertexMeshGenerator.hpp"
+#include "NoCellCycleModel.hpp"
+#include "OutputFileHandler.hpp"
+#include "SmartPointers.hpp"
+#include "VertexBasedCellPopulation.hpp"
+#include "FakePetscSetup.hpp"
+#include "CellEdgeCountWriter.hpp"
+#include "GzipBlockStreamBuffer.hpp"
+
+namespace
+{
+    /**
+     * Read a whole gzip file with zlib. gzread() carries on through concatenated
+     * gzip members, as gunzip does.
+     */
+    std::string ReadGzipFile(const std::string& rPath)
+    {
+        std::string contents;
+        gzFile p_file = gzopen(rPath.c_str(), "rb");
+        TS_ASSERT(p_file != nullptr);
+        if (p_file)
+        {
+            char buffer[4096];
+            int num_read;
+            while ((num_read = gzread(p_file, buffer, sizeof(buffer))) > 0)
+            {
+                contents.append(buffer, num_read);
+            }
+            TS_ASSERT_EQUALS(num_read, 0);
+            gzclose(p_file);
+        }
+        return contents;
+    }
+
+    /** Count the gzip members in a file by inflating them one at a time. */
+    unsigned CountGzipMembers(const std::string& rPath)
+    {
+        std::ifstream file(rPath.c_str(), std::ios::binary);
+        std::string compressed((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        unsigned num_members = 0;
+        size_t offset = 0;
+        std::vector<unsigned char> output(4096);
+        while (offset < compressed.size())
+        {
+            z_stream stream = z_stream();
+            TS_ASSERT_EQUALS(inflateInit2(&stream, 15 + 16), Z_OK);
+            stream.next_in = reinterpret_cast<Bytef*>(&compressed[offset]);
+            stream.avail_in = compressed.size() - offset;
+            int result;
+            do
+            {
+                stream.next_out = output.data();
+                stream.avail_out = output.size();
+                result = inflate(&stream, Z_NO_FLUSH);
+            }
+            while (result == Z_OK);
+            TS_ASSERT_EQUALS(result, Z_STREAM_END);
+            offset = compressed.size() - stream.avail_in;
+            inflateEnd(&stream);
+            if (result != Z_STREAM_END)
+            {
+                break;
+            }
+            num_members++;
+        }
+        return num_members;
+    }
+
+    /** Read a whole file as it is. */
+    std::string ReadFile(const std::string& rPath)
+    {
+        std::ifstream file(rPath.c_str(), std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    }
+}
+
+class TestGzipOutput : public AbstractCellBasedTestSuite
+{
+public:
+
+    void TestStreamBufferRoundTrip()
+    {
+        OutputFileHandler handler("TestGzipOutput", false);
+        std::string path = handler.GetOutputDirectoryFullPath() + "stream.gz";
+
+        std::ostringstream expected;
+        {
+            std::ofstream file(path.c_str(), std::ios::binary);
+            GzipBlockStreamBuffer buffer(file.rdbuf(), 100);
+            std::ostream stream(&buffer);
+            for (unsigned i=0; i<200; i++)
+            {
+                stream << i << " " << 0.5*i << "\n";
+                expected << i << " " << 0.5*i << "\n";
+            }
+            stream.flush();
+        }
+
+        TS_ASSERT_EQUALS(ReadGzipFile(path), expected.str());
+
+        // Each 100 byte block is a member of its own
+        TS_ASSERT_LESS_THAN(expected.str().size()/100, CountGzipMembers(path) + 1);
+        TS_ASSERT_LESS_THAN(1u, CountGzipMembers(path));
+    }
+
+    void TestWriterOutputMatchesUncompressedOutput()
+    {
+        HoneycombVertexMeshGenerator generator(4, 4);
+        boost::shared_ptr<MutableVertexMesh<2,2> > p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements(), std::vector<unsigned>(), p_diff_type);
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+
+        OutputFileHandler handler("TestGzipOutput", false);
+
+        CellEdgeCountWriter<2,2> plain_writer;
+        CellEdgeCountWriter<2,2> compressed_writer;
+        compressed_writer.SetCompressOutput(true);
+        compressed_writer.SetCompressionBlockSize(16); // several blocks per time step
+        TS_ASSERT_EQUALS(compressed_writer.GetFileName(), plain_writer.GetFileName() + ".gz");
+
+        // Three open/close cycles, as when a simulation is saved and loaded again
+        const unsigned num_cycles = 3;
+        for (unsigned cycle=0; cycle<num_cycles; cycle++)
+        {
+            CellEdgeCountWriter<2,2>* writers[2] = {&plain_writer, &compressed_writer};
+            for (unsigned w=0; w<2; w++)
+            {
+                if (cycle == 0)
+                {
+                    writers[w]->OpenOutputFile(handler);
+                }
+                else
+                {
+                    writers[w]->OpenOutputFileForAppend(handler);
+                }
+                for (unsigned step=0; step<2; step++)
+                {
+                    writers[w]->WriteTimeStamp();
+                    for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+                         cell_iter != cell_population.End();
+                         ++cell_iter)
+                    {
+                        writers[w]->VisitCell(*cell_iter, &cell_population);
+                    }
+                    writers[w]->WriteNewline();
+                }
+                writers[w]->CloseFile();
+            }
+        }
+
+        std::string directory = handler.GetOutputDirectoryFullPath();
+        std::string plain_output = ReadFile(directory + plain_writer.GetFileName());
+        TS_ASSERT(!plain_output.empty());
+        TS_ASSERT_EQUALS(ReadGzipFile(directory + compressed_writer.GetFileName()), plain_output);
+
+        // At least one member per open/close cycle, and more for the small blocks
+        TS_ASSERT_LESS_THAN(num_cycles, CountGzipMembers(directory + compressed_writer.GetFileName()));
+    }
+};
+
+#endif /*TESTGZIPOUTPUT_HPP_*/
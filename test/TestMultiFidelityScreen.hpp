@@ -0,0 +1,168 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef TESTMULTIFIDELITYSCREEN_HPP_
+#define TESTMULTIFIDELITYSCREEN_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <cmath>
+#include <fstream>
+#include "FakePetscSetup.hpp"
+#include "Exception.hpp"
+#include "MultiFidelityScreen.hpp"
+#include "OutputFileHandler.hpp"
+
+class TestMultiFidelityScreen : public CxxTest::TestSuite
+{
+private:
+
+    /**
+     * @param meanArea the mean area
+     * @param numCells the number of cells
+     * @return statistics with the given mean area and cell count and fixed other values
+     */
+    TissueSummaryStatistics MakeStatistics(double meanArea, double numCells)
+    {
+        TissueSummaryStatistics statistics;
+        statistics.mNumCells = numCells;
+        statistics.mMeanArea = meanArea;
+        statistics.mMeanPolygonNumber = 6.0;
+        return statistics;
+    }
+
+public:
+
+    void TestScreeningParameters()
+    {
+        PaperVertexSimulationParameters parameters;
+        PaperVertexSimulationParameters screening = MultiFidelityScreen::GetScreeningParameters(parameters);
+        TS_ASSERT_EQUALS(screening.mNumberGenerations, 4u);
+        TS_ASSERT_DELTA(screening.mEndTime, 200.0, 1e-12);
+        TS_ASSERT_DELTA(screening.mDt, 0.01, 1e-12);
+
+        // Output is still written every hour
+        TS_ASSERT_EQUALS(screening.mSamplingTimestepMultiple, 100u);
+        TS_ASSERT_DELTA(screening.mLineTensionParameter, parameters.mLineTensionParameter, 1e-12);
+    }
+
+    void TestScreenAndSelect()
+    {
+        // Five parameter sets with 1, 2, 1, 3 and 1 runs
+        std::vector<SweepTask> tasks;
+        unsigned runs[5] = {1, 2, 1, 3, 1};
+        for (unsigned simulation=1; simulation<=5; simulation++)
+        {
+            for (unsigned run=1; run<=runs[simulation-1]; run++)
+            {
+                tasks.push_back(SweepTask(0.1*simulation, 0.04, simulation, run, SweepTask::DeriveSeed(1u, simulation, run)));
+            }
+        }
+
+        MultiFidelityScreen screen(tasks, MakeStatistics(1.0, 500.0), 0.4);
+        TS_ASSERT_EQUALS(screen.GetNumParameterSets(), 5u);
+
+        std::vector<SweepTask> screening_tasks = screen.GetScreeningTasks();
+        TS_ASSERT_EQUALS(screening_tasks.size(), 5u);
+        TS_ASSERT_EQUALS(screening_tasks[3].mSimulation, 4u);
+        TS_ASSERT_EQUALS(screening_tasks[3].mRun, 1u);
+
+        TS_ASSERT_THROWS_CONTAINS(screen.GetSelectedTasks(), "have not been set");
+
+        // Sets 4 and 2 are closest to the target mean area; the cell counts are ignored.
+        // Set 5 failed.
+        std::vector<TissueSummaryStatistics> statistics;
+        statistics.push_back(MakeStatistics(2.0, 500.0));
+        statistics.push_back(MakeStatistics(1.2, 10.0));
+        statistics.push_back(MakeStatistics(1.6, 500.0));
+        statistics.push_back(MakeStatistics(0.9, 10.0));
+        statistics.push_back(MakeStatistics(1.0, 500.0));
+        std::vector<bool> succeeded(5, true);
+        succeeded[4] = false;
+        screen.SetScreeningResults(statistics, succeeded);
+
+        std::vector<double> scores = screen.rGetScores();
+        TS_ASSERT(scores[3] < scores[1]);
+        TS_ASSERT(scores[1] < scores[2]);
+        TS_ASSERT(scores[2] < scores[0]);
+        TS_ASSERT(std::isinf(scores[4]));
+
+        // The scale is the standard deviation of the mean area over the successful runs
+        double mean = (2.0 + 1.2 + 1.6 + 0.9)/4.0;
+        double variance = (std::pow(2.0 - mean, 2) + std::pow(1.2 - mean, 2) + std::pow(1.6 - mean, 2) + std::pow(0.9 - mean, 2))/3.0;
+        TS_ASSERT_DELTA(scores[3], 0.1/std::sqrt(variance), 1e-12);
+
+        // 40% of five sets is two sets, with 3 and 1 runs
+        std::vector<bool> selected = screen.rGetSelected();
+        TS_ASSERT(!selected[0]);
+        TS_ASSERT(selected[1]);
+        TS_ASSERT(!selected[2]);
+        TS_ASSERT(selected[3]);
+        TS_ASSERT(!selected[4]);
+
+        std::vector<SweepTask> selected_tasks = screen.GetSelectedTasks();
+        TS_ASSERT_EQUALS(selected_tasks.size(), 5u);
+        TS_ASSERT_EQUALS(selected_tasks[0].mSimulation, 2u);
+        TS_ASSERT_EQUALS(selected_tasks[4].mSimulation, 4u);
+        TS_ASSERT_EQUALS(selected_tasks[4].mRun, 3u);
+
+        OutputFileHandler handler("TestMultiFidelityScreen");
+        std::string path = handler.GetOutputDirectoryFullPath() + "ScreeningResults.csv";
+        screen.WriteScreeningResults(path);
+
+        std::ifstream file(path.c_str());
+        std::string line;
+        std::getline(file, line);
+        TS_ASSERT_EQUALS(line.find("Lambda,Gamma,Simulation,Run,Seed,Succeeded,Score,Selected,"), 0u);
+        unsigned num_lines = 0;
+        while (std::getline(file, line))
+        {
+            num_lines++;
+        }
+        TS_ASSERT_EQUALS(num_lines, 5u);
+    }
+
+    void TestExceptions()
+    {
+        std::vector<SweepTask> tasks(1, SweepTask(0.1, 0.04, 1u, 1u, 1u));
+        TissueSummaryStatistics target;
+        TS_ASSERT_THROWS_CONTAINS(MultiFidelityScreen(tasks, target, 0.0), "selection fraction");
+
+        MultiFidelityScreen screen(tasks, target);
+        TS_ASSERT_THROWS_CONTAINS(screen.SetStatisticWeights(std::vector<double>(2, 1.0)), "statistic weights");
+        TS_ASSERT_THROWS_CONTAINS(screen.SetScreeningResults(std::vector<TissueSummaryStatistics>(),
+                                                             std::vector<bool>()), "screening runs");
+    }
+};
+
+#endif /*TESTMULTIFIDELITYSCREEN_HPP_*/
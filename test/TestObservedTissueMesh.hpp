@@ -0,0 +1,355 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTOBSERVEDTISSUEMESH_HPP_
+#define TESTOBSERVEDTISSUEMESH_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <cmath>
+#include <fstream>
+#include <set>
+#include "AbstractCellBasedTestSuite.hpp"
+#include "CellsGenerator.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+#include "NoCellCycleModel.hpp"
+#include "SmartPointers.hpp"
+#include "VertexBasedCellPopulation.hpp"
+#include "VoronoiVertexMeshGenerator.hpp"
+#include "FakePetscSetup.hpp"
+#include "Exception.hpp"
+#include "JitteredSquareTissue.hpp"
+#include "NeighbourCorrelation.hpp"
+#include "ObservedTissueMesh.hpp"
+#include "OutputFileHandler.hpp"
+#include "TissueSummaryStatistics.hpp"
+
+class TestObservedTissueMesh : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * Make an ObservedTissueMesh of a JitteredSquareTissue whose vertices on the
+     * edge of the tissue are left in place, so that its area is numX*numY.
+     *
+     * @param rTissue the tissue
+     * @param rMesh the mesh
+     */
+    static void AddToMesh(const JitteredSquareTissue& rTissue, ObservedTissueMesh& rMesh)
+    {
+        for (unsigned node=0; node<rTissue.GetNumNodes(); node++)
+        {
+            rMesh.AddNode(rTissue.mNodeLocations[2*node], rTissue.mNodeLocations[2*node + 1]);
+        }
+        for (unsigned element=0; element<rTissue.GetNumElements(); element++)
+        {
+            rMesh.AddElement(std::vector<unsigned>(rTissue.mElementNodes.begin() + rTissue.mElementOffsets[element],
+                                                   rTissue.mElementNodes.begin() + rTissue.mElementOffsets[element + 1]));
+        }
+    }
+
+    /**
+     * Add a tissue of numX by numY unit squares, with the vertices not on the
+     * tissue boundary moved randomly by up to 0.2 in each direction, to a mesh.
+     * The cells are numbered row by row.
+     *
+     * @param numX the number of cells in the x direction
+     * @param numY the number of cells in the y direction
+     * @param rMesh the mesh
+     */
+    static void MakeSquareTissue(unsigned numX, unsigned numY, ObservedTissueMesh& rMesh)
+    {
+        AddToMesh(JitteredSquareTissue(numX, numY, 7u, 0.4, true), rMesh);
+    }
+
+public:
+
+    void TestNeighbourCorrelation()
+    {
+        std::vector<double> values = {1.0, 2.0, 3.0, 4.0, 100.0};
+        std::vector<bool> is_internal = {true, true, true, true, false};
+        std::vector<std::pair<unsigned, unsigned> > pairs = {{0, 1}, {1, 2}, {2, 3}};
+
+        double mean_value;
+        double value_variance;
+        NeighbourCorrelation::GetMeanAndVariance(values, is_internal, mean_value, value_variance);
+        TS_ASSERT_DELTA(mean_value, 2.5, 1e-12);
+        TS_ASSERT_DELTA(value_variance, 1.25, 1e-12);
+
+        // ((2 - 6.25) + (6 - 6.25) + (12 - 6.25))/(3*1.25)
+        TS_ASSERT_DELTA(NeighbourCorrelation::Calculate(values, is_internal, pairs), 1.0/3.0, 1e-12);
+
+        pairs.push_back(std::make_pair(3u, 5u));
+        TS_ASSERT_THROWS_CONTAINS(NeighbourCorrelation::Calculate(values, is_internal, pairs), "out of range");
+        is_internal.pop_back();
+        TS_ASSERT_THROWS_CONTAINS(NeighbourCorrelation::GetMeanAndVariance(values, is_internal, mean_value, value_variance),
+                                  "internal cell flags");
+    }
+
+    void TestGeometryAndTopology()
+    {
+        ObservedTissueMesh mesh;
+        MakeSquareTissue(4u, 4u, mesh);
+        TS_ASSERT_EQUALS(mesh.GetNumNodes(), 25u);
+        TS_ASSERT_EQUALS(mesh.GetNumElements(), 16u);
+
+        double total_area = 0.0;
+        for (unsigned element=0; element<mesh.GetNumElements(); element++)
+        {
+            TS_ASSERT_EQUALS(mesh.GetNumNodesInElement(element), 4u);
+            total_area += mesh.GetAreaOfElement(element);
+        }
+        TS_ASSERT_DELTA(total_area, 16.0, 1e-12);
+
+        // Only the middle 2 by 2 block of cells is away from the boundary
+        unsigned num_internal = 0;
+        for (unsigned element=0; element<mesh.GetNumElements(); element++)
+        {
+            unsigned i = element%4;
+            unsigned j = element/4;
+            bool expected_on_boundary = (i == 0 || j == 0 || i == 3 || j == 3);
+            TS_ASSERT_EQUALS(mesh.IsElementOnBoundary(element), expected_on_boundary);
+            num_internal += !expected_on_boundary;
+        }
+        TS_ASSERT_EQUALS(num_internal, 4u);
+
+        // Cells sharing a vertex are neighbours, including diagonally: 3 rows of 3
+        // horizontal pairs, 3 columns of 3 vertical pairs and 9 squares of 2 diagonal pairs
+        const std::vector<std::pair<unsigned, unsigned> >& r_pairs = mesh.rGetNeighbourPairs();
+        TS_ASSERT_EQUALS(r_pairs.size(), 12u + 12u + 18u);
+        for (unsigned i=0; i<r_pairs.size(); i++)
+        {
+            TS_ASSERT_LESS_THAN(r_pairs[i].first, r_pairs[i].second);
+            if (i > 0)
+            {
+                TS_ASSERT(r_pairs[i - 1] < r_pairs[i]);
+            }
+        }
+
+        // A unit square, given clockwise and closed
+        ObservedTissueMesh square;
+        square.AddNode(0.0, 0.0);
+        square.AddNode(0.0, 1.0);
+        square.AddNode(1.0, 1.0);
+        square.AddNode(1.0, 0.0);
+        TS_ASSERT_EQUALS(square.AddElement({0, 1, 2, 3, 0}), 0u);
+        TS_ASSERT_EQUALS(square.GetNumNodesInElement(0), 4u);
+        TS_ASSERT_DELTA(square.GetAreaOfElement(0), 1.0, 1e-12);
+        TS_ASSERT_DELTA(square.GetPerimeterOfElement(0), 4.0, 1e-12);
+        TS_ASSERT(square.IsElementOnBoundary(0));
+        TS_ASSERT(square.rGetNeighbourPairs().empty());
+
+        TS_ASSERT_THROWS_CONTAINS(square.AddElement({0, 1, 0}), "at least three vertices");
+        TS_ASSERT_THROWS_CONTAINS(square.AddElement({0, 1, 4}), "only 4 vertices");
+    }
+
+    void TestSummaryStatistics()
+    {
+        ObservedTissueMesh mesh;
+        MakeSquareTissue(6u, 5u, mesh);
+        TissueSummaryStatistics statistics = TissueSummaryStatistics::Calculate(mesh);
+
+        // Recalculate the statistics directly from their definitions
+        std::vector<double> areas;
+        std::vector<unsigned> internal_elements;
+        double perimeter_sum = 0.0;
+        for (unsigned element=0; element<mesh.GetNumElements(); element++)
+        {
+            if (!mesh.IsElementOnBoundary(element))
+            {
+                internal_elements.push_back(element);
+                areas.push_back(mesh.GetAreaOfElement(element));
+                perimeter_sum += mesh.GetPerimeterOfElement(element);
+            }
+        }
+        double mean_area = 0.0;
+        for (unsigned i=0; i<areas.size(); i++)
+        {
+            mean_area += areas[i]/areas.size();
+        }
+        double area_variance = 0.0;
+        for (unsigned i=0; i<areas.size(); i++)
+        {
+            area_variance += (areas[i] - mean_area)*(areas[i] - mean_area)/areas.size();
+        }
+
+        // Neighbouring internal cells of a grid of squares are those within one step in x and y
+        double correlation_sum = 0.0;
+        unsigned num_pairs = 0;
+        for (unsigned a=0; a<internal_elements.size(); a++)
+        {
+            for (unsigned b=a + 1; b<internal_elements.size(); b++)
+            {
+                int dx = int(internal_elements[a]%6) - int(internal_elements[b]%6);
+                int dy = int(internal_elements[a]/6) - int(internal_elements[b]/6);
+                if (std::abs(dx) <= 1 && std::abs(dy) <= 1)
+                {
+                    correlation_sum += (areas[a]*areas[b] - mean_area*mean_area)/area_variance;
+                    num_pairs++;
+                }
+            }
+        }
+
+        TS_ASSERT_EQUALS(statistics.mNumCells, 30.0);
+        TS_ASSERT_EQUALS(statistics.mNumInternalCells, 12.0);
+        TS_ASSERT_DELTA(statistics.mMeanArea, mean_area, 1e-12);
+        TS_ASSERT_DELTA(statistics.mAreaVariance, area_variance, 1e-12);
+        TS_ASSERT_DELTA(statistics.mMeanPerimeter, perimeter_sum/12.0, 1e-12);
+        TS_ASSERT_EQUALS(statistics.mMeanPolygonNumber, 4.0);
+        TS_ASSERT_EQUALS(statistics.mPolygonNumberVariance, 0.0);
+        TS_ASSERT_DELTA(statistics.mAreaCorrelation, correlation_sum/num_pairs, 1e-10);
+    }
+
+    void TestReadFromFiles()
+    {
+        ObservedTissueMesh mesh;
+        MakeSquareTissue(4u, 4u, mesh);
+
+        // Write the mesh in VertexMeshWriter format, indexed from one, with comments
+        OutputFileHandler handler("TestObservedTissueMesh");
+        std::string base = handler.GetOutputDirectoryFullPath() + "squares";
+        {
+            std::ofstream node_file((base + ".node").c_str());
+            node_file.precision(17);
+            node_file << mesh.GetNumNodes() << "\t2\t0\t1\n";
+            std::ofstream cell_file((base + ".cell").c_str());
+            cell_file << "# segmented by hand\n" << mesh.GetNumElements() << "\t0\n";
+
+            JitteredSquareTissue tissue(4u, 4u, 7u, 0.4, true);
+            for (unsigned i=0; i<tissue.GetNumNodes(); i++)
+            {
+                node_file << i + 1 << "\t" << tissue.mNodeLocations[2*i] << "\t" << tissue.mNodeLocations[2*i + 1] << "\t0\n";
+            }
+            for (unsigned j=0; j<4; j++)
+            {
+                for (unsigned i=0; i<4; i++)
+                {
+                    unsigned corner = j*5 + i + 1;
+                    cell_file << j*4 + i + 1 << "\t4\t" << corner << "\t" << corner + 1 << "\t"
+                              << corner + 6 << "\t" << corner + 5 << "\n";
+                }
+            }
+        }
+
+        ObservedTissueMesh read_mesh;
+        read_mesh.ReadFromFiles(base);
+        TS_ASSERT_EQUALS(read_mesh.GetNumNodes(), 25u);
+        TS_ASSERT_EQUALS(read_mesh.GetNumElements(), 16u);
+        TS_ASSERT_EQUALS(TissueSummaryStatistics::Calculate(read_mesh).ToString(),
+                         TissueSummaryStatistics::Calculate(mesh).ToString());
+
+        TS_ASSERT_THROWS_CONTAINS(read_mesh.ReadFromFiles(base + "_missing"), "Could not open vertex file");
+        {
+            std::ofstream cell_file((base + ".cell").c_str());
+            cell_file << "16\t0\n1\t4\t1\t2\n";
+        }
+        TS_ASSERT_THROWS_CONTAINS(read_mesh.ReadFromFiles(base), "Could not read the vertices of cell 0");
+    }
+
+    void TestAgreesWithVertexMesh()
+    {
+        // A relaxed Voronoi tessellation has cells of many sizes and polygon numbers
+        VoronoiVertexMeshGenerator generator(8, 8, 2);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        ObservedTissueMesh mesh;
+        for (unsigned node=0; node<p_mesh->GetNumNodes(); node++)
+        {
+            const c_vector<double, 2>& r_location = p_mesh->GetNode(node)->rGetLocation();
+            TS_ASSERT_EQUALS(mesh.AddNode(r_location[0], r_location[1]), node);
+        }
+        for (unsigned element=0; element<p_mesh->GetNumElements(); element++)
+        {
+            VertexElement<2,2>* p_element = p_mesh->GetElement(element);
+            std::vector<unsigned> node_indices;
+            for (unsigned local=0; local<p_element->GetNumNodes(); local++)
+            {
+                node_indices.push_back(p_element->GetNodeGlobalIndex(local));
+            }
+            TS_ASSERT_EQUALS(mesh.AddElement(node_indices), element);
+        }
+
+        // Geometry and boundary cells as VertexMesh has them
+        std::set<std::pair<unsigned, unsigned> > expected_pairs;
+        for (unsigned element=0; element<p_mesh->GetNumElements(); element++)
+        {
+            TS_ASSERT_DELTA(mesh.GetAreaOfElement(element), p_mesh->GetVolumeOfElement(element), 1e-10);
+            TS_ASSERT_DELTA(mesh.GetPerimeterOfElement(element), p_mesh->GetSurfaceAreaOfElement(element), 1e-10);
+            TS_ASSERT_EQUALS(mesh.IsElementOnBoundary(element), p_mesh->GetElement(element)->IsElementOnBoundary());
+
+            std::set<unsigned> neighbours = p_mesh->GetNeighbouringElementIndices(element);
+            for (std::set<unsigned>::iterator iter = neighbours.begin(); iter != neighbours.end(); ++iter)
+            {
+                expected_pairs.insert(std::make_pair(std::min(element, *iter), std::max(element, *iter)));
+            }
+        }
+
+        // Neighbours as VertexMesh has them
+        const std::vector<std::pair<unsigned, unsigned> >& r_pairs = mesh.rGetNeighbourPairs();
+        TS_ASSERT_EQUALS(r_pairs.size(), expected_pairs.size());
+        TS_ASSERT(std::vector<std::pair<unsigned, unsigned> >(expected_pairs.begin(), expected_pairs.end()) == r_pairs);
+
+        // And so the same statistics as a simulated tissue
+        std::vector<CellPtr> cells;
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements(), std::vector<unsigned>(), p_diff_type);
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+
+        std::vector<double> observed = TissueSummaryStatistics::Calculate(mesh).ToVector();
+        std::vector<double> simulated = TissueSummaryStatistics::Calculate(&cell_population).ToVector();
+        TS_ASSERT_LESS_THAN(0.0, simulated[6]); // the polygon numbers do vary
+
+        // The last statistic, the neighbour number correlation, is estimated by the
+        // polygon number correlation for observed tissues, so it is not compared
+        for (unsigned i=0; i+1<observed.size(); i++)
+        {
+            TS_ASSERT_DELTA(observed[i], simulated[i], 1e-10*std::max(1.0, std::fabs(simulated[i])));
+        }
+    }
+
+    void TestLargeTissue()
+    {
+        // 40000 cells, as in a large segmented image
+        ObservedTissueMesh mesh;
+        MakeSquareTissue(200u, 200u, mesh);
+        TissueSummaryStatistics statistics = TissueSummaryStatistics::Calculate(mesh);
+        TS_ASSERT_EQUALS(statistics.mNumCells, 40000.0);
+        TS_ASSERT_EQUALS(statistics.mNumInternalCells, 198.0*198.0);
+        TS_ASSERT_DELTA(statistics.mMeanArea, 1.0, 0.01);
+        TS_ASSERT_EQUALS(mesh.rGetNeighbourPairs().size(), 2u*200u*199u + 2u*199u*199u);
+    }
+};
+
+#endif /*TESTOBSERVEDTISSUEMESH_HPP_*/
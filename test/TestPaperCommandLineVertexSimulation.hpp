@@ -39,50 +39,18 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <cxxtest/TestSuite.h>
 #include "CheckpointArchiveTypes.hpp"
 #include "AbstractCellBasedTestSuite.hpp"
-
-#include "OffLatticeSimulation.hpp"
-#include "TargetAreaLinearGrowthModifier.hpp"
-#include "FarhadifarForce.hpp"
 #include "PetscSetupAndFinalize.hpp"
-#include "FixedSequenceCellCycleModel.hpp"
-#include "TransitCellProliferativeType.hpp"
-#include "CellDataItemWriter.hpp"
-#include "CellPropertyRegistry.hpp"
-#include "SmartPointers.hpp"
-#include "WildTypeCellMutationState.hpp"
-
-#include "ForwardEulerNumericalMethod.hpp"
-
-#include "VertexModelDataWriter.hpp"
-#include "CellProliferativePhasesWriter.hpp"
-#include "CellAgesWriter.hpp"
-#include "CellEdgeCountWriter.hpp"
-#include "CellPerimeterWriter.hpp"
-
-//#include "CellForcesWriter.hpp"
-#include "FarhadifarForceWriter.hpp"
-#include "PolygonNumberCorrelationWriter.hpp"
-#include "AreaCorrelationWriter.hpp"
-#include "NeighbourNumberCorrelationWriter.hpp"
-#include "VertexEdgeLengthWriter.hpp"
-
-//#include "RK4NumericalMethod.hpp"
-#include "ModifiedVertexBasedCellPopulation.hpp"
-#include "CellsGenerator.hpp"
-#include "CellCycleTimesGenerator.hpp"
-#include "ExtendedHoneycombVertexMeshGenerator.hpp"
-#include "FasterMutableVertexMesh.hpp"
 
 #include "CommandLineArguments.hpp"
-
-
+#include "PaperVertexSimulation.hpp"
+#include "SimulationWorkerPool.hpp"
+#include "SweepRunner.hpp"
 
 /**
  * These tests check and demonstrate simulation of vertex based models with edge  Srn models
  */
 class TestPaperCommandLineSpeedSimulation : public AbstractCellBasedTestSuite
 {
-  
 public:
 
     /*
@@ -92,160 +60,54 @@ public:
     {   
         /* We include the next line because Vertex simulations cannot be run in parallel */
         EXIT_IF_PARALLEL;
-        double outp1 = CommandLineArguments::Instance()->GetDoubleCorrespondingToOption("-opt1"); // Our Lambda value
-        double outp2 = CommandLineArguments::Instance()->GetDoubleCorrespondingToOption("-opt2"); // Our Gamma Value  
-
-        double number1 = std::stod(CommandLineArguments::Instance()->GetStringCorrespondingToOption("-opt4"));
-        double number2 = std::stod(CommandLineArguments::Instance()->GetStringCorrespondingToOption("-opt3"));  
-        double number3 = std::stod(CommandLineArguments::Instance()->GetStringCorrespondingToOption("-opt5"));
-        
-        //std::cout << "Random number" << number3 << "\n";
-
-        int mRandomSeed = (number1 + number2)*number3;
-        //double mDt = 0.01; 
-        unsigned mNumberGenerations = 7u; //o
-        double mAverageCellCycleTime = 20.0; // o
-        //double mEndTime = 4.0*7.0*100.0;
-        double mNewEdgeLengthFactor = 1.5; // o
-        bool mRestrictVertexMovement = true; // o
-        bool mRandomiseT1SwapOrder = false;
-        //unsigned mSamplingTimestepMultiple = 0u;
-        double mT1SwapThreshold = 0.01;   // o
-        double mT2SwapThreshold = 0.001;  // o
-        unsigned mInitialSize = 2u; // o
-        double mLineTensionParameter = outp1; // o // Lambda -0.85, 0.0 , 0.12
-        double mPerimeterContractilityParameter = outp2; // o   // Gamma 0.1 , 0.1 , 0.04
-        double mBoundaryTensionParameter = mLineTensionParameter; // o  
-        //bool mUseRungeKuttaMethod = false; //o
-        
-        CellCycleTimesGenerator* p_cell_cycle_times_generator = CellCycleTimesGenerator::Instance();
-
-        if(mRandomSeed == 0u)
-     	{
-	      p_cell_cycle_times_generator->SetRandomSeed( time(NULL) );
-	    }
-	    else
-	    {
-		  p_cell_cycle_times_generator->SetRandomSeed( mRandomSeed );
-    	}
-        p_cell_cycle_times_generator->SetRate(3.0/(2.0*mAverageCellCycleTime));
-        p_cell_cycle_times_generator->GenerateCellCycleTimeSequence();
-
-        /* First we create a regular vertex mesh. */
-        ExtendedHoneycombVertexMeshGenerator generator(mInitialSize, mInitialSize, false, mT1SwapThreshold, mT2SwapThreshold, 1.0);
-        FasterMutableVertexMesh<2, 2>* p_mesh = generator.GetMesh();
-        p_mesh->SetRandomizeT1SwapOrderBoolean( mRandomiseT1SwapOrder );
-
-        p_mesh->SetCellRearrangementRatio(mNewEdgeLengthFactor);
-        p_mesh->SetCheckForInternalIntersections(false);
-        p_mesh->SetCheckForT3Swaps(true);
-
-
-        std::vector<CellPtr> cells;
-        MAKE_PTR(WildTypeCellMutationState, p_state);
-        MAKE_PTR(TransitCellProliferativeType, p_diff_type);
-
-        for (unsigned elem_index=0; elem_index < p_mesh->GetNumElements(); elem_index++)
-        {
-            /* Initalise cell cycle */
-            FixedSequenceCellCycleModel* p_cc_model = new FixedSequenceCellCycleModel();
-            //UniformG1GenerationalCellCycleModel* p_cc_model = new UniformG1GenerationalCellCycleModel();
-            p_cc_model->SetDimension(2);
-            p_cc_model->SetG2Duration((1.0/3.0)*mAverageCellCycleTime);
-            p_cc_model->SetMDuration(1e-12);
-            p_cc_model->SetSDuration(1e-12);
-            p_cc_model->SetMaxTransitGenerations(mNumberGenerations);
-
-            CellPtr p_cell(new Cell(p_state, p_cc_model));
-            p_cell->SetCellProliferativeType(p_diff_type);
-
-            
-            //double birth_time = -RandomNumberGenerator::Instance()->ranf()*12.0;
-            double birth_time = 0.0;
-            p_cell->SetBirthTime(birth_time);
-            cells.push_back(p_cell);
-        }
+        CommandLineArguments* p_args = CommandLineArguments::Instance();
 
-        /* Using the vertex mesh and cells, we create a cell-based population object, and specify which results to
-         * output to file. */
-        ModifiedVertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
-
-        cell_population.SetRestrictVertexMovementBoolean(mRestrictVertexMovement);
-
-        // Cell writers
-        cell_population.AddCellWriter<VertexModelDataWriter>();
-        cell_population.AddCellWriter<CellProliferativePhasesWriter>();
-        cell_population.AddCellWriter<CellAgesWriter>();
-        cell_population.AddCellWriter<CellEdgeCountWriter>();
-        cell_population.AddCellWriter<CellPerimeterWriter>();
-        
-        // Cell Population Writers
-        cell_population.AddCellPopulationCountWriter<FarhadifarForceWriter>();
-        //cell_population.AddCellPopulationCountWriter<CellForcesWriter>(); //TODO
-        cell_population.AddCellPopulationCountWriter<AreaCorrelationWriter>();
-        cell_population.AddCellPopulationCountWriter<PolygonNumberCorrelationWriter>(); //TODO
-        cell_population.AddCellPopulationCountWriter<NeighbourNumberCorrelationWriter>();
-        cell_population.AddPopulationWriter<VertexEdgeLengthWriter>(); 
-
-        //cell_population.rGetMesh().SetCellRearrangementThreshold(0.2);
-
-        cell_population.SetWriteCellVtkResults(false);
-        cell_population.SetWriteEdgeVtkResults(false);
-
-        CellPtr p_cell_0b = cell_population.GetCellUsingLocationIndex(3);
-        
-        double initial_target_area = 1.0;  
-
-        
-        for (typename AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
-                cell_iter != cell_population.End();
-                ++cell_iter)
-        {
-            // target areas
-            cell_iter->GetCellData()->SetItem("target area", initial_target_area);
-        }
+        double outp1 = p_args->GetDoubleCorrespondingToOption("-opt1"); // Our Lambda value
+        double outp2 = p_args->GetDoubleCorrespondingToOption("-opt2"); // Our Gamma Value
 
-        //double actual_end_time = (mAverageCellCycleTime * mNumberGenerations)*4.0;
-        double actual_end_time = 700.0;
-        
-        /* We are now in a position to create and configure the cell-based simulation object, pass a force law to it,
-         * and run the simulation. */
-        OffLatticeSimulation<2> simulator(cell_population);
-
-        simulator.SetOutputDirectory("TestBayesianCommandLineRun2/_Sim_Number_"+CommandLineArguments::Instance()->GetStringCorrespondingToOption("-opt4")+"Lambda__"+CommandLineArguments::Instance()->GetStringCorrespondingToOption("-opt1")+"_Gamma_"+CommandLineArguments::Instance()->GetStringCorrespondingToOption("-opt2")+"_Run_"+CommandLineArguments::Instance()->GetStringCorrespondingToOption("-opt3")+"");
-        simulator.SetSamplingTimestepMultiple(200);
-        simulator.SetDt(0.005);
-        simulator.SetEndTime(actual_end_time);
-
-        MAKE_PTR(FarhadifarForce<2>, p_force);
-
-        p_force->SetPerimeterContractilityParameter(mPerimeterContractilityParameter); // Gamma 0.1 , 0.1 , 0.04
-        p_force->SetLineTensionParameter(mLineTensionParameter); // Lambda -0.85, 0.0 , 0.12
-        // If our Line tension parameter is negative in the bulk we need to set it to zero at the boundary
-        // This is to prevent non-physical behaviour from occuring
-        if(mLineTensionParameter < 0){
-                    p_force->SetBoundaryLineTensionParameter(0.0);
-        } else {
-            p_force->SetBoundaryLineTensionParameter(mBoundaryTensionParameter);
-        }
-        simulator.AddForce(p_force);
+        double number1 = std::stod(p_args->GetStringCorrespondingToOption("-opt4"));
+        double number2 = std::stod(p_args->GetStringCorrespondingToOption("-opt3"));
+        // -opt5 identifies the sweep; the seed of each run is derived from it, see SweepTask::DeriveSeed()
+        unsigned sweep_id = (unsigned)std::stoul(p_args->GetStringCorrespondingToOption("-opt5"));
 
-        MAKE_PTR(TargetAreaLinearGrowthModifier<2>, p_growth_modifier);
-        simulator.AddSimulationModifier(p_growth_modifier);
+        PaperVertexSimulationParameters parameters;
+        parameters.mLineTensionParameter = outp1; // Lambda -0.85, 0.0 , 0.12
+        parameters.mPerimeterContractilityParameter = outp2; // Gamma 0.1 , 0.1 , 0.04
 
-        // Pass an adaptive numerical method to the simulation
-        boost::shared_ptr<AbstractNumericalMethod<2,2> > p_method(new ForwardEulerNumericalMethod<2,2>());
-        p_method->SetUseAdaptiveTimestep(true);
-        simulator.SetNumericalMethod(p_method);
+        // Pass -runs <R> to run R runs, starting from run -opt3, in this process, and
+        // -workers <W> to run up to W of them at once (by default one per core)
+        unsigned num_runs = p_args->OptionExists("-runs") ? p_args->GetUnsignedCorrespondingToOption("-runs") : 1u;
+        unsigned num_workers = p_args->OptionExists("-workers") ? p_args->GetUnsignedCorrespondingToOption("-workers") : 0u;
 
-        //MAKE_PTR(VertexBoundaryRefinementModifier<2>, refinement_modifier);
-        //refinement_modifier->SetMaxEdgeLength(2.0);
-        //refinement_modifier->SetMinEdgeLength(0.1);
-        //simulator.AddSimulationModifier(refinement_modifier);
+        // Options such as -compress, -store <file.h5>, -resume and -cache <directory> are
+        // described in SweepRunner::SetOptionsFromCommandLine()
+        SweepRunner runner(parameters, "TestBayesianCommandLineRun2");
+        runner.SetOptionsFromCommandLine();
 
+        std::vector<SweepTask> tasks;
+        for (unsigned i=0; i<num_runs; i++)
+        {
+            unsigned simulation = (unsigned)number1;
+            unsigned run = (unsigned)number2 + i;
+            tasks.push_back(SweepTask(outp1, outp2, simulation, run, SweepTask::DeriveSeed(sweep_id, simulation, run)));
+        }
 
-        simulator.Solve();
-
+        if (num_runs == 1)
+        {
+            std::cout << tasks[0].GetName() << " " << runner.RunToString(tasks[0]) << "\n";
+        }
+        else
+        {
+            SimulationWorkerPool pool(num_workers);
+            std::vector<SimulationWorkerPool::Result> results =
+                    pool.Run(num_runs, [&](unsigned i) { return runner.RunToString(tasks[i]); });
+
+            for (unsigned i=0; i<num_runs; i++)
+            {
+                std::cout << tasks[i].GetName() << " " << results[i].mOutput << "\n";
+                TS_ASSERT(results[i].mSucceeded);
+            }
+        }
     }
 
 };
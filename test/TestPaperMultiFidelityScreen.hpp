@@ -0,0 +1,138 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef TESTPAPERMULTIFIDELITYSCREEN_HPP_
+#define TESTPAPERMULTIFIDELITYSCREEN_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include "AbstractCellBasedTestSuite.hpp"
+#include "PetscSetupAndFinalize.hpp"
+
+#include <fstream>
+#include "CommandLineArguments.hpp"
+#include "MultiFidelityScreen.hpp"
+#include "OutputFileHandler.hpp"
+#include "PaperVertexSimulation.hpp"
+#include "SweepRunner.hpp"
+#include "SweepFarm.hpp"
+
+/**
+ * Runs a parameter sweep in two stages, as an MPI task farm, e.g.
+ *
+ *   mpirun -np 64 TestPaperMultiFidelityScreen -csv ExampleCommandLineCSV.csv -sweep_id 17 -target target.txt
+ *
+ * The file given by -target holds the summary statistics to aim for, on one line
+ * in the form written by TissueSummaryStatistics::ToString() (e.g. the Statistics
+ * line of a RunComplete.manifest). First, one run of each row of the CSV file is
+ * simulated with the cheap parameters of MultiFidelityScreen::GetScreeningParameters()
+ * (set with -screen_generations, -screen_end_time and -screen_dt) and scored against
+ * the target. Then all the runs of the best -fraction (default 0.2) of the rows are
+ * simulated in full. The results of the two stages are written to ScreeningResults.csv
+ * and SweepResults.csv in the TestBayesianMultiFidelity output directory. The options of
+ * SweepRunner::SetOptionsFromCommandLine() apply to both stages.
+ */
+class TestPaperMultiFidelityScreen : public AbstractCellBasedTestSuite
+{
+public:
+
+    void TestRunTwoStageSweep()
+    {
+        CommandLineArguments* p_args = CommandLineArguments::Instance();
+
+        std::string csv_path = p_args->GetStringCorrespondingToOption("-csv");
+        unsigned sweep_id = p_args->OptionExists("-sweep_id") ? p_args->GetUnsignedCorrespondingToOption("-sweep_id") : 1u;
+        std::vector<SweepTask> tasks = SweepTask::ReadSweepFile(csv_path, sweep_id);
+
+        std::ifstream target_file(p_args->GetStringCorrespondingToOption("-target").c_str());
+        std::string target_line;
+        std::getline(target_file, target_line);
+        TissueSummaryStatistics target = TissueSummaryStatistics::FromString(target_line);
+
+        double fraction = p_args->OptionExists("-fraction") ? p_args->GetDoubleCorrespondingToOption("-fraction") : 0.2;
+        MultiFidelityScreen screen(tasks, target, fraction);
+
+        PaperVertexSimulationParameters parameters;
+        PaperVertexSimulationParameters screening_parameters = MultiFidelityScreen::GetScreeningParameters(
+                parameters,
+                p_args->OptionExists("-screen_generations") ? p_args->GetUnsignedCorrespondingToOption("-screen_generations") : 4u,
+                p_args->OptionExists("-screen_end_time") ? p_args->GetDoubleCorrespondingToOption("-screen_end_time") : 200.0,
+                p_args->OptionExists("-screen_dt") ? p_args->GetDoubleCorrespondingToOption("-screen_dt") : 0.01);
+
+        OutputFileHandler handler("TestBayesianMultiFidelity", false);
+
+        // Stage one: the cheap screening runs, whose results every process needs to choose stage two
+        SweepRunner screening_runner(screening_parameters, "TestBayesianMultiFidelity/Screening");
+        screening_runner.SetOptionsFromCommandLine();
+
+        std::vector<SweepTask> screening_tasks = screen.GetScreeningTasks();
+        SweepFarm screening_farm(screening_tasks);
+        screening_farm.Run([&](const SweepTask& rTask) { return screening_runner.RunToString(rTask); });
+        screening_farm.BroadcastResults();
+
+        std::vector<TissueSummaryStatistics> statistics(screening_tasks.size());
+        std::vector<bool> succeeded(screening_tasks.size());
+        for (unsigned i=0; i<screening_tasks.size(); i++)
+        {
+            const SweepFarm::Result& r_result = screening_farm.rGetResults()[i];
+            succeeded[i] = r_result.mSucceeded;
+            if (r_result.mSucceeded)
+            {
+                statistics[i] = TissueSummaryStatistics::FromString(r_result.mOutput);
+            }
+        }
+        screen.SetScreeningResults(statistics, succeeded);
+
+        // Stage two: the full runs of the parameter sets that passed the screen
+        SweepRunner runner(parameters, "TestBayesianMultiFidelity");
+        runner.SetOptionsFromCommandLine();
+
+        std::vector<SweepTask> selected_tasks = screen.GetSelectedTasks();
+        SweepFarm farm(selected_tasks);
+        farm.Run([&](const SweepTask& rTask) { return runner.RunToString(rTask); });
+        farm.WriteResults(handler.GetOutputDirectoryFullPath() + "SweepResults.csv", TissueSummaryStatistics::GetNames());
+
+        if (PetscTools::AmMaster())
+        {
+            screen.WriteScreeningResults(handler.GetOutputDirectoryFullPath() + "ScreeningResults.csv");
+            std::cout << selected_tasks.size() << " of " << tasks.size() << " runs passed the screen\n";
+
+            for (unsigned i=0; i<selected_tasks.size(); i++)
+            {
+                TS_ASSERT(farm.rGetResults()[i].mSucceeded);
+            }
+        }
+    }
+};
+
+#endif /*TESTPAPERMULTIFIDELITYSCREEN_HPP_*/
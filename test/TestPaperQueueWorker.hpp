@@ -0,0 +1,173 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTPAPERQUEUEWORKER_HPP_
+#define TESTPAPERQUEUEWORKER_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+#include "AbstractCellBasedTestSuite.hpp"
+#include "PetscSetupAndFinalize.hpp"
+
+#include "CommandLineArguments.hpp"
+#include "OutputFileHandler.hpp"
+#include "PaperVertexSimulation.hpp"
+#include "SweepRunner.hpp"
+#include "SweepQueueClient.hpp"
+#include "SweepQueueServer.hpp"
+#include "SweepWorkQueue.hpp"
+
+/**
+ * A sweep worker: leases runs from a SweepQueueServerApp and runs them until
+ * the sweep has finished, e.g.
+ *
+ *   SweepQueueServerApp ExampleCommandLineCSV.csv /tmp/sweep.sock sweep_done.txt 17 &
+ *   for ((i = 0; i < 8; i++)); do TestPaperQueueWorker -queue /tmp/sweep.sock & done
+ *
+ * The summary statistics of each run are sent back to the server, which records
+ * them in its completion file. The options of SweepRunner::SetOptionsFromCommandLine()
+ * (-compress, -store, -resume, -cache) apply to the simulations.
+ *
+ * Without -queue, the test serves a small sweep of short runs itself and checks
+ * that a worker runs all of them and that the server records their results.
+ */
+class TestPaperQueueWorker : public AbstractCellBasedTestSuite
+{
+public:
+
+    void TestRunQueuedTasks()
+    {
+        /* Each worker is a serial process; start as many workers as there are cores */
+        EXIT_IF_PARALLEL;
+        CommandLineArguments* p_args = CommandLineArguments::Instance();
+        if (!p_args->OptionExists("-queue"))
+        {
+            return;
+        }
+
+        PaperVertexSimulationParameters parameters;
+        SweepRunner runner(parameters, "TestBayesianQueueSweep");
+        runner.SetOptionsFromCommandLine();
+
+        SweepQueueClient client(p_args->GetStringCorrespondingToOption("-queue"));
+        unsigned num_tasks_run = client.RunTasks([&](const SweepTask& rTask) { return runner.RunToString(rTask); });
+        std::cout << client.rGetWorkerName() << " ran " << num_tasks_run << " runs" << std::endl;
+    }
+
+    void TestServeAndRunSmallSweep()
+    {
+        EXIT_IF_PARALLEL;
+        if (CommandLineArguments::Instance()->OptionExists("-queue"))
+        {
+            return;
+        }
+
+        PaperVertexSimulationParameters parameters;
+        parameters.mEndTime = 2.0;
+        parameters.mSamplingTimestepMultiple = 100u;
+        SweepRunner runner(parameters, "TestPaperQueueWorker");
+
+        std::vector<SweepTask> tasks;
+        tasks.push_back(SweepTask(0.12, 0.04, 1u, 1u, 11u));
+        tasks.push_back(SweepTask(0.12, 0.04, 1u, 2u, 12u));
+        tasks.push_back(SweepTask(0.0, 0.1, 2u, 1u, 13u));
+
+        OutputFileHandler handler("TestPaperQueueWorker");
+        std::string completion_path = handler.GetOutputDirectoryFullPath() + "completion.txt";
+
+        // Socket paths are limited to about 100 characters, so this one is kept short
+        std::string socket_path = "/tmp/TestPaperQueueWorker_" + std::to_string(getpid()) + ".sock";
+
+        SweepWorkQueue queue(tasks, completion_path);
+        SweepQueueServer server(queue, socket_path);
+        std::thread server_thread([&]() { server.Serve(); });
+
+        std::map<std::string, std::string> outputs;
+        SweepQueueClient client(socket_path, 1.0);
+        unsigned num_tasks_run = client.RunTasks([&](const SweepTask& rTask)
+        {
+            std::string output = runner.RunToString(rTask);
+            outputs[rTask.GetName()] = output;
+            return output;
+        });
+        server_thread.join();
+
+        TS_ASSERT_EQUALS(num_tasks_run, tasks.size());
+        TS_ASSERT_EQUALS(outputs.size(), tasks.size());
+        TS_ASSERT(queue.IsFinished());
+        TS_ASSERT_EQUALS(queue.GetNumTasks(SweepWorkQueue::SUCCEEDED), tasks.size());
+        TS_ASSERT_EQUALS(queue.GetNumTasks(SweepWorkQueue::FAILED), 0u);
+
+        // Each run is in the completion file once, with the statistics the worker sent
+        std::ifstream completion_file(completion_path.c_str());
+        std::string line;
+        unsigned num_lines = 0;
+        while (std::getline(completion_file, line))
+        {
+            std::istringstream fields(line);
+            std::string index, name, state, attempts, output;
+            std::getline(fields, index, '\t');
+            std::getline(fields, name, '\t');
+            std::getline(fields, state, '\t');
+            std::getline(fields, attempts, '\t');
+            std::getline(fields, output);
+
+            TS_ASSERT_EQUALS(name, tasks[std::stoi(index)].GetName());
+            TS_ASSERT_EQUALS(state, "succeeded");
+            TS_ASSERT_EQUALS(attempts, "1");
+            TS_ASSERT_EQUALS(outputs.count(name), 1u);
+
+            // The completion file keeps each output on one line
+            std::string expected = outputs[name];
+            for (unsigned i=0; i<expected.size(); i++)
+            {
+                if (expected[i] == '\t' || expected[i] == '\n' || expected[i] == '\r')
+                {
+                    expected[i] = ' ';
+                }
+            }
+            TS_ASSERT(!expected.empty());
+            TS_ASSERT_EQUALS(output, expected);
+            num_lines++;
+        }
+        TS_ASSERT_EQUALS(num_lines, tasks.size());
+    }
+};
+
+#endif /*TESTPAPERQUEUEWORKER_HPP_*/
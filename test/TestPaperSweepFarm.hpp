@@ -0,0 +1,92 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTPAPERSWEEPFARM_HPP_
+#define TESTPAPERSWEEPFARM_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include "AbstractCellBasedTestSuite.hpp"
+#include "PetscSetupAndFinalize.hpp"
+
+#include "CommandLineArguments.hpp"
+#include "OutputFileHandler.hpp"
+#include "PaperVertexSimulation.hpp"
+#include "SweepRunner.hpp"
+#include "SweepFarm.hpp"
+
+/**
+ * Runs a whole parameter sweep as an MPI task farm, e.g.
+ *
+ *   mpirun -np 64 TestPaperSweepFarm -csv ExampleCommandLineCSV.csv -sweep_id 17
+ *
+ * Every row of the CSV file is expanded into its runs, and the runs are handed
+ * out to the processes as they become free. The summary statistics of all runs
+ * are written to SweepResults.csv in the TestBayesianSweepFarm output directory.
+ * The options of SweepRunner::SetOptionsFromCommandLine() (-compress, -store,
+ * -resume, -cache) apply to the simulations.
+ */
+class TestPaperSweepFarm : public AbstractCellBasedTestSuite
+{
+public:
+
+    void TestRunSweepAsTaskFarm()
+    {
+        CommandLineArguments* p_args = CommandLineArguments::Instance();
+
+        std::string csv_path = p_args->GetStringCorrespondingToOption("-csv");
+        unsigned sweep_id = p_args->OptionExists("-sweep_id") ? p_args->GetUnsignedCorrespondingToOption("-sweep_id") : 1u;
+        std::vector<SweepTask> tasks = SweepTask::ReadSweepFile(csv_path, sweep_id);
+
+        PaperVertexSimulationParameters parameters;
+        SweepRunner runner(parameters, "TestBayesianSweepFarm");
+        runner.SetOptionsFromCommandLine();
+
+        OutputFileHandler handler("TestBayesianSweepFarm", false);
+
+        SweepFarm farm(tasks);
+        farm.Run([&](const SweepTask& rTask) { return runner.RunToString(rTask); });
+        farm.WriteResults(handler.GetOutputDirectoryFullPath() + "SweepResults.csv", TissueSummaryStatistics::GetNames());
+
+        if (PetscTools::AmMaster())
+        {
+            for (unsigned i=0; i<tasks.size(); i++)
+            {
+                TS_ASSERT(farm.rGetResults()[i].mSucceeded);
+            }
+        }
+    }
+};
+
+#endif /*TESTPAPERSWEEPFARM_HPP_*/
@@ -0,0 +1,152 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef TESTPAPERSYNTHETICLIKELIHOODMCMC_HPP_
+#define TESTPAPERSYNTHETICLIKELIHOODMCMC_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include "AbstractCellBasedTestSuite.hpp"
+#include "PetscSetupAndFinalize.hpp"
+
+#include <fstream>
+#include "CommandLineArguments.hpp"
+#include "OutputFileHandler.hpp"
+#include "PaperVertexSimulation.hpp"
+#include "ParameterDesign.hpp"
+#include "SimulationWorkerPool.hpp"
+#include "SweepRunner.hpp"
+#include "SyntheticLikelihoodMcmc.hpp"
+
+/**
+ * Samples the posterior of (Lambda, Gamma) given observed summary statistics
+ * with synthetic likelihood MCMC, e.g.
+ *
+ *   TestPaperSyntheticLikelihoodMcmc -observed observed.txt -chains 4 -replicates 8 -iterations 200
+ *
+ * The file given by -observed holds the observed statistics on one line, in the
+ * form of the Statistics line of a RunComplete.manifest; statistics given as nan
+ * are not used. The chains start from a Sobol design over the prior box. At each
+ * iteration the replicate runs of all chains' proposals are simulated at once by
+ * a SimulationWorkerPool (-workers, by default one per core). The samples are
+ * written to McmcSamples.csv in the TestBayesianSyntheticLikelihood output directory.
+ * The options of SweepRunner::SetOptionsFromCommandLine() apply to the simulations.
+ */
+class TestPaperSyntheticLikelihoodMcmc : public AbstractCellBasedTestSuite
+{
+public:
+
+    void TestSampleWithSyntheticLikelihood()
+    {
+        EXIT_IF_PARALLEL;
+        CommandLineArguments* p_args = CommandLineArguments::Instance();
+
+        std::ifstream observed_file(p_args->GetStringCorrespondingToOption("-observed").c_str());
+        std::string observed_line;
+        std::getline(observed_file, observed_line);
+        SyntheticLikelihood likelihood(TissueSummaryStatistics::FromString(observed_line).ToVector());
+
+        unsigned num_chains = p_args->OptionExists("-chains") ? p_args->GetUnsignedCorrespondingToOption("-chains") : 4u;
+        unsigned num_replicates = p_args->OptionExists("-replicates") ? p_args->GetUnsignedCorrespondingToOption("-replicates") : 8u;
+        unsigned num_iterations = p_args->OptionExists("-iterations") ? p_args->GetUnsignedCorrespondingToOption("-iterations") : 200u;
+        unsigned num_workers = p_args->OptionExists("-workers") ? p_args->GetUnsignedCorrespondingToOption("-workers") : 0u;
+        unsigned sweep_id = p_args->OptionExists("-sweep_id") ? p_args->GetUnsignedCorrespondingToOption("-sweep_id") : 1u;
+
+        ParameterDesign design;
+        design.AddSobolSequence(num_chains);
+        SyntheticLikelihoodMcmc mcmc(likelihood, design.rGetPoints(), num_replicates, sweep_id);
+        const std::vector<double> lower_bounds = {-1.0, 0.0};
+        const std::vector<double> upper_bounds = {0.2, 0.5};
+        mcmc.SetPriorBounds(lower_bounds, upper_bounds);
+
+        PaperVertexSimulationParameters parameters;
+        SweepRunner runner(parameters, "TestBayesianSyntheticLikelihood");
+        runner.SetOptionsFromCommandLine();
+        SimulationWorkerPool pool(num_workers);
+
+        mcmc.Run(num_iterations, [&](const std::vector<SweepTask>& rTasks)
+        {
+            std::vector<SimulationWorkerPool::Result> results =
+                    pool.Run(rTasks.size(), [&](unsigned i) { return runner.RunToString(rTasks[i]); });
+
+            std::vector<std::string> statistics(rTasks.size());
+            for (unsigned i=0; i<rTasks.size(); i++)
+            {
+                if (results[i].mSucceeded)
+                {
+                    statistics[i] = results[i].mOutput;
+                }
+                else
+                {
+                    std::cout << rTasks[i].GetName() << " failed: " << results[i].mOutput << "\n";
+                }
+            }
+            return statistics;
+        });
+
+        OutputFileHandler handler("TestBayesianSyntheticLikelihood", false);
+        mcmc.WriteSamples(handler.GetOutputDirectoryFullPath() + "McmcSamples.csv");
+        std::cout << "Acceptance rate " << mcmc.GetAcceptanceRate() << "\n";
+
+        // Every chain has a state for its starting point and for each iteration
+        const std::vector<SyntheticLikelihoodMcmc::Sample>& r_samples = mcmc.rGetSamples();
+        TS_ASSERT_EQUALS(r_samples.size(), num_chains*(num_iterations + 1));
+        std::vector<unsigned> num_samples_per_chain(num_chains, 0u);
+        for (unsigned i=0; i<r_samples.size(); i++)
+        {
+            const SyntheticLikelihoodMcmc::Sample& r_sample = r_samples[i];
+            TS_ASSERT_LESS_THAN(r_sample.mChain, num_chains);
+            TS_ASSERT_LESS_THAN_EQUALS(r_sample.mIteration, num_iterations);
+            if (r_sample.mChain < num_chains)
+            {
+                num_samples_per_chain[r_sample.mChain]++;
+            }
+
+            // Proposals outside the prior box are never accepted
+            TS_ASSERT_LESS_THAN_EQUALS(lower_bounds[0], r_sample.mLambda);
+            TS_ASSERT_LESS_THAN_EQUALS(r_sample.mLambda, upper_bounds[0]);
+            TS_ASSERT_LESS_THAN_EQUALS(lower_bounds[1], r_sample.mGamma);
+            TS_ASSERT_LESS_THAN_EQUALS(r_sample.mGamma, upper_bounds[1]);
+            TS_ASSERT(!(r_sample.mIteration == 0 && r_sample.mAccepted));
+        }
+        for (unsigned chain=0; chain<num_chains; chain++)
+        {
+            TS_ASSERT_EQUALS(num_samples_per_chain[chain], num_iterations + 1);
+        }
+
+        TS_ASSERT_LESS_THAN_EQUALS(0.0, mcmc.GetAcceptanceRate());
+        TS_ASSERT_LESS_THAN_EQUALS(mcmc.GetAcceptanceRate(), 1.0);
+    }
+};
+
+#endif /*TESTPAPERSYNTHETICLIKELIHOODMCMC_HPP_*/
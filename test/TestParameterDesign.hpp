@@ -0,0 +1,170 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef TESTPARAMETERDESIGN_HPP_
+#define TESTPARAMETERDESIGN_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <algorithm>
+#include <cmath>
+#include "FakePetscSetup.hpp"
+#include "Exception.hpp"
+#include "GaussianProcessEmulator.hpp"
+#include "OutputFileHandler.hpp"
+#include "ParameterDesign.hpp"
+#include "SweepTask.hpp"
+
+class TestParameterDesign : public CxxTest::TestSuite
+{
+public:
+
+    void TestSpaceFillingDesigns()
+    {
+        // Every interval of every parameter holds exactly one point of a Latin hypercube
+        std::vector<std::vector<double> > hypercube = ParameterDesign::GetLatinHypercube(20u, 3u, 5u);
+        TS_ASSERT_EQUALS(hypercube.size(), 20u);
+        for (unsigned d=0; d<3; d++)
+        {
+            std::vector<unsigned> count(20, 0u);
+            for (unsigned i=0; i<20; i++)
+            {
+                count[(unsigned)(hypercube[i][d]*20)]++;
+            }
+            TS_ASSERT_EQUALS(*std::min_element(count.begin(), count.end()), 1u);
+        }
+
+        // The first points of the two-dimensional Sobol sequence
+        std::vector<std::vector<double> > sobol = ParameterDesign::GetSobolSequence(4u, 2u);
+        TS_ASSERT_DELTA(sobol[0][0], 0.5, 1e-12);
+        TS_ASSERT_DELTA(sobol[0][1], 0.5, 1e-12);
+        TS_ASSERT_DELTA(sobol[1][0], 0.75, 1e-12);
+        TS_ASSERT_DELTA(sobol[1][1], 0.25, 1e-12);
+        TS_ASSERT_DELTA(sobol[2][0], 0.25, 1e-12);
+        TS_ASSERT_DELTA(sobol[2][1], 0.75, 1e-12);
+        TS_ASSERT_DELTA(sobol[3][0], 0.375, 1e-12);
+        TS_ASSERT_DELTA(sobol[3][1], 0.375, 1e-12);
+
+        std::vector<std::vector<double> > skipped = ParameterDesign::GetSobolSequence(2u, 2u, 2u);
+        TS_ASSERT_DELTA(skipped[1][0], sobol[3][0], 1e-12);
+
+        // The first 2^k points have one point in each of the 2^k intervals of each dimension
+        std::vector<std::vector<double> > points = ParameterDesign::GetSobolSequence(63u, 8u);
+        for (unsigned d=0; d<8; d++)
+        {
+            std::vector<unsigned> count(64, 0u);
+            count[0] = 1u;
+            for (unsigned i=0; i<63; i++)
+            {
+                count[(unsigned)(points[i][d]*64)]++;
+            }
+            TS_ASSERT_EQUALS(*std::max_element(count.begin(), count.end()), 1u);
+        }
+        TS_ASSERT_THROWS_CONTAINS(ParameterDesign::GetSobolSequence(1u, 9u), "1 to 8 dimensions");
+    }
+
+    void TestWriteSweepFile()
+    {
+        ParameterDesign design;
+        design.SetBounds("Gamma", 0.1, 0.2);
+        design.AddSobolSequence(3u);
+        design.AddSobolSequence(1u);
+        TS_ASSERT_EQUALS(design.rGetPoints().size(), 4u);
+        TS_ASSERT_DELTA(design.rGetPoints()[0][0], -0.4, 1e-12);
+        TS_ASSERT_DELTA(design.rGetPoints()[3][1], 0.1375, 1e-12);
+        TS_ASSERT_THROWS_CONTAINS(design.SetBounds("Extra", 0.0, 1.0), "cannot be added");
+        TS_ASSERT_THROWS_CONTAINS(design.SetBounds("Gamma", 1.0, 0.0), "must be below");
+
+        OutputFileHandler handler("TestParameterDesign");
+        std::string path = handler.GetOutputDirectoryFullPath() + "Design.csv";
+        design.WriteSweepFile(path, 3u, 11u);
+
+        std::vector<SweepTask> tasks = SweepTask::ReadSweepFile(path, 1u);
+        TS_ASSERT_EQUALS(tasks.size(), 12u);
+        TS_ASSERT_DELTA(tasks[0].mLambda, -0.4, 1e-12);
+        TS_ASSERT_DELTA(tasks[0].mGamma, 0.15, 1e-12);
+        TS_ASSERT_EQUALS(tasks[0].mSimulation, 11u);
+        TS_ASSERT_EQUALS(tasks[11].mSimulation, 14u);
+        TS_ASSERT_EQUALS(tasks[11].mRun, 3u);
+    }
+
+    void TestActiveLearning()
+    {
+        // An emulator trained only on Lambda < -0.4 is most uncertain at large Lambda
+        GaussianProcessEmulator emulator(std::vector<std::string>(), std::vector<std::string>(1, "Statistic"));
+        std::vector<std::vector<double> > points = ParameterDesign::GetSobolSequence(64u, 2u);
+        for (unsigned i=0; i<points.size(); i++)
+        {
+            double lambda = -1.0 + 0.6*points[i][0];
+            double gamma = 0.5*points[i][1];
+            emulator.AddTrainingPoint({lambda, gamma}, {std::sin(3.0*lambda) + gamma});
+        }
+        emulator.Train();
+
+        ParameterDesign design;
+        design.AddActiveLearningBatch(emulator, 3u, std::vector<double>(), 1024u);
+        TS_ASSERT_EQUALS(design.rGetPoints().size(), 3u);
+        for (unsigned i=0; i<3; i++)
+        {
+            TS_ASSERT_LESS_THAN(-0.4, design.rGetPoints()[i][0]);
+        }
+
+        // The points of a batch are spread out rather than all in the most uncertain corner
+        double smallest_distance = 1e10;
+        for (unsigned i=0; i<3; i++)
+        {
+            for (unsigned j=0; j<i; j++)
+            {
+                double lambda_difference = (design.rGetPoints()[i][0] - design.rGetPoints()[j][0])/1.2;
+                double gamma_difference = (design.rGetPoints()[i][1] - design.rGetPoints()[j][1])/0.5;
+                smallest_distance = std::min(smallest_distance, std::hypot(lambda_difference, gamma_difference));
+            }
+        }
+        TS_ASSERT_LESS_THAN(0.1, smallest_distance);
+
+        ParameterDesign other;
+        other.SetBounds("Lambda", -1.0, -0.4);
+        TS_ASSERT_THROWS_CONTAINS(other.AddActiveLearningBatch(emulator, 1u, std::vector<double>(2, 0.0)), "observed values");
+
+        // With an observation, points concentrate where the emulator can match it
+        double observed = std::sin(3.0*-0.9) + 0.25;
+        other.AddActiveLearningBatch(emulator, 3u, std::vector<double>(1, observed), 1024u);
+        for (unsigned i=0; i<3; i++)
+        {
+            double emulated = emulator.PredictMean(other.rGetPoints()[i])[0];
+            TS_ASSERT_DELTA(emulated, observed, 0.3);
+        }
+    }
+};
+
+#endif /*TESTPARAMETERDESIGN_HPP_*/
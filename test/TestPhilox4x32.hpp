@@ -0,0 +1,128 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTPHILOX4X32_HPP_
+#define TESTPHILOX4X32_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <set>
+#include <vector>
+#include "FakePetscSetup.hpp"
+#include "Exception.hpp"
+#include "Philox4x32.hpp"
+#include "SweepTask.hpp"
+
+class TestPhilox4x32 : public CxxTest::TestSuite
+{
+public:
+
+    void TestKnownAnswers()
+    {
+        // Known-answer tests from the Random123 distribution (kat_vectors, philox4x32 10 rounds)
+        Philox4x32::Block zero = Philox4x32::Generate({{0u, 0u, 0u, 0u}}, {{0u, 0u}});
+        TS_ASSERT_EQUALS(zero[0], 0x6627e8d5u);
+        TS_ASSERT_EQUALS(zero[1], 0xe169c58du);
+        TS_ASSERT_EQUALS(zero[2], 0xbc57ac4cu);
+        TS_ASSERT_EQUALS(zero[3], 0x9b00dbd8u);
+
+        Philox4x32::Block ones = Philox4x32::Generate({{0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu}},
+                                                      {{0xffffffffu, 0xffffffffu}});
+        TS_ASSERT_EQUALS(ones[0], 0x408f276du);
+        TS_ASSERT_EQUALS(ones[1], 0x41c83b0eu);
+        TS_ASSERT_EQUALS(ones[2], 0xa20bc7c6u);
+        TS_ASSERT_EQUALS(ones[3], 0x6d5451fdu);
+
+        Philox4x32::Block pi = Philox4x32::Generate({{0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u}},
+                                                    {{0xa4093822u, 0x299f31d0u}});
+        TS_ASSERT_EQUALS(pi[0], 0xd16cfe09u);
+        TS_ASSERT_EQUALS(pi[1], 0x94fdccebu);
+        TS_ASSERT_EQUALS(pi[2], 0x5001e420u);
+        TS_ASSERT_EQUALS(pi[3], 0x24126ea1u);
+    }
+
+    void TestStreams()
+    {
+        Philox4x32 stream(42u);
+        std::vector<unsigned> first;
+        for (unsigned i=0; i<10; i++)
+        {
+            first.push_back(stream());
+        }
+
+        // Seeking back replays the stream
+        stream.Seek(1u);
+        TS_ASSERT_EQUALS(stream(), first[4]);
+        TS_ASSERT_EQUALS(stream(), first[5]);
+
+        // A different stream number gives different numbers
+        Philox4x32 other(42u, 0u, 1u);
+        TS_ASSERT_DIFFERS(other(), first[0]);
+
+        double sum = 0.0;
+        for (unsigned i=0; i<100000; i++)
+        {
+            double value = stream.ranf();
+            TS_ASSERT(value >= 0.0 && value < 1.0);
+            sum += value;
+        }
+        TS_ASSERT_DELTA(sum/100000, 0.5, 0.01);
+    }
+
+    void TestDeriveSeed()
+    {
+        // Seeds are distinct within a sweep, and never 0
+        std::set<unsigned> seeds;
+        for (unsigned simulation=0; simulation<200; simulation++)
+        {
+            for (unsigned run=1; run<=50; run++)
+            {
+                unsigned seed = SweepTask::DeriveSeed(7u, simulation, run);
+                TS_ASSERT_DIFFERS(seed, 0u);
+                seeds.insert(seed);
+            }
+        }
+        TS_ASSERT_EQUALS(seeds.size(), 200u*50u);
+
+        // They are reproducible, and depend on the sweep id
+        TS_ASSERT_EQUALS(SweepTask::DeriveSeed(7u, 3u, 2u), SweepTask::DeriveSeed(7u, 3u, 2u));
+        TS_ASSERT_DIFFERS(SweepTask::DeriveSeed(7u, 3u, 2u), SweepTask::DeriveSeed(8u, 3u, 2u));
+        TS_ASSERT_DIFFERS(SweepTask::DeriveSeed(7u, 1u, 2u), SweepTask::DeriveSeed(7u, 2u, 1u));
+
+        TS_ASSERT_THROWS_CONTAINS(SweepTask::DeriveSeed(7u, 3u, 0u), "Cannot derive a seed");
+        TS_ASSERT_THROWS_CONTAINS(SweepTask::DeriveSeed(7u, 65536u, 1u), "Cannot derive a seed");
+    }
+};
+
+#endif /*TESTPHILOX4X32_HPP_*/
@@ -0,0 +1,105 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTRESULTCACHE_HPP_
+#define TESTRESULTCACHE_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include "FakePetscSetup.hpp"
+#include "OutputFileHandler.hpp"
+#include "ResultCache.hpp"
+
+class TestResultCache : public CxxTest::TestSuite
+{
+public:
+
+    void TestHash()
+    {
+        // Reference values of 64-bit FNV-1a
+        TS_ASSERT_EQUALS(ResultCache::GetHash(""), "cbf29ce484222325");
+        TS_ASSERT_EQUALS(ResultCache::GetHash("a"), "af63dc4c8601ec8c");
+    }
+
+    void TestLookupAndInsert()
+    {
+        OutputFileHandler handler("TestResultCache");
+        ResultCache cache(handler.GetOutputDirectoryFullPath() + "cache");
+
+        std::string value;
+        TS_ASSERT(!cache.Lookup("Lambda=0.12\nSeed=1\n", value));
+
+        cache.Insert("Lambda=0.12\nSeed=1\n", "1 2 3");
+        cache.Insert("Lambda=0.12\nSeed=2\n", "4 5 6");
+        TS_ASSERT(cache.Lookup("Lambda=0.12\nSeed=1\n", value));
+        TS_ASSERT_EQUALS(value, "1 2 3");
+        TS_ASSERT(cache.Lookup("Lambda=0.12\nSeed=2\n", value));
+        TS_ASSERT_EQUALS(value, "4 5 6");
+        TS_ASSERT(!cache.Lookup("Lambda=0.12\nSeed=3\n", value));
+
+        // A new cache on the same directory sees the same entries
+        ResultCache other_cache(handler.GetOutputDirectoryFullPath() + "cache");
+        TS_ASSERT(other_cache.Lookup("Lambda=0.12\nSeed=1\n", value));
+        TS_ASSERT_EQUALS(value, "1 2 3");
+    }
+
+    void TestLeastRecentlyUsedEviction()
+    {
+        OutputFileHandler handler("TestResultCache", false);
+
+        // Room for two entries of this size (key, separator and value are 16 bytes)
+        ResultCache cache(handler.GetOutputDirectoryFullPath() + "small_cache", 40);
+
+        cache.Insert("Seed=1\n", "value");
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        cache.Insert("Seed=2\n", "value");
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+        // Using the first entry makes the second the least recently used
+        std::string value;
+        TS_ASSERT(cache.Lookup("Seed=1\n", value));
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        cache.Insert("Seed=3\n", "value");
+
+        TS_ASSERT(cache.Lookup("Seed=1\n", value));
+        TS_ASSERT(!cache.Lookup("Seed=2\n", value));
+        TS_ASSERT(cache.Lookup("Seed=3\n", value));
+        TS_ASSERT_EQUALS(cache.GetSize(), 32u);
+    }
+};
+
+#endif /*TESTRESULTCACHE_HPP_*/
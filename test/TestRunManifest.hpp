@@ -0,0 +1,82 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTRUNMANIFEST_HPP_
+#define TESTRUNMANIFEST_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <fstream>
+#include <map>
+#include <string>
+#include "FakePetscSetup.hpp"
+#include "Exception.hpp"
+#include "OutputFileHandler.hpp"
+#include "RunManifest.hpp"
+
+class TestRunManifest : public CxxTest::TestSuite
+{
+public:
+
+    void TestWriteReadAndVerify()
+    {
+        OutputFileHandler handler("TestRunManifest");
+        std::string directory = handler.GetOutputDirectoryFullPath();
+        std::ofstream(directory + "AreaCorrelations.dat") << "Time Area_Correlation\n0\t0.5\n";
+
+        TS_ASSERT(!RunManifest::Exists(directory));
+        TS_ASSERT_THROWS_CONTAINS(RunManifest::Read(directory), "No run manifest");
+
+        SweepTask task(0.12, 0.04, 3u, 2u, 17u);
+        RunManifest::Write(directory, task, 12.5, "1 2 3");
+        TS_ASSERT(RunManifest::Exists(directory));
+
+        std::map<std::string, std::string> entries = RunManifest::Read(directory);
+        TS_ASSERT_EQUALS(entries["Name"], task.GetName());
+        TS_ASSERT_EQUALS(entries["Lambda"], "0.12");
+        TS_ASSERT_EQUALS(entries["Seed"], "17");
+        TS_ASSERT_EQUALS(entries["WallTime"], "12.5");
+        TS_ASSERT_EQUALS(entries["Statistics"], "1 2 3");
+
+        // Size and CRC-32 of the file written above
+        TS_ASSERT_EQUALS(entries["File:AreaCorrelations.dat"], "28 ecf85c70");
+        TS_ASSERT(RunManifest::Verify(directory));
+
+        // Changed output no longer matches the manifest
+        std::ofstream(directory + "AreaCorrelations.dat") << "Time Area_Correlation\n0\t0.6\n";
+        TS_ASSERT(!RunManifest::Verify(directory));
+    }
+};
+
+#endif /*TESTRUNMANIFEST_HPP_*/
@@ -0,0 +1,158 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTRUNTRUNCATIONMARKER_HPP_
+#define TESTRUNTRUNCATIONMARKER_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include "CheckpointArchiveTypes.hpp"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "FakePetscSetup.hpp"
+#include "Exception.hpp"
+#include "FileFinder.hpp"
+#include "OutputFileHandler.hpp"
+#include "PaperVertexSimulation.hpp"
+#include "RunTruncationMarker.hpp"
+#include "SweepTask.hpp"
+
+class TestRunTruncationMarker : public CxxTest::TestSuite
+{
+public:
+
+    void TestWriteReadAndRemove()
+    {
+        OutputFileHandler handler("TestRunTruncationMarker");
+        std::string directory = handler.GetOutputDirectoryFullPath();
+
+        TS_ASSERT(!RunTruncationMarker::Exists(directory));
+        TS_ASSERT_THROWS_CONTAINS(RunTruncationMarker::Read(directory), "No truncation marker");
+
+        RunTruncationMarker marker;
+        marker.mReason = "WallTime";
+        marker.mTime = 0.1 + 0.2;
+        marker.mEndTime = 700.0;
+        marker.mWallTime = 3600.25;
+        marker.mTimeSteps = 60u;
+        marker.mNumCells = 4u;
+        marker.Write(directory);
+        TS_ASSERT(RunTruncationMarker::Exists(directory));
+
+        // The checkpoint is found by its time, so that must survive exactly
+        RunTruncationMarker read_marker = RunTruncationMarker::Read(directory);
+        TS_ASSERT_EQUALS(read_marker.mReason, "WallTime");
+        TS_ASSERT_EQUALS(read_marker.mTime, 0.1 + 0.2);
+        TS_ASSERT_EQUALS(read_marker.mEndTime, 700.0);
+        TS_ASSERT_EQUALS(read_marker.mWallTime, 3600.25);
+        TS_ASSERT_EQUALS(read_marker.mTimeSteps, 60u);
+        TS_ASSERT_EQUALS(read_marker.mNumCells, 4u);
+        TS_ASSERT_EQUALS(read_marker.GetDescription(),
+                         "WallTime budget used up at time 0.30000000000000004 of 700, after 60 time steps and 3600.25 s, with 4 cells");
+
+        RunTruncationMarker::Remove(directory);
+        TS_ASSERT(!RunTruncationMarker::Exists(directory));
+        TS_ASSERT_THROWS_NOTHING(RunTruncationMarker::Remove(directory));
+
+        std::ofstream(directory + RunTruncationMarker::FILE_NAME) << "Reason=TimeSteps\n";
+        TS_ASSERT_THROWS_CONTAINS(RunTruncationMarker::Read(directory), "has no reason or time");
+    }
+
+    void TestBudgetsInSweepFile()
+    {
+        OutputFileHandler handler("TestRunTruncationMarker", false);
+        std::string path = handler.GetOutputDirectoryFullPath() + "Budgets.csv";
+        std::ofstream(path.c_str()) << "Lambda,Gamma,Runs,Simulation,WallTimeBudget,TimeStepBudget\n"
+                                    << "0.12,0.04,2,1\n"
+                                    << "-0.85,0.1,1,2,3600\n"
+                                    << "-0.85,0.2,1,3,0,50000\n";
+
+        std::vector<SweepTask> tasks = SweepTask::ReadSweepFile(path, 1u);
+        TS_ASSERT_EQUALS(tasks.size(), 4u);
+        TS_ASSERT_EQUALS(tasks[0].mWallTimeBudget, 0.0);
+        TS_ASSERT_EQUALS(tasks[1].mTimeStepBudget, 0u);
+        TS_ASSERT_EQUALS(tasks[2].mWallTimeBudget, 3600.0);
+        TS_ASSERT_EQUALS(tasks[2].mTimeStepBudget, 0u);
+        TS_ASSERT_EQUALS(tasks[3].mWallTimeBudget, 0.0);
+        TS_ASSERT_EQUALS(tasks[3].mTimeStepBudget, 50000u);
+    }
+
+    void TestResumeTruncatedRun()
+    {
+        PaperVertexSimulationParameters parameters;
+        parameters.mDt = 0.01;
+        parameters.mEndTime = 15.0;
+        parameters.mSamplingTimestepMultiple = 100u;
+
+        PaperVertexSimulation uninterrupted(parameters, "TestRunTruncationMarker/Uninterrupted");
+        TissueSummaryStatistics expected = uninterrupted.Run(1u);
+        TS_ASSERT(!uninterrupted.WasTruncated());
+
+        // The 1500 time steps take three calls to Run(), since each gets a fresh budget
+        parameters.mTimeStepBudget = 600u;
+        PaperVertexSimulation budgeted(parameters, "TestRunTruncationMarker/Budgeted");
+        budgeted.SetResumeFromCheckpoint(true);
+        std::string directory = OutputFileHandler("TestRunTruncationMarker/Budgeted", false).GetOutputDirectoryFullPath();
+
+        double checkpoint_times[2] = {6.0, 12.0};
+        for (unsigned i=0; i<2; i++)
+        {
+            budgeted.Run(1u);
+            TS_ASSERT(budgeted.WasTruncated());
+
+            TS_ASSERT(RunTruncationMarker::Exists(directory));
+            RunTruncationMarker marker = RunTruncationMarker::Read(directory);
+            TS_ASSERT_EQUALS(marker.mReason, "TimeSteps");
+            TS_ASSERT_DELTA(marker.mTime, checkpoint_times[i], 1e-9);
+            TS_ASSERT_EQUALS(marker.mEndTime, 15.0);
+            TS_ASSERT_EQUALS(marker.mTimeSteps, 600u);
+
+            std::ostringstream archive_name;
+            archive_name << "archive/cell_population_sim_at_time_" << marker.mTime << ".arch";
+            TS_ASSERT(FileFinder(directory + archive_name.str(), RelativeTo::Absolute).IsFile());
+        }
+
+        // The last call finishes the run, and removes the marker
+        TissueSummaryStatistics resumed = budgeted.Run(1u);
+        TS_ASSERT(!budgeted.WasTruncated());
+        TS_ASSERT(!RunTruncationMarker::Exists(directory));
+
+        // Stopping and resuming does not change the run
+        TS_ASSERT_EQUALS(resumed.ToString(), expected.ToString());
+    }
+};
+
+#endif /*TESTRUNTRUNCATIONMARKER_HPP_*/
@@ -0,0 +1,136 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTSIMULATIONCONTEXT_HPP_
+#define TESTSIMULATIONCONTEXT_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <vector>
+#include "FakePetscSetup.hpp"
+#include "Cell.hpp"
+#include "CellCycleTimesGenerator.hpp"
+#include "CellPropertyRegistry.hpp"
+#include "NoCellCycleModel.hpp"
+#include "RandomNumberGenerator.hpp"
+#include "SimulationTime.hpp"
+#include "SmartPointers.hpp"
+#include "WildTypeCellMutationState.hpp"
+#include "SimulationContext.hpp"
+
+namespace
+{
+    /** What one simulation sees of the global state set up by its context. */
+    struct ContextState
+    {
+        double mStartTime;
+        std::vector<double> mRandomNumbers;
+        std::vector<double> mCellCycleTimes;
+        unsigned mFirstCellId;
+        unsigned mNumPropertiesAtStart;
+    };
+
+    /**
+     * Run a pretend simulation in a context of its own, leaving behind state
+     * that the next context must clear.
+     *
+     * @param randomSeed the seed
+     * @return what the simulation saw
+     */
+    ContextState RunInContext(unsigned randomSeed)
+    {
+        SimulationContext context(randomSeed);
+
+        ContextState state;
+        state.mStartTime = SimulationTime::Instance()->GetTime();
+        state.mNumPropertiesAtStart = CellPropertyRegistry::Instance()->rGetAllCellProperties().size();
+
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(10.0, 10);
+        for (unsigned i=0; i<5; i++)
+        {
+            state.mRandomNumbers.push_back(RandomNumberGenerator::Instance()->ranf());
+        }
+
+        CellCycleTimesGenerator* p_generator = CellCycleTimesGenerator::Instance();
+        p_generator->SetRate(0.1);
+        p_generator->GenerateCellCycleTimeSequence();
+        for (unsigned i=0; i<5; i++)
+        {
+            state.mCellCycleTimes.push_back(p_generator->GetNextCellCycleTime());
+        }
+
+        boost::shared_ptr<AbstractCellProperty> p_state(CellPropertyRegistry::Instance()->Get<WildTypeCellMutationState>());
+        CellPtr p_cell(new Cell(p_state, new NoCellCycleModel()));
+        CellPtr p_other_cell(new Cell(p_state, new NoCellCycleModel()));
+        state.mFirstCellId = p_cell->GetCellId();
+
+        // Move time on, as a simulation would
+        SimulationTime::Instance()->IncrementTimeOneStep();
+        return state;
+    }
+}
+
+class TestSimulationContext : public CxxTest::TestSuite
+{
+public:
+
+    void TestEachRunStartsAfresh()
+    {
+        ContextState first = RunInContext(17u);
+        ContextState second = RunInContext(17u);
+        ContextState other_seed = RunInContext(18u);
+
+        TS_ASSERT_DELTA(first.mStartTime, 0.0, 1e-12);
+        TS_ASSERT_DELTA(second.mStartTime, 0.0, 1e-12);
+        TS_ASSERT_EQUALS(first.mNumPropertiesAtStart, 0u);
+        TS_ASSERT_EQUALS(second.mNumPropertiesAtStart, 0u);
+        TS_ASSERT_EQUALS(second.mFirstCellId, first.mFirstCellId);
+        TS_ASSERT_EQUALS(other_seed.mFirstCellId, first.mFirstCellId);
+
+        // The same seed gives the same random numbers, and another seed different ones
+        for (unsigned i=0; i<first.mRandomNumbers.size(); i++)
+        {
+            TS_ASSERT_EQUALS(second.mRandomNumbers[i], first.mRandomNumbers[i]);
+            TS_ASSERT_EQUALS(second.mCellCycleTimes[i], first.mCellCycleTimes[i]);
+        }
+        TS_ASSERT(other_seed.mRandomNumbers != first.mRandomNumbers);
+        TS_ASSERT(other_seed.mCellCycleTimes != first.mCellCycleTimes);
+
+        // The singletons are destroyed again when the last context goes
+        TS_ASSERT(!SimulationTime::Instance()->IsStartTimeSetUp());
+        SimulationTime::Destroy();
+    }
+};
+
+#endif /*TESTSIMULATIONCONTEXT_HPP_*/
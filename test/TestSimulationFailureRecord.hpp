@@ -0,0 +1,102 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTSIMULATIONFAILURERECORD_HPP_
+#define TESTSIMULATIONFAILURERECORD_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <climits>
+#include <fstream>
+#include <string>
+#include "FakePetscSetup.hpp"
+#include "Exception.hpp"
+#include "OutputFileHandler.hpp"
+#include "SimulationFailureRecord.hpp"
+
+class TestSimulationFailureRecord : public CxxTest::TestSuite
+{
+public:
+
+    void TestWriteReadAndRemove()
+    {
+        OutputFileHandler handler("TestSimulationFailureRecord");
+        std::string directory = handler.GetOutputDirectoryFullPath();
+
+        TS_ASSERT(!SimulationFailureRecord::Exists(directory));
+        TS_ASSERT_THROWS_CONTAINS(SimulationFailureRecord::Read(directory), "No failure record");
+
+        SimulationFailureRecord record;
+        record.mReason = "CollapsedElement";
+        record.mTime = 123.455;
+        record.mTimeStep = 24691u;
+        record.mValue = -1.5e-5;
+        record.mLimit = 0.0;
+        record.mIndex = 42u;
+        record.mNumCells = 118u;
+        record.Write(directory);
+        TS_ASSERT(SimulationFailureRecord::Exists(directory));
+
+        SimulationFailureRecord read_record = SimulationFailureRecord::Read(directory);
+        TS_ASSERT_EQUALS(read_record.mReason, "CollapsedElement");
+        TS_ASSERT_EQUALS(read_record.mTime, 123.455);
+        TS_ASSERT_EQUALS(read_record.mTimeStep, 24691u);
+        TS_ASSERT_EQUALS(read_record.mValue, -1.5e-5);
+        TS_ASSERT_EQUALS(read_record.mLimit, 0.0);
+        TS_ASSERT_EQUALS(read_record.mIndex, 42u);
+        TS_ASSERT_EQUALS(read_record.mNumCells, 118u);
+        TS_ASSERT_EQUALS(read_record.GetDescription(),
+                         "CollapsedElement at time 123.455 (step 24691): -1.5e-05 passed the limit 0 at index 42, with 118 cells");
+
+        // Failures that are not tied to one element or node, and non-finite values
+        record.mReason = "SubstepFloor";
+        record.mValue = 1e-300*1e-300;
+        record.mLimit = 1e-6;
+        record.mIndex = UINT_MAX;
+        record.Write(directory);
+        read_record = SimulationFailureRecord::Read(directory);
+        TS_ASSERT_EQUALS(read_record.mIndex, UINT_MAX);
+        TS_ASSERT_EQUALS(read_record.GetDescription(),
+                         "SubstepFloor at time 123.455 (step 24691): 0 passed the limit 1e-06, with 118 cells");
+
+        SimulationFailureRecord::Remove(directory);
+        TS_ASSERT(!SimulationFailureRecord::Exists(directory));
+        TS_ASSERT_THROWS_NOTHING(SimulationFailureRecord::Remove(directory));
+
+        std::ofstream(directory + SimulationFailureRecord::FILE_NAME) << "Time=1\n";
+        TS_ASSERT_THROWS_CONTAINS(SimulationFailureRecord::Read(directory), "has no reason");
+    }
+};
+
+#endif /*TESTSIMULATIONFAILURERECORD_HPP_*/
@@ -0,0 +1,108 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTSIMULATIONWORKERPOOL_HPP_
+#define TESTSIMULATIONWORKERPOOL_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <csignal>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "FakePetscSetup.hpp"
+#include "Exception.hpp"
+#include "SimulationWorkerPool.hpp"
+
+namespace
+{
+    /**
+     * A task that succeeds, fails in each of the ways a task can fail, or
+     * takes its worker down with it, depending on its index.
+     */
+    std::string Task(unsigned index)
+    {
+        switch (index % 6)
+        {
+            case 1:
+                EXCEPTION("Task " << index << " failed");
+            case 2:
+                throw std::runtime_error("Task " + std::to_string(index) + " threw");
+            case 3:
+                throw index;
+            case 4:
+                kill(getpid(), SIGKILL);
+                break;
+            case 5:
+                _exit(3);
+            default:
+                break;
+        }
+        return "Task " + std::to_string(index) + " done";
+    }
+}
+
+class TestSimulationWorkerPool : public CxxTest::TestSuite
+{
+public:
+
+    void TestResults()
+    {
+        SimulationWorkerPool pool(3u);
+        TS_ASSERT_EQUALS(pool.GetNumWorkers(), 3u);
+        TS_ASSERT_LESS_THAN(0u, SimulationWorkerPool().GetNumWorkers());
+
+        std::vector<SimulationWorkerPool::Result> results = pool.Run(12u, &Task);
+        TS_ASSERT_EQUALS(results.size(), 12u);
+
+        for (unsigned i=0; i<results.size(); i++)
+        {
+            TS_ASSERT_EQUALS(results[i].mSucceeded, i % 6 == 0);
+        }
+        TS_ASSERT_EQUALS(results[6].mOutput, "Task 6 done");
+        TS_ASSERT_DIFFERS(results[7].mOutput.find("Task 7 failed"), std::string::npos);
+        TS_ASSERT_EQUALS(results[8].mOutput, "Task 8 threw");
+        TS_ASSERT_EQUALS(results[9].mOutput, "Task threw an unknown exception");
+        TS_ASSERT_EQUALS(results[10].mOutput, "Worker killed by signal " + std::to_string(SIGKILL));
+        TS_ASSERT_EQUALS(results[11].mOutput, "Worker failed");
+
+        // The pool is still usable after its workers have crashed
+        results = pool.Run(1u, &Task);
+        TS_ASSERT_EQUALS(results.size(), 1u);
+        TS_ASSERT(results[0].mSucceeded);
+    }
+};
+
+#endif /*TESTSIMULATIONWORKERPOOL_HPP_*/
@@ -0,0 +1,146 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTSMALLINDEXSET_HPP_
+#define TESTSMALLINDEXSET_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <algorithm>
+#include <iterator>
+#include <set>
+#include "FakePetscSetup.hpp"
+#include "Philox4x32.hpp"
+#include "SmallIndexSet.hpp"
+
+class TestSmallIndexSet : public CxxTest::TestSuite
+{
+private:
+
+    /**
+     * Check that a SmallIndexSet holds the same indices as a std::set.
+     *
+     * @param rSet the set to check
+     * @param rReference the std::set
+     */
+    static void CheckSameIndices(const SmallIndexSet& rSet, const std::set<unsigned>& rReference)
+    {
+        TS_ASSERT_EQUALS(rSet.size(), rReference.size());
+        TS_ASSERT_EQUALS(rSet.empty(), rReference.empty());
+        TS_ASSERT(std::equal(rReference.begin(), rReference.end(), rSet.begin()));
+    }
+
+public:
+
+    void TestMatchesStdSet()
+    {
+        // Random insertions and removals, growing the sets past the inline capacity and back
+        Philox4x32 random(3u);
+        SmallIndexSet set;
+        std::set<unsigned> reference;
+        for (unsigned step=0; step<5000; step++)
+        {
+            unsigned index = (unsigned)(20*random.ranf());
+            if (random.ranf() < (step%1000 < 500 ? 0.7 : 0.3))
+            {
+                bool was_added = set.insert(index).second;
+                TS_ASSERT_EQUALS(was_added, reference.insert(index).second);
+                TS_ASSERT_EQUALS(*set.find(index), index);
+            }
+            else
+            {
+                TS_ASSERT_EQUALS(set.erase(index), reference.erase(index));
+                TS_ASSERT(set.find(index) == set.end());
+            }
+            TS_ASSERT_EQUALS(set.count(index), reference.count(index));
+            CheckSameIndices(set, reference);
+        }
+
+        // Small sets stay inline, and go back inline when cleared
+        SmallIndexSet small;
+        for (unsigned index=0; index<SmallIndexSet::INLINE_CAPACITY; index++)
+        {
+            small.insert(3*index);
+        }
+        TS_ASSERT(!small.IsSpilled());
+        small.insert(1u);
+        TS_ASSERT(small.IsSpilled());
+        TS_ASSERT_EQUALS(small.size(), SmallIndexSet::INLINE_CAPACITY + 1);
+        TS_ASSERT_EQUALS(*small.begin(), 0u);
+        TS_ASSERT_EQUALS(*(small.begin() + 1), 1u);
+        small.clear();
+        TS_ASSERT(small.empty());
+        TS_ASSERT(!small.IsSpilled());
+
+        // Copies are independent
+        SmallIndexSet copy = set;
+        TS_ASSERT(copy == set);
+        copy.insert(100u);
+        TS_ASSERT(copy != set);
+        TS_ASSERT_EQUALS(set.count(100u), 0u);
+    }
+
+    void TestIntersectionsAndUnions()
+    {
+        std::set<unsigned> first = {1, 4, 7, 9, 12};
+        std::set<unsigned> second = {2, 4, 9, 10, 12, 15};
+
+        SmallIndexSet shared;
+        shared.AssignIntersection(first, second);
+        CheckSameIndices(shared, {4, 9, 12});
+
+        SmallIndexSet small_first(first.begin(), first.end());
+        shared.AssignIntersection(small_first, second);
+        CheckSameIndices(shared, {4, 9, 12});
+
+        // std::set_intersection works through a std::inserter, as it does for a std::set
+        SmallIndexSet inserted;
+        std::set_intersection(first.begin(), first.end(), second.begin(), second.end(),
+                              std::inserter(inserted, inserted.end()));
+        CheckSameIndices(inserted, {4, 9, 12});
+
+        // The union of the containing elements of a cell's vertices, less the cell itself
+        SmallIndexSet neighbours;
+        neighbours.InsertAll(first);
+        neighbours.InsertAll(second);
+        TS_ASSERT_EQUALS(neighbours.erase(4u), 1u);
+        CheckSameIndices(neighbours, {1, 2, 7, 9, 10, 12, 15});
+
+        // Constructed from an unsorted range
+        std::vector<unsigned> unsorted = {5, 3, 5, 1};
+        CheckSameIndices(SmallIndexSet(unsorted.begin(), unsorted.end()), {1, 3, 5});
+    }
+};
+
+#endif /*TESTSMALLINDEXSET_HPP_*/
@@ -0,0 +1,225 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTSPATIALHASHINTERSECTIONMODIFIER_HPP_
+#define TESTSPATIALHASHINTERSECTIONMODIFIER_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <algorithm>
+#include <set>
+#include <vector>
+#include "AbstractCellBasedTestSuite.hpp"
+#include "CellsGenerator.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+#include "HoneycombVertexMeshGenerator.hpp"
+#include "NoCellCycleModel.hpp"
+#include "SmartPointers.hpp"
+#include "VertexBasedCellPopulation.hpp"
+#include "FakePetscSetup.hpp"
+#include "SpatialHashIntersectionModifier.hpp"
+
+class TestSpatialHashIntersectionModifier : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * Move a boundary node that lies in one element just across a boundary
+     * edge of a neighbouring element, so that a T3 swap is needed. The edge
+     * joins the next node of the node's element to a node of the neighbour
+     * that lies in that element only.
+     *
+     * @param rMesh the mesh
+     * @return whether such a node was found
+     */
+    static bool MoveBoundaryNodeIntoNeighbour(MutableVertexMesh<2,2>& rMesh)
+    {
+        for (unsigned node_index=0; node_index<rMesh.GetNumNodes(); node_index++)
+        {
+            Node<2>* p_node = rMesh.GetNode(node_index);
+            if (!p_node->IsBoundaryNode() || p_node->rGetContainingElementIndices().size() != 1)
+            {
+                continue;
+            }
+            VertexElement<2,2>* p_element = rMesh.GetElement(*(p_node->rGetContainingElementIndices().begin()));
+            unsigned local_index = p_element->GetNodeLocalIndex(node_index);
+            Node<2>* p_next_node = p_element->GetNode((local_index + 1) % p_element->GetNumNodes());
+            if (!p_next_node->IsBoundaryNode() || p_next_node->rGetContainingElementIndices().size() != 2)
+            {
+                continue;
+            }
+
+            std::set<unsigned>::const_iterator elem_iter = p_next_node->rGetContainingElementIndices().begin();
+            if (*elem_iter == p_element->GetIndex())
+            {
+                ++elem_iter;
+            }
+            VertexElement<2,2>* p_neighbour = rMesh.GetElement(*elem_iter);
+            unsigned next_local_index = p_neighbour->GetNodeLocalIndex(p_next_node->GetIndex());
+            unsigned num_neighbour_nodes = p_neighbour->GetNumNodes();
+            Node<2>* p_edge_nodes[2] = {p_neighbour->GetNode((next_local_index + 1) % num_neighbour_nodes),
+                                        p_neighbour->GetNode((next_local_index + num_neighbour_nodes - 1) % num_neighbour_nodes)};
+            for (unsigned i=0; i<2; i++)
+            {
+                if (p_edge_nodes[i]->IsBoundaryNode() && p_edge_nodes[i]->rGetContainingElementIndices().size() == 1)
+                {
+                    // Just inside the middle of the edge
+                    c_vector<double, 2> midpoint = 0.5*(p_next_node->rGetLocation() + p_edge_nodes[i]->rGetLocation());
+                    c_vector<double, 2> centroid = rMesh.GetCentroidOfElement(p_neighbour->GetIndex());
+                    p_node->rGetModifiableLocation() = midpoint + 0.1*(centroid - midpoint);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Check that two meshes have the same nodes and elements.
+     *
+     * @param rMesh the mesh
+     * @param rOtherMesh the other mesh
+     */
+    static void CheckMeshesMatch(MutableVertexMesh<2,2>& rMesh, MutableVertexMesh<2,2>& rOtherMesh)
+    {
+        TS_ASSERT_EQUALS(rMesh.GetNumNodes(), rOtherMesh.GetNumNodes());
+        TS_ASSERT_EQUALS(rMesh.GetNumElements(), rOtherMesh.GetNumElements());
+        if (rMesh.GetNumNodes() != rOtherMesh.GetNumNodes() || rMesh.GetNumElements() != rOtherMesh.GetNumElements())
+        {
+            return;
+        }
+        for (unsigned node_index=0; node_index<rMesh.GetNumNodes(); node_index++)
+        {
+            for (unsigned dim=0; dim<2; dim++)
+            {
+                TS_ASSERT_EQUALS(rMesh.GetNode(node_index)->rGetLocation()[dim],
+                                 rOtherMesh.GetNode(node_index)->rGetLocation()[dim]);
+            }
+            TS_ASSERT_EQUALS(rMesh.GetNode(node_index)->IsBoundaryNode(), rOtherMesh.GetNode(node_index)->IsBoundaryNode());
+        }
+        for (unsigned elem_index=0; elem_index<rMesh.GetNumElements(); elem_index++)
+        {
+            VertexElement<2,2>* p_element = rMesh.GetElement(elem_index);
+            VertexElement<2,2>* p_other_element = rOtherMesh.GetElement(elem_index);
+            TS_ASSERT_EQUALS(p_element->GetNumNodes(), p_other_element->GetNumNodes());
+            for (unsigned local_index=0; local_index<std::min(p_element->GetNumNodes(), p_other_element->GetNumNodes()); local_index++)
+            {
+                TS_ASSERT_EQUALS(p_element->GetNodeGlobalIndex(local_index), p_other_element->GetNodeGlobalIndex(local_index));
+            }
+        }
+    }
+
+public:
+
+    void TestSameT3SwapsAsMesh()
+    {
+        // Two copies of a tissue in which a boundary node has crossed into a neighbouring element
+        HoneycombVertexMeshGenerator generator(4, 4);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+        HoneycombVertexMeshGenerator other_generator(4, 4);
+        MutableVertexMesh<2,2>* p_other_mesh = other_generator.GetMesh();
+        TS_ASSERT(MoveBoundaryNodeIntoNeighbour(*p_mesh));
+        TS_ASSERT(MoveBoundaryNodeIntoNeighbour(*p_other_mesh));
+
+        std::vector<CellPtr> cells;
+        std::vector<CellPtr> other_cells;
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements(), std::vector<unsigned>(), p_diff_type);
+        cells_generator.GenerateBasic(other_cells, p_other_mesh->GetNumElements(), std::vector<unsigned>(), p_diff_type);
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+        VertexBasedCellPopulation<2> other_cell_population(*p_other_mesh, other_cells);
+
+        // The mesh finds the swap when it remeshes
+        p_mesh->SetCheckForT3Swaps(true);
+        p_mesh->ReMesh();
+        TS_ASSERT_LESS_THAN(0u, p_mesh->GetLocationsOfT3Swaps().size());
+
+        // The modifier takes over the mesh's check and finds the same swaps
+        p_other_mesh->SetCheckForT3Swaps(true);
+        SpatialHashIntersectionModifier<2> modifier;
+        modifier.SetupSolve(other_cell_population, "TestSpatialHashIntersectionModifier");
+        TS_ASSERT(!p_other_mesh->GetCheckForT3Swaps());
+        modifier.UpdateAtEndOfTimeStep(other_cell_population);
+        TS_ASSERT_EQUALS(modifier.GetNumT3Swaps(), p_mesh->GetLocationsOfT3Swaps().size());
+        TS_ASSERT_EQUALS(modifier.GetNumIntersectionSwaps(), 0u);
+        TS_ASSERT_EQUALS(p_other_mesh->GetLocationsOfT3Swaps().size(), p_mesh->GetLocationsOfT3Swaps().size());
+        CheckMeshesMatch(*p_mesh, *p_other_mesh);
+
+        // Nothing is left to do for either
+        unsigned num_t3_swaps = p_mesh->GetLocationsOfT3Swaps().size();
+        p_mesh->ReMesh();
+        modifier.UpdateAtEndOfTimeStep(other_cell_population);
+        TS_ASSERT_EQUALS(p_mesh->GetLocationsOfT3Swaps().size(), num_t3_swaps);
+        TS_ASSERT_EQUALS(modifier.GetNumT3Swaps(), num_t3_swaps);
+        CheckMeshesMatch(*p_mesh, *p_other_mesh);
+    }
+
+    void TestInternalIntersectionsNeedT3Swaps()
+    {
+        HoneycombVertexMeshGenerator generator(4, 4);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+        HoneycombVertexMeshGenerator other_generator(4, 4);
+        MutableVertexMesh<2,2>* p_other_mesh = other_generator.GetMesh();
+        TS_ASSERT(MoveBoundaryNodeIntoNeighbour(*p_mesh));
+        TS_ASSERT(MoveBoundaryNodeIntoNeighbour(*p_other_mesh));
+
+        std::vector<CellPtr> cells;
+        std::vector<CellPtr> other_cells;
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements(), std::vector<unsigned>(), p_diff_type);
+        cells_generator.GenerateBasic(other_cells, p_other_mesh->GetNumElements(), std::vector<unsigned>(), p_diff_type);
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+        VertexBasedCellPopulation<2> other_cell_population(*p_other_mesh, other_cells);
+
+        // With T3 swaps off, the mesh does not check for internal intersections either
+        p_mesh->SetCheckForT3Swaps(false);
+        p_mesh->SetCheckForInternalIntersections(true);
+        p_mesh->ReMesh();
+        TS_ASSERT_EQUALS(p_mesh->GetLocationsOfT3Swaps().size(), 0u);
+
+        p_other_mesh->SetCheckForT3Swaps(false);
+        p_other_mesh->SetCheckForInternalIntersections(true);
+        SpatialHashIntersectionModifier<2> modifier;
+        modifier.SetupSolve(other_cell_population, "TestSpatialHashIntersectionModifier");
+        modifier.UpdateAtEndOfTimeStep(other_cell_population);
+        TS_ASSERT_EQUALS(modifier.GetNumT3Swaps(), 0u);
+        TS_ASSERT_EQUALS(modifier.GetNumIntersectionSwaps(), 0u);
+        TS_ASSERT_EQUALS(modifier.GetNumInclusionTests(), 0u);
+        CheckMeshesMatch(*p_mesh, *p_other_mesh);
+    }
+};
+
+#endif /*TESTSPATIALHASHINTERSECTIONMODIFIER_HPP_*/
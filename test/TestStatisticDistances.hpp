@@ -0,0 +1,187 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTSTATISTICDISTANCES_HPP_
+#define TESTSTATISTICDISTANCES_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include "FakePetscSetup.hpp"
+#include "Exception.hpp"
+#include "DistributionDistance.hpp"
+#include "OutputFileHandler.hpp"
+#include "Philox4x32.hpp"
+#include "SummaryStatisticDistance.hpp"
+
+class TestStatisticDistances : public CxxTest::TestSuite
+{
+public:
+
+    void TestMedianAbsoluteDeviation()
+    {
+        double nan = std::numeric_limits<double>::quiet_NaN();
+        TS_ASSERT_DELTA(SummaryStatisticDistance::GetMedianAbsoluteDeviation({1.0, 2.0, 3.0, 4.0, 100.0}), 1.0, 1e-12);
+        TS_ASSERT_DELTA(SummaryStatisticDistance::GetMedianAbsoluteDeviation({4.0, nan, 1.0, 2.0, 3.0}), 1.0, 1e-12);
+        TS_ASSERT_DELTA(SummaryStatisticDistance::GetMedianAbsoluteDeviation({5.0, 5.0, 5.0}), 0.0, 1e-12);
+        TS_ASSERT(std::isnan(SummaryStatisticDistance::GetMedianAbsoluteDeviation({nan})));
+    }
+
+    void TestWeightedEuclideanDistance()
+    {
+        double nan = std::numeric_limits<double>::quiet_NaN();
+        SummaryStatisticDistance distance({0.0, 1.0, nan});
+        distance.SetScales({2.0, 0.5, 1.0});
+        distance.SetWeights({1.0, 4.0, 1.0});
+
+        // The third statistic is not observed, so is not used
+        TS_ASSERT_DELTA(distance.GetDistance({2.0, 2.0, 5.0}), std::sqrt(1.0 + 16.0), 1e-12);
+        TS_ASSERT_DELTA(distance.GetDistance({2.0, 2.0, nan}), std::sqrt(1.0 + 16.0), 1e-12);
+        TS_ASSERT_EQUALS(distance.GetDistance({nan, 2.0, 5.0}), std::numeric_limits<double>::infinity());
+
+        std::vector<double> distances = distance.GetDistances({{0.0, 1.0, 0.0}, {2.0, 2.0, 5.0}});
+        TS_ASSERT_EQUALS(distances.size(), 2u);
+        TS_ASSERT_DELTA(distances[0], 0.0, 1e-12);
+        TS_ASSERT_DELTA(distances[1], std::sqrt(17.0), 1e-12);
+
+        // Scales from simulations; a statistic that does not vary is not used
+        distance.SetScalesFromSimulations({{1.0, 3.0, 0.0}, {2.0, 3.0, 0.0}, {4.0, 3.0, 0.0}, {8.0, 3.0, 0.0}});
+        TS_ASSERT_DELTA(distance.rGetScales()[0], 1.5, 1e-12);
+        TS_ASSERT_DELTA(distance.rGetScales()[1], 0.0, 1e-12);
+        TS_ASSERT_DELTA(distance.GetDistance({3.0, 100.0, 0.0}), 2.0, 1e-12);
+
+        TS_ASSERT_THROWS_CONTAINS(distance.GetDistance({1.0, 2.0}), "Expected 3 simulated statistics but got 2");
+        TS_ASSERT_THROWS_CONTAINS(distance.SetWeights({1.0, -1.0, 1.0}), "must not be negative");
+        TS_ASSERT_THROWS_CONTAINS(distance.SetScales({1.0}), "Expected 3 scales");
+    }
+
+    void TestDistributionDistances()
+    {
+        // Hand calculations
+        TS_ASSERT_DELTA(DistributionDistance::GetWassersteinDistance({0.0, 1.0}, {1.0, 0.0}), 0.0, 1e-12);
+        TS_ASSERT_DELTA(DistributionDistance::GetWassersteinDistance({0.0, 1.0, 3.0}, {2.5, 3.5, 5.5}), 2.5, 1e-12);
+        TS_ASSERT_DELTA(DistributionDistance::GetWassersteinDistance({0.0, 1.0}, {0.5}), 0.5, 1e-12);
+        TS_ASSERT_DELTA(DistributionDistance::GetEnergyDistance({0.0, 1.0}, {0.5}), std::sqrt(2.0*0.25), 1e-12);
+
+        // Against the definitions, for random samples of different sizes
+        Philox4x32 random(3u);
+        std::vector<double> first(7);
+        std::vector<double> second(11);
+        for (unsigned i=0; i<first.size(); i++)
+        {
+            first[i] = random.ranf();
+        }
+        for (unsigned i=0; i<second.size(); i++)
+        {
+            second[i] = 0.3 + 2.0*random.ranf();
+        }
+
+        double between = 0.0;
+        for (unsigned i=0; i<first.size(); i++)
+        {
+            for (unsigned j=0; j<second.size(); j++)
+            {
+                between += std::fabs(first[i] - second[j])/(first.size()*second.size());
+            }
+        }
+        double within_first = 0.0;
+        for (unsigned i=0; i<first.size(); i++)
+        {
+            for (unsigned j=0; j<first.size(); j++)
+            {
+                within_first += std::fabs(first[i] - first[j])/(first.size()*first.size());
+            }
+        }
+        double within_second = 0.0;
+        for (unsigned i=0; i<second.size(); i++)
+        {
+            for (unsigned j=0; j<second.size(); j++)
+            {
+                within_second += std::fabs(second[i] - second[j])/(second.size()*second.size());
+            }
+        }
+        double energy = std::sqrt(2.0*between - within_first - within_second);
+        TS_ASSERT_DELTA(DistributionDistance::GetEnergyDistance(first, second), energy, 1e-12);
+        TS_ASSERT_DELTA(DistributionDistance::GetEnergyDistance(second, first), energy, 1e-12);
+
+        // With equal sizes, W1 is the mean distance between the sorted samples
+        std::vector<double> truncated(second.begin(), second.begin() + first.size());
+        std::vector<double> sorted_first(first);
+        std::vector<double> sorted_truncated(truncated);
+        std::sort(sorted_first.begin(), sorted_first.end());
+        std::sort(sorted_truncated.begin(), sorted_truncated.end());
+        double wasserstein = 0.0;
+        for (unsigned i=0; i<first.size(); i++)
+        {
+            wasserstein += std::fabs(sorted_first[i] - sorted_truncated[i])/first.size();
+        }
+        TS_ASSERT_DELTA(DistributionDistance::GetWassersteinDistance(first, truncated), wasserstein, 1e-12);
+
+        // Batches give the same distances, and NaN for unusable runs
+        double nan = std::numeric_limits<double>::quiet_NaN();
+        std::vector<std::vector<double> > batch = {first, truncated, {}, {1.0, nan}};
+        std::vector<double> wasserstein_distances = DistributionDistance::GetWassersteinDistances(batch, second);
+        std::vector<double> energy_distances = DistributionDistance::GetEnergyDistances(batch, second);
+        TS_ASSERT_EQUALS(wasserstein_distances.size(), 4u);
+        TS_ASSERT_DELTA(energy_distances[0], energy, 1e-12);
+        TS_ASSERT_DELTA(wasserstein_distances[1], DistributionDistance::GetWassersteinDistance(truncated, second), 1e-12);
+        TS_ASSERT(std::isnan(wasserstein_distances[2]));
+        TS_ASSERT(std::isnan(energy_distances[3]));
+    }
+
+    void TestReadFinalSample()
+    {
+        OutputFileHandler handler("TestStatisticDistances");
+        std::string path = handler.GetOutputDirectoryFullPath() + "EdgeLengths.dat";
+        {
+            std::ofstream file(path.c_str());
+            file << "0\t2\t1\t2\t\n1\t3\t0.5\t1.5\t2.5\t\n";
+        }
+        std::vector<double> sample = DistributionDistance::ReadFinalSample(path);
+        TS_ASSERT_EQUALS(sample.size(), 3u);
+        TS_ASSERT_DELTA(sample[2], 2.5, 1e-12);
+
+        {
+            std::ofstream file(path.c_str());
+            file << "1\t3\t0.5\t1.5\t\n";
+        }
+        TS_ASSERT_THROWS_CONTAINS(DistributionDistance::ReadFinalSample(path), "should have 3 values");
+        TS_ASSERT_THROWS_CONTAINS(DistributionDistance::ReadFinalSample(path + ".missing"), "Could not open");
+    }
+};
+
+#endif /*TESTSTATISTICDISTANCES_HPP_*/
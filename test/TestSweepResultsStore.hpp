@@ -0,0 +1,231 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTSWEEPRESULTSSTORE_HPP_
+#define TESTSWEEPRESULTSSTORE_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "FakePetscSetup.hpp"
+#include "Exception.hpp"
+#include "FileFinder.hpp"
+#include "OutputFileHandler.hpp"
+#include "SweepResultsStore.hpp"
+#include "ResultsStoreStreamBuffer.hpp"
+
+class TestSweepResultsStore : public CxxTest::TestSuite
+{
+public:
+
+    void TestWriteAndReadBack()
+    {
+        OutputFileHandler handler("TestSweepResultsStore");
+        std::string file_path = handler.GetOutputDirectoryFullPath() + "sweep.h5";
+        std::remove(file_path.c_str());
+
+        SweepTask task_a(0.12, 0.04, 1u, 1u, 101u);
+        SweepTask task_b(-0.85, 0.1, 2u, 3u, 202u);
+        TS_ASSERT_EQUALS(task_a.GetName(), "_Sim_Number_1Lambda__0.12_Gamma_0.04_Run_1");
+
+        {
+            SweepResultsStore store_a(file_path, task_a);
+            store_a.SetCommitThreshold(16); // force several commits
+            for (unsigned i=0; i<10; i++)
+            {
+                store_a.Append("AreaCorrelations.dat", "0.5\t0.25\n");
+            }
+            store_a.Append("VertexData.txt", "0\t1 2 3\n");
+
+            SweepResultsStore store_b(file_path, task_b);
+            store_b.Append("AreaCorrelations.dat", "1\t2\n");
+            store_b.Commit();
+            store_a.Commit();
+        }
+
+        std::vector<SweepTask> index = SweepResultsStore::ReadIndex(file_path);
+        TS_ASSERT_EQUALS(index.size(), 2u);
+        TS_ASSERT_EQUALS(index[0].GetName(), task_a.GetName());
+        TS_ASSERT_EQUALS(index[0].mSeed, 101u);
+        TS_ASSERT_EQUALS(index[1].GetName(), task_b.GetName());
+        TS_ASSERT_DELTA(index[1].mLambda, -0.85, 1e-12);
+        TS_ASSERT_EQUALS(index[1].mRun, 3u);
+
+        std::string expected;
+        for (unsigned i=0; i<10; i++)
+        {
+            expected += "0.5\t0.25\n";
+        }
+        TS_ASSERT_EQUALS(SweepResultsStore::ReadDataset(file_path, task_a, "AreaCorrelations.dat"), expected);
+        TS_ASSERT_EQUALS(SweepResultsStore::ReadDataset(file_path, task_a, "VertexData.txt"), "0\t1 2 3\n");
+        TS_ASSERT_EQUALS(SweepResultsStore::ReadDataset(file_path, task_b, "AreaCorrelations.dat"), "1\t2\n");
+
+        TS_ASSERT_THROWS_CONTAINS(SweepResultsStore::ReadDataset(file_path, task_b, "VertexData.txt"),
+                                  "No dataset");
+
+        // Each run has a file of its own, which the store links to
+        TS_ASSERT(FileFinder(SweepResultsStore::GetRunFilePath(file_path, task_a), RelativeTo::Absolute).IsFile());
+        TS_ASSERT(FileFinder(SweepResultsStore::GetRunFilePath(file_path, task_b), RelativeTo::Absolute).IsFile());
+    }
+
+    void TestDamagedRunFileOnlyLosesThatRun()
+    {
+        OutputFileHandler handler("TestSweepResultsStore", false);
+        std::string file_path = handler.GetOutputDirectoryFullPath() + "damaged.h5";
+        std::remove(file_path.c_str());
+
+        SweepTask task_a(0.12, 0.04, 1u, 1u, 101u);
+        SweepTask task_b(-0.85, 0.1, 2u, 3u, 202u);
+        {
+            SweepResultsStore store_a(file_path, task_a);
+            store_a.Append("AreaCorrelations.dat", "a\n");
+            store_a.Commit();
+            SweepResultsStore store_b(file_path, task_b);
+            store_b.Append("AreaCorrelations.dat", std::string(100000, 'b'));
+            store_b.Commit();
+        }
+
+        // As if run b's process had died in the middle of a commit
+        std::string run_file_path = SweepResultsStore::GetRunFilePath(file_path, task_b);
+        std::ofstream(run_file_path.c_str(), std::ios::trunc) << "not an HDF5 file";
+
+        TS_ASSERT_EQUALS(SweepResultsStore::ReadIndex(file_path).size(), 2u);
+        TS_ASSERT_EQUALS(SweepResultsStore::ReadDataset(file_path, task_a, "AreaCorrelations.dat"), "a\n");
+        TS_ASSERT_THROWS_CONTAINS(SweepResultsStore::ReadDataset(file_path, task_b, "AreaCorrelations.dat"),
+                                  "in sweep results store");
+
+        // Running b again replaces its file, and the space its first attempt took
+        {
+            SweepResultsStore store_b(file_path, task_b);
+            store_b.Append("AreaCorrelations.dat", "b\n");
+            store_b.Commit();
+        }
+        TS_ASSERT_EQUALS(SweepResultsStore::ReadIndex(file_path).size(), 2u);
+        TS_ASSERT_EQUALS(SweepResultsStore::ReadDataset(file_path, task_b, "AreaCorrelations.dat"), "b\n");
+        TS_ASSERT_EQUALS(SweepResultsStore::ReadDataset(file_path, task_a, "AreaCorrelations.dat"), "a\n");
+    }
+
+    void TestCommitFailureFailsRun()
+    {
+        OutputFileHandler handler("TestSweepResultsStore", false);
+        std::string file_path = handler.GetOutputDirectoryFullPath() + "no_such_directory/failed.h5";
+
+        SweepTask task(0.12, 0.04, 1u, 1u, 101u);
+        SweepResultsStore store(file_path, task);
+        store.Append("AreaCorrelations.dat", "lost\n");
+        TS_ASSERT_THROWS_CONTAINS(store.Commit(), "Could not");
+
+        // Later commits keep failing, even with nothing pending
+        TS_ASSERT_THROWS_CONTAINS(store.Commit(), "was lost");
+
+        // A stream buffer cannot throw, so the store remembers that its commit failed
+        boost::shared_ptr<SweepResultsStore> p_store(new SweepResultsStore(file_path, task));
+        p_store->SetCommitThreshold(4);
+        {
+            ResultsStoreStreamBuffer buffer(p_store, "results.viznodes", 8);
+            std::ostream stream(&buffer);
+            stream << "more than sixteen bytes\n";
+            stream.flush();
+            TS_ASSERT(!stream.good());
+        }
+        TS_ASSERT_THROWS_CONTAINS(p_store->Commit(), "was lost");
+    }
+
+    void TestRetriedRunReplacesEarlierAttempt()
+    {
+        OutputFileHandler handler("TestSweepResultsStore", false);
+        std::string file_path = handler.GetOutputDirectoryFullPath() + "retried.h5";
+        std::remove(file_path.c_str());
+
+        SweepTask task(0.12, 0.04, 1u, 1u, 101u);
+        {
+            // An attempt that dies after committing part of its output
+            SweepResultsStore store(file_path, task);
+            store.Append("AreaCorrelations.dat", "first attempt\n");
+            store.Append("VertexData.txt", "first attempt\n");
+        }
+        {
+            SweepResultsStore store(file_path, task);
+            store.SetCommitThreshold(16);
+            store.Append("AreaCorrelations.dat", "second attempt\n");
+            store.Append("AreaCorrelations.dat", "second attempt\n");
+        }
+
+        // One index row, and only the second attempt's data
+        TS_ASSERT_EQUALS(SweepResultsStore::ReadIndex(file_path).size(), 1u);
+        TS_ASSERT_EQUALS(SweepResultsStore::ReadDataset(file_path, task, "AreaCorrelations.dat"),
+                         "second attempt\nsecond attempt\n");
+        TS_ASSERT_THROWS_CONTAINS(SweepResultsStore::ReadDataset(file_path, task, "VertexData.txt"), "No dataset");
+
+        {
+            // A run carrying on from a checkpoint adds to its data instead
+            SweepResultsStore store(file_path, task);
+            store.SetReplaceExistingRun(false);
+            store.Append("AreaCorrelations.dat", "resumed\n");
+        }
+        TS_ASSERT_EQUALS(SweepResultsStore::ReadIndex(file_path).size(), 1u);
+        TS_ASSERT_EQUALS(SweepResultsStore::ReadDataset(file_path, task, "AreaCorrelations.dat"),
+                         "second attempt\nsecond attempt\nresumed\n");
+    }
+
+    void TestStreamBuffer()
+    {
+        OutputFileHandler handler("TestSweepResultsStore", false);
+        std::string file_path = handler.GetOutputDirectoryFullPath() + "stream.h5";
+        std::remove(file_path.c_str());
+
+        SweepTask task(0.12, 0.04, 1u, 1u, 101u);
+        std::ostringstream expected;
+        {
+            boost::shared_ptr<SweepResultsStore> p_store(new SweepResultsStore(file_path, task));
+            ResultsStoreStreamBuffer buffer(p_store, "results.viznodes", 8); // several appends per line
+            std::ostream stream(&buffer);
+            for (unsigned i=0; i<20; i++)
+            {
+                stream << 0.5*i << "\t" << i << " " << i+1 << "\n";
+                expected << 0.5*i << "\t" << i << " " << i+1 << "\n";
+            }
+            stream.flush();
+            TS_ASSERT(stream.good());
+        }
+
+        TS_ASSERT_EQUALS(SweepResultsStore::ReadDataset(file_path, task, "results.viznodes"), expected.str());
+    }
+};
+
+#endif /*TESTSWEEPRESULTSSTORE_HPP_*/
@@ -0,0 +1,172 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTSWEEPWORKQUEUE_HPP_
+#define TESTSWEEPWORKQUEUE_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "FakePetscSetup.hpp"
+#include "Exception.hpp"
+#include "OutputFileHandler.hpp"
+#include "SweepWorkQueue.hpp"
+
+class TestSweepWorkQueue : public CxxTest::TestSuite
+{
+private:
+
+    /**
+     * @return three tasks
+     */
+    std::vector<SweepTask> MakeTasks()
+    {
+        std::vector<SweepTask> tasks;
+        tasks.push_back(SweepTask(0.12, 0.04, 1u, 1u, 2u));
+        tasks.push_back(SweepTask(0.12, 0.04, 1u, 2u, 3u));
+        tasks.push_back(SweepTask(-0.85, 0.1, 2u, 1u, 3u));
+        return tasks;
+    }
+
+public:
+
+    void TestLeasesAndHeartbeats()
+    {
+        OutputFileHandler handler("TestSweepWorkQueue");
+        std::string completion_path = handler.GetOutputDirectoryFullPath() + "leases.txt";
+        std::remove(completion_path.c_str());
+
+        SweepWorkQueue queue(MakeTasks(), completion_path, 10.0, 2u);
+
+        unsigned index_a, index_b, index_c, index;
+        TS_ASSERT(queue.Lease("a", 0.0, index_a));
+        TS_ASSERT(queue.Lease("b", 0.0, index_b));
+        TS_ASSERT(queue.Lease("c", 0.0, index_c));
+        TS_ASSERT(!queue.Lease("d", 1.0, index));
+        TS_ASSERT_EQUALS(queue.GetNumTasks(SweepWorkQueue::LEASED), 3u);
+
+        // Worker a keeps its lease alive, worker b finishes, worker c goes quiet
+        TS_ASSERT(queue.Heartbeat(index_a, "a", 8.0));
+        TS_ASSERT(!queue.Heartbeat(index_a, "b", 8.0));
+        TS_ASSERT(queue.Complete(index_b, "b", true, "1 2 3"));
+
+        TS_ASSERT_EQUALS(queue.ExpireLeases(12.0), 1u);
+        TS_ASSERT_EQUALS(queue.GetState(index_a), SweepWorkQueue::LEASED);
+        TS_ASSERT_EQUALS(queue.GetState(index_c), SweepWorkQueue::PENDING);
+
+        // The task of worker c is re-issued; c's late outcome is then ignored
+        TS_ASSERT(queue.Lease("d", 12.0, index));
+        TS_ASSERT_EQUALS(index, index_c);
+        TS_ASSERT(!queue.Complete(index_c, "c", true, "late"));
+
+        // A failure is retried until the maximum number of attempts is reached
+        TS_ASSERT(queue.Complete(index_c, "d", false, "error"));
+        TS_ASSERT_EQUALS(queue.GetState(index_c), SweepWorkQueue::FAILED);
+
+        TS_ASSERT(!queue.IsFinished());
+        TS_ASSERT(queue.Complete(index_a, "a", true, "4 5 6"));
+        TS_ASSERT(queue.IsFinished());
+        TS_ASSERT(!queue.Lease("e", 13.0, index));
+    }
+
+    void TestCompletionFileIsReloaded()
+    {
+        OutputFileHandler handler("TestSweepWorkQueue", false);
+        std::string completion_path = handler.GetOutputDirectoryFullPath() + "completion.txt";
+        std::remove(completion_path.c_str());
+
+        unsigned index;
+        {
+            SweepWorkQueue queue(MakeTasks(), completion_path);
+            TS_ASSERT(queue.Lease("a", 0.0, index));
+            TS_ASSERT(queue.Complete(index, "a", true, "1\t2\n3"));
+            TS_ASSERT(queue.Lease("a", 1.0, index));
+        }
+
+        // The second task was still running when the queue went away, so it is run again
+        SweepWorkQueue queue(MakeTasks(), completion_path);
+        TS_ASSERT_EQUALS(queue.GetState(0), SweepWorkQueue::SUCCEEDED);
+        TS_ASSERT_EQUALS(queue.GetNumTasks(SweepWorkQueue::PENDING), 2u);
+        TS_ASSERT(queue.Lease("b", 0.0, index));
+        TS_ASSERT_EQUALS(index, 1u);
+
+        // A completion file from a different sweep is rejected
+        std::vector<SweepTask> other_tasks = MakeTasks();
+        other_tasks[0].mLambda = 0.0;
+        TS_ASSERT_THROWS_CONTAINS(SweepWorkQueue other_queue(other_tasks, completion_path), "does not belong to this sweep");
+    }
+
+    void TestTruncatedCompletionLineIsNotCounted()
+    {
+        OutputFileHandler handler("TestSweepWorkQueue", false);
+        std::string completion_path = handler.GetOutputDirectoryFullPath() + "truncated.txt";
+        std::remove(completion_path.c_str());
+
+        unsigned index;
+        {
+            SweepWorkQueue queue(MakeTasks(), completion_path);
+            TS_ASSERT(queue.Lease("a", 0.0, index));
+            TS_ASSERT(queue.Complete(index, "a", true, "finished"));
+        }
+
+        // Cut the line short inside the output field, as a crash while appending it would
+        std::string contents;
+        {
+            std::ifstream file(completion_path.c_str());
+            std::getline(file, contents);
+        }
+        {
+            std::ofstream file(completion_path.c_str(), std::ios::trunc);
+            file << contents.substr(0, contents.find("finished") + 3);
+        }
+
+        {
+            SweepWorkQueue queue(MakeTasks(), completion_path);
+            TS_ASSERT_EQUALS(queue.GetState(0), SweepWorkQueue::PENDING);
+            TS_ASSERT(queue.Lease("a", 0.0, index));
+            TS_ASSERT_EQUALS(index, 0u);
+            TS_ASSERT(queue.Complete(index, "a", true, "finished"));
+        }
+
+        // The cut line is ended, so the new record is read back on its own line
+        SweepWorkQueue queue(MakeTasks(), completion_path);
+        TS_ASSERT_EQUALS(queue.GetState(0), SweepWorkQueue::SUCCEEDED);
+        TS_ASSERT_EQUALS(queue.GetNumTasks(SweepWorkQueue::PENDING), 2u);
+    }
+};
+
+#endif /*TESTSWEEPWORKQUEUE_HPP_*/
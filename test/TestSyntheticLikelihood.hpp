@@ -0,0 +1,207 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef TESTSYNTHETICLIKELIHOOD_HPP_
+#define TESTSYNTHETICLIKELIHOOD_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <cmath>
+#include <limits>
+#include "FakePetscSetup.hpp"
+#include "Exception.hpp"
+#include "Philox4x32.hpp"
+#include "StreamingCovariance.hpp"
+#include "SyntheticLikelihood.hpp"
+#include "SyntheticLikelihoodMcmc.hpp"
+#include "TissueSummaryStatistics.hpp"
+
+class TestSyntheticLikelihood : public CxxTest::TestSuite
+{
+private:
+
+    /**
+     * A stand-in for a batch of simulations: the mean area is Lambda and the mean
+     * perimeter Gamma, plus noise seeded by the task's seed.
+     *
+     * @param rTasks the runs
+     * @return the statistics of each run
+     */
+    static std::vector<std::string> RunToyModel(const std::vector<SweepTask>& rTasks)
+    {
+        std::vector<std::string> results;
+        for (unsigned i=0; i<rTasks.size(); i++)
+        {
+            Philox4x32 random(rTasks[i].mSeed);
+            TissueSummaryStatistics statistics;
+            statistics.mMeanArea = rTasks[i].mLambda + 0.05*(random.ranf() - 0.5);
+            statistics.mMeanPerimeter = rTasks[i].mGamma + 0.05*(random.ranf() - 0.5);
+            results.push_back(statistics.ToString());
+        }
+        return results;
+    }
+
+public:
+
+    void TestStreamingCovariance()
+    {
+        StreamingCovariance covariance(2u);
+        TS_ASSERT_THROWS_CONTAINS(covariance.GetCovariance(), "at least two samples");
+        TS_ASSERT_THROWS_CONTAINS(covariance.AddSample(std::vector<double>(3, 0.0)), "length 2");
+
+        // Large offsets do not spoil the estimate
+        covariance.AddSample({1e8 + 1.0, 2.0});
+        covariance.AddSample({1e8 + 2.0, 4.0});
+        covariance.AddSample({1e8 + 3.0, 3.0});
+        TS_ASSERT_EQUALS(covariance.GetNumSamples(), 3u);
+        TS_ASSERT_DELTA(covariance.rGetMean()[0], 1e8 + 2.0, 1e-6);
+        TS_ASSERT_DELTA(covariance.rGetMean()[1], 3.0, 1e-12);
+
+        std::vector<double> matrix = covariance.GetCovariance();
+        TS_ASSERT_DELTA(matrix[0], 1.0, 1e-8);
+        TS_ASSERT_DELTA(matrix[1], 0.5, 1e-8);
+        TS_ASSERT_DELTA(matrix[2], 0.5, 1e-8);
+        TS_ASSERT_DELTA(matrix[3], 1.0, 1e-12);
+    }
+
+    void TestLikelihood()
+    {
+        std::vector<double> observed(10, std::numeric_limits<double>::quiet_NaN());
+        observed[2] = 1.0;
+        observed[4] = 2.0;
+        SyntheticLikelihood likelihood(observed);
+
+        StreamingCovariance samples(10u);
+        TS_ASSERT_THROWS_CONTAINS(likelihood.Evaluate(samples), "at least two replicate runs");
+        std::vector<double> sample(10, 0.0);
+        double values[4][2] = {{0.8, 2.1}, {1.3, 2.4}, {1.1, 1.7}, {0.6, 2.0}};
+        for (unsigned i=0; i<4; i++)
+        {
+            sample[2] = values[i][0];
+            sample[4] = values[i][1];
+            samples.AddSample(sample);
+        }
+
+        // With full shrinkage the statistics are independent normals
+        likelihood.SetShrinkageIntensity(1.0);
+        std::vector<double> covariance = samples.GetCovariance();
+        double expected = 0.0;
+        for (unsigned i : {2u, 4u})
+        {
+            double variance = covariance[i*10 + i];
+            double difference = observed[i] - samples.rGetMean()[i];
+            expected += -0.5*std::log(2.0*M_PI*variance) - 0.5*difference*difference/variance;
+        }
+        TS_ASSERT_DELTA(likelihood.Evaluate(samples), expected, 1e-10);
+
+        // Without shrinkage the full bivariate normal
+        likelihood.SetShrinkageIntensity(0.0);
+        double v0 = covariance[22];
+        double v1 = covariance[44];
+        double c = covariance[24];
+        double determinant = v0*v1 - c*c;
+        double d0 = observed[2] - samples.rGetMean()[2];
+        double d1 = observed[4] - samples.rGetMean()[4];
+        double quadratic = (v1*d0*d0 - 2.0*c*d0*d1 + v0*d1*d1)/determinant;
+        TS_ASSERT_DELTA(likelihood.Evaluate(samples), -std::log(2.0*M_PI) - 0.5*std::log(determinant) - 0.5*quadratic, 1e-10);
+
+        // Automatic shrinkage is between the two
+        likelihood.SetShrinkageIntensity(-1.0);
+        double intensity = likelihood.GetShrinkageIntensity(samples);
+        TS_ASSERT(intensity > 0.0 && intensity <= 1.0);
+        TS_ASSERT_THROWS_CONTAINS(likelihood.SetShrinkageIntensity(1.5), "cannot be more than 1");
+
+        // Uncorrelated samples are shrunk fully, and more samples mean less shrinkage
+        std::vector<double> identity = {1.0, 0.0, 0.0, 1.0};
+        TS_ASSERT_DELTA(SyntheticLikelihood::GetAutomaticShrinkageIntensity(identity, 2u, 5u), 1.0, 1e-12);
+        std::vector<double> correlated = {1.0, 0.9, 0.9, 1.0};
+        TS_ASSERT_LESS_THAN(SyntheticLikelihood::GetAutomaticShrinkageIntensity(correlated, 2u, 100u),
+                            SyntheticLikelihood::GetAutomaticShrinkageIntensity(correlated, 2u, 5u));
+    }
+
+    void TestMcmc()
+    {
+        std::vector<double> observed(10, std::numeric_limits<double>::quiet_NaN());
+        observed[2] = -0.3;
+        observed[4] = 0.2;
+        SyntheticLikelihood likelihood(observed);
+
+        std::vector<std::vector<double> > starting_points = {{-0.9, 0.05}, {0.1, 0.45}, {-0.5, 0.4}, {0.0, 0.0}};
+        SyntheticLikelihoodMcmc mcmc(likelihood, starting_points, 8u, 3u);
+
+        unsigned num_batches = 0;
+        unsigned max_batch_size = 0;
+        mcmc.Run(400u, [&](const std::vector<SweepTask>& rTasks)
+        {
+            num_batches++;
+            max_batch_size = std::max(max_batch_size, (unsigned)rTasks.size());
+            return RunToyModel(rTasks);
+        });
+
+        // One batch per iteration, holding the replicates of all the chains' proposals
+        TS_ASSERT_EQUALS(num_batches, 401u);
+        TS_ASSERT_EQUALS(max_batch_size, 32u);
+        TS_ASSERT_EQUALS(mcmc.rGetSamples().size(), 4u*401u);
+        TS_ASSERT(mcmc.GetAcceptanceRate() > 0.05 && mcmc.GetAcceptanceRate() < 0.9);
+
+        // After burn-in the chains sit around the observed parameters
+        double lambda_sum = 0.0;
+        double gamma_sum = 0.0;
+        unsigned count = 0;
+        for (unsigned i=0; i<mcmc.rGetSamples().size(); i++)
+        {
+            if (mcmc.rGetSamples()[i].mIteration > 200u)
+            {
+                lambda_sum += mcmc.rGetSamples()[i].mLambda;
+                gamma_sum += mcmc.rGetSamples()[i].mGamma;
+                count++;
+            }
+        }
+        TS_ASSERT_DELTA(lambda_sum/count, -0.3, 0.02);
+        TS_ASSERT_DELTA(gamma_sum/count, 0.2, 0.02);
+
+        // Running on would number more points than have seeds, so nothing is simulated
+        num_batches = 0;
+        TS_ASSERT_THROWS_CONTAINS(mcmc.Run(16000u, [&](const std::vector<SweepTask>& rTasks)
+        {
+            num_batches++;
+            return RunToyModel(rTasks);
+        }), "at most 65535 have seeds");
+        TS_ASSERT_EQUALS(num_batches, 0u);
+        TS_ASSERT_EQUALS(mcmc.rGetSamples().size(), 4u*401u);
+
+        TS_ASSERT_THROWS_CONTAINS(SyntheticLikelihoodMcmc(likelihood, starting_points, 1u), "at least two replicate runs");
+    }
+};
+
+#endif /*TESTSYNTHETICLIKELIHOOD_HPP_*/
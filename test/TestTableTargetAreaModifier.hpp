@@ -0,0 +1,312 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTTABLETARGETAREAMODIFIER_HPP_
+#define TESTTABLETARGETAREAMODIFIER_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <cmath>
+#include <vector>
+#include "AbstractCellBasedTestSuite.hpp"
+#include "CellsGenerator.hpp"
+#include "FarhadifarForce.hpp"
+#include "FixedG1GenerationalCellCycleModel.hpp"
+#include "HoneycombVertexMeshGenerator.hpp"
+#include "NoCellCycleModel.hpp"
+#include "OffLatticeSimulation.hpp"
+#include "SimulationTime.hpp"
+#include "SmartPointers.hpp"
+#include "TargetAreaLinearGrowthModifier.hpp"
+#include "TransitCellProliferativeType.hpp"
+#include "VertexBasedCellPopulation.hpp"
+#include "FakePetscSetup.hpp"
+#include "Exception.hpp"
+#include "FasterFarhadifarForce.hpp"
+#include "SimulationContext.hpp"
+#include "TableTargetAreaModifier.hpp"
+
+class TestTableTargetAreaModifier : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * Make transit cells with FixedG1GenerationalCellCycleModel cell cycles (12
+     * hours long, growing from age 8) and evenly spread ages.
+     *
+     * @param numCells the number of cells
+     * @param ageSpacing the difference between the ages of consecutive cells
+     * @return the cells
+     */
+    static std::vector<CellPtr> MakeCells(unsigned numCells, double ageSpacing)
+    {
+        std::vector<CellPtr> cells;
+        MAKE_PTR(TransitCellProliferativeType, p_transit_type);
+        CellsGenerator<FixedG1GenerationalCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, numCells, std::vector<unsigned>(), p_transit_type);
+        for (unsigned i=0; i<numCells; i++)
+        {
+            cells[i]->SetBirthTime(-ageSpacing*i);
+        }
+        return cells;
+    }
+
+    /**
+     * Calculate the forces on the nodes of a population with the given force,
+     * starting from no applied force.
+     *
+     * @param rForce the force
+     * @param rCellPopulation the population
+     * @return the x and y components of the force on each node in turn
+     */
+    static std::vector<double> CalculateForces(AbstractForce<2>& rForce, VertexBasedCellPopulation<2>& rCellPopulation)
+    {
+        for (unsigned node_index=0; node_index<rCellPopulation.GetNumNodes(); node_index++)
+        {
+            rCellPopulation.GetNode(node_index)->ClearAppliedForce();
+        }
+        rForce.AddForceContribution(rCellPopulation);
+
+        std::vector<double> forces;
+        for (unsigned node_index=0; node_index<rCellPopulation.GetNumNodes(); node_index++)
+        {
+            const c_vector<double, 2>& r_force = rCellPopulation.GetNode(node_index)->rGetAppliedForce();
+            forces.push_back(r_force[0]);
+            forces.push_back(r_force[1]);
+        }
+        return forces;
+    }
+
+    /**
+     * Run a growing tissue, with divisions, with FasterFarhadifarForce and either
+     * modifier, in a context of its own.
+     *
+     * @param useTable whether to use a TableTargetAreaModifier rather than TargetAreaLinearGrowthModifier
+     * @param rNumCells filled in with the final number of cells
+     * @return the x and y components of the final location of each node in turn
+     */
+    static std::vector<double> RunSimulation(bool useTable, unsigned& rNumCells)
+    {
+        SimulationContext context(1u);
+
+        HoneycombVertexMeshGenerator generator(3, 3);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, MakeCells(p_mesh->GetNumElements(), 1.45));
+
+        OffLatticeSimulation<2> simulator(cell_population);
+        simulator.SetOutputDirectory(useTable ? "TestTableTargetAreaModifier/Table" : "TestTableTargetAreaModifier/CellData");
+        simulator.SetDt(0.01);
+        simulator.SetSamplingTimestepMultiple(50);
+        simulator.SetEndTime(2.0);
+
+        MAKE_PTR(FasterFarhadifarForce<2>, p_force);
+        simulator.AddForce(p_force);
+        if (useTable)
+        {
+            MAKE_PTR(TableTargetAreaModifier<2>, p_growth_modifier);
+            p_growth_modifier->SetSamplingTimestepMultiple(50);
+            p_force->SetCellDataTable(p_growth_modifier->GetCellDataTable());
+            simulator.AddSimulationModifier(p_growth_modifier);
+        }
+        else
+        {
+            MAKE_PTR(TargetAreaLinearGrowthModifier<2>, p_growth_modifier);
+            simulator.AddSimulationModifier(p_growth_modifier);
+        }
+        simulator.Solve();
+
+        rNumCells = cell_population.GetNumRealCells();
+        std::vector<double> locations;
+        for (unsigned node_index=0; node_index<cell_population.GetNumNodes(); node_index++)
+        {
+            const c_vector<double, 2>& r_location = cell_population.GetNode(node_index)->rGetLocation();
+            locations.push_back(r_location[0]);
+            locations.push_back(r_location[1]);
+        }
+        return locations;
+    }
+
+public:
+
+    void TestSameTargetAreasAsLinearGrowthModifier()
+    {
+        // Ages from 0 to beyond the end of the cell cycle, where cells are ready to divide
+        std::vector<CellPtr> cells = MakeCells(20, 0.7);
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 4);
+
+        TargetAreaLinearGrowthModifier<2> reference_modifier;
+        TableTargetAreaModifier<2> table_modifier;
+        for (unsigned step=0; step<4; step++)
+        {
+            for (unsigned i=0; i<cells.size(); i++)
+            {
+                reference_modifier.UpdateTargetAreaOfCell(cells[i]);
+                double reference_target_area = cells[i]->GetCellData()->GetItem("target area");
+                table_modifier.UpdateTargetAreaOfCell(cells[i]);
+                TS_ASSERT_DELTA(cells[i]->GetCellData()->GetItem("target area"), reference_target_area, 1e-12);
+            }
+            SimulationTime::Instance()->IncrementTimeOneStep();
+        }
+    }
+
+    void TestHotLoopsUseTable()
+    {
+        HoneycombVertexMeshGenerator generator(5, 5);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        // No cell is ready to divide within the test, but some are growing
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, MakeCells(p_mesh->GetNumElements(), 0.45));
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 100);
+
+        TableTargetAreaModifier<2> modifier;
+        modifier.SetSamplingTimestepMultiple(100);
+        modifier.SetupSolve(cell_population, "TestTableTargetAreaModifier");
+        boost::shared_ptr<CellDataTable> p_table = modifier.GetCellDataTable();
+        const std::vector<double>& r_target_areas = p_table->rGetValues(p_table->GetHandle("target area"));
+
+        // SetupSolve() leaves the target areas in both the table and the cells
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            unsigned location_index = cell_population.GetLocationIndexUsingCell(*cell_iter);
+            TS_ASSERT_DELTA(r_target_areas[location_index], cell_iter->GetCellData()->GetItem("target area"), 1e-12);
+        }
+
+        FarhadifarForce<2> reference_force;
+        FasterFarhadifarForce<2> faster_force;
+        faster_force.SetCellDataTable(p_table);
+        std::vector<double> reference = CalculateForces(reference_force, cell_population);
+
+        // Spoil the cells' copies: anything in the time step loop that read them would give NaN
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            cell_iter->GetCellData()->SetItem("target area", NAN);
+        }
+
+        std::vector<double> faster = CalculateForces(faster_force, cell_population);
+        TS_ASSERT_EQUALS(faster.size(), reference.size());
+        for (unsigned i=0; i<faster.size(); i++)
+        {
+            TS_ASSERT_DELTA(faster[i], reference[i], 1e-12);
+        }
+
+        // Between output time steps the modifier writes the table only
+        SimulationTime* p_simulation_time = SimulationTime::Instance();
+        for (unsigned step=1; step<100; step++)
+        {
+            p_simulation_time->IncrementTimeOneStep();
+            modifier.UpdateAtEndOfTimeStep(cell_population);
+            faster = CalculateForces(faster_force, cell_population);
+        }
+        for (unsigned i=0; i<faster.size(); i++)
+        {
+            TS_ASSERT(std::isfinite(faster[i]));
+        }
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            TS_ASSERT(std::isnan(cell_iter->GetCellData()->GetItem("target area")));
+        }
+
+        // At an output time step it copies the target areas to the cells, for the writers
+        p_simulation_time->IncrementTimeOneStep();
+        modifier.UpdateAtEndOfTimeStep(cell_population);
+        unsigned num_growing_cells = 0;
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            unsigned location_index = cell_population.GetLocationIndexUsingCell(*cell_iter);
+            double target_area = cell_iter->GetCellData()->GetItem("target area");
+            TS_ASSERT_DELTA(r_target_areas[location_index], target_area, 1e-12);
+            if (target_area > modifier.GetReferenceTargetArea())
+            {
+                num_growing_cells++;
+            }
+
+            // The growth law as applied to a single cell
+            modifier.UpdateTargetAreaOfCell(*cell_iter);
+            TS_ASSERT_DELTA(cell_iter->GetCellData()->GetItem("target area"), target_area, 1e-12);
+        }
+        TS_ASSERT_LESS_THAN(0u, num_growing_cells);
+    }
+
+    void TestSameSimulationAsLinearGrowthModifier()
+    {
+        // The cells divide during the run, so the daughters must get their mothers' target areas
+        unsigned num_cells_reference = 0;
+        unsigned num_cells_table = 0;
+        std::vector<double> reference = RunSimulation(false, num_cells_reference);
+        std::vector<double> table = RunSimulation(true, num_cells_table);
+
+        TS_ASSERT_LESS_THAN(9u, num_cells_reference);
+        TS_ASSERT_EQUALS(num_cells_table, num_cells_reference);
+        TS_ASSERT_EQUALS(table.size(), reference.size());
+        for (unsigned i=0; i<table.size() && i<reference.size(); i++)
+        {
+            TS_ASSERT_DELTA(table[i], reference[i], 1e-10);
+        }
+    }
+
+    void TestExceptions()
+    {
+        HoneycombVertexMeshGenerator generator(2, 2);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+        std::vector<CellPtr> cells;
+        MAKE_PTR(TransitCellProliferativeType, p_transit_type);
+        CellsGenerator<NoCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements(), std::vector<unsigned>(), p_transit_type);
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+
+        TableTargetAreaModifier<2> modifier;
+        TS_ASSERT_THROWS_CONTAINS(modifier.SetupSolve(cell_population, "TestTableTargetAreaModifier"),
+                                  "TableTargetAreaModifier needs a subclass of AbstractPhaseBasedCellCycleModel");
+        TS_ASSERT_THROWS_CONTAINS(modifier.SetSamplingTimestepMultiple(0u), "must be positive");
+
+        // The force resolves the item when it is given the table, not in the time step loop
+        FasterFarhadifarForce<2> force;
+        boost::shared_ptr<CellDataTable> p_table(new CellDataTable());
+        TS_ASSERT_THROWS_CONTAINS(force.SetCellDataTable(p_table), "\"target area\" has not been registered");
+        TS_ASSERT(!force.GetCellDataTable());
+        p_table->RegisterItem("target area");
+        force.SetCellDataTable(p_table);
+        TS_ASSERT(force.GetCellDataTable() == p_table);
+    }
+};
+
+#endif /*TESTTABLETARGETAREAMODIFIER_HPP_*/
@@ -0,0 +1,117 @@
+/*
+
+Copyright (c) 2005-2023, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTVERTEXSPATIALHASH_HPP_
+#define TESTVERTEXSPATIALHASH_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <algorithm>
+#include "FakePetscSetup.hpp"
+#include "Exception.hpp"
+#include "Philox4x32.hpp"
+#include "VertexSpatialHash.hpp"
+
+class TestVertexSpatialHash : public CxxTest::TestSuite
+{
+public:
+
+    void TestBoxQueriesMatchBruteForce()
+    {
+        // Enough vertices to make the buckets grow, some at negative coordinates
+        Philox4x32 random(5u);
+        unsigned num_vertices = 5000;
+        std::vector<double> x(num_vertices);
+        std::vector<double> y(num_vertices);
+        VertexSpatialHash hash(0.7);
+        for (unsigned index=0; index<num_vertices; index++)
+        {
+            x[index] = 100.0*random.ranf() - 50.0;
+            y[index] = 60.0*random.ranf() - 30.0;
+            hash.SetVertex(index, x[index], y[index]);
+        }
+        TS_ASSERT_EQUALS(hash.GetNumVertices(), num_vertices);
+        TS_ASSERT_EQUALS(hash.GetNumCellChanges(), 0u);
+
+        // Move every vertex a little, and remove some
+        for (unsigned index=0; index<num_vertices; index++)
+        {
+            x[index] += 0.1*(random.ranf() - 0.5);
+            y[index] += 0.1*(random.ranf() - 0.5);
+            hash.SetVertex(index, x[index], y[index]);
+        }
+        TS_ASSERT_LESS_THAN(0u, hash.GetNumCellChanges());
+        TS_ASSERT_LESS_THAN(hash.GetNumCellChanges(), num_vertices/2);
+        for (unsigned index=0; index<num_vertices; index+=7)
+        {
+            hash.RemoveVertex(index);
+        }
+        hash.RemoveVertex(0);
+        hash.Truncate(4500u);
+        TS_ASSERT(!hash.Contains(14u));
+        TS_ASSERT(hash.Contains(15u));
+        TS_ASSERT(!hash.Contains(4600u));
+
+        std::vector<unsigned> found;
+        for (unsigned query=0; query<200; query++)
+        {
+            double x_min = 110.0*random.ranf() - 55.0;
+            double y_min = 70.0*random.ranf() - 35.0;
+            double x_max = x_min + 3.0*random.ranf();
+            double y_max = y_min + 3.0*random.ranf();
+            hash.GetVerticesInBox(x_min, y_min, x_max, y_max, found);
+            std::sort(found.begin(), found.end());
+
+            std::vector<unsigned> expected;
+            for (unsigned index=0; index<4500; index++)
+            {
+                if (index%7 != 0 && x[index] >= x_min && x[index] <= x_max && y[index] >= y_min && y[index] <= y_max)
+                {
+                    expected.push_back(index);
+                }
+            }
+            TS_ASSERT_EQUALS(found.size(), expected.size());
+            TS_ASSERT(found == expected);
+        }
+
+        // Removed vertices can come back
+        hash.SetVertex(7u, 0.5, 0.5);
+        hash.GetVerticesInBox(0.4, 0.4, 0.6, 0.6, found);
+        TS_ASSERT(std::find(found.begin(), found.end(), 7u) != found.end());
+
+        TS_ASSERT_THROWS_CONTAINS(VertexSpatialHash(0.0), "must be positive");
+    }
+};
+
+#endif /*TESTVERTEXSPATIALHASH_HPP_*/